@@ -0,0 +1,174 @@
+#include "domain/aggregates/OrderBook.hpp"
+#include "support/AllocationCounter.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace mde::domain;
+
+namespace {
+
+const MarketAsset kAsset("0xbd31dc", "6581861");
+
+// Book with `depth` (< 50) levels per side: bids 0.49, 0.48, ... and asks 0.51, 0.52, ...
+BookSnapshot make_snapshot(int depth) {
+    BookSnapshot snap{{kAsset, Timestamp(0), 1}, {}, {}, "0xabc"};
+    for (int i = 0; i < depth; ++i) {
+        snap.bids.emplace_back(Price((49 - i) / 100.0), Quantity(100.0 + i));
+        snap.asks.emplace_back(Price((51 + i) / 100.0), Quantity(100.0 + i));
+    }
+    return snap;
+}
+
+// Steady-state delta mix: resize a level, remove it, then re-add it.
+std::vector<BookDelta> make_delta_cycle() {
+    auto delta = [](double price, double size, Side side) {
+        return BookDelta{
+            {kAsset, Timestamp(100), 0},
+            {PriceLevelDelta{"6581861", Price(price), Quantity(size), side,
+                             Price(0.49), Price(0.51)}}
+        };
+    };
+    return {
+        delta(0.45, 250.0, Side::BUY),
+        delta(0.45, 0.0, Side::BUY),
+        delta(0.45, 120.0, Side::BUY),
+        delta(0.55, 250.0, Side::SELL),
+        delta(0.55, 0.0, Side::SELL),
+        delta(0.55, 120.0, Side::SELL),
+    };
+}
+
+void report_allocations(benchmark::State& state, uint64_t before) {
+    auto allocations = mde::bench::allocation_count() - before;
+    state.counters["allocs_per_event"] = benchmark::Counter(
+        static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+void BM_OrderBookApplyDelta(benchmark::State& state) {
+    auto book = OrderBook::empty(kAsset).apply(make_snapshot(static_cast<int>(state.range(0))));
+    auto deltas = make_delta_cycle();
+    size_t i = 0;
+
+    auto before = mde::bench::allocation_count();
+    for (auto _ : state) {
+        book = book.apply(deltas[i++ % deltas.size()]);
+        benchmark::DoNotOptimize(book);
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(BM_OrderBookApplyDelta)->Arg(10)->Arg(25)->Arg(45);
+
+void BM_OrderBookApplyInPlaceDelta(benchmark::State& state) {
+    auto book = OrderBook::empty(kAsset).apply(make_snapshot(static_cast<int>(state.range(0))));
+    auto deltas = make_delta_cycle();
+    // Warm up so every level vector has reached its steady-state capacity
+    for (const auto& delta : deltas) book.apply_in_place(delta);
+    size_t i = 0;
+
+    auto before = mde::bench::allocation_count();
+    for (auto _ : state) {
+        book.apply_in_place(deltas[i++ % deltas.size()]);
+        benchmark::DoNotOptimize(book);
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(BM_OrderBookApplyInPlaceDelta)->Arg(10)->Arg(25)->Arg(45);
+
+void BM_OrderBookApplySnapshot(benchmark::State& state) {
+    auto snap = make_snapshot(static_cast<int>(state.range(0)));
+    auto book = OrderBook::empty(kAsset).apply(snap);
+
+    auto before = mde::bench::allocation_count();
+    for (auto _ : state) {
+        book = book.apply(snap);
+        benchmark::DoNotOptimize(book);
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(BM_OrderBookApplySnapshot)->Arg(10)->Arg(25)->Arg(45);
+
+void BM_OrderBookApplyInPlaceSnapshot(benchmark::State& state) {
+    auto snap = make_snapshot(static_cast<int>(state.range(0)));
+    auto book = OrderBook::empty(kAsset);
+    book.apply_in_place(snap);
+
+    auto before = mde::bench::allocation_count();
+    for (auto _ : state) {
+        book.apply_in_place(snap);
+        benchmark::DoNotOptimize(book);
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(BM_OrderBookApplyInPlaceSnapshot)->Arg(10)->Arg(25)->Arg(45);
+
+void BM_OrderBookApplyInPlaceTrade(benchmark::State& state) {
+    auto book = OrderBook::empty(kAsset).apply(make_snapshot(50));
+    TradeEvent trade{{kAsset, Timestamp(200), 0}, Price(0.50), Quantity(10.0), Side::BUY, "0"};
+    book.apply_in_place(trade);
+
+    auto before = mde::bench::allocation_count();
+    for (auto _ : state) {
+        book.apply_in_place(trade);
+        benchmark::DoNotOptimize(book);
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(BM_OrderBookApplyInPlaceTrade);
+
+// Alternates the tick between 0.01 and 0.001, moving every level onto the
+// new grid each time
+void BM_OrderBookApplyInPlaceTickSizeChange(benchmark::State& state) {
+    auto book = OrderBook::empty(kAsset).apply(make_snapshot(static_cast<int>(state.range(0))));
+    const TickSizeChange changes[] = {
+        {{kAsset, Timestamp(300), 0}, Price(0.01), Price(0.001)},
+        {{kAsset, Timestamp(300), 0}, Price(0.001), Price(0.01)},
+    };
+    for (const auto& change : changes) book.apply_in_place(change);
+    size_t i = 0;
+
+    auto before = mde::bench::allocation_count();
+    for (auto _ : state) {
+        book.apply_in_place(changes[i++ % 2]);
+        benchmark::DoNotOptimize(book);
+    }
+    report_allocations(state, before);
+}
+BENCHMARK(BM_OrderBookApplyInPlaceTickSizeChange)->Arg(10)->Arg(25)->Arg(45);
+
+// What a strategy reads after every event
+void BM_OrderBookTopOfBookQueries(benchmark::State& state) {
+    auto book = OrderBook::empty(kAsset).apply(make_snapshot(45));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.spread());
+        benchmark::DoNotOptimize(book.midpoint());
+        benchmark::DoNotOptimize(book.weighted_midpoint());
+        benchmark::DoNotOptimize(book.get_depth_within(Side::BUY, 5));
+    }
+}
+BENCHMARK(BM_OrderBookTopOfBookQueries);
+
+// Price of a market order taking `levels` of the asks' 45
+void BM_OrderBookSweep(benchmark::State& state) {
+    auto book = OrderBook::empty(kAsset).apply(make_snapshot(45));
+    auto levels = static_cast<int>(state.range(0));
+    auto size = Quantity::from_units(book.get_depth_within(Side::SELL, levels - 1).units());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.get_sweep(Side::SELL, size));
+    }
+}
+BENCHMARK(BM_OrderBookSweep)->Arg(1)->Arg(10)->Arg(45);
+
+// Depth within 0..29 ticks of the best bid, all at once
+void BM_OrderBookDepthCurve(benchmark::State& state) {
+    auto book = OrderBook::empty(kAsset).apply(make_snapshot(45));
+    std::vector<Quantity> curve(30, Quantity::zero());
+    for (auto _ : state) {
+        book.get_depth_curve(Side::BUY, curve);
+        benchmark::DoNotOptimize(curve.data());
+    }
+}
+BENCHMARK(BM_OrderBookDepthCurve);
+
+} // namespace
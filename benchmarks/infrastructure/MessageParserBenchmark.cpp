@@ -0,0 +1,92 @@
+#include "infrastructure/PolymarketMessageParser.hpp"
+#include "support/AllocationCounter.hpp"
+#include "support/Capture.hpp"
+
+#ifdef MDE_HAS_SIMDJSON
+#include "infrastructure/SimdjsonMessageParser.hpp"
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace mde::infrastructure;
+
+namespace {
+
+// Capture messages by the variant index of their first event: book,
+// price_change, last_trade_price (tick_size_change is too rare to time)
+constexpr std::array<const char*, 3> kMessageTypes = {"book", "price_change", "last_trade_price"};
+
+const std::vector<std::string>& messages_of_type(size_t type) {
+    static const auto by_type = [] {
+        std::array<std::vector<std::string>, kMessageTypes.size()> out;
+        PolymarketMessageParser parser;
+        EventBatch batch;
+        for (const auto& msg : mde::bench::capture_messages()) {
+            parser.parse(msg, batch);
+            if (!batch.empty() && batch[0].index() < out.size()) out[batch[0].index()].push_back(msg);
+        }
+        return out;
+    }();
+    return by_type[type];
+}
+
+// Reports MB/s (bytes_per_second) and messages/s (items_per_second)
+void run_parser(benchmark::State& state, IMessageParser& parser,
+                const std::vector<std::string>& msgs = mde::bench::capture_messages()) {
+    if (msgs.empty()) {
+        state.SkipWithError("no messages of this type in the capture");
+        return;
+    }
+    size_t bytes = 0;
+    size_t i = 0;
+
+    // One batch for every message, as PolymarketClient::dispatch does
+    EventBatch batch;
+    auto before = mde::bench::allocation_count();
+    for (auto _ : state) {
+        const auto& msg = msgs[i++ % msgs.size()];
+        parser.parse(msg, batch);
+        benchmark::DoNotOptimize(batch);
+        bytes += msg.size();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations());
+    state.counters["allocs_per_msg"] = benchmark::Counter(
+        static_cast<double>(mde::bench::allocation_count() - before),
+        benchmark::Counter::kAvgIterations);
+}
+
+void BM_ParseNlohmann(benchmark::State& state) {
+    PolymarketMessageParser parser;
+    run_parser(state, parser);
+}
+BENCHMARK(BM_ParseNlohmann);
+
+// One message type at a time: state.range(0) indexes kMessageTypes
+void BM_ParseNlohmannByType(benchmark::State& state) {
+    PolymarketMessageParser parser;
+    run_parser(state, parser, messages_of_type(static_cast<size_t>(state.range(0))));
+    state.SetLabel(kMessageTypes[state.range(0)]);
+}
+BENCHMARK(BM_ParseNlohmannByType)->DenseRange(0, kMessageTypes.size() - 1);
+
+#ifdef MDE_HAS_SIMDJSON
+void BM_ParseSimdjson(benchmark::State& state) {
+    SimdjsonMessageParser parser;
+    run_parser(state, parser);
+}
+BENCHMARK(BM_ParseSimdjson);
+
+void BM_ParseSimdjsonByType(benchmark::State& state) {
+    SimdjsonMessageParser parser;
+    run_parser(state, parser, messages_of_type(static_cast<size_t>(state.range(0))));
+    state.SetLabel(kMessageTypes[state.range(0)]);
+}
+BENCHMARK(BM_ParseSimdjsonByType)->DenseRange(0, kMessageTypes.size() - 1);
+#endif
+
+} // namespace
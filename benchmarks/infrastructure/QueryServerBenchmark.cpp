@@ -0,0 +1,97 @@
+#include "infrastructure/QueryServer.hpp"
+#include "repositories/InMemoryOrderBookRepository.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::infrastructure;
+using namespace mde::infrastructure::query;
+using namespace mde::services;
+
+namespace {
+
+constexpr int kAssets = 1000;
+
+class IdleFeed : public IMarketDataFeed {
+public:
+    void set_on_event(EventCallback) override {}
+    void subscribe(const std::string&) override {}
+    void start() override {}
+    void stop() override {}
+};
+
+std::string token_of(int asset) {
+    return std::to_string(100000 + asset);
+}
+
+// A service holding kAssets ten-level books, and a server over it. Built
+// once and shared by every benchmark thread.
+struct QueryFixture {
+    mde::repositories::InMemoryOrderBookRepository repo;
+    IdleFeed feed;
+    OrderBookService service{repo, feed, 0};
+    std::unique_ptr<QueryServer> server;
+
+    QueryFixture() {
+        for (int asset = 0; asset < kAssets; ++asset) {
+            std::vector<PriceLevel> bids, asks;
+            for (int level = 0; level < 10; ++level) {
+                bids.emplace_back(Price::from_micros(490000 - level * 1000), Quantity(100.0));
+                asks.emplace_back(Price::from_micros(510000 + level * 1000), Quantity(100.0));
+            }
+            service.on_event(BookSnapshot{{MarketAsset("0xbench", token_of(asset)), Timestamp(1000), 0},
+                                          std::move(bids), std::move(asks), ""});
+        }
+        QueryServerOptions options;
+        options.host = "127.0.0.1";
+        options.port = 0;
+        options.threads = 4;
+        server = std::make_unique<QueryServer>(service, options);
+        server->start();
+    }
+};
+
+QueryFixture& fixture() {
+    static QueryFixture instance;
+    return instance;
+}
+
+// Round trips of one request carrying range(0) queries from each client
+// thread, every client on its own connection. Iteration time is the
+// request latency; items/s counts queries answered across all threads.
+void run_queries(benchmark::State& state, QueryKind kind, uint16_t depth) {
+    auto& shared = fixture();
+    QueryClient client("127.0.0.1", shared.server->port());
+    std::vector<Query> queries;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        queries.push_back(Query{kind, token_of(static_cast<int>((i * 7 + state.thread_index() * 131) % kAssets)),
+                                depth});
+    }
+
+    for (auto _ : state) {
+        auto response = client.query(queries);
+        benchmark::DoNotOptimize(response);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_QueryTopOfBook(benchmark::State& state) {
+    run_queries(state, QueryKind::book, 5);
+}
+BENCHMARK(BM_QueryTopOfBook)->Arg(1)->Arg(100)->Threads(1)->Threads(4)->Threads(8)->UseRealTime();
+
+void BM_QueryMidpoint(benchmark::State& state) {
+    run_queries(state, QueryKind::midpoint, 0);
+}
+BENCHMARK(BM_QueryMidpoint)->Arg(1)->Arg(100)->Threads(1)->Threads(4)->Threads(8)->UseRealTime();
+
+void BM_QueryFullBook(benchmark::State& state) {
+    run_queries(state, QueryKind::book, 0);
+}
+BENCHMARK(BM_QueryFullBook)->Arg(100)->Threads(1)->Threads(8)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,181 @@
+#include "infrastructure/MessageParserFactory.hpp"
+#include "repositories/parquet/ParquetOrderBookRepository.hpp"
+#include "services/OrderBookService.hpp"
+#include "support/Capture.hpp"
+
+#include <arrow/filesystem/api.h>
+#include <arrow/filesystem/mockfs.h>
+#include <benchmark/benchmark.h>
+
+#include <set>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::infrastructure;
+using namespace mde::repositories::pq;
+using namespace mde::services;
+
+namespace {
+
+const char* const kProfiles[] = {"default", "fast", "compact"};
+
+// The capture replayed this many times, so files hold thousands of events
+// and footers don't dominate bytes/event
+constexpr int kCapturePasses = 20;
+
+// Every captured event, numbered as the service would number them
+const std::vector<OrderBookEventVariant>& capture_events() {
+    static const std::vector<OrderBookEventVariant> events = [] {
+        std::vector<OrderBookEventVariant> out;
+        auto parser = make_message_parser("nlohmann");
+        EventBatch batch;
+        for (int pass = 0; pass < kCapturePasses; ++pass) {
+            for (const auto& msg : mde::bench::capture_messages()) {
+                parser->parse(msg, batch);
+                for (auto& event : batch) {
+                    std::visit([&](auto& e) { e.sequence_number = out.size() + 1; }, event);
+                    out.push_back(std::move(event));
+                }
+            }
+        }
+        return out;
+    }();
+    return events;
+}
+
+std::vector<MarketAsset> capture_assets() {
+    std::set<MarketAsset> assets;
+    for (const auto& event : capture_events()) {
+        std::visit([&](const auto& e) { assets.insert(e.asset); }, event);
+    }
+    return {assets.begin(), assets.end()};
+}
+
+std::shared_ptr<arrow::fs::FileSystem> make_fs() {
+    auto mock_fs = std::make_shared<arrow::fs::internal::MockFileSystem>(
+        arrow::fs::TimePoint(std::chrono::seconds(0)));
+    return std::make_shared<arrow::fs::SubTreeFileSystem>("/", mock_fs);
+}
+
+mde::config::StorageSettings profile_settings(int64_t profile) {
+    mde::config::StorageSettings settings;
+    settings.write_buffer_size = 4096;
+    settings.parquet = *mde::config::ParquetWriterSettings::named(kProfiles[profile]);
+    return settings;
+}
+
+void write_capture(const std::shared_ptr<arrow::fs::FileSystem>& fs,
+                   const mde::config::StorageSettings& settings) {
+    ParquetOrderBookRepository repo(fs, settings);
+    for (const auto& event : capture_events()) repo.append_event(event);
+}  // the destructor flushes
+
+int64_t event_file_bytes(arrow::fs::FileSystem& fs) {
+    arrow::fs::FileSelector selector;
+    selector.base_dir = "events";
+    selector.recursive = true;
+    int64_t bytes = 0;
+    for (const auto& info : fs.GetFileInfo(selector).ValueOrDie()) {
+        if (info.IsFile()) bytes += info.size();
+    }
+    return bytes;
+}
+
+// Write every captured event under profile state.range(0), flushing at
+// 4096 events per file as production does
+void BM_ParquetWrite(benchmark::State& state) {
+    const auto settings = profile_settings(state.range(0));
+    const auto& events = capture_events();
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        auto fs = make_fs();
+        write_capture(fs, settings);
+        state.PauseTiming();
+        bytes = event_file_bytes(*fs);
+        state.ResumeTiming();
+    }
+    state.SetLabel(kProfiles[state.range(0)]);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+    state.counters["bytes_per_event"] =
+        static_cast<double>(bytes) / static_cast<double>(events.size());
+}
+BENCHMARK(BM_ParquetWrite)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+// Read every asset's events back from files written under profile state.range(0)
+void BM_ParquetRead(benchmark::State& state) {
+    const auto settings = profile_settings(state.range(0));
+    auto fs = make_fs();
+    write_capture(fs, settings);
+    const auto assets = capture_assets();
+
+    int64_t events = 0;
+    for (auto _ : state) {
+        // A fresh repository each time, so manifests are read as on recovery
+        ParquetOrderBookRepository repo(fs, settings);
+        for (const auto& asset : assets) {
+            auto read = repo.get_events_since(asset, 0);
+            events += static_cast<int64_t>(read.size());
+            benchmark::DoNotOptimize(read.data());
+        }
+    }
+    state.SetLabel(kProfiles[state.range(0)]);
+    state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_ParquetRead)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+// Stream every asset's events in one merged pass, as ReplayEngine does
+void BM_ParquetReplay(benchmark::State& state) {
+    const auto settings = profile_settings(state.range(0));
+    auto fs = make_fs();
+    write_capture(fs, settings);
+    const auto assets = capture_assets();
+
+    int64_t events = 0;
+    for (auto _ : state) {
+        ParquetOrderBookRepository repo(fs, settings);
+        events += static_cast<int64_t>(repo.replay_events(assets, 0, [](OrderBookEventVariant&& event) {
+            benchmark::DoNotOptimize(event);
+            return true;
+        }));
+    }
+    state.SetLabel(kProfiles[state.range(0)]);
+    state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_ParquetReplay)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+// The service is driven directly; the feed only has to exist
+class IdleFeed : public IMarketDataFeed {
+public:
+    void set_on_event(EventCallback) override {}
+    void subscribe(const std::string&) override {}
+    void start() override {}
+    void stop() override {}
+};
+
+// Parse and ingest one message per iteration into a Parquet repository
+// under profile state.range(0), with its flushes, as in production
+void BM_IngestParquet(benchmark::State& state) {
+    const auto settings = profile_settings(state.range(0));
+    const auto& msgs = mde::bench::capture_messages();
+    auto parser = make_message_parser("nlohmann");
+    IdleFeed feed;
+    ParquetOrderBookRepository repo(make_fs(), settings);
+    OrderBookService service(repo, feed, 0);
+    EventBatch batch;
+    size_t i = 0;
+    int64_t events = 0;
+
+    for (auto _ : state) {
+        parser->parse(msgs[i++ % msgs.size()], batch);
+        service.on_events(std::span(batch.begin(), batch.end()));
+        events += static_cast<int64_t>(batch.size());
+    }
+    state.SetLabel(kProfiles[state.range(0)]);
+    state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_IngestParquet)->DenseRange(0, 2);
+
+} // namespace
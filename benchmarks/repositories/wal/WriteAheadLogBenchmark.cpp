@@ -0,0 +1,43 @@
+#include "repositories/wal/WriteAheadLog.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+
+using namespace mde::domain;
+using namespace mde::repositories::wal;
+
+namespace {
+
+// A typical price_change message: one level on one side
+BookDelta make_delta(uint64_t seq) {
+    return BookDelta{{MarketAsset("0xbd31dc", "6581861"), Timestamp(1757908892351), seq},
+                     {PriceLevelDelta{"6581861", Price(0.49), Quantity(120.0), Side::BUY,
+                                      Price(0.49), Price(0.51)}}};
+}
+
+// Append cost with fdatasync every state.range(0) ms (-1: never)
+void BM_WalAppend(benchmark::State& state) {
+    auto dir = std::filesystem::temp_directory_path() / "mde_bench_wal";
+    std::filesystem::remove_all(dir);
+    {
+        WalOptions options;
+        options.directory = dir.string();
+        options.sync_interval = std::chrono::milliseconds(state.range(0));
+        WriteAheadLog log(options);
+
+        OrderBookEventVariant event = make_delta(0);
+        uint64_t seq = 0;
+        for (auto _ : state) {
+            std::get<BookDelta>(event).sequence_number = ++seq;
+            benchmark::DoNotOptimize(log.append(event));
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(static_cast<int64_t>(log.stats().bytes_appended));
+        state.counters["syncs"] = static_cast<double>(log.stats().syncs);
+    }
+    std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_WalAppend)->Arg(-1)->Arg(10)->Arg(0);
+
+} // namespace
@@ -0,0 +1,185 @@
+#include "infrastructure/MessageParserFactory.hpp"
+#include "services/OrderBookService.hpp"
+#include "support/AllocationCounter.hpp"
+#include "support/Capture.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::infrastructure;
+using namespace mde::services;
+
+namespace {
+
+// The service is driven directly; the feed only has to exist
+class IdleFeed : public IMarketDataFeed {
+public:
+    void set_on_event(EventCallback) override {}
+    void subscribe(const std::string&) override {}
+    void start() override {}
+    void stop() override {}
+};
+
+// Buffers events and drops them in batches, as the Parquet repository does
+// when it flushes, so every stored event costs what it would in production
+class BufferingRepository : public mde::repositories::IOrderBookRepository {
+public:
+    void append_event(const OrderBookEventVariant& event) override {
+        buffer_.push_back(event);
+        flush_if_full();
+    }
+
+    void append_event(OrderBookEventVariant&& event) override {
+        buffer_.push_back(std::move(event));
+        flush_if_full();
+    }
+
+    std::vector<OrderBookEventVariant> get_events_since(const MarketAsset&, uint64_t) const override {
+        return {};
+    }
+    uint64_t max_sequence_number() const override { return 0; }
+    void store_snapshot(const OrderBook&) override {}
+    std::optional<OrderBook> get_latest_snapshot(const MarketAsset&) const override {
+        return std::nullopt;
+    }
+    std::optional<OrderBook> get_latest_snapshot_by_token(const std::string&) const override {
+        return std::nullopt;
+    }
+    void store_checkpoint(const std::vector<OrderBook>&) override {}
+    std::vector<OrderBook> load_checkpoint() const override { return {}; }
+
+private:
+    static constexpr size_t kFlushEvents = 4096;
+
+    void flush_if_full() {
+        if (buffer_.size() < kFlushEvents) return;
+        buffer_.clear();
+    }
+
+    std::vector<OrderBookEventVariant> buffer_;
+};
+
+#ifdef MDE_HAS_SIMDJSON
+const char* const kParser = "simdjson";
+#else
+const char* const kParser = "nlohmann";
+#endif
+
+// Parse each message into one reused batch and hand its events to the
+// service, as PolymarketClient::dispatch does. Allocations cover the whole
+// path, parser included: a moved-out event takes its vectors with it, so
+// the parser has to allocate fresh ones for the next message.
+template <typename Handoff>
+void run_ingest(benchmark::State& state, Handoff handoff) {
+    const auto& msgs = mde::bench::capture_messages();
+    auto parser = make_message_parser(kParser);
+    IdleFeed feed;
+    BufferingRepository repo;
+    OrderBookService service(repo, feed, 0);
+    EventBatch batch;
+    size_t i = 0;
+    int64_t events = 0;
+
+    auto allocations = mde::bench::allocation_count();
+    auto bytes = mde::bench::allocated_bytes();
+    for (auto _ : state) {
+        parser->parse(msgs[i++ % msgs.size()], batch);
+        handoff(service, batch);
+        events += static_cast<int64_t>(batch.size());
+    }
+    auto per_event = [&](uint64_t total) {
+        return benchmark::Counter(static_cast<double>(total) / static_cast<double>(events));
+    };
+    state.SetItemsProcessed(events);
+    state.counters["allocs_per_event"] = per_event(mde::bench::allocation_count() - allocations);
+    state.counters["bytes_allocated_per_event"] = per_event(mde::bench::allocated_bytes() - bytes);
+}
+
+void BM_IngestCopied(benchmark::State& state) {
+    run_ingest(state, [](OrderBookService& service, const EventBatch& batch) {
+        for (const auto& event : batch) service.on_event(event);
+    });
+}
+BENCHMARK(BM_IngestCopied);
+
+void BM_IngestMoved(benchmark::State& state) {
+    run_ingest(state, [](OrderBookService& service, EventBatch& batch) {
+        for (auto& event : batch) service.on_event(std::move(event));
+    });
+}
+BENCHMARK(BM_IngestMoved);
+
+// The whole message at once, runs of one asset applied together
+void BM_IngestBatched(benchmark::State& state) {
+    run_ingest(state, [](OrderBookService& service, EventBatch& batch) {
+        service.on_events(std::span(batch.begin(), batch.end()));
+    });
+}
+BENCHMARK(BM_IngestBatched);
+
+class DiscardingRepository : public mde::repositories::IOrderBookRepository {
+public:
+    void append_event(const OrderBookEventVariant&) override {}
+    std::vector<OrderBookEventVariant> get_events_since(const MarketAsset&, uint64_t) const override {
+        return {};
+    }
+    uint64_t max_sequence_number() const override { return 0; }
+    void store_snapshot(const OrderBook&) override {}
+    std::optional<OrderBook> get_latest_snapshot(const MarketAsset&) const override {
+        return std::nullopt;
+    }
+    std::optional<OrderBook> get_latest_snapshot_by_token(const std::string&) const override {
+        return std::nullopt;
+    }
+    void store_checkpoint(const std::vector<OrderBook>&) override {}
+    std::vector<OrderBook> load_checkpoint() const override { return {}; }
+};
+
+// Heap bytes a fresh service allocates per tracked market while range(0)
+// ten-level books arrive, ladders included. The events are built before
+// the count starts.
+void BM_MemoryPerMarket(benchmark::State& state) {
+    const auto markets = static_cast<int>(state.range(0));
+    std::vector<MarketAsset> assets;
+    for (int market = 0; market < markets; ++market) {
+        assets.emplace_back("0xmemory", std::to_string(200000 + market));
+    }
+    uint64_t bytes = 0;
+    int64_t runs = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<OrderBookEventVariant> events;
+        events.reserve(assets.size());
+        for (const auto& asset : assets) {
+            std::vector<PriceLevel> bids, asks;
+            for (int level = 0; level < 10; ++level) {
+                bids.emplace_back(Price::from_micros(490000 - level * 10000), Quantity(100.0));
+                asks.emplace_back(Price::from_micros(510000 + level * 10000), Quantity(100.0));
+            }
+            events.emplace_back(BookSnapshot{{asset, Timestamp(1000), 0}, std::move(bids), std::move(asks), ""});
+        }
+        DiscardingRepository repo;
+        IdleFeed feed;
+        state.ResumeTiming();
+
+        auto before = mde::bench::allocated_bytes();
+        {
+            OrderBookService service(repo, feed, 0);
+            for (auto& event : events) service.on_event(std::move(event));
+            bytes += mde::bench::allocated_bytes() - before;
+            benchmark::DoNotOptimize(service.book_count());
+        }
+        ++runs;
+    }
+    state.counters["bytes_per_market"] =
+        benchmark::Counter(static_cast<double>(bytes) / static_cast<double>(runs * markets));
+}
+BENCHMARK(BM_MemoryPerMarket)->Arg(1000)->Arg(10000);
+
+} // namespace
@@ -0,0 +1,60 @@
+#include "infrastructure/MessageParserFactory.hpp"
+#include "services/analytics/AnalyticsService.hpp"
+#include "support/AllocationCounter.hpp"
+#include "support/Capture.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <variant>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::services::analytics;
+
+namespace {
+
+// Every captured event, numbered as the service would number them
+const std::vector<OrderBookEventVariant>& capture_events() {
+    static const std::vector<OrderBookEventVariant> events = [] {
+        std::vector<OrderBookEventVariant> out;
+        auto parser = mde::infrastructure::make_message_parser("nlohmann");
+        mde::infrastructure::EventBatch batch;
+        for (const auto& msg : mde::bench::capture_messages()) {
+            parser->parse(msg, batch);
+            for (auto& event : batch) {
+                std::visit([&](auto& e) { e.sequence_number = out.size() + 1; }, event);
+                out.push_back(std::move(event));
+            }
+        }
+        return out;
+    }();
+    return events;
+}
+
+// Publish the capture and let the analytics consumer apply it. After a
+// warm-up pass the books have their levels, so the steady state should
+// allocate only the bus entries.
+void BM_AnalyticsApply(benchmark::State& state) {
+    const auto& events = capture_events();
+    AnalyticsService::EventStream bus(events.size());
+    AnalyticsService analytics(bus);
+    for (const auto& event : events) bus.publish(event);
+    analytics.poll();
+
+    uint64_t allocations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (const auto& event : events) bus.publish(event);
+        auto before = mde::bench::allocation_count();
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(analytics.poll());
+        allocations += mde::bench::allocation_count() - before;
+    }
+    auto processed = state.iterations() * static_cast<int64_t>(events.size());
+    state.SetItemsProcessed(processed);
+    state.counters["allocs_per_event"] =
+        static_cast<double>(allocations) / static_cast<double>(processed);
+}
+BENCHMARK(BM_AnalyticsApply);
+
+} // namespace
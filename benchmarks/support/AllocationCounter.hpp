@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+namespace mde::bench {
+
+// Number of global operator new calls made by this process so far.
+// The benchmark binary replaces the global allocation functions to count them.
+uint64_t allocation_count() noexcept;
+
+// Bytes requested from those calls so far
+uint64_t allocated_bytes() noexcept;
+
+} // namespace mde::bench
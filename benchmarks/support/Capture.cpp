@@ -0,0 +1,28 @@
+#include "support/Capture.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+namespace mde::bench {
+
+const std::vector<std::string>& capture_messages() {
+    static const std::vector<std::string> loaded = [] {
+        const char* capture = std::getenv("MDE_BENCH_CAPTURE");
+        std::string path = capture ? capture : MDE_BENCH_FIXTURES_DIR "/market_channel.jsonl";
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("Cannot open benchmark capture: " + path);
+
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.rfind("{", 0) == 0 || line.rfind("[{", 0) == 0) {
+                lines.push_back(std::move(line));
+            }
+        }
+        return lines;
+    }();
+    return loaded;
+}
+
+} // namespace mde::bench
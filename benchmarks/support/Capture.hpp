@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace mde::bench {
+
+// Market-channel traffic, one WebSocket message per line. Defaults to the
+// checked-in fixture; set MDE_BENCH_CAPTURE to replay a real capture
+// (e.g. `ws_listener <token_id> > capture.txt`; status lines are skipped).
+const std::vector<std::string>& capture_messages();
+
+} // namespace mde::bench
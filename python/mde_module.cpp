@@ -0,0 +1,285 @@
+// Python bindings: live books from the shared-memory region and recorded
+// events from a Parquet store, as Arrow record batches. Batches cross into
+// Python through the Arrow C Data Interface (the PyCapsule protocol), so
+// pyarrow, polars or pandas take over the buffers without a row ever being
+// turned into Python objects.
+
+#include "infrastructure/SharedBookRegion.hpp"
+#include "repositories/parquet/EventBatches.hpp"
+#include "repositories/parquet/ParquetOrderBookRepository.hpp"
+#include "repositories/parquet/ParquetSchemas.hpp"
+
+#include <arrow/api.h>
+#include <arrow/c/abi.h>
+#include <arrow/c/bridge.h>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace py = pybind11;
+
+using namespace mde::domain;
+using mde::infrastructure::SharedBook;
+using mde::infrastructure::SharedBookReader;
+using mde::repositories::pq::ParquetOrderBookRepository;
+using mde::repositories::pq::ParquetSchemas;
+
+namespace {
+
+// --- Arrow C Data Interface ---
+
+void release_schema(PyObject* capsule) {
+    auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(capsule, "arrow_schema"));
+    if (schema->release) schema->release(schema);
+    delete schema;
+}
+
+void release_array(PyObject* capsule) {
+    auto* array = static_cast<ArrowArray*>(PyCapsule_GetPointer(capsule, "arrow_array"));
+    if (array->release) array->release(array);
+    delete array;
+}
+
+void check(const arrow::Status& status) {
+    if (!status.ok()) throw std::runtime_error(status.ToString());
+}
+
+py::capsule schema_capsule(const arrow::Schema& schema) {
+    auto exported = std::make_unique<ArrowSchema>();
+    check(arrow::ExportSchema(schema, exported.get()));
+    return py::capsule(exported.release(), "arrow_schema", &release_schema);
+}
+
+// A record batch Python can import without copying: any consumer of the
+// Arrow PyCapsule interface (pyarrow.record_batch(batch), polars.from_arrow,
+// ...) ends up holding the same buffers, which stay alive until it lets go
+struct Batch {
+    std::shared_ptr<arrow::RecordBatch> batch;
+
+    py::capsule arrow_c_schema() const { return schema_capsule(*batch->schema()); }
+
+    // The requested schema is ignored; the batch is always in its own
+    py::tuple arrow_c_array(const py::object& /*requested_schema*/) const {
+        auto schema = schema_capsule(*batch->schema());
+        auto array = std::make_unique<ArrowArray>();
+        check(arrow::ExportRecordBatch(*batch, array.get()));
+        return py::make_tuple(schema, py::capsule(array.release(), "arrow_array", &release_array));
+    }
+};
+
+// --- Live books ---
+
+std::shared_ptr<arrow::RecordBatch> book_levels_batch(const std::vector<SharedBook>& books) {
+    auto schema = ParquetSchemas::book_levels_schema();
+
+    arrow::StringBuilder token_builder;
+    arrow::Int64Builder timestamp_builder;
+    arrow::UInt64Builder seq_builder;
+    arrow::BooleanBuilder stale_builder;
+
+    auto bid_prices_builder = std::make_shared<arrow::Int64Builder>();
+    auto bid_sizes_builder = std::make_shared<arrow::Int64Builder>();
+    auto ask_prices_builder = std::make_shared<arrow::Int64Builder>();
+    auto ask_sizes_builder = std::make_shared<arrow::Int64Builder>();
+
+    arrow::ListBuilder bid_prices_list(arrow::default_memory_pool(), bid_prices_builder);
+    arrow::ListBuilder bid_sizes_list(arrow::default_memory_pool(), bid_sizes_builder);
+    arrow::ListBuilder ask_prices_list(arrow::default_memory_pool(), ask_prices_builder);
+    arrow::ListBuilder ask_sizes_list(arrow::default_memory_pool(), ask_sizes_builder);
+
+    for (const auto& book : books) {
+        (void)token_builder.Append(book.token);
+        (void)timestamp_builder.Append(book.timestamp_ms);
+        (void)seq_builder.Append(book.last_sequence_number);
+        (void)stale_builder.Append(book.stale);
+
+        (void)bid_prices_list.Append();
+        (void)bid_sizes_list.Append();
+        for (const auto& level : book.bids) {
+            (void)bid_prices_builder->Append(level.price);
+            (void)bid_sizes_builder->Append(level.size);
+        }
+
+        (void)ask_prices_list.Append();
+        (void)ask_sizes_list.Append();
+        for (const auto& level : book.asks) {
+            (void)ask_prices_builder->Append(level.price);
+            (void)ask_sizes_builder->Append(level.size);
+        }
+    }
+
+    std::shared_ptr<arrow::Array> arr_tid, arr_ts, arr_seq, arr_stale;
+    std::shared_ptr<arrow::Array> arr_bp, arr_bs, arr_ap, arr_as;
+    (void)token_builder.Finish(&arr_tid);
+    (void)timestamp_builder.Finish(&arr_ts);
+    (void)seq_builder.Finish(&arr_seq);
+    (void)stale_builder.Finish(&arr_stale);
+    (void)bid_prices_list.Finish(&arr_bp);
+    (void)bid_sizes_list.Finish(&arr_bs);
+    (void)ask_prices_list.Finish(&arr_ap);
+    (void)ask_sizes_list.Finish(&arr_as);
+
+    return arrow::RecordBatch::Make(schema, arr_tid->length(),
+        {arr_tid, arr_ts, arr_seq, arr_stale, arr_bp, arr_bs, arr_ap, arr_as});
+}
+
+// Reads the region a running engine publishes with MDE_SHM_NAME
+class BookReader {
+public:
+    explicit BookReader(const std::string& name) : reader_(name) {}
+
+    // The named books the engine has published, or every published book
+    Batch read(const std::optional<std::vector<std::string>>& tokens) {
+        std::vector<SharedBook> books;
+        {
+            py::gil_scoped_release release;
+            if (tokens) {
+                books.reserve(tokens->size());
+                for (const auto& token : *tokens) {
+                    if (auto book = reader_.read(token)) books.push_back(std::move(*book));
+                }
+            } else {
+                SharedBook book;
+                for (uint32_t slot = 0; slot < reader_.slot_count(); ++slot) {
+                    if (reader_.read(slot, book)) books.push_back(book);
+                }
+            }
+        }
+        return Batch{book_levels_batch(books)};
+    }
+
+    size_t slot_count() const noexcept { return reader_.slot_count(); }
+    size_t depth() const noexcept { return reader_.depth(); }
+
+private:
+    SharedBookReader reader_;
+};
+
+// --- Recorded events ---
+
+constexpr std::array<const char*, 4> kEventKinds = {"book_snapshot", "book_delta", "trade_event", "tick_size_change"};
+
+// Deltas use the nested schema, which holds any delta
+std::shared_ptr<arrow::RecordBatch> event_batch(size_t kind, const std::vector<OrderBookEventVariant>& events) {
+    using namespace mde::repositories::pq;
+    switch (kind) {
+        case 0: return book_snapshot_batch(events);
+        case 1: return book_delta_batch(events);
+        case 2: return trade_event_batch(events);
+        default: return tick_size_change_batch(events);
+    }
+}
+
+// One batch per event kind present, keyed by kind
+py::dict event_batches(std::array<std::vector<OrderBookEventVariant>, kEventKinds.size()>& by_kind) {
+    py::dict batches;
+    for (size_t kind = 0; kind < by_kind.size(); ++kind) {
+        if (by_kind[kind].empty()) continue;
+        batches[kEventKinds[kind]] = Batch{event_batch(kind, by_kind[kind])};
+        by_kind[kind].clear();
+    }
+    return batches;
+}
+
+// Read-only view of a Parquet event store on local disk (MDE_DATA_DIR)
+class EventStore {
+public:
+    explicit EventStore(const std::string& path) {
+        mde::config::StorageSettings settings;
+        settings.mmap_reads = true;
+        repo_ = std::make_unique<ParquetOrderBookRepository>(
+            ParquetOrderBookRepository::make_local_fs(path, settings.mmap_reads), settings,
+            mde::repositories::pq::Access::read_only);
+    }
+
+    py::dict events(const std::string& condition_id, const std::string& token_id, uint64_t after) const {
+        std::array<std::vector<OrderBookEventVariant>, kEventKinds.size()> by_kind;
+        {
+            py::gil_scoped_release release;
+            for (auto& event : repo_->get_events_since(MarketAsset(condition_id, token_id), after)) {
+                auto kind = event.index();
+                by_kind[kind].push_back(std::move(event));
+            }
+        }
+        return event_batches(by_kind);
+    }
+
+    // Streams the events of `assets` after `after` in sequence order,
+    // calling on_batches with a dict of batches per kind every batch_rows
+    // events; each call covers the next range of sequence numbers. Returns
+    // the events streamed; on_batches returning False stops the replay.
+    uint64_t replay(const std::vector<std::pair<std::string, std::string>>& assets, const py::function& on_batches,
+                    uint64_t after, size_t batch_rows) const {
+        if (batch_rows == 0) throw std::invalid_argument("batch_rows must be positive");
+        std::vector<MarketAsset> wanted;
+        wanted.reserve(assets.size());
+        for (const auto& [condition_id, token_id] : assets) wanted.emplace_back(condition_id, token_id);
+
+        std::array<std::vector<OrderBookEventVariant>, kEventKinds.size()> by_kind;
+        size_t buffered = 0;
+        bool stopped = false;
+        auto hand_over = [&] {
+            py::gil_scoped_acquire acquire;
+            auto keep_going = on_batches(event_batches(by_kind));
+            buffered = 0;
+            stopped = !keep_going.is_none() && !keep_going.cast<bool>();
+        };
+
+        uint64_t streamed = 0;
+        {
+            py::gil_scoped_release release;
+            repo_->replay_events(wanted, after, [&](OrderBookEventVariant&& event) {
+                auto kind = event.index();
+                by_kind[kind].push_back(std::move(event));
+                ++streamed;
+                if (++buffered == batch_rows) hand_over();
+                return !stopped;
+            });
+            if (buffered > 0 && !stopped) hand_over();
+        }
+        return streamed;
+    }
+
+private:
+    std::unique_ptr<ParquetOrderBookRepository> repo_;
+};
+
+} // namespace
+
+PYBIND11_MODULE(mde, m) {
+    m.doc() = "Market data engine books and events as Arrow record batches. Prices and sizes are "
+              "int64 micro-units (value * 10^6).";
+
+    py::class_<Batch>(m, "Batch", "Arrow record batch; pass it to pyarrow.record_batch() or any Arrow "
+                                  "PyCapsule consumer")
+        .def("__arrow_c_schema__", &Batch::arrow_c_schema)
+        .def("__arrow_c_array__", &Batch::arrow_c_array, py::arg("requested_schema") = py::none())
+        .def("__len__", [](const Batch& batch) { return batch.batch->num_rows(); })
+        .def_property_readonly("num_rows", [](const Batch& batch) { return batch.batch->num_rows(); })
+        .def("to_pyarrow", [](const py::object& self) {
+            return py::module_::import("pyarrow").attr("record_batch")(self);
+        });
+
+    py::class_<BookReader>(m, "BookReader", "Live top levels of the books an engine publishes to shared memory")
+        .def(py::init<const std::string&>(), py::arg("name"))
+        .def("read", &BookReader::read, py::arg("tokens") = py::none())
+        .def_property_readonly("slot_count", &BookReader::slot_count)
+        .def_property_readonly("depth", &BookReader::depth);
+
+    py::class_<EventStore>(m, "EventStore", "Recorded events of a local Parquet store, by kind")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def("events", &EventStore::events, py::arg("condition_id"), py::arg("token_id"), py::arg("after") = 0)
+        .def("replay", &EventStore::replay, py::arg("assets"), py::arg("on_batches"), py::arg("after") = 0,
+             py::arg("batch_rows") = 65536);
+}
@@ -28,27 +28,133 @@ int env_int_or(const char* name, int fallback) {
     }
 }
 
+double env_double_or(const char* name, double fallback) {
+    const char* val = std::getenv(name);
+    if (!val) return fallback;
+    try {
+        return std::stod(val);
+    } catch (...) {
+        return fallback;
+    }
+}
+
 } // namespace
 
+std::optional<ParquetWriterSettings> ParquetWriterSettings::named(const std::string& profile) {
+    ParquetWriterSettings p;
+    p.profile = profile;
+    if (profile == "default") return p;
+    if (profile == "fast") {
+        p.codec = "snappy";
+        p.numeric_encoding = "plain";
+        p.row_group_rows = 1024;
+        return p;
+    }
+    if (profile == "compact") {
+        p.codec = "zstd";
+        p.codec_level = 6;
+        p.numeric_encoding = "delta";
+        p.row_group_rows = 4096;
+        return p;
+    }
+    return std::nullopt;
+}
+
 Settings Settings::from_environment() {
     std::string env = env_or("MDE_ENV", "development");
     Settings s = (env == "production") ? production() : development();
     s.websocket.url = env_or("MDE_WEBSOCKET_URL", s.websocket.url);
     s.websocket.ping_interval_seconds = env_int_or("MDE_PING_INTERVAL", s.websocket.ping_interval_seconds);
+    s.websocket.parser_backend = env_or("MDE_PARSER_BACKEND", s.websocket.parser_backend);
+    s.websocket.parse_queue_capacity = env_int_or("MDE_PARSE_QUEUE_CAPACITY", s.websocket.parse_queue_capacity);
+    s.websocket.connections = env_int_or("MDE_WS_CONNECTIONS", s.websocket.connections);
+    s.websocket.reconnect_min_wait_ms = env_int_or("MDE_WS_RECONNECT_MIN_MS", s.websocket.reconnect_min_wait_ms);
+    s.websocket.reconnect_max_wait_ms = env_int_or("MDE_WS_RECONNECT_MAX_MS", s.websocket.reconnect_max_wait_ms);
+    s.websocket.cpus = env_or("MDE_WS_CPUS", s.websocket.cpus);
     s.api.gamma_api_base_url = env_or("MDE_GAMMA_API_URL", s.api.gamma_api_base_url);
     s.service.snapshot_interval_seconds = env_int_or("MDE_SNAPSHOT_INTERVAL", s.service.snapshot_interval_seconds);
+    s.service.snapshot_every_events = env_int_or("MDE_SNAPSHOT_EVERY_EVENTS", s.service.snapshot_every_events);
+    s.service.ingest_shards = env_int_or("MDE_INGEST_SHARDS", s.service.ingest_shards);
+    s.service.ingest_queue_capacity = env_int_or("MDE_INGEST_QUEUE_CAPACITY", s.service.ingest_queue_capacity);
+    s.service.recovery_threads = env_int_or("MDE_RECOVERY_THREADS", s.service.recovery_threads);
+    s.service.snapshot_mode = env_or("MDE_SNAPSHOT_MODE", s.service.snapshot_mode);
+    s.service.checkpoint_interval_seconds = env_int_or("MDE_CHECKPOINT_INTERVAL", s.service.checkpoint_interval_seconds);
+    s.service.shard_cpus = env_or("MDE_INGEST_SHARD_CPUS", s.service.shard_cpus);
+    s.service.writer_cpus = env_or("MDE_INGEST_WRITER_CPUS", s.service.writer_cpus);
+    s.service.busy_poll = env_bool_or("MDE_INGEST_BUSY_POLL", s.service.busy_poll);
+    s.service.background_cpus = env_or("MDE_BACKGROUND_CPUS", s.service.background_cpus);
     s.storage.backend = env_or("MDE_STORAGE_BACKEND", s.storage.backend);
     s.storage.data_directory = env_or("MDE_DATA_DIRECTORY", s.storage.data_directory);
     s.storage.write_buffer_size = env_int_or("MDE_WRITE_BUFFER_SIZE", s.storage.write_buffer_size);
+    s.storage.memory_max_events = env_int_or("MDE_MEMORY_MAX_EVENTS", s.storage.memory_max_events);
+    s.storage.memory_max_age_seconds = env_int_or("MDE_MEMORY_MAX_AGE", s.storage.memory_max_age_seconds);
+    s.storage.flush_threads = env_int_or("MDE_FLUSH_THREADS", s.storage.flush_threads);
+    s.storage.flush_cpus = env_or("MDE_FLUSH_CPUS", s.storage.flush_cpus);
+    s.storage.max_pending_flushes = env_int_or("MDE_MAX_PENDING_FLUSHES", s.storage.max_pending_flushes);
+    s.storage.buffer_age_seconds = env_int_or("MDE_BUFFER_AGE", s.storage.buffer_age_seconds);
+    s.storage.wal_directory = env_or("MDE_WAL_DIRECTORY", s.storage.wal_directory);
+    s.storage.wal_sync_interval_ms = env_int_or("MDE_WAL_SYNC_INTERVAL_MS", s.storage.wal_sync_interval_ms);
+    s.storage.snapshot_diffs_per_base = env_int_or("MDE_SNAPSHOT_DIFFS_PER_BASE", s.storage.snapshot_diffs_per_base);
+    s.storage.compaction_interval_seconds = env_int_or("MDE_COMPACTION_INTERVAL", s.storage.compaction_interval_seconds);
+    s.storage.hot_tail_events = env_int_or("MDE_HOT_TAIL_EVENTS", s.storage.hot_tail_events);
+    s.storage.hot_tail_age_seconds = env_int_or("MDE_HOT_TAIL_AGE", s.storage.hot_tail_age_seconds);
+    s.storage.cache_directory = env_or("MDE_CACHE_DIRECTORY", s.storage.cache_directory);
+    if (const char* profile = std::getenv("MDE_PARQUET_PROFILE")) {
+        // An unknown name is kept (with the current knobs) for main to reject
+        auto named = ParquetWriterSettings::named(profile);
+        if (named) {
+            s.storage.parquet = *named;
+        } else {
+            s.storage.parquet.profile = profile;
+        }
+    }
+    auto& parquet = s.storage.parquet;
+    parquet.codec = env_or("MDE_PARQUET_CODEC", parquet.codec);
+    parquet.codec_level = env_int_or("MDE_PARQUET_CODEC_LEVEL", parquet.codec_level);
+    parquet.dictionary = env_bool_or("MDE_PARQUET_DICTIONARY", parquet.dictionary);
+    parquet.numeric_encoding = env_or("MDE_PARQUET_NUMERIC_ENCODING", parquet.numeric_encoding);
+    parquet.row_group_rows = env_int_or("MDE_PARQUET_ROW_GROUP_ROWS", parquet.row_group_rows);
+    parquet.page_size_kb = env_int_or("MDE_PARQUET_PAGE_SIZE_KB", parquet.page_size_kb);
+    s.storage.mmap_reads = env_bool_or("MDE_MMAP_READS", s.storage.mmap_reads);
+    s.storage.pre_buffer_reads = env_bool_or("MDE_PRE_BUFFER_READS", s.storage.pre_buffer_reads);
+    s.storage.memory_pool = env_or("MDE_MEMORY_POOL", s.storage.memory_pool);
+    s.storage.read_concurrency = env_int_or("MDE_READ_CONCURRENCY", s.storage.read_concurrency);
     s.storage.s3_bucket = env_or("MDE_S3_BUCKET", s.storage.s3_bucket);
     s.storage.s3_prefix = env_or("MDE_S3_PREFIX", s.storage.s3_prefix);
     s.storage.s3_region = env_or("MDE_S3_REGION", s.storage.s3_region);
     s.storage.s3_endpoint_override = env_or("MDE_S3_ENDPOINT", s.storage.s3_endpoint_override);
     s.storage.s3_scheme = env_or("MDE_S3_SCHEME", s.storage.s3_scheme);
+    s.storage.s3_cache_directory = env_or("MDE_S3_CACHE_DIRECTORY", s.storage.s3_cache_directory);
+    s.storage.s3_cache_max_mb = env_int_or("MDE_S3_CACHE_MAX_MB", s.storage.s3_cache_max_mb);
     s.discovery.enabled = env_bool_or("MDE_DISCOVERY_ENABLED", s.discovery.enabled);
     s.discovery.max_tracked_markets = env_int_or("MDE_MAX_TRACKED_MARKETS", s.discovery.max_tracked_markets);
     s.discovery.discovery_interval_seconds = env_int_or("MDE_DISCOVERY_INTERVAL", s.discovery.discovery_interval_seconds);
     s.discovery.markets_per_poll = env_int_or("MDE_MARKETS_PER_POLL", s.discovery.markets_per_poll);
+    s.discovery.page_size = env_int_or("MDE_DISCOVERY_PAGE_SIZE", s.discovery.page_size);
+    s.discovery.fetch_concurrency = env_int_or("MDE_DISCOVERY_CONCURRENCY", s.discovery.fetch_concurrency);
+    s.analytics.enabled = env_bool_or("MDE_ANALYTICS_ENABLED", s.analytics.enabled);
+    s.analytics.vwap_trades = env_int_or("MDE_ANALYTICS_VWAP_TRADES", s.analytics.vwap_trades);
+    s.analytics.volatility_returns = env_int_or("MDE_ANALYTICS_VOLATILITY_RETURNS", s.analytics.volatility_returns);
+    s.analytics.ewma_lambda = env_double_or("MDE_ANALYTICS_EWMA_LAMBDA", s.analytics.ewma_lambda);
+    s.analytics.depth_ticks = env_int_or("MDE_ANALYTICS_DEPTH_TICKS", s.analytics.depth_ticks);
+    s.analytics.sweep_size = env_double_or("MDE_ANALYTICS_SWEEP_SIZE", s.analytics.sweep_size);
+    s.bars.enabled = env_bool_or("MDE_BARS_ENABLED", s.bars.enabled);
+    s.bars.intervals = env_or("MDE_BAR_INTERVALS", s.bars.intervals);
+    s.bars.flush_interval_seconds = env_int_or("MDE_BAR_FLUSH_INTERVAL", s.bars.flush_interval_seconds);
+    s.bars.grace_ms = env_int_or("MDE_BAR_GRACE_MS", s.bars.grace_ms);
+    s.metrics.port = env_int_or("MDE_METRICS_PORT", s.metrics.port);
+    s.metrics.host = env_or("MDE_METRICS_HOST", s.metrics.host);
+    s.shared_memory.name = env_or("MDE_SHM_NAME", s.shared_memory.name);
+    s.shared_memory.slots = env_int_or("MDE_SHM_SLOTS", s.shared_memory.slots);
+    s.shared_memory.depth = env_int_or("MDE_SHM_DEPTH", s.shared_memory.depth);
+    s.binary_feed.group = env_or("MDE_BINARY_FEED_GROUP", s.binary_feed.group);
+    s.binary_feed.port = env_int_or("MDE_BINARY_FEED_PORT", s.binary_feed.port);
+    s.binary_feed.interface_address = env_or("MDE_BINARY_FEED_INTERFACE", s.binary_feed.interface_address);
+    s.binary_feed.ttl = env_int_or("MDE_BINARY_FEED_TTL", s.binary_feed.ttl);
+    s.binary_feed.recovery_port = env_int_or("MDE_BINARY_FEED_RECOVERY_PORT", s.binary_feed.recovery_port);
+    s.query.port = env_int_or("MDE_QUERY_PORT", s.query.port);
+    s.query.host = env_or("MDE_QUERY_HOST", s.query.host);
+    s.query.threads = env_int_or("MDE_QUERY_THREADS", s.query.threads);
     return s;
 }
 
@@ -63,11 +169,25 @@ Settings Settings::development() {
 Settings Settings::production() {
     Settings s;
     s.websocket.ping_interval_seconds = 15;
+    s.websocket.parser_backend = "simdjson";
+    s.websocket.parse_queue_capacity = 4096;
+    s.websocket.connections = 4;
+    s.websocket.reconnect_max_wait_ms = 10000;
     s.service.snapshot_interval_seconds = 5;
+    s.service.ingest_shards = 4;
+    s.service.snapshot_mode = "checkpoint";
     s.storage.backend = "parquet";
     s.storage.data_directory = "data/prod";
     s.storage.write_buffer_size = 4096;
+    s.storage.flush_threads = 4;
+    s.storage.read_concurrency = 8;
+    // Durability comes from the log, so buffers can grow into large files
+    s.storage.buffer_age_seconds = 300;
+    s.storage.wal_directory = "data/prod/wal";
+    s.storage.compaction_interval_seconds = 900;
+    s.storage.parquet = *ParquetWriterSettings::named("compact");
     s.discovery.enabled = true;
+    s.metrics.port = 9464;
     return s;
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 
 namespace mde::config {
@@ -7,6 +8,20 @@ namespace mde::config {
 struct WebSocketSettings {
     std::string url = "wss://ws-subscriptions-clob.polymarket.com/ws/market";
     int ping_interval_seconds = 30;
+    std::string parser_backend = "nlohmann";  // "nlohmann" or "simdjson"
+    // > 0: the network thread only enqueues raw messages and a separate
+    // parser thread parses them; 0: parse inline on the network thread
+    int parse_queue_capacity = 0;
+    // Websockets the subscribed tokens are spread over, each with its own
+    // network (and parser) thread
+    int connections = 1;
+    // A dropped connection is retried after min, then twice as long each
+    // failed attempt, capped at max
+    int reconnect_min_wait_ms = 500;
+    int reconnect_max_wait_ms = 30000;
+    // CPUs, as a cpulist ("2", "4-7", "0,2"), for the network and parser
+    // threads; empty leaves them to the scheduler. Likewise below.
+    std::string cpus;
 };
 
 struct ApiSettings {
@@ -14,7 +29,30 @@ struct ApiSettings {
 };
 
 struct ServiceSettings {
+    // Per-asset snapshots: a book is stored after snapshot_every_events of
+    // its events, and a book with unsaved events once its last snapshot is
+    // snapshot_interval_seconds old (0 disables either)
     int snapshot_interval_seconds = 10;
+    int snapshot_every_events = 1000;
+    // Book worker threads (assets hashed across them) plus one writer thread;
+    // 0 applies and persists inline on the feed thread
+    int ingest_shards = 0;
+    int ingest_queue_capacity = 65536;
+    // Threads loading snapshots + replaying event tails on startup (0 = skip)
+    int recovery_threads = 8;
+    // "per_asset": the per-book policy above;
+    // "checkpoint": store every book in one checkpoint each
+    // checkpoint_interval_seconds, and once more on shutdown
+    std::string snapshot_mode = "per_asset";
+    int checkpoint_interval_seconds = 60;
+    // Sharded mode: shard i runs on the i-th CPU of shard_cpus (wrapping),
+    // the writer on any of writer_cpus. With busy_poll they spin while idle
+    // instead of backing off to sleeps, for cores kept free of other work.
+    std::string shard_cpus;
+    std::string writer_cpus;
+    bool busy_poll = false;
+    // Discovery and compaction threads
+    std::string background_cpus;
 };
 
 struct DiscoverySettings {
@@ -22,18 +60,142 @@ struct DiscoverySettings {
     int max_tracked_markets = 500;
     int discovery_interval_seconds = 1800;  // 30 min
     int markets_per_poll = 50;
+    int page_size = 100;           // markets per Gamma API request
+    int fetch_concurrency = 4;     // page requests in flight at once
+};
+
+// Per-asset streaming metrics computed off the service's event stream
+struct AnalyticsSettings {
+    bool enabled = false;
+    int vwap_trades = 100;         // trades in the rolling VWAP
+    int volatility_returns = 100;  // midpoint returns in the realized volatility
+    double ewma_lambda = 0.94;     // decay of the EWMA variance
+    int depth_ticks = 5;           // window of the depth imbalance
+    double sweep_size = 100.0;     // shares of the market order the sweep prices fill
+};
+
+// OHLCV and quote bars per asset, written to the Parquet store
+struct BarSettings {
+    bool enabled = false;
+    std::string intervals = "1s,1m";   // e.g. "500ms,1s,5m,1h"
+    int flush_interval_seconds = 60;   // how often closed bars are written
+    int grace_ms = 2000;               // a quiet bar closes this long after its end
+};
+
+// Prometheus scrape endpoint (GET /metrics)
+struct MetricsSettings {
+    int port = 0;  // 0 disables the endpoint
+    std::string host = "0.0.0.0";
+};
+
+// Top-of-book for co-located readers in a POSIX shared-memory region
+struct SharedMemorySettings {
+    std::string name;  // shm_open name, e.g. "/mde_books"; empty disables
+    int slots = 1024;  // assets the region can hold
+    int depth = 10;    // levels per side
+};
+
+// Binary UDP feed of every event, with TCP recovery (BinaryFeed.hpp)
+struct BinaryFeedSettings {
+    std::string group;          // multicast group, e.g. "239.255.0.1"; empty disables
+    int port = 20000;
+    std::string interface_address;  // multicast leaves by the default interface if empty
+    int ttl = 1;
+    int recovery_port = 20001;  // TCP, on every interface
+};
+
+// Batched book query API over TCP (QueryServer.hpp)
+struct QuerySettings {
+    int port = 0;  // 0 disables
+    std::string host = "0.0.0.0";
+    int threads = 2;  // event loops
+};
+
+// How the Parquet repository encodes the files it writes. Start from a
+// named profile and override single knobs:
+//   "default": Parquet's own defaults (uncompressed, dictionary everywhere)
+//   "fast":    snappy, dictionary-encoded ids, plain numbers
+//   "compact": zstd, dictionary-encoded ids, delta-encoded numbers and
+//              bigger row groups
+struct ParquetWriterSettings {
+    std::string profile = "default";
+    std::string codec = "uncompressed";   // any Arrow codec name: snappy, zstd, lz4, gzip, ...
+    int codec_level = 0;                  // 0 = the codec's default
+    // Dictionary-encode string columns (condition and token ids, hashes, fees)
+    bool dictionary = true;
+    // Integer columns (timestamps, sequence numbers, prices, sizes, sides):
+    // "dictionary", "plain", "delta" or "byte_stream_split" (which needs
+    // Arrow 17+ for integers)
+    std::string numeric_encoding = "dictionary";
+    // Rows per row group in event files. Files are seq-ordered, so smaller
+    // groups let a recovery read skip the part of a file it has already seen.
+    int row_group_rows = 256;
+    int page_size_kb = 1024;
+
+    // nullopt for an unknown name
+    static std::optional<ParquetWriterSettings> named(const std::string& profile);
 };
 
 struct StorageSettings {
     std::string backend = "memory";       // "memory", "parquet", or "s3"
     std::string data_directory = "data";
     int write_buffer_size = 1024;
+    // Memory: event history kept per asset, the newest this many events and
+    // at most this old (0 = no limit)
+    int memory_max_events = 0;
+    int memory_max_age_seconds = 0;
+    // Parquet: threads writing full buffers in the background (0 = write
+    // synchronously in append_event) and how many files may queue for them
+    // before appends block
+    int flush_threads = 0;
+    int max_pending_flushes = 16;
+    std::string flush_cpus;  // cpulist the flush threads run on
+
+    // Parquet: a partition's buffer is written once it is this old
+    int buffer_age_seconds = 30;
+    // Parquet: events are appended to a local write-ahead log here before
+    // they are buffered (empty = no log), which is fdatasynced at most every
+    // wal_sync_interval_ms (negative = never). The flush threads also sync
+    // it that often once appends stop; with none, the tail of a burst is
+    // synced by the next append, sync() or shutdown.
+    std::string wal_directory;
+    int wal_sync_interval_ms = 10;
+    // Parquet: a book's snapshot is written in full once, then as the
+    // levels that changed since that base, up to this many times before the
+    // next full one (0 = always in full)
+    int snapshot_diffs_per_base = 8;
+    // Parquet: merge each ended hour's small event files this often (0 = off)
+    int compaction_interval_seconds = 0;
+    // Parquet and S3: keep each asset's newest events in memory too, this
+    // many and at most this old (both 0 = no memory tier), so recent ranges
+    // are read without touching files; S3: also keep a Parquet copy of this
+    // run's events under cache_directory (empty = none) for ranges older
+    // than the memory tier
+    int hot_tail_events = 0;
+    int hot_tail_age_seconds = 0;
+    std::string cache_directory;
+    ParquetWriterSettings parquet;
+    // Parquet reads: memory-map local files rather than copying them into
+    // heap buffers; coalesce and prefetch the column chunks a read needs
+    // (fewer, larger requests, which is what S3 wants); and the Arrow memory
+    // pool decoded data comes from ("default", "system", "jemalloc" or
+    // "mimalloc", if Arrow was built with it)
+    bool mmap_reads = false;
+    bool pre_buffer_reads = false;
+    std::string memory_pool = "default";
+    // Parquet reads: files get_events_since opens and decodes at once
+    // (1 = one after another)
+    int read_concurrency = 1;
     // S3-compatible storage (AWS S3, Cloudflare R2, Backblaze B2, Wasabi, MinIO)
     std::string s3_bucket;
     std::string s3_prefix = "mde";
     std::string s3_region = "us-east-1";
     std::string s3_endpoint_override;     // non-empty for R2/B2/Wasabi/MinIO
     std::string s3_scheme = "https";      // "http" for local MinIO
+    // S3: keep downloaded files in a local LRU cache of this size (empty
+    // directory = no cache)
+    std::string s3_cache_directory;
+    int s3_cache_max_mb = 1024;
 };
 
 struct Settings {
@@ -42,6 +204,12 @@ struct Settings {
     ServiceSettings service;
     DiscoverySettings discovery;
     StorageSettings storage;
+    AnalyticsSettings analytics;
+    BarSettings bars;
+    MetricsSettings metrics;
+    SharedMemorySettings shared_memory;
+    BinaryFeedSettings binary_feed;
+    QuerySettings query;
 
     static Settings from_environment();
     static Settings development();
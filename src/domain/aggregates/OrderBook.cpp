@@ -1,119 +1,177 @@
 #include "domain/aggregates/OrderBook.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 namespace mde::domain {
 
-OrderBook::OrderBook(MarketAsset asset, std::vector<PriceLevel> bids, std::vector<PriceLevel> asks,
+OrderBook::OrderBook(MarketAsset asset, BidLadder bids, AskLadder asks,
                      std::optional<TradeEvent> latest_trade, Price tick_size,
                      Timestamp timestamp, uint64_t last_sequence_number, std::string book_hash)
     : asset_(std::move(asset))
-    , bids_(std::move(bids))
-    , asks_(std::move(asks))
-    , latest_trade_(std::move(latest_trade))
     , tick_size_(tick_size)
-    , timestamp_(timestamp)
     , last_sequence_number_(last_sequence_number)
-    , book_hash_(std::move(book_hash)) {}
+    , timestamp_(timestamp)
+    , bids_(std::move(bids))
+    , asks_(std::move(asks))
+    , book_hash_(std::move(book_hash))
+    , latest_trade_(std::move(latest_trade)) {
+    refresh_top();
+}
 
 OrderBook OrderBook::empty(MarketAsset asset) {
-    return OrderBook(std::move(asset), {}, {}, std::nullopt, Price(0.01), Timestamp(0), 0, "");
+    Price tick_size(0.01);
+    return OrderBook(std::move(asset), BidLadder(tick_size),
+                     AskLadder(tick_size), std::nullopt, tick_size,
+                     Timestamp(0), 0, "");
 }
 
-// BookSnapshot: replace entire book state
+// --- Immutable apply: copy, then apply in place ---
+
 OrderBook OrderBook::apply(const BookSnapshot& event) const {
-    // Bids sorted descending by price
-    auto bids = event.bids;
-    std::sort(bids.begin(), bids.end(),
-              [](const PriceLevel& a, const PriceLevel& b) {
-                  return a.price() > b.price();
-              });
-
-    // Asks sorted ascending by price
-    auto asks = event.asks;
-    std::sort(asks.begin(), asks.end(),
-              [](const PriceLevel& a, const PriceLevel& b) {
-                  return a.price() < b.price();
-              });
-
-    return OrderBook(asset_, std::move(bids), std::move(asks),
-                     latest_trade_, tick_size_,
-                     event.timestamp, event.sequence_number, event.hash);
-}
-
-namespace {
-
-// Update a sorted price level vector with a new level.
-// For bids: descending order (comp should be >).
-// For asks: ascending order (comp should be <).
-template <typename Compare>
-std::vector<PriceLevel> update_levels(std::vector<PriceLevel> levels,
-                                       Price price, Quantity new_size,
-                                       Compare comp) {
-    // Find existing level at this price
-    auto it = std::find_if(levels.begin(), levels.end(),
-                           [&](const PriceLevel& lvl) { return lvl.price() == price; });
-
-    if (new_size.size() == 0.0) {
-        // Remove level
-        if (it != levels.end()) {
-            levels.erase(it);
-        }
-    } else if (it != levels.end()) {
-        // Update existing level
-        *it = PriceLevel(price, new_size);
-    } else {
-        // Insert new level in sorted position
-        auto pos = std::lower_bound(levels.begin(), levels.end(), price,
-                                    [&](const PriceLevel& lvl, const Price& p) {
-                                        return comp(lvl.price(), p);
-                                    });
-        levels.insert(pos, PriceLevel(price, new_size));
-    }
+    auto next = *this;
+    next.apply_in_place(event);
+    return next;
+}
+
+OrderBook OrderBook::apply(const BookDelta& event) const {
+    auto next = *this;
+    next.apply_in_place(event);
+    return next;
+}
+
+OrderBook OrderBook::apply(const TradeEvent& event) const {
+    auto next = *this;
+    next.apply_in_place(event);
+    return next;
+}
 
-    return levels;
+OrderBook OrderBook::apply(const TickSizeChange& event) const {
+    auto next = *this;
+    next.apply_in_place(event);
+    return next;
 }
 
-} // anonymous namespace
+// Variant dispatch
+OrderBook OrderBook::apply(const OrderBookEventVariant& event) const {
+    return std::visit([this](const auto& e) { return this->apply(e); }, event);
+}
+
+// --- In-place apply ---
+// Ladders are fixed-size per tick grid and the hash string keeps its
+// capacity, so once a book has warmed up, applying an event performs no
+// heap allocation.
+
+// BookSnapshot: replace entire book state
+void OrderBook::apply_in_place(const BookSnapshot& event) {
+    // Levels are bucketed by tick, so input order does not matter
+    bids_.clear();
+    for (const auto& level : event.bids) {
+        bids_.set(level.price(), level.size());
+    }
+
+    asks_.clear();
+    for (const auto& level : event.asks) {
+        asks_.set(level.price(), level.size());
+    }
+
+    refresh_top();
+
+    timestamp_ = event.timestamp;
+    last_sequence_number_ = event.sequence_number;
+    book_hash_ = event.hash;
+}
 
 // BookDelta: patch individual price levels
-OrderBook OrderBook::apply(const BookDelta& event) const {
-    auto bids = bids_;
-    auto asks = asks_;
+void OrderBook::apply_in_place(const BookDelta& event) {
+    try {
+        apply_changes(event);
+    } catch (...) {
+        settle();
+        throw;
+    }
+    settle();
+}
+
+// Leaves the ladders unsettled. Only a change at or better than the
+// cached best level can move the top of book.
+//
+// One pass per side: each is a loop over that side's changes with the
+// side's ordering compiled in, and changes to one side never depend on the
+// other's, so the order within a side is all that must be kept.
+void OrderBook::apply_changes(const BookDelta& event) {
+    apply_side_changes(event, bids_, top_.bid, bid_stale_);
+    apply_side_changes(event, asks_, top_.ask, ask_stale_);
 
+    timestamp_ = event.timestamp;
+    last_sequence_number_ = event.sequence_number;
+}
+
+template <Side S>
+void OrderBook::apply_side_changes(const BookDelta& event, Ladder<S>& ladder,
+                                   const std::optional<PriceLevel>& top, bool& stale) {
+    // The top can only move for a change at or better than the cached best
+    const int64_t best = top ? top->price().micros() : (S == Side::BUY ? -1 : kFixedPointScale + 1);
+    bool touched = false;
     for (const auto& change : event.changes) {
-        if (change.side == Side::BUY) {
-            bids = update_levels(std::move(bids), change.price, change.new_size,
-                                 std::greater<Price>{});
-        } else {
-            asks = update_levels(std::move(asks), change.price, change.new_size,
-                                 std::less<Price>{});
-        }
+        if (change.side != S) continue;
+        ladder.set_deferred(change.price, change.new_size);
+        touched |= S == Side::BUY ? change.price.micros() >= best : change.price.micros() <= best;
     }
+    stale = stale || touched;
+}
 
-    return OrderBook(asset_, std::move(bids), std::move(asks),
-                     latest_trade_, tick_size_,
-                     event.timestamp, event.sequence_number, book_hash_);
+void OrderBook::settle() {
+    bids_.settle();
+    asks_.settle();
+    if (bid_stale_ || ask_stale_) refresh_top();
+}
+
+void OrderBook::refresh_top() {
+    top_.bid = bids_.empty() ? std::nullopt : std::optional<PriceLevel>(bids_.best());
+    top_.ask = asks_.empty() ? std::nullopt : std::optional<PriceLevel>(asks_.best());
+    bid_stale_ = ask_stale_ = false;
 }
 
 // TradeEvent: record latest trade
-OrderBook OrderBook::apply(const TradeEvent& event) const {
-    return OrderBook(asset_, bids_, asks_,
-                     event, tick_size_,
-                     event.timestamp, event.sequence_number, book_hash_);
+void OrderBook::apply_in_place(const TradeEvent& event) {
+    latest_trade_ = event;
+    timestamp_ = event.timestamp;
+    last_sequence_number_ = event.sequence_number;
 }
 
-// TickSizeChange: update tick size
-OrderBook OrderBook::apply(const TickSizeChange& event) const {
-    return OrderBook(asset_, bids_, asks_,
-                     latest_trade_, event.new_tick_size,
-                     event.timestamp, event.sequence_number, book_hash_);
+// TickSizeChange: update tick size and move levels onto the new grid
+void OrderBook::apply_in_place(const TickSizeChange& event) {
+    tick_size_ = event.new_tick_size;
+    bids_.rebucket(tick_size_);
+    asks_.rebucket(tick_size_);
+    refresh_top();
+    timestamp_ = event.timestamp;
+    last_sequence_number_ = event.sequence_number;
 }
 
 // Variant dispatch
-OrderBook OrderBook::apply(const OrderBookEventVariant& event) const {
-    return std::visit([this](const auto& e) { return this->apply(e); }, event);
+void OrderBook::apply_in_place(const OrderBookEventVariant& event) {
+    std::visit([this](const auto& e) { this->apply_in_place(e); }, event);
+}
+
+void OrderBook::apply_in_place(std::span<const OrderBookEventVariant> events) {
+    try {
+        for (const auto& event : events) {
+            if (const auto* delta = std::get_if<BookDelta>(&event)) {
+                apply_changes(*delta);
+            } else {
+                settle();
+                apply_in_place(event);
+            }
+        }
+    } catch (...) {
+        // The events before the failing one stay applied, as one by one
+        settle();
+        throw;
+    }
+    settle();
 }
 
 Spread OrderBook::get_spread() const {
@@ -125,23 +183,85 @@ int OrderBook::get_depth() const noexcept {
 }
 
 Price OrderBook::get_midpoint() const {
-    auto bid = get_best_bid().value();
-    auto ask = get_best_ask().value();
-    return Price((bid + ask) / 2.0);
+    auto mid = midpoint();
+    if (!mid) {
+        throw std::runtime_error(top_.bid ? "No asks in order book" : "No bids in order book");
+    }
+    return *mid;
 }
 
 Price OrderBook::get_best_bid() const {
-    if (bids_.empty()) {
+    if (!top_.bid) {
         throw std::runtime_error("No bids in order book");
     }
-    return bids_.front().price();
+    return top_.bid->price();
 }
 
 Price OrderBook::get_best_ask() const {
-    if (asks_.empty()) {
+    if (!top_.ask) {
         throw std::runtime_error("No asks in order book");
     }
-    return asks_.front().price();
+    return top_.ask->price();
+}
+
+std::optional<Price> OrderBook::best_bid() const noexcept {
+    if (!top_.bid) return std::nullopt;
+    return top_.bid->price();
+}
+
+std::optional<Price> OrderBook::best_ask() const noexcept {
+    if (!top_.ask) return std::nullopt;
+    return top_.ask->price();
+}
+
+bool OrderBook::agrees_with(const BookDelta& event) const noexcept {
+    const auto& token = asset_.token();
+    for (auto it = event.changes.rbegin(); it != event.changes.rend(); ++it) {
+        if (it->asset_id != token) continue;
+        auto matches = [](const std::optional<Price>& held, Price reported) {
+            return held ? *held == reported : reported.micros() == 0;
+        };
+        return matches(best_bid(), it->best_bid) && matches(best_ask(), it->best_ask);
+    }
+    return true;
+}
+
+std::optional<Spread> OrderBook::spread() const noexcept {
+    if (!top_.bid || !top_.ask) return std::nullopt;
+    return Spread{top_.bid->price(), top_.ask->price()};
+}
+
+std::optional<Price> OrderBook::midpoint() const {
+    if (!top_.bid || !top_.ask) return std::nullopt;
+    // Half a micro rounds up, as Price(double) would
+    return Price::from_micros((top_.bid->price().micros() + top_.ask->price().micros() + 1) / 2);
+}
+
+std::optional<Price> OrderBook::weighted_midpoint() const {
+    if (!top_.bid || !top_.ask) return std::nullopt;
+    auto bid_size = static_cast<double>(top_.bid->size().units());
+    auto ask_size = static_cast<double>(top_.ask->size().units());
+    auto bid = static_cast<double>(top_.bid->price().micros());
+    auto ask = static_cast<double>(top_.ask->price().micros());
+    return Price::from_micros(std::llround((bid * ask_size + ask * bid_size) / (bid_size + ask_size)));
+}
+
+Quantity OrderBook::get_total_size(Side side) const {
+    return side_ladder(side).total_size();
+}
+
+Quantity OrderBook::get_depth_within(Side side, int ticks) const {
+    if (ticks < 0) return Quantity::zero();
+    auto distance = std::min<int64_t>(tick_size_.micros() * ticks, kFixedPointScale);
+    return side_ladder(side).size_within(Price::from_micros(distance));
+}
+
+void OrderBook::get_depth_curve(Side side, std::span<Quantity> out) const {
+    side_ladder(side).cumulative_depth(tick_size_, out);
+}
+
+Sweep OrderBook::get_sweep(Side side, Quantity size) const {
+    return side_ladder(side).sweep(size);
 }
 
 } // namespace mde::domain
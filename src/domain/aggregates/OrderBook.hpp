@@ -1,5 +1,6 @@
 #pragma once
 
+#include "domain/aggregates/PriceLadder.hpp"
 #include "domain/events/BookDelta.hpp"
 #include "domain/events/BookSnapshot.hpp"
 #include "domain/events/TickSizeChange.hpp"
@@ -11,6 +12,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
 #include <variant>
 #include <vector>
@@ -26,6 +28,12 @@ struct Spread {
     double value() const { return best_ask.value() - best_bid.value(); }
 };
 
+// Best level of each side; empty for a side with no levels
+struct TopOfBook {
+    std::optional<PriceLevel> bid;
+    std::optional<PriceLevel> ask;
+};
+
 class OrderBook {
 public:
     // Factory
@@ -38,34 +46,95 @@ public:
     OrderBook apply(const TickSizeChange& event) const;
     OrderBook apply(const OrderBookEventVariant& event) const;
 
-    // Queries
+    // Apply events in place — mutates this book, reusing level storage.
+    // Hot ingestion path for the book owned by the service projection;
+    // the immutable apply() overloads above are built on top of these.
+    void apply_in_place(const BookSnapshot& event);
+    void apply_in_place(const BookDelta& event);
+    void apply_in_place(const TradeEvent& event);
+    void apply_in_place(const TickSizeChange& event);
+    void apply_in_place(const OrderBookEventVariant& event);
+
+    // Apply a run of this book's events in order. Same result as applying
+    // them one by one, but the changes of consecutive deltas all land before
+    // either side looks for its new best and worst levels.
+    void apply_in_place(std::span<const OrderBookEventVariant> events);
+
+    // Queries. The get_ forms of the top-of-book queries throw when a side
+    // is empty.
     const MarketAsset& get_asset() const noexcept { return asset_; }
     Spread get_spread() const;
     int get_depth() const noexcept;
     Price get_midpoint() const;
     Price get_best_bid() const;
     Price get_best_ask() const;
+
+    // Top of book, cached and refreshed only by events that change levels,
+    // so these are plain reads; empty when a side (or either side) is empty
+    const TopOfBook& top() const noexcept { return top_; }
+    std::optional<Price> best_bid() const noexcept;
+    std::optional<Price> best_ask() const noexcept;
+    std::optional<Spread> spread() const noexcept;
+    std::optional<Price> midpoint() const;
+    // Mid weighted by the size opposite each price (the microprice): it
+    // leans toward the ask when more size rests on the bid
+    std::optional<Price> weighted_midpoint() const;
+
+    // Whether the top of this book is the one the exchange reported with
+    // the delta's last change for this book's token (best_bid/best_ask, a
+    // zero price standing for an empty side). Checked after applying the
+    // delta; a mismatch means a message was lost or misapplied. A delta
+    // with no change for this token agrees.
+    bool agrees_with(const BookDelta& event) const noexcept;
+
+    // Level aggregates. Totals are maintained by every update; depth sums
+    // the levels no more than `ticks` tick sizes from the best price.
+    Quantity get_total_size(Side side) const;
+    Quantity get_depth_within(Side side, int ticks) const;
+    // get_depth_within(side, k) for every k < out.size(), in one pass
+    void get_depth_curve(Side side, std::span<Quantity> out) const;
+    // What a market order of `size` would pay taking the levels of `side`:
+    // Side::SELL (the asks) for a buy, Side::BUY (the bids) for a sell
+    Sweep get_sweep(Side side, Quantity size) const;
     std::optional<TradeEvent> get_latest_trade() const noexcept { return latest_trade_; }
     Price get_tick_size() const noexcept { return tick_size_; }
     Timestamp get_timestamp() const noexcept { return timestamp_; }
     uint64_t get_last_sequence_number() const noexcept { return last_sequence_number_; }
     const std::string& get_book_hash() const noexcept { return book_hash_; }
-    const std::vector<PriceLevel>& get_bids() const noexcept { return bids_; }
-    const std::vector<PriceLevel>& get_asks() const noexcept { return asks_; }
+    // Level views, iterated from best to worst price
+    const BidLadder& get_bids() const noexcept { return bids_; }
+    const AskLadder& get_asks() const noexcept { return asks_; }
 
 private:
-    OrderBook(MarketAsset asset, std::vector<PriceLevel> bids, std::vector<PriceLevel> asks,
+    void apply_changes(const BookDelta& event);
+    template <Side S>
+    void apply_side_changes(const BookDelta& event, Ladder<S>& ladder, const std::optional<PriceLevel>& top,
+                            bool& stale);
+    void settle();
+    void refresh_top();
+    const PriceLadder& side_ladder(Side side) const noexcept {
+        return side == Side::BUY ? static_cast<const PriceLadder&>(bids_) : asks_;
+    }
+
+    OrderBook(MarketAsset asset, BidLadder bids, AskLadder asks,
               std::optional<TradeEvent> latest_trade, Price tick_size,
               Timestamp timestamp, uint64_t last_sequence_number, std::string book_hash);
 
+    // What every event reads first, then the ladders, then the fields only
+    // snapshots and trades touch, so the hot part spans as few cache lines
+    // as possible
     MarketAsset asset_;
-    std::vector<PriceLevel> bids_;   // Sorted descending by price
-    std::vector<PriceLevel> asks_;   // Sorted ascending by price
-    std::optional<TradeEvent> latest_trade_;
     Price tick_size_;
-    Timestamp timestamp_;
     uint64_t last_sequence_number_;
+    Timestamp timestamp_;
+    TopOfBook top_;
+    // A delta touched a side's top; refreshed when the ladders settle
+    bool bid_stale_{false};
+    bool ask_stale_{false};
+    BidLadder bids_;   // Best = highest price
+    AskLadder asks_;   // Best = lowest price
     std::string book_hash_;
+    std::optional<TradeEvent> latest_trade_;
 };
 
 } // namespace mde::domain
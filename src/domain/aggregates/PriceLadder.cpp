@@ -0,0 +1,258 @@
+#include "domain/aggregates/PriceLadder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace mde::domain {
+
+namespace {
+
+// Slots summed per step of a sweep; a few vector registers' worth
+constexpr std::ptrdiff_t kSweepBlock = 16;
+
+// A sweep's size-weighted price sum: units times micro-dollars overflows
+// int64 past about nine million shares
+__extension__ using WideInt = __int128;
+
+// Plain loops over consecutive slots with no branches, so the compiler can
+// vectorize them (a Quantity is its int64 units)
+int64_t sum_units(const Quantity* sizes, std::ptrdiff_t first, std::ptrdiff_t count) {
+    int64_t units = 0;
+    for (std::ptrdiff_t i = first; i < first + count; ++i) {
+        units += sizes[i].units();
+    }
+    return units;
+}
+
+// Sum of index * units, which is notional in ticks. Wide from the first
+// product: one level of a few million shares deep in the ladder already
+// overflows int64.
+WideInt sum_tick_weighted(const Quantity* sizes, std::ptrdiff_t first, std::ptrdiff_t count) {
+    WideInt weighted = 0;
+    for (std::ptrdiff_t i = first; i < first + count; ++i) {
+        weighted += static_cast<WideInt>(i) * sizes[i].units();
+    }
+    return weighted;
+}
+
+} // anonymous namespace
+
+PriceLadder::const_iterator& PriceLadder::const_iterator::operator++() {
+    if (index_ == ladder_->worst_) {
+        index_ = kNone;
+    } else {
+        index_ = ladder_->next_populated(ladder_->step_worse(index_), ladder_->worst_);
+    }
+    return *this;
+}
+
+PriceLadder::PriceLadder(Side side, Price tick_size)
+    : side_(side)
+    , ticks_per_unit_(ticks_per_unit_for(tick_size))
+    , micros_per_tick_(kFixedPointScale / ticks_per_unit_)
+    , sizes_(static_cast<size_t>(ticks_per_unit_ + 1), Quantity::zero()) {}
+
+int64_t PriceLadder::ticks_per_unit_for(Price tick_size) {
+    auto micros = tick_size.micros();
+    if (micros <= 0) {
+        throw std::invalid_argument("Tick size must be positive");
+    }
+    auto ticks = kFixedPointScale / micros;
+    if (kFixedPointScale % micros != 0 || ticks > kMaxTicksPerUnit) {
+        throw std::invalid_argument(
+            "Unsupported tick size: " + std::to_string(tick_size.value()));
+    }
+    return ticks;
+}
+
+Price PriceLadder::price_at(std::ptrdiff_t index) const {
+    return Price::from_micros(static_cast<int64_t>(index) * micros_per_tick_);
+}
+
+PriceLevel PriceLadder::level_at(std::ptrdiff_t index) const {
+    return PriceLevel(price_at(index), sizes_[static_cast<size_t>(index)]);
+}
+
+std::ptrdiff_t PriceLadder::next_populated(std::ptrdiff_t from, std::ptrdiff_t stop) const noexcept {
+    for (auto i = from; ; i = step_worse(i)) {
+        if (!sizes_[static_cast<size_t>(i)].is_zero()) return i;
+        if (i == stop) return kNone;
+    }
+}
+
+void PriceLadder::set(Price price, Quantity size) {
+    set_deferred(price, size);
+    settle();
+}
+
+void PriceLadder::set_deferred(Price price, Quantity size) {
+    if (side_ == Side::BUY) {
+        set_deferred_on<Side::BUY>(price, size);
+    } else {
+        set_deferred_on<Side::SELL>(price, size);
+    }
+}
+
+void PriceLadder::settle() noexcept {
+    if (side_ == Side::BUY) {
+        settle_on<Side::BUY>();
+    } else {
+        settle_on<Side::SELL>();
+    }
+}
+
+void PriceLadder::refine_grid(Price price) {
+    // Regridding walks the levels, which needs exact bounds
+    settle();
+    while (!on_grid(price) && ticks_per_unit_ < kMaxTicksPerUnit) {
+        resize_grid(ticks_per_unit_ * 10);
+    }
+}
+
+void PriceLadder::clear() noexcept {
+    if (level_count_ > 0) {
+        auto lo = std::min(best_, worst_);
+        auto hi = std::max(best_, worst_);
+        for (auto i = lo; i <= hi; ++i) {
+            sizes_[static_cast<size_t>(i)] = Quantity::zero();
+        }
+    }
+    level_count_ = 0;
+    total_units_ = 0;
+    best_ = worst_ = kNone;
+    unsettled_ = false;
+}
+
+void PriceLadder::rebucket(Price tick_size) {
+    auto ticks = ticks_per_unit_for(tick_size);
+    if (ticks != ticks_per_unit_) {
+        settle();
+        resize_grid(ticks);
+    }
+}
+
+void PriceLadder::resize_grid(int64_t ticks_per_unit) {
+    std::vector<PriceLevel> levels(begin(), end());
+
+    ticks_per_unit_ = ticks_per_unit;
+    micros_per_tick_ = kFixedPointScale / ticks_per_unit_;
+    sizes_.assign(static_cast<size_t>(ticks_per_unit_ + 1), Quantity::zero());
+    level_count_ = 0;
+    total_units_ = 0;
+    best_ = worst_ = kNone;
+
+    for (const auto& level : levels) {
+        set(level.price(), level.size());
+    }
+}
+
+Quantity PriceLadder::size_at(Price price) const {
+    if (!has_slot(price)) return Quantity::zero();
+    return sizes_[static_cast<size_t>(index_of(price))];
+}
+
+Quantity PriceLadder::size_within(Price distance) const {
+    if (level_count_ == 0 || distance.micros() < 0) return Quantity::zero();
+    // Empty slots hold zero, so the window is summed without tests
+    auto span = static_cast<std::ptrdiff_t>(distance.micros() / micros_per_tick_);
+    auto lo = side_ == Side::BUY ? std::max(best_ - span, std::min(best_, worst_)) : best_;
+    auto hi = side_ == Side::BUY ? best_ : std::min(best_ + span, std::max(best_, worst_));
+    return Quantity::from_units(sum_units(sizes_.data(), lo, hi - lo + 1));
+}
+
+void PriceLadder::cumulative_depth(Price step, std::span<Quantity> out) const {
+    if (level_count_ == 0) {
+        std::fill(out.begin(), out.end(), Quantity::zero());
+        return;
+    }
+    const std::ptrdiff_t direction = side_ == Side::BUY ? -1 : 1;
+    const auto last_offset = std::abs(worst_ - best_);
+    int64_t units = 0;
+    std::ptrdiff_t summed = -1;  // offsets from the best slot already in `units`
+    for (size_t k = 0; k < out.size(); ++k) {
+        auto offset = std::min<int64_t>(static_cast<int64_t>(k) * step.micros() / micros_per_tick_, last_offset);
+        if (offset > summed) {
+            // Slots [summed + 1, offset] from the best, lowest index first
+            auto near = best_ + direction * (summed + 1);
+            auto far = best_ + direction * static_cast<std::ptrdiff_t>(offset);
+            units += sum_units(sizes_.data(), std::min(near, far), std::abs(far - near) + 1);
+            summed = static_cast<std::ptrdiff_t>(offset);
+        }
+        out[k] = Quantity::from_units(units);
+    }
+}
+
+Sweep PriceLadder::sweep(Quantity size) const {
+    Sweep result{Quantity::zero(), 0, std::nullopt, std::nullopt};
+    const int64_t target = size.units();
+    if (level_count_ == 0 || target <= 0) return result;
+
+    const auto* sizes = sizes_.data();
+    const std::ptrdiff_t direction = side_ == Side::BUY ? -1 : 1;
+    int64_t filled = 0;
+    WideInt weighted = 0;   // filled units times their slot index
+    std::ptrdiff_t last = worst_;
+    for (auto start = best_;;) {
+        auto remaining = std::abs(worst_ - start) + 1;
+        auto count = std::min(kSweepBlock, remaining);
+        auto first = direction > 0 ? start : start - count + 1;
+        auto block_units = sum_units(sizes, first, count);
+        if (filled + block_units < target) {
+            filled += block_units;
+            weighted += sum_tick_weighted(sizes, first, count);
+            if (count == remaining) break;  // the side ran out
+            start += direction * count;
+            continue;
+        }
+        // This block completes the fill: finish it level by level
+        for (auto i = start;; i += direction) {
+            auto take = std::min(sizes[i].units(), target - filled);
+            filled += take;
+            weighted += static_cast<WideInt>(i) * take;
+            if (filled == target) {
+                last = i;
+                break;
+            }
+        }
+        break;
+    }
+
+    // index * micros_per_tick_ is a price, so this is exact micro-dollars
+    // times kFixedPointScale before the division
+    auto price_units = weighted * micros_per_tick_;
+    result.filled = Quantity::from_units(filled);
+    result.notional = static_cast<int64_t>(price_units / kFixedPointScale);
+    if (filled > 0) {
+        // Rounded half up, as both are positive
+        result.average_price = Price::from_micros(static_cast<int64_t>((price_units + filled / 2) / filled));
+        result.worst_price = price_at(last);
+    }
+    return result;
+}
+
+PriceLevel PriceLadder::operator[](size_t i) const {
+    if (i >= level_count_) {
+        throw std::out_of_range("PriceLadder index out of range");
+    }
+    auto it = begin();
+    std::advance(it, static_cast<std::ptrdiff_t>(i));
+    return *it;
+}
+
+PriceLadder::const_iterator PriceLadder::begin() const noexcept {
+    return const_iterator(this, best_);
+}
+
+bool PriceLadder::operator==(const PriceLadder& other) const {
+    if (side_ != other.side_ || level_count_ != other.level_count_) return false;
+    auto a = begin();
+    auto b = other.begin();
+    for (; a != end(); ++a, ++b) {
+        if (*a != *b) return false;
+    }
+    return true;
+}
+
+} // namespace mde::domain
@@ -0,0 +1,254 @@
+#pragma once
+
+#include "domain/value_objects/Price.hpp"
+#include "domain/value_objects/PriceLevel.hpp"
+#include "domain/value_objects/Quantity.hpp"
+#include "domain/value_objects/Side.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace mde::domain {
+
+// What taking up to some size from one side of a book would cost (a
+// market order's fill), best price first
+struct Sweep {
+    Quantity filled;                      // less than asked if the side ran out
+    int64_t notional{0};                  // micro-dollars
+    std::optional<Price> average_price;   // empty when nothing was filled
+    std::optional<Price> worst_price;     // the last level reached
+};
+
+// One side of an order book, stored as a dense array of sizes indexed by
+// integer tick (slot i holds the aggregate size at price i / ticks_per_unit).
+// Polymarket prices live on a 0..1 grid, so a side has at most a few hundred
+// to a few thousand slots. Level updates, best price and level count are O(1);
+// removing the best level scans to the next populated slot. Prices are
+// fixed-point, so tick indexing is exact integer arithmetic.
+//
+// Prices that fall between grid points refine the grid (x10) until they fit,
+// so levels are never merged or dropped.
+//
+// The side is a runtime value here; Ladder<S> below fixes it at compile time
+// for the update path.
+class PriceLadder {
+public:
+    // Iterates populated levels from best to worst price.
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PriceLevel;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = PriceLevel;
+
+        const_iterator() = default;
+
+        PriceLevel operator*() const { return ladder_->level_at(index_); }
+        const_iterator& operator++();
+        const_iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+
+    private:
+        friend class PriceLadder;
+        const_iterator(const PriceLadder* ladder, std::ptrdiff_t index)
+            : ladder_(ladder), index_(index) {}
+
+        const PriceLadder* ladder_{nullptr};
+        std::ptrdiff_t index_{-1};
+    };
+
+    PriceLadder(Side side, Price tick_size);
+
+    // Set the aggregate size at a price. Zero size removes the level.
+    void set(Price price, Quantity size);
+    void clear() noexcept;
+
+    // Batched updates: set_deferred() is set() except that removing the best
+    // or worst level does not scan for the next one; settle() does that once
+    // for the whole batch. Queries and iteration must wait for settle().
+    void set_deferred(Price price, Quantity size);
+    void settle() noexcept;
+
+    // Move all levels onto the grid for a new tick size.
+    void rebucket(Price tick_size);
+
+    Side side() const noexcept { return side_; }
+    int64_t ticks_per_unit() const noexcept { return ticks_per_unit_; }
+
+    bool empty() const noexcept { return level_count_ == 0; }
+    size_t size() const noexcept { return level_count_; }
+
+    // Size resting on the whole side, kept up to date by every update
+    Quantity total_size() const { return Quantity::from_units(total_units_); }
+
+    // Size resting no further than `distance` from the best price (zero
+    // when empty). Sums the slots in that window, so O(distance in ticks).
+    Quantity size_within(Price distance) const;
+
+    // The depth curve: out[k] = size_within(k * step) for every k, in one
+    // pass from the best price
+    void cumulative_depth(Price step, std::span<Quantity> out) const;
+
+    // Take `size` from the best price outward. Whole blocks of slots are
+    // summed until the block that completes the fill, so the scan is a
+    // vectorizable loop over the slot array rather than a walk over levels.
+    Sweep sweep(Quantity size) const;
+
+    // Best populated level. Precondition: !empty().
+    Price best_price() const { return price_at(best_); }
+    Quantity best_size() const { return sizes_[static_cast<size_t>(best_)]; }
+    PriceLevel best() const { return level_at(best_); }
+
+    // Size resting at a price (zero if no level there)
+    Quantity size_at(Price price) const;
+
+    // i-th best level; walks from the best price, so O(slots) in the worst case
+    PriceLevel operator[](size_t i) const;
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept { return const_iterator(this, kNone); }
+
+    bool operator==(const PriceLadder& other) const;
+
+protected:
+    // The update path with the side as a template argument, so ordering and
+    // scan direction are constants. S must be side(). Ladder<S> calls these
+    // directly; set(), set_deferred() and settle() dispatch on side_.
+    template <Side S>
+    void set_deferred_on(Price price, Quantity size);
+    template <Side S>
+    void settle_on() noexcept;
+
+private:
+    static constexpr std::ptrdiff_t kNone = -1;
+
+    // Finest supported grid: 0.0001
+    static constexpr int64_t kMaxTicksPerUnit = 10000;
+
+    static int64_t ticks_per_unit_for(Price tick_size);
+
+    bool on_grid(Price price) const noexcept { return price.micros() % micros_per_tick_ == 0; }
+    // Whether a price has a slot: on the grid, or rounded on the finest one
+    bool has_slot(Price price) const noexcept {
+        return on_grid(price) || ticks_per_unit_ == kMaxTicksPerUnit;
+    }
+    // Rounds to the nearest slot when the price is finer than the finest grid
+    std::ptrdiff_t index_of(Price price) const noexcept {
+        return static_cast<std::ptrdiff_t>((price.micros() + micros_per_tick_ / 2) / micros_per_tick_);
+    }
+    Price price_at(std::ptrdiff_t index) const;
+    PriceLevel level_at(std::ptrdiff_t index) const;
+    void resize_grid(int64_t ticks_per_unit);
+    // Regrid until an off-grid price fits (or the finest grid is reached)
+    void refine_grid(Price price);
+
+    // Bids are best at the highest index, asks at the lowest
+    template <Side S>
+    static constexpr bool better_on(std::ptrdiff_t a, std::ptrdiff_t b) noexcept {
+        return S == Side::BUY ? a > b : a < b;
+    }
+    template <Side S>
+    static constexpr std::ptrdiff_t step_worse_on(std::ptrdiff_t index) noexcept {
+        return S == Side::BUY ? index - 1 : index + 1;
+    }
+    std::ptrdiff_t step_worse(std::ptrdiff_t index) const noexcept {
+        return side_ == Side::BUY ? step_worse_on<Side::BUY>(index) : step_worse_on<Side::SELL>(index);
+    }
+    std::ptrdiff_t next_populated(std::ptrdiff_t from, std::ptrdiff_t stop) const noexcept;
+
+    Side side_;
+    int64_t ticks_per_unit_;
+    int64_t micros_per_tick_;
+    std::vector<Quantity> sizes_;   // ticks_per_unit_ + 1 slots
+    size_t level_count_{0};
+    int64_t total_units_{0};
+    // While unsettled these only bound the populated slots
+    std::ptrdiff_t best_{kNone};
+    std::ptrdiff_t worst_{kNone};
+    bool unsettled_{false};
+};
+
+// A PriceLadder whose side is fixed at compile time. Its update methods
+// hide PriceLadder's and go straight to the side-specialized path, which
+// the caller can inline; everything else is PriceLadder's, so it binds to
+// a const PriceLadder& wherever a side is read.
+template <Side S>
+class Ladder : public PriceLadder {
+public:
+    explicit Ladder(Price tick_size) : PriceLadder(S, tick_size) {}
+
+    void set(Price price, Quantity size) {
+        set_deferred_on<S>(price, size);
+        settle_on<S>();
+    }
+    void set_deferred(Price price, Quantity size) { set_deferred_on<S>(price, size); }
+    void settle() noexcept { settle_on<S>(); }
+};
+
+using BidLadder = Ladder<Side::BUY>;
+using AskLadder = Ladder<Side::SELL>;
+
+// --- Side-specialized update path ---
+
+template <Side S>
+void PriceLadder::set_deferred_on(Price price, Quantity size) {
+    if (!has_slot(price)) {
+        // Nothing can rest between grid points, so there is nothing to remove
+        if (size.is_zero()) return;
+        refine_grid(price);
+    }
+
+    auto index = index_of(price);
+    auto& slot = sizes_[static_cast<size_t>(index)];
+    bool was_populated = !slot.is_zero();
+    bool populated = !size.is_zero();
+    total_units_ += size.units() - slot.units();
+    slot = size;
+
+    if (populated && !was_populated) {
+        ++level_count_;
+        if (best_ == kNone || better_on<S>(index, best_)) best_ = index;
+        if (worst_ == kNone || better_on<S>(worst_, index)) worst_ = index;
+    } else if (!populated && was_populated) {
+        --level_count_;
+        if (level_count_ == 0) {
+            best_ = worst_ = kNone;
+            unsettled_ = false;
+        } else if (index == best_ || index == worst_) {
+            unsettled_ = true;
+        }
+    }
+}
+
+template <Side S>
+void PriceLadder::settle_on() noexcept {
+    if (!unsettled_) return;
+    unsettled_ = false;
+    // Populated slots lie within [best_, worst_], so scan inward from each end
+    for (auto i = best_; ; i = step_worse_on<S>(i)) {
+        if (!sizes_[static_cast<size_t>(i)].is_zero() || i == worst_) {
+            best_ = i;
+            break;
+        }
+    }
+    for (auto i = worst_; ; i = (S == Side::BUY ? i + 1 : i - 1)) {
+        if (!sizes_[static_cast<size_t>(i)].is_zero()) {
+            worst_ = i;
+            break;
+        }
+    }
+}
+
+} // namespace mde::domain
@@ -0,0 +1,37 @@
+#include "domain/value_objects/AssetId.hpp"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace mde::domain {
+
+namespace {
+
+// Entries live in a deque so their addresses stay stable as it grows;
+// the index maps views of those strings back to their entries.
+template <typename Entry>
+struct InternTable {
+    std::mutex mutex;
+    std::deque<Entry> entries;
+    std::unordered_map<std::string_view, const Entry*> index;
+};
+
+} // namespace
+
+const AssetId::Entry* AssetId::intern(std::string_view id) {
+    static InternTable<Entry> table;
+
+    std::lock_guard lock(table.mutex);
+    auto it = table.index.find(id);
+    if (it != table.index.end()) return it->second;
+
+    auto& entry = table.entries.emplace_back(
+        Entry{std::string(id), static_cast<uint32_t>(table.entries.size())});
+    table.index.emplace(entry.value, &entry);
+    return &entry;
+}
+
+AssetId::AssetId(std::string_view id) : entry_(intern(id)) {}
+
+} // namespace mde::domain
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace mde::domain {
+
+// Interned Polymarket identifier (token or condition id). Each distinct
+// string is stored once for the life of the process; an AssetId is a pointer
+// to that entry, so copies, equality and hashing never touch the characters.
+//
+// Interning takes a lock and a hash probe, so build AssetIds once at the
+// edge (parser, repository reads) and pass them around by value.
+class AssetId {
+public:
+    AssetId(std::string_view id);
+    AssetId(const char* id) : AssetId(std::string_view(id)) {}
+    AssetId(const std::string& id) : AssetId(std::string_view(id)) {}
+
+    const std::string& str() const noexcept { return entry_->value; }
+    bool empty() const noexcept { return entry_->value.empty(); }
+
+    // Dense, process-unique index in interning order
+    uint32_t index() const noexcept { return entry_->index; }
+
+    bool operator==(const AssetId& other) const noexcept { return entry_ == other.entry_; }
+    bool operator==(std::string_view other) const noexcept { return str() == other; }
+    bool operator==(const char* other) const noexcept { return str() == other; }
+    bool operator==(const std::string& other) const noexcept { return str() == other; }
+
+    // Lexicographic, so ordered containers and output stay deterministic
+    std::strong_ordering operator<=>(const AssetId& other) const noexcept {
+        if (entry_ == other.entry_) return std::strong_ordering::equal;
+        return str().compare(other.str()) <=> 0;
+    }
+
+private:
+    struct Entry {
+        std::string value;
+        uint32_t index;
+    };
+
+    static const Entry* intern(std::string_view id);
+
+    const Entry* entry_;
+};
+
+} // namespace mde::domain
+
+template <>
+struct std::hash<mde::domain::AssetId> {
+    size_t operator()(const mde::domain::AssetId& id) const noexcept {
+        return std::hash<uint32_t>{}(id.index());
+    }
+};
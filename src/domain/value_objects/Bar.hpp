@@ -0,0 +1,41 @@
+#pragma once
+
+#include "domain/value_objects/MarketAsset.hpp"
+
+#include <cstdint>
+
+namespace mde::domain {
+
+// One asset's activity over [start_ms, start_ms + interval_ms) of exchange
+// time. Prices, midpoints and spreads are micro-units and volumes
+// micro-shares, as in Price and Quantity.
+struct Bar {
+    MarketAsset asset;
+    int64_t interval_ms{0};
+    int64_t start_ms{0};
+
+    // Trades; all zero when trade_count is 0
+    int64_t open{0};
+    int64_t high{0};
+    int64_t low{0};
+    int64_t close{0};
+    int64_t volume{0};
+    int64_t buy_volume{0};  // of it, trades whose taker bought
+    uint32_t trade_count{0};
+
+    // Top of book, from the quote in force when the bar opened and after
+    // every book event in it; all zero while the book has not been two-sided
+    int64_t mid_open{0};
+    int64_t mid_high{0};
+    int64_t mid_low{0};
+    int64_t mid_close{0};
+    int64_t spread_close{0};
+    int64_t spread_max{0};
+    uint32_t quote_updates{0};  // book events in the bar
+
+    int64_t end_ms() const noexcept { return start_ms + interval_ms; }
+
+    bool operator==(const Bar&) const = default;
+};
+
+} // namespace mde::domain
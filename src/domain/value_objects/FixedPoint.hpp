@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+namespace mde::domain {
+
+// Prices and quantities are stored as integers scaled by 10^6
+// (micro-units), which covers every decimal Polymarket emits exactly.
+inline constexpr int kFixedPointDecimals = 6;
+inline constexpr int64_t kFixedPointScale = 1'000'000;
+
+namespace detail {
+
+enum class DecimalParse { Ok, Invalid, Overflow };
+
+// Parse a plain decimal string ("219.217767", "-10", ".5") into a value
+// scaled by 10^6. Digits past the sixth decimal are rounded half-up.
+// No exponents, whitespace or leading '+'.
+inline DecimalParse parse_fixed_point(std::string_view str, int64_t& out) noexcept {
+    constexpr int64_t kMaxWhole = INT64_MAX / kFixedPointScale - 1;
+
+    size_t i = 0;
+    bool negative = false;
+    if (i < str.size() && str[i] == '-') {
+        negative = true;
+        ++i;
+    }
+
+    int64_t whole = 0;
+    size_t whole_digits = 0;
+    for (; i < str.size() && str[i] >= '0' && str[i] <= '9'; ++i, ++whole_digits) {
+        whole = whole * 10 + (str[i] - '0');
+        if (whole > kMaxWhole) return DecimalParse::Overflow;
+    }
+
+    int64_t frac = 0;
+    size_t frac_digits = 0;
+    bool round_up = false;
+    if (i < str.size() && str[i] == '.') {
+        ++i;
+        for (; i < str.size() && str[i] >= '0' && str[i] <= '9'; ++i, ++frac_digits) {
+            if (frac_digits < kFixedPointDecimals) {
+                frac = frac * 10 + (str[i] - '0');
+            } else if (frac_digits == kFixedPointDecimals) {
+                round_up = str[i] >= '5';
+            }
+        }
+    }
+
+    if (i != str.size() || whole_digits + frac_digits == 0) return DecimalParse::Invalid;
+
+    for (auto d = std::min<size_t>(frac_digits, kFixedPointDecimals); d < kFixedPointDecimals; ++d) {
+        frac *= 10;
+    }
+
+    int64_t value = whole * kFixedPointScale + frac + (round_up ? 1 : 0);
+    out = negative ? -value : value;
+    return DecimalParse::Ok;
+}
+
+} // namespace detail
+
+} // namespace mde::domain
@@ -4,9 +4,9 @@
 
 namespace mde::domain {
 
-MarketAsset::MarketAsset(std::string condition_id, std::string token_id)
-    : condition_id_(std::move(condition_id))
-    , token_id_(std::move(token_id)) {
+MarketAsset::MarketAsset(AssetId condition_id, AssetId token_id)
+    : condition_id_(condition_id)
+    , token_id_(token_id) {
     if (condition_id_.empty()) {
         throw std::invalid_argument("MarketAsset condition_id must not be empty");
     }
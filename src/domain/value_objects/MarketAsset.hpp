@@ -1,22 +1,39 @@
 #pragma once
 
+#include "domain/value_objects/AssetId.hpp"
+
+#include <cstddef>
+#include <functional>
 #include <string>
 
 namespace mde::domain {
 
+// A (condition_id, token_id) pair held as two interned AssetIds: copying,
+// comparing for equality and hashing are pointer operations.
 class MarketAsset {
 public:
-    MarketAsset(std::string condition_id, std::string token_id);
+    MarketAsset(AssetId condition_id, AssetId token_id);
+
+    const std::string& condition_id() const noexcept { return condition_id_.str(); }
+    const std::string& token_id() const noexcept { return token_id_.str(); }
 
-    const std::string& condition_id() const noexcept { return condition_id_; }
-    const std::string& token_id() const noexcept { return token_id_; }
+    AssetId condition() const noexcept { return condition_id_; }
+    AssetId token() const noexcept { return token_id_; }
 
     bool operator==(const MarketAsset&) const = default;
     auto operator<=>(const MarketAsset&) const = default;
 
 private:
-    std::string condition_id_;
-    std::string token_id_;
+    AssetId condition_id_;
+    AssetId token_id_;
 };
 
 } // namespace mde::domain
+
+template <>
+struct std::hash<mde::domain::MarketAsset> {
+    size_t operator()(const mde::domain::MarketAsset& asset) const noexcept {
+        // Token ids are unique across markets, so the token alone spreads well
+        return std::hash<mde::domain::AssetId>{}(asset.token());
+    }
+};
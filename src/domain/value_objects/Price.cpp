@@ -1,20 +1,52 @@
 #include "domain/value_objects/Price.hpp"
 
+#include <cmath>
+
 namespace mde::domain {
 
-Price::Price(double value) : value_(value) {
-    if (value < 0.0 || value > 1.0) {
+Price::Price(double value) {
+    if (!(value >= 0.0 && value <= 1.0)) {
         throw std::out_of_range(
             "Price must be between 0 and 1, got: " + std::to_string(value));
     }
+    micros_ = std::llround(value * kFixedPointScale);
 }
 
-Price Price::from_string(const std::string& str) {
-    return Price(std::stod(str));
+Price Price::from_string(std::string_view str) {
+    auto price = zero();
+    auto error = parse(str, price);
+    if (error == std::errc{}) return price;
+    if (error == std::errc::result_out_of_range) {
+        throw std::out_of_range("Price out of range: " + std::string(str));
+    }
+    throw std::invalid_argument("Invalid price: " + std::string(str));
+}
+
+std::errc Price::parse(std::string_view str, Price& out) noexcept {
+    int64_t micros = 0;
+    switch (detail::parse_fixed_point(str, micros)) {
+        case detail::DecimalParse::Ok:
+            if (micros < 0 || micros > kFixedPointScale) return std::errc::result_out_of_range;
+            out = Price(Micros{}, micros);
+            return {};
+        case detail::DecimalParse::Overflow:
+            return std::errc::result_out_of_range;
+        case detail::DecimalParse::Invalid:
+            break;
+    }
+    return std::errc::invalid_argument;
+}
+
+Price Price::from_micros(int64_t micros) {
+    if (micros < 0 || micros > kFixedPointScale) {
+        throw std::out_of_range(
+            "Price must be between 0 and 1, got micros: " + std::to_string(micros));
+    }
+    return Price(Micros{}, micros);
 }
 
 Price Price::zero() {
-    return Price(0.0);
+    return Price(Micros{}, 0);
 }
 
 } // namespace mde::domain
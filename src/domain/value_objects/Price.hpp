@@ -1,25 +1,42 @@
 #pragma once
 
+#include "domain/value_objects/FixedPoint.hpp"
+
 #include <compare>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 
 namespace mde::domain {
 
+// Probability price between 0 and 1, stored as integer micro-units so that
+// comparisons are exact.
 class Price {
 public:
     explicit Price(double value);
 
-    static Price from_string(const std::string& str);
+    static Price from_string(std::string_view str);
+    // As from_string, but like std::from_chars: on error leaves `out` alone
+    // and returns std::errc::invalid_argument for a malformed decimal or
+    // std::errc::result_out_of_range for one outside [0, 1].
+    static std::errc parse(std::string_view str, Price& out) noexcept;
+    static Price from_micros(int64_t micros);
     static Price zero();
 
-    double value() const noexcept { return value_; }
+    // Compatibility accessor; the integer representation is authoritative
+    double value() const noexcept { return static_cast<double>(micros_) / kFixedPointScale; }
+    int64_t micros() const noexcept { return micros_; }
 
     bool operator==(const Price&) const = default;
     auto operator<=>(const Price&) const = default;
 
 private:
-    double value_;
+    struct Micros {};
+    Price(Micros, int64_t micros) noexcept : micros_(micros) {}
+
+    int64_t micros_;
 };
 
 } // namespace mde::domain
@@ -6,7 +6,7 @@ PriceLevel::PriceLevel(Price price, Quantity size)
     : price_(price)
     , size_(size) {}
 
-PriceLevel PriceLevel::from_strings(const std::string& price, const std::string& size) {
+PriceLevel PriceLevel::from_strings(std::string_view price, std::string_view size) {
     return PriceLevel(Price::from_string(price), Quantity::from_string(size));
 }
 
@@ -3,13 +3,15 @@
 #include "domain/value_objects/Price.hpp"
 #include "domain/value_objects/Quantity.hpp"
 
+#include <string_view>
+
 namespace mde::domain {
 
 class PriceLevel {
 public:
     PriceLevel(Price price, Quantity size);
 
-    static PriceLevel from_strings(const std::string& price, const std::string& size);
+    static PriceLevel from_strings(std::string_view price, std::string_view size);
 
     const Price& price() const noexcept { return price_; }
     const Quantity& size() const noexcept { return size_; }
@@ -22,4 +24,6 @@ private:
     Quantity size_;
 };
 
+static_assert(sizeof(PriceLevel) <= 16, "PriceLevel should stay two machine words");
+
 } // namespace mde::domain
@@ -1,20 +1,52 @@
 #include "domain/value_objects/Quantity.hpp"
 
+#include <cmath>
+
 namespace mde::domain {
 
-Quantity::Quantity(double size) : size_(size) {
-    if (size < 0.0) {
+Quantity::Quantity(double size) {
+    if (!(size >= 0.0 && size < static_cast<double>(INT64_MAX / kFixedPointScale))) {
         throw std::out_of_range(
             "Quantity must be non-negative, got: " + std::to_string(size));
     }
+    units_ = std::llround(size * kFixedPointScale);
 }
 
-Quantity Quantity::from_string(const std::string& str) {
-    return Quantity(std::stod(str));
+Quantity Quantity::from_string(std::string_view str) {
+    auto quantity = zero();
+    auto error = parse(str, quantity);
+    if (error == std::errc{}) return quantity;
+    if (error == std::errc::result_out_of_range) {
+        throw std::out_of_range("Quantity out of range: " + std::string(str));
+    }
+    throw std::invalid_argument("Invalid quantity: " + std::string(str));
+}
+
+std::errc Quantity::parse(std::string_view str, Quantity& out) noexcept {
+    int64_t units = 0;
+    switch (detail::parse_fixed_point(str, units)) {
+        case detail::DecimalParse::Ok:
+            if (units < 0) return std::errc::result_out_of_range;
+            out = Quantity(Units{}, units);
+            return {};
+        case detail::DecimalParse::Overflow:
+            return std::errc::result_out_of_range;
+        case detail::DecimalParse::Invalid:
+            break;
+    }
+    return std::errc::invalid_argument;
+}
+
+Quantity Quantity::from_units(int64_t units) {
+    if (units < 0) {
+        throw std::out_of_range(
+            "Quantity must be non-negative, got units: " + std::to_string(units));
+    }
+    return Quantity(Units{}, units);
 }
 
 Quantity Quantity::zero() {
-    return Quantity(0.0);
+    return Quantity(Units{}, 0);
 }
 
 } // namespace mde::domain
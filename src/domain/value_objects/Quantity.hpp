@@ -1,25 +1,43 @@
 #pragma once
 
+#include "domain/value_objects/FixedPoint.hpp"
+
 #include <compare>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 
 namespace mde::domain {
 
+// Share quantity, stored as integer micro-shares (Polymarket sizes carry
+// at most six decimals).
 class Quantity {
 public:
     explicit Quantity(double size);
 
-    static Quantity from_string(const std::string& str);
+    static Quantity from_string(std::string_view str);
+    // As from_string, but like std::from_chars: on error leaves `out` alone
+    // and returns std::errc::invalid_argument for a malformed decimal or
+    // std::errc::result_out_of_range for a negative or too large one.
+    static std::errc parse(std::string_view str, Quantity& out) noexcept;
+    static Quantity from_units(int64_t units);
     static Quantity zero();
 
-    double size() const noexcept { return size_; }
+    // Compatibility accessor; the integer representation is authoritative
+    double size() const noexcept { return static_cast<double>(units_) / kFixedPointScale; }
+    int64_t units() const noexcept { return units_; }
+    bool is_zero() const noexcept { return units_ == 0; }
 
     bool operator==(const Quantity&) const = default;
     auto operator<=>(const Quantity&) const = default;
 
 private:
-    double size_;
+    struct Units {};
+    Quantity(Units, int64_t units) noexcept : units_(units) {}
+
+    int64_t units_;
 };
 
 } // namespace mde::domain
@@ -2,15 +2,31 @@
 
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 
 namespace mde::domain {
 
 enum class Side { BUY, SELL };
 
-inline Side side_from_string(const std::string& str) {
-    if (str == "BUY") return Side::BUY;
-    if (str == "SELL") return Side::SELL;
-    throw std::invalid_argument("Invalid side: " + str);
+// "BUY" or "SELL", exactly. Like std::from_chars: leaves `out` alone and
+// returns std::errc::invalid_argument for anything else.
+inline std::errc parse_side(std::string_view str, Side& out) noexcept {
+    if (str.size() == 3 && str[0] == 'B' && str[1] == 'U' && str[2] == 'Y') {
+        out = Side::BUY;
+        return {};
+    }
+    if (str.size() == 4 && str[0] == 'S' && str[1] == 'E' && str[2] == 'L' && str[3] == 'L') {
+        out = Side::SELL;
+        return {};
+    }
+    return std::errc::invalid_argument;
+}
+
+inline Side side_from_string(std::string_view str) {
+    Side side{};
+    if (parse_side(str, side) != std::errc{}) throw std::invalid_argument("Invalid side: " + std::string(str));
+    return side;
 }
 
 } // namespace mde::domain
@@ -1,5 +1,6 @@
 #include "domain/value_objects/Timestamp.hpp"
 
+#include <charconv>
 #include <stdexcept>
 
 namespace mde::domain {
@@ -11,8 +12,24 @@ Timestamp::Timestamp(int64_t milliseconds_since_epoch) : ms_(milliseconds_since_
     }
 }
 
-Timestamp Timestamp::from_string(const std::string& str) {
-    return Timestamp(std::stoll(str));
+Timestamp Timestamp::from_string(std::string_view str) {
+    Timestamp ts(0);
+    auto error = parse(str, ts);
+    if (error == std::errc{}) return ts;
+    if (error == std::errc::result_out_of_range) {
+        throw std::out_of_range("Timestamp out of range: " + std::string(str));
+    }
+    throw std::invalid_argument("Invalid timestamp: " + std::string(str));
+}
+
+std::errc Timestamp::parse(std::string_view str, Timestamp& out) noexcept {
+    int64_t ms = 0;
+    auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), ms);
+    if (error != std::errc{}) return error;
+    if (end != str.data() + str.size()) return std::errc::invalid_argument;
+    if (ms < 0) return std::errc::result_out_of_range;
+    out.ms_ = ms;
+    return {};
 }
 
 } // namespace mde::domain
@@ -3,6 +3,8 @@
 #include <compare>
 #include <cstdint>
 #include <string>
+#include <string_view>
+#include <system_error>
 
 namespace mde::domain {
 
@@ -10,7 +12,11 @@ class Timestamp {
 public:
     explicit Timestamp(int64_t milliseconds_since_epoch);
 
-    static Timestamp from_string(const std::string& str);
+    static Timestamp from_string(std::string_view str);
+    // Decimal milliseconds and nothing else. Like std::from_chars: on error
+    // leaves `out` alone and returns std::errc::invalid_argument, or
+    // std::errc::result_out_of_range for a negative or too large value.
+    static std::errc parse(std::string_view str, Timestamp& out) noexcept;
 
     int64_t milliseconds() const noexcept { return ms_; }
 
@@ -0,0 +1,482 @@
+#include "infrastructure/BinaryFeed.hpp"
+
+#include "infrastructure/LittleEndian.hpp"
+#include "infrastructure/Sockets.hpp"
+#include "services/SpscQueue.hpp"
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <variant>
+
+namespace mde::infrastructure {
+
+using namespace mde::domain;
+using namespace mde::infrastructure::binary;
+using namespace mde::infrastructure::net;
+
+namespace {
+
+// Accept and receive loops wake this often to notice stop()
+constexpr int kPollIntervalMs = 100;
+constexpr auto kServeTimeout = std::chrono::seconds(1);
+
+bool is_multicast(in_addr address) {
+    return IN_MULTICAST(ntohl(address.s_addr));
+}
+
+// Recovery answers frame each packet with a little-endian u32 length
+bool send_framed(int fd, std::string_view packet) {
+    std::string prefix;
+    little_endian::put(prefix, static_cast<uint32_t>(packet.size()));
+    return send_all(fd, prefix.data(), prefix.size()) && send_all(fd, packet.data(), packet.size());
+}
+
+std::optional<uint32_t> receive_length(int fd) {
+    char prefix[4];
+    if (!receive_all(fd, prefix, sizeof(prefix))) return std::nullopt;
+    return little_endian::load<uint32_t>(prefix);
+}
+
+uint32_t make_session() {
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    auto session = static_cast<uint32_t>(now.count()) ^ (static_cast<uint32_t>(::getpid()) << 16);
+    return session != 0 ? session : 1;
+}
+
+const MarketAsset& asset_of(const OrderBookEventVariant& event) {
+    return std::visit([](const auto& e) -> const MarketAsset& { return e.asset; }, event);
+}
+
+BookSnapshot snapshot_of(mde::services::BookLevels&& levels) {
+    return BookSnapshot{{levels.asset, levels.timestamp, levels.last_sequence_number},
+                        std::move(levels.bids), std::move(levels.asks), ""};
+}
+
+} // namespace
+
+void validate(const BinaryPublisherOptions& options) {
+    parse_address(options.group, "group");
+    parse_address(options.recovery_host, "recovery");
+    if (!options.interface_address.empty()) parse_address(options.interface_address, "interface");
+    if (options.max_packet_bytes < kPacketHeaderBytes + kMessageHeaderBytes ||
+        options.max_packet_bytes > kMaxPacketBytes) {
+        throw std::invalid_argument("Binary feed packets must be " +
+                                    std::to_string(kPacketHeaderBytes + kMessageHeaderBytes) + " to " +
+                                    std::to_string(kMaxPacketBytes) + " bytes");
+    }
+    if (options.retransmit_packets == 0) {
+        throw std::invalid_argument("Binary feed needs a retransmit buffer of at least one packet");
+    }
+    if (options.ttl < 0 || options.ttl > 255) {
+        throw std::invalid_argument("Multicast TTL must be 0 to 255");
+    }
+}
+
+// --- BinaryPublisher ---
+
+BinaryPublisher::BinaryPublisher(mde::services::OrderBookService& service, BinaryPublisherOptions options)
+    : service_(service)
+    , options_((validate(options), std::move(options)))
+    , subscription_(service.events().subscribe())
+    , session_(options_.session != 0 ? options_.session : make_session())
+    , writer_(options_.max_packet_bytes)
+    , sent_(options_.retransmit_packets) {
+    auto group = parse_address(options_.group, "group");
+    destination_ = group.s_addr;
+
+    auto feed = open_socket(SOCK_DGRAM, "binary feed socket");
+    if (is_multicast(group)) {
+        set_option(feed.get(), IPPROTO_IP, IP_MULTICAST_TTL, static_cast<unsigned char>(options_.ttl),
+                   "multicast TTL");
+        if (!options_.interface_address.empty()) {
+            set_option(feed.get(), IPPROTO_IP, IP_MULTICAST_IF,
+                       parse_address(options_.interface_address, "interface"), "multicast interface");
+        }
+    }
+
+    auto listener = listen_on(options_.recovery_host, options_.recovery_port, 16, "recovery");
+    recovery_port_ = local_port(listener.get());
+
+    socket_ = feed.release();
+    listener_ = listener.release();
+    writer_.begin(session_, next_sequence_);
+}
+
+BinaryPublisher::~BinaryPublisher() {
+    stop();
+    ::close(socket_);
+    ::close(listener_);
+}
+
+void BinaryPublisher::start() {
+    if (running_.exchange(true)) return;
+    worker_ = std::thread([this] { run(); });
+    server_ = std::thread([this] { serve(); });
+}
+
+void BinaryPublisher::stop() {
+    if (!running_.exchange(false)) return;
+    if (worker_.joinable()) worker_.join();
+    if (server_.joinable()) server_.join();
+}
+
+void BinaryPublisher::run() {
+    mde::services::Backoff backoff;
+    while (running_.load(std::memory_order_acquire)) {
+        if (poll() > 0) {
+            backoff.reset();
+        } else {
+            backoff.pause();
+        }
+    }
+    poll();
+}
+
+size_t BinaryPublisher::poll() {
+    size_t read = subscription_.poll([this](const OrderBookEventVariant& event) {
+        const auto& asset = asset_of(event);
+        define(asset);
+        add(asset.token().index(), event);
+    });
+
+    auto dropped = subscription_.dropped();
+    if (dropped != last_dropped_) {
+        dropped_.fetch_add(dropped - last_dropped_, std::memory_order_relaxed);
+        last_dropped_ = dropped;
+        resync();
+    }
+    if (!writer_.empty()) send();
+    return read;
+}
+
+void BinaryPublisher::define(const MarketAsset& asset) {
+    auto id = asset.token().index();
+    if (id < defined_.size() && defined_[id]) return;
+    if (id >= defined_.size()) defined_.resize(size_t{id} + 1);
+    defined_[id] = true;
+    {
+        std::lock_guard lock(mutex_);
+        assets_.emplace_back(id, asset);
+    }
+    if (!writer_.add_definition(id, asset)) {
+        send();
+        writer_.add_definition(id, asset);
+    }
+}
+
+void BinaryPublisher::add(uint32_t asset, const OrderBookEventVariant& event) {
+    try {
+        if (!writer_.add_event(asset, event)) {
+            send();
+            writer_.add_event(asset, event);
+        }
+        events_sent_.fetch_add(1, std::memory_order_relaxed);
+    } catch (const std::length_error& e) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "[binary] Dropped event: " << e.what() << std::endl;
+    }
+}
+
+void BinaryPublisher::send() {
+    auto packet = writer_.finish();
+    auto address = endpoint(in_addr{destination_}, options_.port);
+    if (::sendto(socket_, packet.data(), packet.size(), 0, reinterpret_cast<const sockaddr*>(&address),
+                 sizeof(address)) < 0) {
+        // Still kept below, so subscribers can have it retransmitted
+        send_errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard lock(mutex_);
+        sent_[next_sequence_ % sent_.size()].assign(packet);
+    }
+    last_sent_.store(next_sequence_, std::memory_order_release);
+    writer_.begin(session_, ++next_sequence_);
+}
+
+void BinaryPublisher::resync() {
+    std::vector<std::pair<uint32_t, MarketAsset>> assets;
+    {
+        std::lock_guard lock(mutex_);
+        assets = assets_;
+    }
+    for (const auto& [id, asset] : assets) {
+        if (auto levels = service_.get_top_levels(asset, std::numeric_limits<size_t>::max())) {
+            add(id, snapshot_of(std::move(*levels)));
+        }
+    }
+}
+
+std::vector<std::string> BinaryPublisher::snapshot_packets() {
+    // Every packet up to as_of was sent after its events were applied, so
+    // books copied from here on include them
+    auto as_of = last_sent_.load(std::memory_order_acquire);
+    std::vector<std::pair<uint32_t, MarketAsset>> assets;
+    {
+        std::lock_guard lock(mutex_);
+        assets = assets_;
+    }
+
+    std::vector<std::string> packets;
+    PacketWriter writer(options_.max_packet_bytes);
+    writer.begin(session_, as_of, kSnapshot);
+    auto append = [&](auto&& add) {
+        if (add()) return;
+        packets.emplace_back(writer.finish());
+        writer.begin(session_, as_of, kSnapshot);
+        add();
+    };
+    for (const auto& [id, asset] : assets) {
+        auto levels = service_.get_top_levels(asset, std::numeric_limits<size_t>::max());
+        if (!levels) continue;
+        OrderBookEventVariant snapshot = snapshot_of(std::move(*levels));
+        try {
+            append([&] { return writer.add_definition(id, asset); });
+            append([&] { return writer.add_event(id, snapshot); });
+        } catch (const std::length_error& e) {
+            std::cerr << "[binary] Left a book out of a snapshot: " << e.what() << std::endl;
+        }
+    }
+    if (!writer.empty() || packets.empty()) packets.emplace_back(writer.finish());
+    return packets;
+}
+
+void BinaryPublisher::serve() {
+    while (running_.load(std::memory_order_acquire)) {
+        pollfd ready{listener_, POLLIN, 0};
+        if (::poll(&ready, 1, kPollIntervalMs) <= 0) continue;
+        Descriptor connection(::accept(listener_, nullptr, nullptr));
+        if (connection.get() < 0) continue;
+        set_timeouts(connection.get(), kServeTimeout);
+        answer(connection.get());
+    }
+}
+
+void BinaryPublisher::answer(int connection) {
+    std::string bytes(kRecoveryRequestBytes, '\0');
+    if (!receive_all(connection, bytes.data(), bytes.size())) return;
+    auto request = read_request(bytes);
+    if (!request) return;
+
+    std::vector<std::string> packets;
+    if (request->kind == RecoveryKind::snapshot) {
+        packets = snapshot_packets();
+        snapshots_.fetch_add(1, std::memory_order_relaxed);
+    } else if (request->session == session_ && request->from > 0) {
+        std::lock_guard lock(mutex_);
+        auto to = std::min(request->to, last_sent_.load(std::memory_order_acquire));
+        auto held = sent_.size();
+        auto from = std::max(request->from, to >= held ? to - held + 1 : 1);
+        for (auto sequence = from; sequence <= to; ++sequence) {
+            const auto& packet = sent_[sequence % held];
+            auto header = read_header(packet);
+            if (header && header->sequence == sequence) packets.push_back(packet);
+        }
+        retransmits_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    for (const auto& packet : packets) {
+        if (!send_framed(connection, packet)) return;
+    }
+    send_framed(connection, {});
+}
+
+// --- BinarySubscriber ---
+
+BinarySubscriber::BinarySubscriber(BinarySubscriberOptions options)
+    : options_(std::move(options)) {
+    parse_address(options_.group, "group");
+    parse_address(options_.recovery_host, "recovery");
+    if (!options_.interface_address.empty()) parse_address(options_.interface_address, "interface");
+}
+
+BinarySubscriber::~BinarySubscriber() {
+    stop();
+}
+
+void BinarySubscriber::set_on_event(EventCallback callback) {
+    on_event_ = std::move(callback);
+    on_events_ = nullptr;
+}
+
+void BinarySubscriber::set_on_events(BatchCallback callback) {
+    on_events_ = std::move(callback);
+    on_event_ = nullptr;
+}
+
+void BinarySubscriber::start() {
+    if (running_.load()) return;
+    auto group = parse_address(options_.group, "group");
+
+    auto feed = open_socket(SOCK_DGRAM, "binary feed socket");
+    set_option(feed.get(), SOL_SOCKET, SO_REUSEADDR, 1, "SO_REUSEADDR");
+    // Bursts outrun the default buffer; best effort, the kernel caps it
+    int buffer = 4 << 20;
+    ::setsockopt(feed.get(), SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+    auto local = endpoint(in_addr{htonl(INADDR_ANY)}, options_.port);
+    if (::bind(feed.get(), reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) {
+        throw std::system_error(errno, std::generic_category(),
+                                "Cannot bind binary feed port " + std::to_string(options_.port));
+    }
+    if (is_multicast(group)) {
+        ip_mreq membership{};
+        membership.imr_multiaddr = group;
+        membership.imr_interface = options_.interface_address.empty()
+                                       ? in_addr{htonl(INADDR_ANY)}
+                                       : parse_address(options_.interface_address, "interface");
+        set_option(feed.get(), IPPROTO_IP, IP_ADD_MEMBERSHIP, membership, "multicast membership");
+    }
+
+    socket_ = feed.release();
+    running_ = true;
+    thread_ = std::thread([this] { run(); });
+}
+
+void BinarySubscriber::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+    ::close(socket_);
+    socket_ = -1;
+}
+
+void BinarySubscriber::run() {
+    std::vector<char> buffer(kMaxPacketBytes);
+    while (running_.load(std::memory_order_acquire)) {
+        pollfd ready{socket_, POLLIN, 0};
+        if (::poll(&ready, 1, kPollIntervalMs) <= 0) continue;
+        auto received = ::recv(socket_, buffer.data(), buffer.size(), 0);
+        if (received <= 0) continue;
+        handle_packet(std::string_view(buffer.data(), static_cast<size_t>(received)));
+    }
+}
+
+void BinarySubscriber::handle_packet(std::string_view packet) {
+    received_.fetch_add(1, std::memory_order_relaxed);
+    auto header = read_header(packet);
+    if (!header || (header->flags & kSnapshot)) {
+        malformed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (header->session != session_) {
+        // First packet, or the publisher restarted: ids and sequence
+        // numbers start over
+        session_ = header->session;
+        next_ = 0;
+        assets_.clear();
+        last_event_.clear();
+    }
+    if (next_ == 0) {
+        auto as_of = take_snapshot();
+        next_ = as_of ? *as_of + 1 : header->sequence;
+    }
+
+    if (header->sequence > next_) recover(header->sequence);
+    if (header->sequence < next_) {
+        duplicates_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    deliver(packet);
+    ++next_;
+}
+
+bool BinarySubscriber::recover(uint64_t up_to) {
+    gaps_.fetch_add(1, std::memory_order_relaxed);
+    fetch(RecoveryRequest{RecoveryKind::retransmit, session_, next_, up_to - 1}, [&](std::string_view packet) {
+        auto header = read_header(packet);
+        if (!header || header->session != session_ || header->sequence != next_) return;
+        deliver(packet);
+        ++next_;
+        recovered_.fetch_add(1, std::memory_order_relaxed);
+    });
+    if (next_ == up_to) return true;
+
+    // The publisher no longer holds them all
+    if (auto as_of = take_snapshot(); as_of && *as_of + 1 > next_) next_ = *as_of + 1;
+    if (next_ < up_to) {
+        lost_.fetch_add(up_to - next_, std::memory_order_relaxed);
+        next_ = up_to;
+        return false;
+    }
+    return true;
+}
+
+std::optional<uint64_t> BinarySubscriber::take_snapshot() {
+    std::optional<uint64_t> as_of;
+    bool foreign = false;
+    bool complete = fetch(RecoveryRequest{RecoveryKind::snapshot, session_, 0, 0}, [&](std::string_view packet) {
+        auto header = read_header(packet);
+        if (!header || header->session != session_ || !(header->flags & kSnapshot)) {
+            // Restarted since the live packet that sent us here
+            foreign = true;
+            return;
+        }
+        as_of = header->sequence;
+        deliver(packet);
+    });
+    if (!complete || foreign) return std::nullopt;
+    snapshots_.fetch_add(1, std::memory_order_relaxed);
+    return as_of;
+}
+
+void BinarySubscriber::deliver(std::string_view packet) {
+    batch_.clear();
+    auto result = decode_packet(packet, assets_, [this](uint32_t asset, OrderBookEventVariant&& event) {
+        auto sequence = std::visit([](const auto& e) { return e.sequence_number; }, event);
+        if (asset >= last_event_.size()) last_event_.resize(size_t{asset} + 1, 0);
+        auto& last = last_event_[asset];
+        // A book snapshot as new as the book replaces it with the same
+        // state, so only strictly older ones are dropped
+        bool covered = std::holds_alternative<BookSnapshot>(event) ? sequence < last : sequence <= last;
+        if (covered) return;
+        last = sequence;
+        batch_.push_back(std::move(event));
+    });
+    if (!result.ok) {
+        malformed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    malformed_.fetch_add(result.skipped, std::memory_order_relaxed);
+    if (batch_.empty()) return;
+
+    delivered_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    if (on_events_) {
+        on_events_(std::span(batch_.begin(), batch_.end()));
+    } else if (on_event_) {
+        for (auto& event : batch_) on_event_(std::move(event));
+    }
+}
+
+template <typename OnPacket>
+bool BinarySubscriber::fetch(const RecoveryRequest& request, OnPacket&& on_packet) {
+    if (options_.recovery_port == 0) return false;
+    Descriptor connection(::socket(AF_INET, SOCK_STREAM, 0));
+    if (connection.get() < 0) return false;
+    set_timeouts(connection.get(), options_.recovery_timeout);
+    auto address = endpoint(parse_address(options_.recovery_host, "recovery"), options_.recovery_port);
+    if (::connect(connection.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        return false;
+    }
+    auto bytes = encode_request(request);
+    if (!send_all(connection.get(), bytes.data(), bytes.size())) return false;
+
+    std::string packet;
+    while (auto length = receive_length(connection.get())) {
+        if (*length == 0) return true;
+        if (*length > kMaxPacketBytes) return false;
+        packet.resize(*length);
+        if (!receive_all(connection.get(), packet.data(), packet.size())) return false;
+        on_packet(std::string_view(packet));
+    }
+    return false;
+}
+
+} // namespace mde::infrastructure
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "infrastructure/BinaryProtocol.hpp"
+#include "services/IMarketDataFeed.hpp"
+#include "services/OrderBookService.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mde::infrastructure {
+
+struct BinaryPublisherOptions {
+    // Multicast group (or, for a single listener, a unicast address) and port
+    std::string group = "239.255.0.1";
+    uint16_t port = 20000;
+    // Local address of the interface multicast leaves by; empty = the default
+    std::string interface_address;
+    int ttl = 1;
+    // Packets are cut at this size (the message that opens a packet may
+    // go past it, see PacketWriter)
+    size_t max_packet_bytes = 1400;
+    // Live packets kept for retransmit requests
+    size_t retransmit_packets = 8192;
+    // TCP recovery endpoint; port 0 binds an ephemeral one (recovery_port())
+    std::string recovery_host = "0.0.0.0";
+    uint16_t recovery_port = 20001;
+    // 0 picks one from the clock and pid
+    uint32_t session = 0;
+};
+
+// Throws std::invalid_argument for bad addresses, a packet size outside
+// the header..kMaxPacketBytes range or no retransmit buffer
+void validate(const BinaryPublisherOptions& options);
+
+// Publishes the service's event stream in the binary wire format
+// (BinaryProtocol.hpp) over UDP, for consumers that want every event with
+// less decoding and latency than JSON. A worker thread reads the stream,
+// packs events into packets and sends a packet once it is full or the
+// stream is drained, so a quiet feed goes out event by event and a busy one
+// in full packets. Each asset gets a wire id (its token's interned index)
+// with a definition before its first event.
+//
+// Subscribers recover over TCP from the same process: retransmits come
+// from the last retransmit_packets packets sent; snapshots copy the books
+// (OrderBookService::get_top_levels) of every asset seen on the stream
+// since this started. Books are copied after the packets they reflect were
+// sent, so a snapshot can be newer than the sequence it is stamped with:
+// subscribers drop events that are not newer than what they hold. Recovery
+// connections are served one at a time on their own thread.
+//
+// A publisher that falls a whole ring behind the stream cannot send what
+// it lost; it sends a book_snapshot of every asset it knows instead.
+class BinaryPublisher {
+public:
+    // Subscribes at once and binds the sockets; throws std::invalid_argument
+    // (see validate) or std::system_error if a socket cannot be set up
+    BinaryPublisher(mde::services::OrderBookService& service, BinaryPublisherOptions options = {});
+    ~BinaryPublisher();
+
+    BinaryPublisher(const BinaryPublisher&) = delete;
+    BinaryPublisher& operator=(const BinaryPublisher&) = delete;
+
+    void start();
+    // Sends what was published before the call, then joins both threads
+    void stop();
+
+    // Pack and send every event published so far; returns how many were
+    // read. What the worker does; call it yourself only while not started.
+    size_t poll();
+
+    uint32_t session() const noexcept { return session_; }
+    uint16_t recovery_port() const noexcept { return recovery_port_; }
+    // Sequence number of the last packet sent, 0 before the first
+    uint64_t last_sequence() const noexcept { return last_sent_.load(std::memory_order_acquire); }
+
+    // Packed into a packet; each goes out with its packet by the end of poll()
+    uint64_t events_sent() const noexcept { return events_sent_.load(std::memory_order_relaxed); }
+    uint64_t packets_sent() const noexcept { return last_sequence(); }
+    uint64_t send_errors() const noexcept { return send_errors_.load(std::memory_order_relaxed); }
+    // Lost to a lapped ring, or too large for any packet
+    uint64_t events_dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t retransmits_served() const noexcept { return retransmits_.load(std::memory_order_relaxed); }
+    uint64_t snapshots_served() const noexcept { return snapshots_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void serve();
+    void answer(int connection);
+    void add(uint32_t asset, const mde::domain::OrderBookEventVariant& event);
+    void define(const mde::domain::MarketAsset& asset);
+    void send();
+    void resync();
+    std::vector<std::string> snapshot_packets();
+
+    mde::services::OrderBookService& service_;
+    BinaryPublisherOptions options_;
+    mde::services::OrderBookService::EventStream::Subscription subscription_;
+    uint32_t session_;
+
+    // Polling thread only. defined_ is indexed by wire id.
+    binary::PacketWriter writer_;
+    std::vector<bool> defined_;
+    uint64_t next_sequence_{1};
+    uint64_t last_dropped_{0};
+
+    // Shared with the recovery thread
+    mutable std::mutex mutex_;
+    std::vector<std::pair<uint32_t, mde::domain::MarketAsset>> assets_;  // in order of first event
+    std::vector<std::string> sent_;  // ring of live packets, by sequence
+
+    int socket_{-1};
+    int listener_{-1};
+    uint16_t recovery_port_{0};
+    uint32_t destination_{0};  // IPv4 address, network byte order
+
+    std::atomic<uint64_t> last_sent_{0};
+    std::atomic<uint64_t> events_sent_{0};
+    std::atomic<uint64_t> send_errors_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> retransmits_{0};
+    std::atomic<uint64_t> snapshots_{0};
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+    std::thread server_;
+};
+
+struct BinarySubscriberOptions {
+    std::string group = "239.255.0.1";
+    uint16_t port = 20000;
+    std::string interface_address;  // joins on the default interface if empty
+    // The publisher's recovery endpoint; port 0 disables recovery, so gaps
+    // are only counted
+    std::string recovery_host = "127.0.0.1";
+    uint16_t recovery_port = 20001;
+    std::chrono::milliseconds recovery_timeout{1000};
+};
+
+// Feed side of the binary protocol: receives the publisher's packets and
+// hands their events on like any other feed, so an OrderBookService can
+// run off another engine's output. Every asset on the wire is carried, so
+// subscribe() is ignored.
+//
+// Packets are taken in sequence. The first packet of a session (at start,
+// or after the publisher restarts) first fetches a snapshot; a gap asks
+// for a retransmit of the missing packets and, if the publisher no longer
+// holds them all, falls back to a snapshot. Events already covered by what
+// was delivered for their asset (by sequence number) are dropped, so the
+// snapshot and the live packets that overlap it are applied once.
+// Whatever recovery cannot fill is skipped and counted in packets_lost();
+// the next snapshot or BookSnapshot of an asset repairs its book.
+class BinarySubscriber : public mde::services::IMarketDataFeed {
+public:
+    // Throws std::invalid_argument for bad addresses
+    explicit BinarySubscriber(BinarySubscriberOptions options = {});
+    ~BinarySubscriber() override;
+
+    BinarySubscriber(const BinarySubscriber&) = delete;
+    BinarySubscriber& operator=(const BinarySubscriber&) = delete;
+
+    void set_on_event(EventCallback callback) override;
+    void set_on_events(BatchCallback callback) override;
+    void subscribe(const std::string&) override {}
+
+    // Joins the group and receives on a thread of its own; throws
+    // std::system_error if the socket cannot be set up
+    void start() override;
+    void stop() override;
+
+    // One datagram through sequencing and recovery, as the receive thread
+    // does; call it yourself (from one thread) to use another transport
+    void handle_packet(std::string_view packet);
+
+    uint64_t packets_received() const noexcept { return received_.load(std::memory_order_relaxed); }
+    uint64_t events_delivered() const noexcept { return delivered_.load(std::memory_order_relaxed); }
+    uint64_t duplicates() const noexcept { return duplicates_.load(std::memory_order_relaxed); }
+    uint64_t gaps() const noexcept { return gaps_.load(std::memory_order_relaxed); }
+    uint64_t packets_recovered() const noexcept { return recovered_.load(std::memory_order_relaxed); }
+    uint64_t snapshots() const noexcept { return snapshots_.load(std::memory_order_relaxed); }
+    uint64_t packets_lost() const noexcept { return lost_.load(std::memory_order_relaxed); }
+    // Malformed packets, and events with an unknown asset or bad values
+    uint64_t malformed() const noexcept { return malformed_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void deliver(std::string_view packet);
+    bool recover(uint64_t up_to);
+    std::optional<uint64_t> take_snapshot();
+    // Send a request and hand each packet of the answer to on_packet;
+    // false if the connection failed before the end of the answer
+    template <typename OnPacket>
+    bool fetch(const binary::RecoveryRequest& request, OnPacket&& on_packet);
+
+    BinarySubscriberOptions options_;
+    EventCallback on_event_;
+    BatchCallback on_events_;
+
+    // Packet handling thread only
+    binary::AssetDictionary assets_;
+    std::vector<uint64_t> last_event_;  // by wire id: last sequence number delivered
+    std::vector<mde::domain::OrderBookEventVariant> batch_;
+    uint32_t session_{0};
+    uint64_t next_{0};  // sequence expected next, 0 until synced
+
+    int socket_{-1};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> duplicates_{0};
+    std::atomic<uint64_t> gaps_{0};
+    std::atomic<uint64_t> recovered_{0};
+    std::atomic<uint64_t> snapshots_{0};
+    std::atomic<uint64_t> lost_{0};
+    std::atomic<uint64_t> malformed_{0};
+};
+
+} // namespace mde::infrastructure
@@ -0,0 +1,346 @@
+#include "infrastructure/BinaryProtocol.hpp"
+
+#include "infrastructure/LittleEndian.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+namespace mde::infrastructure::binary {
+
+using namespace mde::domain;
+using little_endian::load;
+using little_endian::patch;
+using little_endian::put;
+
+namespace {
+
+// Fixed blocks of each message body, before their repeating groups
+constexpr size_t kDefinitionBlock = 4;
+constexpr size_t kSnapshotBlock = 24;
+constexpr size_t kLevelBytes = 16;
+constexpr size_t kDeltaBlock = 24;
+constexpr size_t kChangeBytes = 40;
+constexpr size_t kTradeBlock = 40;
+constexpr size_t kTickSizeBlock = 32;
+
+void put_zeros(std::string& out, size_t n) {
+    out.append(n, '\0');
+}
+
+void put_message_header(std::string& out, MessageType type, uint32_t asset) {
+    put<uint16_t>(out, 0);  // length, patched by commit()
+    put(out, static_cast<uint8_t>(type));
+    put<uint8_t>(out, 0);
+    put(out, asset);
+}
+
+void put_event_header(std::string& out, const OrderBookEvent& e) {
+    put(out, e.timestamp.milliseconds());
+    put(out, e.sequence_number);
+}
+
+void put_levels(std::string& out, const std::vector<PriceLevel>& levels) {
+    for (const auto& level : levels) {
+        put(out, level.price().micros());
+        put(out, level.size().units());
+    }
+}
+
+template <typename Count>
+Count checked_count(size_t n, const char* what) {
+    if (n > std::numeric_limits<Count>::max()) throw std::length_error(std::string("Too many ") + what + " for one message");
+    return static_cast<Count>(n);
+}
+
+void put_body(std::string& out, const BookSnapshot& e) {
+    put_event_header(out, e);
+    put(out, checked_count<uint16_t>(e.bids.size(), "bids"));
+    put(out, checked_count<uint16_t>(e.asks.size(), "asks"));
+    put(out, checked_count<uint16_t>(e.hash.size(), "hash bytes"));
+    put_zeros(out, 2);
+    put_levels(out, e.bids);
+    put_levels(out, e.asks);
+    out.append(e.hash);
+}
+
+void put_body(std::string& out, const BookDelta& e) {
+    put_event_header(out, e);
+    put(out, checked_count<uint16_t>(e.changes.size(), "changes"));
+    put_zeros(out, 6);
+    for (const auto& change : e.changes) {
+        put(out, change.price.micros());
+        put(out, change.new_size.units());
+        put(out, change.best_bid.micros());
+        put(out, change.best_ask.micros());
+        put(out, static_cast<uint8_t>(change.side));
+        put_zeros(out, 7);
+    }
+}
+
+void put_body(std::string& out, const TradeEvent& e) {
+    put_event_header(out, e);
+    put(out, e.price.micros());
+    put(out, e.size.units());
+    put(out, static_cast<uint8_t>(e.side));
+    put(out, checked_count<uint8_t>(e.fee_rate_bps.size(), "fee bytes"));
+    put_zeros(out, 6);
+    out.append(e.fee_rate_bps);
+}
+
+void put_body(std::string& out, const TickSizeChange& e) {
+    put_event_header(out, e);
+    put(out, e.old_tick_size.micros());
+    put(out, e.new_tick_size.micros());
+}
+
+constexpr MessageType type_of(const BookSnapshot&) { return MessageType::book_snapshot; }
+constexpr MessageType type_of(const BookDelta&) { return MessageType::book_delta; }
+constexpr MessageType type_of(const TradeEvent&) { return MessageType::trade; }
+constexpr MessageType type_of(const TickSizeChange&) { return MessageType::tick_size_change; }
+
+// Whether a body's repeating groups add up to its length
+bool body_fits(MessageType type, std::string_view body) {
+    const char* p = body.data();
+    switch (type) {
+    case MessageType::asset_definition:
+        return body.size() >= kDefinitionBlock &&
+               body.size() == kDefinitionBlock + load<uint16_t>(p) + load<uint16_t>(p + 2);
+    case MessageType::book_snapshot:
+        return body.size() >= kSnapshotBlock &&
+               body.size() == kSnapshotBlock +
+                                  kLevelBytes * (size_t{load<uint16_t>(p + 16)} + load<uint16_t>(p + 18)) +
+                                  load<uint16_t>(p + 20);
+    case MessageType::book_delta:
+        return body.size() >= kDeltaBlock && body.size() == kDeltaBlock + kChangeBytes * load<uint16_t>(p + 16);
+    case MessageType::trade:
+        return body.size() >= kTradeBlock &&
+               body.size() == kTradeBlock + static_cast<uint8_t>(p[33]);
+    case MessageType::tick_size_change:
+        return body.size() == kTickSizeBlock;
+    }
+    return false;
+}
+
+Side side_of(char byte) {
+    return byte == 0 ? Side::BUY : Side::SELL;
+}
+
+std::vector<PriceLevel> load_levels(const char* p, size_t count) {
+    std::vector<PriceLevel> levels;
+    levels.reserve(count);
+    for (size_t i = 0; i < count; ++i, p += kLevelBytes) {
+        levels.emplace_back(Price::from_micros(load<int64_t>(p)), Quantity::from_units(load<int64_t>(p + 8)));
+    }
+    return levels;
+}
+
+} // namespace
+
+// --- PacketWriter ---
+
+PacketWriter::PacketWriter(size_t max_bytes)
+    : max_bytes_(std::min(std::max(max_bytes, kPacketHeaderBytes + kMessageHeaderBytes), kMaxPacketBytes)) {
+    buffer_.reserve(max_bytes_);
+}
+
+void PacketWriter::begin(uint32_t session, uint64_t sequence, uint8_t flags) {
+    buffer_.clear();
+    count_ = 0;
+    put(buffer_, kMagic);
+    put(buffer_, kVersion);
+    put(buffer_, flags);
+    put<uint16_t>(buffer_, 0);  // message count and length, patched by finish()
+    put<uint16_t>(buffer_, 0);
+    put(buffer_, session);
+    put(buffer_, sequence);
+}
+
+bool PacketWriter::add_definition(uint32_t asset, const MarketAsset& definition) {
+    auto start = buffer_.size();
+    put_message_header(buffer_, MessageType::asset_definition, asset);
+    put(buffer_, checked_count<uint16_t>(definition.condition_id().size(), "condition id bytes"));
+    put(buffer_, checked_count<uint16_t>(definition.token_id().size(), "token id bytes"));
+    buffer_.append(definition.condition_id());
+    buffer_.append(definition.token_id());
+    return commit(start);
+}
+
+bool PacketWriter::add_event(uint32_t asset, const OrderBookEventVariant& event) {
+    auto start = buffer_.size();
+    try {
+        std::visit([&](const auto& e) {
+            put_message_header(buffer_, type_of(e), asset);
+            put_body(buffer_, e);
+        }, event);
+    } catch (...) {
+        buffer_.resize(start);
+        throw;
+    }
+    return commit(start);
+}
+
+bool PacketWriter::commit(size_t start) {
+    auto length = buffer_.size() - start;
+    if (count_ > 0 && buffer_.size() > max_bytes_) {
+        buffer_.resize(start);
+        return false;
+    }
+    if (buffer_.size() > kMaxPacketBytes) {
+        buffer_.resize(start);
+        throw std::length_error("Message of " + std::to_string(length) + " bytes does not fit a packet");
+    }
+    patch(buffer_, start, static_cast<uint16_t>(length));
+    ++count_;
+    return true;
+}
+
+std::string_view PacketWriter::finish() {
+    patch(buffer_, 4, count_);
+    patch(buffer_, 6, static_cast<uint16_t>(buffer_.size()));
+    return buffer_;
+}
+
+// --- AssetDictionary ---
+
+void AssetDictionary::define(uint32_t asset, MarketAsset definition) {
+    if (asset >= assets_.size()) assets_.resize(size_t{asset} + 1);
+    assets_[asset] = std::move(definition);
+}
+
+const MarketAsset* AssetDictionary::find(uint32_t asset) const noexcept {
+    if (asset >= assets_.size() || !assets_[asset]) return nullptr;
+    return &*assets_[asset];
+}
+
+size_t AssetDictionary::size() const noexcept {
+    size_t defined = 0;
+    for (const auto& asset : assets_) defined += asset.has_value();
+    return defined;
+}
+
+// --- Recovery requests ---
+
+std::string encode_request(const RecoveryRequest& request) {
+    std::string out;
+    out.reserve(kRecoveryRequestBytes);
+    put(out, kMagic);
+    put(out, kVersion);
+    put(out, static_cast<uint8_t>(request.kind));
+    put(out, request.session);
+    put(out, request.from);
+    put(out, request.to);
+    return out;
+}
+
+std::optional<RecoveryRequest> read_request(std::string_view bytes) {
+    if (bytes.size() != kRecoveryRequestBytes) return std::nullopt;
+    const char* p = bytes.data();
+    if (load<uint16_t>(p) != kMagic || static_cast<uint8_t>(p[2]) != kVersion) return std::nullopt;
+    auto kind = static_cast<RecoveryKind>(static_cast<uint8_t>(p[3]));
+    if (kind != RecoveryKind::retransmit && kind != RecoveryKind::snapshot) return std::nullopt;
+    return RecoveryRequest{kind, load<uint32_t>(p + 4), load<uint64_t>(p + 8), load<uint64_t>(p + 16)};
+}
+
+// --- Decoding ---
+
+std::optional<PacketHeader> read_header(std::string_view packet) {
+    if (packet.size() < kPacketHeaderBytes) return std::nullopt;
+    const char* p = packet.data();
+    if (load<uint16_t>(p) != kMagic || static_cast<uint8_t>(p[2]) != kVersion) return std::nullopt;
+    PacketHeader header;
+    header.version = static_cast<uint8_t>(p[2]);
+    header.flags = static_cast<uint8_t>(p[3]);
+    header.message_count = load<uint16_t>(p + 4);
+    header.length = load<uint16_t>(p + 6);
+    header.session = load<uint32_t>(p + 8);
+    header.sequence = load<uint64_t>(p + 12);
+    if (header.length != packet.size()) return std::nullopt;
+    return header;
+}
+
+namespace detail {
+
+uint16_t load_u16(const char* p) noexcept {
+    return load<uint16_t>(p);
+}
+
+uint32_t load_u32(const char* p) noexcept {
+    return load<uint32_t>(p);
+}
+
+bool check_messages(std::string_view packet, uint16_t count) {
+    size_t pos = kPacketHeaderBytes;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (packet.size() - pos < kMessageHeaderBytes) return false;
+        auto length = load<uint16_t>(packet.data() + pos);
+        if (length < kMessageHeaderBytes || packet.size() - pos < length) return false;
+        auto type = static_cast<MessageType>(static_cast<uint8_t>(packet[pos + 2]));
+        if (!body_fits(type, packet.substr(pos + kMessageHeaderBytes, length - kMessageHeaderBytes))) return false;
+        pos += length;
+    }
+    return pos == packet.size();
+}
+
+bool decode_message(MessageType type, uint32_t asset, std::string_view body, AssetDictionary& assets,
+                    std::optional<OrderBookEventVariant>& event) {
+    const char* p = body.data();
+    if (type == MessageType::asset_definition) {
+        auto condition_length = load<uint16_t>(p);
+        auto condition = body.substr(kDefinitionBlock, condition_length);
+        auto token = body.substr(kDefinitionBlock + condition_length);
+        assets.define(asset, MarketAsset(condition, token));
+        return true;
+    }
+
+    const auto* market = assets.find(asset);
+    if (!market) return false;
+    OrderBookEvent header{*market, Timestamp(load<int64_t>(p)), load<uint64_t>(p + 8)};
+
+    try {
+        switch (type) {
+        case MessageType::book_snapshot: {
+            size_t bids = load<uint16_t>(p + 16);
+            size_t asks = load<uint16_t>(p + 18);
+            const char* levels = p + kSnapshotBlock;
+            event = BookSnapshot{header, load_levels(levels, bids), load_levels(levels + bids * kLevelBytes, asks),
+                                 std::string(body.substr(kSnapshotBlock + (bids + asks) * kLevelBytes))};
+            return true;
+        }
+        case MessageType::book_delta: {
+            size_t count = load<uint16_t>(p + 16);
+            BookDelta delta{header, {}};
+            delta.changes.reserve(count);
+            for (const char* c = p + kDeltaBlock; count > 0; --count, c += kChangeBytes) {
+                delta.changes.push_back(PriceLevelDelta{market->token(), Price::from_micros(load<int64_t>(c)),
+                                                        Quantity::from_units(load<int64_t>(c + 8)), side_of(c[32]),
+                                                        Price::from_micros(load<int64_t>(c + 16)),
+                                                        Price::from_micros(load<int64_t>(c + 24))});
+            }
+            event = std::move(delta);
+            return true;
+        }
+        case MessageType::trade:
+            event = TradeEvent{header, Price::from_micros(load<int64_t>(p + 16)),
+                               Quantity::from_units(load<int64_t>(p + 24)), side_of(p[32]),
+                               std::string(body.substr(kTradeBlock))};
+            return true;
+        case MessageType::tick_size_change:
+            event = TickSizeChange{header, Price::from_micros(load<int64_t>(p + 16)),
+                                   Price::from_micros(load<int64_t>(p + 24))};
+            return true;
+        case MessageType::asset_definition:
+            break;
+        }
+    } catch (const std::exception&) {
+        // Price or size out of range
+    }
+    return false;
+}
+
+} // namespace detail
+
+} // namespace mde::infrastructure::binary
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mde::infrastructure::binary {
+
+// Wire format of the binary market data feed (BinaryPublisher ->
+// BinarySubscriber). Little-endian, fixed layout, no per-field tags: a
+// packet is a header followed by messages, each a fixed block for its type
+// plus repeating groups. Prices, sizes and tick sizes are int64 micro-units
+// (FixedPoint.hpp), timestamps int64 milliseconds.
+//
+//   Packet header (20 bytes)
+//     u16 magic 'MD' | u8 version | u8 flags | u16 message_count
+//     u16 length (whole packet) | u32 session | u64 sequence
+//   Message header (8 bytes)
+//     u16 length (whole message) | u8 type | u8 reserved | u32 asset
+//   asset_definition   u16 condition length | u16 token length | bytes
+//   book_snapshot      i64 timestamp | u64 seq | u16 bids | u16 asks |
+//                      u16 hash length | u16 reserved |
+//                      (i64 price, i64 size) x (bids + asks) | hash
+//   book_delta         i64 timestamp | u64 seq | u16 changes | u16 x3 reserved |
+//                      (i64 price, i64 size, i64 best bid, i64 best ask,
+//                       u8 side, u8 x7 reserved) x changes
+//   trade              i64 timestamp | u64 seq | i64 price | i64 size |
+//                      u8 side | u8 fee length | u16 x3 reserved | fee
+//   tick_size_change   i64 timestamp | u64 seq | i64 old tick | i64 new tick
+//
+// Assets travel as u32 ids, each defined once per session by an
+// asset_definition sent before its first event (and in every snapshot). A
+// delta's changes are all for its own asset, as the parser emits them, so
+// they carry no asset of their own.
+//
+// Packets are numbered 1, 2, ... per session; a new session id means the
+// publisher restarted and every id and sequence number starts over. Packets
+// answering a snapshot request carry kSnapshot and the sequence of the last
+// live packet the snapshot includes.
+//
+// Recovery runs over TCP, one request per connection:
+//   Request (24 bytes)
+//     u16 magic | u8 version | u8 kind | u32 session | u64 from | u64 to
+//   Response: packets, each prefixed with its u32 length, then a u32 0
+// A retransmit answers with the live packets from..to the publisher still
+// holds for that session, in order (possibly none). A snapshot ignores the
+// other fields and answers with definitions and a book_snapshot per asset,
+// at least one packet even when there are no books.
+inline constexpr uint16_t kMagic = 0x444D;  // "MD"
+inline constexpr uint8_t kVersion = 1;
+inline constexpr size_t kPacketHeaderBytes = 20;
+inline constexpr size_t kMessageHeaderBytes = 8;
+// Largest UDP payload over IPv4
+inline constexpr size_t kMaxPacketBytes = 65507;
+
+inline constexpr uint8_t kSnapshot = 1u << 0;  // PacketHeader::flags
+
+inline constexpr size_t kRecoveryRequestBytes = 24;
+
+enum class RecoveryKind : uint8_t {
+    retransmit = 1,
+    snapshot = 2,
+};
+
+struct RecoveryRequest {
+    RecoveryKind kind{RecoveryKind::snapshot};
+    uint32_t session{0};
+    uint64_t from{0};
+    uint64_t to{0};
+};
+
+std::string encode_request(const RecoveryRequest& request);
+// nullopt unless exactly a request of this version
+std::optional<RecoveryRequest> read_request(std::string_view bytes);
+
+enum class MessageType : uint8_t {
+    asset_definition = 1,
+    book_snapshot = 2,
+    book_delta = 3,
+    trade = 4,
+    tick_size_change = 5,
+};
+
+struct PacketHeader {
+    uint8_t version{kVersion};
+    uint8_t flags{0};
+    uint16_t message_count{0};
+    uint16_t length{0};
+    uint32_t session{0};
+    uint64_t sequence{0};
+};
+
+// Builds one packet at a time into a buffer it reuses
+class PacketWriter {
+public:
+    explicit PacketWriter(size_t max_bytes = 1400);
+
+    void begin(uint32_t session, uint64_t sequence, uint8_t flags = 0);
+
+    // Append one message. Returns false, appending nothing, if it would take
+    // a non-empty packet past max_bytes. The first message of a packet may
+    // be larger (a deep book snapshot goes out alone, IP fragmenting it);
+    // one that does not fit kMaxPacketBytes throws std::length_error.
+    bool add_definition(uint32_t asset, const mde::domain::MarketAsset& definition);
+    bool add_event(uint32_t asset, const mde::domain::OrderBookEventVariant& event);
+
+    bool empty() const noexcept { return count_ == 0; }
+    uint16_t message_count() const noexcept { return count_; }
+    // The finished packet; valid until the next begin()
+    std::string_view finish();
+
+private:
+    bool commit(size_t start);
+
+    size_t max_bytes_;
+    std::string buffer_;
+    uint16_t count_{0};
+};
+
+// Asset ids of one session, as learned from asset_definition messages
+class AssetDictionary {
+public:
+    void define(uint32_t asset, mde::domain::MarketAsset definition);
+    const mde::domain::MarketAsset* find(uint32_t asset) const noexcept;
+    void clear() noexcept { assets_.clear(); }
+    size_t size() const noexcept;
+
+private:
+    std::vector<std::optional<mde::domain::MarketAsset>> assets_;
+};
+
+// Header of a packet that starts with the magic and version and is as long
+// as it says; nullopt otherwise
+std::optional<PacketHeader> read_header(std::string_view packet);
+
+struct DecodeResult {
+    bool ok{false};            // false: malformed, and nothing was delivered
+    size_t events{0};          // delivered
+    size_t skipped{0};         // events for an undefined asset id or with out-of-range values
+};
+
+// Decode a packet: definitions go into `assets`, and each event is handed to
+// on_event(asset id, event) in order. Every message length is checked before
+// anything is delivered.
+template <typename Handler>
+DecodeResult decode_packet(std::string_view packet, AssetDictionary& assets, Handler&& on_event);
+
+namespace detail {
+// One message body (after its header), whose size check_messages has
+// verified; false for an undefined asset or a value out of range
+bool decode_message(MessageType type, uint32_t asset, std::string_view body, AssetDictionary& assets,
+                    std::optional<mde::domain::OrderBookEventVariant>& event);
+bool check_messages(std::string_view packet, uint16_t count);
+uint16_t load_u16(const char* p) noexcept;
+uint32_t load_u32(const char* p) noexcept;
+} // namespace detail
+
+template <typename Handler>
+DecodeResult decode_packet(std::string_view packet, AssetDictionary& assets, Handler&& on_event) {
+    DecodeResult result;
+    auto header = read_header(packet);
+    if (!header || !detail::check_messages(packet, header->message_count)) return result;
+
+    size_t pos = kPacketHeaderBytes;
+    std::optional<mde::domain::OrderBookEventVariant> event;
+    for (uint16_t i = 0; i < header->message_count; ++i) {
+        auto length = detail::load_u16(packet.data() + pos);
+        auto type = static_cast<MessageType>(static_cast<uint8_t>(packet[pos + 2]));
+        auto asset = detail::load_u32(packet.data() + pos + 4);
+        auto body = packet.substr(pos + kMessageHeaderBytes, length - kMessageHeaderBytes);
+        pos += length;
+
+        event.reset();
+        if (!detail::decode_message(type, asset, body, assets, event)) {
+            // Lengths and types were checked; the rest of the packet is fine
+            ++result.skipped;
+            continue;
+        }
+        if (event) {
+            on_event(asset, std::move(*event));
+            ++result.events;
+        }
+    }
+    result.ok = true;
+    return result;
+}
+
+} // namespace mde::infrastructure::binary
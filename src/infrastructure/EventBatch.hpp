@@ -0,0 +1,132 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace mde::infrastructure {
+
+// The events parsed from one message, in storage that is recycled across
+// messages. clear() only forgets the events: the next message's book
+// snapshots and deltas are written into the previous ones, reusing their
+// level and change vectors, so a warm batch parses without heap traffic.
+// A snapshot or delta whose slot is taken by another event type is set
+// aside and reused for the next one, so the mix of types may vary between
+// messages without losing that storage.
+//
+// Events are only valid until the next clear(); consumers that keep one must
+// copy or move it out (a moved-from slot is refilled without the recycled
+// capacity). Owned by a single parsing thread.
+class EventBatch {
+public:
+    using iterator = std::vector<mde::domain::OrderBookEventVariant>::iterator;
+    using const_iterator = std::vector<mde::domain::OrderBookEventVariant>::const_iterator;
+
+    // Empty containers that keep their capacity from earlier messages
+    mde::domain::BookSnapshot& add_snapshot(const mde::domain::OrderBookEvent& header) {
+        auto& snapshot = recycle(mde::domain::BookSnapshot{header, {}, {}, {}});
+        snapshot.bids.clear();
+        snapshot.asks.clear();
+        snapshot.hash.clear();
+        return snapshot;
+    }
+
+    mde::domain::BookDelta& add_delta(const mde::domain::OrderBookEvent& header) {
+        auto& delta = recycle(mde::domain::BookDelta{header, {}});
+        delta.changes.clear();
+        return delta;
+    }
+
+    // Trades and tick size changes own nothing worth recycling
+    template <typename Event>
+    void add(Event&& event) {
+        if (size_ < slots_.size()) {
+            set_aside(slots_[size_]);
+            slots_[size_] = std::forward<Event>(event);
+        } else {
+            slots_.emplace_back(std::forward<Event>(event));
+        }
+        ++size_;
+    }
+
+    void clear() noexcept { size_ = 0; }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_t size() const noexcept { return size_; }
+
+    mde::domain::OrderBookEventVariant& operator[](size_t i) { return slots_[i]; }
+    const mde::domain::OrderBookEventVariant& operator[](size_t i) const { return slots_[i]; }
+
+    iterator begin() noexcept { return slots_.begin(); }
+    iterator end() noexcept { return slots_.begin() + static_cast<std::ptrdiff_t>(size_); }
+    const_iterator begin() const noexcept { return slots_.begin(); }
+    const_iterator end() const noexcept {
+        return slots_.begin() + static_cast<std::ptrdiff_t>(size_);
+    }
+
+    // Move the events out (giving up their storage) and clear the batch
+    std::vector<mde::domain::OrderBookEventVariant> take() {
+        slots_.erase(end(), slots_.end());
+        size_ = 0;
+        return std::exchange(slots_, {});
+    }
+
+private:
+    // A set-aside event of the same type, or else `blank`, is used for a new
+    // slot; only the header is copied into a slot that already holds an Event
+    template <typename Event>
+    Event& recycle(Event&& blank) {
+        if (size_ == slots_.size()) {
+            slots_.emplace_back(reuse(std::move(blank)));
+            return std::get<Event>(slots_[size_++]);
+        }
+        auto& slot = slots_[size_++];
+        if (auto* event = std::get_if<Event>(&slot)) {
+            static_cast<mde::domain::OrderBookEvent&>(*event) =
+                static_cast<const mde::domain::OrderBookEvent&>(blank);
+            return *event;
+        }
+        set_aside(slot);
+        return slot.emplace<Event>(reuse(std::move(blank)));
+    }
+
+    template <typename Event>
+    Event reuse(Event&& blank) {
+        auto& spares = spares_for<Event>();
+        if (spares.empty()) return std::move(blank);
+        Event event = std::move(spares.back());
+        spares.pop_back();
+        static_cast<mde::domain::OrderBookEvent&>(event) =
+            static_cast<const mde::domain::OrderBookEvent&>(blank);
+        return event;
+    }
+
+    // Called before a slot is overwritten with another event type
+    void set_aside(mde::domain::OrderBookEventVariant& slot) {
+        if (auto* snapshot = std::get_if<mde::domain::BookSnapshot>(&slot)) {
+            spare_snapshots_.push_back(std::move(*snapshot));
+        } else if (auto* delta = std::get_if<mde::domain::BookDelta>(&slot)) {
+            spare_deltas_.push_back(std::move(*delta));
+        }
+    }
+
+    template <typename Event>
+    std::vector<Event>& spares_for() {
+        if constexpr (std::is_same_v<Event, mde::domain::BookSnapshot>) {
+            return spare_snapshots_;
+        } else {
+            return spare_deltas_;
+        }
+    }
+
+    std::vector<mde::domain::OrderBookEventVariant> slots_;
+    size_t size_{0};
+    std::vector<mde::domain::BookSnapshot> spare_snapshots_;
+    std::vector<mde::domain::BookDelta> spare_deltas_;
+};
+
+} // namespace mde::infrastructure
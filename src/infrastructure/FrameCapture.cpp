@@ -0,0 +1,64 @@
+#include "infrastructure/FrameCapture.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace mde::infrastructure {
+
+namespace {
+
+constexpr char kMagic[8] = {'M', 'D', 'E', 'F', 'R', 'M', '0', '1'};
+
+template <typename T>
+void write_raw(std::ofstream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read_raw(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // anonymous namespace
+
+FrameWriter::FrameWriter(const std::string& path)
+    : out_(path, std::ios::binary | std::ios::trunc) {
+    if (!out_) throw std::runtime_error("Cannot create capture file: " + path);
+    out_.write(kMagic, sizeof(kMagic));
+}
+
+void FrameWriter::write(std::chrono::nanoseconds received, std::string_view frame) {
+    write_raw(out_, static_cast<uint64_t>(received.count()));
+    write_raw(out_, static_cast<uint32_t>(frame.size()));
+    out_.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    ++frames_;
+}
+
+void FrameWriter::flush() {
+    out_.flush();
+}
+
+FrameReader::FrameReader(const std::string& path) : in_(path, std::ios::binary) {
+    if (!in_) throw std::runtime_error("Cannot open capture file: " + path);
+    char magic[sizeof(kMagic)];
+    if (!in_.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a frame capture: " + path);
+    }
+}
+
+bool FrameReader::next(CapturedFrame& frame) {
+    uint64_t received = 0;
+    uint32_t length = 0;
+    if (!read_raw(in_, received) || !read_raw(in_, length)) return false;
+    frame.text.resize(length);
+    if (!in_.read(frame.text.data(), length)) return false;
+    frame.received = std::chrono::nanoseconds(static_cast<int64_t>(received));
+    return true;
+}
+
+void FrameReader::rewind() {
+    in_.clear();
+    in_.seekg(sizeof(kMagic));
+}
+
+} // namespace mde::infrastructure
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace mde::infrastructure {
+
+// Raw market-channel frames with their receive times, as recorded by
+// `ws_listener --record` and played back by ReplayFeed. A capture file is
+//
+//   8-byte magic "MDEFRM01" | record...
+//
+// and each record is
+//
+//   u64 receive time (ns since the Unix epoch) | u32 length | frame bytes
+//
+// Integers are in host byte order, as in the write-ahead log.
+struct CapturedFrame {
+    std::chrono::nanoseconds received{0};
+    std::string text;
+};
+
+class FrameWriter {
+public:
+    // Truncates the file. Throws std::runtime_error if it can't be created.
+    explicit FrameWriter(const std::string& path);
+
+    // Buffered; flush() or destruction writes it out
+    void write(std::chrono::nanoseconds received, std::string_view frame);
+    void flush();
+
+    uint64_t frames_written() const noexcept { return frames_; }
+
+private:
+    std::ofstream out_;
+    uint64_t frames_{0};
+};
+
+class FrameReader {
+public:
+    // Throws std::runtime_error if the file can't be opened or is not a capture
+    explicit FrameReader(const std::string& path);
+
+    // Reads the next frame into `frame`, reusing its string. False at the
+    // end of the file, including at a last record cut short because the
+    // recorder was killed mid-write.
+    bool next(CapturedFrame& frame);
+
+    // Back to the first frame
+    void rewind();
+
+private:
+    std::ifstream in_;
+};
+
+} // namespace mde::infrastructure
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+#include "infrastructure/EventBatch.hpp"
+
+#include <string_view>
+#include <vector>
+
+namespace mde::infrastructure {
+
+// Turns one raw market-channel WebSocket message into domain events.
+// Backends must produce identical events for the same message.
+class IMessageParser {
+public:
+    // Replaces the batch contents with the message's events, reusing their
+    // storage. Leaves the batch empty for malformed JSON, unrecognized
+    // message types and a missing or malformed field. Returns false, rather
+    // than throwing, for a malformed message or field, so callers can count
+    // what they drop. Polymarket wraps messages in a JSON array, so one message
+    // can produce multiple events (e.g. price_change with multiple assets).
+    virtual bool parse(std::string_view message, EventBatch& batch) = 0;
+
+    // Convenience for callers that keep the events; allocates per call
+    std::vector<mde::domain::OrderBookEventVariant> parse(std::string_view message) {
+        EventBatch batch;
+        parse(message, batch);
+        return batch.take();
+    }
+
+    virtual ~IMessageParser() = default;
+};
+
+} // namespace mde::infrastructure
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// Fixed-width integers in little-endian byte order, for the binary wire
+// formats (BinaryProtocol.hpp, QueryProtocol.hpp). A memcpy on little-endian
+// hosts, byte shifts elsewhere; no alignment needed.
+namespace mde::infrastructure::little_endian {
+
+template <typename T>
+void put(std::string& out, T value) {
+    using U = std::make_unsigned_t<T>;
+    auto bits = static_cast<U>(value);
+    char bytes[sizeof(T)];
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(bytes, &bits, sizeof(T));
+    } else {
+        for (size_t i = 0; i < sizeof(T); ++i) bytes[i] = static_cast<char>(bits >> (8 * i));
+    }
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T load(const char* p) noexcept {
+    using U = std::make_unsigned_t<T>;
+    U bits = 0;
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(&bits, p, sizeof(T));
+    } else {
+        for (size_t i = 0; i < sizeof(T); ++i) bits |= static_cast<U>(static_cast<unsigned char>(p[i])) << (8 * i);
+    }
+    return static_cast<T>(bits);
+}
+
+// Overwrite a value put() earlier at `pos`
+template <typename T>
+void patch(std::string& out, size_t pos, T value) {
+    std::string bytes;
+    put(bytes, value);
+    out.replace(pos, sizeof(T), bytes);
+}
+
+} // namespace mde::infrastructure::little_endian
@@ -5,8 +5,236 @@
 #include <ixwebsocket/IXHttpClient.h>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <span>
+#include <thread>
+
 namespace mde::infrastructure {
 
+namespace {
+
+using json = nlohmann::json;
+
+constexpr std::string_view kDeltaPrefix = "delta-";
+constexpr std::string_view kDeltaSuffix = ".json";
+
+// Reads the markets of a Gamma /markets response without building a
+// document: only each market's clobTokenIds and status flags are looked at.
+// clobTokenIds is usually a string holding an encoded array
+// ("[\"id1\",\"id2\"]"), whose first id is cut out of the string rather
+// than parsed a second time; a real array is accepted too.
+struct MarketReader {
+    using string_t = json::string_t;
+
+    struct Market {
+        std::string token_id;
+        bool retired{false};  // closed, archived or no longer active
+    };
+
+    enum class Key : uint8_t { other, ids, closed, active, archived };
+
+    std::vector<Market> markets;
+    size_t depth{0};         // open objects and arrays
+    Key next{Key::other};    // the key whose value comes next
+    bool in_ids{false};      // inside a clobTokenIds array
+    Market market;           // the one being read
+
+    bool start_object(size_t) {
+        if (depth == 0) return false;  // not a listing
+        if (depth == 1) market = {};
+        ++depth;
+        next = Key::other;
+        return true;
+    }
+
+    bool end_object() {
+        --depth;
+        if (depth == 1 && !market.token_id.empty()) markets.push_back(std::move(market));
+        return true;
+    }
+
+    bool start_array(size_t) {
+        if (depth == 2 && next == Key::ids) in_ids = true;
+        ++depth;
+        next = Key::other;
+        return true;
+    }
+
+    bool end_array() {
+        --depth;
+        if (depth == 2) in_ids = false;
+        return true;
+    }
+
+    bool key(string_t& name) {
+        next = Key::other;
+        if (depth != 2) return true;
+        if (name == "clobTokenIds") {
+            next = Key::ids;
+        } else if (name == "closed") {
+            next = Key::closed;
+        } else if (name == "active") {
+            next = Key::active;
+        } else if (name == "archived") {
+            next = Key::archived;
+        }
+        return true;
+    }
+
+    bool string(string_t& value) {
+        if (depth == 2 && next == Key::ids) {
+            take(first_quoted(value));
+        } else if (depth == 3 && in_ids) {
+            take(value);
+        }
+        next = Key::other;
+        return true;
+    }
+
+    bool boolean(bool value) {
+        if (depth == 2) {
+            if ((next == Key::closed || next == Key::archived) && value) market.retired = true;
+            if (next == Key::active && !value) market.retired = true;
+        }
+        return scalar();
+    }
+
+    bool null() { return scalar(); }
+    bool number_integer(json::number_integer_t) { return scalar(); }
+    bool number_unsigned(json::number_unsigned_t) { return scalar(); }
+    bool number_float(json::number_float_t, const string_t&) { return scalar(); }
+    bool binary(json::binary_t&) { return scalar(); }
+
+    bool parse_error(size_t, const std::string&, const nlohmann::detail::exception&) {
+        return false;
+    }
+
+private:
+    bool scalar() {
+        next = Key::other;
+        return true;
+    }
+
+    void take(std::string_view id) {
+        if (market.token_id.empty()) market.token_id = id;
+    }
+
+    // Token ids are decimal strings, so they never hold an escaped quote
+    static std::string_view first_quoted(std::string_view encoded) {
+        auto open = encoded.find('"');
+        if (open == std::string_view::npos) return {};
+        auto close = encoded.find('"', open + 1);
+        if (close == std::string_view::npos) return {};
+        return encoded.substr(open + 1, close - open - 1);
+    }
+};
+
+std::optional<std::vector<MarketReader::Market>> read_markets(std::string_view body) {
+    MarketReader reader;
+    try {
+        if (!json::sax_parse(body.begin(), body.end(), &reader)) return std::nullopt;
+    } catch (...) {
+        return std::nullopt;
+    }
+    return std::move(reader.markets);
+}
+
+// Runs task(page) for pages 0..pages-1 on up to `concurrency` threads, the
+// caller's included, and rethrows the first exception once all are done
+template <typename Task>
+void for_each_page(int pages, int concurrency, Task task) {
+    std::atomic<int> next{0};
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+    auto work = [&] {
+        try {
+            for (int page = next.fetch_add(1); page < pages; page = next.fetch_add(1)) task(page);
+        } catch (...) {
+            std::lock_guard lock(failure_mutex);
+            if (!failure) failure = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    int threads = std::clamp(concurrency, 1, std::max(pages, 1));
+    for (int i = 1; i < threads; ++i) workers.emplace_back(work);
+    work();
+    for (auto& worker : workers) worker.join();
+    if (failure) std::rethrow_exception(failure);
+}
+
+std::optional<std::string> read_file(arrow::fs::FileSystem& fs, const std::string& path) {
+    auto result = fs.OpenInputFile(path);
+    if (!result.ok()) return std::nullopt;  // file doesn't exist yet
+
+    auto file = *result;
+    auto size_result = file->GetSize();
+    if (!size_result.ok()) return std::nullopt;
+
+    auto buf_result = file->Read(*size_result);
+    if (!buf_result.ok()) return std::nullopt;
+
+    return std::string(reinterpret_cast<const char*>((*buf_result)->data()),
+                       static_cast<size_t>((*buf_result)->size()));
+}
+
+std::optional<std::string> http_get(const std::string& url) {
+    ix::HttpClient client;
+    auto args = client.createRequest();
+    args->connectTimeout = 10;
+    args->transferTimeout = 30;
+
+    auto response = client.get(url, args);
+    if (response->statusCode != 200) return std::nullopt;
+    return std::move(response->body);
+}
+
+// Written under a temporary name and moved into place, so a failed write
+// never leaves a truncated file at `path`
+arrow::Status write_file(arrow::fs::FileSystem& fs, const std::string& path, const std::string& content) {
+    auto tmp = path + ".tmp";
+    auto status = [&]() -> arrow::Status {
+        ARROW_ASSIGN_OR_RAISE(auto stream, fs.OpenOutputStream(tmp));
+        ARROW_RETURN_NOT_OK(stream->Write(content.data(), static_cast<int64_t>(content.size())));
+        ARROW_RETURN_NOT_OK(stream->Close());
+        return fs.Move(tmp, path);
+    }();
+    if (!status.ok()) (void)fs.DeleteFile(tmp);
+    return status;
+}
+
+template <typename Ids>
+std::string tracked_json(const Ids& ids, const std::vector<std::string>& removed = {}) {
+    json content;
+    content["tracked_token_ids"] = json::array();
+    for (const auto& id : ids) {
+        content["tracked_token_ids"].push_back(id);
+    }
+    if (!removed.empty()) content["removed_token_ids"] = removed;
+    return content.dump();
+}
+
+// The number in "delta-<n>.json", or -1
+int delta_number(std::string_view name) {
+    if (name.size() <= kDeltaPrefix.size() + kDeltaSuffix.size() ||
+        name.substr(0, kDeltaPrefix.size()) != kDeltaPrefix ||
+        name.substr(name.size() - kDeltaSuffix.size()) != kDeltaSuffix) {
+        return -1;
+    }
+    auto digits = name.substr(kDeltaPrefix.size(), name.size() - kDeltaPrefix.size() - kDeltaSuffix.size());
+    int number = -1;
+    auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), number);
+    if (error != std::errc() || end != digits.data() + digits.size()) return -1;
+    return number;
+}
+
+} // namespace
+
 MarketDiscovery::MarketDiscovery(std::shared_ptr<arrow::fs::FileSystem> fs,
                                  const config::ApiSettings& api,
                                  const config::DiscoverySettings& discovery)
@@ -15,20 +243,31 @@ MarketDiscovery::MarketDiscovery(std::shared_ptr<arrow::fs::FileSystem> fs,
 void MarketDiscovery::load() {
     if (!fs_) return;
 
-    auto result = fs_->OpenInputFile(kTrackedFile);
-    if (!result.ok()) return;  // file doesn't exist yet
-
-    auto file = *result;
-    auto size_result = file->GetSize();
-    if (!size_result.ok()) return;
-
-    auto buf_result = file->Read(*size_result);
-    if (!buf_result.ok()) return;
+    load_file(kTrackedFile);
+
+    arrow::fs::FileSelector selector;
+    selector.base_dir = kDeltaDirectory;
+    selector.allow_not_found = true;
+    auto listing = fs_->GetFileInfo(selector);
+    if (!listing.ok()) return;
+    // In order, so a removal lands after the addition it undoes
+    std::vector<std::pair<int, std::string>> deltas;
+    for (const auto& info : *listing) {
+        auto number = delta_number(info.base_name());
+        if (info.type() == arrow::fs::FileType::File && number >= 0) deltas.emplace_back(number, info.path());
+    }
+    std::sort(deltas.begin(), deltas.end());
+    for (const auto& [number, path] : deltas) {
+        load_file(path);
+        next_delta_ = std::max(next_delta_, number + 1);
+    }
+}
 
-    std::string content(reinterpret_cast<const char*>((*buf_result)->data()),
-                        static_cast<size_t>((*buf_result)->size()));
+void MarketDiscovery::load_file(const std::string& path) {
+    auto content = read_file(*fs_, path);
+    if (!content) return;
 
-    auto json = nlohmann::json::parse(content, nullptr, false);
+    auto json = nlohmann::json::parse(*content, nullptr, false);
     if (json.is_discarded() || !json.contains("tracked_token_ids")) return;
 
     std::lock_guard lock(mutex_);
@@ -37,6 +276,11 @@ void MarketDiscovery::load() {
             tracked_ids_.insert(id.get<std::string>());
         }
     }
+    if (json.contains("removed_token_ids")) {
+        for (const auto& id : json["removed_token_ids"]) {
+            if (id.is_string()) tracked_ids_.erase(id.get<std::string>());
+        }
+    }
 }
 
 std::vector<std::string> MarketDiscovery::tracked_token_ids() const {
@@ -54,18 +298,30 @@ bool MarketDiscovery::at_capacity() const {
     return static_cast<int>(tracked_ids_.size()) >= discovery_.max_tracked_markets;
 }
 
-size_t MarketDiscovery::poll(std::function<void(const std::vector<std::string>&)> on_new) {
-    if (at_capacity()) return 0;
-
-    auto top_ids = fetch_top_token_ids(discovery_.markets_per_poll);
+size_t MarketDiscovery::poll(std::function<void(const std::vector<std::string>&)> on_new,
+                             std::function<void(const std::vector<std::string>&)> on_retired) {
+    // Closed markets go first, so their slots are free for this poll
+    std::vector<std::string> retired_ids;
+    auto tracked = tracked_token_ids();
+    if (!tracked.empty()) {
+        auto retired = fetch_retired_token_ids(tracked);
+        std::lock_guard lock(mutex_);
+        for (auto& id : retired) {
+            if (tracked_ids_.erase(id)) retired_ids.push_back(std::move(id));
+        }
+    }
 
     std::vector<std::string> new_ids;
-    {
+    if (!at_capacity()) {
+        auto top_ids = fetch_top_token_ids(discovery_.markets_per_poll);
+
         std::lock_guard lock(mutex_);
         int remaining = discovery_.max_tracked_markets - static_cast<int>(tracked_ids_.size());
 
         for (const auto& id : top_ids) {
             if (remaining <= 0) break;
+            // The listing can lag the close by a poll
+            if (std::find(retired_ids.begin(), retired_ids.end(), id) != retired_ids.end()) continue;
             if (tracked_ids_.insert(id).second) {
                 new_ids.push_back(id);
                 --remaining;
@@ -73,68 +329,120 @@ size_t MarketDiscovery::poll(std::function<void(const std::vector<std::string>&)
         }
     }
 
-    if (!new_ids.empty()) {
-        persist();
-        if (on_new) {
-            on_new(new_ids);
-        }
+    if (!new_ids.empty() || !retired_ids.empty()) persist(new_ids, retired_ids);
+    if (!retired_ids.empty() && on_retired) {
+        on_retired(retired_ids);
+    }
+    if (!new_ids.empty() && on_new) {
+        on_new(new_ids);
     }
 
     return new_ids.size();
 }
 
-std::vector<std::string> MarketDiscovery::fetch_top_token_ids(int limit) const {
-    ix::HttpClient client;
-    auto args = client.createRequest();
-    args->connectTimeout = 10;
-    args->transferTimeout = 30;
-
-    std::string url = api_.gamma_api_base_url +
-        "/markets?active=true&closed=false&limit=" + std::to_string(limit) +
-        "&order=volume24hr&ascending=false";
+std::vector<std::string> MarketDiscovery::parse_token_ids(std::string_view body) {
+    std::vector<std::string> ids;
+    if (auto markets = read_markets(body)) {
+        for (auto& market : *markets) ids.push_back(std::move(market.token_id));
+    }
+    return ids;
+}
 
-    auto response = client.get(url, args);
-    if (response->statusCode != 200) return {};
+std::vector<std::string> MarketDiscovery::parse_retired_token_ids(std::string_view body) {
+    std::vector<std::string> ids;
+    if (auto markets = read_markets(body)) {
+        for (auto& market : *markets) {
+            if (market.retired) ids.push_back(std::move(market.token_id));
+        }
+    }
+    return ids;
+}
 
-    auto json = nlohmann::json::parse(response->body, nullptr, false);
-    if (!json.is_array()) return {};
+std::vector<std::string> MarketDiscovery::fetch_top_token_ids(int limit) const {
+    if (limit <= 0) return {};
+    int page_size = std::max(discovery_.page_size, 1);
+    int pages = (limit + page_size - 1) / page_size;
+
+    // A page that fails leaves a gap; the next poll fills it
+    std::vector<std::vector<std::string>> results(static_cast<size_t>(pages));
+    for_each_page(pages, discovery_.fetch_concurrency, [&](int page) {
+        int offset = page * page_size;
+        if (auto body = fetch_page(offset, std::min(page_size, limit - offset))) {
+            results[static_cast<size_t>(page)] = parse_token_ids(*body);
+        }
+    });
 
     std::vector<std::string> ids;
-    for (const auto& market : json) {
-        if (!market.contains("clobTokenIds")) continue;
-
-        // clobTokenIds is a string-encoded JSON array like "[\"id1\",\"id2\"]"
-        std::string clob_str = market["clobTokenIds"].get<std::string>();
-        auto clob = nlohmann::json::parse(clob_str, nullptr, false);
-        if (clob.is_array() && !clob.empty()) {
-            // Take [0] — YES side
-            ids.push_back(clob[0].get<std::string>());
-        }
+    for (auto& page : results) {
+        ids.insert(ids.end(), std::make_move_iterator(page.begin()), std::make_move_iterator(page.end()));
     }
+    return ids;
+}
+
+std::vector<std::string> MarketDiscovery::fetch_retired_token_ids(const std::vector<std::string>& token_ids) const {
+    size_t page_size = static_cast<size_t>(std::max(discovery_.page_size, 1));
+    int pages = static_cast<int>((token_ids.size() + page_size - 1) / page_size);
+
+    // A market whose page fails stays tracked until a later poll
+    std::vector<std::vector<std::string>> results(static_cast<size_t>(pages));
+    for_each_page(pages, discovery_.fetch_concurrency, [&](int page) {
+        auto first = static_cast<size_t>(page) * page_size;
+        auto ids = std::span(token_ids).subspan(first, std::min(page_size, token_ids.size() - first));
+        if (auto body = fetch_markets(ids)) {
+            results[static_cast<size_t>(page)] = parse_retired_token_ids(*body);
+        }
+    });
 
+    std::vector<std::string> ids;
+    for (auto& page : results) {
+        ids.insert(ids.end(), std::make_move_iterator(page.begin()), std::make_move_iterator(page.end()));
+    }
     return ids;
 }
 
-void MarketDiscovery::persist() const {
+std::optional<std::string> MarketDiscovery::fetch_page(int offset, int limit) const {
+    return http_get(api_.gamma_api_base_url +
+                    "/markets?active=true&closed=false&limit=" + std::to_string(limit) +
+                    "&offset=" + std::to_string(offset) +
+                    "&order=volume24hr&ascending=false");
+}
+
+std::optional<std::string> MarketDiscovery::fetch_markets(std::span<const std::string> token_ids) const {
+    std::string url = api_.gamma_api_base_url + "/markets?limit=" + std::to_string(token_ids.size());
+    for (const auto& id : token_ids) url += "&clob_token_ids=" + id;
+    return http_get(url);
+}
+
+void MarketDiscovery::persist(const std::vector<std::string>& new_ids, const std::vector<std::string>& removed_ids) {
     if (!fs_) return;
 
-    nlohmann::json json;
-    {
-        std::lock_guard lock(mutex_);
-        json["tracked_token_ids"] = nlohmann::json::array();
-        for (const auto& id : tracked_ids_) {
-            json["tracked_token_ids"].push_back(id);
-        }
+    (void)fs_->CreateDir(kDeltaDirectory, true);
+    auto path = std::string(kDeltaDirectory) + "/" + std::string(kDeltaPrefix) + std::to_string(next_delta_++) +
+                std::string(kDeltaSuffix);
+    auto status = write_file(*fs_, path, tracked_json(new_ids, removed_ids));
+    if (!status.ok()) {
+        std::cerr << "[discovery] Failed to write " << path << ": " << status.ToString() << std::endl;
     }
 
-    std::string content = json.dump(2);
-
-    auto result = fs_->OpenOutputStream(kTrackedFile);
-    if (!result.ok()) return;
+    if (next_delta_ >= kCompactAfterDeltas) compact();
+}
 
-    auto stream = *result;
-    (void)stream->Write(content.data(), static_cast<int64_t>(content.size()));
-    (void)stream->Close();
+void MarketDiscovery::compact() {
+    std::string content;
+    {
+        std::lock_guard lock(mutex_);
+        content = tracked_json(tracked_ids_);
+    }
+    // The base first: a crash before the deltas go only leaves ids that
+    // are stored twice. If it fails the deltas stay, and the next persist
+    // tries again.
+    auto status = write_file(*fs_, kTrackedFile, content);
+    if (!status.ok()) {
+        std::cerr << "[discovery] Failed to write " << kTrackedFile << ": " << status.ToString() << std::endl;
+        return;
+    }
+    (void)fs_->DeleteDirContents(kDeltaDirectory, true);
+    next_delta_ = 0;
 }
 
 } // namespace mde::infrastructure
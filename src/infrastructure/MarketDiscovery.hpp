@@ -7,12 +7,24 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <set>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace mde::infrastructure {
 
+// Tracks the most traded markets, up to max_tracked_markets.
+//
+// Each poll first asks the Gamma API about the tracked markets and drops
+// those that have closed, then requests the top markets_per_poll by 24h
+// volume to fill the free slots. Both go as pages of page_size,
+// fetch_concurrency requests at a time, and the responses are read as a
+// stream. Tracked ids are stored as a base file
+// plus one small delta file per poll that added markets; every
+// kCompactAfterDeltas deltas are folded back into the base.
 class MarketDiscovery {
 public:
     MarketDiscovery(std::shared_ptr<arrow::fs::FileSystem> fs,
@@ -25,23 +37,44 @@ public:
     size_t tracked_count() const;
     bool at_capacity() const;
 
-    // Poll Gamma API, add new markets, persist, fire callback with new IDs.
+    // Poll Gamma API, drop closed markets, add new ones, persist, then fire
+    // on_retired with the dropped IDs and on_new with the added ones.
     // Returns number of newly added markets.
-    size_t poll(std::function<void(const std::vector<std::string>&)> on_new);
+    size_t poll(std::function<void(const std::vector<std::string>&)> on_new,
+                std::function<void(const std::vector<std::string>&)> on_retired = nullptr);
+
+    // The first (YES) token id of each market in a Gamma /markets response,
+    // in order. Empty unless the body is a JSON array.
+    static std::vector<std::string> parse_token_ids(std::string_view body);
+    // Those of markets marked closed, archived or not active
+    static std::vector<std::string> parse_retired_token_ids(std::string_view body);
 
 protected:
+    // Pages of page_size through fetch_page, concatenated in rank order
     virtual std::vector<std::string> fetch_top_token_ids(int limit) const;
+    // One page of the listing; nullopt if the request failed
+    virtual std::optional<std::string> fetch_page(int offset, int limit) const;
+    // The tracked ids whose markets have closed, through fetch_markets
+    virtual std::vector<std::string> fetch_retired_token_ids(const std::vector<std::string>& token_ids) const;
+    // The markets of these tokens, any status; nullopt if the request failed
+    virtual std::optional<std::string> fetch_markets(std::span<const std::string> token_ids) const;
 
 private:
-    void persist() const;
+    // Adds the ids of a tracked-markets file, if it exists and parses
+    void load_file(const std::string& path);
+    void persist(const std::vector<std::string>& new_ids, const std::vector<std::string>& removed_ids);
+    void compact();
 
     std::shared_ptr<arrow::fs::FileSystem> fs_;
     config::ApiSettings api_;
     config::DiscoverySettings discovery_;
     std::set<std::string> tracked_ids_;
     mutable std::mutex mutex_;
+    int next_delta_{0};  // poll thread only
 
     static constexpr const char* kTrackedFile = "tracked_markets.json";
+    static constexpr const char* kDeltaDirectory = "tracked_markets.d";
+    static constexpr int kCompactAfterDeltas = 64;
 };
 
 } // namespace mde::infrastructure
@@ -0,0 +1,27 @@
+#include "infrastructure/MessageParserFactory.hpp"
+#include "infrastructure/PolymarketMessageParser.hpp"
+
+#ifdef MDE_HAS_SIMDJSON
+#include "infrastructure/SimdjsonMessageParser.hpp"
+#endif
+
+#include <stdexcept>
+
+namespace mde::infrastructure {
+
+std::unique_ptr<IMessageParser> make_message_parser(const std::string& backend) {
+    if (backend == "nlohmann") {
+        return std::make_unique<PolymarketMessageParser>();
+    }
+    if (backend == "simdjson") {
+#ifdef MDE_HAS_SIMDJSON
+        return std::make_unique<SimdjsonMessageParser>();
+#else
+        throw std::invalid_argument(
+            "simdjson parser requested but not compiled in. Rebuild with -DMDE_WITH_SIMDJSON=ON.");
+#endif
+    }
+    throw std::invalid_argument("Unknown parser backend: " + backend);
+}
+
+} // namespace mde::infrastructure
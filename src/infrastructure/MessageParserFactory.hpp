@@ -0,0 +1,15 @@
+#pragma once
+
+#include "infrastructure/IMessageParser.hpp"
+
+#include <memory>
+#include <string>
+
+namespace mde::infrastructure {
+
+// Build a parser for a backend name: "nlohmann" or "simdjson".
+// Throws std::invalid_argument for unknown backends and for "simdjson"
+// when the binary was built without MDE_WITH_SIMDJSON.
+std::unique_ptr<IMessageParser> make_message_parser(const std::string& backend);
+
+} // namespace mde::infrastructure
@@ -0,0 +1,48 @@
+#include "infrastructure/MetricsServer.hpp"
+
+#include <ixwebsocket/IXHttpServer.h>
+
+#include <stdexcept>
+
+namespace mde::infrastructure {
+
+MetricsServer::MetricsServer(int port, const std::string& host,
+                             const mde::telemetry::MetricsRegistry& metrics,
+                             const mde::telemetry::LatencyRegistry& latencies)
+    : server_(std::make_unique<ix::HttpServer>(port, host)) {
+    server_->setOnConnectionCallback(
+        [&metrics, &latencies](ix::HttpRequestPtr request,
+                               std::shared_ptr<ix::ConnectionState>) -> ix::HttpResponsePtr {
+            ix::WebSocketHttpHeaders headers;
+            headers["Content-Type"] = "text/plain; version=0.0.4; charset=utf-8";
+            if (request->method != "GET" || request->uri != "/metrics") {
+                return std::make_shared<ix::HttpResponse>(404, "Not Found", ix::HttpErrorCode::Ok,
+                                                          headers, "Not found; try /metrics\n");
+            }
+            auto body = metrics.render();
+            mde::telemetry::render_latencies(latencies, body);
+            return std::make_shared<ix::HttpResponse>(200, "OK", ix::HttpErrorCode::Ok, headers, body);
+        });
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::start() {
+    if (started_) return;
+    auto [ok, error] = server_->listen();
+    if (!ok) {
+        throw std::runtime_error("Metrics endpoint failed to listen: " + error);
+    }
+    server_->start();
+    started_ = true;
+}
+
+void MetricsServer::stop() {
+    if (!started_) return;
+    server_->stop();
+    started_ = false;
+}
+
+} // namespace mde::infrastructure
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "telemetry/Latency.hpp"
+#include "telemetry/Metrics.hpp"
+
+#include <memory>
+#include <string>
+
+namespace ix {
+class HttpServer;
+}
+
+namespace mde::infrastructure {
+
+// Plain-HTTP scrape endpoint: GET /metrics returns the metrics registry and
+// the stage latency summaries in the Prometheus text format; anything else
+// is a 404. Requests are served on the HTTP server's own threads, so a
+// scrape never runs on the ingestion path.
+class MetricsServer {
+public:
+    MetricsServer(int port, const std::string& host,
+                  const mde::telemetry::MetricsRegistry& metrics = mde::telemetry::MetricsRegistry::global(),
+                  const mde::telemetry::LatencyRegistry& latencies = mde::telemetry::LatencyRegistry::global());
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Throws std::runtime_error if the port can't be bound
+    void start();
+    void stop();
+
+private:
+    std::unique_ptr<ix::HttpServer> server_;
+    bool started_{false};
+};
+
+} // namespace mde::infrastructure
@@ -1,66 +1,280 @@
 #include "infrastructure/PolymarketClient.hpp"
+#include "infrastructure/MessageParserFactory.hpp"
+#include "telemetry/CpuAffinity.hpp"
+#include "telemetry/Latency.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <span>
+#include <stdexcept>
 
 namespace mde::infrastructure {
 
-PolymarketClient::PolymarketClient(const mde::config::WebSocketSettings& settings) {
-    ws_.setUrl(settings.url);
-    ws_.setPingInterval(settings.ping_interval_seconds);
+namespace {
+
+// Polymarket's per-connection subscription limit
+constexpr size_t kMaxTokensPerConnection = 500;
+
+// A token is resubscribed at most this often, so a book that keeps
+// disagreeing does not turn into a subscription storm
+constexpr auto kResyncInterval = std::chrono::seconds(5);
+
+std::string assets_array(std::span<const std::string> token_ids) {
+    std::string assets = "[";
+    for (size_t i = 0; i < token_ids.size(); ++i) {
+        if (i > 0) assets += ",";
+        assets += "\"" + token_ids[i] + "\"";
+    }
+    assets += "]";
+    return assets;
+}
+
+// The first message on a connection names the channel; later ones add
+// assets to it
+std::string subscribe_message(std::span<const std::string> token_ids, bool initial) {
+    auto assets = assets_array(token_ids);
+    return initial ? R"({"assets_ids": )" + assets + R"(, "type": "market"})"
+                   : R"({"assets_ids": )" + assets + R"(, "operation": "subscribe"})";
+}
+
+std::string unsubscribe_message(std::span<const std::string> token_ids) {
+    return R"({"assets_ids": )" + assets_array(token_ids) + R"(, "operation": "unsubscribe"})";
+}
+
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // anonymous namespace
 
-    ws_.setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
-        on_message(msg);
-    });
+PolymarketClient::Connection::Connection(size_t index, std::unique_ptr<IMessageParser> parser,
+                                         size_t queue_capacity)
+    : index(index), parser(std::move(parser)) {
+    if (queue_capacity > 0) {
+        parse_queue = std::make_unique<mde::services::SpscQueue<QueuedMessage>>(queue_capacity);
+        spare_buffers = std::make_unique<mde::services::SpscQueue<std::string>>(queue_capacity);
+    }
+}
+
+PolymarketClient::PolymarketClient(const mde::config::WebSocketSettings& settings,
+                                   std::unique_ptr<IMessageParser> parser)
+    : messages_(mde::telemetry::MetricsRegistry::global().counter(
+          "mde_websocket_messages_total", "Market-channel messages received"))
+    , parse_failures_(mde::telemetry::MetricsRegistry::global().counter(
+          "mde_parse_failures_total", "Messages dropped as malformed or with a bad field"))
+    , reconnects_(mde::telemetry::MetricsRegistry::global().counter(
+          "mde_websocket_reconnects_total", "Connections opened after the first"))
+    , connected_gauge_(mde::telemetry::MetricsRegistry::global().gauge(
+          "mde_websocket_connected", "Websockets currently open"))
+    , resyncs_(mde::telemetry::MetricsRegistry::global().counter(
+          "mde_websocket_resyncs_total", "Assets resubscribed to fetch a fresh book"))
+    , downtime_ms_(mde::telemetry::MetricsRegistry::global().counter(
+          "mde_websocket_downtime_ms_total", "Milliseconds connections spent down before reopening"))
+    , last_recovery_gauge_(mde::telemetry::MetricsRegistry::global().gauge(
+          "mde_websocket_last_recovery_ms", "How long the last connection outage lasted"))
+    , cpus_(settings.cpus) {
+    if (settings.connections < 1) {
+        throw std::invalid_argument("WebSocket connections must be >= 1");
+    }
+    if (settings.reconnect_min_wait_ms < 0 || settings.reconnect_max_wait_ms < settings.reconnect_min_wait_ms) {
+        throw std::invalid_argument("WebSocket reconnect waits must satisfy 0 <= min <= max");
+    }
+    auto capacity = static_cast<size_t>(std::max(settings.parse_queue_capacity, 0));
+    for (int i = 0; i < settings.connections; ++i) {
+        auto connection_parser = (i == 0 && parser) ? std::move(parser)
+                                                    : make_message_parser(settings.parser_backend);
+        connections_.push_back(
+            std::make_unique<Connection>(static_cast<size_t>(i), std::move(connection_parser), capacity));
+        auto& connection = *connections_.back();
+        connection.ws.setUrl(settings.url);
+        connection.ws.setPingInterval(settings.ping_interval_seconds);
+        // IXWebSocket doubles the wait after each failed attempt, within these bounds
+        connection.ws.enableAutomaticReconnection();
+        connection.ws.setMinWaitBetweenReconnectionRetries(static_cast<uint32_t>(settings.reconnect_min_wait_ms));
+        connection.ws.setMaxWaitBetweenReconnectionRetries(static_cast<uint32_t>(settings.reconnect_max_wait_ms));
+        connection.ws.setOnMessageCallback([this, &connection](const ix::WebSocketMessagePtr& msg) {
+            on_message(connection, msg);
+        });
+    }
 }
 
 PolymarketClient::~PolymarketClient() {
-    ws_.stop();
+    stop();
 }
 
 void PolymarketClient::set_on_event(EventCallback callback) {
     std::lock_guard lock(callback_mutex_);
     on_event_ = std::move(callback);
+    on_events_ = nullptr;
+}
+
+void PolymarketClient::set_on_events(BatchCallback callback) {
+    std::lock_guard lock(callback_mutex_);
+    on_events_ = std::move(callback);
+    on_event_ = nullptr;
 }
 
 void PolymarketClient::subscribe(const std::string& token_id) {
-    std::lock_guard lock(sub_mutex_);
-    token_ids_.push_back(token_id);
-    if (connected_) {
-        send_subscribe();
+    subscribe_all(std::span(&token_id, 1));
+}
+
+void PolymarketClient::subscribe_all(std::span<const std::string> token_ids) {
+    std::lock_guard assign_lock(assign_mutex_);
+    std::vector<std::vector<std::string>> added(connections_.size());
+    for (const auto& token_id : token_ids) {
+        if (assigned_.count(token_id)) continue;
+
+        auto& connection = **std::min_element(connections_.begin(), connections_.end(),
+                                              [](const auto& a, const auto& b) {
+                                                  return a->token_count.load() < b->token_count.load();
+                                              });
+        assigned_.emplace(token_id, connection.index);
+        added[connection.index].push_back(token_id);
+
+        std::lock_guard lock(connection.tokens_mutex);
+        connection.token_ids.push_back(token_id);
+        connection.token_count.store(connection.token_ids.size());
+        if (connection.token_ids.size() == kMaxTokensPerConnection + 1) {
+            std::cerr << "[client] Connection " << connection.index << " is past Polymarket's "
+                      << kMaxTokensPerConnection << "-asset limit; raise MDE_WS_CONNECTIONS" << std::endl;
+        }
+    }
+
+    for (auto& connection : connections_) {
+        const auto& tokens = added[connection->index];
+        if (tokens.empty()) continue;
+        std::lock_guard lock(connection->tokens_mutex);
+        if (connection->connected) {
+            // Only the new tokens; an Open racing this resends the full
+            // list, and subscribing twice is harmless
+            connection->ws.send(subscribe_message(tokens, false));
+        }
     }
 }
 
+void PolymarketClient::unsubscribe_all(std::span<const std::string> token_ids) {
+    std::lock_guard assign_lock(assign_mutex_);
+    std::vector<std::vector<std::string>> removed(connections_.size());
+    for (const auto& token_id : token_ids) {
+        auto it = assigned_.find(token_id);
+        if (it == assigned_.end()) continue;
+        removed[it->second].push_back(token_id);
+        assigned_.erase(it);
+        last_resync_.erase(token_id);
+    }
+
+    for (auto& connection : connections_) {
+        const auto& tokens = removed[connection->index];
+        if (tokens.empty()) continue;
+        std::lock_guard lock(connection->tokens_mutex);
+        std::erase_if(connection->token_ids, [&](const std::string& id) {
+            return std::find(tokens.begin(), tokens.end(), id) != tokens.end();
+        });
+        connection->token_count.store(connection->token_ids.size());
+        if (connection->connected) connection->ws.send(unsubscribe_message(tokens));
+    }
+}
+
+bool PolymarketClient::resync(const std::string& token_id) {
+    Connection* connection = nullptr;
+    {
+        std::lock_guard assign_lock(assign_mutex_);
+        auto it = assigned_.find(token_id);
+        if (it == assigned_.end()) return false;
+        connection = connections_[it->second].get();
+
+        auto now = std::chrono::steady_clock::now();
+        auto [last, inserted] = last_resync_.try_emplace(token_id, now);
+        if (!inserted) {
+            if (now - last->second < kResyncInterval) return false;
+            last->second = now;
+        }
+    }
+
+    std::lock_guard lock(connection->tokens_mutex);
+    if (!connection->connected) return false;  // the next Open subscribes afresh anyway
+    // The server answers a fresh subscription with a book message, which
+    // arrives on this socket in order with the token's price changes
+    auto tokens = std::span(&token_id, 1);
+    connection->ws.send(unsubscribe_message(tokens));
+    connection->ws.send(subscribe_message(tokens, false));
+    resyncs_.inc();
+    return true;
+}
+
 void PolymarketClient::start() {
-    ws_.start();
+    for (auto& connection : connections_) {
+        if (connection->parse_queue && !connection->parser_thread.joinable()) {
+            connection->parsing = true;
+            connection->parser_thread = std::thread([this, &c = *connection] { run_parser(c); });
+        }
+        connection->ws.start();
+    }
 }
 
 void PolymarketClient::stop() {
-    ws_.stop();
+    // Stop the producers first so the parsers can drain what is queued
+    for (auto& connection : connections_) connection->ws.stop();
+    for (auto& connection : connections_) stop_parser(*connection);
 }
 
-void PolymarketClient::on_message(const ix::WebSocketMessagePtr& msg) {
+std::vector<ConnectionHealth> PolymarketClient::connection_health() const {
+    std::vector<ConnectionHealth> health;
+    health.reserve(connections_.size());
+    auto now = steady_now_ns();
+    for (const auto& connection : connections_) {
+        ConnectionHealth h;
+        h.index = connection->index;
+        h.tokens = connection->token_count.load();
+        h.connected = connection->connected.load();
+        h.messages = connection->messages.load(std::memory_order_relaxed);
+        h.reconnects = connection->reconnects.load(std::memory_order_relaxed);
+        auto last = connection->last_message_ns.load(std::memory_order_relaxed);
+        if (last >= 0) {
+            h.idle = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(now - last));
+        }
+        auto down_since = connection->down_since_ns.load();
+        if (down_since >= 0) {
+            h.down_for = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::nanoseconds(now - down_since));
+        }
+        auto recovery = connection->last_recovery_ms.load(std::memory_order_relaxed);
+        if (recovery >= 0) h.last_recovery = std::chrono::milliseconds(recovery);
+        health.push_back(h);
+    }
+    return health;
+}
+
+void PolymarketClient::on_message(Connection& connection, const ix::WebSocketMessagePtr& msg) {
     switch (msg->type) {
         case ix::WebSocketMessageType::Open:
-            connected_ = true;
-            {
-                std::lock_guard lock(sub_mutex_);
-                if (!token_ids_.empty()) {
-                    send_subscribe();
-                }
-            }
+            mde::telemetry::pin_current_thread(cpus_, "websocket network thread");
+            on_open(connection);
             break;
 
-        case ix::WebSocketMessageType::Message: {
-            auto events = parser_.parse(msg->str);
-            std::lock_guard lock(callback_mutex_);
-            if (on_event_) {
-                for (const auto& event : events) {
-                    on_event_(event);
-                }
+        case ix::WebSocketMessageType::Message:
+            messages_.inc();
+            connection.messages.fetch_add(1, std::memory_order_relaxed);
+            connection.last_message_ns.store(steady_now_ns(), std::memory_order_relaxed);
+            if (connection.parse_queue) {
+                enqueue_message(connection, msg->str);
+            } else {
+                dispatch(connection, msg->str, mde::telemetry::tsc_now());
             }
             break;
-        }
 
         case ix::WebSocketMessageType::Close:
-            connected_ = false;
+            on_down(connection);
+            break;
+
+        case ix::WebSocketMessageType::Error:
+            // A failed connect or a socket error; IXWebSocket retries on its own
+            on_down(connection);
+            std::cerr << "[client] Connection " << connection.index << ": " << msg->errorInfo.reason
+                      << " (attempt " << msg->errorInfo.retries << ", next in "
+                      << msg->errorInfo.wait_time << " ms)" << std::endl;
             break;
 
         default:
@@ -68,14 +282,120 @@ void PolymarketClient::on_message(const ix::WebSocketMessagePtr& msg) {
     }
 }
 
-void PolymarketClient::send_subscribe() {
-    std::string assets = "[";
-    for (size_t i = 0; i < token_ids_.size(); ++i) {
-        if (i > 0) assets += ",";
-        assets += "\"" + token_ids_[i] + "\"";
+void PolymarketClient::on_open(Connection& connection) {
+    connection.connected = true;
+    connected_gauge_.add(1);
+    if (connection.opened_before) {
+        connection.reconnects.fetch_add(1, std::memory_order_relaxed);
+        reconnects_.inc();
+    }
+    connection.opened_before = true;
+
+    size_t tokens = 0;
+    {
+        // Includes tokens subscribed while the connection was down
+        std::lock_guard lock(connection.tokens_mutex);
+        tokens = connection.token_ids.size();
+        if (tokens > 0) {
+            connection.ws.send(subscribe_message(connection.token_ids, true));
+        }
+    }
+
+    auto down_since = connection.down_since_ns.exchange(-1);
+    if (down_since >= 0) {
+        auto downtime_ms = (steady_now_ns() - down_since) / 1'000'000;
+        connection.last_recovery_ms.store(downtime_ms, std::memory_order_relaxed);
+        downtime_ms_.inc(static_cast<uint64_t>(downtime_ms));
+        last_recovery_gauge_.set(downtime_ms);
+        std::cout << "[client] Connection " << connection.index << " back after " << downtime_ms
+                  << " ms, resubscribed " << tokens << " assets" << std::endl;
+    }
+}
+
+void PolymarketClient::on_down(Connection& connection) {
+    // Close and Error can both report one drop; only the first counts
+    if (!connection.connected.exchange(false)) return;
+    connected_gauge_.add(-1);
+    connection.down_since_ns.store(steady_now_ns());
+
+    if (!on_disconnect_) return;
+    std::vector<std::string> tokens;
+    {
+        std::lock_guard lock(connection.tokens_mutex);
+        tokens = connection.token_ids;
+    }
+    on_disconnect_(tokens);
+}
+
+void PolymarketClient::dispatch(Connection& connection, std::string_view message, uint64_t received) {
+    using mde::telemetry::Stage;
+
+    // Parsed on this connection's thread; only the hand-off is serialized.
+    // Events are moved out to the service and on into storage. The batch
+    // keeps its slots, but moved-from levels no longer hold capacity.
+    auto& batch = connection.batch;
+    bool well_formed = false;
+    try {
+        well_formed = connection.parser->parse(message, batch);
+    } catch (...) {
+        parse_failures_.inc();
+        throw;
+    }
+    mde::telemetry::record_since(Stage::parse, received);
+    if (!well_formed) parse_failures_.inc();
+    if (batch.empty()) return;
+    std::lock_guard lock(callback_mutex_);
+    if (on_events_) {
+        on_events_(std::span(batch.begin(), batch.end()));
+    } else if (on_event_) {
+        for (auto& event : batch) {
+            on_event_(std::move(event));
+        }
+    }
+    mde::telemetry::record_since(Stage::end_to_end, received);
+}
+
+void PolymarketClient::enqueue_message(Connection& connection, const std::string& message) {
+    // msg->str is only valid during the callback, so it has to be copied;
+    // reusing a buffer the parser has finished with avoids an allocation
+    QueuedMessage queued{connection.spare_buffers->try_pop().value_or(std::string()),
+                         mde::telemetry::tsc_now()};
+    queued.text.assign(message);
+
+    // Blocks only this connection's network thread
+    mde::services::Backoff backoff;
+    while (!connection.parse_queue->try_push(std::move(queued))) {
+        backoff.pause();
+    }
+}
+
+void PolymarketClient::run_parser(Connection& connection) {
+    mde::telemetry::pin_current_thread(cpus_, "websocket parser");
+    mde::services::Backoff backoff;
+    while (true) {
+        auto message = connection.parse_queue->try_pop();
+        if (!message) {
+            if (!connection.parsing) break;
+            backoff.pause();
+            continue;
+        }
+        backoff.reset();
+
+        try {
+            dispatch(connection, message->text, message->received);
+        } catch (const std::exception& e) {
+            std::cerr << "[client] Dropped message: " << e.what() << std::endl;
+        }
+        // Dropped if the pool is full; the network thread then allocates
+        (void)connection.spare_buffers->try_push(std::move(message->text));
+    }
+}
+
+void PolymarketClient::stop_parser(Connection& connection) {
+    connection.parsing = false;
+    if (connection.parser_thread.joinable()) {
+        connection.parser_thread.join();
     }
-    assets += "]";
-    ws_.send(R"({"assets_ids": )" + assets + R"(, "type": "market"})");
 }
 
 } // namespace mde::infrastructure
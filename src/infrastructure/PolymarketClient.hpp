@@ -1,39 +1,156 @@
 #pragma once
 
 #include "config/Settings.hpp"
-#include "infrastructure/PolymarketMessageParser.hpp"
+#include "infrastructure/IMessageParser.hpp"
 #include "services/IMarketDataFeed.hpp"
+#include "services/SpscQueue.hpp"
+#include "telemetry/Metrics.hpp"
 
 #include <ixwebsocket/IXWebSocket.h>
 
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace mde::infrastructure {
 
+// State of one pooled connection, for logs and health checks
+struct ConnectionHealth {
+    size_t index{0};
+    size_t tokens{0};
+    bool connected{false};
+    uint64_t messages{0};
+    uint64_t reconnects{0};
+    // Since the last message; nullopt before the first
+    std::optional<std::chrono::milliseconds> idle;
+    // How long the current outage has lasted, and how long the last one
+    // took to recover from; nullopt when up, and before any outage
+    std::optional<std::chrono::milliseconds> down_for;
+    std::optional<std::chrono::milliseconds> last_recovery;
+};
+
+// Market-channel feed over settings.connections websockets. Each token is
+// assigned once, to the connection with the fewest, and stays there, so its
+// messages keep their order. Each connection has its own network thread
+// (and parser thread with parse_queue_capacity > 0) and its own parser, so
+// a slow socket or a large book only holds up its own tokens; delivery to
+// the callback is serialized across connections.
+//
+// On (re)connect a connection subscribes to all of its tokens; tokens added
+// while it is open are sent together as an incremental subscribe, and those
+// added while it is down wait in its list for the next open. A dropped
+// connection is retried with exponential backoff (reconnect_min_wait_ms,
+// doubling to reconnect_max_wait_ms); the disconnect callback is told which
+// tokens went dark, and the resubscription on open brings a fresh book for
+// each of them.
 class PolymarketClient : public mde::services::IMarketDataFeed {
 public:
-    explicit PolymarketClient(const mde::config::WebSocketSettings& settings = {});
+    // Uses the parser backend named in settings unless one is supplied; a
+    // supplied parser serves the first connection, the others get
+    // settings.parser_backend
+    explicit PolymarketClient(const mde::config::WebSocketSettings& settings = {},
+                              std::unique_ptr<IMessageParser> parser = nullptr);
     ~PolymarketClient() override;
 
+    // Told the tokens of a connection that dropped, on its network thread.
+    // Set before start().
+    using DisconnectCallback = std::function<void(std::span<const std::string> token_ids)>;
+    void set_on_disconnect(DisconnectCallback callback) { on_disconnect_ = std::move(callback); }
+
+    // Setting either callback clears the other
     void set_on_event(EventCallback callback) override;
+    void set_on_events(BatchCallback callback) override;
+    // A token already subscribed is ignored
     void subscribe(const std::string& token_id) override;
+    // One subscribe message per open connection for all of its new tokens
+    void subscribe_all(std::span<const std::string> token_ids) override;
+    // Drops the tokens from their connections, telling the open ones;
+    // unknown tokens are ignored
+    void unsubscribe_all(std::span<const std::string> token_ids) override;
     void start() override;
     void stop() override;
 
+    // Resubscribes one token on its connection so the server sends a fresh
+    // book snapshot for it, e.g. after the local book was found to disagree
+    // with the exchange. Rate-limited per token; returns whether a request
+    // went out (false for an unknown token, a closed connection, or a
+    // request within the last few seconds).
+    bool resync(const std::string& token_id);
+
+    size_t connection_count() const noexcept { return connections_.size(); }
+    std::vector<ConnectionHealth> connection_health() const;
+
 private:
-    ix::WebSocket ws_;
-    PolymarketMessageParser parser_;
+    // Parser stage (parse_queue_capacity > 0): the network thread copies each
+    // message into a recycled buffer and a dedicated thread parses it
+    struct QueuedMessage {
+        std::string text;
+        uint64_t received;  // telemetry::tsc_now() on the network thread
+    };
+
+    struct Connection {
+        Connection(size_t index, std::unique_ptr<IMessageParser> parser, size_t queue_capacity);
+
+        size_t index;
+        ix::WebSocket ws;
+        std::unique_ptr<IMessageParser> parser;
+        EventBatch batch;  // used only by the thread running dispatch()
+
+        std::mutex tokens_mutex;
+        std::vector<std::string> token_ids;
+        std::atomic<size_t> token_count{0};
+        std::atomic<bool> connected{false};
+        bool opened_before{false};  // network thread only
+        std::atomic<int64_t> down_since_ns{-1};     // steady_clock; -1 while up
+        std::atomic<int64_t> last_recovery_ms{-1};
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> reconnects{0};
+        std::atomic<int64_t> last_message_ns{-1};  // steady_clock
+
+        std::unique_ptr<mde::services::SpscQueue<QueuedMessage>> parse_queue;
+        std::unique_ptr<mde::services::SpscQueue<std::string>> spare_buffers;
+        std::thread parser_thread;
+        std::atomic<bool> parsing{false};
+    };
+
+    std::vector<std::unique_ptr<Connection>> connections_;
     EventCallback on_event_;
-    std::vector<std::string> token_ids_;
-    std::atomic<bool> connected_{false};
+    BatchCallback on_events_;
     std::mutex callback_mutex_;
-    std::mutex sub_mutex_;
+    DisconnectCallback on_disconnect_;
+
+    // token_id -> connection index, and when each token was last resynced
+    std::mutex assign_mutex_;
+    std::unordered_map<std::string, size_t> assigned_;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> last_resync_;
+
+    mde::telemetry::Counter& messages_;
+    mde::telemetry::Counter& parse_failures_;
+    mde::telemetry::Counter& reconnects_;
+    mde::telemetry::Gauge& connected_gauge_;
+    mde::telemetry::Counter& resyncs_;
+    mde::telemetry::Counter& downtime_ms_;
+    mde::telemetry::Gauge& last_recovery_gauge_;
+    // Network threads are IXWebSocket's; each pins itself as it opens
+    std::string cpus_;
 
-    void on_message(const ix::WebSocketMessagePtr& msg);
-    void send_subscribe();
+    void on_message(Connection& connection, const ix::WebSocketMessagePtr& msg);
+    void on_open(Connection& connection);
+    void on_down(Connection& connection);
+    void dispatch(Connection& connection, std::string_view message, uint64_t received);
+    void enqueue_message(Connection& connection, const std::string& message);
+    void run_parser(Connection& connection);
+    static void stop_parser(Connection& connection);
 };
 
 } // namespace mde::infrastructure
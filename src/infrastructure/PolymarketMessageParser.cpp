@@ -2,7 +2,13 @@
 
 #include <nlohmann/json.hpp>
 
-#include <map>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <system_error>
+#include <string>
+#include <string_view>
 
 using json = nlohmann::json;
 using namespace mde::domain;
@@ -11,120 +17,330 @@ namespace mde::infrastructure {
 
 namespace {
 
-BookSnapshot parse_book_snapshot(const json& obj) {
-    auto market = obj["market"].get<std::string>();
-    auto asset_id = obj["asset_id"].get<std::string>();
-    auto timestamp = Timestamp::from_string(obj["timestamp"].get<std::string>());
-    auto hash = obj.value("hash", "");
+// The string fields read from event objects and from their price level and
+// price change entries; any other key is skipped
+enum class Field : uint8_t {
+    event_type, market, asset_id, timestamp, hash, price, size, side,
+    fee_rate_bps, old_tick_size, new_tick_size, best_bid, best_ask,
+};
 
-    std::vector<PriceLevel> bids;
-    for (const auto& level : obj["bids"]) {
-        bids.push_back(PriceLevel::from_strings(
-            level["price"].get<std::string>(),
-            level["size"].get<std::string>()));
-    }
+constexpr std::array<std::string_view, 13> kFieldNames = {
+    "event_type", "market", "asset_id", "timestamp", "hash", "price", "size", "side",
+    "fee_rate_bps", "old_tick_size", "new_tick_size", "best_bid", "best_ask",
+};
 
-    std::vector<PriceLevel> asks;
-    for (const auto& level : obj["asks"]) {
-        asks.push_back(PriceLevel::from_strings(
-            level["price"].get<std::string>(),
-            level["size"].get<std::string>()));
+std::optional<Field> field_named(std::string_view key) {
+    for (size_t i = 0; i < kFieldNames.size(); ++i) {
+        if (kFieldNames[i] == key) return static_cast<Field>(i);
     }
-
-    return BookSnapshot{
-        {MarketAsset(market, asset_id), timestamp, 0},
-        std::move(bids), std::move(asks), hash
-    };
+    return std::nullopt;
 }
 
-// price_change can contain changes for multiple assets,
-// so we group by asset_id and return one BookDelta per asset.
-std::vector<OrderBookEventVariant> parse_price_change(const json& obj) {
-    auto market = obj["market"].get<std::string>();
-    auto timestamp = Timestamp::from_string(obj["timestamp"].get<std::string>());
-
-    // Group changes by asset_id
-    std::map<std::string, std::vector<PriceLevelDelta>> by_asset;
-    for (const auto& change : obj["price_changes"]) {
-        auto asset_id = change["asset_id"].get<std::string>();
-        by_asset[asset_id].push_back(PriceLevelDelta{
-            asset_id,
-            Price::from_string(change["price"].get<std::string>()),
-            Quantity::from_string(change["size"].get<std::string>()),
-            side_from_string(change["side"].get<std::string>()),
-            Price::from_string(change["best_bid"].get<std::string>()),
-            Price::from_string(change["best_ask"].get<std::string>()),
-        });
-    }
-
-    std::vector<OrderBookEventVariant> events;
-    for (auto& [asset_id, changes] : by_asset) {
-        events.push_back(BookDelta{
-            {MarketAsset(market, asset_id), timestamp, 0},
-            std::move(changes)
-        });
-    }
-    return events;
+// The arrays of objects inside an event
+enum class Section : uint8_t { none, bids, asks, price_changes };
+
+Section section_named(std::string_view key) {
+    if (key == "bids") return Section::bids;
+    if (key == "asks") return Section::asks;
+    if (key == "price_changes") return Section::price_changes;
+    return Section::none;
 }
 
-TradeEvent parse_trade_event(const json& obj) {
-    auto market = obj["market"].get<std::string>();
-    auto asset_id = obj["asset_id"].get<std::string>();
-    auto timestamp = Timestamp::from_string(obj["timestamp"].get<std::string>());
-
-    return TradeEvent{
-        {MarketAsset(market, asset_id), timestamp, 0},
-        Price::from_string(obj["price"].get<std::string>()),
-        Quantity::from_string(obj["size"].get<std::string>()),
-        side_from_string(obj["side"].get<std::string>()),
-        obj.value("fee_rate_bps", "0")
-    };
+constexpr uint8_t section_bit(Section section) noexcept {
+    return static_cast<uint8_t>(uint8_t{1} << static_cast<uint8_t>(section));
 }
 
-TickSizeChange parse_tick_size_change(const json& obj) {
-    auto market = obj["market"].get<std::string>();
-    auto asset_id = obj["asset_id"].get<std::string>();
-    auto timestamp = Timestamp::from_string(obj["timestamp"].get<std::string>());
+// Values of one object's fields, in strings that are reused for every object
+class FieldSet {
+public:
+    void clear() noexcept { present_ = 0; }
 
-    return TickSizeChange{
-        {MarketAsset(market, asset_id), timestamp, 0},
-        Price::from_string(obj["old_tick_size"].get<std::string>()),
-        Price::from_string(obj["new_tick_size"].get<std::string>())
-    };
-}
+    void set(Field field, std::string_view value) {
+        values_[index(field)].assign(value);
+        present_ |= bit(field);
+    }
+
+    bool has(Field field) const noexcept { return (present_ & bit(field)) != 0; }
+
+    // Empty for a missing field, which no conversion accepts
+    std::string_view get(Field field) const noexcept {
+        return has(field) ? std::string_view(values_[index(field)]) : std::string_view();
+    }
+
+    std::string_view get_or(Field field, std::string_view fallback) const {
+        return has(field) ? std::string_view(values_[index(field)]) : fallback;
+    }
+
+private:
+    static size_t index(Field field) noexcept { return static_cast<size_t>(field); }
+    static uint32_t bit(Field field) noexcept { return uint32_t{1} << index(field); }
+
+    std::array<std::string, kFieldNames.size()> values_;
+    uint32_t present_{0};
+};
+
+// Conversions report a bad value instead of throwing it, so the message is
+// dropped and counted without unwinding through the feed's callback
+bool read(std::string_view text, Price& out) noexcept { return Price::parse(text, out) == std::errc{}; }
+bool read(std::string_view text, Quantity& out) noexcept { return Quantity::parse(text, out) == std::errc{}; }
+bool read(std::string_view text, Side& out) noexcept { return parse_side(text, out) == std::errc{}; }
+bool read(std::string_view text, Timestamp& out) noexcept { return Timestamp::parse(text, out) == std::errc{}; }
 
 } // anonymous namespace
 
-std::vector<OrderBookEventVariant> PolymarketMessageParser::parse(
-    const std::string& json_str) const {
+// SAX handler. Event objects are the root object or the objects directly in
+// the root array; their bids, asks and price_changes entries are parsed as
+// each entry closes, and the event itself when its object closes, since
+// Polymarket does not promise any key order. A missing or malformed field,
+// or a missing (or non-array) bids, asks or price_changes, stops the parse,
+// which drops the whole message.
+struct PolymarketMessageParser::Impl {
+    using string_t = json::string_t;
+
+    EventBatch* batch{nullptr};
+
+    size_t depth{0};        // open objects and arrays
+    size_t event_depth{0};  // depth inside the current event object, 0 outside one
+    bool root_is_array{false};
+
+    std::optional<Field> field;  // the key whose string value comes next
+    Section next_section{Section::none};
+    Section section{Section::none};
+    uint8_t sections_seen{0};  // section_bit of each array the event has
+
+    FieldSet fields;
+    FieldSet entry;
+    std::vector<PriceLevel> bids;
+    std::vector<PriceLevel> asks;
+    std::vector<PriceLevelDelta> changes;
+
+    void reset(EventBatch& out) {
+        batch = &out;
+        depth = 0;
+        event_depth = 0;
+        root_is_array = false;
+        field.reset();
+        section = Section::none;
+    }
+
+    bool in_event() const noexcept { return event_depth != 0; }
+    bool in_entry() const noexcept { return section != Section::none && depth == event_depth + 2; }
+
+    // --- nlohmann SAX interface ---
+
+    bool start_object(size_t) {
+        ++depth;
+        field.reset();
+        if (!in_event() && (depth == 1 || (depth == 2 && root_is_array))) {
+            event_depth = depth;
+            sections_seen = 0;
+            fields.clear();
+            bids.clear();
+            asks.clear();
+            changes.clear();
+        } else if (in_entry()) {
+            entry.clear();
+        }
+        return true;
+    }
+
+    bool end_object() {
+        bool ok = true;
+        if (in_event() && depth == event_depth) {
+            ok = finish_event();
+            event_depth = 0;
+        } else if (in_entry()) {
+            ok = finish_entry();
+        }
+        --depth;
+        field.reset();
+        return ok;
+    }
 
-    auto json_msg = json::parse(json_str, nullptr, false);
-    if (json_msg.is_discarded()) return {};
-    std::vector<OrderBookEventVariant> events;
+    bool start_array(size_t) {
+        if (depth == 0) root_is_array = true;
+        if (in_event() && depth == event_depth) {
+            section = next_section;
+            sections_seen |= section_bit(section);
+        }
+        ++depth;
+        field.reset();
+        return true;
+    }
 
-    // Polymarket wraps messages in a JSON array
-    auto& items = json_msg.is_array() ? json_msg : (json_msg = json::array({json_msg}));
+    bool end_array() {
+        --depth;
+        if (in_event() && depth == event_depth) section = Section::none;
+        field.reset();
+        return true;
+    }
 
-    for (const auto& obj : items) {
-        if (!obj.is_object() || !obj.contains("event_type")) continue;
+    bool key(string_t& name) {
+        if (in_event() && depth == event_depth) {
+            field = field_named(name);
+            next_section = section_named(name);
+        } else if (in_entry()) {
+            field = field_named(name);
+        } else {
+            field.reset();
+        }
+        return true;
+    }
 
-        auto event_type = obj["event_type"].get<std::string>();
+    bool string(string_t& value) {
+        if (field) {
+            if (depth == event_depth) {
+                fields.set(*field, value);
+            } else if (in_entry()) {
+                entry.set(*field, value);
+            }
+        }
+        field.reset();
+        return true;
+    }
+
+    // Other values are never read
+    bool null() { return scalar(); }
+    bool boolean(bool) { return scalar(); }
+    bool number_integer(json::number_integer_t) { return scalar(); }
+    bool number_unsigned(json::number_unsigned_t) { return scalar(); }
+    bool number_float(json::number_float_t, const string_t&) { return scalar(); }
+    bool binary(json::binary_t&) { return scalar(); }
+
+    bool parse_error(size_t, const std::string&, const nlohmann::detail::exception&) {
+        return false;
+    }
 
-        if (event_type == "book") {
-            events.push_back(parse_book_snapshot(obj));
-        } else if (event_type == "price_change") {
-            auto deltas = parse_price_change(obj);
-            events.insert(events.end(),
-                          std::make_move_iterator(deltas.begin()),
-                          std::make_move_iterator(deltas.end()));
-        } else if (event_type == "last_trade_price") {
-            events.push_back(parse_trade_event(obj));
-        } else if (event_type == "tick_size_change") {
-            events.push_back(parse_tick_size_change(obj));
+private:
+    bool scalar() {
+        field.reset();
+        return true;
+    }
+
+    // The event's asset and timestamp; nullopt if one is missing or malformed
+    std::optional<OrderBookEvent> header() const {
+        auto market = fields.get(Field::market);
+        auto token = fields.get(Field::asset_id);
+        auto timestamp = Timestamp(0);
+        if (market.empty() || token.empty() || !read(fields.get(Field::timestamp), timestamp)) return std::nullopt;
+        return OrderBookEvent{MarketAsset(AssetId(market), AssetId(token)), timestamp, 0};
+    }
+
+    bool has_section(Section wanted) const noexcept { return (sections_seen & section_bit(wanted)) != 0; }
+
+    bool finish_entry() {
+        switch (section) {
+            case Section::bids:
+            case Section::asks: {
+                auto price = Price::zero();
+                auto size = Quantity::zero();
+                if (!read(entry.get(Field::price), price) || !read(entry.get(Field::size), size)) return false;
+                (section == Section::bids ? bids : asks).emplace_back(price, size);
+                return true;
+            }
+            case Section::price_changes: {
+                auto token = entry.get(Field::asset_id);
+                auto price = Price::zero();
+                auto size = Quantity::zero();
+                auto side = Side::BUY;
+                auto best_bid = Price::zero();
+                auto best_ask = Price::zero();
+                if (token.empty() || !read(entry.get(Field::price), price) || !read(entry.get(Field::size), size) ||
+                    !read(entry.get(Field::side), side) || !read(entry.get(Field::best_bid), best_bid) ||
+                    !read(entry.get(Field::best_ask), best_ask)) {
+                    return false;
+                }
+                changes.push_back(PriceLevelDelta{AssetId(token), price, size, side, best_bid, best_ask});
+                return true;
+            }
+            case Section::none:
+                break;
+        }
+        return true;
+    }
+
+    bool finish_event() {
+        if (!fields.has(Field::event_type)) return true;
+        auto type = fields.get(Field::event_type);
+
+        if (type == "book") {
+            auto event = header();
+            if (!event || !has_section(Section::bids) || !has_section(Section::asks)) return false;
+            auto& snapshot = batch->add_snapshot(*event);
+            snapshot.hash.assign(fields.get_or(Field::hash, ""));
+            snapshot.bids.assign(bids.begin(), bids.end());
+            snapshot.asks.assign(asks.begin(), asks.end());
+        } else if (type == "price_change") {
+            return has_section(Section::price_changes) && add_price_change();
+        } else if (type == "last_trade_price") {
+            auto event = header();
+            auto price = Price::zero();
+            auto size = Quantity::zero();
+            auto side = Side::BUY;
+            if (!event || !read(fields.get(Field::price), price) || !read(fields.get(Field::size), size) ||
+                !read(fields.get(Field::side), side)) {
+                return false;
+            }
+            batch->add(TradeEvent{*event, price, size, side, std::string(fields.get_or(Field::fee_rate_bps, "0"))});
+        } else if (type == "tick_size_change") {
+            auto event = header();
+            auto old_tick = Price::zero();
+            auto new_tick = Price::zero();
+            if (!event || !read(fields.get(Field::old_tick_size), old_tick) ||
+                !read(fields.get(Field::new_tick_size), new_tick)) {
+                return false;
+            }
+            batch->add(TickSizeChange{*event, old_tick, new_tick});
+        }
+        return true;
+    }
+
+    // price_change can contain changes for multiple assets,
+    // so we group by asset_id and add one BookDelta per asset.
+    bool add_price_change() {
+        auto market_id = fields.get(Field::market);
+        auto ts = Timestamp(0);
+        if (market_id.empty() || !read(fields.get(Field::timestamp), ts)) return false;
+        AssetId market(market_id);
+
+        // Keep first-seen order. A message touches one or two assets, so a
+        // linear scan over this message's deltas beats a map.
+        size_t first = batch->size();
+        for (const auto& change : changes) {
+            BookDelta* delta = nullptr;
+            for (size_t i = first; i < batch->size(); ++i) {
+                auto& candidate = std::get<BookDelta>((*batch)[i]);
+                if (candidate.asset.token() == change.asset_id) {
+                    delta = &candidate;
+                    break;
+                }
+            }
+            if (!delta) {
+                delta = &batch->add_delta({MarketAsset(market, change.asset_id), ts, 0});
+            }
+            delta->changes.push_back(change);
         }
+        return true;
     }
+};
+
+PolymarketMessageParser::PolymarketMessageParser() : impl_(std::make_unique<Impl>()) {}
 
-    return events;
+PolymarketMessageParser::~PolymarketMessageParser() = default;
+
+bool PolymarketMessageParser::parse(std::string_view message, EventBatch& batch) {
+    batch.clear();
+    impl_->reset(batch);
+    try {
+        if (!json::sax_parse(message.begin(), message.end(), impl_.get())) {
+            batch.clear();  // malformed JSON or field; no partial messages
+            return false;
+        }
+    } catch (...) {
+        batch.clear();
+        throw;
+    }
+    return true;
 }
 
 } // namespace mde::infrastructure
@@ -1,19 +1,33 @@
 #pragma once
 
-#include "domain/aggregates/OrderBook.hpp"
+#include "infrastructure/IMessageParser.hpp"
 
-#include <string>
+#include <memory>
+#include <string_view>
 #include <vector>
 
 namespace mde::infrastructure {
 
-class PolymarketMessageParser {
+// nlohmann::json backend. Reads messages through the SAX interface instead
+// of building a DOM: field values are copied into scratch strings and level
+// and change vectors that keep their capacity from message to message, and
+// the events are assembled from those when each object closes.
+//
+// Holds that scratch state, so one instance must not be shared between threads.
+class PolymarketMessageParser : public IMessageParser {
 public:
-    // Parse a raw WebSocket JSON message into domain events.
-    // Returns empty vector for unrecognized message types.
-    // Polymarket wraps messages in a JSON array, so one message
-    // can produce multiple events (e.g. price_change with multiple assets).
-    std::vector<mde::domain::OrderBookEventVariant> parse(const std::string& json_str) const;
+    PolymarketMessageParser();
+    ~PolymarketMessageParser() override;
+
+    PolymarketMessageParser(const PolymarketMessageParser&) = delete;
+    PolymarketMessageParser& operator=(const PolymarketMessageParser&) = delete;
+
+    using IMessageParser::parse;
+    bool parse(std::string_view message, EventBatch& batch) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
 };
 
 } // namespace mde::infrastructure
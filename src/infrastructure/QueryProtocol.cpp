@@ -0,0 +1,207 @@
+#include "infrastructure/QueryProtocol.hpp"
+
+#include "infrastructure/LittleEndian.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace mde::infrastructure::query {
+
+using namespace mde::domain;
+using little_endian::load;
+using little_endian::patch;
+using little_endian::put;
+
+namespace {
+
+constexpr size_t kQueryBlock = 6;
+constexpr size_t kResultBlock = 4;
+constexpr size_t kBookBlock = 24;
+constexpr size_t kLevelBytes = 16;
+
+void put_header(std::string& out, uint32_t request_id) {
+    put(out, kMagic);
+    put(out, kVersion);
+    put<uint8_t>(out, 0);
+    put(out, request_id);
+    put<uint16_t>(out, 0);  // count, patched once known
+    put<uint16_t>(out, 0);
+}
+
+// Header of a body; nullopt unless it carries the magic and this version
+std::optional<std::pair<uint32_t, uint16_t>> read_header(std::string_view body) {
+    if (body.size() < kHeaderBytes) return std::nullopt;
+    const char* p = body.data();
+    if (load<uint16_t>(p) != kMagic || static_cast<uint8_t>(p[2]) != kVersion) return std::nullopt;
+    return std::pair{load<uint32_t>(p + 4), load<uint16_t>(p + 8)};
+}
+
+uint16_t put_side(std::string& out, const PriceLadder& ladder, uint16_t depth) {
+    uint16_t count = 0;
+    size_t limit = depth == 0 ? std::numeric_limits<uint16_t>::max() : depth;
+    for (auto level = ladder.begin(); level != ladder.end() && count < limit; ++level, ++count) {
+        auto value = *level;
+        put(out, value.price().micros());
+        put(out, value.size().units());
+    }
+    return count;
+}
+
+void load_side(const char* p, size_t count, std::vector<PriceLevel>& out) {
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i, p += kLevelBytes) {
+        out.emplace_back(Price::from_micros(load<int64_t>(p)), Quantity::from_units(load<int64_t>(p + 8)));
+    }
+}
+
+} // namespace
+
+std::string encode_request(uint32_t request_id, std::span<const Query> queries) {
+    if (queries.size() > std::numeric_limits<uint16_t>::max()) {
+        throw std::length_error("Too many queries for one request");
+    }
+    std::string out;
+    put<uint32_t>(out, 0);  // frame length, patched below
+    put_header(out, request_id);
+    for (const auto& query : queries) {
+        if (query.token_id.size() > std::numeric_limits<uint16_t>::max()) {
+            throw std::length_error("Token id too long for a query");
+        }
+        put(out, static_cast<uint8_t>(query.kind));
+        put<uint8_t>(out, 0);
+        put(out, query.depth);
+        put(out, static_cast<uint16_t>(query.token_id.size()));
+        out.append(query.token_id);
+    }
+    patch(out, kFrameHeaderBytes + 8, static_cast<uint16_t>(queries.size()));
+    patch(out, 0, static_cast<uint32_t>(out.size() - kFrameHeaderBytes));
+    return out;
+}
+
+std::optional<uint32_t> read_request(std::string_view body, std::vector<QueryView>& queries) {
+    queries.clear();
+    auto header = read_header(body);
+    if (!header) return std::nullopt;
+    auto [request_id, count] = *header;
+
+    size_t pos = kHeaderBytes;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (body.size() - pos < kQueryBlock) return std::nullopt;
+        const char* p = body.data() + pos;
+        auto kind = static_cast<QueryKind>(static_cast<uint8_t>(p[0]));
+        if (kind != QueryKind::book && kind != QueryKind::spread && kind != QueryKind::midpoint) return std::nullopt;
+        size_t token_length = load<uint16_t>(p + 4);
+        if (body.size() - pos - kQueryBlock < token_length) return std::nullopt;
+        queries.push_back(QueryView{kind, load<uint16_t>(p + 2), body.substr(pos + kQueryBlock, token_length)});
+        pos += kQueryBlock + token_length;
+    }
+    if (pos != body.size()) return std::nullopt;
+    return request_id;
+}
+
+// --- ResponseWriter ---
+
+ResponseWriter::ResponseWriter(std::string& out, uint32_t request_id)
+    : out_(out)
+    , start_(out.size()) {
+    put<uint32_t>(out_, 0);
+    put_header(out_, request_id);
+}
+
+void ResponseWriter::append_book(const OrderBook& book, uint16_t depth) {
+    append_status(QueryKind::book, Status::ok);
+    put(out_, book.get_timestamp().milliseconds());
+    put(out_, book.get_last_sequence_number());
+    auto counts = out_.size();
+    put<uint16_t>(out_, 0);
+    put<uint16_t>(out_, 0);
+    put<uint32_t>(out_, 0);
+    patch(out_, counts, put_side(out_, book.get_bids(), depth));
+    patch(out_, counts + 2, put_side(out_, book.get_asks(), depth));
+}
+
+void ResponseWriter::append_spread(const OrderBook& book) {
+    auto spread = book.spread();
+    if (!spread) return append_status(QueryKind::spread, Status::one_sided);
+    append_status(QueryKind::spread, Status::ok);
+    put(out_, spread->best_bid.micros());
+    put(out_, spread->best_ask.micros());
+}
+
+void ResponseWriter::append_midpoint(const OrderBook& book) {
+    auto midpoint = book.midpoint();
+    if (!midpoint) return append_status(QueryKind::midpoint, Status::one_sided);
+    append_status(QueryKind::midpoint, Status::ok);
+    put(out_, midpoint->micros());
+}
+
+void ResponseWriter::append_status(QueryKind kind, Status status) {
+    put(out_, static_cast<uint8_t>(kind));
+    put(out_, static_cast<uint8_t>(status));
+    put<uint16_t>(out_, 0);
+    ++count_;
+}
+
+void ResponseWriter::finish() {
+    patch(out_, start_ + kFrameHeaderBytes + 8, count_);
+    patch(out_, start_, static_cast<uint32_t>(out_.size() - start_ - kFrameHeaderBytes));
+}
+
+// --- Responses ---
+
+std::optional<Response> read_response(std::string_view body) {
+    auto header = read_header(body);
+    if (!header) return std::nullopt;
+    Response response;
+    response.request_id = header->first;
+    response.results.resize(header->second);
+
+    size_t pos = kHeaderBytes;
+    try {
+        for (auto& result : response.results) {
+            if (body.size() - pos < kResultBlock) return std::nullopt;
+            const char* p = body.data() + pos;
+            result.kind = static_cast<QueryKind>(static_cast<uint8_t>(p[0]));
+            result.status = static_cast<Status>(static_cast<uint8_t>(p[1]));
+            pos += kResultBlock;
+            p += kResultBlock;
+            if (result.status != Status::ok) continue;
+
+            auto remaining = body.size() - pos;
+            switch (result.kind) {
+            case QueryKind::book: {
+                if (remaining < kBookBlock) return std::nullopt;
+                size_t bids = load<uint16_t>(p + 16);
+                size_t asks = load<uint16_t>(p + 18);
+                if (remaining - kBookBlock < (bids + asks) * kLevelBytes) return std::nullopt;
+                result.timestamp = Timestamp(load<int64_t>(p));
+                result.last_sequence_number = load<uint64_t>(p + 8);
+                load_side(p + kBookBlock, bids, result.bids);
+                load_side(p + kBookBlock + bids * kLevelBytes, asks, result.asks);
+                pos += kBookBlock + (bids + asks) * kLevelBytes;
+                break;
+            }
+            case QueryKind::spread:
+                if (remaining < 16) return std::nullopt;
+                result.spread = Spread{Price::from_micros(load<int64_t>(p)), Price::from_micros(load<int64_t>(p + 8))};
+                pos += 16;
+                break;
+            case QueryKind::midpoint:
+                if (remaining < 8) return std::nullopt;
+                result.midpoint = Price::from_micros(load<int64_t>(p));
+                pos += 8;
+                break;
+            default:
+                return std::nullopt;
+            }
+        }
+    } catch (const std::out_of_range&) {
+        // A price or size out of range
+        return std::nullopt;
+    }
+    if (pos != body.size()) return std::nullopt;
+    return response;
+}
+
+} // namespace mde::infrastructure::query
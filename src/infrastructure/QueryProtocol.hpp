@@ -0,0 +1,118 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mde::infrastructure::query {
+
+// Wire format of the book query API (QueryServer <-> QueryClient), over
+// TCP. Little-endian and fixed layout like the binary feed; prices and
+// sizes in int64 micro-units, timestamps in int64 milliseconds.
+//
+// Every message is a frame: u32 length of the body, then the body.
+//   Request body
+//     u16 magic 'MQ' | u8 version | u8 reserved | u32 request id |
+//     u16 query count | u16 reserved | queries
+//   Query
+//     u8 kind | u8 reserved | u16 depth | u16 token length | token
+//   Response body
+//     u16 magic | u8 version | u8 reserved | u32 request id |
+//     u16 result count | u16 reserved | results, one per query, in order
+//   Result
+//     u8 kind | u8 status | u16 reserved, then for status ok:
+//     book       i64 timestamp | u64 seq | u16 bids | u16 asks | u32 reserved |
+//                (i64 price, i64 size) x (bids + asks), best first
+//     spread     i64 best bid | i64 best ask
+//     midpoint   i64 midpoint
+//
+// A book query returns the top `depth` levels per side, the whole book for
+// depth 0. A client may send further requests without waiting; responses
+// come back in request order.
+inline constexpr uint16_t kMagic = 0x514D;  // "MQ"
+inline constexpr uint8_t kVersion = 1;
+inline constexpr size_t kFrameHeaderBytes = 4;
+inline constexpr size_t kHeaderBytes = 12;
+
+enum class QueryKind : uint8_t {
+    book = 1,
+    spread = 2,
+    midpoint = 3,
+};
+
+enum class Status : uint8_t {
+    ok = 0,
+    unknown_asset = 1,
+    one_sided = 2,  // spread or midpoint of a book missing a side
+};
+
+struct Query {
+    QueryKind kind{QueryKind::book};
+    std::string token_id;
+    uint16_t depth{0};
+};
+
+// A query as parsed by the server, pointing into the request
+struct QueryView {
+    QueryKind kind;
+    uint16_t depth;
+    std::string_view token_id;
+};
+
+struct Result {
+    QueryKind kind{QueryKind::book};
+    Status status{Status::ok};
+    // book
+    mde::domain::Timestamp timestamp{0};
+    uint64_t last_sequence_number{0};
+    std::vector<mde::domain::PriceLevel> bids;  // best (highest) first
+    std::vector<mde::domain::PriceLevel> asks;  // best (lowest) first
+    // spread
+    std::optional<mde::domain::Spread> spread;
+    // midpoint
+    std::optional<mde::domain::Price> midpoint;
+};
+
+struct Response {
+    uint32_t request_id{0};
+    std::vector<Result> results;
+};
+
+// A whole request frame. Throws std::length_error past 65535 queries or a
+// token longer than 65535 bytes.
+std::string encode_request(uint32_t request_id, std::span<const Query> queries);
+
+// Parse a request body (after its length) into `queries`, reusing its
+// storage; nullopt (the request id otherwise) if malformed or of another
+// version
+std::optional<uint32_t> read_request(std::string_view body, std::vector<QueryView>& queries);
+
+// Builds a response frame at the end of `out` (a connection's output
+// buffer): begin, one append per query in order, then finish.
+class ResponseWriter {
+public:
+    ResponseWriter(std::string& out, uint32_t request_id);
+
+    void append_book(const mde::domain::OrderBook& book, uint16_t depth);
+    void append_spread(const mde::domain::OrderBook& book);
+    void append_midpoint(const mde::domain::OrderBook& book);
+    void append_status(QueryKind kind, Status status);
+
+    void finish();
+
+private:
+    std::string& out_;
+    size_t start_;
+    uint16_t count_{0};
+};
+
+// Parse a response body; nullopt if malformed
+std::optional<Response> read_response(std::string_view body);
+
+} // namespace mde::infrastructure::query
@@ -0,0 +1,281 @@
+#include "infrastructure/QueryServer.hpp"
+
+#include "infrastructure/LittleEndian.hpp"
+
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+
+namespace mde::infrastructure {
+
+using namespace mde::domain;
+using namespace mde::infrastructure::query;
+
+namespace {
+
+// Loops wake this often to notice stop()
+constexpr int kPollIntervalMs = 100;
+constexpr size_t kReadChunk = 64 * 1024;
+constexpr int kMaxEvents = 64;
+
+} // namespace
+
+struct QueryServer::Connection {
+    net::Descriptor socket;
+    std::string in;
+    size_t consumed{0};  // bytes of `in` already answered
+    std::string out;
+    size_t sent{0};      // bytes of `out` already written
+    uint32_t events{EPOLLIN};
+};
+
+void validate(const QueryServerOptions& options) {
+    net::parse_address(options.host, "query server");
+    if (options.threads == 0) throw std::invalid_argument("Query server needs at least one thread");
+    if (options.max_request_bytes == 0 || options.max_pending_output == 0) {
+        throw std::invalid_argument("Query server limits must be positive");
+    }
+}
+
+QueryServer::QueryServer(const mde::services::OrderBookService& service, QueryServerOptions options)
+    : service_(service)
+    , options_(std::move(options)) {
+    validate(options_);
+    listener_ = net::listen_on(options_.host, options_.port, 128, "query server");
+    // Every loop accepts; whichever wakes takes what is pending
+    ::fcntl(listener_.get(), F_SETFL, ::fcntl(listener_.get(), F_GETFL) | O_NONBLOCK);
+    port_ = net::local_port(listener_.get());
+}
+
+QueryServer::~QueryServer() {
+    stop();
+}
+
+void QueryServer::start() {
+    if (running_.load()) return;
+    std::vector<net::Descriptor> epolls;
+    for (size_t i = 0; i < options_.threads; ++i) {
+        net::Descriptor epoll(::epoll_create1(EPOLL_CLOEXEC));
+        // Only one loop is woken per incoming connection
+        epoll_event listen_event{};
+        listen_event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        listen_event.data.ptr = nullptr;
+        if (epoll.get() < 0 || ::epoll_ctl(epoll.get(), EPOLL_CTL_ADD, listener_.get(), &listen_event) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot set up a query server loop");
+        }
+        epolls.push_back(std::move(epoll));
+    }
+    epolls_ = std::move(epolls);
+    running_ = true;
+    for (const auto& epoll : epolls_) {
+        loops_.emplace_back([this, fd = epoll.get()] { run(fd); });
+    }
+}
+
+void QueryServer::stop() {
+    if (!running_.exchange(false)) return;
+    for (auto& loop : loops_) loop.join();
+    loops_.clear();
+    epolls_.clear();
+}
+
+void QueryServer::run(int epoll) {
+    std::unordered_map<Connection*, std::unique_ptr<Connection>> connections;
+    std::vector<QueryView> queries;
+    std::string chunk(kReadChunk, '\0');
+
+    auto close = [&](Connection* connection) {
+        ::epoll_ctl(epoll, EPOLL_CTL_DEL, connection->socket.get(), nullptr);
+        connections.erase(connection);
+        open_.fetch_sub(1, std::memory_order_relaxed);
+    };
+
+    auto accept_pending = [&] {
+        while (true) {
+            int fd = ::accept4(listener_.get(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+            auto connection = std::make_unique<Connection>();
+            connection->socket = net::Descriptor(fd);
+            int on = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            epoll_event event{};
+            event.events = connection->events;
+            event.data.ptr = connection.get();
+            if (::epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) != 0) continue;
+            connections.emplace(connection.get(), std::move(connection));
+            accepted_.fetch_add(1, std::memory_order_relaxed);
+            open_.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    // Read what is available; false once the peer is gone
+    auto receive = [&](Connection& connection) {
+        while (true) {
+            auto received = ::recv(connection.socket.get(), chunk.data(), chunk.size(), 0);
+            if (received > 0) {
+                connection.in.append(chunk.data(), static_cast<size_t>(received));
+                if (static_cast<size_t>(received) < chunk.size()) return true;
+                continue;
+            }
+            if (received < 0 && errno == EINTR) continue;
+            return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    };
+
+    // Write what the socket takes; false once the peer is gone
+    auto transmit = [&](Connection& connection) {
+        while (connection.sent < connection.out.size()) {
+            auto sent = ::send(connection.socket.get(), connection.out.data() + connection.sent,
+                               connection.out.size() - connection.sent, MSG_NOSIGNAL);
+            if (sent > 0) {
+                connection.sent += static_cast<size_t>(sent);
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) continue;
+            return sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+        connection.out.clear();
+        connection.sent = 0;
+        return true;
+    };
+
+    // Wait for output room before reading more from a client that is not
+    // reading its answers
+    auto rearm = [&](Connection& connection) {
+        auto pending = connection.out.size() - connection.sent;
+        uint32_t events = (pending < options_.max_pending_output ? EPOLLIN : 0u) | (pending > 0 ? EPOLLOUT : 0u);
+        if (events == connection.events) return;
+        connection.events = events;
+        epoll_event event{};
+        event.events = events;
+        event.data.ptr = &connection;
+        ::epoll_ctl(epoll, EPOLL_CTL_MOD, connection.socket.get(), &event);
+    };
+
+    epoll_event events[kMaxEvents];
+    while (running_.load(std::memory_order_acquire)) {
+        int ready = ::epoll_wait(epoll, events, kMaxEvents, kPollIntervalMs);
+        for (int i = 0; i < ready; ++i) {
+            if (!events[i].data.ptr) {
+                accept_pending();
+                continue;
+            }
+            auto* connection = static_cast<Connection*>(events[i].data.ptr);
+            bool alive = true;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                alive = receive(*connection);
+                // Requests that arrived before the peer went away (or a
+                // malformed one) still get their answers written
+                if (!answer_requests(*connection, queries)) alive = false;
+            }
+            if (transmit(*connection) && alive) {
+                rearm(*connection);
+            } else {
+                close(connection);
+            }
+        }
+    }
+    open_.fetch_sub(connections.size(), std::memory_order_relaxed);
+}
+
+bool QueryServer::answer_requests(Connection& connection, std::vector<QueryView>& queries) {
+    while (true) {
+        auto available = connection.in.size() - connection.consumed;
+        if (available < kFrameHeaderBytes) break;
+        auto length = little_endian::load<uint32_t>(connection.in.data() + connection.consumed);
+        if (length > options_.max_request_bytes) {
+            bad_requests_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (available - kFrameHeaderBytes < length) break;
+
+        auto body = std::string_view(connection.in).substr(connection.consumed + kFrameHeaderBytes, length);
+        auto request_id = read_request(body, queries);
+        if (!request_id) {
+            bad_requests_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        ResponseWriter writer(connection.out, *request_id);
+        for (const auto& query : queries) answer(query, writer);
+        writer.finish();
+        connection.consumed += kFrameHeaderBytes + length;
+        requests_.fetch_add(1, std::memory_order_relaxed);
+        queries_.fetch_add(queries.size(), std::memory_order_relaxed);
+    }
+
+    // Drop what was answered once it is most of the buffer
+    if (connection.consumed == connection.in.size()) {
+        connection.in.clear();
+        connection.consumed = 0;
+    } else if (connection.consumed > connection.in.size() / 2) {
+        connection.in.erase(0, connection.consumed);
+        connection.consumed = 0;
+    }
+    return true;
+}
+
+void QueryServer::answer(const QueryView& query, ResponseWriter& writer) {
+    std::shared_ptr<const OrderBook> book;
+    if (auto asset = service_.resolve_asset(query.token_id)) {
+        try {
+            book = service_.get_book_snapshot(*asset);
+        } catch (const std::exception&) {
+            // Indexed, but its shard has not applied an event yet
+        }
+    }
+    if (!book) return writer.append_status(query.kind, Status::unknown_asset);
+
+    switch (query.kind) {
+    case QueryKind::book:
+        return writer.append_book(*book, query.depth);
+    case QueryKind::spread:
+        return writer.append_spread(*book);
+    case QueryKind::midpoint:
+        return writer.append_midpoint(*book);
+    }
+}
+
+// --- QueryClient ---
+
+QueryClient::QueryClient(const std::string& host, uint16_t port, std::chrono::milliseconds timeout)
+    : socket_(net::open_socket(SOCK_STREAM, "query client socket")) {
+    auto address = net::endpoint(net::parse_address(host, "query server"), port);
+    net::set_timeouts(socket_.get(), timeout);
+    int on = 1;
+    ::setsockopt(socket_.get(), IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    if (::connect(socket_.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::system_error(errno, std::generic_category(),
+                                "Cannot connect to query server " + host + ":" + std::to_string(port));
+    }
+}
+
+Response QueryClient::query(std::span<const Query> queries) {
+    auto request_id = next_id_++;
+    auto request = encode_request(request_id, queries);
+    if (!net::send_all(socket_.get(), request.data(), request.size())) {
+        throw std::runtime_error("Query server connection lost");
+    }
+
+    char prefix[kFrameHeaderBytes];
+    if (!net::receive_all(socket_.get(), prefix, sizeof(prefix))) {
+        throw std::runtime_error("Query server connection lost");
+    }
+    buffer_.resize(little_endian::load<uint32_t>(prefix));
+    if (!net::receive_all(socket_.get(), buffer_.data(), buffer_.size())) {
+        throw std::runtime_error("Query server connection lost");
+    }
+    auto response = read_response(buffer_);
+    if (!response || response->request_id != request_id || response->results.size() != queries.size()) {
+        throw std::runtime_error("Malformed query response");
+    }
+    return std::move(*response);
+}
+
+} // namespace mde::infrastructure
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "infrastructure/QueryProtocol.hpp"
+#include "infrastructure/Sockets.hpp"
+#include "services/OrderBookService.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mde::infrastructure {
+
+struct QueryServerOptions {
+    std::string host = "0.0.0.0";
+    uint16_t port = 9200;  // 0 binds an ephemeral one (port())
+    // Event loops, each serving its share of the connections
+    size_t threads = 2;
+    // A request frame larger than this closes the connection
+    size_t max_request_bytes = 1 << 20;
+    // A connection stops being read while this much of its output is unsent
+    size_t max_pending_output = 4 << 20;
+};
+
+// Throws std::invalid_argument for a bad host, no threads or a zero limit
+void validate(const QueryServerOptions& options);
+
+// Answers book queries (QueryProtocol.hpp) over TCP: the current book or
+// its top levels, the spread and the midpoint, for any number of assets
+// per request. Each of `threads` event loops (epoll) accepts connections
+// and serves them without blocking, so slow clients only wait on their
+// own socket.
+//
+// Queries read OrderBookService::get_book_snapshot, the immutable book the
+// applying thread republishes after each event: after the first query for
+// an asset, answering it never takes the book lock, so queries neither
+// stall ingestion nor see a half-applied event. Each result is consistent
+// for its asset; results for different assets in one response may be from
+// slightly different points in the stream.
+class QueryServer {
+public:
+    // Binds at once; throws std::invalid_argument (see validate) or
+    // std::system_error if the port cannot be bound
+    QueryServer(const mde::services::OrderBookService& service, QueryServerOptions options = {});
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    // Throws std::system_error if an event loop cannot be set up
+    void start();
+    // Closes every connection and joins the loops
+    void stop();
+
+    uint16_t port() const noexcept { return port_; }
+
+    uint64_t connections_accepted() const noexcept { return accepted_.load(std::memory_order_relaxed); }
+    size_t connections_open() const noexcept { return open_.load(std::memory_order_relaxed); }
+    uint64_t requests_served() const noexcept { return requests_.load(std::memory_order_relaxed); }
+    uint64_t queries_served() const noexcept { return queries_.load(std::memory_order_relaxed); }
+    // Connections closed for a malformed or oversized request
+    uint64_t bad_requests() const noexcept { return bad_requests_.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection;
+
+    void run(int epoll);
+    // Parse and answer every whole request buffered on the connection;
+    // false if one was malformed
+    bool answer_requests(Connection& connection, std::vector<query::QueryView>& queries);
+    void answer(const query::QueryView& query, query::ResponseWriter& writer);
+
+    const mde::services::OrderBookService& service_;
+    QueryServerOptions options_;
+    net::Descriptor listener_;
+    uint16_t port_{0};
+
+    std::atomic<uint64_t> accepted_{0};
+    std::atomic<size_t> open_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> queries_{0};
+    std::atomic<uint64_t> bad_requests_{0};
+    std::atomic<bool> running_{false};
+    std::vector<net::Descriptor> epolls_;  // one per loop
+    std::vector<std::thread> loops_;
+};
+
+// Blocking client, one connection, for tools, tests and benchmarks. Not
+// thread-safe: give each thread its own.
+class QueryClient {
+public:
+    // Throws std::invalid_argument for a bad host and std::system_error if
+    // it cannot connect
+    QueryClient(const std::string& host, uint16_t port,
+                std::chrono::milliseconds timeout = std::chrono::seconds(5));
+
+    // One request, waiting for its response; throws std::runtime_error if
+    // the connection fails or the response is malformed
+    query::Response query(std::span<const query::Query> queries);
+
+private:
+    net::Descriptor socket_;
+    uint32_t next_id_{1};
+    std::string buffer_;
+};
+
+} // namespace mde::infrastructure
@@ -0,0 +1,102 @@
+#include "infrastructure/ReplayFeed.hpp"
+
+#include "telemetry/Latency.hpp"
+
+#include <chrono>
+#include <exception>
+#include <span>
+#include <stdexcept>
+
+namespace mde::infrastructure {
+
+ReplayFeed::ReplayFeed(const std::string& path, std::unique_ptr<IMessageParser> parser, ReplayOptions options)
+    : reader_(path), parser_(std::move(parser)), options_(options) {
+    if (!parser_) throw std::invalid_argument("ReplayFeed needs a parser");
+    if (!(options_.speed >= 0)) throw std::invalid_argument("Replay speed must be >= 0");
+    if (options_.passes == 0) throw std::invalid_argument("Replay passes must be > 0");
+}
+
+ReplayFeed::~ReplayFeed() {
+    stop();
+}
+
+void ReplayFeed::set_on_event(EventCallback callback) {
+    on_event_ = std::move(callback);
+    on_events_ = nullptr;
+}
+
+void ReplayFeed::set_on_events(BatchCallback callback) {
+    on_events_ = std::move(callback);
+    on_event_ = nullptr;
+}
+
+void ReplayFeed::start() {
+    if (thread_.joinable()) return;
+    stopping_ = false;
+    thread_ = std::thread([this] { run(); });
+}
+
+void ReplayFeed::stop() {
+    stopping_ = true;
+    if (thread_.joinable()) thread_.join();
+}
+
+void ReplayFeed::wait() {
+    if (thread_.joinable()) thread_.join();
+}
+
+void ReplayFeed::run() {
+    using clock = std::chrono::steady_clock;
+    finished_.store(false, std::memory_order_release);
+
+    // Each frame is due at its offset from the first frame of the capture,
+    // scaled by the speed; later passes continue from where the last ended
+    CapturedFrame frame;
+    auto start = clock::now();
+    std::chrono::nanoseconds pass_offset{0};
+    for (size_t pass = 0; pass < options_.passes && !stopping_; ++pass) {
+        reader_.rewind();
+        std::chrono::nanoseconds first{-1};
+        std::chrono::nanoseconds last{0};
+        while (!stopping_ && reader_.next(frame)) {
+            if (first.count() < 0) first = frame.received;
+            last = frame.received - first;
+            if (options_.speed > 0) {
+                auto due = start + std::chrono::duration_cast<clock::duration>(
+                                       (pass_offset + last) / options_.speed);
+                if (due > clock::now()) std::this_thread::sleep_until(due);
+            }
+            dispatch(frame);
+        }
+        pass_offset += last;
+    }
+    finished_.store(true, std::memory_order_release);
+}
+
+void ReplayFeed::dispatch(const CapturedFrame& frame) {
+    using mde::telemetry::Stage;
+
+    auto received = mde::telemetry::tsc_now();
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    bool well_formed = false;
+    try {
+        well_formed = parser_->parse(frame.text, batch_);
+    } catch (const std::exception&) {
+        // A live client would drop the frame too
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    mde::telemetry::record_since(Stage::parse, received);
+    if (!well_formed) failures_.fetch_add(1, std::memory_order_relaxed);
+    if (batch_.empty()) return;
+
+    events_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    if (on_events_) {
+        on_events_(std::span(batch_.begin(), batch_.end()));
+    } else if (on_event_) {
+        for (auto& event : batch_) on_event_(std::move(event));
+    }
+    mde::telemetry::record_since(Stage::end_to_end, received);
+}
+
+} // namespace mde::infrastructure
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "infrastructure/FrameCapture.hpp"
+#include "infrastructure/IMessageParser.hpp"
+#include "services/IMarketDataFeed.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace mde::infrastructure {
+
+struct ReplayOptions {
+    // Multiple of the recorded pace: 1 plays frames with their recorded
+    // gaps, 10 ten times faster; 0 plays them back to back
+    double speed = 1.0;
+    // Passes over the capture; later passes keep the recorded gaps but are
+    // otherwise the same frames again
+    size_t passes = 1;
+};
+
+// Feeds a frame capture through a parser, as PolymarketClient does with
+// live frames: one batch per frame, parse and end-to-end latency recorded
+// in the global LatencyRegistry. Stands in for the client to measure the
+// engine's sustained throughput without a connection. subscribe() is
+// ignored: the capture holds whatever was recorded.
+class ReplayFeed : public mde::services::IMarketDataFeed {
+public:
+    // Throws std::runtime_error if the capture can't be read and
+    // std::invalid_argument for a negative speed or zero passes
+    ReplayFeed(const std::string& path, std::unique_ptr<IMessageParser> parser, ReplayOptions options = {});
+    ~ReplayFeed() override;
+
+    ReplayFeed(const ReplayFeed&) = delete;
+    ReplayFeed& operator=(const ReplayFeed&) = delete;
+
+    void set_on_event(EventCallback callback) override;
+    void set_on_events(BatchCallback callback) override;
+    void subscribe(const std::string&) override {}
+
+    // start() replays on a thread of its own; run() on the caller's,
+    // returning once every pass is done or stop() is called
+    void start() override;
+    void stop() override;
+    void run();
+
+    // Blocks until a started replay has finished
+    void wait();
+    bool finished() const noexcept { return finished_.load(std::memory_order_acquire); }
+
+    uint64_t frames_replayed() const noexcept { return frames_.load(std::memory_order_relaxed); }
+    uint64_t events_replayed() const noexcept { return events_.load(std::memory_order_relaxed); }
+    // Frames dropped as malformed or with a field that failed to parse
+    uint64_t parse_failures() const noexcept { return failures_.load(std::memory_order_relaxed); }
+
+private:
+    void dispatch(const CapturedFrame& frame);
+
+    FrameReader reader_;
+    std::unique_ptr<IMessageParser> parser_;
+    ReplayOptions options_;
+    EventBatch batch_;
+    EventCallback on_event_;
+    BatchCallback on_events_;
+
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> finished_{false};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> events_{0};
+    std::atomic<uint64_t> failures_{0};
+};
+
+} // namespace mde::infrastructure
@@ -0,0 +1,279 @@
+#include "infrastructure/SharedBookRegion.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace mde::infrastructure {
+
+using namespace mde::domain;
+
+namespace {
+
+// Cell value for a token that will never get a slot
+constexpr uint32_t kNoSlot = 0xFFFFFFFF;
+
+template <typename T>
+std::atomic_ref<T> ref(T& value) noexcept {
+    return std::atomic_ref<T>(value);
+}
+
+// For loads through const views; the reader maps the region read-only,
+// and atomic loads never write
+template <typename T>
+std::atomic_ref<T> view(const T& value) noexcept {
+    return std::atomic_ref<T>(const_cast<T&>(value));
+}
+
+shm::SlotHeader& slot_at(std::byte* base, size_t slot_size, size_t slot) {
+    return *reinterpret_cast<shm::SlotHeader*>(base + sizeof(shm::Header) + slot * slot_size);
+}
+
+shm::Level* levels_of(shm::SlotHeader& slot) {
+    return reinterpret_cast<shm::Level*>(reinterpret_cast<std::byte*>(&slot) + sizeof(shm::SlotHeader));
+}
+
+uint32_t copy_side(const PriceLadder& ladder, shm::Level* out, size_t depth) {
+    uint32_t count = 0;
+    for (auto it = ladder.begin(); it != ladder.end() && count < depth; ++it, ++count) {
+        auto level = *it;
+        ref(out[count].price).store(level.price().micros(), std::memory_order_relaxed);
+        ref(out[count].size).store(level.size().units(), std::memory_order_relaxed);
+    }
+    return count;
+}
+
+} // namespace
+
+// --- SharedBookPublisher ---
+
+SharedBookPublisher::SharedBookPublisher(SharedBookOptions options)
+    : options_(std::move(options)) {
+    if (options_.name.empty()) throw std::invalid_argument("Shared book region needs a name");
+    if (options_.slots == 0 || options_.slots >= kNoSlot || options_.depth == 0) {
+        throw std::invalid_argument("Shared book region needs at least one slot and one level");
+    }
+
+    auto slot_size = shm::slot_size(options_.depth);
+    size_ = sizeof(shm::Header) + options_.slots * slot_size;
+
+    // A region left by an earlier run would still be mapped by its readers;
+    // they keep the old one, new readers get this one
+    ::shm_unlink(options_.name.c_str());
+    int fd = ::shm_open(options_.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot create shared memory " + options_.name);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+        int error = errno;
+        ::close(fd);
+        ::shm_unlink(options_.name.c_str());
+        throw std::system_error(error, std::generic_category(), "Cannot size shared memory " + options_.name);
+    }
+    void* mapped = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        int error = errno;
+        ::shm_unlink(options_.name.c_str());
+        throw std::system_error(error, std::generic_category(), "Cannot map shared memory " + options_.name);
+    }
+    base_ = static_cast<std::byte*>(mapped);
+
+    // ftruncate zero-fills, so every slot starts at version 0. Magic goes
+    // last: a reader that sees it sees the rest of the header.
+    auto& header = *reinterpret_cast<shm::Header*>(base_);
+    header.layout_version = shm::kLayoutVersion;
+    header.depth = static_cast<uint32_t>(options_.depth);
+    header.slot_count = static_cast<uint32_t>(options_.slots);
+    header.slot_size = static_cast<uint32_t>(slot_size);
+    ref(header.magic).store(shm::kMagic, std::memory_order_release);
+
+    size_t cells = 1;
+    while (cells < 2 * options_.slots) cells <<= 1;
+    table_ = std::make_unique<std::atomic<uint64_t>[]>(cells);
+    table_mask_ = cells - 1;
+}
+
+SharedBookPublisher::~SharedBookPublisher() {
+    if (base_) ::munmap(base_, size_);
+    ::shm_unlink(options_.name.c_str());
+}
+
+std::optional<uint32_t> SharedBookPublisher::slot_for(const AssetId& token) {
+    const uint64_t key = static_cast<uint64_t>(token.index()) + 1;
+    for (size_t probe = 0, cell = std::hash<AssetId>{}(token) & table_mask_; probe <= table_mask_;
+         ++probe, cell = (cell + 1) & table_mask_) {
+        auto value = table_[cell].load(std::memory_order_acquire);
+        if (value == 0) {
+            // Claim the cell before the slot so a lost race wastes neither
+            auto pending = key << 32 | kNoSlot;
+            if (!table_[cell].compare_exchange_strong(value, pending, std::memory_order_acq_rel)) {
+                if (value >> 32 != key) continue;
+            } else {
+                uint32_t slot = kNoSlot;
+                if (token.str().size() < shm::kTokenCapacity) {
+                    auto& used = reinterpret_cast<shm::Header*>(base_)->slots_used;
+                    auto taken = ref(used).load(std::memory_order_relaxed);
+                    while (taken < options_.slots &&
+                           !ref(used).compare_exchange_weak(taken, taken + 1, std::memory_order_acq_rel)) {
+                    }
+                    if (taken < options_.slots) slot = taken;
+                }
+                table_[cell].store(key << 32 | slot, std::memory_order_release);
+                if (slot == kNoSlot) return std::nullopt;
+                return slot;
+            }
+        }
+        if (value >> 32 != key) continue;
+        auto slot = static_cast<uint32_t>(value);
+        if (slot == kNoSlot) return std::nullopt;
+        return slot;
+    }
+    return std::nullopt;
+}
+
+bool SharedBookPublisher::publish(const OrderBook& book, bool stale) {
+    auto slot_index = slot_for(book.get_asset().token());
+    if (!slot_index) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    auto& slot = slot_at(base_, shm::slot_size(options_.depth), *slot_index);
+    auto version = ref(slot.version).load(std::memory_order_relaxed);
+    ref(slot.version).store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (version == 0) {
+        const auto& token = book.get_asset().token().str();
+        std::memcpy(slot.token, token.data(), token.size());
+        slot.token_length = static_cast<uint32_t>(token.size());
+    }
+    ref(slot.last_sequence_number).store(book.get_last_sequence_number(), std::memory_order_relaxed);
+    ref(slot.timestamp_ms).store(book.get_timestamp().milliseconds(), std::memory_order_relaxed);
+    ref(slot.flags).store(stale ? shm::kStale : 0u, std::memory_order_relaxed);
+    auto* levels = levels_of(slot);
+    ref(slot.bid_count).store(copy_side(book.get_bids(), levels, options_.depth), std::memory_order_relaxed);
+    ref(slot.ask_count).store(copy_side(book.get_asks(), levels + options_.depth, options_.depth),
+                              std::memory_order_relaxed);
+
+    ref(slot.version).store(version + 2, std::memory_order_release);
+    return true;
+}
+
+size_t SharedBookPublisher::slots_used() const noexcept {
+    const auto& header = *reinterpret_cast<const shm::Header*>(base_);
+    return std::min<size_t>(view(header.slots_used).load(std::memory_order_acquire), options_.slots);
+}
+
+// --- SharedBookReader ---
+
+SharedBookReader::SharedBookReader(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot open shared memory " + name);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "Cannot stat shared memory " + name);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    void* mapped = size_ >= sizeof(shm::Header) ? ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    int error = errno;
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::system_error(error, std::generic_category(), "Cannot map shared memory " + name);
+    }
+    base_ = static_cast<std::byte*>(mapped);
+
+    const auto& header = *reinterpret_cast<const shm::Header*>(base_);
+    if (view(header.magic).load(std::memory_order_acquire) != shm::kMagic ||
+        header.layout_version != shm::kLayoutVersion ||
+        header.slot_size != shm::slot_size(header.depth) ||
+        size_ < sizeof(shm::Header) + static_cast<size_t>(header.slot_count) * header.slot_size) {
+        ::munmap(base_, size_);
+        throw std::runtime_error("Not a book region of layout version " + std::to_string(shm::kLayoutVersion) +
+                                 ": " + name);
+    }
+    slot_count_ = header.slot_count;
+    slot_size_ = header.slot_size;
+    depth_ = header.depth;
+}
+
+SharedBookReader::~SharedBookReader() {
+    if (base_) ::munmap(base_, size_);
+}
+
+std::optional<uint32_t> SharedBookReader::find(std::string_view token) {
+    auto cached = slots_.find(std::string(token));
+    if (cached != slots_.end()) return cached->second;
+
+    // Index the slots bound since the last look, stopping at the first one
+    // whose token is not written yet
+    const auto& header = *reinterpret_cast<const shm::Header*>(base_);
+    auto used = std::min<size_t>(view(header.slots_used).load(std::memory_order_acquire), slot_count_);
+    std::optional<uint32_t> found;
+    for (; scanned_ < used; ++scanned_) {
+        auto& slot = slot_at(base_, slot_size_, scanned_);
+        auto version = ref(slot.version).load(std::memory_order_acquire);
+        if (version < 2) break;
+        // Stable once the first version is even
+        std::string slot_token(slot.token, std::min<size_t>(slot.token_length, shm::kTokenCapacity));
+        if (!found && slot_token == token) found = static_cast<uint32_t>(scanned_);
+        slots_.emplace(std::move(slot_token), static_cast<uint32_t>(scanned_));
+    }
+    return found;
+}
+
+bool SharedBookReader::read(uint32_t slot_index, SharedBook& out) const {
+    if (slot_index >= slot_count_) return false;
+    auto& slot = slot_at(base_, slot_size_, slot_index);
+    auto* levels = levels_of(slot);
+    while (true) {
+        auto version = ref(slot.version).load(std::memory_order_acquire);
+        if (version == 0) return false;
+        if (version & 1) continue;  // mid-update
+
+        out.last_sequence_number = ref(slot.last_sequence_number).load(std::memory_order_relaxed);
+        out.timestamp_ms = ref(slot.timestamp_ms).load(std::memory_order_relaxed);
+        out.stale = (ref(slot.flags).load(std::memory_order_relaxed) & shm::kStale) != 0;
+        auto bids = std::min<size_t>(ref(slot.bid_count).load(std::memory_order_relaxed), depth_);
+        auto asks = std::min<size_t>(ref(slot.ask_count).load(std::memory_order_relaxed), depth_);
+        out.bids.resize(bids);
+        out.asks.resize(asks);
+        for (size_t i = 0; i < bids; ++i) {
+            out.bids[i] = {ref(levels[i].price).load(std::memory_order_relaxed),
+                           ref(levels[i].size).load(std::memory_order_relaxed)};
+        }
+        for (size_t i = 0; i < asks; ++i) {
+            out.asks[i] = {ref(levels[depth_ + i].price).load(std::memory_order_relaxed),
+                           ref(levels[depth_ + i].size).load(std::memory_order_relaxed)};
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (ref(slot.version).load(std::memory_order_relaxed) != version) continue;
+        out.version = version;
+        out.token.assign(slot.token, std::min<size_t>(slot.token_length, shm::kTokenCapacity));
+        return true;
+    }
+}
+
+std::optional<SharedBook> SharedBookReader::read(std::string_view token) {
+    auto slot = find(token);
+    if (!slot) return std::nullopt;
+    SharedBook book;
+    if (!read(*slot, book)) return std::nullopt;
+    return book;
+}
+
+} // namespace mde::infrastructure
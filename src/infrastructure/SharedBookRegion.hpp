@@ -0,0 +1,166 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mde::infrastructure {
+
+// Layout of the POSIX shared-memory region SharedBookPublisher writes, for
+// readers in other processes (SharedBookReader, or any language that can map
+// the file and do acquire loads). Host byte order; every field is naturally
+// aligned and accessed as a lock-free atomic.
+//
+//   Header                               at offset 0, 64 bytes
+//   slot[0 .. slot_count)                at 64 + i * slot_size
+//     SlotHeader, then `depth` bid Levels (best first), then `depth` ask Levels
+//
+// Each slot holds one asset's book under a seqlock: `version` is odd while
+// the writer is updating the slot and even otherwise, 0 until the first
+// write. A reader loads version (acquire), copies what it needs, fences
+// (acquire) and loads version again; the copy is consistent if both loads
+// saw the same even value. The token is written once, before the first
+// version becomes even, and never changes, so a slot is bound to one asset
+// for the life of the region.
+namespace shm {
+
+inline constexpr uint64_t kMagic = 0x314B425348454D44;  // "MDESHBK1"
+inline constexpr uint32_t kLayoutVersion = 1;
+inline constexpr size_t kTokenCapacity = 96;
+inline constexpr uint32_t kStale = 1u << 0;  // SlotHeader::flags
+
+struct Header {
+    uint64_t magic;
+    uint32_t layout_version;
+    uint32_t depth;        // levels per side in every slot
+    uint32_t slot_count;
+    uint32_t slot_size;    // bytes, a multiple of 64
+    uint32_t slots_used;   // slots bound to an asset so far (atomic)
+    uint32_t reserved[9];
+};
+static_assert(sizeof(Header) == 64);
+
+struct Level {
+    int64_t price;  // micro-units (Price * 10^6)
+    int64_t size;   // micro-units (Quantity * 10^6)
+};
+
+struct SlotHeader {
+    uint64_t version;
+    uint64_t last_sequence_number;
+    int64_t timestamp_ms;
+    uint32_t bid_count;
+    uint32_t ask_count;
+    uint32_t flags;
+    uint32_t token_length;
+    char token[kTokenCapacity];
+};
+static_assert(sizeof(SlotHeader) % alignof(Level) == 0);
+
+// Bytes per slot for a depth, rounded up to a cache line
+constexpr size_t slot_size(size_t depth) {
+    return (sizeof(SlotHeader) + 2 * depth * sizeof(Level) + 63) / 64 * 64;
+}
+
+} // namespace shm
+
+struct SharedBookOptions {
+    std::string name;      // shm_open name, e.g. "/mde_books"
+    size_t slots = 1024;   // assets the region can hold
+    size_t depth = 10;     // levels per side
+};
+
+// Writer side: creates the region (replacing one left by an earlier run) and
+// unlinks it on destruction. publish() copies the top `depth` levels of a
+// book into its asset's slot, binding a free slot on first sight. Slots are
+// found through a fixed open-addressed table keyed by the token's interned
+// index, so publishing takes no lock and allocates nothing; calls for
+// different assets may run concurrently (one shard each), calls for one
+// asset must not overlap, which is what OrderBookService's update callback
+// guarantees. Assets beyond `slots`, or with a token longer than the slot
+// holds, are counted in rejected() and not published.
+class SharedBookPublisher {
+public:
+    // Throws std::invalid_argument for empty name or zero slots/depth, and
+    // std::system_error if the region cannot be created
+    explicit SharedBookPublisher(SharedBookOptions options);
+    ~SharedBookPublisher();
+
+    SharedBookPublisher(const SharedBookPublisher&) = delete;
+    SharedBookPublisher& operator=(const SharedBookPublisher&) = delete;
+
+    // Returns false for a rejected asset
+    bool publish(const mde::domain::OrderBook& book, bool stale = false);
+
+    size_t slots_used() const noexcept;
+    uint64_t rejected() const noexcept { return rejected_.load(std::memory_order_relaxed); }
+    const SharedBookOptions& options() const noexcept { return options_; }
+
+private:
+    // Slot bound to the token's index, binding the next free one on first
+    // sight; nullopt once the region is full
+    std::optional<uint32_t> slot_for(const mde::domain::AssetId& token);
+
+    SharedBookOptions options_;
+    size_t size_{0};
+    std::byte* base_{nullptr};
+    // (token index + 1) << 32 | slot, 0 for an empty cell
+    std::unique_ptr<std::atomic<uint64_t>[]> table_;
+    size_t table_mask_{0};
+    std::atomic<uint64_t> rejected_{0};
+};
+
+// One book as read from the region
+struct SharedBook {
+    std::string token;
+    uint64_t version{0};
+    uint64_t last_sequence_number{0};
+    int64_t timestamp_ms{0};
+    bool stale{false};
+    std::vector<shm::Level> bids;  // best first
+    std::vector<shm::Level> asks;
+};
+
+// Reader side: maps an existing region read-only. Reads spin only while the
+// writer is mid-update of that one slot. Not thread-safe (find() caches the
+// slots it has looked up); give each reading thread its own reader.
+class SharedBookReader {
+public:
+    // Throws std::system_error if the region does not exist, and
+    // std::runtime_error if it is not a book region of this layout
+    explicit SharedBookReader(const std::string& name);
+    ~SharedBookReader();
+
+    SharedBookReader(const SharedBookReader&) = delete;
+    SharedBookReader& operator=(const SharedBookReader&) = delete;
+
+    // Slot bound to the token, nullopt if the writer has not published it
+    std::optional<uint32_t> find(std::string_view token);
+    // Consistent copy of a slot into `out`, reusing its storage; false if
+    // the slot has never been written
+    bool read(uint32_t slot, SharedBook& out) const;
+    // find() then read()
+    std::optional<SharedBook> read(std::string_view token);
+
+    size_t slot_count() const noexcept { return slot_count_; }
+    size_t depth() const noexcept { return depth_; }
+
+private:
+    size_t size_{0};
+    std::byte* base_{nullptr};
+    size_t slot_count_{0};
+    size_t slot_size_{0};
+    size_t depth_{0};
+    size_t scanned_{0};  // slots already indexed in slots_
+    std::unordered_map<std::string, uint32_t> slots_;
+};
+
+} // namespace mde::infrastructure
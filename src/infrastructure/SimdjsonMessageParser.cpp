@@ -0,0 +1,208 @@
+#include "infrastructure/SimdjsonMessageParser.hpp"
+
+#include <simdjson.h>
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <system_error>
+
+using namespace mde::domain;
+namespace od = simdjson::ondemand;
+
+namespace mde::infrastructure {
+
+struct SimdjsonMessageParser::Impl {
+    od::parser parser;
+    // simdjson reads up to SIMDJSON_PADDING bytes past the end of the input;
+    // messages are copied here once instead of allocating a padded_string each time.
+    std::vector<char> buffer;
+};
+
+namespace {
+
+// Field lookups tolerate any key order, as the nlohmann backend does. A
+// missing or malformed field makes these return false, which drops the
+// message without throwing; malformed JSON is still found lazily, as a
+// simdjson_error.
+bool str(od::object& obj, std::string_view key, std::string_view& out) {
+    return obj.find_field_unordered(key).get_string().get(out) == simdjson::SUCCESS;
+}
+
+std::string_view str_or(od::object& obj, std::string_view key, std::string_view fallback) {
+    std::string_view value;
+    auto field = obj.find_field_unordered(key);
+    if (field.error() == simdjson::NO_SUCH_FIELD) return fallback;
+    if (field.get_string().get(value) != simdjson::SUCCESS) return fallback;
+    return value;
+}
+
+bool convert(std::string_view text, Price& out) noexcept { return Price::parse(text, out) == std::errc{}; }
+bool convert(std::string_view text, Quantity& out) noexcept { return Quantity::parse(text, out) == std::errc{}; }
+bool convert(std::string_view text, Side& out) noexcept { return parse_side(text, out) == std::errc{}; }
+bool convert(std::string_view text, Timestamp& out) noexcept { return Timestamp::parse(text, out) == std::errc{}; }
+
+template <typename T>
+bool read(od::object& obj, std::string_view key, T& out) {
+    std::string_view text;
+    return str(obj, key, text) && convert(text, out);
+}
+
+// The event's asset and timestamp; nullopt if one is missing or malformed
+std::optional<OrderBookEvent> header(od::object& obj) {
+    std::string_view market;
+    std::string_view token;
+    auto ts = Timestamp(0);
+    if (!str(obj, "market", market) || !str(obj, "asset_id", token) || !read(obj, "timestamp", ts) ||
+        market.empty() || token.empty()) {
+        return std::nullopt;
+    }
+    return OrderBookEvent{MarketAsset(AssetId(market), AssetId(token)), ts, 0};
+}
+
+bool parse_levels(od::object& obj, std::string_view key, std::vector<PriceLevel>& levels) {
+    for (auto entry : obj.find_field_unordered(key).get_array()) {
+        od::object level = entry.get_object();
+        auto price = Price::zero();
+        auto size = Quantity::zero();
+        if (!read(level, "price", price) || !read(level, "size", size)) return false;
+        levels.emplace_back(price, size);
+    }
+    return true;
+}
+
+bool parse_book_snapshot(od::object& obj, EventBatch& batch) {
+    auto event = header(obj);
+    if (!event) return false;
+
+    auto& snapshot = batch.add_snapshot(*event);
+    snapshot.hash.assign(str_or(obj, "hash", ""));
+    return parse_levels(obj, "bids", snapshot.bids) && parse_levels(obj, "asks", snapshot.asks);
+}
+
+// price_change can contain changes for multiple assets,
+// so we group by asset_id and add one BookDelta per asset.
+bool parse_price_change(od::object& obj, EventBatch& batch) {
+    std::string_view market_id;
+    auto ts = Timestamp(0);
+    if (!str(obj, "market", market_id) || !read(obj, "timestamp", ts) || market_id.empty()) return false;
+    AssetId market(market_id);
+
+    // Group changes by asset_id, keeping first-seen order
+    size_t first = batch.size();
+    for (auto entry : obj.find_field_unordered("price_changes").get_array()) {
+        od::object change = entry.get_object();
+        std::string_view token;
+        auto price = Price::zero();
+        auto size = Quantity::zero();
+        auto side = Side::BUY;
+        auto best_bid = Price::zero();
+        auto best_ask = Price::zero();
+        if (!str(change, "asset_id", token) || token.empty() || !read(change, "price", price) ||
+            !read(change, "size", size) || !read(change, "side", side) || !read(change, "best_bid", best_bid) ||
+            !read(change, "best_ask", best_ask)) {
+            return false;
+        }
+        AssetId asset_id(token);
+
+        BookDelta* delta = nullptr;
+        for (size_t i = first; i < batch.size(); ++i) {
+            auto& candidate = std::get<BookDelta>(batch[i]);
+            if (candidate.asset.token() == asset_id) {
+                delta = &candidate;
+                break;
+            }
+        }
+        if (!delta) {
+            delta = &batch.add_delta({MarketAsset(market, asset_id), ts, 0});
+        }
+        delta->changes.push_back(PriceLevelDelta{asset_id, price, size, side, best_bid, best_ask});
+    }
+    return true;
+}
+
+bool parse_trade_event(od::object& obj, EventBatch& batch) {
+    auto event = header(obj);
+    auto price = Price::zero();
+    auto size = Quantity::zero();
+    auto side = Side::BUY;
+    if (!event || !read(obj, "price", price) || !read(obj, "size", size) || !read(obj, "side", side)) {
+        return false;
+    }
+    std::string fee_rate_bps(str_or(obj, "fee_rate_bps", "0"));
+
+    batch.add(TradeEvent{*event, price, size, side, std::move(fee_rate_bps)});
+    return true;
+}
+
+bool parse_tick_size_change(od::object& obj, EventBatch& batch) {
+    auto event = header(obj);
+    auto old_tick = Price::zero();
+    auto new_tick = Price::zero();
+    if (!event || !read(obj, "old_tick_size", old_tick) || !read(obj, "new_tick_size", new_tick)) return false;
+
+    batch.add(TickSizeChange{*event, old_tick, new_tick});
+    return true;
+}
+
+// False for a missing or malformed field
+bool parse_object(od::object obj, EventBatch& batch) {
+    std::string_view event_type;
+    auto field = obj.find_field_unordered("event_type");
+    if (field.error() == simdjson::NO_SUCH_FIELD) return true;
+    if (field.get_string().get(event_type) != simdjson::SUCCESS) return true;
+
+    if (event_type == "book") return parse_book_snapshot(obj, batch);
+    if (event_type == "price_change") return parse_price_change(obj, batch);
+    if (event_type == "last_trade_price") return parse_trade_event(obj, batch);
+    if (event_type == "tick_size_change") return parse_tick_size_change(obj, batch);
+    return true;
+}
+
+} // anonymous namespace
+
+SimdjsonMessageParser::SimdjsonMessageParser() : impl_(std::make_unique<Impl>()) {}
+
+SimdjsonMessageParser::~SimdjsonMessageParser() = default;
+
+bool SimdjsonMessageParser::parse(std::string_view message, EventBatch& batch) {
+    batch.clear();
+    auto& buffer = impl_->buffer;
+    if (buffer.size() < message.size() + simdjson::SIMDJSON_PADDING) {
+        buffer.resize(message.size() + simdjson::SIMDJSON_PADDING);
+    }
+    std::memcpy(buffer.data(), message.data(), message.size());
+    std::memset(buffer.data() + message.size(), 0, simdjson::SIMDJSON_PADDING);
+
+    bool ok = true;
+    try {
+        od::document doc = impl_->parser.iterate(buffer.data(), message.size(), buffer.size());
+        od::json_type type = doc.type();
+
+        // Polymarket wraps messages in a JSON array
+        if (type == od::json_type::array) {
+            for (auto item : doc.get_array()) {
+                od::value value = item.value();
+                od::json_type item_type = value.type();
+                if (item_type == od::json_type::object && !parse_object(value.get_object(), batch)) {
+                    ok = false;
+                    break;
+                }
+            }
+        } else if (type == od::json_type::object) {
+            ok = parse_object(doc.get_object(), batch);
+        }
+    } catch (const simdjson::simdjson_error&) {
+        // Malformed JSON is detected lazily; drop the whole message like the nlohmann backend
+        batch.clear();
+        return false;
+    } catch (...) {
+        batch.clear();
+        throw;
+    }
+    if (!ok) batch.clear();  // no partial messages
+    return ok;
+}
+
+} // namespace mde::infrastructure
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "infrastructure/IMessageParser.hpp"
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace mde::infrastructure {
+
+// simdjson On-Demand backend. Walks the message in place and hands price and
+// size strings to the fixed-point parsers as string_views, without building
+// a DOM or copying field values into std::strings. Validation is as lazy as
+// the walk: a root that is neither an array nor an object is skipped unread,
+// so parse() reports false only for malformed JSON inside a message it reads.
+//
+// Holds parser state and a reusable padded input buffer, so one instance must
+// not be shared between threads.
+class SimdjsonMessageParser : public IMessageParser {
+public:
+    SimdjsonMessageParser();
+    ~SimdjsonMessageParser() override;
+
+    SimdjsonMessageParser(const SimdjsonMessageParser&) = delete;
+    SimdjsonMessageParser& operator=(const SimdjsonMessageParser&) = delete;
+
+    using IMessageParser::parse;
+    bool parse(std::string_view message, EventBatch& batch) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace mde::infrastructure
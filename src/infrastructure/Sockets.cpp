@@ -0,0 +1,87 @@
+#include "infrastructure/Sockets.hpp"
+
+#include <arpa/inet.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+namespace mde::infrastructure::net {
+
+void Descriptor::reset() noexcept {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+}
+
+in_addr parse_address(const std::string& host, const char* what) {
+    in_addr address{};
+    if (::inet_pton(AF_INET, host.c_str(), &address) != 1) {
+        throw std::invalid_argument(std::string("Invalid ") + what + " address: " + host);
+    }
+    return address;
+}
+
+sockaddr_in endpoint(in_addr address, uint16_t port) {
+    sockaddr_in out{};
+    out.sin_family = AF_INET;
+    out.sin_addr = address;
+    out.sin_port = htons(port);
+    return out;
+}
+
+Descriptor open_socket(int type, const char* what) {
+    Descriptor fd(::socket(AF_INET, type, 0));
+    if (fd.get() < 0) throw std::system_error(errno, std::generic_category(), std::string("Cannot open ") + what);
+    return fd;
+}
+
+Descriptor listen_on(const std::string& host, uint16_t port, int backlog, const char* what) {
+    auto listener = open_socket(SOCK_STREAM, what);
+    set_option(listener.get(), SOL_SOCKET, SO_REUSEADDR, 1, "SO_REUSEADDR");
+    auto local = endpoint(parse_address(host, what), port);
+    if (::bind(listener.get(), reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0 ||
+        ::listen(listener.get(), backlog) != 0) {
+        throw std::system_error(errno, std::generic_category(),
+                                std::string("Cannot listen on ") + host + ":" + std::to_string(port));
+    }
+    return listener;
+}
+
+uint16_t local_port(int fd) {
+    sockaddr_in local{};
+    socklen_t length = sizeof(local);
+    if (::getsockname(fd, reinterpret_cast<sockaddr*>(&local), &length) != 0) return 0;
+    return ntohs(local.sin_port);
+}
+
+void set_timeouts(int fd, std::chrono::milliseconds timeout) {
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    tv.tv_usec = static_cast<suseconds_t>(timeout.count() % 1000 * 1000);
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+bool send_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        auto sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool receive_all(int fd, char* data, size_t size) {
+    while (size > 0) {
+        auto received = ::recv(fd, data, size, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+} // namespace mde::infrastructure::net
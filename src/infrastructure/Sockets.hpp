@@ -0,0 +1,70 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <utility>
+
+// Thin helpers over POSIX IPv4 sockets for the binary feed and the query
+// server. Setup failures throw (std::invalid_argument for a bad address,
+// std::system_error otherwise); I/O helpers return false instead, as a
+// peer going away is routine.
+namespace mde::infrastructure::net {
+
+// Owns a file descriptor; -1 for none
+class Descriptor {
+public:
+    explicit Descriptor(int fd = -1) noexcept : fd_(fd) {}
+    ~Descriptor() { reset(); }
+    Descriptor(Descriptor&& other) noexcept : fd_(other.release()) {}
+    Descriptor& operator=(Descriptor&& other) noexcept {
+        if (this != &other) {
+            reset();
+            fd_ = other.release();
+        }
+        return *this;
+    }
+    Descriptor(const Descriptor&) = delete;
+    Descriptor& operator=(const Descriptor&) = delete;
+
+    int get() const noexcept { return fd_; }
+    int release() noexcept { return std::exchange(fd_, -1); }
+    void reset() noexcept;
+
+private:
+    int fd_;
+};
+
+// Dotted-quad address; `what` names it in the error
+in_addr parse_address(const std::string& host, const char* what);
+sockaddr_in endpoint(in_addr address, uint16_t port);
+
+// socket(AF_INET, type): SOCK_STREAM or SOCK_DGRAM
+Descriptor open_socket(int type, const char* what);
+
+template <typename T>
+void set_option(int fd, int level, int name, const T& value, const char* what) {
+    if (::setsockopt(fd, level, name, &value, sizeof(value)) != 0) {
+        throw std::system_error(errno, std::generic_category(), std::string("Cannot set ") + what);
+    }
+}
+
+// A TCP socket listening on host:port (0 = ephemeral, see local_port)
+Descriptor listen_on(const std::string& host, uint16_t port, int backlog, const char* what);
+uint16_t local_port(int fd);
+
+// Blocking calls on `fd` give up after the timeout
+void set_timeouts(int fd, std::chrono::milliseconds timeout);
+
+// Loop over partial writes and reads; false once the peer is gone or a
+// timeout expires
+bool send_all(int fd, const char* data, size_t size);
+bool receive_all(int fd, char* data, size_t size);
+
+} // namespace mde::infrastructure::net
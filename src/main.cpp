@@ -1,11 +1,23 @@
 #include "config/Settings.hpp"
+#include "infrastructure/BinaryFeed.hpp"
+#include "infrastructure/MessageParserFactory.hpp"
+#include "infrastructure/MetricsServer.hpp"
 #include "infrastructure/PolymarketClient.hpp"
+#include "infrastructure/QueryServer.hpp"
+#include "infrastructure/SharedBookRegion.hpp"
 #include "repositories/IOrderBookRepository.hpp"
 #include "repositories/InMemoryOrderBookRepository.hpp"
+#include "repositories/TieredOrderBookRepository.hpp"
 #include "services/OrderBookService.hpp"
+#include "services/analytics/AnalyticsService.hpp"
+#include "services/analytics/BarService.hpp"
+#include "telemetry/CpuAffinity.hpp"
+#include "telemetry/Latency.hpp"
+#include "telemetry/Metrics.hpp"
 
 #ifdef MDE_HAS_PARQUET
 #include "infrastructure/MarketDiscovery.hpp"
+#include "repositories/parquet/CachingFileSystem.hpp"
 #include "repositories/parquet/ParquetOrderBookRepository.hpp"
 #include <arrow/filesystem/localfs.h>
 #include <arrow/filesystem/s3fs.h>
@@ -13,12 +25,20 @@
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <csignal>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
 
 static std::atomic<bool> running{true};
 
@@ -53,6 +73,27 @@ int main(int argc, char* argv[]) {
 
     // Shared filesystem for both repo and discovery
     std::shared_ptr<arrow::fs::FileSystem> shared_fs;
+
+    // Non-owning view of repo for flush metrics
+    mde::repositories::pq::ParquetOrderBookRepository* parquet_repo = nullptr;
+
+    auto open_parquet = [&] {
+        if (!mde::config::ParquetWriterSettings::named(settings.storage.parquet.profile)) {
+            std::cerr << "Unknown Parquet profile: " << settings.storage.parquet.profile
+                      << " (expected default, fast or compact)" << std::endl;
+            return false;
+        }
+        try {
+            auto parquet = std::make_unique<mde::repositories::pq::ParquetOrderBookRepository>(
+                shared_fs, settings.storage);
+            parquet_repo = parquet.get();
+            repo = std::move(parquet);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    };
 #endif
 
     if (settings.storage.backend == "s3") {
@@ -64,8 +105,7 @@ int main(int argc, char* argv[]) {
         s3_guard = std::make_unique<S3Guard>();
         shared_fs = mde::repositories::pq::ParquetOrderBookRepository::make_s3_fs(
             settings.storage);
-        repo = std::make_unique<mde::repositories::pq::ParquetOrderBookRepository>(
-            shared_fs, settings.storage);
+        if (!open_parquet()) return 1;
 #else
         std::cerr << "S3 backend requested but not compiled in. "
                   << "Rebuild with Apache Arrow installed." << std::endl;
@@ -74,20 +114,194 @@ int main(int argc, char* argv[]) {
     } else if (settings.storage.backend == "parquet") {
 #ifdef MDE_HAS_PARQUET
         shared_fs = mde::repositories::pq::ParquetOrderBookRepository::make_local_fs(
-            settings.storage.data_directory);
-        repo = std::make_unique<mde::repositories::pq::ParquetOrderBookRepository>(
-            shared_fs, settings.storage);
+            settings.storage.data_directory, settings.storage.mmap_reads);
+        if (!open_parquet()) return 1;
 #else
         std::cerr << "Parquet backend requested but not compiled in. "
                   << "Rebuild with Apache Arrow installed." << std::endl;
         return 1;
 #endif
     } else {
-        repo = std::make_unique<mde::repositories::InMemoryOrderBookRepository>();
+        mde::repositories::InMemoryRetention retention;
+        retention.max_events_per_asset = static_cast<size_t>(std::max(settings.storage.memory_max_events, 0));
+        retention.max_age = std::chrono::seconds(std::max(settings.storage.memory_max_age_seconds, 0));
+        repo = std::make_unique<mde::repositories::InMemoryOrderBookRepository>(retention);
+    }
+
+    // Recent events from memory, older ones from the files
+    mde::repositories::TieredOrderBookRepository* tiered_repo = nullptr;
+    if ((settings.storage.backend == "parquet" || settings.storage.backend == "s3") &&
+        (settings.storage.hot_tail_events > 0 || settings.storage.hot_tail_age_seconds > 0)) {
+        mde::repositories::InMemoryRetention hot;
+        hot.max_events_per_asset = static_cast<size_t>(std::max(settings.storage.hot_tail_events, 0));
+        hot.max_age = std::chrono::seconds(std::max(settings.storage.hot_tail_age_seconds, 0));
+        std::unique_ptr<mde::repositories::IOrderBookRepository> cache;
+#ifdef MDE_HAS_PARQUET
+        if (settings.storage.backend == "s3" && !settings.storage.cache_directory.empty()) {
+            auto cache_settings = settings.storage;
+            cache_settings.wal_directory.clear();  // the S3 tier keeps the log
+            try {
+                cache = std::make_unique<mde::repositories::pq::ParquetOrderBookRepository>(
+                    mde::repositories::pq::ParquetOrderBookRepository::make_local_fs(
+                        settings.storage.cache_directory, settings.storage.mmap_reads),
+                    cache_settings);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << e.what() << std::endl;
+                return 1;
+            }
+        }
+#endif
+        auto tiered = std::make_unique<mde::repositories::TieredOrderBookRepository>(std::move(repo), hot,
+                                                                                     std::move(cache));
+        tiered_repo = tiered.get();
+        repo = std::move(tiered);
+    }
+
+    std::unique_ptr<mde::infrastructure::IMessageParser> parser;
+    try {
+        parser = mde::infrastructure::make_message_parser(settings.websocket.parser_backend);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    const auto& snapshot_mode = settings.service.snapshot_mode;
+    if (snapshot_mode != "per_asset" && snapshot_mode != "checkpoint") {
+        std::cerr << "Unknown snapshot mode: " << snapshot_mode
+                  << " (expected per_asset or checkpoint)" << std::endl;
+        return 1;
+    }
+    bool checkpoints = snapshot_mode == "checkpoint";
+
+    if (settings.websocket.connections < 1) {
+        std::cerr << "MDE_WS_CONNECTIONS must be >= 1" << std::endl;
+        return 1;
+    }
+    if (settings.websocket.reconnect_min_wait_ms < 0 ||
+        settings.websocket.reconnect_max_wait_ms < settings.websocket.reconnect_min_wait_ms) {
+        std::cerr << "MDE_WS_RECONNECT_MIN_MS and MDE_WS_RECONNECT_MAX_MS must satisfy 0 <= min <= max" << std::endl;
+        return 1;
+    }
+    mde::infrastructure::PolymarketClient client(settings.websocket, std::move(parser));
+    mde::services::OrderBookService service(
+        *repo, client,
+        checkpoints ? 0 : static_cast<uint64_t>(std::max(settings.service.snapshot_every_events, 0)),
+        static_cast<size_t>(std::max(settings.service.ingest_shards, 0)),
+        static_cast<size_t>(std::max(settings.service.ingest_queue_capacity, 1)),
+        checkpoints ? std::chrono::milliseconds(0)
+                    : std::chrono::seconds(std::max(settings.service.snapshot_interval_seconds, 0)),
+        mde::services::PipelineThreads{settings.service.shard_cpus, settings.service.writer_cpus,
+                                       settings.service.busy_poll});
+
+    // A book whose top disagrees with the exchange's is refetched through a
+    // fresh subscription; the flag clears when its snapshot arrives
+    service.set_on_divergence([&client](const mde::domain::MarketAsset& asset) {
+        client.resync(asset.token());
+    });
+    // Books on a dropped connection are stale until the resubscription on
+    // reconnect brings their snapshots
+    client.set_on_disconnect([&service](std::span<const std::string> token_ids) {
+        auto marked = service.mark_stale(token_ids);
+        std::cerr << "[client] Connection lost; " << marked << " books stale until resubscribed" << std::endl;
+    });
+
+    // Co-located readers map the region; every book update lands in its
+    // slot, including the books recovery installs
+    std::unique_ptr<mde::infrastructure::SharedBookPublisher> shared_books;
+    if (!settings.shared_memory.name.empty()) {
+        try {
+            shared_books = std::make_unique<mde::infrastructure::SharedBookPublisher>(
+                mde::infrastructure::SharedBookOptions{
+                    settings.shared_memory.name,
+                    static_cast<size_t>(std::max(settings.shared_memory.slots, 0)),
+                    static_cast<size_t>(std::max(settings.shared_memory.depth, 0))});
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        service.set_on_book_update([&shared_books](const mde::domain::OrderBook& book, bool stale) {
+            shared_books->publish(book, stale);
+        });
+        std::cout << "[shm] Publishing " << settings.shared_memory.depth << " levels for up to "
+                  << settings.shared_memory.slots << " books in " << settings.shared_memory.name << std::endl;
+    }
+
+    // Subscribed before start() so it sees every live event
+    std::unique_ptr<mde::services::analytics::AnalyticsService> analytics;
+    if (settings.analytics.enabled) {
+        mde::services::analytics::AnalyticsOptions options;
+        options.vwap_trades = static_cast<size_t>(std::max(settings.analytics.vwap_trades, 0));
+        options.volatility_returns = static_cast<size_t>(std::max(settings.analytics.volatility_returns, 0));
+        options.ewma_lambda = settings.analytics.ewma_lambda;
+        options.depth_ticks = settings.analytics.depth_ticks;
+        options.sweep_size = settings.analytics.sweep_size;
+        try {
+            analytics = std::make_unique<mde::services::analytics::AnalyticsService>(service.events(), options);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+#ifdef MDE_HAS_PARQUET
+    // Time bars, written to the Parquet store next to the raw events
+    std::unique_ptr<mde::services::analytics::BarService> bars;
+    if (settings.bars.enabled && parquet_repo) {
+        mde::services::analytics::BarOptions options;
+        auto intervals = mde::services::analytics::parse_bar_intervals(settings.bars.intervals);
+        if (!intervals) {
+            std::cerr << "MDE_BAR_INTERVALS must be a list like 1s,1m of ms, s, m or h counts" << std::endl;
+            return 1;
+        }
+        options.intervals_ms = std::move(*intervals);
+        options.grace_ms = settings.bars.grace_ms;
+        try {
+            bars = std::make_unique<mde::services::analytics::BarService>(
+                service.events(),
+                [parquet_repo](const std::vector<mde::domain::Bar>& closed) { parquet_repo->store_bars(closed); },
+                options, std::chrono::seconds(settings.bars.flush_interval_seconds));
+        } catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "[bars] Building " << settings.bars.intervals << " bars" << std::endl;
     }
+#endif
 
-    mde::infrastructure::PolymarketClient client(settings.websocket);
-    mde::services::OrderBookService service(*repo, client, settings.service.snapshot_interval_seconds);
+    // Every event, in the binary wire format, for downstream engines
+    std::unique_ptr<mde::infrastructure::BinaryPublisher> binary_feed;
+    if (!settings.binary_feed.group.empty()) {
+        mde::infrastructure::BinaryPublisherOptions options;
+        options.group = settings.binary_feed.group;
+        options.port = static_cast<uint16_t>(settings.binary_feed.port);
+        options.interface_address = settings.binary_feed.interface_address;
+        options.ttl = settings.binary_feed.ttl;
+        options.recovery_port = static_cast<uint16_t>(settings.binary_feed.recovery_port);
+        try {
+            binary_feed = std::make_unique<mde::infrastructure::BinaryPublisher>(service, options);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "[binary] Publishing to " << options.group << ":" << options.port << ", recovery on port "
+                  << binary_feed->recovery_port() << std::endl;
+    }
+
+    // Batched reads of the current books for other processes
+    std::unique_ptr<mde::infrastructure::QueryServer> query_server;
+    if (settings.query.port > 0) {
+        mde::infrastructure::QueryServerOptions options;
+        options.host = settings.query.host;
+        options.port = static_cast<uint16_t>(settings.query.port);
+        options.threads = static_cast<size_t>(std::max(settings.query.threads, 1));
+        try {
+            query_server = std::make_unique<mde::infrastructure::QueryServer>(service, options);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "[query] Serving on " << options.host << ":" << query_server->port() << std::endl;
+    }
 
     // Subscribe seed token if provided
     if (!seed_token_id.empty()) {
@@ -103,18 +317,155 @@ int main(int argc, char* argv[]) {
         discovery->load();
 
         // Subscribe all restored tracked IDs
-        for (const auto& id : discovery->tracked_token_ids()) {
-            service.subscribe(id);
-        }
+        service.subscribe_all(discovery->tracked_token_ids());
 
         std::cout << "[discovery] Restored " << discovery->tracked_count()
                   << " tracked markets" << std::endl;
     }
 #endif
 
+    // Warm start: rebuild books from stored snapshots before any live data
+    if (settings.service.recovery_threads > 0) {
+        std::vector<std::string> recover_ids;
+        if (!seed_token_id.empty()) recover_ids.push_back(seed_token_id);
+#ifdef MDE_HAS_PARQUET
+        if (discovery) {
+            for (const auto& id : discovery->tracked_token_ids()) {
+                if (id != seed_token_id) recover_ids.push_back(id);
+            }
+        }
+#endif
+        auto recovery = service.recover(
+            recover_ids, static_cast<size_t>(settings.service.recovery_threads));
+
+        std::chrono::microseconds slowest{0};
+        for (const auto& market : recovery.markets) {
+            slowest = std::max(slowest, market.duration);
+        }
+        std::cout << "[recovery] Restored " << recovery.recovered << "/" << recover_ids.size()
+                  << " books (" << recovery.from_checkpoint << " from checkpoint), replayed " << recovery.events_replayed << " events in "
+                  << recovery.total.count() / 1000.0 << " ms (slowest market "
+                  << slowest.count() / 1000.0 << " ms)" << std::endl;
+    }
+
+    // Gauges read at scrape time; declared after what they read so they are
+    // unregistered first
+    using mde::telemetry::MetricType;
+    auto& metrics = mde::telemetry::MetricsRegistry::global();
+    std::vector<mde::telemetry::MetricsRegistry::SampleHandle> samples;
+    samples.push_back(metrics.sample(MetricType::gauge, "mde_books_tracked", "Order books held by the service", {},
+                                     [&] { return static_cast<double>(service.book_count()); }));
+#ifdef MDE_HAS_PARQUET
+    if (tiered_repo) {
+        samples.push_back(metrics.sample(MetricType::gauge, "mde_hot_tail_events", "Events held by the in-memory tier",
+                                         {}, [&] { return static_cast<double>(tiered_repo->hot_events()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_tiered_reads_total", "Event reads each storage tier served",
+                                         {{"tier", "hot"}}, [&] { return static_cast<double>(tiered_repo->hot_reads()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_tiered_reads_total", "Event reads each storage tier served",
+                                         {{"tier", "warm"}}, [&] { return static_cast<double>(tiered_repo->warm_reads()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_tiered_reads_total", "Event reads each storage tier served",
+                                         {{"tier", "cold"}}, [&] { return static_cast<double>(tiered_repo->cold_reads()); }));
+    }
+    if (auto cache = std::dynamic_pointer_cast<mde::repositories::pq::CachingFileSystem>(shared_fs)) {
+        samples.push_back(metrics.sample(MetricType::counter, "mde_s3_cache_requests_total", "S3 file opens by cache outcome",
+                                         {{"outcome", "hit"}}, [cache] { return static_cast<double>(cache->hits()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_s3_cache_requests_total", "S3 file opens by cache outcome",
+                                         {{"outcome", "miss"}}, [cache] { return static_cast<double>(cache->misses()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_s3_cache_evictions_total", "Files evicted from the S3 cache",
+                                         {}, [cache] { return static_cast<double>(cache->evictions()); }));
+        samples.push_back(metrics.sample(MetricType::gauge, "mde_s3_cache_bytes", "Bytes held by the S3 cache", {},
+                                         [cache] { return static_cast<double>(cache->bytes_cached()); }));
+    }
+    if (parquet_repo) {
+        samples.push_back(metrics.sample(MetricType::counter, "mde_flush_files_total", "Event files written", {},
+                                         [&] { return static_cast<double>(parquet_repo->flush_stats().files_written); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_flush_bytes_total", "Bytes of event files written", {},
+                                         [&] { return static_cast<double>(parquet_repo->flush_stats().bytes_written); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_flush_failures_total", "Event file writes that failed", {},
+                                         [&] { return static_cast<double>(parquet_repo->flush_stats().failed_writes); }));
+        samples.push_back(metrics.sample(MetricType::gauge, "mde_flush_queue_depth", "Event files queued or being written", {},
+                                         [&] { return static_cast<double>(parquet_repo->flush_stats().queue_depth); }));
+        const char* const event_types[] = {"book_snapshot", "book_delta", "trade_event", "tick_size_change"};
+        for (size_t i = 0; i < std::size(event_types); ++i) {
+            samples.push_back(metrics.sample(
+                MetricType::gauge, "mde_buffered_events", "Events buffered for the next flush",
+                {{"type", event_types[i]}},
+                [&, i] { return static_cast<double>(parquet_repo->flush_stats().buffered_events[i]); }));
+        }
+    }
+#endif
+    if (shared_books) {
+        samples.push_back(metrics.sample(MetricType::gauge, "mde_shm_slots_used", "Shared-memory book slots bound to an asset", {},
+                                         [&] { return static_cast<double>(shared_books->slots_used()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_shm_rejected_total",
+                                         "Book updates with no shared-memory slot", {},
+                                         [&] { return static_cast<double>(shared_books->rejected()); }));
+    }
+    if (binary_feed) {
+        samples.push_back(metrics.sample(MetricType::counter, "mde_binary_packets_sent_total", "Binary feed packets sent", {},
+                                         [&] { return static_cast<double>(binary_feed->packets_sent()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_binary_send_errors_total",
+                                         "Binary feed packets the socket refused", {},
+                                         [&] { return static_cast<double>(binary_feed->send_errors()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_binary_dropped_total",
+                                         "Events the binary feed fell behind on or could not fit a packet", {},
+                                         [&] { return static_cast<double>(binary_feed->events_dropped()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_binary_recoveries_total",
+                                         "Binary feed recovery requests served", {{"kind", "retransmit"}},
+                                         [&] { return static_cast<double>(binary_feed->retransmits_served()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_binary_recoveries_total",
+                                         "Binary feed recovery requests served", {{"kind", "snapshot"}},
+                                         [&] { return static_cast<double>(binary_feed->snapshots_served()); }));
+    }
+    if (query_server) {
+        samples.push_back(metrics.sample(MetricType::gauge, "mde_query_connections", "Open query API connections", {},
+                                         [&] { return static_cast<double>(query_server->connections_open()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_query_requests_total", "Query API requests answered",
+                                         {}, [&] { return static_cast<double>(query_server->requests_served()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_query_queries_total",
+                                         "Queries answered across all requests", {},
+                                         [&] { return static_cast<double>(query_server->queries_served()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_query_bad_requests_total",
+                                         "Query API connections closed for a malformed request", {},
+                                         [&] { return static_cast<double>(query_server->bad_requests()); }));
+    }
+    if (analytics) {
+        samples.push_back(metrics.sample(MetricType::counter, "mde_analytics_dropped_total",
+                                         "Events the analytics consumer fell behind on", {},
+                                         [&] { return static_cast<double>(analytics->events_dropped()); }));
+    }
+#ifdef MDE_HAS_PARQUET
+    if (bars) {
+        samples.push_back(metrics.sample(MetricType::counter, "mde_bars_written_total", "Time bars written", {},
+                                         [&] { return static_cast<double>(bars->bars_written()); }));
+        samples.push_back(metrics.sample(MetricType::counter, "mde_bars_dropped_total",
+                                         "Events the bar builder fell behind on", {},
+                                         [&] { return static_cast<double>(bars->events_dropped()); }));
+    }
+#endif
+
+    std::unique_ptr<mde::infrastructure::MetricsServer> metrics_server;
+    if (settings.metrics.port > 0) {
+        metrics_server = std::make_unique<mde::infrastructure::MetricsServer>(settings.metrics.port, settings.metrics.host);
+        try {
+            metrics_server->start();
+        } catch (const std::runtime_error& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "[metrics] Serving http://" << settings.metrics.host << ":" << settings.metrics.port
+                  << "/metrics" << std::endl;
+    }
+
     std::signal(SIGINT, signal_handler);
 
     service.start();
+    if (analytics) analytics->start();
+#ifdef MDE_HAS_PARQUET
+    if (bars) bars->start();
+#endif
+    if (binary_feed) binary_feed->start();
+    if (query_server) query_server->start();
     std::cout << "[engine] Started" << std::endl;
 
 #ifdef MDE_HAS_PARQUET
@@ -122,13 +473,16 @@ int main(int argc, char* argv[]) {
     std::thread discovery_thread;
     if (discovery) {
         discovery_thread = std::thread([&]() {
+            mde::telemetry::pin_current_thread(settings.service.background_cpus, "discovery");
             while (running) {
                 try {
-                    size_t added = discovery->poll([&](const std::vector<std::string>& new_ids) {
-                        for (const auto& id : new_ids) {
-                            service.subscribe(id);
-                        }
-                    });
+                    size_t added = discovery->poll(
+                        [&](const std::vector<std::string>& new_ids) { service.subscribe_all(new_ids); },
+                        [&](const std::vector<std::string>& closed_ids) {
+                            auto dropped = service.retire(closed_ids);
+                            std::cout << "[discovery] Retired " << closed_ids.size() << " closed markets, "
+                                      << dropped << " books dropped" << std::endl;
+                        });
                     if (added > 0) {
                         std::cout << "[discovery] Added " << added << " new markets, total="
                                   << discovery->tracked_count() << std::endl;
@@ -144,11 +498,39 @@ int main(int argc, char* argv[]) {
             }
         });
     }
+
+    // Compaction thread: merges the small files flushes leave behind
+    std::thread compaction_thread;
+    if (parquet_repo && settings.storage.compaction_interval_seconds > 0) {
+        compaction_thread = std::thread([&]() {
+            mde::telemetry::pin_current_thread(settings.service.background_cpus, "compaction");
+            while (running) {
+                for (int i = 0; i < settings.storage.compaction_interval_seconds && running; ++i) {
+                    std::this_thread::sleep_for(std::chrono::seconds(1));
+                }
+                if (!running) break;
+                try {
+                    auto compaction = parquet_repo->compact();
+                    if (compaction.files_written > 0) {
+                        std::cout << "[compaction] Merged " << compaction.files_merged
+                                  << " files into " << compaction.files_written << " ("
+                                  << compaction.events_rewritten << " events)" << std::endl;
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "[compaction] Error: " << e.what() << std::endl;
+                }
+            }
+        });
+    }
 #endif
 
-    // Log-mode stats loop
+    // Log-mode stats loop; latency percentiles cover the last interval
+    using mde::telemetry::LatencyRegistry;
+    using mde::telemetry::LatencySummary;
+    std::array<mde::telemetry::HistogramSnapshot, mde::telemetry::kStages.size()> last_latencies;
     uint64_t last_event_count = 0;
     auto last_stats_time = std::chrono::steady_clock::now();
+    auto last_checkpoint_time = last_stats_time;
 
     while (running) {
         std::this_thread::sleep_for(std::chrono::seconds(10));
@@ -161,20 +543,74 @@ int main(int argc, char* argv[]) {
 
         std::cout << "[stats] markets=" << service.book_count()
                   << " events/sec=" << static_cast<int>(events_per_sec)
-                  << " total_events=" << current_events
-                  << std::endl;
+                  << " total_events=" << current_events;
+        size_t connections_up = 0;
+        for (const auto& connection : client.connection_health()) {
+            if (connection.connected) ++connections_up;
+        }
+        std::cout << " ws_connected=" << connections_up << "/" << client.connection_count()
+                  << " divergences=" << service.divergence_count()
+                  << " stale_books=" << service.stale_assets().size();
+#ifdef MDE_HAS_PARQUET
+        if (parquet_repo) {
+            auto flush = parquet_repo->flush_stats();
+            std::cout << " flush_queue=" << flush.queue_depth
+                      << " flush_max_ms=" << flush.max_latency.count() / 1000.0
+                      << " flush_stalls=" << flush.backpressure_waits;
+        }
+#endif
+        if (analytics) {
+            std::cout << " analytics_markets=" << analytics->all_metrics().size()
+                      << " analytics_dropped=" << analytics->events_dropped();
+        }
+        std::cout << std::endl;
+
+        for (size_t i = 0; i < mde::telemetry::kStages.size(); ++i) {
+            auto stage = mde::telemetry::kStages[i];
+            auto current = LatencyRegistry::global().snapshot(stage);
+            auto window = LatencySummary::of(current.since(last_latencies[i]));
+            last_latencies[i] = std::move(current);
+            if (window.count == 0) continue;
+            std::cout << "[latency] " << mde::telemetry::stage_name(stage) << std::fixed << std::setprecision(1)
+                      << " p50_us=" << window.p50_ns / 1000.0
+                      << " p99_us=" << window.p99_ns / 1000.0
+                      << " p999_us=" << window.p999_ns / 1000.0
+                      << " max_us=" << window.max_ns / 1000.0
+                      << " n=" << window.count << std::defaultfloat << std::endl;
+        }
 
         last_event_count = current_events;
         last_stats_time = now;
-    }
 
-    service.stop();
+        if (checkpoints && now - last_checkpoint_time >=
+                               std::chrono::seconds(settings.service.checkpoint_interval_seconds)) {
+            service.checkpoint();
+            last_checkpoint_time = now;
+        }
+    }
 
 #ifdef MDE_HAS_PARQUET
+    // Before the service stops, so no poll subscribes to or retires from
+    // a stopped service
     if (discovery_thread.joinable()) {
         discovery_thread.join();
     }
+    if (compaction_thread.joinable()) {
+        compaction_thread.join();
+    }
+#endif
+
+    if (metrics_server) metrics_server->stop();
+    service.stop();
+    if (analytics) analytics->stop();
+#ifdef MDE_HAS_PARQUET
+    if (bars) bars->stop();
 #endif
+    if (binary_feed) binary_feed->stop();
+    if (query_server) query_server->stop();
+    if (checkpoints) {
+        std::cout << "[engine] Checkpointed " << service.checkpoint() << " books" << std::endl;
+    }
 
     std::cout << "\n[engine] Done. Processed " << service.event_count() << " events." << std::endl;
     return 0;
@@ -2,23 +2,77 @@
 
 #include "domain/aggregates/OrderBook.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
+#include <iterator>
 #include <optional>
+#include <span>
+#include <string>
+#include <variant>
 #include <vector>
 
 namespace mde::repositories {
 
+// Implementations the service writes to must be thread-safe: it appends
+// from its event path while other threads store snapshots and checkpoints.
 class IOrderBookRepository {
 public:
     // Event storage (source of truth)
     virtual void append_event(const mde::domain::OrderBookEventVariant& event) = 0;
+    // Takes ownership instead of copying; the default falls back to the copy
+    virtual void append_event(mde::domain::OrderBookEventVariant&& event) {
+        append_event(static_cast<const mde::domain::OrderBookEventVariant&>(event));
+    }
+    // Takes ownership of a run of events, in sequence order; implementations
+    // may store them under one lock. The default appends them one at a time.
+    virtual void append_events(std::span<mde::domain::OrderBookEventVariant> events) {
+        for (auto& event : events) append_event(std::move(event));
+    }
     virtual std::vector<mde::domain::OrderBookEventVariant> get_events_since(
         const mde::domain::MarketAsset& asset, uint64_t sequence_number) const = 0;
 
+    // Stream every event of `assets` after sequence_number to visit, in
+    // sequence order, and return how many were visited; visit returns false
+    // to stop. Unlike get_events_since, implementations need not hold the
+    // whole result in memory. The default merges get_events_since per asset.
+    using EventVisitor = std::function<bool(mde::domain::OrderBookEventVariant&& event)>;
+    virtual size_t replay_events(const std::vector<mde::domain::MarketAsset>& assets,
+                                 uint64_t sequence_number, const EventVisitor& visit) const {
+        auto seq_of = [](const auto& event) {
+            return std::visit([](const auto& e) { return e.sequence_number; }, event);
+        };
+        std::vector<mde::domain::OrderBookEventVariant> events;
+        for (const auto& asset : assets) {
+            auto tail = get_events_since(asset, sequence_number);
+            auto middle = events.insert(events.end(), std::make_move_iterator(tail.begin()),
+                                        std::make_move_iterator(tail.end()));
+            std::inplace_merge(events.begin(), middle, events.end(),
+                               [&](const auto& a, const auto& b) { return seq_of(a) < seq_of(b); });
+        }
+        size_t visited = 0;
+        for (auto& event : events) {
+            ++visited;
+            if (!visit(std::move(event))) break;
+        }
+        return visited;
+    }
+    // Highest sequence number of any stored event, 0 if none; recovery
+    // resumes numbering after it
+    virtual uint64_t max_sequence_number() const = 0;
+
     // Snapshot storage (projection for fast reads)
     virtual void store_snapshot(const mde::domain::OrderBook& book) = 0;
     virtual std::optional<mde::domain::OrderBook> get_latest_snapshot(
         const mde::domain::MarketAsset& asset) const = 0;
+    // For recovery, where only the token_id is known; the book carries the asset
+    virtual std::optional<mde::domain::OrderBook> get_latest_snapshot_by_token(
+        const std::string& token_id) const = 0;
+
+    // Checkpoints: every book written together and read back in one call.
+    // A new checkpoint replaces the previous one; empty when none was stored.
+    virtual void store_checkpoint(const std::vector<mde::domain::OrderBook>& books) = 0;
+    virtual std::vector<mde::domain::OrderBook> load_checkpoint() const = 0;
 
     virtual ~IOrderBookRepository() = default;
 };
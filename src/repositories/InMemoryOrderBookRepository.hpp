@@ -2,54 +2,242 @@
 
 #include "repositories/IOrderBookRepository.hpp"
 
-#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
 namespace mde::repositories {
 
+// How much event history the in-memory repository keeps per asset; the
+// default keeps everything. Older events are dropped as new ones arrive.
+struct InMemoryRetention {
+    size_t max_events_per_asset = 0;  // 0 = no limit
+    // Events older than the asset's newest by more than this (event time) are
+    // dropped; 0 = no limit
+    std::chrono::milliseconds max_age{0};
+};
+
+// Events are held per asset, in sequence order, each asset in its own ring
+// buffer, so get_events_since is a binary search into one asset's history
+// rather than a scan of every event. Like the service's other repositories
+// it expects sequence numbers to increase per asset. Thread-safe: writes
+// take one lock, reads share it.
 class InMemoryOrderBookRepository : public mde::repositories::IOrderBookRepository {
 public:
+    explicit InMemoryOrderBookRepository(InMemoryRetention retention = {})
+        : retention_(retention) {}
+
     void append_event(const mde::domain::OrderBookEventVariant& event) override {
-        events_.push_back(event);
+        append_event(mde::domain::OrderBookEventVariant(event));
+    }
+
+    void append_event(mde::domain::OrderBookEventVariant&& event) override {
+        std::unique_lock lock(mutex_);
+        append_locked(std::move(event));
+    }
+
+    void append_events(std::span<mde::domain::OrderBookEventVariant> events) override {
+        std::unique_lock lock(mutex_);
+        for (auto& event : events) append_locked(std::move(event));
     }
 
     std::vector<mde::domain::OrderBookEventVariant> get_events_since(
         const mde::domain::MarketAsset& asset, uint64_t sequence_number) const override {
         std::vector<mde::domain::OrderBookEventVariant> result;
-        for (const auto& event : events_) {
-            const auto& e_asset = std::visit(
-                [](const auto& e) -> const mde::domain::MarketAsset& { return e.asset; }, event);
-            auto e_seq = std::visit(
-                [](const auto& e) { return e.sequence_number; }, event);
-            if (e_asset == asset && e_seq > sequence_number) {
-                result.push_back(event);
+        std::shared_lock lock(mutex_);
+        auto it = histories_.find(asset);
+        if (it == histories_.end()) return result;
+        const auto& history = it->second;
+        // First event after sequence_number
+        size_t low = 0, high = history.size();
+        while (low < high) {
+            auto mid = low + (high - low) / 2;
+            if (sequence_of(history[mid]) <= sequence_number) {
+                low = mid + 1;
+            } else {
+                high = mid;
             }
         }
+        result.reserve(history.size() - low);
+        for (auto i = low; i < history.size(); ++i) result.push_back(history[i]);
         return result;
     }
 
+    // Kept past retention, so dropped events count too
+    uint64_t max_sequence_number() const override {
+        std::shared_lock lock(mutex_);
+        return max_sequence_;
+    }
+
     void store_snapshot(const mde::domain::OrderBook& book) override {
+        std::unique_lock lock(mutex_);
         snapshots_.insert_or_assign(book.get_asset(), book);
     }
 
     std::optional<mde::domain::OrderBook> get_latest_snapshot(
         const mde::domain::MarketAsset& asset) const override {
+        std::shared_lock lock(mutex_);
         auto it = snapshots_.find(asset);
         if (it != snapshots_.end()) return it->second;
         return std::nullopt;
     }
 
+    std::optional<mde::domain::OrderBook> get_latest_snapshot_by_token(
+        const std::string& token_id) const override {
+        std::shared_lock lock(mutex_);
+        for (const auto& [asset, book] : snapshots_) {
+            if (asset.token_id() == token_id) return book;
+        }
+        return std::nullopt;
+    }
+
+    void store_checkpoint(const std::vector<mde::domain::OrderBook>& books) override {
+        std::unique_lock lock(mutex_);
+        checkpoint_ = books;
+        ++checkpoint_count_;
+    }
+
+    std::vector<mde::domain::OrderBook> load_checkpoint() const override {
+        std::shared_lock lock(mutex_);
+        return checkpoint_;
+    }
+
+    // Events currently held, across every asset
+    size_t event_count() const {
+        std::shared_lock lock(mutex_);
+        return count_;
+    }
+    // Sequence number of the newest event of `asset` retention has dropped
+    // (0 if none): every later one is still held
+    uint64_t dropped_through(const mde::domain::MarketAsset& asset) const {
+        std::shared_lock lock(mutex_);
+        auto it = histories_.find(asset);
+        return it == histories_.end() ? 0 : it->second.dropped_through();
+    }
+
     // Test helpers
-    size_t event_count() const { return events_.size(); }
-    const std::vector<mde::domain::OrderBookEventVariant>& events() const { return events_; }
+    // Every held event, in sequence order
+    std::vector<mde::domain::OrderBookEventVariant> events() const {
+        std::vector<mde::domain::OrderBookEventVariant> all;
+        {
+            std::shared_lock lock(mutex_);
+            all.reserve(count_);
+            for (const auto& [asset, history] : histories_) {
+                for (size_t i = 0; i < history.size(); ++i) all.push_back(history[i]);
+            }
+        }
+        std::stable_sort(all.begin(), all.end(),
+                         [](const auto& a, const auto& b) { return sequence_of(a) < sequence_of(b); });
+        return all;
+    }
     bool has_snapshot(const mde::domain::MarketAsset& asset) const {
+        std::shared_lock lock(mutex_);
         return snapshots_.count(asset) > 0;
     }
-
+    size_t snapshot_count() const {
+        std::shared_lock lock(mutex_);
+        return snapshots_.size();
+    }
+    size_t checkpoint_count() const {
+        std::shared_lock lock(mutex_);
+        return checkpoint_count_;
+    }
 private:
-    std::vector<mde::domain::OrderBookEventVariant> events_;
-    std::map<mde::domain::MarketAsset, mde::domain::OrderBook> snapshots_;
+    // One asset's events, oldest first, in a circular buffer. It grows by
+    // doubling up to `capacity` (0 = without limit); once full, each push
+    // overwrites the oldest event. Dropped slots are emptied so their level
+    // vectors are freed at once.
+    class History {
+    public:
+        size_t size() const { return size_; }
+        uint64_t dropped_through() const { return dropped_through_; }
+
+        const mde::domain::OrderBookEventVariant& front() const { return *slots_[head_]; }
+        const mde::domain::OrderBookEventVariant& operator[](size_t i) const {
+            return *slots_[(head_ + i) % slots_.size()];
+        }
+
+        void push(mde::domain::OrderBookEventVariant&& event, size_t capacity) {
+            if (size_ == slots_.size()) {
+                if (capacity > 0 && size_ >= capacity) {
+                    dropped_through_ = sequence_of(*slots_[head_]);
+                    slots_[head_] = std::move(event);
+                    head_ = (head_ + 1) % slots_.size();
+                    return;
+                }
+                grow(capacity);
+            }
+            slots_[(head_ + size_) % slots_.size()] = std::move(event);
+            ++size_;
+        }
+
+        void pop_front() {
+            dropped_through_ = sequence_of(*slots_[head_]);
+            slots_[head_].reset();
+            head_ = (head_ + 1) % slots_.size();
+            --size_;
+        }
+
+    private:
+        void grow(size_t capacity) {
+            auto target = std::max<size_t>(8, slots_.size() * 2);
+            if (capacity > 0) target = std::min(target, capacity);
+            std::vector<std::optional<mde::domain::OrderBookEventVariant>> slots(target);
+            for (size_t i = 0; i < size_; ++i) slots[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+            slots_ = std::move(slots);
+            head_ = 0;
+        }
+
+        std::vector<std::optional<mde::domain::OrderBookEventVariant>> slots_;
+        size_t head_{0};
+        size_t size_{0};
+        uint64_t dropped_through_{0};
+    };
+
+    // Callers hold mutex_ exclusively
+    void append_locked(mde::domain::OrderBookEventVariant&& event) {
+        const auto& asset = std::visit(
+            [](const auto& e) -> const mde::domain::MarketAsset& { return e.asset; }, event);
+        auto it = histories_.find(asset);
+        if (it == histories_.end()) it = histories_.emplace(asset, History{}).first;
+        auto& history = it->second;
+
+        max_sequence_ = std::max(max_sequence_, sequence_of(event));
+        auto newest = timestamp_of(event);
+        count_ -= history.size();
+        history.push(std::move(event), retention_.max_events_per_asset);
+        if (retention_.max_age.count() > 0) {
+            auto horizon = newest.milliseconds() - retention_.max_age.count();
+            while (history.size() > 1 && timestamp_of(history.front()).milliseconds() < horizon) {
+                history.pop_front();
+            }
+        }
+        count_ += history.size();
+    }
+
+    static uint64_t sequence_of(const mde::domain::OrderBookEventVariant& event) {
+        return std::visit([](const auto& e) { return e.sequence_number; }, event);
+    }
+    static mde::domain::Timestamp timestamp_of(const mde::domain::OrderBookEventVariant& event) {
+        return std::visit([](const auto& e) { return e.timestamp; }, event);
+    }
+
+    InMemoryRetention retention_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<mde::domain::MarketAsset, History> histories_;
+    size_t count_{0};
+    uint64_t max_sequence_{0};
+    std::unordered_map<mde::domain::MarketAsset, mde::domain::OrderBook> snapshots_;
+    std::vector<mde::domain::OrderBook> checkpoint_;
+    size_t checkpoint_count_{0};
 };
 
 } // namespace mde::repositories
@@ -0,0 +1,149 @@
+#include "repositories/TieredOrderBookRepository.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace mde::repositories {
+
+using namespace mde::domain;
+
+namespace {
+
+uint64_t sequence_of(const OrderBookEventVariant& event) {
+    return std::visit([](const auto& e) { return e.sequence_number; }, event);
+}
+
+} // namespace
+
+TieredOrderBookRepository::TieredOrderBookRepository(std::unique_ptr<IOrderBookRepository> cold,
+                                                     InMemoryRetention hot,
+                                                     std::unique_ptr<IOrderBookRepository> warm)
+    : cold_(std::move(cold))
+    , warm_(std::move(warm))
+    , hot_(hot) {
+    if (!cold_) throw std::invalid_argument("Tiered repository needs a cold store");
+}
+
+void TieredOrderBookRepository::append_event(const OrderBookEventVariant& event) {
+    append_event(OrderBookEventVariant(event));
+}
+
+void TieredOrderBookRepository::append_event(OrderBookEventVariant&& event) {
+    // The cold store takes the event; the tiers above keep copies
+    OrderBookEventVariant copy(event);
+    if (warm_) warm_->append_event(copy);
+    cold_->append_event(std::move(event));
+    append_hot({&copy, 1});
+}
+
+void TieredOrderBookRepository::append_events(std::span<OrderBookEventVariant> events) {
+    if (events.empty()) return;
+    std::vector<OrderBookEventVariant> copies(events.begin(), events.end());
+    if (warm_) {
+        std::vector<OrderBookEventVariant> warm_copies(copies);
+        warm_->append_events(warm_copies);
+    }
+    cold_->append_events(events);
+    append_hot(copies);
+}
+
+void TieredOrderBookRepository::append_hot(std::span<OrderBookEventVariant> events) {
+    std::unique_lock lock(hot_mutex_);
+    for (auto& event : events) {
+        auto sequence = sequence_of(event);
+        auto floor = sequence > 0 ? sequence - 1 : 0;
+        if (!started_ || floor < floor_) floor_ = floor;
+        started_ = true;
+        hot_.append_event(std::move(event));
+    }
+}
+
+TieredOrderBookRepository::Tier TieredOrderBookRepository::tier_for(const MarketAsset& asset,
+                                                                    uint64_t sequence_number) const {
+    if (!started_ || sequence_number < floor_) return Tier::cold;
+    if (sequence_number >= hot_.dropped_through(asset)) return Tier::hot;
+    return warm_ ? Tier::warm : Tier::cold;
+}
+
+void TieredOrderBookRepository::count_read(Tier tier) const {
+    auto& counter = tier == Tier::hot ? hot_reads_ : tier == Tier::warm ? warm_reads_ : cold_reads_;
+    counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<OrderBookEventVariant> TieredOrderBookRepository::get_events_since(const MarketAsset& asset,
+                                                                               uint64_t sequence_number) const {
+    Tier tier;
+    {
+        std::shared_lock lock(hot_mutex_);
+        tier = tier_for(asset, sequence_number);
+        if (tier == Tier::hot) {
+            count_read(tier);
+            return hot_.get_events_since(asset, sequence_number);
+        }
+    }
+    count_read(tier);
+    return (tier == Tier::warm ? *warm_ : *cold_).get_events_since(asset, sequence_number);
+}
+
+size_t TieredOrderBookRepository::replay_events(const std::vector<MarketAsset>& assets, uint64_t sequence_number,
+                                                const EventVisitor& visit) const {
+    std::vector<OrderBookEventVariant> events;
+    auto tier = Tier::hot;
+    {
+        std::shared_lock lock(hot_mutex_);
+        for (const auto& asset : assets) tier = std::max(tier, tier_for(asset, sequence_number));
+        if (tier == Tier::hot) {
+            // Copied out under the lock, merged and visited outside it
+            for (const auto& asset : assets) {
+                auto tail = hot_.get_events_since(asset, sequence_number);
+                auto middle = events.insert(events.end(), std::make_move_iterator(tail.begin()),
+                                            std::make_move_iterator(tail.end()));
+                std::inplace_merge(events.begin(), middle, events.end(),
+                                   [](const auto& a, const auto& b) { return sequence_of(a) < sequence_of(b); });
+            }
+        }
+    }
+    count_read(tier);
+    if (tier != Tier::hot) return (tier == Tier::warm ? *warm_ : *cold_).replay_events(assets, sequence_number, visit);
+
+    size_t visited = 0;
+    for (auto& event : events) {
+        ++visited;
+        if (!visit(std::move(event))) break;
+    }
+    return visited;
+}
+
+uint64_t TieredOrderBookRepository::max_sequence_number() const {
+    return cold_->max_sequence_number();
+}
+
+size_t TieredOrderBookRepository::hot_events() const {
+    std::shared_lock lock(hot_mutex_);
+    return hot_.event_count();
+}
+
+void TieredOrderBookRepository::store_snapshot(const OrderBook& book) {
+    cold_->store_snapshot(book);
+}
+
+std::optional<OrderBook> TieredOrderBookRepository::get_latest_snapshot(const MarketAsset& asset) const {
+    return cold_->get_latest_snapshot(asset);
+}
+
+std::optional<OrderBook> TieredOrderBookRepository::get_latest_snapshot_by_token(const std::string& token_id) const {
+    return cold_->get_latest_snapshot_by_token(token_id);
+}
+
+void TieredOrderBookRepository::store_checkpoint(const std::vector<OrderBook>& books) {
+    cold_->store_checkpoint(books);
+}
+
+std::vector<OrderBook> TieredOrderBookRepository::load_checkpoint() const {
+    return cold_->load_checkpoint();
+}
+
+} // namespace mde::repositories
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "repositories/IOrderBookRepository.hpp"
+#include "repositories/InMemoryOrderBookRepository.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+
+namespace mde::repositories {
+
+// One repository over up to three tiers: a bounded in-memory tail per asset
+// (hot), an optional local cache (warm, e.g. Parquet on local disk) and the
+// durable store (cold, Parquet locally or on S3).
+//
+// Every event goes to every tier, the cold one first, so an event is only
+// served from memory once it is durable. get_events_since and replay_events
+// read the fastest tier that still holds every event of the range: the hot
+// tail while the requested sequence is at or after the oldest event it
+// kept for the asset, the warm tier while the range started after this
+// repository did, the cold store otherwise. Events from before this
+// repository was created, i.e. from earlier runs, only come from the cold
+// store. Snapshots and checkpoints live in the cold store alone.
+//
+// Thread-safe if the tiers below it are.
+class TieredOrderBookRepository : public IOrderBookRepository {
+public:
+    TieredOrderBookRepository(std::unique_ptr<IOrderBookRepository> cold, InMemoryRetention hot,
+                              std::unique_ptr<IOrderBookRepository> warm = nullptr);
+
+    void append_event(const mde::domain::OrderBookEventVariant& event) override;
+    void append_event(mde::domain::OrderBookEventVariant&& event) override;
+    void append_events(std::span<mde::domain::OrderBookEventVariant> events) override;
+    std::vector<mde::domain::OrderBookEventVariant> get_events_since(
+        const mde::domain::MarketAsset& asset, uint64_t sequence_number) const override;
+    size_t replay_events(const std::vector<mde::domain::MarketAsset>& assets, uint64_t sequence_number,
+                         const EventVisitor& visit) const override;
+    // The cold store's, which takes every event first
+    uint64_t max_sequence_number() const override;
+
+    void store_snapshot(const mde::domain::OrderBook& book) override;
+    std::optional<mde::domain::OrderBook> get_latest_snapshot(
+        const mde::domain::MarketAsset& asset) const override;
+    std::optional<mde::domain::OrderBook> get_latest_snapshot_by_token(
+        const std::string& token_id) const override;
+    void store_checkpoint(const std::vector<mde::domain::OrderBook>& books) override;
+    std::vector<mde::domain::OrderBook> load_checkpoint() const override;
+
+    // Reads (get_events_since calls, or replay_events calls) each tier served
+    uint64_t hot_reads() const noexcept { return hot_reads_.load(std::memory_order_relaxed); }
+    uint64_t warm_reads() const noexcept { return warm_reads_.load(std::memory_order_relaxed); }
+    uint64_t cold_reads() const noexcept { return cold_reads_.load(std::memory_order_relaxed); }
+    // Events the hot tail holds
+    size_t hot_events() const;
+
+private:
+    enum class Tier { hot, warm, cold };
+
+    // The fastest tier holding every event of `asset` after sequence_number
+    Tier tier_for(const mde::domain::MarketAsset& asset, uint64_t sequence_number) const;
+    void count_read(Tier tier) const;
+    // The events, already stored below, into the hot tail
+    void append_hot(std::span<mde::domain::OrderBookEventVariant> events);
+
+    std::unique_ptr<IOrderBookRepository> cold_;
+    std::unique_ptr<IOrderBookRepository> warm_;
+
+    mutable std::shared_mutex hot_mutex_;
+    InMemoryOrderBookRepository hot_;
+    // Tiers above cold hold every event after this sequence number (the
+    // first one this repository stored, less one); nothing until then
+    bool started_{false};
+    uint64_t floor_{0};
+
+    mutable std::atomic<uint64_t> hot_reads_{0};
+    mutable std::atomic<uint64_t> warm_reads_{0};
+    mutable std::atomic<uint64_t> cold_reads_{0};
+};
+
+} // namespace mde::repositories
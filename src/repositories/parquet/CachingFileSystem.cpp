@@ -0,0 +1,264 @@
+#include "repositories/parquet/CachingFileSystem.hpp"
+
+#include <arrow/buffer.h>
+#include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/result.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace mde::repositories::pq {
+
+namespace {
+
+constexpr const char* kEntrySuffix = ".cache";
+constexpr const char* kTempSuffix = ".tmp";
+
+// Stable across runs, unlike std::hash
+uint64_t fnv1a(const std::string& text) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool ends_with(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+CachingFileSystem::CachingFileSystem(std::shared_ptr<arrow::fs::FileSystem> base, DiskCacheOptions options)
+    : arrow::fs::FileSystem(base->io_context())
+    , base_(std::move(base))
+    , options_(std::move(options)) {
+    if (options_.directory.empty()) throw std::invalid_argument("Disk cache needs a directory");
+    if (options_.max_bytes == 0) throw std::invalid_argument("Disk cache size must be positive");
+    std::filesystem::create_directories(options_.directory);
+    load_index();
+}
+
+bool CachingFileSystem::Equals(const arrow::fs::FileSystem& other) const {
+    return this == &other;
+}
+
+void CachingFileSystem::load_index() {
+    struct Found {
+        std::filesystem::file_time_type used;
+        std::string key;
+        uint64_t bytes;
+    };
+    std::vector<Found> found;
+    std::error_code error;
+    for (const auto& file : std::filesystem::directory_iterator(options_.directory, error)) {
+        auto name = file.path().filename().string();
+        if (ends_with(name, kTempSuffix)) {
+            // A download the last run did not finish
+            std::filesystem::remove(file.path(), error);
+            continue;
+        }
+        if (!file.is_regular_file(error) || !ends_with(name, kEntrySuffix)) continue;
+        auto bytes = file.file_size(error);
+        if (error) continue;
+        found.push_back({file.last_write_time(error), name.substr(0, name.size() - std::string(kEntrySuffix).size()),
+                         bytes});
+    }
+    std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.used < b.used; });
+
+    std::lock_guard lock(mutex_);
+    for (auto& entry : found) {
+        lru_.push_back({std::move(entry.key), entry.bytes});
+        index_.emplace(lru_.back().key, std::prev(lru_.end()));
+        bytes_ += entry.bytes;
+    }
+    evict();
+}
+
+std::string CachingFileSystem::key_for(const arrow::fs::FileInfo& info) const {
+    if (info.type() != arrow::fs::FileType::File || info.size() < 0) return {};
+    auto mtime = info.mtime();
+    if (mtime == arrow::fs::kNoTime) return {};
+    auto age = std::chrono::system_clock::now() - mtime;
+    if (age < options_.settle_time) return {};
+
+    char key[64];
+    std::snprintf(key, sizeof(key), "%016llx-%lld-%lld", static_cast<unsigned long long>(fnv1a(info.path())),
+                  static_cast<long long>(info.size()),
+                  static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             mtime.time_since_epoch()).count()));
+    return key;
+}
+
+std::string CachingFileSystem::local_path(const std::string& key) const {
+    return (std::filesystem::path(options_.directory) / (key + kEntrySuffix)).string();
+}
+
+void CachingFileSystem::touch(const std::string& key, uint64_t bytes) {
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        lru_.splice(lru_.end(), lru_, it->second);
+    } else {
+        lru_.push_back({key, bytes});
+        index_.emplace(key, std::prev(lru_.end()));
+        bytes_ += bytes;
+    }
+    // So the next run's index keeps the order
+    std::error_code error;
+    std::filesystem::last_write_time(local_path(key), std::filesystem::file_time_type::clock::now(), error);
+    evict();
+}
+
+void CachingFileSystem::evict() {
+    while (bytes_ > options_.max_bytes && !lru_.empty()) {
+        auto& oldest = lru_.front();
+        // Readers that already opened it keep their descriptor
+        std::error_code error;
+        std::filesystem::remove(local_path(oldest.key), error);
+        bytes_ -= oldest.bytes;
+        index_.erase(oldest.key);
+        lru_.pop_front();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint64_t CachingFileSystem::bytes_cached() const {
+    std::lock_guard lock(mutex_);
+    return bytes_;
+}
+
+size_t CachingFileSystem::entries() const {
+    std::lock_guard lock(mutex_);
+    return lru_.size();
+}
+
+arrow::Result<std::shared_ptr<arrow::io::RandomAccessFile>> CachingFileSystem::OpenInputFile(
+    const std::string& path) {
+    auto info = base_->GetFileInfo(path);
+    if (!info.ok() || info->type() != arrow::fs::FileType::File) return base_->OpenInputFile(path);
+    return OpenInputFile(*info);
+}
+
+arrow::Result<std::shared_ptr<arrow::io::RandomAccessFile>> CachingFileSystem::OpenInputFile(
+    const arrow::fs::FileInfo& info) {
+    auto key = key_for(info);
+    if (key.empty()) return base_->OpenInputFile(info);
+
+    {
+        std::lock_guard lock(mutex_);
+        if (index_.count(key)) {
+            auto cached = arrow::io::ReadableFile::Open(local_path(key), io_context().pool());
+            if (cached.ok()) {
+                touch(key, 0);
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return std::shared_ptr<arrow::io::RandomAccessFile>(std::move(cached).ValueOrDie());
+            }
+            // Removed behind our back; download it again
+            bytes_ -= index_[key]->bytes;
+            lru_.erase(index_[key]);
+            index_.erase(key);
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return download(info, key);
+}
+
+arrow::Result<std::shared_ptr<arrow::io::RandomAccessFile>> CachingFileSystem::download(
+    const arrow::fs::FileInfo& info, const std::string& key) {
+    ARROW_ASSIGN_OR_RAISE(auto source, base_->OpenInputFile(info));
+    ARROW_ASSIGN_OR_RAISE(auto size, source->GetSize());
+    ARROW_ASSIGN_OR_RAISE(auto buffer, source->ReadAt(0, size));
+    // Served from what was just downloaded; the disk copy is for next time
+    std::shared_ptr<arrow::io::RandomAccessFile> reader = std::make_shared<arrow::io::BufferReader>(buffer);
+    auto bytes = static_cast<uint64_t>(buffer->size());
+    if (bytes > options_.max_bytes) return reader;
+
+    std::string temp;
+    {
+        std::lock_guard lock(mutex_);
+        temp = (std::filesystem::path(options_.directory) / (key + "." + std::to_string(next_temp_++) + kTempSuffix))
+                   .string();
+    }
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(buffer->data()), static_cast<std::streamsize>(bytes));
+        if (!out) {
+            // A full or unwritable cache disk only costs the caching
+            out.close();
+            std::error_code error;
+            std::filesystem::remove(temp, error);
+            return reader;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp, local_path(key), error);
+    if (error) {
+        std::filesystem::remove(temp, error);
+        return reader;
+    }
+    std::lock_guard lock(mutex_);
+    touch(key, bytes);
+    return reader;
+}
+
+// --- Everything else goes to the base filesystem ---
+
+arrow::Result<arrow::fs::FileInfo> CachingFileSystem::GetFileInfo(const std::string& path) {
+    return base_->GetFileInfo(path);
+}
+
+arrow::Result<arrow::fs::FileInfoVector> CachingFileSystem::GetFileInfo(const arrow::fs::FileSelector& select) {
+    return base_->GetFileInfo(select);
+}
+
+arrow::Status CachingFileSystem::CreateDir(const std::string& path, bool recursive) {
+    return base_->CreateDir(path, recursive);
+}
+
+arrow::Status CachingFileSystem::DeleteDir(const std::string& path) {
+    return base_->DeleteDir(path);
+}
+
+arrow::Status CachingFileSystem::DeleteDirContents(const std::string& path, bool missing_dir_ok) {
+    return base_->DeleteDirContents(path, missing_dir_ok);
+}
+
+arrow::Status CachingFileSystem::DeleteRootDirContents() {
+    return base_->DeleteRootDirContents();
+}
+
+arrow::Status CachingFileSystem::DeleteFile(const std::string& path) {
+    return base_->DeleteFile(path);
+}
+
+arrow::Status CachingFileSystem::Move(const std::string& src, const std::string& dest) {
+    return base_->Move(src, dest);
+}
+
+arrow::Status CachingFileSystem::CopyFile(const std::string& src, const std::string& dest) {
+    return base_->CopyFile(src, dest);
+}
+
+arrow::Result<std::shared_ptr<arrow::io::InputStream>> CachingFileSystem::OpenInputStream(const std::string& path) {
+    return base_->OpenInputStream(path);
+}
+
+arrow::Result<std::shared_ptr<arrow::io::OutputStream>> CachingFileSystem::OpenOutputStream(
+    const std::string& path, const std::shared_ptr<const arrow::KeyValueMetadata>& metadata) {
+    return base_->OpenOutputStream(path, metadata);
+}
+
+arrow::Result<std::shared_ptr<arrow::io::OutputStream>> CachingFileSystem::OpenAppendStream(
+    const std::string& path, const std::shared_ptr<const arrow::KeyValueMetadata>& metadata) {
+    return base_->OpenAppendStream(path, metadata);
+}
+
+} // namespace mde::repositories::pq
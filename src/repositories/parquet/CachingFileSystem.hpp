@@ -0,0 +1,112 @@
+#pragma once
+
+#include <arrow/filesystem/api.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mde::repositories::pq {
+
+struct DiskCacheOptions {
+    std::string directory;                // created if missing
+    uint64_t max_bytes = uint64_t{1} << 30;
+    /// Only files last modified at least this long ago are cached, so a file
+    /// rewritten within one modification-time tick (a second on S3) is never
+    /// mistaken for the copy already cached
+    std::chrono::seconds settle_time{10};
+};
+
+/// A size-bounded local disk cache in front of another filesystem (S3, R2),
+/// for the Parquet repository's reads.
+///
+/// OpenInputFile serves a cached copy of the file if one matches and
+/// otherwise downloads the whole file into the cache first. Copies are
+/// addressed by what identifies a version of an object, its path, size and
+/// modification time: a rewritten snapshot or manifest gets a new entry and
+/// the old one simply ages out. Entries are evicted least recently used
+/// first once the cache exceeds max_bytes, and survive restarts: the
+/// directory is indexed on construction, most recently used last.
+///
+/// Opening a file still costs the base filesystem one metadata request
+/// (unless the caller passes a FileInfo from a listing), but no download on
+/// a hit. Streams, listings and every write go straight to the base
+/// filesystem. Thread-safe.
+class CachingFileSystem : public arrow::fs::FileSystem {
+public:
+    /// Throws std::invalid_argument without a directory or with a zero size
+    CachingFileSystem(std::shared_ptr<arrow::fs::FileSystem> base, DiskCacheOptions options);
+
+    using arrow::fs::FileSystem::GetFileInfo;
+    using arrow::fs::FileSystem::OpenInputStream;
+    using arrow::fs::FileSystem::OpenOutputStream;
+    using arrow::fs::FileSystem::OpenAppendStream;
+
+    std::string type_name() const override { return "caching"; }
+    bool Equals(const arrow::fs::FileSystem& other) const override;
+
+    arrow::Result<arrow::fs::FileInfo> GetFileInfo(const std::string& path) override;
+    arrow::Result<arrow::fs::FileInfoVector> GetFileInfo(const arrow::fs::FileSelector& select) override;
+
+    arrow::Status CreateDir(const std::string& path, bool recursive) override;
+    arrow::Status DeleteDir(const std::string& path) override;
+    arrow::Status DeleteDirContents(const std::string& path, bool missing_dir_ok) override;
+    arrow::Status DeleteRootDirContents() override;
+    arrow::Status DeleteFile(const std::string& path) override;
+    arrow::Status Move(const std::string& src, const std::string& dest) override;
+    arrow::Status CopyFile(const std::string& src, const std::string& dest) override;
+
+    arrow::Result<std::shared_ptr<arrow::io::InputStream>> OpenInputStream(const std::string& path) override;
+    arrow::Result<std::shared_ptr<arrow::io::RandomAccessFile>> OpenInputFile(const std::string& path) override;
+    arrow::Result<std::shared_ptr<arrow::io::RandomAccessFile>> OpenInputFile(
+        const arrow::fs::FileInfo& info) override;
+    arrow::Result<std::shared_ptr<arrow::io::OutputStream>> OpenOutputStream(
+        const std::string& path, const std::shared_ptr<const arrow::KeyValueMetadata>& metadata) override;
+    arrow::Result<std::shared_ptr<arrow::io::OutputStream>> OpenAppendStream(
+        const std::string& path, const std::shared_ptr<const arrow::KeyValueMetadata>& metadata) override;
+
+    uint64_t hits() const noexcept { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const noexcept { return misses_.load(std::memory_order_relaxed); }
+    uint64_t evictions() const noexcept { return evictions_.load(std::memory_order_relaxed); }
+    uint64_t bytes_cached() const;
+    size_t entries() const;
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t bytes;
+    };
+
+    // The cache file name for this version of the object; empty if it may
+    // still change under the same size and time
+    std::string key_for(const arrow::fs::FileInfo& info) const;
+    std::string local_path(const std::string& key) const;
+    // Index the entries a previous run left
+    void load_index();
+    // Record a new or used entry most recently used, then evict past the
+    // budget; the caller holds mutex_
+    void touch(const std::string& key, uint64_t bytes);
+    void evict();
+    arrow::Result<std::shared_ptr<arrow::io::RandomAccessFile>> download(const arrow::fs::FileInfo& info,
+                                                                         const std::string& key);
+
+    std::shared_ptr<arrow::fs::FileSystem> base_;
+    DiskCacheOptions options_;
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  // least recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    uint64_t bytes_{0};
+    uint64_t next_temp_{0};
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+} // namespace mde::repositories::pq
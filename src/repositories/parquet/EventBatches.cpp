@@ -0,0 +1,239 @@
+#include "repositories/parquet/EventBatches.hpp"
+
+#include "repositories/parquet/ParquetSchemas.hpp"
+
+#include <variant>
+
+namespace mde::repositories::pq {
+
+using namespace mde::domain;
+
+std::shared_ptr<arrow::RecordBatch> book_snapshot_batch(const std::vector<OrderBookEventVariant>& events) {
+    auto schema = ParquetSchemas::book_snapshot_schema();
+
+    arrow::StringBuilder condition_id_builder, token_id_builder, hash_builder;
+    arrow::Int64Builder timestamp_builder;
+    arrow::UInt64Builder seq_builder;
+
+    auto bid_prices_builder = std::make_shared<arrow::Int64Builder>();
+    auto bid_sizes_builder = std::make_shared<arrow::Int64Builder>();
+    auto ask_prices_builder = std::make_shared<arrow::Int64Builder>();
+    auto ask_sizes_builder = std::make_shared<arrow::Int64Builder>();
+
+    arrow::ListBuilder bid_prices_list(arrow::default_memory_pool(), bid_prices_builder);
+    arrow::ListBuilder bid_sizes_list(arrow::default_memory_pool(), bid_sizes_builder);
+    arrow::ListBuilder ask_prices_list(arrow::default_memory_pool(), ask_prices_builder);
+    arrow::ListBuilder ask_sizes_list(arrow::default_memory_pool(), ask_sizes_builder);
+
+    for (const auto& event : events) {
+        const auto& snap = std::get<BookSnapshot>(event);
+        (void)condition_id_builder.Append(snap.asset.condition_id());
+        (void)token_id_builder.Append(snap.asset.token_id());
+        (void)timestamp_builder.Append(snap.timestamp.milliseconds());
+        (void)seq_builder.Append(snap.sequence_number);
+        (void)hash_builder.Append(snap.hash);
+
+        (void)bid_prices_list.Append();
+        (void)bid_sizes_list.Append();
+        for (const auto& bid : snap.bids) {
+            (void)bid_prices_builder->Append(bid.price().micros());
+            (void)bid_sizes_builder->Append(bid.size().units());
+        }
+
+        (void)ask_prices_list.Append();
+        (void)ask_sizes_list.Append();
+        for (const auto& ask : snap.asks) {
+            (void)ask_prices_builder->Append(ask.price().micros());
+            (void)ask_sizes_builder->Append(ask.size().units());
+        }
+    }
+
+    std::shared_ptr<arrow::Array> arr_cid, arr_tid, arr_ts, arr_seq, arr_hash;
+    std::shared_ptr<arrow::Array> arr_bp, arr_bs, arr_ap, arr_as;
+    (void)condition_id_builder.Finish(&arr_cid);
+    (void)token_id_builder.Finish(&arr_tid);
+    (void)timestamp_builder.Finish(&arr_ts);
+    (void)seq_builder.Finish(&arr_seq);
+    (void)hash_builder.Finish(&arr_hash);
+    (void)bid_prices_list.Finish(&arr_bp);
+    (void)bid_sizes_list.Finish(&arr_bs);
+    (void)ask_prices_list.Finish(&arr_ap);
+    (void)ask_sizes_list.Finish(&arr_as);
+
+    return arrow::RecordBatch::Make(schema, arr_cid->length(),
+        {arr_cid, arr_tid, arr_ts, arr_seq, arr_hash, arr_bp, arr_bs, arr_ap, arr_as});
+}
+
+std::shared_ptr<arrow::RecordBatch> book_delta_batch(const std::vector<OrderBookEventVariant>& events) {
+    auto schema = ParquetSchemas::book_delta_schema();
+
+    arrow::StringBuilder condition_id_builder, token_id_builder;
+    arrow::Int64Builder timestamp_builder;
+    arrow::UInt64Builder seq_builder;
+
+    auto asset_ids_inner = std::make_shared<arrow::StringBuilder>();
+    auto prices_inner = std::make_shared<arrow::Int64Builder>();
+    auto sizes_inner = std::make_shared<arrow::Int64Builder>();
+    auto sides_inner = std::make_shared<arrow::UInt8Builder>();
+    auto best_bids_inner = std::make_shared<arrow::Int64Builder>();
+    auto best_asks_inner = std::make_shared<arrow::Int64Builder>();
+
+    arrow::ListBuilder asset_ids_list(arrow::default_memory_pool(), asset_ids_inner);
+    arrow::ListBuilder prices_list(arrow::default_memory_pool(), prices_inner);
+    arrow::ListBuilder sizes_list(arrow::default_memory_pool(), sizes_inner);
+    arrow::ListBuilder sides_list(arrow::default_memory_pool(), sides_inner);
+    arrow::ListBuilder best_bids_list(arrow::default_memory_pool(), best_bids_inner);
+    arrow::ListBuilder best_asks_list(arrow::default_memory_pool(), best_asks_inner);
+
+    for (const auto& event : events) {
+        const auto& delta = std::get<BookDelta>(event);
+        (void)condition_id_builder.Append(delta.asset.condition_id());
+        (void)token_id_builder.Append(delta.asset.token_id());
+        (void)timestamp_builder.Append(delta.timestamp.milliseconds());
+        (void)seq_builder.Append(delta.sequence_number);
+
+        (void)asset_ids_list.Append();
+        (void)prices_list.Append();
+        (void)sizes_list.Append();
+        (void)sides_list.Append();
+        (void)best_bids_list.Append();
+        (void)best_asks_list.Append();
+        for (const auto& change : delta.changes) {
+            (void)asset_ids_inner->Append(change.asset_id.str());
+            (void)prices_inner->Append(change.price.micros());
+            (void)sizes_inner->Append(change.new_size.units());
+            (void)sides_inner->Append(static_cast<uint8_t>(change.side));
+            (void)best_bids_inner->Append(change.best_bid.micros());
+            (void)best_asks_inner->Append(change.best_ask.micros());
+        }
+    }
+
+    std::shared_ptr<arrow::Array> arr_cid, arr_tid, arr_ts, arr_seq;
+    std::shared_ptr<arrow::Array> arr_aids, arr_prices, arr_sizes, arr_sides, arr_bbids, arr_basks;
+    (void)condition_id_builder.Finish(&arr_cid);
+    (void)token_id_builder.Finish(&arr_tid);
+    (void)timestamp_builder.Finish(&arr_ts);
+    (void)seq_builder.Finish(&arr_seq);
+    (void)asset_ids_list.Finish(&arr_aids);
+    (void)prices_list.Finish(&arr_prices);
+    (void)sizes_list.Finish(&arr_sizes);
+    (void)sides_list.Finish(&arr_sides);
+    (void)best_bids_list.Finish(&arr_bbids);
+    (void)best_asks_list.Finish(&arr_basks);
+
+    return arrow::RecordBatch::Make(schema, arr_cid->length(),
+        {arr_cid, arr_tid, arr_ts, arr_seq, arr_aids, arr_prices, arr_sizes, arr_sides, arr_bbids, arr_basks});
+}
+
+std::shared_ptr<arrow::RecordBatch> flat_book_delta_batch(const std::vector<OrderBookEventVariant>& events) {
+    auto schema = ParquetSchemas::flat_book_delta_schema();
+
+    arrow::StringBuilder condition_id_builder, token_id_builder;
+    arrow::Int64Builder timestamp_builder;
+    arrow::UInt64Builder seq_builder;
+    arrow::UInt8Builder side_builder;
+    arrow::Int64Builder price_builder, size_builder, best_bid_builder, best_ask_builder;
+
+    for (const auto& event : events) {
+        const auto& delta = std::get<BookDelta>(event);
+        for (const auto& change : delta.changes) {
+            (void)condition_id_builder.Append(delta.asset.condition_id());
+            (void)token_id_builder.Append(delta.asset.token_id());
+            (void)timestamp_builder.Append(delta.timestamp.milliseconds());
+            (void)seq_builder.Append(delta.sequence_number);
+            (void)side_builder.Append(static_cast<uint8_t>(change.side));
+            (void)price_builder.Append(change.price.micros());
+            (void)size_builder.Append(change.new_size.units());
+            (void)best_bid_builder.Append(change.best_bid.micros());
+            (void)best_ask_builder.Append(change.best_ask.micros());
+        }
+    }
+
+    std::shared_ptr<arrow::Array> arr_cid, arr_tid, arr_ts, arr_seq;
+    std::shared_ptr<arrow::Array> arr_side, arr_price, arr_size, arr_bbid, arr_bask;
+    (void)condition_id_builder.Finish(&arr_cid);
+    (void)token_id_builder.Finish(&arr_tid);
+    (void)timestamp_builder.Finish(&arr_ts);
+    (void)seq_builder.Finish(&arr_seq);
+    (void)side_builder.Finish(&arr_side);
+    (void)price_builder.Finish(&arr_price);
+    (void)size_builder.Finish(&arr_size);
+    (void)best_bid_builder.Finish(&arr_bbid);
+    (void)best_ask_builder.Finish(&arr_bask);
+
+    return arrow::RecordBatch::Make(schema, arr_cid->length(),
+        {arr_cid, arr_tid, arr_ts, arr_seq, arr_side, arr_price, arr_size, arr_bbid, arr_bask});
+}
+
+std::shared_ptr<arrow::RecordBatch> trade_event_batch(const std::vector<OrderBookEventVariant>& events) {
+    auto schema = ParquetSchemas::trade_event_schema();
+
+    arrow::StringBuilder condition_id_builder, token_id_builder, fee_builder;
+    arrow::Int64Builder timestamp_builder;
+    arrow::UInt64Builder seq_builder;
+    arrow::Int64Builder price_builder, size_builder;
+    arrow::UInt8Builder side_builder;
+
+    for (const auto& event : events) {
+        const auto& trade = std::get<TradeEvent>(event);
+        (void)condition_id_builder.Append(trade.asset.condition_id());
+        (void)token_id_builder.Append(trade.asset.token_id());
+        (void)timestamp_builder.Append(trade.timestamp.milliseconds());
+        (void)seq_builder.Append(trade.sequence_number);
+        (void)price_builder.Append(trade.price.micros());
+        (void)size_builder.Append(trade.size.units());
+        (void)side_builder.Append(static_cast<uint8_t>(trade.side));
+        (void)fee_builder.Append(trade.fee_rate_bps);
+    }
+
+    std::shared_ptr<arrow::Array> arr_cid, arr_tid, arr_ts, arr_seq;
+    std::shared_ptr<arrow::Array> arr_price, arr_size, arr_side, arr_fee;
+    (void)condition_id_builder.Finish(&arr_cid);
+    (void)token_id_builder.Finish(&arr_tid);
+    (void)timestamp_builder.Finish(&arr_ts);
+    (void)seq_builder.Finish(&arr_seq);
+    (void)price_builder.Finish(&arr_price);
+    (void)size_builder.Finish(&arr_size);
+    (void)side_builder.Finish(&arr_side);
+    (void)fee_builder.Finish(&arr_fee);
+
+    return arrow::RecordBatch::Make(schema, arr_cid->length(),
+        {arr_cid, arr_tid, arr_ts, arr_seq, arr_price, arr_size, arr_side, arr_fee});
+}
+
+std::shared_ptr<arrow::RecordBatch> tick_size_change_batch(const std::vector<OrderBookEventVariant>& events) {
+    auto schema = ParquetSchemas::tick_size_change_schema();
+
+    arrow::StringBuilder condition_id_builder, token_id_builder;
+    arrow::Int64Builder timestamp_builder;
+    arrow::UInt64Builder seq_builder;
+    arrow::Int64Builder old_tick_builder, new_tick_builder;
+
+    for (const auto& event : events) {
+        const auto& tick = std::get<TickSizeChange>(event);
+        (void)condition_id_builder.Append(tick.asset.condition_id());
+        (void)token_id_builder.Append(tick.asset.token_id());
+        (void)timestamp_builder.Append(tick.timestamp.milliseconds());
+        (void)seq_builder.Append(tick.sequence_number);
+        (void)old_tick_builder.Append(tick.old_tick_size.micros());
+        (void)new_tick_builder.Append(tick.new_tick_size.micros());
+    }
+
+    std::shared_ptr<arrow::Array> arr_cid, arr_tid, arr_ts, arr_seq;
+    std::shared_ptr<arrow::Array> arr_old, arr_new;
+    (void)condition_id_builder.Finish(&arr_cid);
+    (void)token_id_builder.Finish(&arr_tid);
+    (void)timestamp_builder.Finish(&arr_ts);
+    (void)seq_builder.Finish(&arr_seq);
+    (void)old_tick_builder.Finish(&arr_old);
+    (void)new_tick_builder.Finish(&arr_new);
+
+    return arrow::RecordBatch::Make(schema, arr_cid->length(),
+        {arr_cid, arr_tid, arr_ts, arr_seq, arr_old, arr_new});
+}
+
+std::shared_ptr<arrow::Table> as_table(const std::shared_ptr<arrow::RecordBatch>& batch) {
+    return arrow::Table::Make(batch->schema(), batch->columns(), batch->num_rows());
+}
+
+} // namespace mde::repositories::pq
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+
+#include <arrow/api.h>
+
+#include <memory>
+#include <vector>
+
+namespace mde::repositories::pq {
+
+// Events of one type as a record batch in the ParquetSchemas event schema
+// their files use, for the event writers and for exporting to other Arrow
+// consumers. Every event must hold the batch's type (std::bad_variant_access
+// otherwise).
+std::shared_ptr<arrow::RecordBatch> book_snapshot_batch(
+    const std::vector<mde::domain::OrderBookEventVariant>& events);
+// Schema version 1, one row per BookDelta; takes any delta
+std::shared_ptr<arrow::RecordBatch> book_delta_batch(
+    const std::vector<mde::domain::OrderBookEventVariant>& events);
+// Schema version 2, one row per change; only for deltas whose changes are
+// all for the delta's own asset (see flat_book_delta_schema)
+std::shared_ptr<arrow::RecordBatch> flat_book_delta_batch(
+    const std::vector<mde::domain::OrderBookEventVariant>& events);
+std::shared_ptr<arrow::RecordBatch> trade_event_batch(
+    const std::vector<mde::domain::OrderBookEventVariant>& events);
+std::shared_ptr<arrow::RecordBatch> tick_size_change_batch(
+    const std::vector<mde::domain::OrderBookEventVariant>& events);
+
+// The batch's columns as a one-chunk table, without copying
+std::shared_ptr<arrow::Table> as_table(const std::shared_ptr<arrow::RecordBatch>& batch);
+
+} // namespace mde::repositories::pq
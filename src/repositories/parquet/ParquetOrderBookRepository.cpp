@@ -1,16 +1,46 @@
 #include "repositories/parquet/ParquetOrderBookRepository.hpp"
+#include "repositories/parquet/CachingFileSystem.hpp"
+#include "repositories/parquet/EventBatches.hpp"
 #include "repositories/parquet/ParquetSchemas.hpp"
+#include "telemetry/CpuAffinity.hpp"
+#include "telemetry/Latency.hpp"
 
 #include <arrow/api.h>
 #include <arrow/filesystem/api.h>
 #include <arrow/filesystem/localfs.h>
 #include <arrow/filesystem/s3fs.h>
+#include <arrow/io/caching.h>
+#include <arrow/util/compression.h>
 #include <parquet/arrow/reader.h>
+#include <parquet/arrow/schema.h>
 #include <parquet/arrow/writer.h>
+#include <parquet/exception.h>
+#include <parquet/metadata.h>
+#include <parquet/properties.h>
+#include <parquet/schema.h>
+#include <parquet/statistics.h>
 
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <set>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
 #include <variant>
 
 using namespace mde::domain;
@@ -29,11 +59,58 @@ const MarketAsset& get_asset(const OrderBookEventVariant& event) {
         [](const auto& e) -> const MarketAsset& { return e.asset; }, event);
 }
 
+// Runs task(0) .. task(count - 1) on up to `limit` threads, the calling one
+// included, and rethrows the first exception a task threw
+template <typename Task>
+void run_concurrently(size_t count, size_t limit, const Task& task) {
+    std::atomic<size_t> next{0};
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+    auto worker = [&] {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard lock(failure_mutex);
+                if (!failure) failure = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    auto pool_size = std::min(std::max<size_t>(limit, 1), count);
+    for (size_t t = 1; t < pool_size; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    if (failure) std::rethrow_exception(failure);
+}
+
 int64_t get_timestamp_ms(const OrderBookEventVariant& event) {
     return std::visit(
         [](const auto& e) { return e.timestamp.milliseconds(); }, event);
 }
 
+// Price/size columns are int64 micro-units; files written before the
+// fixed-point switch used float64 and are converted on read.
+int64_t fixed_value(const arrow::Array& array, int64_t i) {
+    if (array.type_id() == arrow::Type::INT64) {
+        return static_cast<const arrow::Int64Array&>(array).Value(i);
+    }
+    return std::llround(static_cast<const arrow::DoubleArray&>(array).Value(i) * kFixedPointScale);
+}
+
+Price price_at(const arrow::Array& array, int64_t i) {
+    return Price::from_micros(fixed_value(array, i));
+}
+
+Quantity quantity_at(const arrow::Array& array, int64_t i) {
+    return Quantity::from_units(fixed_value(array, i));
+}
+
 bool ends_with(const std::string& str, const std::string& suffix) {
     if (suffix.size() > str.size()) return false;
     return str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
@@ -63,627 +140,305 @@ std::string stem(const std::string& path) {
     return filename.substr(0, dot);
 }
 
-} // namespace
+// Leading columns shared by every event schema (see ParquetSchemas)
+constexpr int kTokenIdColumn = 1;
+constexpr int kSequenceColumn = 3;
 
-ParquetOrderBookRepository::ParquetOrderBookRepository(
-    std::shared_ptr<arrow::fs::FileSystem> fs,
-    const mde::config::StorageSettings& settings)
-    : fs_(std::move(fs))
-    , settings_(settings)
-    , last_flush_time_(std::chrono::steady_clock::now()) {
-}
+// Compaction bounds a merged event file (and its memory) to this many events
+constexpr size_t kCompactedFileEvents = 1 << 18;
 
-ParquetOrderBookRepository::~ParquetOrderBookRepository() {
-    std::lock_guard lock(mutex_);
-    flush();
-}
+// Rows (books) per row group in checkpoint files
+constexpr int64_t kCheckpointRowGroupSize = 64;
 
-std::shared_ptr<arrow::fs::FileSystem> ParquetOrderBookRepository::make_local_fs(
-    const std::string& root_dir) {
-    auto local = std::make_shared<arrow::fs::LocalFileSystem>();
-    (void)local->CreateDir(root_dir, /*recursive=*/true);
-    return std::make_shared<arrow::fs::SubTreeFileSystem>(root_dir, local);
-}
+// Holds the path of the current checkpoint file
+constexpr const char* kCheckpointPointer = "checkpoints/LATEST";
 
-std::shared_ptr<arrow::fs::FileSystem> ParquetOrderBookRepository::make_s3_fs(
-    const mde::config::StorageSettings& settings) {
-    auto options = arrow::fs::S3Options::Defaults();
-    options.region = settings.s3_region;
-    options.scheme = settings.s3_scheme;
-    if (!settings.s3_endpoint_override.empty()) {
-        options.endpoint_override = settings.s3_endpoint_override;
+// Writer properties for files of `schema` under `profile`: its codec and
+// page size for every column, its dictionary choice for string columns and
+// its numeric encoding for integer ones. Columns are found through the
+// Parquet schema WriteTable will derive, so list elements are covered too.
+std::shared_ptr<::parquet::WriterProperties> make_writer_properties(
+    const mde::config::ParquetWriterSettings& profile, const arrow::Schema& schema) {
+    auto codec = arrow::util::Codec::GetCompressionType(profile.codec);
+    if (!codec.ok()) {
+        throw std::invalid_argument("Unknown Parquet codec: " + profile.codec);
     }
 
-    auto s3fs = arrow::fs::S3FileSystem::Make(options).ValueOrDie();
-    std::string base_path = settings.s3_bucket;
-    if (!settings.s3_prefix.empty()) {
-        base_path += "/" + settings.s3_prefix;
+    std::optional<::parquet::Encoding::type> numeric;  // nullopt keeps the dictionary
+    if (profile.numeric_encoding == "plain") {
+        numeric = ::parquet::Encoding::PLAIN;
+    } else if (profile.numeric_encoding == "delta") {
+        numeric = ::parquet::Encoding::DELTA_BINARY_PACKED;
+    } else if (profile.numeric_encoding == "byte_stream_split") {
+        numeric = ::parquet::Encoding::BYTE_STREAM_SPLIT;
+    } else if (profile.numeric_encoding != "dictionary") {
+        throw std::invalid_argument("Unknown Parquet numeric encoding: " + profile.numeric_encoding +
+                                    " (expected dictionary, plain, delta or byte_stream_split)");
     }
-    return std::make_shared<arrow::fs::SubTreeFileSystem>(base_path, s3fs);
-}
 
-void ParquetOrderBookRepository::append_event(const OrderBookEventVariant& event) {
-    std::lock_guard lock(mutex_);
-
-    auto seq = get_seq(event);
-    if (min_seq_in_buffer_ == 0) min_seq_in_buffer_ = seq;
-    max_seq_in_buffer_ = seq;
-
-    std::visit([this, &event](const auto& e) {
-        using T = std::decay_t<decltype(e)>;
-        if constexpr (std::is_same_v<T, BookSnapshot>) {
-            snapshot_buffer_.push_back(event);
-        } else if constexpr (std::is_same_v<T, BookDelta>) {
-            delta_buffer_.push_back(event);
-        } else if constexpr (std::is_same_v<T, TradeEvent>) {
-            trade_buffer_.push_back(event);
-        } else if constexpr (std::is_same_v<T, TickSizeChange>) {
-            tick_size_buffer_.push_back(event);
+    ::parquet::WriterProperties::Builder builder;
+    builder.compression(*codec);
+    if (profile.codec_level > 0) builder.compression_level(profile.codec_level);
+    builder.data_pagesize(static_cast<int64_t>(std::max(profile.page_size_kb, 1)) * 1024);
+
+    std::shared_ptr<::parquet::SchemaDescriptor> descriptor;
+    PARQUET_THROW_NOT_OK(::parquet::arrow::ToParquetSchema(
+        &schema, *builder.build(), *::parquet::default_arrow_writer_properties(), &descriptor));
+    for (int i = 0; i < descriptor->num_columns(); ++i) {
+        const auto* column = descriptor->Column(i);
+        switch (column->physical_type()) {
+        case ::parquet::Type::BYTE_ARRAY:
+            if (!profile.dictionary) builder.disable_dictionary(column->path());
+            break;
+        case ::parquet::Type::INT32:
+        case ::parquet::Type::INT64:
+            if (numeric) {
+                builder.disable_dictionary(column->path());
+                builder.encoding(column->path(), *numeric);
+            }
+            break;
+        default:
+            break;
         }
-    }, event);
-
-    maybe_flush();
-}
-
-void ParquetOrderBookRepository::maybe_flush() {
-    size_t total = snapshot_buffer_.size() + delta_buffer_.size() +
-                   trade_buffer_.size() + tick_size_buffer_.size();
-
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-        now - last_flush_time_).count();
-
-    if (total >= static_cast<size_t>(settings_.write_buffer_size) || elapsed >= 30) {
-        flush();
     }
+    return builder.build();
 }
 
-void ParquetOrderBookRepository::flush() {
-    if (!snapshot_buffer_.empty()) {
-        flush_buffer("book_snapshot", snapshot_buffer_);
-        snapshot_buffer_.clear();
-    }
-    if (!delta_buffer_.empty()) {
-        flush_buffer("book_delta", delta_buffer_);
-        delta_buffer_.clear();
-    }
-    if (!trade_buffer_.empty()) {
-        flush_buffer("trade_event", trade_buffer_);
-        trade_buffer_.clear();
+// Named Arrow memory pool; jemalloc and mimalloc exist only if Arrow was
+// built with them
+arrow::MemoryPool* memory_pool_named(const std::string& name) {
+    if (name == "default") return arrow::default_memory_pool();
+    if (name == "system") return arrow::system_memory_pool();
+
+    arrow::MemoryPool* pool = nullptr;
+    arrow::Status status;
+    if (name == "jemalloc") {
+        status = arrow::jemalloc_memory_pool(&pool);
+    } else if (name == "mimalloc") {
+        status = arrow::mimalloc_memory_pool(&pool);
+    } else {
+        throw std::invalid_argument("Unknown memory pool: " + name +
+                                    " (expected default, system, jemalloc or mimalloc)");
     }
-    if (!tick_size_buffer_.empty()) {
-        flush_buffer("tick_size_change", tick_size_buffer_);
-        tick_size_buffer_.clear();
+    if (!status.ok()) {
+        throw std::invalid_argument("Memory pool " + name + " unavailable: " + status.ToString());
     }
-    min_seq_in_buffer_ = 0;
-    max_seq_in_buffer_ = 0;
-    last_flush_time_ = std::chrono::steady_clock::now();
+    return pool;
 }
 
-void ParquetOrderBookRepository::flush_buffer(
-    const std::string& event_type,
-    const std::vector<OrderBookEventVariant>& events) {
-    if (events.empty()) return;
-
-    // Use the first event's token_id and timestamp for directory structure
-    const auto& first_asset = get_asset(events.front());
-    auto first_ts = get_timestamp_ms(events.front());
-
-    uint64_t seq_start = get_seq(events.front());
-    uint64_t seq_end = get_seq(events.back());
-
-    std::string dir = events_dir(event_type, first_asset.token_id()) + "/"
-        + date_string(first_ts);
-    (void)fs_->CreateDir(dir, /*recursive=*/true);
-
-    std::string filename = event_type + "_" + hour_string(first_ts) + "_"
-        + std::to_string(seq_start) + "_" + std::to_string(seq_end) + ".parquet";
-    std::string path = dir + "/" + filename;
-
-    if (event_type == "book_snapshot") {
-        write_book_snapshots(path, events);
-    } else if (event_type == "book_delta") {
-        write_book_deltas(path, events);
-    } else if (event_type == "trade_event") {
-        write_trade_events(path, events);
-    } else if (event_type == "tick_size_change") {
-        write_tick_size_changes(path, events);
-    }
+std::string_view as_string_view(const ::parquet::ByteArray& bytes) {
+    return {reinterpret_cast<const char*>(bytes.ptr), bytes.len};
 }
 
-// --- Write helpers ---
-
-void ParquetOrderBookRepository::write_book_snapshots(
-    const std::string& path,
-    const std::vector<OrderBookEventVariant>& events) {
-
-    auto schema = ParquetSchemas::book_snapshot_schema();
-
-    arrow::StringBuilder condition_id_builder, token_id_builder, hash_builder;
-    arrow::Int64Builder timestamp_builder;
-    arrow::UInt64Builder seq_builder;
-
-    auto bid_prices_builder = std::make_shared<arrow::DoubleBuilder>();
-    auto bid_sizes_builder = std::make_shared<arrow::DoubleBuilder>();
-    auto ask_prices_builder = std::make_shared<arrow::DoubleBuilder>();
-    auto ask_sizes_builder = std::make_shared<arrow::DoubleBuilder>();
-
-    arrow::ListBuilder bid_prices_list(arrow::default_memory_pool(), bid_prices_builder);
-    arrow::ListBuilder bid_sizes_list(arrow::default_memory_pool(), bid_sizes_builder);
-    arrow::ListBuilder ask_prices_list(arrow::default_memory_pool(), ask_prices_builder);
-    arrow::ListBuilder ask_sizes_list(arrow::default_memory_pool(), ask_sizes_builder);
-
-    for (const auto& event : events) {
-        const auto& snap = std::get<BookSnapshot>(event);
-        (void)condition_id_builder.Append(snap.asset.condition_id());
-        (void)token_id_builder.Append(snap.asset.token_id());
-        (void)timestamp_builder.Append(snap.timestamp.milliseconds());
-        (void)seq_builder.Append(snap.sequence_number);
-        (void)hash_builder.Append(snap.hash);
-
-        (void)bid_prices_list.Append();
-        (void)bid_sizes_list.Append();
-        for (const auto& bid : snap.bids) {
-            (void)bid_prices_builder->Append(bid.price().value());
-            (void)bid_sizes_builder->Append(bid.size().size());
+// True if the footer statistics prove no row in the group has this token
+// and sequence_number > min_sequence. Missing statistics never prune.
+bool row_group_excluded(const ::parquet::RowGroupMetaData& row_group,
+                        std::string_view token_id, uint64_t min_sequence) {
+    auto token_chunk = row_group.ColumnChunk(kTokenIdColumn);
+    if (token_chunk->is_stats_set()) {
+        auto stats = std::static_pointer_cast<::parquet::ByteArrayStatistics>(
+            token_chunk->statistics());
+        if (stats->HasMinMax() &&
+            (token_id < as_string_view(stats->min()) || token_id > as_string_view(stats->max()))) {
+            return true;
         }
+    }
 
-        (void)ask_prices_list.Append();
-        (void)ask_sizes_list.Append();
-        for (const auto& ask : snap.asks) {
-            (void)ask_prices_builder->Append(ask.price().value());
-            (void)ask_sizes_builder->Append(ask.size().size());
+    auto seq_chunk = row_group.ColumnChunk(kSequenceColumn);
+    if (seq_chunk->is_stats_set()) {
+        // uint64 is stored as INT64 with unsigned sort order
+        auto stats = std::static_pointer_cast<::parquet::Int64Statistics>(
+            seq_chunk->statistics());
+        if (stats->HasMinMax() && static_cast<uint64_t>(stats->max()) <= min_sequence) {
+            return true;
         }
     }
-
-    std::shared_ptr<arrow::Array> arr_cid, arr_tid, arr_ts, arr_seq, arr_hash;
-    std::shared_ptr<arrow::Array> arr_bp, arr_bs, arr_ap, arr_as;
-    (void)condition_id_builder.Finish(&arr_cid);
-    (void)token_id_builder.Finish(&arr_tid);
-    (void)timestamp_builder.Finish(&arr_ts);
-    (void)seq_builder.Finish(&arr_seq);
-    (void)hash_builder.Finish(&arr_hash);
-    (void)bid_prices_list.Finish(&arr_bp);
-    (void)bid_sizes_list.Finish(&arr_bs);
-    (void)ask_prices_list.Finish(&arr_ap);
-    (void)ask_sizes_list.Finish(&arr_as);
-
-    auto table = arrow::Table::Make(schema,
-        {arr_cid, arr_tid, arr_ts, arr_seq, arr_hash, arr_bp, arr_bs, arr_ap, arr_as});
-
-    auto outfile = fs_->OpenOutputStream(path).ValueOrDie();
-    (void)::parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), outfile, events.size());
-    (void)outfile->Close();
-}
-
-void ParquetOrderBookRepository::write_book_deltas(
-    const std::string& path,
-    const std::vector<OrderBookEventVariant>& events) {
-
-    auto schema = ParquetSchemas::book_delta_schema();
-
-    arrow::StringBuilder condition_id_builder, token_id_builder;
-    arrow::Int64Builder timestamp_builder;
-    arrow::UInt64Builder seq_builder;
-
-    auto asset_ids_inner = std::make_shared<arrow::StringBuilder>();
-    auto prices_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto sizes_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto sides_inner = std::make_shared<arrow::UInt8Builder>();
-    auto best_bids_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto best_asks_inner = std::make_shared<arrow::DoubleBuilder>();
-
-    arrow::ListBuilder asset_ids_list(arrow::default_memory_pool(), asset_ids_inner);
-    arrow::ListBuilder prices_list(arrow::default_memory_pool(), prices_inner);
-    arrow::ListBuilder sizes_list(arrow::default_memory_pool(), sizes_inner);
-    arrow::ListBuilder sides_list(arrow::default_memory_pool(), sides_inner);
-    arrow::ListBuilder best_bids_list(arrow::default_memory_pool(), best_bids_inner);
-    arrow::ListBuilder best_asks_list(arrow::default_memory_pool(), best_asks_inner);
-
-    for (const auto& event : events) {
-        const auto& delta = std::get<BookDelta>(event);
-        (void)condition_id_builder.Append(delta.asset.condition_id());
-        (void)token_id_builder.Append(delta.asset.token_id());
-        (void)timestamp_builder.Append(delta.timestamp.milliseconds());
-        (void)seq_builder.Append(delta.sequence_number);
-
-        (void)asset_ids_list.Append();
-        (void)prices_list.Append();
-        (void)sizes_list.Append();
-        (void)sides_list.Append();
-        (void)best_bids_list.Append();
-        (void)best_asks_list.Append();
-        for (const auto& change : delta.changes) {
-            (void)asset_ids_inner->Append(change.asset_id);
-            (void)prices_inner->Append(change.price.value());
-            (void)sizes_inner->Append(change.new_size.size());
-            (void)sides_inner->Append(static_cast<uint8_t>(change.side));
-            (void)best_bids_inner->Append(change.best_bid.value());
-            (void)best_asks_inner->Append(change.best_ask.value());
-        }
-    }
-
-    std::shared_ptr<arrow::Array> arr_cid, arr_tid, arr_ts, arr_seq;
-    std::shared_ptr<arrow::Array> arr_aids, arr_prices, arr_sizes, arr_sides, arr_bbids, arr_basks;
-    (void)condition_id_builder.Finish(&arr_cid);
-    (void)token_id_builder.Finish(&arr_tid);
-    (void)timestamp_builder.Finish(&arr_ts);
-    (void)seq_builder.Finish(&arr_seq);
-    (void)asset_ids_list.Finish(&arr_aids);
-    (void)prices_list.Finish(&arr_prices);
-    (void)sizes_list.Finish(&arr_sizes);
-    (void)sides_list.Finish(&arr_sides);
-    (void)best_bids_list.Finish(&arr_bbids);
-    (void)best_asks_list.Finish(&arr_basks);
-
-    auto table = arrow::Table::Make(schema,
-        {arr_cid, arr_tid, arr_ts, arr_seq, arr_aids, arr_prices, arr_sizes, arr_sides, arr_bbids, arr_basks});
-
-    auto outfile = fs_->OpenOutputStream(path).ValueOrDie();
-    (void)::parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), outfile, events.size());
-    (void)outfile->Close();
-}
-
-void ParquetOrderBookRepository::write_trade_events(
-    const std::string& path,
-    const std::vector<OrderBookEventVariant>& events) {
-
-    auto schema = ParquetSchemas::trade_event_schema();
-
-    arrow::StringBuilder condition_id_builder, token_id_builder, fee_builder;
-    arrow::Int64Builder timestamp_builder;
-    arrow::UInt64Builder seq_builder;
-    arrow::DoubleBuilder price_builder, size_builder;
-    arrow::UInt8Builder side_builder;
-
-    for (const auto& event : events) {
-        const auto& trade = std::get<TradeEvent>(event);
-        (void)condition_id_builder.Append(trade.asset.condition_id());
-        (void)token_id_builder.Append(trade.asset.token_id());
-        (void)timestamp_builder.Append(trade.timestamp.milliseconds());
-        (void)seq_builder.Append(trade.sequence_number);
-        (void)price_builder.Append(trade.price.value());
-        (void)size_builder.Append(trade.size.size());
-        (void)side_builder.Append(static_cast<uint8_t>(trade.side));
-        (void)fee_builder.Append(trade.fee_rate_bps);
-    }
-
-    std::shared_ptr<arrow::Array> arr_cid, arr_tid, arr_ts, arr_seq;
-    std::shared_ptr<arrow::Array> arr_price, arr_size, arr_side, arr_fee;
-    (void)condition_id_builder.Finish(&arr_cid);
-    (void)token_id_builder.Finish(&arr_tid);
-    (void)timestamp_builder.Finish(&arr_ts);
-    (void)seq_builder.Finish(&arr_seq);
-    (void)price_builder.Finish(&arr_price);
-    (void)size_builder.Finish(&arr_size);
-    (void)side_builder.Finish(&arr_side);
-    (void)fee_builder.Finish(&arr_fee);
-
-    auto table = arrow::Table::Make(schema,
-        {arr_cid, arr_tid, arr_ts, arr_seq, arr_price, arr_size, arr_side, arr_fee});
-
-    auto outfile = fs_->OpenOutputStream(path).ValueOrDie();
-    (void)::parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), outfile, events.size());
-    (void)outfile->Close();
+    return false;
 }
 
-void ParquetOrderBookRepository::write_tick_size_changes(
-    const std::string& path,
-    const std::vector<OrderBookEventVariant>& events) {
-
-    auto schema = ParquetSchemas::tick_size_change_schema();
-
-    arrow::StringBuilder condition_id_builder, token_id_builder;
-    arrow::Int64Builder timestamp_builder;
-    arrow::UInt64Builder seq_builder;
-    arrow::DoubleBuilder old_tick_builder, new_tick_builder;
-
-    for (const auto& event : events) {
-        const auto& tick = std::get<TickSizeChange>(event);
-        (void)condition_id_builder.Append(tick.asset.condition_id());
-        (void)token_id_builder.Append(tick.asset.token_id());
-        (void)timestamp_builder.Append(tick.timestamp.milliseconds());
-        (void)seq_builder.Append(tick.sequence_number);
-        (void)old_tick_builder.Append(tick.old_tick_size.value());
-        (void)new_tick_builder.Append(tick.new_tick_size.value());
+// Row groups that may hold matching rows. Survivors of the statistics check
+// are confirmed by decoding only the token_id and sequence_number columns,
+// so the wide payload columns are decoded only where a row really matches.
+std::vector<int> matching_row_groups(::parquet::arrow::FileReader& reader,
+                                     std::string_view token_id, uint64_t min_sequence) {
+    std::vector<int> matching;
+    auto metadata = reader.parquet_reader()->metadata();
+    for (int group = 0; group < metadata->num_row_groups(); ++group) {
+        if (row_group_excluded(*metadata->RowGroup(group), token_id, min_sequence)) continue;
+
+        std::shared_ptr<arrow::Table> keys;
+        if (!reader.ReadRowGroup(group, {kTokenIdColumn, kSequenceColumn}, &keys).ok()) continue;
+        auto tokens = keys->column(0);
+        auto seqs = keys->column(1);
+        bool found = false;
+        for (int c = 0; c < tokens->num_chunks() && !found; ++c) {
+            auto tid_col = std::static_pointer_cast<arrow::StringArray>(tokens->chunk(c));
+            auto seq_col = std::static_pointer_cast<arrow::UInt64Array>(seqs->chunk(c));
+            for (int64_t i = 0; i < tid_col->length(); ++i) {
+                if (seq_col->Value(i) > min_sequence && tid_col->GetView(i) == token_id) {
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (found) matching.push_back(group);
     }
-
-    std::shared_ptr<arrow::Array> arr_cid, arr_tid, arr_ts, arr_seq;
-    std::shared_ptr<arrow::Array> arr_old, arr_new;
-    (void)condition_id_builder.Finish(&arr_cid);
-    (void)token_id_builder.Finish(&arr_tid);
-    (void)timestamp_builder.Finish(&arr_ts);
-    (void)seq_builder.Finish(&arr_seq);
-    (void)old_tick_builder.Finish(&arr_old);
-    (void)new_tick_builder.Finish(&arr_new);
-
-    auto table = arrow::Table::Make(schema,
-        {arr_cid, arr_tid, arr_ts, arr_seq, arr_old, arr_new});
-
-    auto outfile = fs_->OpenOutputStream(path).ValueOrDie();
-    (void)::parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), outfile, events.size());
-    (void)outfile->Close();
+    return matching;
 }
 
-// --- Read path ---
-
-std::vector<OrderBookEventVariant> ParquetOrderBookRepository::get_events_since(
-    const MarketAsset& asset, uint64_t sequence_number) const {
-    std::lock_guard lock(mutex_);
+// Directory/file names per event type, in OrderBookEventVariant order
+const std::string kEventTypes[] = {"book_snapshot", "book_delta", "trade_event", "tick_size_change"};
 
-    std::vector<OrderBookEventVariant> result;
+constexpr int64_t kMillisPerHour = 3'600'000;
 
-    // Read from storage for each event type
-    const std::string event_types[] = {"book_snapshot", "book_delta", "trade_event", "tick_size_change"};
-    for (const auto& event_type : event_types) {
-        std::string dir = events_dir(event_type, asset.token_id());
-        auto disk_events = read_events_from_directory(dir, asset, sequence_number);
-        result.insert(result.end(), disk_events.begin(), disk_events.end());
+// Start of the hour named by an event file's {date}/{type}_{HH} key, or
+// nullopt if the key is not in that form
+std::optional<int64_t> hour_start_ms(const std::string& hour_key) {
+    auto underscore = hour_key.rfind('_');
+    auto slash = hour_key.rfind('/');
+    if (underscore == std::string::npos || slash == std::string::npos || slash < 10 ||
+        underscore < slash || hour_key.size() - underscore != 3) {
+        return std::nullopt;
     }
-
-    // Merge with unflushed buffers
-    auto merge_buffer = [&](const std::vector<OrderBookEventVariant>& buffer) {
-        for (const auto& event : buffer) {
-            if (get_asset(event) == asset && get_seq(event) > sequence_number) {
-                result.push_back(event);
-            }
-        }
+    auto number = [&](size_t pos, size_t len) {
+        int value = -1;
+        auto [end, error] = std::from_chars(hour_key.data() + pos, hour_key.data() + pos + len, value);
+        return error == std::errc() && end == hour_key.data() + pos + len ? value : -1;
     };
-    merge_buffer(snapshot_buffer_);
-    merge_buffer(delta_buffer_);
-    merge_buffer(trade_buffer_);
-    merge_buffer(tick_size_buffer_);
-
-    // Sort by sequence number
-    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
-        return get_seq(a) < get_seq(b);
-    });
-
-    return result;
+    auto date = slash - 10;  // YYYY-MM-DD
+    if (hour_key[date + 4] != '-' || hour_key[date + 7] != '-') return std::nullopt;
+    auto year = number(date, 4);
+    auto month = number(date + 5, 2);
+    auto day = number(date + 8, 2);
+    auto hour = number(underscore + 1, 2);
+    std::chrono::year_month_day ymd{std::chrono::year{year}, std::chrono::month(static_cast<unsigned>(month)),
+                                    std::chrono::day(static_cast<unsigned>(day))};
+    if (year < 0 || month < 0 || day < 0 || !ymd.ok() || hour < 0 || hour > 23) return std::nullopt;
+    auto days = std::chrono::sys_days{ymd}.time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(days).count() + hour * kMillisPerHour;
 }
 
-std::vector<OrderBookEventVariant> ParquetOrderBookRepository::read_events_from_directory(
-    const std::string& dir, const MarketAsset& asset, uint64_t min_sequence) const {
-
-    std::vector<OrderBookEventVariant> result;
-
-    arrow::fs::FileSelector selector;
-    selector.base_dir = dir;
-    selector.allow_not_found = true;
-    selector.recursive = true;
-    auto listing_result = fs_->GetFileInfo(selector);
-    if (!listing_result.ok()) return result;
-    auto listing = listing_result.ValueOrDie();
-
-    for (const auto& file_info : listing) {
-        if (file_info.type() != arrow::fs::FileType::File) continue;
-        if (!ends_with(file_info.path(), ".parquet")) continue;
+std::chrono::microseconds elapsed_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+}
 
-        // Try to extract seq range from filename to skip files entirely
-        std::string filename = stem(file_info.path());
-        // Format: {event_type}_{HH}_{seq_start}_{seq_end}
-        // Quick check: if seq_end < min_sequence, skip this file
-        auto last_underscore = filename.rfind('_');
-        if (last_underscore != std::string::npos) {
-            auto second_last = filename.rfind('_', last_underscore - 1);
-            if (second_last != std::string::npos) {
-                try {
-                    uint64_t seq_end = std::stoull(filename.substr(last_underscore + 1));
-                    if (seq_end <= min_sequence) continue;
-                } catch (...) {}
-            }
+// Levels of `current` that differ from `base`, best first (`better` orders
+// prices best first); a level only the base has is listed with size 0
+template <typename Ladder, typename Better>
+std::vector<PriceLevel> level_changes(const Ladder& base, const Ladder& current, Better better) {
+    std::vector<PriceLevel> changes;
+    auto b = base.begin();
+    auto c = current.begin();
+    while (b != base.end() || c != current.end()) {
+        if (c == current.end() || (b != base.end() && better((*b).price(), (*c).price()))) {
+            changes.emplace_back((*b).price(), Quantity::from_units(0));
+            ++b;
+        } else if (b == base.end() || better((*c).price(), (*b).price())) {
+            changes.push_back(*c);
+            ++c;
+        } else {
+            if ((*b).size() != (*c).size()) changes.push_back(*c);
+            ++b;
+            ++c;
         }
+    }
+    return changes;
+}
 
-        // Read the parquet file
-        auto infile = fs_->OpenInputFile(file_info.path()).ValueOrDie();
-        std::unique_ptr<::parquet::arrow::FileReader> reader;
-        auto reader_result = ::parquet::arrow::FileReader::Make(arrow::default_memory_pool(), ::parquet::ParquetFileReader::Open(infile));
-        if (!reader_result.ok()) continue;
-        reader = std::move(reader_result).ValueOrDie();
-
-        std::shared_ptr<arrow::Table> table;
-        auto read_status = reader->ReadTable(&table);
-        if (!read_status.ok()) continue;
-
-        // Determine event type from the path relative to "events/"
-        // file_info.path() within SubTreeFileSystem is like:
-        //   "events/book_snapshot/6581861/2025-07-15/file.parquet"
-        // We want the component after "events/"
-        std::string event_type;
-        const std::string events_prefix = "events/";
-        auto events_pos = file_info.path().find(events_prefix);
-        if (events_pos != std::string::npos) {
-            std::string after_events = file_info.path().substr(events_pos + events_prefix.size());
-            event_type = first_path_component(after_events);
-        }
-
-        auto cid_col = std::static_pointer_cast<arrow::StringArray>(
-            table->column(0)->chunk(0));
-        auto tid_col = std::static_pointer_cast<arrow::StringArray>(
-            table->column(1)->chunk(0));
-        auto ts_col = std::static_pointer_cast<arrow::Int64Array>(
-            table->column(2)->chunk(0));
-        auto seq_col = std::static_pointer_cast<arrow::UInt64Array>(
-            table->column(3)->chunk(0));
-
-        for (int64_t i = 0; i < table->num_rows(); ++i) {
-            uint64_t seq = seq_col->Value(i);
-            if (seq <= min_sequence) continue;
-
-            std::string cid = cid_col->GetString(i);
-            std::string tid = tid_col->GetString(i);
-            if (tid != asset.token_id() || cid != asset.condition_id()) continue;
-
-            int64_t ts = ts_col->Value(i);
-            MarketAsset evt_asset(cid, tid);
-
-            if (event_type == "book_snapshot") {
-                BookSnapshot snap{
-                    {evt_asset, Timestamp(ts), seq},
-                    {}, {},
-                    std::static_pointer_cast<arrow::StringArray>(
-                        table->column(4)->chunk(0))->GetString(i)
-                };
-
-                auto bp_list = std::static_pointer_cast<arrow::ListArray>(
-                    table->column(5)->chunk(0));
-                auto bs_list = std::static_pointer_cast<arrow::ListArray>(
-                    table->column(6)->chunk(0));
-                auto ap_list = std::static_pointer_cast<arrow::ListArray>(
-                    table->column(7)->chunk(0));
-                auto as_list = std::static_pointer_cast<arrow::ListArray>(
-                    table->column(8)->chunk(0));
-
-                auto bp_values = std::static_pointer_cast<arrow::DoubleArray>(bp_list->values());
-                auto bs_values = std::static_pointer_cast<arrow::DoubleArray>(bs_list->values());
-
-                int32_t bp_start = bp_list->value_offset(i);
-                int32_t bp_end = bp_list->value_offset(i + 1);
-                for (int32_t j = bp_start; j < bp_end; ++j) {
-                    snap.bids.emplace_back(Price(bp_values->Value(j)), Quantity(bs_values->Value(j)));
-                }
-
-                auto ap_values = std::static_pointer_cast<arrow::DoubleArray>(ap_list->values());
-                auto as_values = std::static_pointer_cast<arrow::DoubleArray>(as_list->values());
-
-                int32_t ap_start = ap_list->value_offset(i);
-                int32_t ap_end = ap_list->value_offset(i + 1);
-                for (int32_t j = ap_start; j < ap_end; ++j) {
-                    snap.asks.emplace_back(Price(ap_values->Value(j)), Quantity(as_values->Value(j)));
-                }
-
-                result.push_back(snap);
-
-            } else if (event_type == "book_delta") {
-                BookDelta delta{{evt_asset, Timestamp(ts), seq}, {}};
-
-                auto aids_list = std::static_pointer_cast<arrow::ListArray>(
-                    table->column(4)->chunk(0));
-                auto prices_list = std::static_pointer_cast<arrow::ListArray>(
-                    table->column(5)->chunk(0));
-                auto sizes_list = std::static_pointer_cast<arrow::ListArray>(
-                    table->column(6)->chunk(0));
-                auto sides_list = std::static_pointer_cast<arrow::ListArray>(
-                    table->column(7)->chunk(0));
-                auto bbids_list = std::static_pointer_cast<arrow::ListArray>(
-                    table->column(8)->chunk(0));
-                auto basks_list = std::static_pointer_cast<arrow::ListArray>(
-                    table->column(9)->chunk(0));
-
-                auto aids_values = std::static_pointer_cast<arrow::StringArray>(aids_list->values());
-                auto prices_values = std::static_pointer_cast<arrow::DoubleArray>(prices_list->values());
-                auto sizes_values = std::static_pointer_cast<arrow::DoubleArray>(sizes_list->values());
-                auto sides_values = std::static_pointer_cast<arrow::UInt8Array>(sides_list->values());
-                auto bbids_values = std::static_pointer_cast<arrow::DoubleArray>(bbids_list->values());
-                auto basks_values = std::static_pointer_cast<arrow::DoubleArray>(basks_list->values());
-
-                int32_t start = aids_list->value_offset(i);
-                int32_t end = aids_list->value_offset(i + 1);
-                for (int32_t j = start; j < end; ++j) {
-                    delta.changes.push_back(PriceLevelDelta{
-                        aids_values->GetString(j),
-                        Price(prices_values->Value(j)),
-                        Quantity(sizes_values->Value(j)),
-                        static_cast<Side>(sides_values->Value(j)),
-                        Price(bbids_values->Value(j)),
-                        Price(basks_values->Value(j)),
-                    });
-                }
-
-                result.push_back(delta);
-
-            } else if (event_type == "trade_event") {
-                TradeEvent trade{
-                    {evt_asset, Timestamp(ts), seq},
-                    Price(std::static_pointer_cast<arrow::DoubleArray>(
-                        table->column(4)->chunk(0))->Value(i)),
-                    Quantity(std::static_pointer_cast<arrow::DoubleArray>(
-                        table->column(5)->chunk(0))->Value(i)),
-                    static_cast<Side>(std::static_pointer_cast<arrow::UInt8Array>(
-                        table->column(6)->chunk(0))->Value(i)),
-                    std::static_pointer_cast<arrow::StringArray>(
-                        table->column(7)->chunk(0))->GetString(i)
-                };
-
-                result.push_back(trade);
-
-            } else if (event_type == "tick_size_change") {
-                TickSizeChange tick{
-                    {evt_asset, Timestamp(ts), seq},
-                    Price(std::static_pointer_cast<arrow::DoubleArray>(
-                        table->column(4)->chunk(0))->Value(i)),
-                    Price(std::static_pointer_cast<arrow::DoubleArray>(
-                        table->column(5)->chunk(0))->Value(i))
-                };
-
-                result.push_back(tick);
-            }
+// `base` with `changes` (from level_changes) applied, best first
+template <typename Better>
+std::vector<PriceLevel> apply_level_changes(const std::vector<PriceLevel>& base,
+                                            const std::vector<PriceLevel>& changes, Better better) {
+    std::vector<PriceLevel> levels;
+    levels.reserve(base.size() + changes.size());
+    auto b = base.begin();
+    auto c = changes.begin();
+    while (b != base.end() || c != changes.end()) {
+        if (c == changes.end() || (b != base.end() && better(b->price(), c->price()))) {
+            levels.push_back(*b++);
+            continue;
         }
+        if (b != base.end() && !better(c->price(), b->price())) ++b;  // replaced or removed
+        if (c->size().units() > 0) levels.push_back(*c);
+        ++c;
     }
-
-    return result;
+    return levels;
 }
 
-// --- Snapshot storage ---
-
-void ParquetOrderBookRepository::store_snapshot(const OrderBook& book) {
-    std::lock_guard lock(mutex_);
+// The levels a snapshot diff holds: those that changed since its base
+struct LevelChanges {
+    uint64_t base_sequence_number{0};
+    std::vector<PriceLevel> bids;
+    std::vector<PriceLevel> asks;
+};
 
-    auto schema = ParquetSchemas::order_book_snapshot_schema();
+// One row per book, in the order given (order_book_snapshot_schema). With
+// `changes` there must be one book, whose row holds those levels instead of
+// its own (order_book_diff_schema).
+std::shared_ptr<arrow::Table> make_snapshot_table(const std::vector<const OrderBook*>& books,
+                                                  const LevelChanges* changes = nullptr) {
+    auto schema = changes ? ParquetSchemas::order_book_diff_schema() : ParquetSchemas::order_book_snapshot_schema();
 
     arrow::StringBuilder cid_b, tid_b, hash_b, fee_b;
     arrow::Int64Builder ts_b, trade_ts_b;
     arrow::UInt64Builder seq_b;
-    arrow::DoubleBuilder tick_b, trade_price_b, trade_size_b;
+    arrow::Int64Builder tick_b, trade_price_b, trade_size_b;
     arrow::UInt8Builder trade_side_b;
     arrow::BooleanBuilder has_trade_b;
 
-    auto bp_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto bs_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto ap_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto as_inner = std::make_shared<arrow::DoubleBuilder>();
+    auto bp_inner = std::make_shared<arrow::Int64Builder>();
+    auto bs_inner = std::make_shared<arrow::Int64Builder>();
+    auto ap_inner = std::make_shared<arrow::Int64Builder>();
+    auto as_inner = std::make_shared<arrow::Int64Builder>();
     arrow::ListBuilder bp_list(arrow::default_memory_pool(), bp_inner);
     arrow::ListBuilder bs_list(arrow::default_memory_pool(), bs_inner);
     arrow::ListBuilder ap_list(arrow::default_memory_pool(), ap_inner);
     arrow::ListBuilder as_list(arrow::default_memory_pool(), as_inner);
+    auto append_levels = [](arrow::ListBuilder& prices, arrow::Int64Builder& price_values,
+                            arrow::ListBuilder& sizes, arrow::Int64Builder& size_values, const auto& levels) {
+        (void)prices.Append();
+        (void)sizes.Append();
+        for (const auto& level : levels) {
+            (void)price_values.Append(level.price().micros());
+            (void)size_values.Append(level.size().units());
+        }
+    };
 
-    (void)cid_b.Append(book.get_asset().condition_id());
-    (void)tid_b.Append(book.get_asset().token_id());
-    (void)ts_b.Append(book.get_timestamp().milliseconds());
-    (void)seq_b.Append(book.get_last_sequence_number());
-    (void)tick_b.Append(book.get_tick_size().value());
-    (void)hash_b.Append(book.get_book_hash());
-
-    (void)bp_list.Append();
-    (void)bs_list.Append();
-    for (const auto& bid : book.get_bids()) {
-        (void)bp_inner->Append(bid.price().value());
-        (void)bs_inner->Append(bid.size().size());
-    }
-
-    (void)ap_list.Append();
-    (void)as_list.Append();
-    for (const auto& ask : book.get_asks()) {
-        (void)ap_inner->Append(ask.price().value());
-        (void)as_inner->Append(ask.size().size());
-    }
-
-    bool has_trade = book.get_latest_trade().has_value();
-    (void)has_trade_b.Append(has_trade);
+    for (const auto* book_ptr : books) {
+        const auto& book = *book_ptr;
+        (void)cid_b.Append(book.get_asset().condition_id());
+        (void)tid_b.Append(book.get_asset().token_id());
+        (void)ts_b.Append(book.get_timestamp().milliseconds());
+        (void)seq_b.Append(book.get_last_sequence_number());
+        (void)tick_b.Append(book.get_tick_size().micros());
+        (void)hash_b.Append(book.get_book_hash());
+
+        if (changes) {
+            append_levels(bp_list, *bp_inner, bs_list, *bs_inner, changes->bids);
+            append_levels(ap_list, *ap_inner, as_list, *as_inner, changes->asks);
+        } else {
+            append_levels(bp_list, *bp_inner, bs_list, *bs_inner, book.get_bids());
+            append_levels(ap_list, *ap_inner, as_list, *as_inner, book.get_asks());
+        }
 
-    if (has_trade) {
-        auto trade = *book.get_latest_trade();
-        (void)trade_price_b.Append(trade.price.value());
-        (void)trade_size_b.Append(trade.size.size());
-        (void)trade_side_b.Append(static_cast<uint8_t>(trade.side));
-        (void)fee_b.Append(trade.fee_rate_bps);
-        (void)trade_ts_b.Append(trade.timestamp.milliseconds());
-    } else {
-        (void)trade_price_b.Append(0.0);
-        (void)trade_size_b.Append(0.0);
-        (void)trade_side_b.Append(0);
-        (void)fee_b.Append("");
-        (void)trade_ts_b.Append(0);
+        bool has_trade = book.get_latest_trade().has_value();
+        (void)has_trade_b.Append(has_trade);
+
+        if (has_trade) {
+            auto trade = *book.get_latest_trade();
+            (void)trade_price_b.Append(trade.price.micros());
+            (void)trade_size_b.Append(trade.size.units());
+            (void)trade_side_b.Append(static_cast<uint8_t>(trade.side));
+            (void)fee_b.Append(trade.fee_rate_bps);
+            (void)trade_ts_b.Append(trade.timestamp.milliseconds());
+        } else {
+            (void)trade_price_b.Append(0);
+            (void)trade_size_b.Append(0);
+            (void)trade_side_b.Append(0);
+            (void)fee_b.Append("");
+            (void)trade_ts_b.Append(0);
+        }
     }
 
     std::shared_ptr<arrow::Array> arr_cid, arr_tid, arr_ts, arr_seq, arr_tick, arr_hash;
@@ -706,129 +461,2074 @@ void ParquetOrderBookRepository::store_snapshot(const OrderBook& book) {
     (void)trade_ts_b.Finish(&arr_tts);
     (void)has_trade_b.Finish(&arr_ht);
 
-    auto table = arrow::Table::Make(schema,
-        {arr_cid, arr_tid, arr_ts, arr_seq, arr_tick, arr_hash,
-         arr_bp, arr_bs, arr_ap, arr_as,
-         arr_tp, arr_tsz, arr_ts2, arr_fee, arr_tts, arr_ht});
-
-    std::string path = snapshot_path(book.get_asset().token_id());
-    std::string parent = parent_path(path);
-    if (!parent.empty()) {
-        (void)fs_->CreateDir(parent, /*recursive=*/true);
+    arrow::ArrayVector columns{arr_cid, arr_tid, arr_ts, arr_seq, arr_tick, arr_hash,
+                               arr_bp, arr_bs, arr_ap, arr_as,
+                               arr_tp, arr_tsz, arr_ts2, arr_fee, arr_tts, arr_ht};
+    if (changes) {
+        arrow::UInt64Builder base_b;
+        (void)base_b.Append(changes->base_sequence_number);
+        std::shared_ptr<arrow::Array> arr_base;
+        (void)base_b.Finish(&arr_base);
+        columns.push_back(arr_base);
     }
-
-    auto outfile = fs_->OpenOutputStream(path).ValueOrDie();
-    (void)::parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), outfile, 1);
-    (void)outfile->Close();
+    return arrow::Table::Make(schema, columns);
 }
 
-std::optional<OrderBook> ParquetOrderBookRepository::get_latest_snapshot(
-    const MarketAsset& asset) const {
-    std::lock_guard lock(mutex_);
-
-    std::string path = snapshot_path(asset.token_id());
-    auto file_info = fs_->GetFileInfo(path);
-    if (!file_info.ok() || file_info->type() == arrow::fs::FileType::NotFound) {
-        return std::nullopt;
-    }
-
-    auto infile = fs_->OpenInputFile(path).ValueOrDie();
-    std::unique_ptr<::parquet::arrow::FileReader> reader;
-    auto reader_result = ::parquet::arrow::FileReader::Make(arrow::default_memory_pool(), ::parquet::ParquetFileReader::Open(infile));
-    if (!reader_result.ok()) return std::nullopt;
-    reader = std::move(reader_result).ValueOrDie();
-
-    std::shared_ptr<arrow::Table> table;
-    auto read_status = reader->ReadTable(&table);
-    if (!read_status.ok() || table->num_rows() == 0) return std::nullopt;
+// One row of a snapshot (or snapshot diff) table, before it becomes a book
+struct StoredBook {
+    BookSnapshot snapshot;
+    Price tick_size;
+    std::optional<TradeEvent> trade;
+};
 
-    // Read the single row
+StoredBook stored_book_at(const arrow::Table& table, int64_t row) {
     auto cid = std::static_pointer_cast<arrow::StringArray>(
-        table->column(0)->chunk(0))->GetString(0);
+        table.column(0)->chunk(0))->GetString(row);
     auto tid = std::static_pointer_cast<arrow::StringArray>(
-        table->column(1)->chunk(0))->GetString(0);
-
-    // Verify this is the right asset
-    if (tid != asset.token_id() || cid != asset.condition_id()) return std::nullopt;
+        table.column(1)->chunk(0))->GetString(row);
 
     auto ts = std::static_pointer_cast<arrow::Int64Array>(
-        table->column(2)->chunk(0))->Value(0);
+        table.column(2)->chunk(0))->Value(row);
     auto seq = std::static_pointer_cast<arrow::UInt64Array>(
-        table->column(3)->chunk(0))->Value(0);
+        table.column(3)->chunk(0))->Value(row);
 
     // Build a BookSnapshot to apply to an empty book
     MarketAsset snap_asset(cid, tid);
     std::string snap_hash = std::static_pointer_cast<arrow::StringArray>(
-        table->column(5)->chunk(0))->GetString(0);
+        table.column(5)->chunk(0))->GetString(row);
 
     std::vector<PriceLevel> bids, asks;
 
-    auto bp_list = std::static_pointer_cast<arrow::ListArray>(table->column(6)->chunk(0));
-    auto bs_list = std::static_pointer_cast<arrow::ListArray>(table->column(7)->chunk(0));
-    auto bp_values = std::static_pointer_cast<arrow::DoubleArray>(bp_list->values());
-    auto bs_values = std::static_pointer_cast<arrow::DoubleArray>(bs_list->values());
+    auto bp_list = std::static_pointer_cast<arrow::ListArray>(table.column(6)->chunk(0));
+    auto bs_list = std::static_pointer_cast<arrow::ListArray>(table.column(7)->chunk(0));
+    auto bp_values = bp_list->values();
+    auto bs_values = bs_list->values();
 
-    int32_t bp_start = bp_list->value_offset(0);
-    int32_t bp_end = bp_list->value_offset(1);
+    int32_t bp_start = bp_list->value_offset(row);
+    int32_t bp_end = bp_list->value_offset(row + 1);
     for (int32_t j = bp_start; j < bp_end; ++j) {
-        bids.emplace_back(Price(bp_values->Value(j)), Quantity(bs_values->Value(j)));
+        bids.emplace_back(price_at(*bp_values, j), quantity_at(*bs_values, j));
     }
 
-    auto ap_list = std::static_pointer_cast<arrow::ListArray>(table->column(8)->chunk(0));
-    auto as_list = std::static_pointer_cast<arrow::ListArray>(table->column(9)->chunk(0));
-    auto ap_values = std::static_pointer_cast<arrow::DoubleArray>(ap_list->values());
-    auto as_values = std::static_pointer_cast<arrow::DoubleArray>(as_list->values());
+    auto ap_list = std::static_pointer_cast<arrow::ListArray>(table.column(8)->chunk(0));
+    auto as_list = std::static_pointer_cast<arrow::ListArray>(table.column(9)->chunk(0));
+    auto ap_values = ap_list->values();
+    auto as_values = as_list->values();
 
-    int32_t ap_start = ap_list->value_offset(0);
-    int32_t ap_end = ap_list->value_offset(1);
+    int32_t ap_start = ap_list->value_offset(row);
+    int32_t ap_end = ap_list->value_offset(row + 1);
     for (int32_t j = ap_start; j < ap_end; ++j) {
-        asks.emplace_back(Price(ap_values->Value(j)), Quantity(as_values->Value(j)));
+        asks.emplace_back(price_at(*ap_values, j), quantity_at(*as_values, j));
     }
 
-    BookSnapshot snap{{snap_asset, Timestamp(ts), seq}, std::move(bids), std::move(asks), snap_hash};
-    auto book = OrderBook::empty(snap_asset).apply(snap);
-
-    // Apply tick size if different from default
-    auto tick_size = std::static_pointer_cast<arrow::DoubleArray>(
-        table->column(4)->chunk(0))->Value(0);
-    if (tick_size != 0.01) {
-        TickSizeChange tick_change{{snap_asset, Timestamp(ts), seq}, Price(0.01), Price(tick_size)};
-        book = book.apply(tick_change);
-    }
+    StoredBook stored{BookSnapshot{{snap_asset, Timestamp(ts), seq}, std::move(bids), std::move(asks), snap_hash},
+                      price_at(*table.column(4)->chunk(0), row), std::nullopt};
 
-    // Apply trade if present
     auto has_trade = std::static_pointer_cast<arrow::BooleanArray>(
-        table->column(15)->chunk(0))->Value(0);
+        table.column(15)->chunk(0))->Value(row);
     if (has_trade) {
-        TradeEvent trade{
+        stored.trade = TradeEvent{
             {snap_asset,
              Timestamp(std::static_pointer_cast<arrow::Int64Array>(
-                 table->column(14)->chunk(0))->Value(0)),
+                 table.column(14)->chunk(0))->Value(row)),
              seq},
-            Price(std::static_pointer_cast<arrow::DoubleArray>(
-                table->column(10)->chunk(0))->Value(0)),
-            Quantity(std::static_pointer_cast<arrow::DoubleArray>(
-                table->column(11)->chunk(0))->Value(0)),
+            price_at(*table.column(10)->chunk(0), row),
+            quantity_at(*table.column(11)->chunk(0), row),
             static_cast<Side>(std::static_pointer_cast<arrow::UInt8Array>(
-                table->column(12)->chunk(0))->Value(0)),
+                table.column(12)->chunk(0))->Value(row)),
             std::static_pointer_cast<arrow::StringArray>(
-                table->column(13)->chunk(0))->GetString(0)
+                table.column(13)->chunk(0))->GetString(row)
         };
-        book = book.apply(trade);
+    }
+    return stored;
+}
+
+OrderBook book_from(const StoredBook& stored) {
+    const auto& header = stored.snapshot;
+    auto book = OrderBook::empty(header.asset).apply(stored.snapshot);
+
+    // Apply tick size if different from default
+    if (stored.tick_size != Price(0.01)) {
+        TickSizeChange tick_change{{header.asset, header.timestamp, header.sequence_number},
+                                   Price(0.01), stored.tick_size};
+        book = book.apply(tick_change);
     }
 
+    // Apply trade if present
+    if (stored.trade) {
+        book = book.apply(*stored.trade);
+    }
     return book;
 }
 
-// --- Path helpers ---
+// Rebuild the book stored in one row of a snapshot table
+OrderBook book_from_snapshot_row(const arrow::Table& table, int64_t row) {
+    return book_from(stored_book_at(table, row));
+}
 
-std::string ParquetOrderBookRepository::events_dir(
-    const std::string& event_type, const std::string& token_id) const {
-    return "events/" + event_type + "/" + token_prefix(token_id);
+// Event type of an event file, from the path component after "events/":
+//   "events/book_snapshot/6581861/2025-07-15/file.parquet" -> "book_snapshot"
+std::string event_type_of(const std::string& path) {
+    const std::string events_prefix = "events/";
+    auto events_pos = path.find(events_prefix);
+    if (events_pos == std::string::npos) return "";
+    return first_path_component(path.substr(events_pos + events_prefix.size()));
 }
 
-std::string ParquetOrderBookRepository::snapshot_path(const std::string& token_id) const {
-    return "snapshots/" + token_hash(token_id) + ".parquet";
+// Which assets' rows an event read keeps: one asset, a set of them, or
+// (neither) every asset
+struct AssetFilter {
+    const MarketAsset* asset = nullptr;
+    const std::unordered_set<MarketAsset>* assets = nullptr;
+};
+
+// The asset of each row of a batch. Files are written per market, so rows
+// come in long runs of the same ids: each run is interned and checked
+// against the filter once, rather than every row copying and comparing its
+// strings.
+class BatchAssets {
+public:
+    BatchAssets(const arrow::Array& condition_ids, const arrow::Array& token_ids, const AssetFilter& filter)
+        : cids_(static_cast<const arrow::StringArray&>(condition_ids))
+        , tids_(static_cast<const arrow::StringArray&>(token_ids))
+        , filter_(filter) {}
+
+    // Null when the filter drops row i
+    const MarketAsset* at(int64_t i) {
+        auto tid = tids_.GetView(i);
+        auto cid = cids_.GetView(i);
+        if (!open_ || tid != tid_ || cid != cid_) start_run(cid, tid);
+        return current_ ? &*current_ : nullptr;
+    }
+
+private:
+    void start_run(std::string_view cid, std::string_view tid) {
+        open_ = true;
+        cid_ = cid;
+        tid_ = tid;
+        current_.reset();
+        if (filter_.asset) {
+            // Compare before interning so other markets' ids never are
+            if (tid == filter_.asset->token_id() && cid == filter_.asset->condition_id()) {
+                current_ = *filter_.asset;
+            }
+            return;
+        }
+        MarketAsset asset(cid, tid);
+        if (!filter_.assets || filter_.assets->count(asset)) current_ = asset;
+    }
+
+    const arrow::StringArray& cids_;
+    const arrow::StringArray& tids_;
+    const AssetFilter& filter_;
+    bool open_{false};
+    std::string_view cid_;
+    std::string_view tid_;
+    std::optional<MarketAsset> current_;
+};
+
+// A price or size column as int64 micro-units: the Int64 value buffer
+// itself, or (files from before the fixed-point switch) float64 values
+// converted in one pass
+class FixedColumn {
+public:
+    explicit FixedColumn(const arrow::Array& array) {
+        if (array.type_id() == arrow::Type::INT64) {
+            values_ = static_cast<const arrow::Int64Array&>(array).raw_values();
+            return;
+        }
+        const auto& doubles = static_cast<const arrow::DoubleArray&>(array);
+        const double* in = doubles.raw_values();
+        converted_.resize(static_cast<size_t>(doubles.length()));
+        for (size_t i = 0; i < converted_.size(); ++i) {
+            converted_[i] = std::llround(in[i] * kFixedPointScale);
+        }
+        values_ = converted_.data();
+    }
+
+    FixedColumn(const FixedColumn&) = delete;
+    FixedColumn& operator=(const FixedColumn&) = delete;
+
+    Price price(int64_t i) const { return Price::from_micros(values_[i]); }
+    Quantity quantity(int64_t i) const { return Quantity::from_units(values_[i]); }
+
+private:
+    const int64_t* values_ = nullptr;
+    std::vector<int64_t> converted_;
+};
+
+// A selected row and its asset
+struct SelectedRow {
+    int64_t row;
+    const MarketAsset* asset;
+};
+
+// The rows of a batch after min_sequence whose asset passes the filter
+std::vector<SelectedRow> select_rows(const arrow::RecordBatch& batch, BatchAssets& assets,
+                                     uint64_t min_sequence) {
+    const uint64_t* seqs = static_cast<const arrow::UInt64Array&>(*batch.column(3)).raw_values();
+    std::vector<SelectedRow> rows;
+    rows.reserve(static_cast<size_t>(batch.num_rows()));
+    for (int64_t i = 0; i < batch.num_rows(); ++i) {
+        if (seqs[i] <= min_sequence) continue;
+        if (auto* asset = assets.at(i)) rows.push_back({i, asset});
+    }
+    return rows;
+}
+
+// Reassemble the BookDeltas of a flat_book_delta_schema batch: a run of
+// rows with the same token_id and sequence_number is one delta. A run can
+// continue from the previous batch, whose last delta is result.back() when
+// `open` is set.
+void decode_flat_delta_batch(const arrow::RecordBatch& batch, BatchAssets& assets, uint64_t min_sequence,
+                             bool& open, std::vector<OrderBookEventVariant>& result) {
+    const auto* ts = static_cast<const arrow::Int64Array&>(*batch.column(2)).raw_values();
+    const auto* seqs = static_cast<const arrow::UInt64Array&>(*batch.column(3)).raw_values();
+    const auto* sides = static_cast<const arrow::UInt8Array&>(*batch.column(4)).raw_values();
+    FixedColumn prices(*batch.column(5));
+    FixedColumn sizes(*batch.column(6));
+    FixedColumn best_bids(*batch.column(7));
+    FixedColumn best_asks(*batch.column(8));
+
+    for (int64_t i = 0; i < batch.num_rows(); ++i) {
+        uint64_t seq = seqs[i];
+        const MarketAsset* asset = seq > min_sequence ? assets.at(i) : nullptr;
+        if (!asset) {
+            open = false;
+            continue;
+        }
+        auto* delta = open ? &std::get<BookDelta>(result.back()) : nullptr;
+        if (!delta || delta->sequence_number != seq || delta->asset != *asset) {
+            delta = &std::get<BookDelta>(result.emplace_back(BookDelta{{*asset, Timestamp(ts[i]), seq}, {}}));
+            open = true;
+        }
+        delta->changes.push_back(PriceLevelDelta{
+            asset->token(),
+            prices.price(i),
+            sizes.quantity(i),
+            static_cast<Side>(sides[i]),
+            best_bids.price(i),
+            best_asks.price(i),
+        });
+    }
+}
+
+void decode_snapshot_batch(const arrow::RecordBatch& batch, const std::vector<SelectedRow>& rows,
+                           std::vector<OrderBookEventVariant>& result) {
+    const auto* ts = static_cast<const arrow::Int64Array&>(*batch.column(2)).raw_values();
+    const auto* seqs = static_cast<const arrow::UInt64Array&>(*batch.column(3)).raw_values();
+    const auto& hashes = static_cast<const arrow::StringArray&>(*batch.column(4));
+    const auto& bid_lists = static_cast<const arrow::ListArray&>(*batch.column(5));
+    const auto& ask_lists = static_cast<const arrow::ListArray&>(*batch.column(7));
+    FixedColumn bid_prices(*bid_lists.values());
+    FixedColumn bid_sizes(*static_cast<const arrow::ListArray&>(*batch.column(6)).values());
+    FixedColumn ask_prices(*ask_lists.values());
+    FixedColumn ask_sizes(*static_cast<const arrow::ListArray&>(*batch.column(8)).values());
+
+    for (const auto& [i, asset] : rows) {
+        BookSnapshot snap{{*asset, Timestamp(ts[i]), seqs[i]}, {}, {}, hashes.GetString(i)};
+        snap.bids.reserve(static_cast<size_t>(bid_lists.value_length(i)));
+        for (int32_t j = bid_lists.value_offset(i); j < bid_lists.value_offset(i + 1); ++j) {
+            snap.bids.emplace_back(bid_prices.price(j), bid_sizes.quantity(j));
+        }
+        snap.asks.reserve(static_cast<size_t>(ask_lists.value_length(i)));
+        for (int32_t j = ask_lists.value_offset(i); j < ask_lists.value_offset(i + 1); ++j) {
+            snap.asks.emplace_back(ask_prices.price(j), ask_sizes.quantity(j));
+        }
+        result.push_back(std::move(snap));
+    }
+}
+
+// Deltas in the nested (version 1) layout: one row per delta
+void decode_nested_delta_batch(const arrow::RecordBatch& batch, const std::vector<SelectedRow>& rows,
+                               std::vector<OrderBookEventVariant>& result) {
+    const auto* ts = static_cast<const arrow::Int64Array&>(*batch.column(2)).raw_values();
+    const auto* seqs = static_cast<const arrow::UInt64Array&>(*batch.column(3)).raw_values();
+    const auto& id_lists = static_cast<const arrow::ListArray&>(*batch.column(4));
+    const auto& ids = static_cast<const arrow::StringArray&>(*id_lists.values());
+    FixedColumn prices(*static_cast<const arrow::ListArray&>(*batch.column(5)).values());
+    FixedColumn sizes(*static_cast<const arrow::ListArray&>(*batch.column(6)).values());
+    const auto* sides = static_cast<const arrow::UInt8Array&>(
+        *static_cast<const arrow::ListArray&>(*batch.column(7)).values()).raw_values();
+    FixedColumn best_bids(*static_cast<const arrow::ListArray&>(*batch.column(8)).values());
+    FixedColumn best_asks(*static_cast<const arrow::ListArray&>(*batch.column(9)).values());
+
+    for (const auto& [i, asset] : rows) {
+        BookDelta delta{{*asset, Timestamp(ts[i]), seqs[i]}, {}};
+        delta.changes.reserve(static_cast<size_t>(id_lists.value_length(i)));
+        for (int32_t j = id_lists.value_offset(i); j < id_lists.value_offset(i + 1); ++j) {
+            auto id = ids.GetView(j);
+            // Almost always the row's own token, which is interned already
+            AssetId asset_id = id == asset->token_id() ? asset->token() : AssetId(id);
+            delta.changes.push_back(PriceLevelDelta{
+                asset_id,
+                prices.price(j),
+                sizes.quantity(j),
+                static_cast<Side>(sides[j]),
+                best_bids.price(j),
+                best_asks.price(j),
+            });
+        }
+        result.push_back(std::move(delta));
+    }
+}
+
+void decode_trade_batch(const arrow::RecordBatch& batch, const std::vector<SelectedRow>& rows,
+                        std::vector<OrderBookEventVariant>& result) {
+    const auto* ts = static_cast<const arrow::Int64Array&>(*batch.column(2)).raw_values();
+    const auto* seqs = static_cast<const arrow::UInt64Array&>(*batch.column(3)).raw_values();
+    FixedColumn prices(*batch.column(4));
+    FixedColumn sizes(*batch.column(5));
+    const auto* sides = static_cast<const arrow::UInt8Array&>(*batch.column(6)).raw_values();
+    const auto& fees = static_cast<const arrow::StringArray&>(*batch.column(7));
+
+    for (const auto& [i, asset] : rows) {
+        result.push_back(TradeEvent{
+            {*asset, Timestamp(ts[i]), seqs[i]},
+            prices.price(i),
+            sizes.quantity(i),
+            static_cast<Side>(sides[i]),
+            fees.GetString(i),
+        });
+    }
+}
+
+void decode_tick_size_batch(const arrow::RecordBatch& batch, const std::vector<SelectedRow>& rows,
+                            std::vector<OrderBookEventVariant>& result) {
+    const auto* ts = static_cast<const arrow::Int64Array&>(*batch.column(2)).raw_values();
+    const auto* seqs = static_cast<const arrow::UInt64Array&>(*batch.column(3)).raw_values();
+    FixedColumn old_ticks(*batch.column(4));
+    FixedColumn new_ticks(*batch.column(5));
+
+    for (const auto& [i, asset] : rows) {
+        result.push_back(TickSizeChange{{*asset, Timestamp(ts[i]), seqs[i]}, old_ticks.price(i), new_ticks.price(i)});
+    }
+}
+
+// Rebuild the events in an event file table, a record batch at a time
+// (so the row groups a read returns need not be combined first). Rows at
+// or below min_sequence are skipped, as are rows the filter drops.
+std::vector<OrderBookEventVariant> decode_events(const arrow::Table& table,
+                                                 const std::string& event_type,
+                                                 const AssetFilter& filter,
+                                                 uint64_t min_sequence) {
+    std::vector<OrderBookEventVariant> result;
+    if (table.num_rows() == 0) return result;
+    const bool flat_deltas =
+        event_type == "book_delta" && ParquetSchemas::schema_version(*table.schema()) >= 2;
+
+    arrow::TableBatchReader batches(table);
+    bool open_delta = false;  // a flat delta may continue into the next batch
+    std::shared_ptr<arrow::RecordBatch> batch;
+    while (batches.ReadNext(&batch).ok() && batch) {
+        BatchAssets assets(*batch->column(0), *batch->column(1), filter);
+        if (flat_deltas) {
+            decode_flat_delta_batch(*batch, assets, min_sequence, open_delta, result);
+            continue;
+        }
+
+        auto rows = select_rows(*batch, assets, min_sequence);
+        if (rows.empty()) continue;
+        if (event_type == "book_snapshot") {
+            decode_snapshot_batch(*batch, rows, result);
+        } else if (event_type == "book_delta") {
+            decode_nested_delta_batch(*batch, rows, result);
+        } else if (event_type == "trade_event") {
+            decode_trade_batch(*batch, rows, result);
+        } else if (event_type == "tick_size_change") {
+            decode_tick_size_batch(*batch, rows, result);
+        }
+    }
+
+    return result;
+}
+
+// One event file as replay_events reads it: a row group at a time, keeping
+// the events of `assets` after min_sequence. A flat delta's rows can run
+// into the next row group, so the last event of a group is held back until
+// the next one is decoded.
+class EventFileCursor {
+public:
+    EventFileCursor(std::unique_ptr<::parquet::arrow::FileReader> reader, std::string event_type,
+                    const std::unordered_set<MarketAsset>& assets,
+                    const std::vector<std::string>& tokens, uint64_t min_sequence)
+        : reader_(std::move(reader))
+        , event_type_(std::move(event_type))
+        , assets_(assets)
+        , tokens_(tokens)
+        , min_sequence_(min_sequence) {
+        if (reader_) {
+            groups_ = reader_->parquet_reader()->metadata()->num_row_groups();
+            fill();
+        }
+    }
+
+    // Null once the file is exhausted
+    OrderBookEventVariant* current() { return pos_ < batch_.size() ? &batch_[pos_] : nullptr; }
+
+    void advance() {
+        if (++pos_ >= batch_.size()) fill();
+    }
+
+private:
+    // Decode row groups until one yields events or none are left
+    void fill() {
+        batch_.clear();
+        pos_ = 0;
+        while (batch_.empty() && next_group_ < groups_) {
+            decode_group(next_group_++);
+        }
+        if (batch_.empty() && carry_) {
+            batch_.push_back(std::move(*carry_));
+            carry_.reset();
+        }
+    }
+
+    void decode_group(int group) {
+        auto metadata = reader_->parquet_reader()->metadata()->RowGroup(group);
+        bool excluded = std::all_of(tokens_.begin(), tokens_.end(), [&](const auto& token) {
+            return row_group_excluded(*metadata, token, min_sequence_);
+        });
+        if (excluded) return;
+
+        std::shared_ptr<arrow::Table> table;
+        if (!reader_->ReadRowGroup(group, &table).ok()) {
+            next_group_ = groups_;  // unreadable: end the file here
+            return;
+        }
+        auto events = decode_events(*table, event_type_, AssetFilter{nullptr, &assets_}, min_sequence_);
+
+        if (carry_) {
+            auto* continued = events.empty() ? nullptr : std::get_if<BookDelta>(&events.front());
+            auto* carried = std::get_if<BookDelta>(&*carry_);
+            if (continued && carried && continued->sequence_number == carried->sequence_number &&
+                continued->asset == carried->asset) {
+                carried->changes.insert(carried->changes.end(),
+                                        std::make_move_iterator(continued->changes.begin()),
+                                        std::make_move_iterator(continued->changes.end()));
+                events.front() = std::move(*carry_);
+            } else {
+                events.insert(events.begin(), std::move(*carry_));
+            }
+            carry_.reset();
+        }
+        if (event_type_ == "book_delta" && next_group_ < groups_ && !events.empty()) {
+            carry_ = std::move(events.back());
+            events.pop_back();
+        }
+        batch_ = std::move(events);
+    }
+
+    std::unique_ptr<::parquet::arrow::FileReader> reader_;
+    std::string event_type_;
+    const std::unordered_set<MarketAsset>& assets_;
+    const std::vector<std::string>& tokens_;
+    uint64_t min_sequence_;
+    int groups_{0};
+    int next_group_{0};
+    std::vector<OrderBookEventVariant> batch_;
+    size_t pos_{0};
+    std::optional<OrderBookEventVariant> carry_;
+};
+
+// "500ms", "1s", "5m", "1h": the largest unit that divides the interval
+std::string interval_label(int64_t interval_ms) {
+    if (interval_ms % 3'600'000 == 0) return std::to_string(interval_ms / 3'600'000) + "h";
+    if (interval_ms % 60'000 == 0) return std::to_string(interval_ms / 60'000) + "m";
+    if (interval_ms % 1000 == 0) return std::to_string(interval_ms / 1000) + "s";
+    return std::to_string(interval_ms) + "ms";
+}
+
+// Every bar_schema column after the asset ids, by name
+constexpr std::pair<const char*, int64_t Bar::*> kBarValueColumns[] = {
+    {"interval_ms", &Bar::interval_ms}, {"start_ms", &Bar::start_ms},
+    {"open", &Bar::open}, {"high", &Bar::high}, {"low", &Bar::low}, {"close", &Bar::close},
+    {"volume", &Bar::volume}, {"buy_volume", &Bar::buy_volume},
+    {"mid_open", &Bar::mid_open}, {"mid_high", &Bar::mid_high}, {"mid_low", &Bar::mid_low},
+    {"mid_close", &Bar::mid_close}, {"spread_close", &Bar::spread_close}, {"spread_max", &Bar::spread_max},
+};
+constexpr std::pair<const char*, uint32_t Bar::*> kBarCountColumns[] = {
+    {"trade_count", &Bar::trade_count}, {"quote_updates", &Bar::quote_updates},
+};
+
+std::shared_ptr<arrow::Table> make_bar_table(const std::vector<const Bar*>& bars) {
+    auto schema = ParquetSchemas::bar_schema();
+    arrow::ArrayVector columns;
+    auto append = [&](arrow::ArrayBuilder& builder) {
+        std::shared_ptr<arrow::Array> array;
+        (void)builder.Finish(&array);
+        columns.push_back(std::move(array));
+    };
+
+    arrow::StringBuilder cid_builder, tid_builder;
+    for (const auto* bar : bars) {
+        (void)cid_builder.Append(bar->asset.condition_id());
+        (void)tid_builder.Append(bar->asset.token_id());
+    }
+    append(cid_builder);
+    append(tid_builder);
+
+    for (int i = 2; i < schema->num_fields(); ++i) {
+        const auto& name = schema->field(i)->name();
+        for (const auto& [column, member] : kBarValueColumns) {
+            if (name != column) continue;
+            arrow::Int64Builder builder;
+            for (const auto* bar : bars) (void)builder.Append(bar->*member);
+            append(builder);
+        }
+        for (const auto& [column, member] : kBarCountColumns) {
+            if (name != column) continue;
+            arrow::UInt32Builder builder;
+            for (const auto* bar : bars) (void)builder.Append(bar->*member);
+            append(builder);
+        }
+    }
+    return arrow::Table::Make(schema, columns);
+}
+
+} // namespace
+
+ParquetOrderBookRepository::ParquetOrderBookRepository(
+    std::shared_ptr<arrow::fs::FileSystem> fs,
+    const mde::config::StorageSettings& settings,
+    Access access)
+    : fs_(std::move(fs))
+    , settings_(settings)
+    , access_(access)
+    , pool_(memory_pool_named(settings.memory_pool))
+    , last_age_check_(std::chrono::steady_clock::now()) {
+    settings_.parquet.row_group_rows = std::max(settings_.parquet.row_group_rows, 1);
+    snapshot_properties_ = make_writer_properties(settings_.parquet, *ParquetSchemas::book_snapshot_schema());
+    delta_properties_ = make_writer_properties(settings_.parquet, *ParquetSchemas::flat_book_delta_schema());
+    nested_delta_properties_ = make_writer_properties(settings_.parquet, *ParquetSchemas::book_delta_schema());
+    trade_properties_ = make_writer_properties(settings_.parquet, *ParquetSchemas::trade_event_schema());
+    tick_size_properties_ = make_writer_properties(settings_.parquet, *ParquetSchemas::tick_size_change_schema());
+    book_properties_ = make_writer_properties(settings_.parquet, *ParquetSchemas::order_book_snapshot_schema());
+    bar_properties_ = make_writer_properties(settings_.parquet, *ParquetSchemas::bar_schema());
+    if (access_ == Access::read_only) return;
+
+    // The log is replayed before any worker starts, so its flushes are
+    // written synchronously and a failure throws with no thread to join
+    if (!settings_.wal_directory.empty()) {
+        wal::WalOptions options;
+        options.directory = settings_.wal_directory;
+        options.sync_interval = std::chrono::milliseconds(settings_.wal_sync_interval_ms);
+        wal_ = std::make_unique<wal::WriteAheadLog>(std::move(options));
+        replay_wal();
+    }
+
+    try {
+        for (int i = 0; i < settings_.flush_threads; ++i) {
+            flush_workers_.emplace_back([this] { run_flush_worker(); });
+        }
+    } catch (...) {
+        stop_flush_workers();
+        throw;
+    }
+}
+
+ParquetOrderBookRepository::~ParquetOrderBookRepository() {
+    try {
+        flush();
+    } catch (const std::exception& e) {
+        // The log keeps the events for the next start
+        std::cerr << "[parquet] Final flush failed: " << e.what() << std::endl;
+    }
+    stop_flush_workers();
+    release_wal();
+}
+
+void ParquetOrderBookRepository::stop_flush_workers() {
+    {
+        std::lock_guard lock(flush_mutex_);
+        stopping_ = true;
+    }
+    // Workers drain the queue before exiting
+    flush_cv_.notify_all();
+    for (auto& worker : flush_workers_) {
+        worker.join();
+    }
+}
+
+std::shared_ptr<arrow::fs::FileSystem> ParquetOrderBookRepository::make_local_fs(
+    const std::string& root_dir, bool use_mmap) {
+    auto options = arrow::fs::LocalFileSystemOptions::Defaults();
+    options.use_mmap = use_mmap;
+    auto local = std::make_shared<arrow::fs::LocalFileSystem>(options);
+    (void)local->CreateDir(root_dir, /*recursive=*/true);
+    return std::make_shared<arrow::fs::SubTreeFileSystem>(root_dir, local);
+}
+
+std::shared_ptr<arrow::fs::FileSystem> ParquetOrderBookRepository::make_s3_fs(
+    const mde::config::StorageSettings& settings) {
+    auto options = arrow::fs::S3Options::Defaults();
+    options.region = settings.s3_region;
+    options.scheme = settings.s3_scheme;
+    if (!settings.s3_endpoint_override.empty()) {
+        options.endpoint_override = settings.s3_endpoint_override;
+    }
+
+    auto s3fs = arrow::fs::S3FileSystem::Make(options).ValueOrDie();
+    std::string base_path = settings.s3_bucket;
+    if (!settings.s3_prefix.empty()) {
+        base_path += "/" + settings.s3_prefix;
+    }
+    std::shared_ptr<arrow::fs::FileSystem> fs = std::make_shared<arrow::fs::SubTreeFileSystem>(base_path, s3fs);
+    if (!settings.s3_cache_directory.empty()) {
+        DiskCacheOptions cache;
+        cache.directory = settings.s3_cache_directory;
+        cache.max_bytes = static_cast<uint64_t>(std::max(settings.s3_cache_max_mb, 1)) << 20;
+        fs = std::make_shared<CachingFileSystem>(std::move(fs), std::move(cache));
+    }
+    return fs;
+}
+
+size_t ParquetOrderBookRepository::PartitionKeyHash::operator()(
+    const PartitionKey& key) const noexcept {
+    size_t h = std::hash<std::string>{}(key.prefix);
+    h ^= std::hash<int64_t>{}(key.hour) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h ^ key.event_type;
+}
+
+void ParquetOrderBookRepository::append_event(const OrderBookEventVariant& event) {
+    append_event(OrderBookEventVariant(event));
+}
+
+void ParquetOrderBookRepository::append_event(OrderBookEventVariant&& event) {
+    require_writable("append_event");
+    std::vector<PartitionKey> due;
+    buffer_event(std::move(event), std::nullopt, due);
+    add_aged_partitions(due);
+    flush(due);
+}
+
+void ParquetOrderBookRepository::append_events(std::span<OrderBookEventVariant> events) {
+    require_writable("append_events");
+    std::vector<PartitionKey> due;
+    for (auto& event : events) {
+        buffer_event(std::move(event), std::nullopt, due);
+        if (!due.empty()) {
+            flush(due);
+            due.clear();
+        }
+    }
+    add_aged_partitions(due);
+    flush(due);
+}
+
+void ParquetOrderBookRepository::require_writable(const char* operation) const {
+    if (access_ == Access::read_only) {
+        throw std::logic_error(std::string(operation) + " on a read-only Parquet repository");
+    }
+}
+
+ParquetOrderBookRepository::PartitionShard& ParquetOrderBookRepository::shard_for(
+    const std::string& prefix) const {
+    return shards_[std::hash<std::string>{}(prefix) % kPartitionShards];
+}
+
+ParquetOrderBookRepository::SnapshotStripe& ParquetOrderBookRepository::stripe_for(
+    const std::string& token_id) const {
+    return snapshot_stripes_[std::hash<std::string>{}(token_id) % kSnapshotStripes];
+}
+
+void ParquetOrderBookRepository::buffer_event(OrderBookEventVariant&& event,
+                                              std::optional<uint64_t> wal_segment,
+                                              std::vector<PartitionKey>& due) {
+    PartitionKey key{event.index(), token_prefix(get_asset(event).token_id()),
+                     get_timestamp_ms(event) / kMillisPerHour};
+    auto& shard = shard_for(key.prefix);
+    std::lock_guard lock(shard.mutex);
+
+    // Logged first: an event the log could not take is not buffered either.
+    // Both happen under the shard lock, so a partition's events are in the
+    // log in the order they are in the partition.
+    if (!wal_segment && wal_) {
+        std::lock_guard wal_lock(wal_mutex_);
+        wal_segment = wal_->append(event);
+    }
+
+    auto [it, inserted] = shard.partitions.try_emplace(key);
+    if (inserted) {
+        it->second.opened = std::chrono::steady_clock::now();
+        it->second.wal_segment = wal_segment.value_or(0);
+    }
+    it->second.events.push_back(std::move(event));
+    if (it->second.events.size() >= static_cast<size_t>(settings_.write_buffer_size)) {
+        due.push_back(std::move(key));
+    }
+}
+
+void ParquetOrderBookRepository::add_aged_partitions(std::vector<PartitionKey>& due) {
+    auto now = std::chrono::steady_clock::now();
+    auto last = last_age_check_.load(std::memory_order_relaxed);
+    if (now - last < std::chrono::seconds(1)) return;
+    // One appending thread sweeps; the others go on
+    if (!last_age_check_.compare_exchange_strong(last, now, std::memory_order_relaxed)) return;
+
+    auto max_age = std::chrono::seconds(settings_.buffer_age_seconds);
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        for (const auto& [key, partition] : shard.partitions) {
+            // A key already due by size may repeat; flush() skips it the second time
+            if (now - partition.opened >= max_age) due.push_back(key);
+        }
+    }
+}
+
+void ParquetOrderBookRepository::replay_wal() {
+    // A crash between writing a file and deleting its segments leaves events
+    // that are in both; the manifests say which
+    std::unordered_map<std::string, std::vector<ManifestEntry>> manifests;
+    size_t replayed = 0;
+    size_t skipped = 0;
+    wal_->replay([&](uint64_t segment, OrderBookEventVariant&& event) {
+        if (in_manifest(event, manifests)) {
+            ++skipped;
+            return;
+        }
+        std::vector<PartitionKey> due;
+        buffer_event(std::move(event), segment, due);
+        add_aged_partitions(due);
+        flush(due);
+        ++replayed;
+    });
+    if (replayed > 0 || skipped > 0) {
+        std::cerr << "[parquet] Replayed " << replayed << " events from the write-ahead log ("
+                  << skipped << " already written)" << std::endl;
+    }
+
+    // Compact what the last run left behind so its segments can go
+    flush();
+    release_wal();
+}
+
+bool ParquetOrderBookRepository::in_manifest(
+    const OrderBookEventVariant& event,
+    std::unordered_map<std::string, std::vector<ManifestEntry>>& manifests) const {
+    const auto& token_id = get_asset(event).token_id();
+    auto dir = events_dir(kEventTypes[event.index()], token_id);
+    auto it = manifests.find(dir);
+    if (it == manifests.end()) it = manifests.emplace(dir, manifest_for(dir)).first;
+
+    auto seq = get_seq(event);
+    auto ts = get_timestamp_ms(event);
+    // A range of 0..0 is unknown too: manifests rebuilt by listing stored
+    // that before listed entries were left open
+    auto unknown_range = [](const ManifestEntry& entry) {
+        return entry.ts_start_ms == 0 && entry.ts_end_ms == 0;
+    };
+    return std::any_of(it->second.begin(), it->second.end(), [&](const ManifestEntry& entry) {
+        return entry.seq_start <= seq && seq <= entry.seq_end &&
+               (unknown_range(entry) || (entry.ts_start_ms <= ts && ts <= entry.ts_end_ms)) &&
+               (entry.token_ids.empty() ||
+                std::find(entry.token_ids.begin(), entry.token_ids.end(), token_id) !=
+                    entry.token_ids.end());
+    });
+}
+
+void ParquetOrderBookRepository::release_wal() {
+    if (!wal_) return;
+    // Every segment before the oldest one still holding an unwritten event.
+    // The current segment is read first: an event appended after that is in
+    // it or a later one. A flush moves a partition into pending_flushes_
+    // under its shard lock, so the partitions and then the pending files
+    // miss no event in between.
+    uint64_t keep_from;
+    {
+        std::lock_guard lock(wal_mutex_);
+        keep_from = wal_->current_segment();
+    }
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        for (const auto& [key, partition] : shard.partitions) {
+            keep_from = std::min(keep_from, partition.wal_segment);
+        }
+    }
+    {
+        std::lock_guard lock(flush_mutex_);
+        for (const auto& job : pending_flushes_) {
+            keep_from = std::min(keep_from, job->wal_segment);
+        }
+        if (wal_retained_) keep_from = std::min(keep_from, *wal_retained_);
+    }
+    std::lock_guard lock(wal_mutex_);
+    wal_->release_before(keep_from);
+}
+
+void ParquetOrderBookRepository::flush() {
+    std::vector<PartitionKey> keys;
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        for (const auto& entry : shard.partitions) {
+            keys.push_back(entry.first);
+        }
+    }
+    flush(keys);
+}
+
+void ParquetOrderBookRepository::flush(const std::vector<PartitionKey>& keys) {
+    if (keys.empty()) return;
+
+    if (async_flush()) {
+        // Backpressure: wait (holding no shard lock) for the writers to make
+        // room before taking buffers out, so the events stay readable. The
+        // slots are reserved so concurrent flushes cannot overfill the queue
+        // between the wait and the swap. A flush larger than the whole queue
+        // only waits for it to empty.
+        auto capacity = static_cast<size_t>(std::max(settings_.max_pending_flushes, 1));
+        std::unique_lock lock(flush_mutex_);
+        auto has_room = [&] {
+            auto queued = pending_flushes_.size() + reserved_flushes_;
+            return queued == 0 || queued + keys.size() <= capacity;
+        };
+        if (!has_room()) {
+            ++stats_.backpressure_waits;
+            flush_cv_.wait(lock, has_room);
+        }
+        reserved_flushes_ += keys.size();
+    }
+
+    // Another thread may have flushed some of these while we waited. Each
+    // partition moves into pending_flushes_ under its shard lock, so a read
+    // finds its events in one place or the other.
+    std::vector<std::shared_ptr<const FlushJob>> jobs;
+    for (const auto& key : keys) {
+        auto& shard = shard_for(key.prefix);
+        std::lock_guard shard_lock(shard.mutex);
+        auto it = shard.partitions.find(key);
+        if (it == shard.partitions.end()) continue;
+        auto job = std::make_shared<const FlushJob>(make_flush_job(key, it->second));
+        shard.partitions.erase(it);
+
+        std::lock_guard lock(flush_mutex_);
+        pending_flushes_.push_back(job);
+        if (async_flush()) flush_queue_.push_back(job);
+        jobs.push_back(std::move(job));
+    }
+
+    std::unique_lock lock(flush_mutex_);
+    if (async_flush()) {
+        reserved_flushes_ -= keys.size();
+        stats_.queue_depth = pending_flushes_.size();
+        stats_.max_queue_depth = std::max(stats_.max_queue_depth, stats_.queue_depth);
+        flush_cv_.notify_all();
+        return;
+    }
+
+    // Written by this thread, holding no lock, so appends to other shards
+    // and reads go on meanwhile
+    auto done = [&](const std::shared_ptr<const FlushJob>& job) {
+        pending_flushes_.erase(std::find(pending_flushes_.begin(), pending_flushes_.end(), job));
+    };
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        lock.unlock();
+        auto start = std::chrono::steady_clock::now();
+        int64_t bytes = 0;
+        try {
+            bytes = write_flush_job(*jobs[i]);
+        } catch (...) {
+            // This and the remaining jobs are dropped; the log still has
+            // their events, so keep it for the next start to replay
+            lock.lock();
+            record_flush(elapsed_since(start), false, 0);
+            for (size_t j = i; j < jobs.size(); ++j) {
+                done(jobs[j]);
+                if (wal_) {
+                    wal_retained_ = std::min(wal_retained_.value_or(jobs[j]->wal_segment),
+                                             jobs[j]->wal_segment);
+                }
+            }
+            throw;
+        }
+        lock.lock();
+        done(jobs[i]);
+        record_flush(elapsed_since(start), true, bytes);
+    }
+    lock.unlock();
+    release_wal();
+}
+
+ParquetOrderBookRepository::FlushJob ParquetOrderBookRepository::make_flush_job(
+    const PartitionKey& key, Partition& partition) const {
+    auto& events = partition.events;
+    const auto& event_type = kEventTypes[key.event_type];
+    auto first_ts = get_timestamp_ms(events.front());
+
+    // Events arrive in sequence order, so the range is first..last
+    uint64_t seq_start = get_seq(events.front());
+    uint64_t seq_end = get_seq(events.back());
+
+    std::string dir = events_dir(event_type, get_asset(events.front()).token_id());
+    std::string filename = event_type + "_" + hour_string(first_ts) + "_"
+        + std::to_string(seq_start) + "_" + std::to_string(seq_end) + ".parquet";
+    std::string path = dir + "/" + date_string(first_ts) + "/" + filename;
+
+    return FlushJob{event_type, std::move(dir), std::move(path), std::move(events),
+                    partition.wal_segment};
+}
+
+int64_t ParquetOrderBookRepository::write_flush_job(const FlushJob& job) {
+    auto bytes = write_event_file(job);
+
+    // Only after the file itself is complete, so the manifest never lists a
+    // file that does not exist
+    record_in_manifest(job);
+    return bytes;
+}
+
+int64_t ParquetOrderBookRepository::write_event_file(const FlushJob& job) {
+    (void)fs_->CreateDir(parent_path(job.path), /*recursive=*/true);
+
+    if (job.event_type == "book_snapshot") {
+        return write_book_snapshots(job.path, job.events);
+    } else if (job.event_type == "book_delta") {
+        return write_book_deltas(job.path, job.events);
+    } else if (job.event_type == "trade_event") {
+        return write_trade_events(job.path, job.events);
+    } else if (job.event_type == "tick_size_change") {
+        return write_tick_size_changes(job.path, job.events);
+    }
+    return 0;
+}
+
+int64_t ParquetOrderBookRepository::write_event_table(
+    const std::string& path, const arrow::Table& table,
+    const std::shared_ptr<::parquet::WriterProperties>& properties) {
+    auto outfile_result = fs_->OpenOutputStream(path);
+    if (!outfile_result.ok()) {
+        throw std::runtime_error("Failed to write " + path + ": " + outfile_result.status().ToString());
+    }
+    auto outfile = std::move(outfile_result).ValueOrDie();
+    auto write_status = ::parquet::arrow::WriteTable(table, arrow::default_memory_pool(), outfile,
+                                                     settings_.parquet.row_group_rows, properties);
+    // The footer is written by now; Close only flushes
+    int64_t bytes = outfile->Tell().ValueOr(0);
+    auto close_status = outfile->Close();
+    if (!write_status.ok() || !close_status.ok()) {
+        // A partial file must not be found by a later listing
+        (void)fs_->DeleteFile(path);
+        throw std::runtime_error("Failed to write " + path + ": " +
+                                 (write_status.ok() ? close_status : write_status).ToString());
+    }
+    return bytes;
+}
+
+void ParquetOrderBookRepository::record_flush(std::chrono::microseconds latency, bool ok,
+                                              int64_t bytes) {
+    if (ok) {
+        ++stats_.files_written;
+        stats_.bytes_written += static_cast<uint64_t>(bytes);
+    } else {
+        ++stats_.failed_writes;
+    }
+    stats_.last_latency = latency;
+    stats_.max_latency = std::max(stats_.max_latency, latency);
+    stats_.total_latency += latency;
+    mde::telemetry::LatencyRegistry::global().record(mde::telemetry::Stage::flush, latency);
+}
+
+void ParquetOrderBookRepository::run_flush_worker() {
+    mde::telemetry::pin_current_thread(settings_.flush_cpus, "parquet flush");
+    // Appends only sync the log once sync_interval has passed, so with
+    // nothing queued the workers also wake that often to sync its tail
+    auto sync_every = std::chrono::milliseconds(settings_.wal_sync_interval_ms);
+    auto ready = [this] { return stopping_ || !flush_queue_.empty(); };
+    std::unique_lock lock(flush_mutex_);
+    while (true) {
+        if (wal_ && sync_every.count() > 0) {
+            if (!flush_cv_.wait_for(lock, sync_every, ready)) {
+                lock.unlock();
+                try {
+                    std::lock_guard wal_lock(wal_mutex_);
+                    wal_->sync();
+                } catch (const std::exception& e) {
+                    std::cerr << "[parquet] " << e.what() << std::endl;
+                }
+                lock.lock();
+                continue;
+            }
+        } else {
+            flush_cv_.wait(lock, ready);
+        }
+        if (flush_queue_.empty()) break;  // stopping and drained
+
+        auto job = std::move(flush_queue_.front());
+        flush_queue_.pop_front();
+
+        lock.unlock();
+        auto start = std::chrono::steady_clock::now();
+        bool ok = true;
+        int64_t bytes = 0;
+        try {
+            bytes = write_flush_job(*job);
+        } catch (const std::exception& e) {
+            // No caller to rethrow to; without a write-ahead log the events
+            // in this file are lost
+            ok = false;
+            std::cerr << "[parquet] Flush of " << job->path << " failed: " << e.what() << std::endl;
+        }
+        auto latency = elapsed_since(start);
+        lock.lock();
+
+        pending_flushes_.erase(std::find(pending_flushes_.begin(), pending_flushes_.end(), job));
+        stats_.queue_depth = pending_flushes_.size();
+        record_flush(latency, ok, bytes);
+        if (!ok && wal_) {
+            wal_retained_ = std::min(wal_retained_.value_or(job->wal_segment), job->wal_segment);
+        }
+        flush_cv_.notify_all();
+
+        // Takes the shard locks, which are ordered before this one
+        lock.unlock();
+        release_wal();
+        lock.lock();
+    }
+}
+
+void ParquetOrderBookRepository::sync() {
+    flush();
+    {
+        std::unique_lock lock(flush_mutex_);
+        flush_cv_.wait(lock, [this] { return pending_flushes_.empty() && reserved_flushes_ == 0; });
+    }
+    if (wal_) {
+        std::lock_guard lock(wal_mutex_);
+        wal_->sync();
+    }
+}
+
+FlushStats ParquetOrderBookRepository::flush_stats() const {
+    FlushStats stats;
+    {
+        std::lock_guard lock(flush_mutex_);
+        stats = stats_;
+    }
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        for (const auto& [key, partition] : shard.partitions) {
+            stats.buffered_events[key.event_type] += partition.events.size();
+        }
+    }
+    return stats;
+}
+
+// --- Write helpers ---
+
+int64_t ParquetOrderBookRepository::write_book_snapshots(
+    const std::string& path,
+    const std::vector<OrderBookEventVariant>& events) {
+    return write_event_table(path, *as_table(book_snapshot_batch(events)), snapshot_properties_);
+}
+
+int64_t ParquetOrderBookRepository::write_book_deltas(
+    const std::string& path,
+    const std::vector<OrderBookEventVariant>& events) {
+
+    // The flat schema has no per-change asset id and no row for a delta
+    // without changes, so anything else keeps the nested one
+    bool flat = std::all_of(events.begin(), events.end(), [](const auto& event) {
+        const auto& delta = std::get<BookDelta>(event);
+        return !delta.changes.empty() &&
+               std::all_of(delta.changes.begin(), delta.changes.end(),
+                           [&](const auto& change) { return change.asset_id == delta.asset.token(); });
+    });
+    if (!flat) {
+        return write_nested_book_deltas(path, events);
+    }
+
+    return write_event_table(path, *as_table(flat_book_delta_batch(events)), delta_properties_);
+}
+
+int64_t ParquetOrderBookRepository::write_nested_book_deltas(
+    const std::string& path,
+    const std::vector<OrderBookEventVariant>& events) {
+    return write_event_table(path, *as_table(book_delta_batch(events)), nested_delta_properties_);
+}
+
+int64_t ParquetOrderBookRepository::write_trade_events(
+    const std::string& path,
+    const std::vector<OrderBookEventVariant>& events) {
+    return write_event_table(path, *as_table(trade_event_batch(events)), trade_properties_);
+}
+
+int64_t ParquetOrderBookRepository::write_tick_size_changes(
+    const std::string& path,
+    const std::vector<OrderBookEventVariant>& events) {
+    return write_event_table(path, *as_table(tick_size_change_batch(events)), tick_size_properties_);
+}
+
+// --- Read path ---
+
+std::vector<OrderBookEventVariant> ParquetOrderBookRepository::get_events_since(
+    const MarketAsset& asset, uint64_t sequence_number) const {
+    std::vector<OrderBookEventVariant> result;
+    auto merge_buffer = [&](const std::vector<OrderBookEventVariant>& buffer) {
+        for (const auto& event : buffer) {
+            if (get_asset(event) == asset && get_seq(event) > sequence_number) {
+                result.push_back(event);
+            }
+        }
+    };
+
+    // The buffered events, then the files being written, then the manifest:
+    // an event a flush moves along in between is seen twice (and dropped
+    // below), never missed. Only the asset's shard is locked, and only
+    // while its events are copied; the manifest and the files are read
+    // holding no repository lock, so reads (e.g. parallel recovery) neither
+    // serialize nor hold up appends.
+    auto prefix = token_prefix(asset.token_id());
+    {
+        auto& shard = shard_for(prefix);
+        std::lock_guard lock(shard.mutex);
+        for (const auto& [key, partition] : shard.partitions) {
+            if (key.prefix == prefix) merge_buffer(partition.events);
+        }
+    }
+
+    // Files still being flushed are read from memory; skipping them on
+    // disk avoids both duplicates and reading a partially written file
+    std::vector<std::shared_ptr<const FlushJob>> pending;
+    {
+        std::lock_guard lock(flush_mutex_);
+        pending = pending_flushes_;
+    }
+    std::unordered_set<std::string> pending_paths;
+    for (const auto& job : pending) {
+        pending_paths.insert(job->path);
+        merge_buffer(job->events);
+    }
+
+    // Files are partitioned by token prefix and indexed by a manifest,
+    // so only candidate files are opened and the store is not listed
+    std::vector<ManifestEntry> files;
+    for (const auto& event_type : kEventTypes) {
+        for (auto& entry : manifest_for(events_dir(event_type, asset.token_id()))) {
+            if (entry.seq_end <= sequence_number) continue;
+            if (pending_paths.count(entry.path)) continue;
+            if (!entry.token_ids.empty() &&
+                std::find(entry.token_ids.begin(), entry.token_ids.end(), asset.token_id()) ==
+                    entry.token_ids.end()) {
+                continue;
+            }
+            files.push_back(std::move(entry));
+        }
+    }
+
+    // Each file is a round trip or more on S3, so up to read_concurrency
+    // of them are opened and decoded at once
+    std::vector<std::vector<OrderBookEventVariant>> per_file(files.size());
+    run_concurrently(files.size(), static_cast<size_t>(std::max(settings_.read_concurrency, 1)),
+                     [&](size_t i) { per_file[i] = read_events_from_file(files[i].path, asset, sequence_number); });
+    for (auto& disk_events : per_file) {
+        result.insert(result.end(), std::make_move_iterator(disk_events.begin()),
+                      std::make_move_iterator(disk_events.end()));
+    }
+
+    // Sort by sequence number. A manifest rebuilt by listing can include
+    // both a compacted file and an input not yet deleted, so drop repeats.
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return get_seq(a) < get_seq(b);
+    });
+    result.erase(std::unique(result.begin(), result.end(),
+                             [](const auto& a, const auto& b) { return get_seq(a) == get_seq(b); }),
+                 result.end());
+
+    return result;
+}
+
+size_t ParquetOrderBookRepository::replay_events(
+    const std::vector<MarketAsset>& assets, uint64_t sequence_number,
+    const EventVisitor& visit) const {
+    const std::unordered_set<MarketAsset> wanted(assets.begin(), assets.end());
+    std::vector<std::string> tokens;
+    for (const auto& asset : wanted) tokens.push_back(asset.token_id());
+    const std::unordered_set<std::string> token_set(tokens.begin(), tokens.end());
+
+    std::vector<OrderBookEventVariant> buffered;
+    auto merge_buffer = [&](const std::vector<OrderBookEventVariant>& buffer) {
+        for (const auto& event : buffer) {
+            if (get_seq(event) > sequence_number && wanted.count(get_asset(event))) {
+                buffered.push_back(event);
+            }
+        }
+    };
+
+    // In the same order as get_events_since, one shard at a time
+    std::map<std::string, std::string> prefixes;  // token prefix -> one of its tokens
+    for (const auto& token : tokens) prefixes.emplace(token_prefix(token), token);
+    for (const auto& [prefix, token] : prefixes) {
+        auto& shard = shard_for(prefix);
+        std::lock_guard lock(shard.mutex);
+        for (const auto& [key, partition] : shard.partitions) {
+            if (key.prefix == prefix) merge_buffer(partition.events);
+        }
+    }
+
+    std::vector<std::shared_ptr<const FlushJob>> pending;
+    {
+        std::lock_guard lock(flush_mutex_);
+        pending = pending_flushes_;
+    }
+    std::unordered_set<std::string> pending_paths;
+    for (const auto& job : pending) {
+        pending_paths.insert(job->path);
+        merge_buffer(job->events);
+    }
+
+    std::vector<ManifestEntry> files;
+    for (const auto& [prefix, token] : prefixes) {
+        for (const auto& event_type : kEventTypes) {
+            for (auto& entry : manifest_for(events_dir(event_type, token))) {
+                if (entry.seq_end <= sequence_number) continue;
+                if (pending_paths.count(entry.path)) continue;
+                if (!entry.token_ids.empty() &&
+                    std::none_of(entry.token_ids.begin(), entry.token_ids.end(),
+                                 [&](const auto& id) { return token_set.count(id) > 0; })) {
+                    continue;
+                }
+                files.push_back(std::move(entry));
+            }
+        }
+    }
+    std::stable_sort(buffered.begin(), buffered.end(),
+                     [](const auto& a, const auto& b) { return get_seq(a) < get_seq(b); });
+
+    // Min-heap of (next sequence number, source). A file not yet opened is
+    // keyed by its first sequence number; the buffered events are the last
+    // source.
+    using Head = std::pair<uint64_t, size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<>> heap;
+    std::vector<std::unique_ptr<EventFileCursor>> cursors(files.size());
+    for (size_t i = 0; i < files.size(); ++i) heap.emplace(files[i].seq_start, i);
+    const size_t buffered_source = files.size();
+    size_t buffered_pos = 0;
+    if (!buffered.empty()) heap.emplace(get_seq(buffered.front()), buffered_source);
+
+    size_t visited = 0;
+    uint64_t last = sequence_number;  // also drops repeats from overlapping files
+    while (!heap.empty()) {
+        auto [seq, source] = heap.top();
+        heap.pop();
+
+        OrderBookEventVariant* event = nullptr;
+        if (source == buffered_source) {
+            event = &buffered[buffered_pos];
+        } else if (!cursors[source]) {
+            cursors[source] = std::make_unique<EventFileCursor>(
+                open_reader(files[source].path), event_type_of(files[source].path),
+                wanted, tokens, sequence_number);
+            if (auto* first = cursors[source]->current()) {
+                heap.emplace(get_seq(*first), source);
+            } else {
+                cursors[source].reset();
+            }
+            continue;
+        } else {
+            event = cursors[source]->current();
+        }
+
+        if (seq > last) {
+            last = seq;
+            ++visited;
+            if (!visit(std::move(*event))) break;
+        }
+
+        if (source == buffered_source) {
+            if (++buffered_pos < buffered.size()) heap.emplace(get_seq(buffered[buffered_pos]), source);
+        } else {
+            cursors[source]->advance();
+            if (auto* next = cursors[source]->current()) {
+                heap.emplace(get_seq(*next), source);
+            } else {
+                cursors[source].reset();  // done; never popped again
+            }
+        }
+    }
+    return visited;
+}
+
+uint64_t ParquetOrderBookRepository::max_sequence_number() const {
+    uint64_t max_sequence = 0;
+    auto add = [&](const std::vector<OrderBookEventVariant>& events) {
+        for (const auto& event : events) max_sequence = std::max(max_sequence, get_seq(event));
+    };
+    // In the order events move: buffered, being written, in a manifest
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        for (const auto& [key, partition] : shard.partitions) add(partition.events);
+    }
+    {
+        std::lock_guard lock(flush_mutex_);
+        for (const auto& job : pending_flushes_) add(job->events);
+    }
+    for (const auto& dir : manifest_dirs()) {
+        for (const auto& entry : manifest_for(dir)) {
+            max_sequence = std::max(max_sequence, entry.seq_end);
+        }
+    }
+    return max_sequence;
+}
+
+std::unique_ptr<::parquet::arrow::FileReader> ParquetOrderBookRepository::open_reader(
+    const std::string& path) const {
+    auto infile = fs_->OpenInputFile(path);
+    if (!infile.ok()) return nullptr;
+
+    // Pre-buffering fetches every column chunk a ReadRowGroups call needs
+    // up front, merging nearby ranges into single requests
+    ::parquet::ArrowReaderProperties arrow_properties;
+    arrow_properties.set_pre_buffer(settings_.pre_buffer_reads);
+    if (settings_.pre_buffer_reads) {
+        arrow_properties.set_cache_options(arrow::io::CacheOptions::LazyDefaults());
+    }
+
+    ::parquet::arrow::FileReaderBuilder builder;
+    std::unique_ptr<::parquet::arrow::FileReader> reader;
+    try {
+        if (!builder.Open(std::move(infile).ValueOrDie(), ::parquet::ReaderProperties(pool_)).ok()) {
+            return nullptr;
+        }
+        if (!builder.memory_pool(pool_)->properties(arrow_properties)->Build(&reader).ok()) {
+            return nullptr;
+        }
+    } catch (const ::parquet::ParquetException&) {
+        return nullptr;
+    }
+    return reader;
+}
+
+std::vector<OrderBookEventVariant> ParquetOrderBookRepository::read_events_from_file(
+    const std::string& path, const MarketAsset& asset, uint64_t min_sequence) const {
+
+    std::vector<OrderBookEventVariant> result;
+
+    // Open the file and prune row groups on footer statistics before
+    // decoding anything
+    auto reader = open_reader(path);
+    if (!reader) return result;  // Listed in the manifest but gone
+
+    auto row_groups = matching_row_groups(*reader, asset.token_id(), min_sequence);
+    if (row_groups.empty()) return result;
+
+    std::shared_ptr<arrow::Table> table;
+    auto read_status = reader->ReadRowGroups(row_groups, &table);
+    if (!read_status.ok()) return result;
+
+    return decode_events(*table, event_type_of(path), AssetFilter{&asset, nullptr}, min_sequence);
+}
+
+std::optional<std::vector<OrderBookEventVariant>> ParquetOrderBookRepository::read_event_file(
+    const std::string& path) const {
+    auto reader = open_reader(path);
+    if (!reader) return std::nullopt;
+
+    std::shared_ptr<arrow::Table> table;
+    if (!reader->ReadTable(&table).ok()) return std::nullopt;
+    return decode_events(*table, event_type_of(path), AssetFilter{}, 0);
+}
+
+// --- Event file manifest ---
+
+std::string ParquetOrderBookRepository::manifest_path(const std::string& dir) {
+    return "manifests/" + dir + ".parquet";
+}
+
+std::vector<ParquetOrderBookRepository::ManifestEntry> ParquetOrderBookRepository::manifest_for(
+    const std::string& dir) const {
+    std::lock_guard lock(manifest_mutex_);
+    return load_manifest_locked(dir);
+}
+
+std::vector<ParquetOrderBookRepository::ManifestEntry>&
+ParquetOrderBookRepository::load_manifest_locked(const std::string& dir) const {
+    auto it = manifests_.find(dir);
+    if (it != manifests_.end()) return it->second;
+
+    auto entries = read_manifest(dir);
+    if (!entries) {
+        // No (readable) manifest: list once, then persist what we found so
+        // the next start does not have to
+        entries = list_event_files(dir);
+        if (!entries->empty() && access_ == Access::read_write) {
+            // Only saves the next start a listing, so a failure is not fatal
+            auto status = write_manifest(dir, *entries);
+            if (!status.ok()) {
+                std::cerr << "[parquet] Failed to write " << manifest_path(dir) << ": "
+                          << status.ToString() << std::endl;
+            }
+        }
+    }
+    return manifests_.emplace(dir, std::move(*entries)).first->second;
+}
+
+ParquetOrderBookRepository::ManifestEntry ParquetOrderBookRepository::manifest_entry_for(
+    const FlushJob& job) {
+    ManifestEntry entry{job.path, {}, UINT64_MAX, 0, INT64_MAX, INT64_MIN};
+    for (const auto& event : job.events) {
+        const auto& token_id = get_asset(event).token_id();
+        if (std::find(entry.token_ids.begin(), entry.token_ids.end(), token_id) ==
+            entry.token_ids.end()) {
+            entry.token_ids.push_back(token_id);
+        }
+        entry.seq_start = std::min(entry.seq_start, get_seq(event));
+        entry.seq_end = std::max(entry.seq_end, get_seq(event));
+        entry.ts_start_ms = std::min(entry.ts_start_ms, get_timestamp_ms(event));
+        entry.ts_end_ms = std::max(entry.ts_end_ms, get_timestamp_ms(event));
+    }
+    return entry;
+}
+
+void ParquetOrderBookRepository::record_in_manifest(const FlushJob& job) {
+    auto entry = manifest_entry_for(job);
+
+    std::lock_guard lock(manifest_mutex_);
+    auto& entries = load_manifest_locked(job.dir);
+    // A fallback listing may already have picked the new file up
+    auto existing = std::find_if(entries.begin(), entries.end(),
+                                 [&](const ManifestEntry& e) { return e.path == entry.path; });
+    if (existing != entries.end()) {
+        *existing = std::move(entry);
+    } else {
+        entries.push_back(std::move(entry));
+    }
+    // The file stays listed in memory, since it is complete and reads can
+    // use it, but the flush fails: the manifest on disk does not list it,
+    // so the log must keep its events for the next start to write again
+    auto status = write_manifest(job.dir, entries);
+    if (!status.ok()) {
+        throw std::runtime_error("Failed to write " + manifest_path(job.dir) + ": " + status.ToString());
+    }
+}
+
+std::vector<ParquetOrderBookRepository::ManifestEntry> ParquetOrderBookRepository::list_event_files(
+    const std::string& dir) const {
+    std::vector<ManifestEntry> entries;
+
+    arrow::fs::FileSelector selector;
+    selector.base_dir = dir;
+    selector.allow_not_found = true;
+    selector.recursive = true;
+    auto listing_result = fs_->GetFileInfo(selector);
+    if (!listing_result.ok()) return entries;
+
+    for (const auto& file_info : listing_result.ValueOrDie()) {
+        if (file_info.type() != arrow::fs::FileType::File) continue;
+        if (!ends_with(file_info.path(), ".parquet")) continue;
+
+        // Format: {event_type}_{HH}_{seq_start}_{seq_end}. The token set and
+        // time range are unknown without opening the file, so they are left
+        // open and never prune.
+        ManifestEntry entry{file_info.path(), {}, 0, UINT64_MAX, INT64_MIN, INT64_MAX};
+        std::string filename = stem(file_info.path());
+        auto last_underscore = filename.rfind('_');
+        if (last_underscore != std::string::npos && last_underscore > 0) {
+            auto second_last = filename.rfind('_', last_underscore - 1);
+            if (second_last != std::string::npos) {
+                try {
+                    entry.seq_start = std::stoull(filename.substr(second_last + 1));
+                    entry.seq_end = std::stoull(filename.substr(last_underscore + 1));
+                } catch (...) {}
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+std::optional<std::vector<ParquetOrderBookRepository::ManifestEntry>>
+ParquetOrderBookRepository::read_manifest(const std::string& dir) const {
+    // Missing, or truncated or corrupt: rebuilt from a listing
+    auto reader = open_reader(manifest_path(dir));
+    if (!reader) return std::nullopt;
+
+    std::shared_ptr<arrow::Table> table;
+    if (!reader->ReadTable(&table).ok()) return std::nullopt;
+    auto combined = table->CombineChunks();
+    if (!combined.ok()) return std::nullopt;
+    table = std::move(combined).ValueOrDie();
+
+    std::vector<ManifestEntry> entries;
+    if (table->num_rows() == 0) return entries;
+
+    auto path_col = std::static_pointer_cast<arrow::StringArray>(table->column(0)->chunk(0));
+    auto tokens_list = std::static_pointer_cast<arrow::ListArray>(table->column(1)->chunk(0));
+    auto tokens_values = std::static_pointer_cast<arrow::StringArray>(tokens_list->values());
+    auto seq_start_col = std::static_pointer_cast<arrow::UInt64Array>(table->column(2)->chunk(0));
+    auto seq_end_col = std::static_pointer_cast<arrow::UInt64Array>(table->column(3)->chunk(0));
+    auto ts_start_col = std::static_pointer_cast<arrow::Int64Array>(table->column(4)->chunk(0));
+    auto ts_end_col = std::static_pointer_cast<arrow::Int64Array>(table->column(5)->chunk(0));
+
+    entries.reserve(table->num_rows());
+    for (int64_t i = 0; i < table->num_rows(); ++i) {
+        ManifestEntry entry{path_col->GetString(i), {},
+                            seq_start_col->Value(i), seq_end_col->Value(i),
+                            ts_start_col->Value(i), ts_end_col->Value(i)};
+        for (int32_t j = tokens_list->value_offset(i); j < tokens_list->value_offset(i + 1); ++j) {
+            entry.token_ids.push_back(tokens_values->GetString(j));
+        }
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+arrow::Status ParquetOrderBookRepository::write_manifest(const std::string& dir,
+                                                         const std::vector<ManifestEntry>& entries) const {
+    auto schema = ParquetSchemas::event_manifest_schema();
+
+    arrow::StringBuilder path_b;
+    auto token_inner = std::make_shared<arrow::StringBuilder>();
+    arrow::ListBuilder tokens_b(arrow::default_memory_pool(), token_inner);
+    arrow::UInt64Builder seq_start_b, seq_end_b;
+    arrow::Int64Builder ts_start_b, ts_end_b;
+
+    for (const auto& entry : entries) {
+        (void)path_b.Append(entry.path);
+        (void)tokens_b.Append();
+        for (const auto& token_id : entry.token_ids) {
+            (void)token_inner->Append(token_id);
+        }
+        (void)seq_start_b.Append(entry.seq_start);
+        (void)seq_end_b.Append(entry.seq_end);
+        (void)ts_start_b.Append(entry.ts_start_ms);
+        (void)ts_end_b.Append(entry.ts_end_ms);
+    }
+
+    std::shared_ptr<arrow::Array> arr_path, arr_tokens, arr_seq_start, arr_seq_end;
+    std::shared_ptr<arrow::Array> arr_ts_start, arr_ts_end;
+    ARROW_RETURN_NOT_OK(path_b.Finish(&arr_path));
+    ARROW_RETURN_NOT_OK(tokens_b.Finish(&arr_tokens));
+    ARROW_RETURN_NOT_OK(seq_start_b.Finish(&arr_seq_start));
+    ARROW_RETURN_NOT_OK(seq_end_b.Finish(&arr_seq_end));
+    ARROW_RETURN_NOT_OK(ts_start_b.Finish(&arr_ts_start));
+    ARROW_RETURN_NOT_OK(ts_end_b.Finish(&arr_ts_end));
+
+    auto table = arrow::Table::Make(schema,
+        {arr_path, arr_tokens, arr_seq_start, arr_seq_end, arr_ts_start, arr_ts_end});
+
+    // Written under a temporary name a listing ignores and moved into place
+    // once complete, so readers and the next start see the old or the new
+    // manifest, never a partial one
+    auto path = manifest_path(dir);
+    auto tmp = path + ".tmp";
+    (void)fs_->CreateDir(parent_path(path), /*recursive=*/true);
+    auto status = [&] {
+        auto outfile_result = fs_->OpenOutputStream(tmp);
+        if (!outfile_result.ok()) return outfile_result.status();
+        auto outfile = std::move(outfile_result).ValueOrDie();
+        auto write_status = ::parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), outfile,
+                                                         std::max<int64_t>(table->num_rows(), 1));
+        auto close_status = outfile->Close();
+        if (!write_status.ok()) return write_status;
+        if (!close_status.ok()) return close_status;
+        return fs_->Move(tmp, path);
+    }();
+    if (!status.ok()) (void)fs_->DeleteFile(tmp);
+    return status;
+}
+
+// --- Compaction ---
+
+CompactionStats ParquetOrderBookRepository::compact(std::chrono::system_clock::time_point now) {
+    require_writable("compact");
+    std::lock_guard lock(compaction_mutex_);
+    CompactionStats stats;
+
+    // Out of every manifest since the last pass, so no read still needs them
+    for (const auto& path : retired_files_) {
+        if (fs_->DeleteFile(path).ok()) ++stats.files_deleted;
+    }
+    retired_files_.clear();
+
+    // Only hours that have ended; flushes into the current one keep coming
+    auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count();
+    auto current_hour_ms = now_ms / kMillisPerHour * kMillisPerHour;
+
+    for (const auto& dir : manifest_dirs()) {
+        // Files named {type}_{HH}_{seq_start}_{seq_end} under {dir}/{date}/
+        std::map<std::string, std::vector<ManifestEntry>> hours;
+        for (auto& entry : manifest_for(dir)) {
+            auto name = stem(entry.path);
+            auto seq_end = name.rfind('_');
+            auto seq_start = seq_end == std::string::npos || seq_end == 0
+                ? std::string::npos : name.rfind('_', seq_end - 1);
+            if (seq_start == std::string::npos) continue;
+            hours[parent_path(entry.path) + "/" + name.substr(0, seq_start)].push_back(std::move(entry));
+        }
+
+        for (auto& [hour, entries] : hours) {
+            if (entries.size() < 2) continue;
+            // From the path: an entry rebuilt by listing has no time range
+            auto start = hour_start_ms(hour);
+            if (!start || *start + kMillisPerHour > current_hour_ms) continue;
+
+            std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+                return a.seq_start < b.seq_start;
+            });
+            compact_hour(dir, hour, entries, stats);
+        }
+    }
+    return stats;
+}
+
+void ParquetOrderBookRepository::compact_hour(const std::string& dir, const std::string& hour,
+                                              const std::vector<ManifestEntry>& entries,
+                                              CompactionStats& stats) {
+    // Merge consecutive files until an output would exceed
+    // kCompactedFileEvents, so memory stays bounded on busy hours
+    std::vector<const ManifestEntry*> inputs;
+    std::vector<OrderBookEventVariant> events;
+
+    auto emit = [&] {
+        if (inputs.size() >= 2) merge_event_files(dir, hour, inputs, events, stats);
+        inputs.clear();
+        events.clear();
+    };
+
+    for (const auto& entry : entries) {
+        auto file_events = read_event_file(entry.path);
+        if (!file_events) {
+            // Unreadable: leave it alone rather than drop its events
+            std::cerr << "[parquet] Compaction skipped unreadable " << entry.path << std::endl;
+            emit();
+            continue;
+        }
+        if (!inputs.empty() && events.size() + file_events->size() > kCompactedFileEvents) emit();
+        inputs.push_back(&entry);
+        events.insert(events.end(), std::make_move_iterator(file_events->begin()),
+                      std::make_move_iterator(file_events->end()));
+    }
+    emit();
+}
+
+void ParquetOrderBookRepository::merge_event_files(const std::string& dir, const std::string& hour,
+                                                   const std::vector<const ManifestEntry*>& inputs,
+                                                   std::vector<OrderBookEventVariant>& events,
+                                                   CompactionStats& stats) {
+    std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b) {
+        return get_seq(a) < get_seq(b);
+    });
+    // A replayed write-ahead log or a rebuilt manifest can list an event twice
+    events.erase(std::unique(events.begin(), events.end(),
+                             [](const auto& a, const auto& b) {
+                                 return get_seq(a) == get_seq(b) && get_asset(a) == get_asset(b);
+                             }),
+                 events.end());
+    if (events.empty()) return;
+
+    // Written under a temporary name a listing ignores, and moved into
+    // place only once complete, so a failed merge neither replaces an input
+    // of the same name nor is swapped into the manifest
+    std::string path = hour + "_" + std::to_string(get_seq(events.front())) + "_" +
+                       std::to_string(get_seq(events.back())) + ".parquet";
+    FlushJob job{event_type_of(dir), dir, path + ".tmp", std::move(events), 0};
+    try {
+        write_event_file(job);
+        if (!open_reader(job.path)) throw std::runtime_error("unreadable after writing");
+        auto moved = fs_->Move(job.path, path);
+        if (!moved.ok()) throw std::runtime_error(moved.ToString());
+    } catch (const std::exception& e) {
+        std::cerr << "[parquet] Compaction of " << hour << " failed: " << e.what() << std::endl;
+        (void)fs_->DeleteFile(job.path);
+        return;
+    }
+    job.path = std::move(path);
+
+    // Swap in one manifest write: readers see the inputs or the merged file
+    std::unordered_set<std::string> replaced;
+    for (const auto* input : inputs) replaced.insert(input->path);
+    replaced.erase(job.path);  // rewritten in place, not retired
+    {
+        std::lock_guard lock(manifest_mutex_);
+        auto& live = load_manifest_locked(dir);
+        auto before = live;
+        live.erase(std::remove_if(live.begin(), live.end(),
+                                  [&](const ManifestEntry& e) {
+                                      return replaced.count(e.path) || e.path == job.path;
+                                  }),
+                   live.end());
+        live.push_back(manifest_entry_for(job));
+        auto status = write_manifest(dir, live);
+        if (!status.ok()) {
+            // The manifest on disk still lists the inputs, so they must
+            // stay; the merged file goes unless it took an input's place
+            std::cerr << "[parquet] Compaction of " << hour << " failed: " << status.ToString() << std::endl;
+            live = std::move(before);
+            bool in_place = std::any_of(inputs.begin(), inputs.end(),
+                                        [&](const ManifestEntry* input) { return input->path == job.path; });
+            if (!in_place) (void)fs_->DeleteFile(job.path);
+            return;
+        }
+    }
+
+    retired_files_.insert(retired_files_.end(), replaced.begin(), replaced.end());
+    ++stats.files_written;
+    stats.files_merged += inputs.size();
+    stats.events_rewritten += job.events.size();
+}
+
+std::vector<std::string> ParquetOrderBookRepository::manifest_dirs() const {
+    // manifests/{dir}.parquet for every event directory that has been written
+    std::set<std::string> dirs;
+    arrow::fs::FileSelector selector;
+    selector.base_dir = "manifests/events";
+    selector.allow_not_found = true;
+    selector.recursive = true;
+    auto listing = fs_->GetFileInfo(selector);
+    if (listing.ok()) {
+        const std::string prefix = "manifests/";
+        for (const auto& info : listing.ValueOrDie()) {
+            if (info.type() != arrow::fs::FileType::File || !ends_with(info.path(), ".parquet")) continue;
+            auto path = info.path();
+            dirs.insert(path.substr(prefix.size(), path.size() - prefix.size() - 8));
+        }
+    }
+    // Directories whose manifest has not been persisted yet (e.g. empty)
+    std::lock_guard lock(manifest_mutex_);
+    for (const auto& [dir, entries] : manifests_) {
+        if (!entries.empty()) dirs.insert(dir);
+    }
+    return {dirs.begin(), dirs.end()};
+}
+
+// --- Snapshot storage ---
+
+void ParquetOrderBookRepository::store_snapshot(const OrderBook& book) {
+    require_writable("store_snapshot");
+    const auto& token_id = book.get_asset().token_id();
+    auto& stripe = stripe_for(token_id);
+    std::unique_lock lock(stripe.mutex);
+
+    // Written under a temporary name and moved into place once complete, so
+    // a failed write leaves the previous base and diff as they were. Failures
+    // are logged, like a checkpoint's, and leave the bases untouched.
+    auto write = [&](const std::string& path, const arrow::Table& table) {
+        std::string parent = parent_path(path);
+        if (!parent.empty()) {
+            (void)fs_->CreateDir(parent, /*recursive=*/true);
+        }
+        std::string tmp = path + ".tmp";
+        auto status = [&] {
+            auto outfile_result = fs_->OpenOutputStream(tmp);
+            if (!outfile_result.ok()) return outfile_result.status();
+            auto outfile = std::move(outfile_result).ValueOrDie();
+            auto write_status = ::parquet::arrow::WriteTable(table, arrow::default_memory_pool(), outfile, 1,
+                                                             book_properties_);
+            auto close_status = outfile->Close();
+            if (!write_status.ok()) return write_status;
+            if (!close_status.ok()) return close_status;
+            return fs_->Move(tmp, path);
+        }();
+        if (!status.ok()) {
+            std::cerr << "[parquet] Failed to write " << path << ": " << status.ToString() << std::endl;
+            (void)fs_->DeleteFile(tmp);
+        }
+        return status.ok();
+    };
+
+    auto base = stripe.bases.find(token_id);
+    if (base != stripe.bases.end() && base->second.diffs < settings_.snapshot_diffs_per_base) {
+        const auto& base_book = base->second.book;
+        LevelChanges changes{base_book.get_last_sequence_number(),
+                             level_changes(base_book.get_bids(), book.get_bids(), std::greater<Price>()),
+                             level_changes(base_book.get_asks(), book.get_asks(), std::less<Price>())};
+        // A diff half the size of the book saves too little to be worth
+        // the extra read; write a new base instead
+        auto levels = book.get_bids().size() + book.get_asks().size();
+        if (2 * (changes.bids.size() + changes.asks.size()) < levels) {
+            if (write(snapshot_diff_path(token_id), *make_snapshot_table({&book}, &changes))) {
+                ++base->second.diffs;
+            }
+            return;
+        }
+    }
+
+    if (!write(snapshot_path(token_id), *make_snapshot_table({&book}))) return;
+    // The diff belongs to the base just replaced; reads also ignore it by
+    // its base sequence number if the delete fails
+    (void)fs_->DeleteFile(snapshot_diff_path(token_id));
+    if (settings_.snapshot_diffs_per_base > 0) {
+        stripe.bases.insert_or_assign(token_id, SnapshotBase{book, 0});
+    }
+}
+
+std::optional<OrderBook> ParquetOrderBookRepository::get_latest_snapshot(
+    const MarketAsset& asset) const {
+    auto book = get_latest_snapshot_by_token(asset.token_id());
+    // Verify this is the right asset
+    if (!book || book->get_asset() != asset) return std::nullopt;
+    return book;
+}
+
+std::optional<OrderBook> ParquetOrderBookRepository::get_latest_snapshot_by_token(
+    const std::string& token_id) const {
+    std::shared_lock lock(stripe_for(token_id).mutex);
+
+    std::string path = snapshot_path(token_id);
+    auto file_info = fs_->GetFileInfo(path);
+    if (!file_info.ok() || file_info->type() == arrow::fs::FileType::NotFound) {
+        // Checkpoint mode writes no per-asset files
+        std::shared_lock checkpoint_lock(checkpoint_mutex_);
+        return find_in_checkpoint(token_id);
+    }
+
+    auto reader = open_reader(path);
+    if (!reader) return std::nullopt;
+
+    std::shared_ptr<arrow::Table> table;
+    auto read_status = reader->ReadTable(&table);
+    if (!read_status.ok() || table->num_rows() == 0) return std::nullopt;
+
+    // snapshot_path keys on a token_id prefix, so check for a collision
+    auto tid = std::static_pointer_cast<arrow::StringArray>(table->column(1)->chunk(0))->GetView(0);
+    if (tid != token_id) return std::nullopt;
+    auto stored = stored_book_at(*table, 0);
+
+    // A diff counts only against the base it was taken from
+    auto diff_reader = open_reader(snapshot_diff_path(token_id));
+    std::shared_ptr<arrow::Table> diff;
+    if (!diff_reader || !diff_reader->ReadTable(&diff).ok() || diff->num_rows() == 0 ||
+        diff->num_columns() != ParquetSchemas::order_book_diff_schema()->num_fields()) {
+        return book_from(stored);
+    }
+    auto diff_tid = std::static_pointer_cast<arrow::StringArray>(diff->column(1)->chunk(0))->GetView(0);
+    auto base_seq = std::static_pointer_cast<arrow::UInt64Array>(diff->column(16)->chunk(0))->Value(0);
+    if (diff_tid != token_id || base_seq != stored.snapshot.sequence_number) {
+        return book_from(stored);
+    }
+
+    auto patched = stored_book_at(*diff, 0);
+    patched.snapshot.bids = apply_level_changes(stored.snapshot.bids, patched.snapshot.bids, std::greater<Price>());
+    patched.snapshot.asks = apply_level_changes(stored.snapshot.asks, patched.snapshot.asks, std::less<Price>());
+    return book_from(patched);
+}
+
+// --- Path helpers ---
+
+std::string ParquetOrderBookRepository::events_dir(
+    const std::string& event_type, const std::string& token_id) const {
+    return "events/" + event_type + "/" + token_prefix(token_id);
+}
+
+// --- Bars ---
+
+void ParquetOrderBookRepository::store_bars(const std::vector<Bar>& bars) {
+    require_writable("store_bars");
+    // One file per interval and UTC hour of bar start
+    std::map<std::pair<int64_t, int64_t>, std::vector<const Bar*>> files;
+    for (const auto& bar : bars) {
+        files[{bar.interval_ms, bar.start_ms / 3'600'000}].push_back(&bar);
+    }
+
+    auto written_at = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (auto& [key, rows] : files) {
+        std::sort(rows.begin(), rows.end(), [](const Bar* a, const Bar* b) {
+            if (a->asset.token_id() != b->asset.token_id()) return a->asset.token_id() < b->asset.token_id();
+            return a->start_ms < b->start_ms;
+        });
+        auto start_ms = rows.front()->start_ms;
+        std::string path = "bars/" + interval_label(key.first) + "/" + date_string(start_ms) + "/bars_" +
+                           hour_string(start_ms) + "_" + std::to_string(written_at) + "_" +
+                           std::to_string(bar_files_.fetch_add(1, std::memory_order_relaxed)) + ".parquet";
+
+        auto table = make_bar_table(rows);
+        (void)fs_->CreateDir(parent_path(path), /*recursive=*/true);
+        auto outfile_result = fs_->OpenOutputStream(path);
+        if (!outfile_result.ok()) {
+            std::cerr << "[parquet] Failed to write " << path << ": "
+                      << outfile_result.status().ToString() << std::endl;
+            continue;
+        }
+        auto outfile = std::move(outfile_result).ValueOrDie();
+        auto write_status = ::parquet::arrow::WriteTable(
+            *table, arrow::default_memory_pool(), outfile, settings_.parquet.row_group_rows, bar_properties_);
+        auto close_status = outfile->Close();
+        if (!write_status.ok() || !close_status.ok()) {
+            std::cerr << "[parquet] Failed to write " << path << ": "
+                      << (write_status.ok() ? close_status : write_status).ToString() << std::endl;
+        }
+    }
+}
+
+std::vector<Bar> ParquetOrderBookRepository::read_bars(int64_t interval_ms, int64_t from_ms,
+                                                       int64_t to_ms) const {
+    std::vector<Bar> bars;
+    arrow::fs::FileSelector selector;
+    selector.base_dir = "bars/" + interval_label(interval_ms);
+    selector.allow_not_found = true;
+    selector.recursive = true;
+    auto listing = fs_->GetFileInfo(selector);
+    if (!listing.ok()) return bars;
+
+    for (const auto& info : *listing) {
+        if (info.type() != arrow::fs::FileType::File || !ends_with(info.path(), ".parquet")) continue;
+        auto reader = open_reader(info.path());
+        if (!reader) continue;
+        std::shared_ptr<arrow::Table> table;
+        if (!reader->ReadTable(&table).ok()) continue;
+        auto combined = table->CombineChunks();
+        if (!combined.ok()) continue;
+        table = std::move(combined).ValueOrDie();
+        if (table->num_rows() == 0) continue;
+
+        auto column = [&](const char* name) { return table->GetColumnByName(name)->chunk(0); };
+        auto cids = std::static_pointer_cast<arrow::StringArray>(column("condition_id"));
+        auto tids = std::static_pointer_cast<arrow::StringArray>(column("token_id"));
+        std::vector<std::shared_ptr<arrow::Array>> values;
+        for (const auto& [name, member] : kBarValueColumns) values.push_back(column(name));
+        std::vector<std::shared_ptr<arrow::UInt32Array>> counts;
+        for (const auto& [name, member] : kBarCountColumns) {
+            counts.push_back(std::static_pointer_cast<arrow::UInt32Array>(column(name)));
+        }
+        auto starts = column("start_ms");
+
+        for (int64_t row = 0; row < table->num_rows(); ++row) {
+            auto start = fixed_value(*starts, row);
+            if (start < from_ms || start >= to_ms) continue;
+            Bar bar{MarketAsset(cids->GetView(row), tids->GetView(row))};
+            for (size_t i = 0; i < values.size(); ++i) bar.*kBarValueColumns[i].second = fixed_value(*values[i], row);
+            for (size_t i = 0; i < counts.size(); ++i) bar.*kBarCountColumns[i].second = counts[i]->Value(row);
+            bars.push_back(std::move(bar));
+        }
+    }
+    std::sort(bars.begin(), bars.end(), [](const Bar& a, const Bar& b) {
+        if (a.asset.token_id() != b.asset.token_id()) return a.asset.token_id() < b.asset.token_id();
+        return a.start_ms < b.start_ms;
+    });
+    return bars;
+}
+
+// --- Checkpoints ---
+
+void ParquetOrderBookRepository::store_checkpoint(const std::vector<OrderBook>& books) {
+    require_writable("store_checkpoint");
+    if (books.empty()) return;
+
+    // Rows sorted by token_id, so each row group covers a narrow token range
+    // and its footer statistics locate a token without reading other rows
+    std::vector<const OrderBook*> rows;
+    rows.reserve(books.size());
+    uint64_t max_sequence = 0;
+    for (const auto& book : books) {
+        rows.push_back(&book);
+        max_sequence = std::max(max_sequence, book.get_last_sequence_number());
+    }
+    std::sort(rows.begin(), rows.end(), [](const OrderBook* a, const OrderBook* b) {
+        return a->get_asset().token_id() < b->get_asset().token_id();
+    });
+
+    std::unique_lock lock(checkpoint_mutex_);
+
+    // Every applied event raises the maximum, so an equal name means
+    // nothing changed since the last checkpoint
+    std::string path = checkpoint_path(max_sequence);
+    auto previous = latest_checkpoint();
+    if (previous == path) return;
+
+    auto table = make_snapshot_table(rows);
+    (void)fs_->CreateDir("checkpoints", /*recursive=*/true);
+    auto outfile_result = fs_->OpenOutputStream(path);
+    if (!outfile_result.ok()) {
+        std::cerr << "[parquet] Failed to write " << path << ": "
+                  << outfile_result.status().ToString() << std::endl;
+        return;
+    }
+    auto outfile = std::move(outfile_result).ValueOrDie();
+    auto write_status = ::parquet::arrow::WriteTable(
+        *table, arrow::default_memory_pool(), outfile, kCheckpointRowGroupSize, book_properties_);
+    auto close_status = outfile->Close();
+    if (!write_status.ok() || !close_status.ok()) {
+        std::cerr << "[parquet] Failed to write " << path << ": "
+                  << (write_status.ok() ? close_status : write_status).ToString() << std::endl;
+        return;
+    }
+
+    // Publish only once the file is complete, then drop the one it replaces
+    auto pointer_result = fs_->OpenOutputStream(kCheckpointPointer);
+    if (!pointer_result.ok()) return;
+    auto pointer = std::move(pointer_result).ValueOrDie();
+    (void)pointer->Write(path.data(), static_cast<int64_t>(path.size()));
+    if (!pointer->Close().ok()) return;
+    if (previous) {
+        (void)fs_->DeleteFile(*previous);
+    }
+}
+
+std::vector<OrderBook> ParquetOrderBookRepository::load_checkpoint() const {
+    std::shared_lock lock(checkpoint_mutex_);
+
+    std::vector<OrderBook> books;
+    auto path = latest_checkpoint();
+    if (!path) return books;
+
+    auto reader = open_reader(*path);
+    if (!reader) return books;
+
+    std::shared_ptr<arrow::Table> table;
+    if (!reader->ReadTable(&table).ok()) return books;
+    auto combined = table->CombineChunks();
+    if (!combined.ok()) return books;
+    table = std::move(combined).ValueOrDie();
+
+    books.reserve(static_cast<size_t>(table->num_rows()));
+    for (int64_t row = 0; row < table->num_rows(); ++row) {
+        books.push_back(book_from_snapshot_row(*table, row));
+    }
+    return books;
+}
+
+std::optional<OrderBook> ParquetOrderBookRepository::find_in_checkpoint(
+    const std::string& token_id) const {
+    auto path = latest_checkpoint();
+    if (!path) return std::nullopt;
+
+    auto reader = open_reader(*path);
+    if (!reader) return std::nullopt;
+
+    // Rows are token-sorted, so at most one row group survives pruning
+    auto row_groups = matching_row_groups(*reader, token_id, 0);
+    if (row_groups.empty()) return std::nullopt;
+
+    std::shared_ptr<arrow::Table> table;
+    if (!reader->ReadRowGroups(row_groups, &table).ok()) return std::nullopt;
+    auto combined = table->CombineChunks();
+    if (!combined.ok()) return std::nullopt;
+    table = std::move(combined).ValueOrDie();
+
+    auto tids = std::static_pointer_cast<arrow::StringArray>(table->column(1)->chunk(0));
+    for (int64_t row = 0; row < tids->length(); ++row) {
+        if (tids->GetView(row) == token_id) {
+            return book_from_snapshot_row(*table, row);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> ParquetOrderBookRepository::latest_checkpoint() const {
+    auto input_result = fs_->OpenInputStream(kCheckpointPointer);
+    if (!input_result.ok()) return std::nullopt;
+    auto input = std::move(input_result).ValueOrDie();
+    auto contents = input->Read(std::numeric_limits<int32_t>::max());
+    if (!contents.ok() || (*contents)->size() == 0) return std::nullopt;
+    return (*contents)->ToString();
+}
+
+std::string ParquetOrderBookRepository::checkpoint_path(uint64_t max_sequence) {
+    // Zero-padded so names sort in checkpoint order
+    std::ostringstream oss;
+    oss << "checkpoints/checkpoint_" << std::setfill('0') << std::setw(20) << max_sequence
+        << ".parquet";
+    return oss.str();
+}
+
+std::string ParquetOrderBookRepository::snapshot_path(const std::string& token_id) const {
+    return "snapshots/" + token_hash(token_id) + ".parquet";
+}
+
+std::string ParquetOrderBookRepository::snapshot_diff_path(const std::string& token_id) const {
+    return "snapshots/" + token_hash(token_id) + ".diff.parquet";
 }
 
 std::string ParquetOrderBookRepository::token_prefix(const std::string& token_id) {
@@ -1,27 +1,114 @@
 #pragma once
 
 #include "config/Settings.hpp"
+#include "domain/value_objects/Bar.hpp"
 #include "repositories/IOrderBookRepository.hpp"
+#include "repositories/wal/WriteAheadLog.hpp"
 
 #include <arrow/filesystem/api.h>
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <variant>
 #include <vector>
 
+namespace arrow {
+class MemoryPool;
+class Table;
+} // namespace arrow
+
+namespace parquet {
+class WriterProperties;
+namespace arrow {
+class FileReader;
+} // namespace arrow
+} // namespace parquet
+
 namespace mde::repositories::pq {
 
+/// Flush metrics. A flush writes one Parquet file per non-empty event buffer.
+struct FlushStats {
+    uint64_t files_written{0};
+    uint64_t failed_writes{0};
+    uint64_t bytes_written{0};        // by successful writes
+    uint64_t backpressure_waits{0};   // appends that blocked on a full flush queue
+    size_t queue_depth{0};            // files queued or being written
+    size_t max_queue_depth{0};
+    std::chrono::microseconds last_latency{0};   // per file write
+    std::chrono::microseconds max_latency{0};
+    std::chrono::microseconds total_latency{0};
+    // Events waiting in partitions, by OrderBookEventVariant index
+    std::array<size_t, std::variant_size_v<mde::domain::OrderBookEventVariant>> buffered_events{};
+};
+
+/// What one compact() pass did
+struct CompactionStats {
+    uint64_t files_written{0};      // merged files
+    uint64_t files_merged{0};       // inputs they replace
+    uint64_t events_rewritten{0};
+    uint64_t files_deleted{0};      // inputs retired by the previous pass
+};
+
+/// What a repository may change in its store
+enum class Access { read_write, read_only };
+
+/// Buffers events per (event type, token prefix, UTC hour) partition and
+/// writes each partition as its own Parquet file under
+/// events/{type}/{token prefix}/{date}/, so files are per market and per
+/// hour and readers only list the directory of the asset they want. Each
+/// partition flushes when it reaches write_buffer_size events or
+/// buffer_age_seconds of age.
+///
+/// With settings.flush_threads == 0 a full buffer is written synchronously
+/// inside append_event. Otherwise full buffers are swapped out and written by
+/// flush_threads background writers (in parallel, which matters for S3);
+/// appends only block once max_pending_flushes files are queued. Events in
+/// queued files stay visible to get_events_since until they are on disk.
+///
+/// Partitions are spread over kPartitionShards shards by token prefix, each
+/// with its own lock, so appends to different markets do not wait on each
+/// other and a read locks only the shard of the asset it wants, for as long
+/// as it takes to copy the buffered events. Files are written and read with
+/// no shard lock held. Snapshot files are locked per token stripe, apart
+/// from the event buffers and from checkpoints.
+///
+/// With settings.wal_directory set, every event is first appended to a local
+/// WriteAheadLog, so buffered events survive a crash and the buffers can be
+/// sized for large files rather than for what a crash may lose. Parquet files
+/// are then compactions of the log: a segment is deleted once every event in
+/// it is in a written file. On construction the segments left by the last run
+/// are replayed (skipping events a manifest already lists) and compacted.
 class ParquetOrderBookRepository : public mde::repositories::IOrderBookRepository {
 public:
+    /// Throws std::invalid_argument if settings.parquet names an unknown
+    /// codec or numeric encoding, or settings.memory_pool an unavailable pool.
+    /// With Access::read_only the store is never written: a manifest rebuilt
+    /// by listing stays in memory, settings.wal_directory and flush_threads
+    /// are ignored, and the append, store and compact calls throw
+    /// std::logic_error.
     ParquetOrderBookRepository(std::shared_ptr<arrow::fs::FileSystem> fs,
-                               const mde::config::StorageSettings& settings);
+                               const mde::config::StorageSettings& settings,
+                               Access access = Access::read_write);
 
     /// Create a local filesystem rooted at root_dir (creates dir if needed).
-    static std::shared_ptr<arrow::fs::FileSystem> make_local_fs(const std::string& root_dir);
+    /// With use_mmap, files are opened as memory maps.
+    static std::shared_ptr<arrow::fs::FileSystem> make_local_fs(const std::string& root_dir,
+                                                                bool use_mmap = false);
 
-    /// Create an S3-compatible filesystem (AWS S3, R2, B2, Wasabi, MinIO).
+    /// Create an S3-compatible filesystem (AWS S3, R2, B2, Wasabi, MinIO),
+    /// behind a CachingFileSystem if settings.s3_cache_directory is set.
     /// Requires arrow::fs::EnsureS3Initialized() before use.
     static std::shared_ptr<arrow::fs::FileSystem> make_s3_fs(
         const mde::config::StorageSettings& settings);
@@ -29,54 +116,269 @@ public:
 
     // IOrderBookRepository
     void append_event(const mde::domain::OrderBookEventVariant& event) override;
+    void append_event(mde::domain::OrderBookEventVariant&& event) override;
+    void append_events(std::span<mde::domain::OrderBookEventVariant> events) override;
     std::vector<mde::domain::OrderBookEventVariant> get_events_since(
         const mde::domain::MarketAsset& asset, uint64_t sequence_number) const override;
+    // A k-way merge over every candidate file of the four event types and
+    // the unflushed events. Files are opened only once the merge reaches
+    // their first sequence number and read a row group at a time, so memory
+    // stays at about one decoded row group per file overlapping the current
+    // position.
+    size_t replay_events(const std::vector<mde::domain::MarketAsset>& assets,
+                         uint64_t sequence_number, const EventVisitor& visit) const override;
+    // The newest seq_end in any manifest, or of an event not yet written.
+    // Reads every manifest, so meant for startup.
+    uint64_t max_sequence_number() const override;
+    /// snapshots/{token}.parquet holds a full base snapshot; the next
+    /// settings.snapshot_diffs_per_base calls write only the levels that
+    /// differ from it to snapshots/{token}.diff.parquet (replacing the last
+    /// diff), unless they are half the book or more. Reads apply the diff to
+    /// its base, so a load is at most two small files. A failed write is
+    /// logged, not thrown, and leaves the previous files in place.
     void store_snapshot(const mde::domain::OrderBook& book) override;
     std::optional<mde::domain::OrderBook> get_latest_snapshot(
         const mde::domain::MarketAsset& asset) const override;
+    std::optional<mde::domain::OrderBook> get_latest_snapshot_by_token(
+        const std::string& token_id) const override;
+
+    /// All books in one file, checkpoints/checkpoint_{max seq}.parquet: one
+    /// order_book_snapshot_schema row per book, sorted by token_id, so the
+    /// row-group token statistics index assets to rows. checkpoints/LATEST
+    /// names the current file and is rewritten only after the file is
+    /// complete; the previous checkpoint is then deleted.
+    void store_checkpoint(const std::vector<mde::domain::OrderBook>& books) override;
+    std::vector<mde::domain::OrderBook> load_checkpoint() const override;
+
+    /// Time bars as their own dataset, bars/{interval}/{date}/, one file per
+    /// interval and UTC hour of bar start in each call, rows sorted by
+    /// token_id and start. The interval directory is named like the setting
+    /// ("500ms", "1s", "5m", "1h"). Failures are logged, not thrown.
+    void store_bars(const std::vector<mde::domain::Bar>& bars);
+    /// Bars of one interval starting in [from_ms, to_ms), sorted by token_id
+    /// and start
+    std::vector<mde::domain::Bar> read_bars(int64_t interval_ms, int64_t from_ms, int64_t to_ms) const;
+
+    /// Write out buffered events and block until every pending file is
+    /// written; also syncs the write-ahead log.
+    void sync();
+
+    /// Merge the event files of every UTC hour that ended before `now` (per
+    /// event type and token prefix directory) into files sorted by sequence
+    /// number, of up to 256Ki events each. A merge rewrites the directory's
+    /// manifest once, so readers see either the inputs or the merged file;
+    /// the inputs are deleted by the next pass, so a read that picked them
+    /// up before the swap can still open them. Runs alongside appends and
+    /// reads; one pass at a time.
+    CompactionStats compact(std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+    FlushStats flush_stats() const;
 
 private:
-    void maybe_flush();
-    void flush();
-    void flush_buffer(const std::string& event_type,
-                      const std::vector<mde::domain::OrderBookEventVariant>& events);
+    struct PartitionKey {
+        size_t event_type;      // OrderBookEventVariant index
+        std::string prefix;     // token_prefix(token_id)
+        int64_t hour;           // timestamp_ms / 3'600'000
+        bool operator==(const PartitionKey&) const = default;
+    };
+    struct PartitionKeyHash {
+        size_t operator()(const PartitionKey& key) const noexcept;
+    };
+    struct Partition {
+        std::vector<mde::domain::OrderBookEventVariant> events;
+        std::chrono::steady_clock::time_point opened;
+        uint64_t wal_segment{0};    // holding the first event
+    };
+
+    static constexpr size_t kPartitionShards = 16;
+    struct PartitionShard {
+        std::mutex mutex;
+        std::unordered_map<PartitionKey, Partition, PartitionKeyHash> partitions;
+    };
+
+    static constexpr size_t kSnapshotStripes = 16;
+    // The base each book's snapshot diffs are taken against, with the diffs
+    // written since
+    struct SnapshotBase {
+        mde::domain::OrderBook book;
+        int diffs{0};
+    };
+    struct SnapshotStripe {
+        std::shared_mutex mutex;
+        // Empty when snapshot_diffs_per_base is 0
+        std::unordered_map<std::string, SnapshotBase> bases;
+    };
+
+    struct FlushJob {
+        std::string event_type;
+        std::string dir;    // events/{type}/{token prefix}
+        std::string path;
+        std::vector<mde::domain::OrderBookEventVariant> events;
+        uint64_t wal_segment{0};
+    };
+
+    // One event file as recorded in its directory's manifest
+    struct ManifestEntry {
+        std::string path;
+        std::vector<std::string> token_ids;  // empty: unknown (found by listing)
+        uint64_t seq_start;
+        uint64_t seq_end;
+        int64_t ts_start_ms;
+        int64_t ts_end_ms;
+    };
+
+    bool async_flush() const noexcept { return !flush_workers_.empty(); }
+    // Throws std::logic_error naming `operation` when read-only
+    void require_writable(const char* operation) const;
+
+    PartitionShard& shard_for(const std::string& prefix) const;
+    SnapshotStripe& stripe_for(const std::string& token_id) const;
+
+    // Buffers the event in its partition, first appending it to the log
+    // unless it came from there (wal_segment); adds the partition to `due`
+    // once it is full
+    void buffer_event(mde::domain::OrderBookEventVariant&& event, std::optional<uint64_t> wal_segment,
+                      std::vector<PartitionKey>& due);
+    // Adds partitions older than buffer_age_seconds to `due`; sweeps at most
+    // once a second so appends stay O(1) with many partitions
+    void add_aged_partitions(std::vector<PartitionKey>& due);
+    void replay_wal();
+    void release_wal();
+    bool in_manifest(const mde::domain::OrderBookEventVariant& event,
+                     std::unordered_map<std::string, std::vector<ManifestEntry>>& manifests) const;
+
+    void flush();  // every partition
+    void flush(const std::vector<PartitionKey>& keys);
+    FlushJob make_flush_job(const PartitionKey& key, Partition& partition) const;
+    // Both return the file's size in bytes
+    int64_t write_flush_job(const FlushJob& job);
+    int64_t write_event_file(const FlushJob& job);
+    void record_flush(std::chrono::microseconds latency, bool ok, int64_t bytes);
+    void run_flush_worker();
+    void stop_flush_workers();  // drains the queue, then joins
 
     // File path helpers
     std::string events_dir(const std::string& event_type,
                            const std::string& token_id) const;
     std::string snapshot_path(const std::string& token_id) const;
+    std::string snapshot_diff_path(const std::string& token_id) const;
+    static std::string checkpoint_path(uint64_t max_sequence);
     static std::string token_prefix(const std::string& token_id);
     static std::string token_hash(const std::string& token_id);
     static std::string date_string(int64_t timestamp_ms);
     static std::string hour_string(int64_t timestamp_ms);
 
-    // Parquet read/write
-    void write_book_snapshots(const std::string& path,
-                              const std::vector<mde::domain::OrderBookEventVariant>& events);
-    void write_book_deltas(const std::string& path,
-                           const std::vector<mde::domain::OrderBookEventVariant>& events);
-    void write_trade_events(const std::string& path,
-                            const std::vector<mde::domain::OrderBookEventVariant>& events);
-    void write_tick_size_changes(const std::string& path,
+    // Parquet read/write. The event writers return the bytes written.
+    int64_t write_event_table(const std::string& path, const arrow::Table& table,
+                              const std::shared_ptr<::parquet::WriterProperties>& properties);
+    int64_t write_book_snapshots(const std::string& path,
                                  const std::vector<mde::domain::OrderBookEventVariant>& events);
+    int64_t write_book_deltas(const std::string& path,
+                              const std::vector<mde::domain::OrderBookEventVariant>& events);
+    int64_t write_nested_book_deltas(const std::string& path,
+                                     const std::vector<mde::domain::OrderBookEventVariant>& events);
+    int64_t write_trade_events(const std::string& path,
+                               const std::vector<mde::domain::OrderBookEventVariant>& events);
+    int64_t write_tick_size_changes(const std::string& path,
+                                    const std::vector<mde::domain::OrderBookEventVariant>& events);
+
+    // Null if the file is missing or not Parquet. Reads through pool_ with
+    // settings_.pre_buffer_reads.
+    std::unique_ptr<::parquet::arrow::FileReader> open_reader(const std::string& path) const;
+
+    // Callers hold checkpoint_mutex_
+    std::optional<std::string> latest_checkpoint() const;
+    std::optional<mde::domain::OrderBook> find_in_checkpoint(const std::string& token_id) const;
 
-    std::vector<mde::domain::OrderBookEventVariant> read_events_from_directory(
-        const std::string& dir, const mde::domain::MarketAsset& asset,
+    std::vector<mde::domain::OrderBookEventVariant> read_events_from_file(
+        const std::string& path, const mde::domain::MarketAsset& asset,
         uint64_t min_sequence) const;
+    // Every event in the file; nullopt if it cannot be read
+    std::optional<std::vector<mde::domain::OrderBookEventVariant>> read_event_file(
+        const std::string& path) const;
+
+    // Compaction; callers hold compaction_mutex_
+    void compact_hour(const std::string& dir, const std::string& hour,
+                      const std::vector<ManifestEntry>& entries, CompactionStats& stats);
+    void merge_event_files(const std::string& dir, const std::string& hour,
+                           const std::vector<const ManifestEntry*>& inputs,
+                           std::vector<mde::domain::OrderBookEventVariant>& events,
+                           CompactionStats& stats);
+    std::vector<std::string> manifest_dirs() const;
+
+    // Event file manifests, one per events/{type}/{token prefix} directory,
+    // stored at manifests/{dir}.parquet. Reads consult the manifest instead
+    // of listing; a directory is listed only when its manifest is missing,
+    // and the result is persisted as the new manifest unless read-only.
+    // record_in_manifest throws if the manifest cannot be written, which
+    // fails the flush and keeps its events in the write-ahead log.
+    static std::string manifest_path(const std::string& dir);
+    std::vector<ManifestEntry> manifest_for(const std::string& dir) const;
+    std::vector<ManifestEntry>& load_manifest_locked(const std::string& dir) const;
+    static ManifestEntry manifest_entry_for(const FlushJob& job);
+    void record_in_manifest(const FlushJob& job);
+    std::vector<ManifestEntry> list_event_files(const std::string& dir) const;
+    std::optional<std::vector<ManifestEntry>> read_manifest(const std::string& dir) const;
+    arrow::Status write_manifest(const std::string& dir, const std::vector<ManifestEntry>& entries) const;
 
     std::shared_ptr<arrow::fs::FileSystem> fs_;
     mde::config::StorageSettings settings_;
-    mutable std::mutex mutex_;
+    Access access_;
+
+    // Built from settings_.parquet, one per file schema
+    std::shared_ptr<::parquet::WriterProperties> snapshot_properties_;
+    std::shared_ptr<::parquet::WriterProperties> delta_properties_;
+    std::shared_ptr<::parquet::WriterProperties> nested_delta_properties_;
+    std::shared_ptr<::parquet::WriterProperties> trade_properties_;
+    std::shared_ptr<::parquet::WriterProperties> tick_size_properties_;
+    std::shared_ptr<::parquet::WriterProperties> book_properties_;  // snapshots/ and checkpoints/
+    std::shared_ptr<::parquet::WriterProperties> bar_properties_;
+    arrow::MemoryPool* pool_;  // settings_.memory_pool, for reads
+
+    // Unflushed events, one buffer per output file. A shard's lock is
+    // ordered before flush_mutex_ and wal_mutex_; no thread holds two.
+    mutable std::array<PartitionShard, kPartitionShards> shards_;
+    std::atomic<std::chrono::steady_clock::time_point> last_age_check_;
+
+    // Null without settings.wal_directory. The log is not thread-safe, so
+    // every call holds wal_mutex_. Segments from wal_retained_ (under
+    // flush_mutex_) on are kept because a file holding their events failed
+    // to write.
+    std::unique_ptr<mde::repositories::wal::WriteAheadLog> wal_;
+    std::mutex wal_mutex_;
+    std::optional<uint64_t> wal_retained_;
+
+    // Guard the snapshots/ files of the tokens hashing to them, and the
+    // bases of their diffs
+    mutable std::array<SnapshotStripe, kSnapshotStripes> snapshot_stripes_;
+    // Guards the checkpoints/ files; ordered after a snapshot stripe
+    mutable std::shared_mutex checkpoint_mutex_;
+
+    // Cached manifests by directory; taken with no other lock held but
+    // compaction_mutex_
+    mutable std::mutex manifest_mutex_;
+    mutable std::unordered_map<std::string, std::vector<ManifestEntry>> manifests_;
+
+    // Serializes compact(); files it replaced, deleted by the next pass
+    std::mutex compaction_mutex_;
+    std::vector<std::string> retired_files_;
 
-    // Buffers per event type
-    std::vector<mde::domain::OrderBookEventVariant> snapshot_buffer_;
-    std::vector<mde::domain::OrderBookEventVariant> delta_buffer_;
-    std::vector<mde::domain::OrderBookEventVariant> trade_buffer_;
-    std::vector<mde::domain::OrderBookEventVariant> tick_size_buffer_;
+    // Numbers bar files, so two written in the same millisecond differ
+    std::atomic<uint64_t> bar_files_{0};
 
-    std::chrono::steady_clock::time_point last_flush_time_;
-    uint64_t min_seq_in_buffer_{0};
-    uint64_t max_seq_in_buffer_{0};
+    // Flushing, under flush_mutex_. pending_flushes_ holds every file taken
+    // out of a partition but not yet on disk (queued or being written, by a
+    // background writer or synchronously by an appending thread);
+    // flush_queue_ only those no writer has picked up. reserved_flushes_
+    // counts queue slots claimed by flushes still taking their partitions.
+    mutable std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+    std::deque<std::shared_ptr<const FlushJob>> flush_queue_;
+    std::vector<std::shared_ptr<const FlushJob>> pending_flushes_;
+    size_t reserved_flushes_{0};
+    std::vector<std::thread> flush_workers_;
+    bool stopping_{false};
+    FlushStats stats_;
 };
 
 } // namespace mde::repositories::pq
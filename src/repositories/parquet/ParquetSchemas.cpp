@@ -1,7 +1,11 @@
 #include "repositories/parquet/ParquetSchemas.hpp"
 
+#include <arrow/util/key_value_metadata.h>
+
 namespace mde::repositories::pq {
 
+const std::string ParquetSchemas::kSchemaVersionKey = "mde.schema_version";
+
 namespace {
 
 arrow::FieldVector base_event_fields() {
@@ -13,6 +17,11 @@ arrow::FieldVector base_event_fields() {
     };
 }
 
+// Prices and sizes are int64 fixed-point micro-units (see FixedPoint.hpp)
+std::shared_ptr<arrow::DataType> fixed_point() {
+    return arrow::int64();
+}
+
 arrow::FieldVector extend(arrow::FieldVector base, arrow::FieldVector extra) {
     base.insert(base.end(), extra.begin(), extra.end());
     return base;
@@ -23,28 +32,40 @@ arrow::FieldVector extend(arrow::FieldVector base, arrow::FieldVector extra) {
 std::shared_ptr<arrow::Schema> ParquetSchemas::book_snapshot_schema() {
     return arrow::schema(extend(base_event_fields(), {
         arrow::field("hash", arrow::utf8()),
-        arrow::field("bid_prices", arrow::list(arrow::float64())),
-        arrow::field("bid_sizes", arrow::list(arrow::float64())),
-        arrow::field("ask_prices", arrow::list(arrow::float64())),
-        arrow::field("ask_sizes", arrow::list(arrow::float64())),
+        arrow::field("bid_prices", arrow::list(fixed_point())),
+        arrow::field("bid_sizes", arrow::list(fixed_point())),
+        arrow::field("ask_prices", arrow::list(fixed_point())),
+        arrow::field("ask_sizes", arrow::list(fixed_point())),
     }));
 }
 
 std::shared_ptr<arrow::Schema> ParquetSchemas::book_delta_schema() {
     return arrow::schema(extend(base_event_fields(), {
         arrow::field("change_asset_ids", arrow::list(arrow::utf8())),
-        arrow::field("change_prices", arrow::list(arrow::float64())),
-        arrow::field("change_new_sizes", arrow::list(arrow::float64())),
+        arrow::field("change_prices", arrow::list(fixed_point())),
+        arrow::field("change_new_sizes", arrow::list(fixed_point())),
         arrow::field("change_sides", arrow::list(arrow::uint8())),
-        arrow::field("change_best_bids", arrow::list(arrow::float64())),
-        arrow::field("change_best_asks", arrow::list(arrow::float64())),
+        arrow::field("change_best_bids", arrow::list(fixed_point())),
+        arrow::field("change_best_asks", arrow::list(fixed_point())),
     }));
 }
 
+std::shared_ptr<arrow::Schema> ParquetSchemas::flat_book_delta_schema() {
+    return arrow::schema(
+        extend(base_event_fields(), {
+            arrow::field("side", arrow::uint8()),
+            arrow::field("price", fixed_point()),
+            arrow::field("new_size", fixed_point()),
+            arrow::field("best_bid", fixed_point()),
+            arrow::field("best_ask", fixed_point()),
+        }),
+        arrow::key_value_metadata({kSchemaVersionKey}, {"2"}));
+}
+
 std::shared_ptr<arrow::Schema> ParquetSchemas::trade_event_schema() {
     return arrow::schema(extend(base_event_fields(), {
-        arrow::field("price", arrow::float64()),
-        arrow::field("size", arrow::float64()),
+        arrow::field("price", fixed_point()),
+        arrow::field("size", fixed_point()),
         arrow::field("side", arrow::uint8()),
         arrow::field("fee_rate_bps", arrow::utf8()),
     }));
@@ -52,8 +73,8 @@ std::shared_ptr<arrow::Schema> ParquetSchemas::trade_event_schema() {
 
 std::shared_ptr<arrow::Schema> ParquetSchemas::tick_size_change_schema() {
     return arrow::schema(extend(base_event_fields(), {
-        arrow::field("old_tick_size", arrow::float64()),
-        arrow::field("new_tick_size", arrow::float64()),
+        arrow::field("old_tick_size", fixed_point()),
+        arrow::field("new_tick_size", fixed_point()),
     }));
 }
 
@@ -63,14 +84,14 @@ std::shared_ptr<arrow::Schema> ParquetSchemas::order_book_snapshot_schema() {
         arrow::field("token_id", arrow::utf8()),
         arrow::field("timestamp_ms", arrow::int64()),
         arrow::field("sequence_number", arrow::uint64()),
-        arrow::field("tick_size", arrow::float64()),
+        arrow::field("tick_size", fixed_point()),
         arrow::field("book_hash", arrow::utf8()),
-        arrow::field("bid_prices", arrow::list(arrow::float64())),
-        arrow::field("bid_sizes", arrow::list(arrow::float64())),
-        arrow::field("ask_prices", arrow::list(arrow::float64())),
-        arrow::field("ask_sizes", arrow::list(arrow::float64())),
-        arrow::field("trade_price", arrow::float64()),
-        arrow::field("trade_size", arrow::float64()),
+        arrow::field("bid_prices", arrow::list(fixed_point())),
+        arrow::field("bid_sizes", arrow::list(fixed_point())),
+        arrow::field("ask_prices", arrow::list(fixed_point())),
+        arrow::field("ask_sizes", arrow::list(fixed_point())),
+        arrow::field("trade_price", fixed_point()),
+        arrow::field("trade_size", fixed_point()),
         arrow::field("trade_side", arrow::uint8()),
         arrow::field("trade_fee_rate_bps", arrow::utf8()),
         arrow::field("trade_timestamp_ms", arrow::int64()),
@@ -78,4 +99,69 @@ std::shared_ptr<arrow::Schema> ParquetSchemas::order_book_snapshot_schema() {
     });
 }
 
+std::shared_ptr<arrow::Schema> ParquetSchemas::order_book_diff_schema() {
+    return arrow::schema(extend(order_book_snapshot_schema()->fields(), {
+        arrow::field("base_sequence_number", arrow::uint64()),
+    }));
+}
+
+std::shared_ptr<arrow::Schema> ParquetSchemas::bar_schema() {
+    return arrow::schema({
+        arrow::field("condition_id", arrow::utf8()),
+        arrow::field("token_id", arrow::utf8()),
+        arrow::field("interval_ms", arrow::int64()),
+        arrow::field("start_ms", arrow::int64()),
+        arrow::field("open", fixed_point()),
+        arrow::field("high", fixed_point()),
+        arrow::field("low", fixed_point()),
+        arrow::field("close", fixed_point()),
+        arrow::field("volume", fixed_point()),
+        arrow::field("buy_volume", fixed_point()),
+        arrow::field("trade_count", arrow::uint32()),
+        arrow::field("mid_open", fixed_point()),
+        arrow::field("mid_high", fixed_point()),
+        arrow::field("mid_low", fixed_point()),
+        arrow::field("mid_close", fixed_point()),
+        arrow::field("spread_close", fixed_point()),
+        arrow::field("spread_max", fixed_point()),
+        arrow::field("quote_updates", arrow::uint32()),
+    });
+}
+
+std::shared_ptr<arrow::Schema> ParquetSchemas::book_levels_schema() {
+    return arrow::schema({
+        arrow::field("token_id", arrow::utf8()),
+        arrow::field("timestamp_ms", arrow::int64()),
+        arrow::field("sequence_number", arrow::uint64()),
+        arrow::field("stale", arrow::boolean()),
+        arrow::field("bid_prices", arrow::list(fixed_point())),
+        arrow::field("bid_sizes", arrow::list(fixed_point())),
+        arrow::field("ask_prices", arrow::list(fixed_point())),
+        arrow::field("ask_sizes", arrow::list(fixed_point())),
+    });
+}
+
+std::shared_ptr<arrow::Schema> ParquetSchemas::event_manifest_schema() {
+    return arrow::schema({
+        arrow::field("path", arrow::utf8()),
+        arrow::field("token_ids", arrow::list(arrow::utf8())),
+        arrow::field("seq_start", arrow::uint64()),
+        arrow::field("seq_end", arrow::uint64()),
+        arrow::field("ts_start_ms", arrow::int64()),
+        arrow::field("ts_end_ms", arrow::int64()),
+    });
+}
+
+int ParquetSchemas::schema_version(const arrow::Schema& schema) {
+    const auto& metadata = schema.metadata();
+    if (!metadata) return 1;
+    auto value = metadata->Get(kSchemaVersionKey);
+    if (!value.ok()) return 1;
+    try {
+        return std::stoi(*value);
+    } catch (...) {
+        return 1;
+    }
+}
+
 } // namespace mde::repositories::pq
@@ -2,18 +2,46 @@
 
 #include <arrow/api.h>
 
+#include <string>
+
 namespace mde::repositories::pq {
 
+// Prices, sizes and tick sizes are stored as int64 fixed-point micro-units
+// (value * 10^6) so they compare exactly and compress well. Files written
+// before this used float64 for the same columns; readers accept both.
 class ParquetSchemas {
 public:
     // Event schemas
     static std::shared_ptr<arrow::Schema> book_snapshot_schema();
+    // Schema version 1: one row per BookDelta, its changes in parallel lists
     static std::shared_ptr<arrow::Schema> book_delta_schema();
+    // Schema version 2: one row per PriceLevelDelta, the delta's own token_id
+    // as the change's asset id. Consecutive rows with the same token_id and
+    // sequence_number are one BookDelta.
+    static std::shared_ptr<arrow::Schema> flat_book_delta_schema();
     static std::shared_ptr<arrow::Schema> trade_event_schema();
     static std::shared_ptr<arrow::Schema> tick_size_change_schema();
 
     // Snapshot file schema (for OrderBook persistence)
     static std::shared_ptr<arrow::Schema> order_book_snapshot_schema();
+    // The same columns plus base_sequence_number: the level lists hold only
+    // the levels that differ from the base snapshot with that sequence
+    // number, a size of 0 removing the level
+    static std::shared_ptr<arrow::Schema> order_book_diff_schema();
+
+    // Time bars (domain::Bar), one row per asset and bar
+    static std::shared_ptr<arrow::Schema> bar_schema();
+
+    // Top levels of live books as exported to Arrow consumers (not stored),
+    // best level first in each list
+    static std::shared_ptr<arrow::Schema> book_levels_schema();
+
+    // Manifest listing the event files of one events/{type}/{token prefix} directory
+    static std::shared_ptr<arrow::Schema> event_manifest_schema();
+
+    // Key-value metadata naming a schema's version; a file without it is version 1
+    static const std::string kSchemaVersionKey;
+    static int schema_version(const arrow::Schema& schema);
 };
 
 } // namespace mde::repositories::pq
@@ -0,0 +1,402 @@
+#include "repositories/wal/WriteAheadLog.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+using namespace mde::domain;
+
+namespace mde::repositories::wal {
+
+namespace {
+
+// Length and CRC precede every payload
+constexpr size_t kFrameBytes = 2 * sizeof(uint32_t);
+
+// Anything larger is a corrupt length, not a record
+constexpr uint32_t kMaxPayloadBytes = 64 * 1024 * 1024;
+
+constexpr std::string_view kSegmentPrefix = "segment_";
+constexpr std::string_view kSegmentSuffix = ".wal";
+
+// CRC-32 (IEEE 802.3, reflected), table-driven
+constexpr std::array<uint32_t, 256> kCrcTable = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}();
+
+uint32_t crc32(std::string_view data) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (unsigned char byte : data) {
+        c = kCrcTable[(c ^ byte) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void put_string(std::string& out, std::string_view str) {
+    put(out, static_cast<uint32_t>(str.size()));
+    out.append(str);
+}
+
+// Bounds-checked cursor over a payload; any overrun clears ok
+struct Reader {
+    std::string_view data;
+    size_t pos{0};
+    bool ok{true};
+
+    template <typename T>
+    T get() {
+        T value{};
+        if (data.size() - pos < sizeof(T)) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    std::string_view get_string() {
+        auto size = get<uint32_t>();
+        if (!ok || data.size() - pos < size) {
+            ok = false;
+            return {};
+        }
+        auto str = data.substr(pos, size);
+        pos += size;
+        return str;
+    }
+
+    Price get_price() { return Price::from_micros(get<int64_t>()); }
+    Quantity get_quantity() { return Quantity::from_units(get<int64_t>()); }
+    Side get_side() { return get<uint8_t>() == 0 ? Side::BUY : Side::SELL; }
+};
+
+void put_levels(std::string& out, const std::vector<PriceLevel>& levels) {
+    for (const auto& level : levels) {
+        put(out, level.price().micros());
+        put(out, level.size().units());
+    }
+}
+
+std::vector<PriceLevel> get_levels(Reader& in, uint32_t count) {
+    std::vector<PriceLevel> levels;
+    levels.reserve(std::min<size_t>(count, in.data.size() / (2 * sizeof(int64_t))));
+    for (uint32_t i = 0; i < count && in.ok; ++i) {
+        auto price = in.get_price();
+        auto size = in.get_quantity();
+        levels.emplace_back(price, size);
+    }
+    return levels;
+}
+
+void put_body(std::string& out, const BookSnapshot& e) {
+    put(out, static_cast<uint32_t>(e.bids.size()));
+    put(out, static_cast<uint32_t>(e.asks.size()));
+    put_levels(out, e.bids);
+    put_levels(out, e.asks);
+    put_string(out, e.hash);
+}
+
+void put_body(std::string& out, const BookDelta& e) {
+    put(out, static_cast<uint32_t>(e.changes.size()));
+    for (const auto& change : e.changes) {
+        put_string(out, change.asset_id.str());
+        put(out, change.price.micros());
+        put(out, change.new_size.units());
+        put(out, static_cast<uint8_t>(change.side));
+        put(out, change.best_bid.micros());
+        put(out, change.best_ask.micros());
+    }
+}
+
+void put_body(std::string& out, const TradeEvent& e) {
+    put(out, e.price.micros());
+    put(out, e.size.units());
+    put(out, static_cast<uint8_t>(e.side));
+    put_string(out, e.fee_rate_bps);
+}
+
+void put_body(std::string& out, const TickSizeChange& e) {
+    put(out, e.old_tick_size.micros());
+    put(out, e.new_tick_size.micros());
+}
+
+std::optional<OrderBookEventVariant> get_event(Reader& in) {
+    auto type = in.get<uint8_t>();
+    auto timestamp = in.get<int64_t>();
+    auto sequence = in.get<uint64_t>();
+    auto condition_id = in.get_string();
+    auto token_id = in.get_string();
+    if (!in.ok) return std::nullopt;
+
+    OrderBookEvent header{MarketAsset(condition_id, token_id), Timestamp(timestamp), sequence};
+    switch (type) {
+    case 0: {
+        auto bid_count = in.get<uint32_t>();
+        auto ask_count = in.get<uint32_t>();
+        if (!in.ok) return std::nullopt;
+        auto bids = get_levels(in, bid_count);
+        auto asks = get_levels(in, ask_count);
+        auto hash = in.get_string();
+        if (!in.ok) return std::nullopt;
+        return BookSnapshot{header, std::move(bids), std::move(asks), std::string(hash)};
+    }
+    case 1: {
+        auto count = in.get<uint32_t>();
+        BookDelta delta{header, {}};
+        for (uint32_t i = 0; i < count && in.ok; ++i) {
+            auto asset_id = in.get_string();
+            auto price = in.get_price();
+            auto size = in.get_quantity();
+            auto side = in.get_side();
+            auto best_bid = in.get_price();
+            auto best_ask = in.get_price();
+            if (!in.ok) break;
+            delta.changes.push_back(
+                PriceLevelDelta{AssetId(asset_id), price, size, side, best_bid, best_ask});
+        }
+        if (!in.ok) return std::nullopt;
+        return delta;
+    }
+    case 2: {
+        auto price = in.get_price();
+        auto size = in.get_quantity();
+        auto side = in.get_side();
+        auto fee = in.get_string();
+        if (!in.ok) return std::nullopt;
+        return TradeEvent{header, price, size, side, std::string(fee)};
+    }
+    case 3: {
+        auto old_tick = in.get_price();
+        auto new_tick = in.get_price();
+        if (!in.ok) return std::nullopt;
+        return TickSizeChange{header, old_tick, new_tick};
+    }
+    default:
+        return std::nullopt;
+    }
+}
+
+void write_all(int fd, std::string_view data) {
+    while (!data.empty()) {
+        auto written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "WAL write failed");
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+void sync_fd(int fd) {
+#ifdef __APPLE__
+    int rc = ::fsync(fd);
+#else
+    int rc = ::fdatasync(fd);
+#endif
+    if (rc != 0) throw std::system_error(errno, std::generic_category(), "WAL sync failed");
+}
+
+} // namespace
+
+WriteAheadLog::WriteAheadLog(WalOptions options)
+    : options_(std::move(options)) {
+    std::filesystem::create_directories(options_.directory);
+    auto existing = list_segments();
+    open_segment(existing.empty() ? 1 : existing.back() + 1);
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    try {
+        close_segment();
+    } catch (const std::exception&) {
+        // Nothing to report to; the records were written, only not synced
+    }
+}
+
+uint64_t WriteAheadLog::append(const OrderBookEventVariant& event) {
+    record_.clear();
+    encode(event, record_);
+
+    if (segment_size_ > 0 && segment_size_ + record_.size() > options_.segment_bytes) {
+        close_segment();
+        open_segment(segment_ + 1);
+    }
+
+    try {
+        write_all(fd_, record_);
+    } catch (...) {
+        // A partial record ends what replay can read of this segment, so
+        // anything after it goes to a fresh one
+        segment_size_ = options_.segment_bytes;
+        throw;
+    }
+    segment_size_ += record_.size();
+    unsynced_ = true;
+    ++stats_.records_appended;
+    stats_.bytes_appended += record_.size();
+
+    if (options_.sync_interval.count() >= 0 &&
+        std::chrono::steady_clock::now() - last_sync_ >= options_.sync_interval) {
+        sync();
+    }
+    return segment_;
+}
+
+void WriteAheadLog::sync() {
+    if (!unsynced_) return;
+    sync_fd(fd_);
+    unsynced_ = false;
+    last_sync_ = std::chrono::steady_clock::now();
+    ++stats_.syncs;
+}
+
+void WriteAheadLog::release_before(uint64_t segment) {
+    for (auto id : list_segments()) {
+        if (id >= segment || id >= segment_) break;
+        std::error_code ec;
+        if (std::filesystem::remove(segment_path(id), ec)) ++stats_.segments_released;
+    }
+}
+
+size_t WriteAheadLog::replay(const Visitor& visit) const {
+    size_t records = 0;
+    for (auto id : list_segments()) {
+        std::ifstream in(segment_path(id), std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        std::string_view rest(data);
+        while (rest.size() >= kFrameBytes) {
+            uint32_t length = 0;
+            uint32_t crc = 0;
+            std::memcpy(&length, rest.data(), sizeof(length));
+            std::memcpy(&crc, rest.data() + sizeof(length), sizeof(crc));
+            if (length > kMaxPayloadBytes || rest.size() - kFrameBytes < length) break;
+
+            auto payload = rest.substr(kFrameBytes, length);
+            if (crc32(payload) != crc) break;
+            auto event = decode(payload);
+            if (!event) break;
+
+            visit(id, std::move(*event));
+            ++records;
+            rest.remove_prefix(kFrameBytes + length);
+        }
+    }
+    return records;
+}
+
+void WriteAheadLog::encode(const OrderBookEventVariant& event, std::string& out) {
+    auto frame = out.size();
+    put(out, uint32_t{0});
+    put(out, uint32_t{0});
+
+    std::visit([&](const auto& e) {
+        put(out, static_cast<uint8_t>(event.index()));
+        put(out, e.timestamp.milliseconds());
+        put(out, e.sequence_number);
+        put_string(out, e.asset.condition_id());
+        put_string(out, e.asset.token_id());
+        put_body(out, e);
+    }, event);
+
+    std::string_view payload(out.data() + frame + kFrameBytes, out.size() - frame - kFrameBytes);
+    auto length = static_cast<uint32_t>(payload.size());
+    auto crc = crc32(payload);
+    std::memcpy(out.data() + frame, &length, sizeof(length));
+    std::memcpy(out.data() + frame + sizeof(length), &crc, sizeof(crc));
+}
+
+std::optional<OrderBookEventVariant> WriteAheadLog::decode(std::string_view payload) {
+    Reader in{payload};
+    try {
+        auto event = get_event(in);
+        if (event && in.pos != payload.size()) return std::nullopt;
+        return event;
+    } catch (const std::exception&) {
+        // A value the domain rejects (e.g. a negative price)
+        return std::nullopt;
+    }
+}
+
+std::string WriteAheadLog::segment_path(uint64_t segment) const {
+    char name[48];
+    std::snprintf(name, sizeof(name), "segment_%020llu.wal",
+                  static_cast<unsigned long long>(segment));
+    return (std::filesystem::path(options_.directory) / name).string();
+}
+
+std::vector<uint64_t> WriteAheadLog::list_segments() const {
+    std::vector<uint64_t> segments;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(options_.directory, ec)) {
+        auto name = entry.path().filename().string();
+        if (name.size() <= kSegmentPrefix.size() + kSegmentSuffix.size() ||
+            name.compare(0, kSegmentPrefix.size(), kSegmentPrefix) != 0 ||
+            name.compare(name.size() - kSegmentSuffix.size(), kSegmentSuffix.size(),
+                         kSegmentSuffix) != 0) {
+            continue;
+        }
+        auto digits = name.substr(kSegmentPrefix.size(),
+                                  name.size() - kSegmentPrefix.size() - kSegmentSuffix.size());
+        if (!std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        segments.push_back(std::stoull(digits));
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+void WriteAheadLog::open_segment(uint64_t segment) {
+    auto path = segment_path(segment);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot open WAL segment " + path);
+    }
+    fd_ = fd;
+    segment_ = segment;
+    segment_size_ = 0;
+    last_sync_ = std::chrono::steady_clock::now();
+}
+
+void WriteAheadLog::close_segment() {
+    if (fd_ < 0) return;
+    try {
+        if (options_.sync_interval.count() >= 0) sync();
+    } catch (...) {
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+    ::close(fd_);
+    fd_ = -1;
+    unsynced_ = false;
+}
+
+} // namespace mde::repositories::wal
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mde::repositories::wal {
+
+struct WalOptions {
+    std::string directory;
+    // The next append starts a new segment once the current one is this big
+    size_t segment_bytes = 64 * 1024 * 1024;
+    // Group commit: fdatasync at most this often. Zero syncs every append;
+    // negative never syncs (records still survive a process crash).
+    std::chrono::milliseconds sync_interval{10};
+};
+
+struct WalStats {
+    uint64_t records_appended{0};
+    uint64_t bytes_appended{0};
+    uint64_t syncs{0};
+    uint64_t segments_released{0};
+};
+
+/// Append-only binary event log, split into segments
+/// {directory}/segment_{id:020}.wal with increasing ids. Each record is
+///
+///   u32 payload length | u32 CRC-32 of the payload | payload
+///
+/// and the payload is a fixed header (event type, timestamp, sequence
+/// number, asset ids) followed by the event's own fields; see encode().
+/// Integers are in host byte order: a log is only read on the machine that
+/// wrote it.
+///
+/// Each append is a single write(2) to an O_APPEND descriptor, so a record
+/// survives a process crash once append returns, at the cost of a syscall
+/// rather than a file. fdatasync is group-committed: an append syncs once
+/// sync_interval has passed since the last sync. The records after that
+/// wait for the next append, sync() or close, so an owner that must bound
+/// what a power loss can take after a burst calls sync() on a timer.
+///
+/// Opening never appends to an existing segment (its last record may be
+/// torn); it starts the one after the newest. Not thread-safe: the owner
+/// serializes calls.
+class WriteAheadLog {
+public:
+    using Visitor = std::function<void(uint64_t segment, mde::domain::OrderBookEventVariant&& event)>;
+
+    /// Creates the directory if needed. Throws std::system_error if the new
+    /// segment cannot be created.
+    explicit WriteAheadLog(WalOptions options);
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /// Returns the segment the record went to. Throws std::system_error if
+    /// the write fails.
+    uint64_t append(const mde::domain::OrderBookEventVariant& event);
+
+    /// fdatasync the current segment now
+    void sync();
+
+    /// Delete every segment older than `segment`, once their events are
+    /// stored elsewhere. The current segment is never deleted.
+    void release_before(uint64_t segment);
+
+    uint64_t current_segment() const noexcept { return segment_; }
+
+    /// Visit every record on disk, oldest first; returns how many. A segment
+    /// is read up to its first incomplete or corrupt record, which can only
+    /// be the torn tail of its last write.
+    size_t replay(const Visitor& visit) const;
+
+    WalStats stats() const noexcept { return stats_; }
+
+    /// Append one framed record to out
+    static void encode(const mde::domain::OrderBookEventVariant& event, std::string& out);
+
+    /// Decode a record payload (without its frame); nullopt if malformed
+    static std::optional<mde::domain::OrderBookEventVariant> decode(std::string_view payload);
+
+private:
+    std::string segment_path(uint64_t segment) const;
+    std::vector<uint64_t> list_segments() const;
+    void open_segment(uint64_t segment);
+    void close_segment();
+
+    WalOptions options_;
+    uint64_t segment_{0};
+    int fd_{-1};
+    size_t segment_size_{0};
+    std::string record_;   // encode buffer, reused across appends
+    std::chrono::steady_clock::time_point last_sync_;
+    bool unsynced_{false};
+    WalStats stats_;
+};
+
+} // namespace mde::repositories::wal
@@ -0,0 +1,64 @@
+#include "services/BacktestRunner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <utility>
+
+namespace mde::services {
+
+using namespace mde::domain;
+
+BacktestRunner::BacktestRunner(const mde::repositories::IOrderBookRepository& repo)
+    : repository_(repo) {}
+
+BacktestResult BacktestRunner::run(const std::vector<MarketAsset>& assets,
+                                   const StrategyFactory& make_strategy,
+                                   const BacktestOptions& options) const {
+    auto started = std::chrono::steady_clock::now();
+    BacktestResult result;
+    result.assets.reserve(assets.size());
+    for (const auto& asset : assets) {
+        result.assets.push_back(BacktestAssetResult{asset, {}, OrderBook::empty(asset), {}});
+    }
+
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        while (true) {
+            size_t i = next.fetch_add(1);
+            if (i >= assets.size()) break;
+
+            // Each asset is claimed by one worker, so its result is written
+            // by that worker alone
+            auto& market = result.assets[i];
+            try {
+                auto strategy = make_strategy ? make_strategy(market.asset) : Strategy{};
+                ReplayEngine engine(repository_);
+                market.stats = engine.replay({market.asset}, strategy, options.sequence_number, options.until);
+                market.book = engine.book(market.asset);
+            } catch (const std::exception& e) {
+                market.error = e.what();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    auto pool_size = std::min(std::max<size_t>(options.threads, 1), assets.size());
+    for (size_t t = 1; t < pool_size; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();  // The calling thread works too
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    for (const auto& market : result.assets) {
+        result.events += market.stats.events;
+    }
+    result.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    return result;
+}
+
+} // namespace mde::services
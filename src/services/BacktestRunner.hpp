@@ -0,0 +1,63 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+#include "repositories/IOrderBookRepository.hpp"
+#include "services/ReplayEngine.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mde::services {
+
+struct BacktestOptions {
+    size_t threads = 1;             // the calling thread counts as one
+    uint64_t sequence_number = 0;   // replay events after this one
+    std::optional<mde::domain::Timestamp> until;  // last event time replayed
+};
+
+// One asset's replay, in the order the assets were given
+struct BacktestAssetResult {
+    mde::domain::MarketAsset asset;
+    ReplayStats stats;
+    mde::domain::OrderBook book;  // as of the last event replayed
+    std::string error;            // empty unless the replay threw
+};
+
+struct BacktestResult {
+    std::vector<BacktestAssetResult> assets;
+    uint64_t events{0};
+    std::chrono::microseconds duration{0};
+};
+
+// Runs a strategy over the recorded history of many assets at once. Each
+// asset is replayed on its own ReplayEngine by whichever worker claims it
+// next, so a busy market holds one thread while the others work through the
+// rest; list the busiest assets first so they do not start last.
+//
+// Every asset gets its own strategy from the factory and sees its events in
+// sequence order on one thread, so a strategy that keeps to its own state
+// produces the same results however the assets are spread over threads.
+// Strategies for different assets run concurrently; anything they share
+// must be synchronized. The repository must allow concurrent reads.
+class BacktestRunner {
+public:
+    using Strategy = ReplayEngine::Observer;
+    // Called on the worker that claims the asset, before its first event
+    using StrategyFactory = std::function<Strategy(const mde::domain::MarketAsset& asset)>;
+
+    explicit BacktestRunner(const mde::repositories::IOrderBookRepository& repo);
+
+    BacktestResult run(const std::vector<mde::domain::MarketAsset>& assets,
+                       const StrategyFactory& make_strategy,
+                       const BacktestOptions& options = {}) const;
+
+private:
+    const mde::repositories::IOrderBookRepository& repository_;
+};
+
+} // namespace mde::services
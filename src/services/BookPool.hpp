@@ -0,0 +1,175 @@
+#pragma once
+
+#include "domain/value_objects/MarketAsset.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace mde::services {
+
+// Per-asset entries in cache-line-aligned slots, allocated kChunkSlots at
+// a time and found through a flat index on the asset's interned token id.
+//
+// A lookup is one array read instead of a hash probe and a node chase, and
+// every entry starts on its own cache line next to its neighbours rather
+// than in a node of its own somewhere on the heap. Entries never move, so
+// pointers and references to one stay valid until it is erased; an erased
+// entry's slot is reused by the next one emplaced. Iteration is in slot
+// order.
+//
+// Keyed by the token id alone, which is unique across markets. The index
+// holds a slot for every token interned before the newest one in the pool,
+// four bytes each. Not thread-safe; callers lock as they would a map.
+template <typename Entry>
+class BookPool {
+public:
+    using value_type = std::pair<const mde::domain::MarketAsset, Entry>;
+
+    template <bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = BookPool::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using Pool = std::conditional_t<Const, const BookPool, BookPool>;
+
+        Iterator() = default;
+        // The first live slot from `slot` on
+        Iterator(Pool* pool, size_t slot) : pool_(pool), slot_(pool->next_live(slot)) {}
+        // iterator -> const_iterator
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) : pool_(other.pool_), slot_(other.slot_) {}
+
+        reference operator*() const { return pool_->at(slot_); }
+        pointer operator->() const { return &pool_->at(slot_); }
+        Iterator& operator++() {
+            slot_ = pool_->next_live(slot_ + 1);
+            return *this;
+        }
+        Iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+        bool operator==(const Iterator& other) const { return slot_ == other.slot_; }
+
+    private:
+        friend class BookPool;
+        friend class Iterator<true>;
+        Pool* pool_{nullptr};
+        size_t slot_{0};
+    };
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    BookPool() = default;
+    BookPool(const BookPool&) = delete;
+    BookPool& operator=(const BookPool&) = delete;
+
+    ~BookPool() {
+        for (size_t slot = 0; slot < slots_; ++slot) {
+            if (live_[slot]) at(slot).~value_type();
+        }
+    }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    iterator begin() noexcept { return {this, 0}; }
+    iterator end() noexcept { return {this, slots_}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, slots_}; }
+
+    iterator find(const mde::domain::MarketAsset& asset) noexcept { return {this, slot_of(asset)}; }
+    const_iterator find(const mde::domain::MarketAsset& asset) const noexcept { return {this, slot_of(asset)}; }
+
+    // Does nothing, returning the existing entry and false, if the asset
+    // already has one
+    std::pair<iterator, bool> emplace(const mde::domain::MarketAsset& asset, Entry entry) {
+        auto slot = slot_of(asset);
+        if (slot != slots_) return {iterator(this, slot), false};
+
+        auto token = asset.token().index();
+        if (token >= index_.size()) index_.resize(token + 1, kNoSlot);
+        if (!free_.empty()) {
+            slot = free_.back();
+            free_.pop_back();
+        } else {
+            if (slots_ == chunks_.size() * kChunkSlots) chunks_.push_back(std::unique_ptr<Chunk>(new Chunk));
+            slot = slots_++;
+            live_.push_back(false);
+        }
+        new (bytes(slot)) value_type(asset, std::move(entry));
+        live_[slot] = true;
+        index_[token] = static_cast<uint32_t>(slot);
+        ++size_;
+        return {iterator(this, slot), true};
+    }
+
+    std::pair<iterator, bool> insert_or_assign(const mde::domain::MarketAsset& asset, Entry entry) {
+        auto slot = slot_of(asset);
+        if (slot == slots_) return emplace(asset, std::move(entry));
+        at(slot).second = std::move(entry);
+        return {iterator(this, slot), false};
+    }
+
+    // Returns whether there was an entry
+    bool erase(const mde::domain::MarketAsset& asset) {
+        auto slot = slot_of(asset);
+        if (slot == slots_) return false;
+        at(slot).~value_type();
+        live_[slot] = false;
+        index_[asset.token().index()] = kNoSlot;
+        free_.push_back(slot);
+        --size_;
+        return true;
+    }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+    static constexpr size_t kChunkSlots = 32;
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    struct alignas(kCacheLine) Slot {
+        alignas(value_type) std::byte bytes[sizeof(value_type)];
+    };
+    struct Chunk {
+        Slot slots[kChunkSlots];
+    };
+
+    std::byte* bytes(size_t slot) const noexcept {
+        return chunks_[slot / kChunkSlots]->slots[slot % kChunkSlots].bytes;
+    }
+    value_type& at(size_t slot) noexcept { return *std::launder(reinterpret_cast<value_type*>(bytes(slot))); }
+    const value_type& at(size_t slot) const noexcept {
+        return *std::launder(reinterpret_cast<const value_type*>(bytes(slot)));
+    }
+
+    // slots_ when absent, like end()
+    size_t slot_of(const mde::domain::MarketAsset& asset) const noexcept {
+        auto token = asset.token().index();
+        if (token >= index_.size() || index_[token] == kNoSlot) return slots_;
+        return index_[token];
+    }
+
+    size_t next_live(size_t slot) const noexcept {
+        while (slot < slots_ && !live_[slot]) ++slot;
+        return slot;
+    }
+
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    std::vector<uint32_t> index_;  // token index -> slot
+    std::vector<bool> live_;       // per slot in use
+    std::vector<size_t> free_;     // erased slots, reused first
+    size_t slots_{0};              // slots ever used
+    size_t size_{0};               // live entries
+};
+
+} // namespace mde::services
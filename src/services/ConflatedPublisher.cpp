@@ -0,0 +1,113 @@
+#include "services/ConflatedPublisher.hpp"
+
+#include "services/SpscQueue.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+namespace mde::services {
+
+using namespace mde::domain;
+
+void validate(const ConflationOptions& options) {
+    if (options.interval.count() <= 0) {
+        throw std::invalid_argument("Conflation interval must be positive");
+    }
+    if (options.depth == 0) {
+        throw std::invalid_argument("Conflated books must hold at least one level per side");
+    }
+}
+
+ConflatedPublisher::ConflatedPublisher(OrderBookService& service, Sink sink, ConflationOptions options)
+    : service_(service)
+    , sink_(std::move(sink))
+    , options_(options)
+    , subscription_(service.events().subscribe()) {
+    validate(options_);
+}
+
+ConflatedPublisher::~ConflatedPublisher() {
+    stop();
+}
+
+void ConflatedPublisher::start() {
+    if (running_.exchange(true)) return;
+    worker_ = std::thread([this] { run(); });
+}
+
+void ConflatedPublisher::stop() {
+    if (!running_.exchange(false)) return;
+    if (worker_.joinable()) worker_.join();
+}
+
+void ConflatedPublisher::run() {
+    using Clock = std::chrono::steady_clock;
+    Backoff backoff;
+    auto next_flush = Clock::now() + options_.interval;
+    while (running_.load(std::memory_order_acquire)) {
+        if (poll() > 0) {
+            backoff.reset();
+        } else {
+            backoff.pause();
+        }
+        auto now = Clock::now();
+        if (now >= next_flush) {
+            flush();
+            // A flush that overran skips the intervals it missed
+            next_flush = std::max(next_flush + options_.interval, now);
+        }
+    }
+    poll();
+    flush();
+}
+
+size_t ConflatedPublisher::poll() {
+    size_t read = subscription_.poll([this](const OrderBookEventVariant& event) {
+        mark_dirty(std::visit([](const auto& e) -> const MarketAsset& { return e.asset; }, event));
+    });
+    if (read == 0) return 0;
+    seen_.fetch_add(read, std::memory_order_relaxed);
+
+    auto dropped = subscription_.dropped();
+    if (dropped != last_dropped_) {
+        last_dropped_ = dropped;
+        dropped_.store(dropped, std::memory_order_relaxed);
+        for (auto& [asset, dirty] : assets_) {
+            if (!dirty) {
+                dirty = true;
+                dirty_.push_back(asset);
+            }
+        }
+    }
+    return read;
+}
+
+void ConflatedPublisher::mark_dirty(const MarketAsset& asset) {
+    auto it = assets_.try_emplace(asset, false).first;
+    if (it->second) return;
+    it->second = true;
+    dirty_.push_back(asset);
+}
+
+size_t ConflatedPublisher::flush() {
+    if (dirty_.empty()) return 0;
+
+    batch_.clear();
+    for (const auto& asset : dirty_) {
+        assets_[asset] = false;
+        if (auto levels = service_.get_top_levels(asset, options_.depth)) {
+            batch_.push_back(std::move(*levels));
+        }
+    }
+    dirty_.clear();
+
+    if (!batch_.empty()) {
+        sink_(batch_);
+        published_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    }
+    return batch_.size();
+}
+
+} // namespace mde::services
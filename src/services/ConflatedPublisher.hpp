@@ -0,0 +1,90 @@
+#pragma once
+
+#include "services/OrderBookService.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mde::services {
+
+struct ConflationOptions {
+    // How often the books that changed are published
+    std::chrono::milliseconds interval{100};
+    // Levels per side in each published book
+    size_t depth = 10;
+};
+
+// Throws std::invalid_argument for a non-positive interval or zero depth
+void validate(const ConflationOptions& options);
+
+// Latest-value publishing for consumers that don't want every delta. Reads
+// the service's event stream on a thread of its own and only notes which
+// assets changed; once per interval it copies the top `depth` levels of each
+// of them (OrderBookService::get_top_levels) and hands the batch to the sink.
+// However many events an asset gets in an interval it is published once, so
+// what the sink sees, and what this holds (a dirty flag per asset seen), is
+// bounded by the number of assets rather than the update rate.
+//
+// A publisher that falls a whole ring behind the stream cannot tell which
+// assets the lost events touched, so it republishes every asset it knows.
+//
+// Either start() the worker, or call poll() and flush() from one thread; not
+// both. The sink runs on that thread. The counters may be read from any
+// thread.
+class ConflatedPublisher {
+public:
+    using Sink = std::function<void(std::span<const BookLevels> books)>;
+
+    // Subscribes at once: events published from here on mark their asset
+    ConflatedPublisher(OrderBookService& service, Sink sink, ConflationOptions options = {});
+    ~ConflatedPublisher();
+
+    ConflatedPublisher(const ConflatedPublisher&) = delete;
+    ConflatedPublisher& operator=(const ConflatedPublisher&) = delete;
+
+    void start();
+    // Joins the worker after publishing what changed before the call
+    void stop();
+
+    // Note the assets of every event published so far; returns how many
+    // events were read
+    size_t poll();
+    // Publish every asset changed since the last flush; returns how many
+    // books went to the sink
+    size_t flush();
+
+    uint64_t events_seen() const noexcept { return seen_.load(std::memory_order_relaxed); }
+    uint64_t books_published() const noexcept { return published_.load(std::memory_order_relaxed); }
+    uint64_t events_dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void mark_dirty(const mde::domain::MarketAsset& asset);
+
+    OrderBookService& service_;
+    Sink sink_;
+    ConflationOptions options_;
+    OrderBookService::EventStream::Subscription subscription_;
+
+    // Polling thread only. Every asset seen, with whether it changed since
+    // the last flush; dirty_ lists the changed ones in the order they changed.
+    std::unordered_map<mde::domain::MarketAsset, bool> assets_;
+    std::vector<mde::domain::MarketAsset> dirty_;
+    std::vector<BookLevels> batch_;  // reused by every flush
+    uint64_t last_dropped_{0};
+
+    std::atomic<uint64_t> seen_{0};
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+};
+
+} // namespace mde::services
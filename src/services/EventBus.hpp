@@ -0,0 +1,129 @@
+#pragma once
+
+#include "services/Published.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mde::services {
+
+// Broadcast ring buffer: every published value is seen by every subscriber,
+// each reading at its own pace through its own cursor.
+//
+// publish() never waits for subscribers and may be called from several
+// threads (values from one thread stay in order). Each value is stored once,
+// as a shared immutable entry, and subscribers read it in place. A subscriber
+// that falls a full ring behind loses the oldest entries; it skips to the
+// oldest one still held and counts the rest in dropped().
+template <typename T>
+class EventBus {
+public:
+    struct Entry {
+        uint64_t sequence;
+        T value;
+    };
+
+    // Owned by one consumer thread; cheap to create, register none up front
+    class Subscription {
+    public:
+        // Next entry, or nullptr when caught up
+        std::shared_ptr<const Entry> next() {
+            while (true) {
+                auto entry = bus_->slots_[cursor_ & bus_->mask_].load();
+                if (!entry || entry->sequence < cursor_) return nullptr;
+                if (entry->sequence == cursor_) {
+                    ++cursor_;
+                    return entry;
+                }
+                // Lapped: our entry was overwritten, resume at the oldest held
+                auto head = bus_->head_.load(std::memory_order_acquire);
+                auto oldest = head - std::min<uint64_t>(head, bus_->capacity());
+                oldest = std::max(oldest, cursor_ + 1);
+                dropped_ += oldest - cursor_;
+                cursor_ = oldest;
+            }
+        }
+
+        // Drain everything available; returns how many entries were handled
+        template <typename Handler>
+        size_t poll(Handler&& handler) {
+            size_t handled = 0;
+            while (auto entry = next()) {
+                handler(entry->value);
+                ++handled;
+            }
+            return handled;
+        }
+
+        uint64_t cursor() const noexcept { return cursor_; }
+        uint64_t dropped() const noexcept { return dropped_; }
+
+        ~Subscription() {
+            if (bus_) bus_->subscribers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        Subscription(Subscription&& other) noexcept
+            : bus_(std::exchange(other.bus_, nullptr))
+            , cursor_(other.cursor_)
+            , dropped_(other.dropped_) {}
+        Subscription& operator=(Subscription&&) = delete;
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+    private:
+        friend class EventBus;
+        Subscription(EventBus* bus, uint64_t cursor) : bus_(bus), cursor_(cursor) {}
+
+        EventBus* bus_;
+        uint64_t cursor_;
+        uint64_t dropped_{0};
+    };
+
+    // Capacity is rounded up to a power of two
+    explicit EventBus(size_t capacity)
+        : mask_(round_up_pow2(capacity) - 1)
+        , slots_(mask_ + 1) {}
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    // Starts at the next value published; must not outlive the bus
+    Subscription subscribe() {
+        subscribers_.fetch_add(1, std::memory_order_relaxed);
+        return Subscription(this, head_.load(std::memory_order_acquire));
+    }
+
+    // Lets publishers skip building entries nobody will read
+    bool has_subscribers() const noexcept {
+        return subscribers_.load(std::memory_order_relaxed) > 0;
+    }
+
+    void publish(T value) {
+        auto sequence = head_.fetch_add(1, std::memory_order_acq_rel);
+        slots_[sequence & mask_].store(
+            std::make_shared<const Entry>(Entry{sequence, std::move(value)}));
+    }
+
+    // Sequence the next publish will get
+    uint64_t head() const noexcept { return head_.load(std::memory_order_acquire); }
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const size_t mask_;
+    std::vector<Published<Entry>> slots_;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<size_t> subscribers_{0};
+};
+
+} // namespace mde::services
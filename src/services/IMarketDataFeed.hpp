@@ -3,16 +3,36 @@
 #include "domain/aggregates/OrderBook.hpp"
 
 #include <functional>
+#include <span>
 #include <string>
 
 namespace mde::services {
 
 class IMarketDataFeed {
 public:
-    using EventCallback = std::function<void(const mde::domain::OrderBookEventVariant&)>;
+    // Receives each event by rvalue so it can be moved on into storage
+    using EventCallback = std::function<void(mde::domain::OrderBookEventVariant&&)>;
 
     virtual void set_on_event(EventCallback callback) = 0;
+
+    // Receives the events of one message together, to be moved from. Feeds
+    // that produce events in groups override this; the default hands them
+    // over one at a time through set_on_event.
+    using BatchCallback = std::function<void(std::span<mde::domain::OrderBookEventVariant>)>;
+    virtual void set_on_events(BatchCallback callback) {
+        set_on_event([callback = std::move(callback)](mde::domain::OrderBookEventVariant&& event) {
+            callback(std::span<mde::domain::OrderBookEventVariant>(&event, 1));
+        });
+    }
     virtual void subscribe(const std::string& token_id) = 0;
+    // Several tokens at once. Feeds that can subscribe them in one request
+    // override this; the default subscribes them one at a time.
+    virtual void subscribe_all(std::span<const std::string> token_ids) {
+        for (const auto& token_id : token_ids) subscribe(token_id);
+    }
+    // Stops delivering the tokens' events, as far as the source allows.
+    // Feeds without subscriptions of their own ignore it.
+    virtual void unsubscribe_all(std::span<const std::string>) {}
     virtual void start() = 0;
     virtual void stop() = 0;
     virtual ~IMarketDataFeed() = default;
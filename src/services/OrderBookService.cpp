@@ -1,100 +1,868 @@
 #include "services/OrderBookService.hpp"
 
+#include "telemetry/CpuAffinity.hpp"
+#include "telemetry/Latency.hpp"
+#include "telemetry/Metrics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <functional>
+#include <iostream>
 #include <stdexcept>
 #include <variant>
 
 using namespace mde::domain;
+using mde::telemetry::Stage;
+using mde::telemetry::pin_current_thread;
+using mde::telemetry::record_since;
+using mde::telemetry::tsc_now;
 
 namespace mde::services {
 
+namespace {
+
+const MarketAsset& asset_of(const OrderBookEventVariant& event) {
+    return std::visit([](const auto& e) -> const MarketAsset& { return e.asset; }, event);
+}
+
+// Events held for subscribers of events(); a consumer this far behind drops
+constexpr size_t kEventBusCapacity = 16384;
+
+// How often the event path reads the clock to check for an age sweep
+constexpr uint32_t kSweepCheckEvents = 256;
+
+// How long a retired token keeps late events from building a book
+constexpr auto kRetiredMemory = std::chrono::minutes(10);
+
+// mde_events_total label values, by variant index
+constexpr std::array<const char*, std::variant_size_v<OrderBookEventVariant>> kEventTypeNames = {
+    "book_snapshot", "book_delta", "trade_event", "tick_size_change",
+};
+
+// Blocks the producer while the consumer catches up rather than dropping data
+template <typename T>
+void push_blocking(SpscQueue<T>& queue, T&& value) {
+    Backoff backoff;
+    while (!queue.try_push(std::move(value))) {
+        backoff.pause();
+    }
+}
+
+} // anonymous namespace
+
 OrderBookService::OrderBookService(mde::repositories::IOrderBookRepository& repo,
                                    IMarketDataFeed& feed,
-                                   uint64_t snapshot_interval)
+                                   uint64_t snapshot_every_events,
+                                   size_t shard_count,
+                                   size_t queue_capacity,
+                                   std::chrono::milliseconds snapshot_max_age,
+                                   PipelineThreads threads)
     : repository_(repo)
     , feed_(feed)
-    , snapshot_interval_(snapshot_interval) {
-    feed_.set_on_event([this](const OrderBookEventVariant& event) {
-        on_event(event);
+    , snapshot_every_events_(snapshot_every_events)
+    , snapshot_max_age_(snapshot_max_age)
+    , threads_(std::move(threads))
+    , bus_(kEventBusCapacity) {
+    auto& metrics = mde::telemetry::MetricsRegistry::global();
+    for (size_t i = 0; i < events_by_type_.size(); ++i) {
+        events_by_type_[i] = &metrics.counter("mde_events_total", "Events received from the feed",
+                                              {{"type", kEventTypeNames[i]}});
+    }
+    divergence_counter_ = &metrics.counter("mde_book_divergences_total",
+                                           "Books whose top disagreed with the exchange's");
+    stale_gauge_ = &metrics.gauge("mde_books_stale", "Books waiting for a snapshot after a feed outage");
+    retired_counter_ = &metrics.counter("mde_books_retired_total", "Books dropped after their market closed");
+    if (shard_count > 0) {
+        shards_.reserve(shard_count);
+        for (size_t i = 0; i < shard_count; ++i) {
+            shards_.push_back(std::make_unique<Shard>(queue_capacity));
+        }
+        write_queue_ = std::make_unique<SpscQueue<OrderBookEventVariant>>(queue_capacity);
+        start_pipeline();
+    }
+
+    feed_.set_on_events([this](std::span<OrderBookEventVariant> events) {
+        on_events(events);
     });
 }
 
+OrderBookService::~OrderBookService() {
+    stop_pipeline();
+}
+
 void OrderBookService::subscribe(const std::string& token_id) {
+    unretire(std::span(&token_id, 1));
     feed_.subscribe(token_id);
 }
 
+void OrderBookService::subscribe_all(std::span<const std::string> token_ids) {
+    unretire(token_ids);
+    feed_.subscribe_all(token_ids);
+}
+
 void OrderBookService::start() {
     feed_.start();
 }
 
 void OrderBookService::stop() {
     feed_.stop();
+    stop_pipeline();
+}
+
+RecoveryStats OrderBookService::recover(const std::vector<std::string>& token_ids,
+                                        size_t threads) {
+    auto started = std::chrono::steady_clock::now();
+    RecoveryStats stats;
+    stats.markets.resize(token_ids.size());
+
+    // One read for every checkpointed book
+    auto checkpointed = repository_.load_checkpoint();
+    std::unordered_map<std::string_view, OrderBook*> by_token;
+    by_token.reserve(checkpointed.size());
+    for (auto& book : checkpointed) {
+        by_token.emplace(book.get_asset().token_id(), &book);
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> from_checkpoint{0};
+    std::atomic<uint64_t> max_sequence{0};
+    auto worker = [&] {
+        while (true) {
+            size_t i = next.fetch_add(1);
+            if (i >= token_ids.size()) break;
+
+            auto& market = stats.markets[i];
+            market.token_id = token_ids[i];
+            auto market_started = std::chrono::steady_clock::now();
+
+            try {
+                // Each token is claimed by one worker, so moving out is safe
+                std::optional<OrderBook> book;
+                if (auto it = by_token.find(token_ids[i]); it != by_token.end()) {
+                    book = std::move(*it->second);
+                    from_checkpoint.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    book = repository_.get_latest_snapshot_by_token(token_ids[i]);
+                }
+                if (book) {
+                    market.events_replayed = repository_.replay_events(
+                        {book->get_asset()}, book->get_last_sequence_number(),
+                        [&](OrderBookEventVariant&& event) {
+                            book->apply_in_place(event);
+                            return true;
+                        });
+                    market.recovered = true;
+
+                    auto seq = book->get_last_sequence_number();
+                    auto seen = max_sequence.load();
+                    while (seq > seen && !max_sequence.compare_exchange_weak(seen, seq)) {}
+                    install_book(std::move(*book));
+                }
+            } catch (const std::exception& e) {
+                // Leave the book empty; the next "book" message rebuilds it
+                std::cerr << "[recovery] " << token_ids[i] << ": " << e.what() << std::endl;
+            }
+
+            market.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - market_started);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    auto pool_size = std::min(std::max<size_t>(threads, 1), token_ids.size());
+    for (size_t t = 1; t < pool_size; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();  // The calling thread works too
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    // Continue numbering after every stored event, including those of
+    // markets not recovered here
+    auto resume_at = std::max(repository_.max_sequence_number(), max_sequence.load()) + 1;
+    if (resume_at > next_sequence_number_.load()) {
+        next_sequence_number_.store(resume_at);
+    }
+
+    stats.from_checkpoint = from_checkpoint.load();
+    for (const auto& market : stats.markets) {
+        if (market.recovered) ++stats.recovered;
+        stats.events_replayed += market.events_replayed;
+    }
+    stats.total = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    return stats;
+}
+
+size_t OrderBookService::checkpoint() {
+    std::vector<OrderBook> books;
+    if (sharded()) {
+        for (const auto& shard : shards_) {
+            std::lock_guard lock(shard->mutex);
+            for (const auto& [asset, entry] : shard->books) {
+                books.push_back(entry.book);
+            }
+        }
+    } else {
+        std::lock_guard lock(books_mutex_);
+        for (const auto& [asset, entry] : current_books_) {
+            books.push_back(entry.book);
+        }
+    }
+    repository_.store_checkpoint(books);
+    return books.size();
+}
+
+void OrderBookService::install_book(OrderBook book) {
+    auto asset = book.get_asset();
+    BookEntry entry{std::move(book), 0, Clock::now(), nullptr};
+    // Keep readers of a replaced book on the same published slot
+    auto install = [&](Books& books) {
+        auto it = books.find(asset);
+        if (it != books.end()) entry.published = std::move(it->second.published);
+        if (entry.published) publish(entry);
+        if (on_book_update_) on_book_update_(entry.book, false);
+        books.insert_or_assign(asset, std::move(entry));
+    };
+    {
+        std::unique_lock lock(index_mutex_);
+        assets_by_token_.insert_or_assign(asset.token_id(), asset);
+    }
+
+    if (sharded()) {
+        auto& shard = shard_for(asset);
+        std::lock_guard lock(shard.mutex);
+        install(shard.books);
+    } else {
+        std::lock_guard lock(books_mutex_);
+        install(current_books_);
+    }
 }
 
 void OrderBookService::on_event(const OrderBookEventVariant& event) {
+    on_event(OrderBookEventVariant(event));
+}
+
+void OrderBookService::on_event(OrderBookEventVariant&& event) {
     // Assign sequence number
-    auto numbered = event;
-    std::visit([this](auto& e) { e.sequence_number = next_sequence_number_++; }, numbered);
+    std::visit([this](auto& e) {
+        e.sequence_number = next_sequence_number_.fetch_add(1, std::memory_order_relaxed);
+    }, event);
+    events_by_type_[event.index()]->inc();
+
+    // A copy: the event is moved on below
+    auto asset = asset_of(event);
+    index_asset(asset);
+
+    if (!sharded()) {
+        // Apply to the projection in place, then move the event into storage.
+        // The projection is owned here, so there is no full-book copy per event.
+        auto started = tsc_now();
+        {
+            std::lock_guard lock(books_mutex_);
+            const OrderBook* due = nullptr;
+            try {
+                due = apply(current_books_, event);
+            } catch (...) {
+                // The event store still records what the feed sent
+                repository_.append_event(std::move(event));
+                throw;
+            }
+            if (due) repository_.store_snapshot(*due);
+            if (sweep_due(inline_sweep_)) {
+                for (const auto& book : take_stale(current_books_)) {
+                    repository_.store_snapshot(book);
+                }
+            }
+        }
+        // Chained: the append is timed from the end of the apply (publishing
+        // in between is a pointer store), saving a counter read per event
+        started = record_since(Stage::apply, started);
+        if (bus_.has_subscribers()) bus_.publish(OrderBookEventVariant(event));
+        repository_.append_event(std::move(event));
+        record_since(Stage::append, started);
+        return;
+    }
 
-    // Extract asset from event
-    const auto& asset = std::visit(
-        [](const auto& e) -> const MarketAsset& { return e.asset; }, numbered);
+    // Writer first, so the repository sees events in sequence order. The
+    // writer and the shard both need the event, so this is the one copy.
+    auto& shard = shard_for(asset);
+    OrderBookEventVariant for_writer = event;
+    writes_enqueued_.fetch_add(1, std::memory_order_relaxed);
+    push_blocking(*write_queue_, std::move(for_writer));
+    shard.enqueued.fetch_add(1, std::memory_order_relaxed);
+    push_blocking(shard.inbox, std::move(event));
+}
+
+void OrderBookService::on_events(std::span<OrderBookEventVariant> events) {
+    if (sharded() || events.size() == 1) {
+        for (auto& event : events) on_event(std::move(event));
+        return;
+    }
 
-    // Persist event
-    repository_.append_event(numbered);
+    for (auto& event : events) {
+        std::visit([this](auto& e) {
+            e.sequence_number = next_sequence_number_.fetch_add(1, std::memory_order_relaxed);
+        }, event);
+        events_by_type_[event.index()]->inc();
+        index_asset(asset_of(event));
+    }
+
+    // As in on_event, a run that fails to apply is not published but still
+    // stored; the other runs apply, and the first failure is rethrown once
+    // the whole batch is stored
+    std::exception_ptr failure;
+    std::vector<std::pair<size_t, size_t>> failed_runs;
+    auto started = tsc_now();
+    {
+        std::lock_guard lock(books_mutex_);
+        for (size_t first = 0; first < events.size();) {
+            const auto& asset = asset_of(events[first]);
+            size_t last = first + 1;
+            while (last < events.size() && asset_of(events[last]) == asset) ++last;
+            const OrderBook* due = nullptr;
+            try {
+                due = apply(current_books_, events.subspan(first, last - first));
+            } catch (...) {
+                if (!failure) failure = std::current_exception();
+                failed_runs.emplace_back(first, last);
+            }
+            if (due) repository_.store_snapshot(*due);
+            first = last;
+        }
+        if (sweep_due(inline_sweep_, false, events.size())) {
+            for (const auto& book : take_stale(current_books_)) {
+                repository_.store_snapshot(book);
+            }
+        }
+    }
+    started = record_since(Stage::apply, started);
+    if (bus_.has_subscribers()) {
+        auto failed = failed_runs.begin();
+        for (size_t i = 0; i < events.size(); ++i) {
+            while (failed != failed_runs.end() && i >= failed->second) ++failed;
+            if (failed != failed_runs.end() && i >= failed->first) continue;
+            bus_.publish(OrderBookEventVariant(events[i]));
+        }
+    }
+    repository_.append_events(events);
+    record_since(Stage::append, started);
+    if (failure) std::rethrow_exception(failure);
+}
+
+const OrderBook* OrderBookService::apply(Books& books, const OrderBookEventVariant& event) {
+    return apply(books, std::span<const OrderBookEventVariant>(&event, 1));
+}
+
+const OrderBook* OrderBookService::apply(Books& books,
+                                         std::span<const OrderBookEventVariant> run) {
+    const auto& asset = asset_of(run.front());
 
     // Find or create the book for this asset
-    auto it = current_books_.find(asset);
-    if (it == current_books_.end()) {
-        it = current_books_.emplace(asset, OrderBook::empty(asset)).first;
+    auto it = books.find(asset);
+    if (it == books.end()) {
+        if (is_retired(asset)) return nullptr;
+        it = books.emplace(asset, BookEntry{OrderBook::empty(asset), 0, Clock::now(), nullptr}).first;
+    }
+    auto& entry = it->second;
+    entry.book.apply_in_place(run);
+    if (entry.published) publish(entry);
+    check_divergence(entry, run);
+    if (entry.stale && std::any_of(run.begin(), run.end(), [](const OrderBookEventVariant& event) {
+            return std::holds_alternative<BookSnapshot>(event);
+        })) {
+        entry.stale = false;
+        stale_gauge_->add(-1);
+    }
+    if (on_book_update_) on_book_update_(entry.book, entry.stale);
+
+    entry.unsnapshotted += run.size();
+    if (snapshot_every_events_ > 0 && entry.unsnapshotted >= snapshot_every_events_) {
+        entry.unsnapshotted = 0;
+        if (snapshot_max_age_.count() > 0) entry.snapshotted = Clock::now();
+        return &entry.book;
     }
+    return nullptr;
+}
 
-    // Apply event to projection
-    it->second = it->second.apply(numbered);
+void OrderBookService::check_divergence(BookEntry& entry, std::span<const OrderBookEventVariant> run) {
+    // Only the run's last book event matters: a snapshot resets the book,
+    // and the exchange's top after the last delta is what the book must show
+    for (auto it = run.rbegin(); it != run.rend(); ++it) {
+        if (std::holds_alternative<BookSnapshot>(*it)) {
+            entry.diverged = false;
+            return;
+        }
+        if (const auto* delta = std::get_if<BookDelta>(&*it)) {
+            if (entry.diverged || entry.book.agrees_with(*delta)) return;
+            entry.diverged = true;
+            divergences_.fetch_add(1, std::memory_order_relaxed);
+            divergence_counter_->inc();
+            if (on_divergence_) on_divergence_(entry.book.get_asset());
+            return;
+        }
+    }
+}
 
-    // Maybe persist a snapshot
-    maybe_snapshot(asset, it->second.get_last_sequence_number());
+void OrderBookService::publish(const BookEntry& entry) {
+    entry.published->store(std::make_shared<const OrderBook>(entry.book));
 }
 
-const OrderBook& OrderBookService::get_current_book(const MarketAsset& asset) const {
-    auto it = current_books_.find(asset);
-    if (it == current_books_.end()) {
+std::shared_ptr<OrderBookService::PublishedBook> OrderBookService::start_publishing(
+    const MarketAsset& asset) const {
+    // Under the book lock, so no event lands between the copy and the
+    // applier seeing entry.published
+    auto start = [&](const Books& books) -> std::shared_ptr<PublishedBook> {
+        auto it = books.find(asset);
+        if (it == books.end()) {
+            throw std::runtime_error("No book for asset");
+        }
+        const auto& entry = it->second;
+        if (!entry.published) {
+            entry.published = std::make_shared<PublishedBook>();
+            publish(entry);
+        }
+        return entry.published;
+    };
+
+    std::shared_ptr<PublishedBook> slot;
+    if (sharded()) {
+        auto& shard = shard_for(asset);
+        std::lock_guard lock(shard.mutex);
+        slot = start(shard.books);
+    } else {
+        std::lock_guard lock(books_mutex_);
+        slot = start(current_books_);
+    }
+
+    std::unique_lock lock(published_mutex_);
+    return published_.try_emplace(asset, std::move(slot)).first->second;
+}
+
+bool OrderBookService::sweep_due(SweepSchedule& schedule, bool idle, size_t events) const {
+    if (snapshot_max_age_.count() <= 0) return false;
+    if (!idle) {
+        schedule.events += static_cast<uint32_t>(std::min<size_t>(events, kSweepCheckEvents));
+        if (schedule.events < kSweepCheckEvents) return false;
+    }
+    schedule.events = 0;
+
+    auto now = Clock::now();
+    if (now < schedule.next) return false;
+    // A quarter of the max age keeps staleness within 1.25x of it
+    schedule.next = now + std::max(snapshot_max_age_ / 4, std::chrono::milliseconds(1));
+    return true;
+}
+
+std::vector<OrderBook> OrderBookService::take_stale(Books& books) const {
+    std::vector<OrderBook> stale;
+    auto now = Clock::now();
+    for (auto& [asset, entry] : books) {
+        if (entry.unsnapshotted == 0 || now - entry.snapshotted < snapshot_max_age_) continue;
+        stale.push_back(entry.book);
+        entry.unsnapshotted = 0;
+        entry.snapshotted = now;
+    }
+    return stale;
+}
+
+void OrderBookService::index_asset(const MarketAsset& asset) {
+    if (unindex_pending_.load(std::memory_order_acquire)) unindex_retired();
+    // Only this thread writes the index, so the unlocked probe is safe
+    if (assets_by_token_.find(asset.token_id()) != assets_by_token_.end()) return;
+    // A late event for a closed market does not bring its token back
+    if (is_retired(asset)) return;
+    std::unique_lock lock(index_mutex_);
+    assets_by_token_.emplace(asset.token_id(), asset);
+}
+
+void OrderBookService::unindex_retired() {
+    std::vector<std::string> tokens;
+    {
+        std::lock_guard lock(retired_mutex_);
+        for (auto& token_id : unindex_) {
+            // Unless subscribed again since
+            if (retired_.count(AssetId(token_id))) tokens.push_back(std::move(token_id));
+        }
+        unindex_.clear();
+        unindex_pending_.store(false, std::memory_order_relaxed);
+    }
+    std::unique_lock lock(index_mutex_);
+    for (const auto& token_id : tokens) {
+        assets_by_token_.erase(token_id);
+    }
+}
+
+OrderBookService::Shard& OrderBookService::shard_for(const MarketAsset& asset) const {
+    return *shards_[std::hash<MarketAsset>{}(asset) % shards_.size()];
+}
+
+// --- Pipeline ---
+
+void OrderBookService::start_pipeline() {
+    running_.store(true, std::memory_order_release);
+    writer_running_.store(true, std::memory_order_release);
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        shards_[i]->worker = std::thread([this, &owned = *shards_[i], i] { run_shard(owned, i); });
+    }
+    writer_ = std::thread([this] { run_writer(); });
+}
+
+void OrderBookService::stop_pipeline() {
+    if (!running_.load(std::memory_order_acquire)) return;
+    drain();
+    running_.store(false, std::memory_order_release);
+    for (auto& shard : shards_) {
+        if (shard->worker.joinable()) shard->worker.join();
+    }
+    writer_running_.store(false, std::memory_order_release);
+    if (writer_.joinable()) writer_.join();
+}
+
+void OrderBookService::run_shard(Shard& shard, size_t index) {
+    pin_current_thread(threads_.shard_cpus, "ingest shard", index);
+    Backoff backoff(threads_.busy_poll);
+    while (true) {
+        auto event = shard.inbox.try_pop();
+        if (!event) {
+            if (!running_.load(std::memory_order_acquire) && shard.inbox.empty()) break;
+            // Quiet markets still get their age-based snapshots
+            if (sweep_due(shard.sweep, /*idle=*/true)) {
+                sweep_shard(shard);
+            }
+            backoff.pause();
+            continue;
+        }
+        backoff.reset();
+
+        std::optional<OrderBook> snapshot;
+        auto started = tsc_now();
+        try {
+            std::lock_guard lock(shard.mutex);
+            if (const auto* book = apply(shard.books, *event)) {
+                snapshot = *book;
+            }
+        } catch (const std::exception& e) {
+            // No caller to rethrow to; skip the event and keep the shard alive
+            std::cerr << "[ingest] Dropped event: " << e.what() << std::endl;
+        }
+        record_since(Stage::apply, started);
+        if (snapshot) {
+            writes_enqueued_.fetch_add(1, std::memory_order_relaxed);
+            push_blocking(shard.outbox, std::move(*snapshot));
+        }
+        if (bus_.has_subscribers()) bus_.publish(std::move(*event));
+        if (sweep_due(shard.sweep)) {
+            sweep_shard(shard);
+        }
+        shard.applied.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void OrderBookService::sweep_shard(Shard& shard) {
+    std::vector<OrderBook> stale;
+    {
+        std::lock_guard lock(shard.mutex);
+        stale = take_stale(shard.books);
+    }
+    for (auto& book : stale) {
+        writes_enqueued_.fetch_add(1, std::memory_order_relaxed);
+        push_blocking(shard.outbox, std::move(book));
+    }
+}
+
+void OrderBookService::run_writer() {
+    pin_current_thread(threads_.writer_cpus, "ingest writer");
+    Backoff backoff(threads_.busy_poll);
+    while (true) {
+        bool did_work = false;
+
+        while (auto event = write_queue_->try_pop()) {
+            auto started = tsc_now();
+            repository_.append_event(std::move(*event));
+            record_since(Stage::append, started);
+            writes_done_.fetch_add(1, std::memory_order_release);
+            did_work = true;
+        }
+        for (auto& shard : shards_) {
+            while (auto snapshot = shard->outbox.try_pop()) {
+                repository_.store_snapshot(*snapshot);
+                writes_done_.fetch_add(1, std::memory_order_release);
+                did_work = true;
+            }
+        }
+
+        if (did_work) {
+            backoff.reset();
+            continue;
+        }
+        if (!writer_running_.load(std::memory_order_acquire)) break;
+        backoff.pause();
+    }
+}
+
+void OrderBookService::drain() const {
+    if (!sharded()) return;
+
+    Backoff backoff;
+    for (const auto& shard : shards_) {
+        while (shard->applied.load(std::memory_order_acquire) <
+               shard->enqueued.load(std::memory_order_relaxed)) {
+            backoff.pause();
+        }
+    }
+    // Every snapshot is enqueued by now, so the writer total is final
+    while (writes_done_.load(std::memory_order_acquire) <
+           writes_enqueued_.load(std::memory_order_relaxed)) {
+        backoff.pause();
+    }
+}
+
+// --- Queries ---
+
+const OrderBook& OrderBookService::find_book(const MarketAsset& asset) const {
+    const auto& books = sharded() ? shard_for(asset).books : current_books_;
+    auto it = books.find(asset);
+    if (it == books.end()) {
         throw std::runtime_error("No book for asset");
     }
-    return it->second;
+    return it->second.book;
+}
+
+const OrderBook& OrderBookService::get_current_book(const MarketAsset& asset) const {
+    if (!sharded()) return find_book(asset);
+    std::lock_guard lock(shard_for(asset).mutex);
+    return find_book(asset);
+}
+
+std::shared_ptr<const OrderBook> OrderBookService::get_book_snapshot(
+    const MarketAsset& asset) const {
+    {
+        std::shared_lock lock(published_mutex_);
+        auto it = published_.find(asset);
+        if (it != published_.end()) return it->second->load();
+    }
+    return start_publishing(asset)->load();
+}
+
+std::optional<BookLevels> OrderBookService::get_top_levels(const MarketAsset& asset, size_t depth) const {
+    auto copy = [&](const Books& books) -> std::optional<BookLevels> {
+        auto it = books.find(asset);
+        if (it == books.end()) return std::nullopt;
+        const auto& book = it->second.book;
+        BookLevels levels{asset, book.get_timestamp(), book.get_last_sequence_number(), {}, {}, it->second.stale};
+        auto take = [depth](const PriceLadder& ladder, std::vector<PriceLevel>& out) {
+            out.reserve(std::min(depth, ladder.size()));
+            for (auto level = ladder.begin(); level != ladder.end() && out.size() < depth; ++level) {
+                out.push_back(*level);
+            }
+        };
+        take(book.get_bids(), levels.bids);
+        take(book.get_asks(), levels.asks);
+        return levels;
+    };
+    if (sharded()) {
+        auto& shard = shard_for(asset);
+        std::lock_guard lock(shard.mutex);
+        return copy(shard.books);
+    }
+    std::lock_guard lock(books_mutex_);
+    return copy(current_books_);
 }
 
 Spread OrderBookService::get_current_spread(const MarketAsset& asset) const {
-    return get_current_book(asset).get_spread();
+    return get_book_snapshot(asset)->get_spread();
 }
 
 Price OrderBookService::get_midpoint(const MarketAsset& asset) const {
-    return get_current_book(asset).get_midpoint();
+    return get_book_snapshot(asset)->get_midpoint();
 }
 
-std::optional<MarketAsset> OrderBookService::resolve_asset(const std::string& token_id) const {
-    for (const auto& [asset, book] : current_books_) {
-        if (asset.token_id() == token_id) {
-            return asset;
-        }
+std::optional<MarketAsset> OrderBookService::resolve_asset(std::string_view token_id) const {
+    std::shared_lock lock(index_mutex_);
+    auto it = assets_by_token_.find(token_id);
+    if (it == assets_by_token_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::vector<std::optional<MarketAsset>> OrderBookService::resolve_assets(
+    const std::vector<std::string>& token_ids) const {
+    std::vector<std::optional<MarketAsset>> resolved;
+    resolved.reserve(token_ids.size());
+    for (const auto& token_id : token_ids) {
+        resolved.push_back(resolve_asset(token_id));
     }
-    return std::nullopt;
+    return resolved;
 }
 
 uint64_t OrderBookService::event_count() const {
-    return next_sequence_number_ - 1;
+    return next_sequence_number_.load(std::memory_order_relaxed) - 1;
 }
 
 size_t OrderBookService::book_count() const {
-    return current_books_.size();
+    if (!sharded()) {
+        std::lock_guard lock(books_mutex_);
+        return current_books_.size();
+    }
+    size_t count = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard lock(shard->mutex);
+        count += shard->books.size();
+    }
+    return count;
+}
+
+void OrderBookService::set_on_divergence(DivergenceCallback callback) {
+    on_divergence_ = std::move(callback);
+}
+
+void OrderBookService::set_on_book_update(BookUpdateCallback callback) {
+    on_book_update_ = std::move(callback);
+}
+
+std::vector<MarketAsset> OrderBookService::diverged_assets() const {
+    std::vector<MarketAsset> diverged;
+    auto collect = [&](const Books& books) {
+        for (const auto& [asset, entry] : books) {
+            if (entry.diverged) diverged.push_back(asset);
+        }
+    };
+    if (sharded()) {
+        for (const auto& shard : shards_) {
+            std::lock_guard lock(shard->mutex);
+            collect(shard->books);
+        }
+    } else {
+        std::lock_guard lock(books_mutex_);
+        collect(current_books_);
+    }
+    return diverged;
+}
+
+template <typename Fn>
+void OrderBookService::with_books(const MarketAsset& asset, Fn&& fn) {
+    if (sharded()) {
+        auto& shard = shard_for(asset);
+        std::lock_guard lock(shard.mutex);
+        fn(shard.books);
+    } else {
+        std::lock_guard lock(books_mutex_);
+        fn(current_books_);
+    }
 }
 
-void OrderBookService::maybe_snapshot(const MarketAsset& asset, uint64_t sequence_number) {
-    if (snapshot_interval_ > 0 && sequence_number % snapshot_interval_ == 0) {
-        auto it = current_books_.find(asset);
-        if (it != current_books_.end()) {
-            repository_.store_snapshot(it->second);
+template <typename Fn>
+void OrderBookService::with_entry(const MarketAsset& asset, Fn&& fn) {
+    with_books(asset, [&](Books& books) {
+        auto it = books.find(asset);
+        if (it != books.end()) fn(it->second);
+    });
+}
+
+size_t OrderBookService::mark_stale(std::span<const std::string> token_ids) {
+    size_t marked = 0;
+    for (const auto& token_id : token_ids) {
+        auto asset = resolve_asset(token_id);
+        if (!asset) continue;
+        with_entry(*asset, [&](BookEntry& entry) {
+            if (entry.stale) return;
+            entry.stale = true;
+            stale_gauge_->add(1);
+            ++marked;
+        });
+    }
+    return marked;
+}
+
+size_t OrderBookService::retire(std::span<const std::string> token_ids) {
+    feed_.unsubscribe_all(token_ids);
+    {
+        std::lock_guard lock(retired_mutex_);
+        auto now = Clock::now();
+        std::erase_if(retired_, [&](const auto& entry) { return now - entry.second > kRetiredMemory; });
+        for (const auto& token_id : token_ids) retired_.insert_or_assign(AssetId(token_id), now);
+    }
+
+    std::vector<MarketAsset> dropped;
+    for (const auto& token_id : token_ids) {
+        auto asset = resolve_asset(token_id);
+        if (!asset) continue;
+        std::optional<OrderBook> last;
+        with_books(*asset, [&](Books& books) {
+            auto it = books.find(*asset);
+            if (it == books.end()) return;
+            auto& entry = it->second;
+            if (entry.unsnapshotted > 0) last = std::move(entry.book);
+            if (entry.stale) stale_gauge_->add(-1);
+            books.erase(*asset);
+            dropped.push_back(*asset);
+        });
+        // Outside the book lock, like the writer's snapshots
+        if (last) repository_.store_snapshot(*last);
+    }
+
+    if (!dropped.empty()) {
+        retired_counter_->inc(dropped.size());
+        std::unique_lock lock(published_mutex_);
+        for (const auto& asset : dropped) published_.erase(asset);
+    }
+
+    // The index belongs to the on_event thread, which drops them on its
+    // next event
+    {
+        std::lock_guard lock(retired_mutex_);
+        unindex_.insert(unindex_.end(), token_ids.begin(), token_ids.end());
+        unindex_pending_.store(true, std::memory_order_release);
+    }
+    return dropped.size();
+}
+
+bool OrderBookService::is_retired(const MarketAsset& asset) const {
+    std::lock_guard lock(retired_mutex_);
+    return retired_.count(asset.token()) > 0;
+}
+
+void OrderBookService::unretire(std::span<const std::string> token_ids) {
+    std::lock_guard lock(retired_mutex_);
+    if (retired_.empty()) return;
+    for (const auto& token_id : token_ids) retired_.erase(AssetId(token_id));
+}
+
+std::vector<MarketAsset> OrderBookService::stale_assets() const {
+    std::vector<MarketAsset> stale;
+    auto collect = [&](const Books& books) {
+        for (const auto& [asset, entry] : books) {
+            if (entry.stale) stale.push_back(asset);
+        }
+    };
+    if (sharded()) {
+        for (const auto& shard : shards_) {
+            std::lock_guard lock(shard->mutex);
+            collect(shard->books);
         }
+    } else {
+        std::lock_guard lock(books_mutex_);
+        collect(current_books_);
+    }
+    return stale;
+}
+
+bool OrderBookService::is_stale(const MarketAsset& asset) const {
+    auto stale_in = [&](const Books& books) {
+        auto it = books.find(asset);
+        return it != books.end() && it->second.stale;
+    };
+    if (sharded()) {
+        auto& shard = shard_for(asset);
+        std::lock_guard lock(shard.mutex);
+        return stale_in(shard.books);
     }
+    std::lock_guard lock(books_mutex_);
+    return stale_in(current_books_);
 }
 
 } // namespace mde::services
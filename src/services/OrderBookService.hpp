@@ -2,47 +2,354 @@
 
 #include "domain/aggregates/OrderBook.hpp"
 #include "repositories/IOrderBookRepository.hpp"
+#include "services/BookPool.hpp"
+#include "services/EventBus.hpp"
 #include "services/IMarketDataFeed.hpp"
+#include "services/Published.hpp"
+#include "services/SpscQueue.hpp"
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
-#include <map>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace mde::telemetry {
+class Counter;
+class Gauge;
+}
 
 namespace mde::services {
 
+// Outcome of OrderBookService::recover
+struct RecoveryStats {
+    struct Market {
+        std::string token_id;
+        bool recovered{false};      // false: no snapshot, or the replay failed
+        size_t events_replayed{0};
+        std::chrono::microseconds duration{0};
+    };
+
+    std::vector<Market> markets;    // in the order requested
+    size_t recovered{0};
+    size_t from_checkpoint{0};      // books found in the checkpoint
+
+    size_t events_replayed{0};
+    std::chrono::microseconds total{0};
+};
+
+// The best levels of one book, copied out by OrderBookService::get_top_levels
+struct BookLevels {
+    mde::domain::MarketAsset asset;
+    mde::domain::Timestamp timestamp;
+    uint64_t last_sequence_number{0};
+    std::vector<mde::domain::PriceLevel> bids;  // best (highest) first
+    std::vector<mde::domain::PriceLevel> asks;  // best (lowest) first
+    bool stale{false};                          // see mark_stale
+};
+
+// Where the sharded pipeline's threads run. CPUs are cpulists as taken by
+// telemetry/CpuAffinity; empty leaves a thread to the scheduler.
+struct PipelineThreads {
+    std::string shard_cpus;   // shard i on the i-th of these (wrapping)
+    std::string writer_cpus;
+    bool busy_poll{false};    // workers and writer spin while idle, never sleep
+};
+
+// Applies feed events to per-asset books and persists them.
+//
+// Snapshot policy, tracked per book: a book is snapshotted after
+// snapshot_every_events of its own events, and a book with unsnapshotted
+// events is snapshotted once its last snapshot is snapshot_max_age old
+// (0 disables either trigger). The age check is a periodic sweep over the
+// books rather than a clock read per event; it runs on the shard workers
+// (also while idle), or inline between events.
+//
+// With shard_count == 0 everything runs inline on the caller of on_event.
+// With shard_count > 0 on_event only numbers the event and dispatches it:
+//   - books are split across shard_count worker threads by asset hash,
+//     each owning its books and fed by its own SPSC queue;
+//   - append_event/store_snapshot run on a separate writer thread.
+// `threads` places them. Books first seen on the feed are allocated by
+// their worker, so under first-touch a pinned worker's books sit on its
+// own NUMA node (those recovered at startup sit on the loader's).
+//
+// Ordering guarantees (both modes): sequence numbers are globally monotonic
+// in on_event call order; events reach the repository in sequence order;
+// every asset's events are applied in sequence order. With shards, a
+// snapshot may be stored before the events preceding it are appended, and
+// queries see a book once its shard has caught up (see drain()).
+//
+// on_event must be called from one thread at a time (the feed's callback),
+// and not after stop(). The repository must be thread-safe: checkpoint()
+// and retire() write to it from their callers' threads while the event
+// path appends.
 class OrderBookService {
 public:
     OrderBookService(mde::repositories::IOrderBookRepository& repo,
                      IMarketDataFeed& feed,
-                     uint64_t snapshot_interval = 1000);
+                     uint64_t snapshot_every_events = 1000,
+                     size_t shard_count = 0,
+                     size_t queue_capacity = 65536,
+                     std::chrono::milliseconds snapshot_max_age = std::chrono::milliseconds(0),
+                     PipelineThreads threads = {});
+    ~OrderBookService();
+
+    OrderBookService(const OrderBookService&) = delete;
+    OrderBookService& operator=(const OrderBookService&) = delete;
 
-    // Lifecycle — delegates to feed
+    // Lifecycle — delegates to feed; stop() also drains and joins the pipeline
     void subscribe(const std::string& token_id);
+    void subscribe_all(std::span<const std::string> token_ids);
     void start();
     void stop();
 
-    // Event ingestion (also called by feed callback)
+    // Warm start: for each token, load its latest snapshot and replay the
+    // events stored after it, spread over `threads` threads. The checkpoint
+    // is loaded once up front; tokens it lacks fall back to per-asset
+    // snapshots. Must run before start(), while no events are flowing.
+    // Sequence numbering resumes after the highest recovered sequence number.
+    RecoveryStats recover(const std::vector<std::string>& token_ids, size_t threads);
+
+    // Store every current book as one repository checkpoint. With shards,
+    // each shard is copied under its lock, so the books may be from slightly
+    // different points in the stream; recovery replays each from its own
+    // sequence number. Safe to call from any thread. Returns the number of
+    // books stored.
+    size_t checkpoint();
+
+    // Event ingestion (also called by feed callback). The rvalue overload
+    // numbers the event in place and moves it into the repository; the
+    // const& overload copies once and forwards to it.
     void on_event(const mde::domain::OrderBookEventVariant& event);
+    void on_event(mde::domain::OrderBookEventVariant&& event);
+
+    // The events of one message (the feed's batch callback), moved from.
+    // Inline, each run of consecutive events for the same asset is applied
+    // as a batch under one lock and published once, and the whole span goes
+    // to the repository in one append_events call. A run that throws does
+    // not stop the others; the first exception is rethrown after the append.
+    // With shards, the events are dispatched one at a time as by on_event.
+    void on_events(std::span<mde::domain::OrderBookEventVariant> events);
+
+    // Every event, numbered, once it has been applied to its book. Consumers
+    // (analytics, recorders, publishers) subscribe and poll on their own
+    // threads; a slow consumer drops its oldest events instead of holding
+    // up ingestion. With shards, events of one asset arrive in order but
+    // assets on different shards may interleave. Nothing is published while
+    // there are no subscribers.
+    using EventStream = EventBus<mde::domain::OrderBookEventVariant>;
+    EventStream& events() noexcept { return bus_; }
+
+    // Block until every event passed to on_event so far has been applied
+    // and persisted. No-op in inline mode.
+    void drain() const;
 
-    // Queries against current projection
+    // Queries against current projection. With shards, the returned
+    // reference is only stable while no events are in flight (after drain()).
     const mde::domain::OrderBook& get_current_book(const mde::domain::MarketAsset& asset) const;
+
+    // Immutable copy of the current book, safe to read from any thread and
+    // to keep. The first call for an asset copies the book under its lock;
+    // from then on every event republishes it, and calls only load the
+    // latest version without touching the book lock. Books never read cost
+    // nothing extra. Throws for unknown assets, like get_current_book.
+    std::shared_ptr<const mde::domain::OrderBook> get_book_snapshot(
+        const mde::domain::MarketAsset& asset) const;
+
+    // The best `depth` levels of each side, copied under the book lock
+    // without copying the rest of the book or starting to publish it;
+    // nullopt for unknown assets
+    std::optional<BookLevels> get_top_levels(const mde::domain::MarketAsset& asset, size_t depth) const;
+
+    // Spread and midpoint come from get_book_snapshot
     mde::domain::Spread get_current_spread(const mde::domain::MarketAsset& asset) const;
     mde::domain::Price get_midpoint(const mde::domain::MarketAsset& asset) const;
 
-    // Asset resolution and event count
-    std::optional<mde::domain::MarketAsset> resolve_asset(const std::string& token_id) const;
+    // Asset resolution (one hash probe per token) and event count
+    std::optional<mde::domain::MarketAsset> resolve_asset(std::string_view token_id) const;
+    std::vector<std::optional<mde::domain::MarketAsset>> resolve_assets(
+        const std::vector<std::string>& token_ids) const;
     uint64_t event_count() const;
     size_t book_count() const;
 
+    // Gap detection. After each delta the book's top is checked against the
+    // best_bid/best_ask the exchange sent with it; a book that disagrees is
+    // marked diverged until its next BookSnapshot, and the callback is told
+    // once per divergence so the feed can resync that asset. The callback
+    // runs on the applying thread with the book lock held: keep it short and
+    // don't call back into the service. Set it before start().
+    using DivergenceCallback = std::function<void(const mde::domain::MarketAsset&)>;
+    void set_on_divergence(DivergenceCallback callback);
+    std::vector<mde::domain::MarketAsset> diverged_assets() const;
+    uint64_t divergence_count() const noexcept { return divergences_.load(std::memory_order_relaxed); }
+
+    // Called after every run of events with the updated book and whether it
+    // is stale, and for every book recover() installs. Runs on the applying
+    // thread (a shard worker, the feed thread or a recovery worker) with the
+    // book lock held, so one asset's calls never overlap but different
+    // assets' may: keep it short, don't block, and don't call back into the
+    // service. Set it before start().
+    using BookUpdateCallback = std::function<void(const mde::domain::OrderBook& book, bool stale)>;
+    void set_on_book_update(BookUpdateCallback callback);
+
+    // Feed outages. The feed reports the tokens a dropped connection carried;
+    // their books keep their last state but are marked stale until a
+    // BookSnapshot arrives, which a resubscription sends. Returns how many
+    // books were newly marked; tokens without a book are ignored.
+    size_t mark_stale(std::span<const std::string> token_ids);
+    std::vector<mde::domain::MarketAsset> stale_assets() const;
+    bool is_stale(const mde::domain::MarketAsset& asset) const;
+
+    // Markets that have closed. Unsubscribes the tokens on the feed, stores
+    // a final snapshot of each book with events since its last one and
+    // drops the book. Events for a retired token still in flight are stored
+    // but build no book until the token is subscribed again. Returns how
+    // many books were dropped; tokens without a book are ignored.
+    size_t retire(std::span<const std::string> token_ids);
+
 private:
-    void maybe_snapshot(const mde::domain::MarketAsset& asset, uint64_t sequence_number);
+    using Clock = std::chrono::steady_clock;
+
+    using PublishedBook = Published<mde::domain::OrderBook>;
+
+    struct BookEntry {
+        mde::domain::OrderBook book;
+        uint64_t unsnapshotted{0};        // events applied since the last snapshot
+        Clock::time_point snapshotted;    // last snapshot, or when the book appeared
+        // Set by the first reader (under the book lock) and from then on
+        // republished after every event
+        mutable std::shared_ptr<PublishedBook> published;
+        bool diverged{false};             // since its top disagreed with a delta
+        bool stale{false};                // since its feed dropped, until a snapshot
+    };
+    using Books = BookPool<BookEntry>;
+
+    // When the next age sweep is due; owned by the thread applying events
+    struct SweepSchedule {
+        uint32_t events{0};
+        Clock::time_point next;
+    };
+
+    struct Shard {
+        // Snapshots are rare next to events, so the outbox can stay small
+        explicit Shard(size_t queue_capacity) : inbox(queue_capacity), outbox(1024) {}
+
+        // Books are written by the owning worker; the mutex lets queries
+        // from other threads read them safely.
+        mutable std::mutex mutex;
+        Books books;
+        SweepSchedule sweep;
+
+        SpscQueue<mde::domain::OrderBookEventVariant> inbox;  // dispatcher -> worker
+        SpscQueue<mde::domain::OrderBook> outbox;             // worker -> writer (snapshots)
+        std::atomic<uint64_t> enqueued{0};
+        std::atomic<uint64_t> applied{0};
+        std::thread worker;
+    };
+
+    bool sharded() const noexcept { return !shards_.empty(); }
+    Shard& shard_for(const mde::domain::MarketAsset& asset) const;
+    const mde::domain::OrderBook& find_book(const mde::domain::MarketAsset& asset) const;
+
+    // Returns the updated book when it has reached snapshot_every_events
+    const mde::domain::OrderBook* apply(Books& books,
+                                        const mde::domain::OrderBookEventVariant& event);
+    // A run of events for one asset, counted as run.size() events
+    const mde::domain::OrderBook* apply(Books& books,
+                                        std::span<const mde::domain::OrderBookEventVariant> run);
+    // True at most once per sweep period; reads the clock only every
+    // kSweepCheckEvents events (`events` at a time) unless idle
+    bool sweep_due(SweepSchedule& schedule, bool idle = false, size_t events = 1) const;
+    // Copies of the dirty books whose last snapshot is snapshot_max_age old
+    std::vector<mde::domain::OrderBook> take_stale(Books& books) const;
+    // Calls fn(books) with the books holding the asset's, under their lock
+    template <typename Fn>
+    void with_books(const mde::domain::MarketAsset& asset, Fn&& fn);
+    // Calls fn(entry) for the asset's book, if there is one, under its lock
+    template <typename Fn>
+    void with_entry(const mde::domain::MarketAsset& asset, Fn&& fn);
+    bool is_retired(const mde::domain::MarketAsset& asset) const;
+    void unretire(std::span<const std::string> token_ids);
+    void unindex_retired();
+    void check_divergence(BookEntry& entry, std::span<const mde::domain::OrderBookEventVariant> run);
+    static void publish(const BookEntry& entry);
+    std::shared_ptr<PublishedBook> start_publishing(const mde::domain::MarketAsset& asset) const;
+    void index_asset(const mde::domain::MarketAsset& asset);
+    void install_book(mde::domain::OrderBook book);
+
+    void start_pipeline();
+    void stop_pipeline();
+    void run_shard(Shard& shard, size_t index);
+    void sweep_shard(Shard& shard);
+    void run_writer();
 
     mde::repositories::IOrderBookRepository& repository_;
     IMarketDataFeed& feed_;
-    std::map<mde::domain::MarketAsset, mde::domain::OrderBook> current_books_;
-    uint64_t snapshot_interval_;
-    uint64_t next_sequence_number_{1};
+    uint64_t snapshot_every_events_;
+    std::chrono::milliseconds snapshot_max_age_;
+    PipelineThreads threads_;
+    std::atomic<uint64_t> next_sequence_number_{1};
+    // mde_events_total, indexed by the event's variant index
+    std::array<mde::telemetry::Counter*, std::variant_size_v<mde::domain::OrderBookEventVariant>>
+        events_by_type_{};
+    mde::telemetry::Counter* divergence_counter_{nullptr};
+    std::atomic<uint64_t> divergences_{0};
+    DivergenceCallback on_divergence_;
+    BookUpdateCallback on_book_update_;
+    mde::telemetry::Gauge* stale_gauge_{nullptr};
+    mde::telemetry::Counter* retired_counter_{nullptr};
+
+    // Tokens retired and not subscribed since, with when; read only when an
+    // event would create a book or index its asset. Kept kRetiredMemory,
+    // long enough for any event still in flight.
+    mutable std::mutex retired_mutex_;
+    std::unordered_map<mde::domain::AssetId, Clock::time_point> retired_;
+    // Retired tokens the on_event thread is to drop from assets_by_token_
+    std::vector<std::string> unindex_;
+    std::atomic<bool> unindex_pending_{false};
+
+    // Inline mode: indexed by interned token id, one array read per event
+    Books current_books_;
+    SweepSchedule inline_sweep_;
+    // Uncontended on the feed thread; taken for writes there, by recover()
+    // workers, checkpoint() and a first get_book_snapshot() from other threads
+    mutable std::mutex books_mutex_;
+
+    // Books readers have asked for. Only readers insert, so appliers never
+    // take this lock; they publish through BookEntry::published.
+    mutable std::shared_mutex published_mutex_;
+    mutable std::unordered_map<mde::domain::MarketAsset, std::shared_ptr<PublishedBook>> published_;
+
+    // token_id -> asset, maintained on first sight of an asset and pruned of
+    // retired tokens. Keys view the interned token strings, which live for
+    // the whole process. Written only by the on_event thread (and recover()
+    // before it starts), which may therefore read it without the lock.
+    mutable std::shared_mutex index_mutex_;
+    std::unordered_map<std::string_view, mde::domain::MarketAsset> assets_by_token_;
+
+    EventStream bus_;
+
+    // Sharded mode
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::unique_ptr<SpscQueue<mde::domain::OrderBookEventVariant>> write_queue_;  // dispatcher -> writer
+    std::atomic<uint64_t> writes_enqueued_{0};
+    std::atomic<uint64_t> writes_done_{0};
+    std::thread writer_;
+    std::atomic<bool> running_{false};
+    // Cleared only after the workers have exited, so their last snapshots land
+    std::atomic<bool> writer_running_{false};
 };
 
 } // namespace mde::services
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace mde::services {
+
+// A shared_ptr<const T> that one thread republishes and any thread reads.
+// Readers get a complete immutable version and keep it alive for as long as
+// they hold it; a store never waits for them to let go.
+//
+// std::atomic<std::shared_ptr> would do, but libc++ does not ship it, so a
+// spinlock guards the pointer instead. It is held only for a refcount bump
+// or a pointer swap, never while T is copied or destroyed.
+template <typename T>
+class Published {
+public:
+    Published() = default;
+    explicit Published(std::shared_ptr<const T> value) : value_(std::move(value)) {}
+
+    Published(const Published&) = delete;
+    Published& operator=(const Published&) = delete;
+
+    std::shared_ptr<const T> load() const {
+        Guard guard(lock_);
+        return value_;
+    }
+
+    void store(std::shared_ptr<const T> value) {
+        {
+            Guard guard(lock_);
+            value_.swap(value);
+        }
+        // The previous version, if this was its last owner, dies out here
+    }
+
+private:
+    class Guard {
+    public:
+        explicit Guard(std::atomic_flag& flag) : flag_(flag) {
+            while (flag_.test_and_set(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+        ~Guard() { flag_.clear(std::memory_order_release); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        std::atomic_flag& flag_;
+    };
+
+    mutable std::atomic_flag lock_;
+    std::shared_ptr<const T> value_;
+};
+
+} // namespace mde::services
@@ -0,0 +1,52 @@
+#include "services/ReplayEngine.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+namespace mde::services {
+
+using namespace mde::domain;
+
+ReplayEngine::ReplayEngine(const mde::repositories::IOrderBookRepository& repo)
+    : repository_(repo) {}
+
+ReplayStats ReplayEngine::replay(const std::vector<MarketAsset>& assets,
+                                 const Observer& observer,
+                                 uint64_t sequence_number,
+                                 std::optional<Timestamp> until) {
+    auto started = std::chrono::steady_clock::now();
+    for (const auto& asset : assets) {
+        books_.insert_or_assign(asset, OrderBook::empty(asset));
+    }
+
+    // One probe per run of events of the same asset
+    ReplayStats stats;
+    OrderBook* book = nullptr;
+    repository_.replay_events(assets, sequence_number, [&](OrderBookEventVariant&& event) {
+        const auto& header = std::visit([](const auto& e) -> const OrderBookEvent& { return e; }, event);
+        if (until && header.timestamp > *until) return false;
+
+        if (!book || book->get_asset() != header.asset) {
+            book = &books_.at(header.asset);
+        }
+        book->apply_in_place(event);
+        ++stats.events;
+        stats.last_sequence_number = header.sequence_number;
+        if (observer) observer(*book, event);
+        return true;
+    });
+    stats.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    return stats;
+}
+
+const OrderBook& ReplayEngine::book(const MarketAsset& asset) const {
+    auto it = books_.find(asset);
+    if (it == books_.end()) {
+        throw std::runtime_error("No book for asset");
+    }
+    return it->second;
+}
+
+} // namespace mde::services
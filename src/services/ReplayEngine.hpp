@@ -0,0 +1,55 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+#include "repositories/IOrderBookRepository.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace mde::services {
+
+struct ReplayStats {
+    uint64_t events{0};
+    uint64_t last_sequence_number{0};
+    std::chrono::microseconds duration{0};
+};
+
+// Rebuilds books from the event store for backtests and research. The
+// events of every requested asset come from the repository as one stream
+// in sequence order (IOrderBookRepository::replay_events) and are applied
+// in place, so a replay is a single pass over the store and holds only the
+// books plus what the repository buffers, however long the history.
+//
+// Not thread-safe; the repository may keep ingesting meanwhile.
+class ReplayEngine {
+public:
+    // Called after each event is applied, with the book it changed
+    using Observer = std::function<void(const mde::domain::OrderBook& book,
+                                        const mde::domain::OrderBookEventVariant& event)>;
+
+    explicit ReplayEngine(const mde::repositories::IOrderBookRepository& repo);
+
+    // Replay every stored event of `assets` after sequence_number onto
+    // empty books (replacing any earlier replay of those assets). With
+    // `until`, the first event stamped after it ends the replay.
+    ReplayStats replay(const std::vector<mde::domain::MarketAsset>& assets,
+                       const Observer& observer = {},
+                       uint64_t sequence_number = 0,
+                       std::optional<mde::domain::Timestamp> until = std::nullopt);
+
+    // Books as of the end of the last replay; throws for unknown assets
+    const mde::domain::OrderBook& book(const mde::domain::MarketAsset& asset) const;
+    const std::unordered_map<mde::domain::MarketAsset, mde::domain::OrderBook>& books() const noexcept {
+        return books_;
+    }
+
+private:
+    const mde::repositories::IOrderBookRepository& repository_;
+    std::unordered_map<mde::domain::MarketAsset, mde::domain::OrderBook> books_;
+};
+
+} // namespace mde::services
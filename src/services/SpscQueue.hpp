@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace mde::services {
+
+// Bounded lock-free single-producer/single-consumer ring buffer.
+// Exactly one thread may call try_push and exactly one thread may call
+// try_pop; both are wait-free. Capacity is rounded up to a power of two.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+        : mask_(round_up_pow2(capacity) - 1)
+        , slots_(mask_ + 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Returns false (leaving value untouched) when the queue is full
+    bool try_push(T&& value) {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) return false;
+        }
+        slots_[tail & mask_].emplace(std::move(value));
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> try_pop() {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return std::nullopt;
+        }
+        auto& slot = slots_[head & mask_];
+        std::optional<T> value(std::move(slot));
+        slot.reset();
+        head_.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    // Approximate when called concurrently with push/pop
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const size_t mask_;
+    std::vector<std::optional<T>> slots_;
+
+    // Consumer-owned
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+    size_t tail_cache_{0};
+
+    // Producer-owned
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};
+    size_t head_cache_{0};
+};
+
+// Idle strategy for queue consumers and blocked producers: spin briefly,
+// then yield, then sleep, so an idle stage does not pin a core (unless
+// it is busy, and has one to burn).
+class Backoff {
+public:
+    Backoff() = default;
+    // busy: only ever spin, for threads that have a core to themselves
+    explicit Backoff(bool busy) noexcept : busy_(busy) {}
+
+    void pause() {
+        if (busy_) return;
+        if (spins_ < kSpinLimit) {
+            ++spins_;
+        } else if (spins_ < kYieldLimit) {
+            ++spins_;
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    void reset() noexcept { spins_ = 0; }
+
+private:
+    static constexpr int kSpinLimit = 64;
+    static constexpr int kYieldLimit = 128;
+    int spins_{0};
+    bool busy_{false};
+};
+
+} // namespace mde::services
@@ -0,0 +1,82 @@
+#include "services/analytics/AnalyticsService.hpp"
+
+#include "services/SpscQueue.hpp"
+
+#include <utility>
+#include <variant>
+
+namespace mde::services::analytics {
+
+using namespace mde::domain;
+
+AnalyticsService::AnalyticsService(EventStream& events, AnalyticsOptions options)
+    : options_(options)
+    , subscription_(events.subscribe()) {
+    validate(options_);
+}
+
+AnalyticsService::~AnalyticsService() {
+    stop();
+}
+
+void AnalyticsService::start() {
+    if (running_.exchange(true)) return;
+    worker_ = std::thread([this] { run(); });
+}
+
+void AnalyticsService::stop() {
+    if (!running_.exchange(false)) return;
+    if (worker_.joinable()) worker_.join();
+}
+
+void AnalyticsService::run() {
+    Backoff backoff;
+    while (running_.load(std::memory_order_acquire)) {
+        if (poll() > 0) {
+            backoff.reset();
+        } else {
+            backoff.pause();
+        }
+    }
+    poll();
+}
+
+size_t AnalyticsService::poll() {
+    size_t applied = subscription_.poll([this](const OrderBookEventVariant& event) { apply(event); });
+    if (applied > 0) {
+        processed_.fetch_add(applied, std::memory_order_relaxed);
+        dropped_.store(subscription_.dropped(), std::memory_order_relaxed);
+    }
+    return applied;
+}
+
+void AnalyticsService::apply(const OrderBookEventVariant& event) {
+    const auto& asset = std::visit([](const auto& e) -> const MarketAsset& { return e.asset; }, event);
+
+    std::lock_guard lock(mutex_);
+    if (!last_ || last_->book().get_asset() != asset) {
+        auto it = markets_.find(asset);
+        if (it == markets_.end()) {
+            it = markets_.try_emplace(asset, asset, options_).first;
+        }
+        last_ = &it->second;
+    }
+    last_->apply(event);
+}
+
+std::optional<MetricsSnapshot> AnalyticsService::metrics(const MarketAsset& asset) const {
+    std::lock_guard lock(mutex_);
+    auto it = markets_.find(asset);
+    if (it == markets_.end()) return std::nullopt;
+    return it->second.snapshot();
+}
+
+std::vector<MetricsSnapshot> AnalyticsService::all_metrics() const {
+    std::lock_guard lock(mutex_);
+    std::vector<MetricsSnapshot> out;
+    out.reserve(markets_.size());
+    for (const auto& [asset, market] : markets_) out.push_back(market.snapshot());
+    return out;
+}
+
+} // namespace mde::services::analytics
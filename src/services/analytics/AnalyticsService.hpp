@@ -0,0 +1,68 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+#include "services/EventBus.hpp"
+#include "services/analytics/MarketMetrics.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mde::services::analytics {
+
+// Streaming market analytics over the service's event stream
+// (OrderBookService::events()). Keeps a MarketMetrics per asset seen,
+// updated on a thread of its own, so ingestion never waits for it; if it
+// falls a whole ring behind it loses events (events_dropped()) and its
+// copy of a book may be off until that asset's next snapshot.
+//
+// Either start() the worker, or call poll() from one thread; not both.
+// metrics() and the counters may be read from any thread.
+class AnalyticsService {
+public:
+    using EventStream = EventBus<mde::domain::OrderBookEventVariant>;
+
+    // Subscribes at once: events published from here on are counted
+    explicit AnalyticsService(EventStream& events, AnalyticsOptions options = {});
+    ~AnalyticsService();
+
+    AnalyticsService(const AnalyticsService&) = delete;
+    AnalyticsService& operator=(const AnalyticsService&) = delete;
+
+    void start();
+    // Joins the worker after it has applied what was already published
+    void stop();
+
+    // Apply every event published so far; returns how many were applied
+    size_t poll();
+
+    std::optional<MetricsSnapshot> metrics(const mde::domain::MarketAsset& asset) const;
+    std::vector<MetricsSnapshot> all_metrics() const;
+
+    uint64_t events_processed() const noexcept { return processed_.load(std::memory_order_relaxed); }
+    uint64_t events_dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void apply(const mde::domain::OrderBookEventVariant& event);
+
+    AnalyticsOptions options_;
+    EventStream::Subscription subscription_;
+
+    // Written by the polling thread, read by metrics()
+    mutable std::mutex mutex_;
+    std::unordered_map<mde::domain::MarketAsset, MarketMetrics> markets_;
+    MarketMetrics* last_{nullptr};  // metrics of the previous event's asset
+
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+};
+
+} // namespace mde::services::analytics
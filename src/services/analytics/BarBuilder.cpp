@@ -0,0 +1,168 @@
+#include "services/analytics/BarBuilder.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+
+namespace mde::services::analytics {
+
+using namespace mde::domain;
+
+namespace {
+
+void add_quote(Bar& bar, int64_t bid, int64_t ask) {
+    auto mid = (bid + ask) / 2;
+    auto spread = ask - bid;
+    if (bar.mid_open == 0) {
+        bar.mid_open = bar.mid_high = bar.mid_low = mid;
+        bar.spread_max = spread;
+    }
+    bar.mid_high = std::max(bar.mid_high, mid);
+    bar.mid_low = std::min(bar.mid_low, mid);
+    bar.mid_close = mid;
+    bar.spread_close = spread;
+    bar.spread_max = std::max(bar.spread_max, spread);
+}
+
+void add_trade(Bar& bar, const TradeEvent& trade) {
+    auto price = trade.price.micros();
+    if (bar.trade_count == 0) {
+        bar.open = bar.high = bar.low = price;
+    }
+    bar.high = std::max(bar.high, price);
+    bar.low = std::min(bar.low, price);
+    bar.close = price;
+    bar.volume += trade.size.units();
+    if (trade.side == Side::BUY) bar.buy_volume += trade.size.units();
+    ++bar.trade_count;
+}
+
+} // namespace
+
+void validate(const BarOptions& options) {
+    if (options.intervals_ms.empty()) {
+        throw std::invalid_argument("Bars need at least one interval");
+    }
+    for (size_t i = 0; i < options.intervals_ms.size(); ++i) {
+        if (options.intervals_ms[i] <= 0) {
+            throw std::invalid_argument("Bar intervals must be positive");
+        }
+        if (std::count(options.intervals_ms.begin(), options.intervals_ms.begin() + i, options.intervals_ms[i])) {
+            throw std::invalid_argument("Bar intervals must be distinct");
+        }
+    }
+    if (options.grace_ms < 0) {
+        throw std::invalid_argument("Bar grace must be non-negative");
+    }
+}
+
+std::optional<std::vector<int64_t>> parse_bar_intervals(std::string_view text) {
+    std::vector<int64_t> intervals;
+    while (true) {
+        auto comma = text.find(',');
+        auto item = text.substr(0, comma);
+        while (!item.empty() && item.front() == ' ') item.remove_prefix(1);
+        while (!item.empty() && item.back() == ' ') item.remove_suffix(1);
+
+        int64_t count = 0;
+        auto [end, error] = std::from_chars(item.data(), item.data() + item.size(), count);
+        if (error != std::errc{} || count <= 0) return std::nullopt;
+        std::string_view unit(end, static_cast<size_t>(item.data() + item.size() - end));
+        int64_t scale = 0;
+        if (unit == "ms") scale = 1;
+        else if (unit == "s") scale = 1000;
+        else if (unit == "m") scale = 60'000;
+        else if (unit == "h") scale = 3'600'000;
+        else return std::nullopt;
+        intervals.push_back(count * scale);
+
+        if (comma == std::string_view::npos) return intervals;
+        text.remove_prefix(comma + 1);
+    }
+}
+
+BarBuilder::BarBuilder(BarOptions options) : options_(std::move(options)) {
+    validate(options_);
+}
+
+BarBuilder::AssetBars& BarBuilder::bars_for(const MarketAsset& asset) {
+    auto it = assets_.find(asset);
+    if (it == assets_.end()) {
+        it = assets_.try_emplace(asset).first;
+        it->second.slots.resize(options_.intervals_ms.size());
+    }
+    return it->second;
+}
+
+void BarBuilder::close(Slot& slot, std::vector<Bar>& closed) {
+    slot.closed_until = slot.bar->end_ms();
+    closed.push_back(std::move(*slot.bar));
+    slot.bar.reset();
+}
+
+void BarBuilder::apply(const OrderBookEventVariant& event, std::vector<Bar>& closed) {
+    std::visit([&](const auto& e) {
+        using T = std::decay_t<decltype(e)>;
+        auto& bars = bars_for(e.asset);
+        auto ts = e.timestamp.milliseconds();
+
+        for (size_t i = 0; i < bars.slots.size(); ++i) {
+            auto& slot = bars.slots[i];
+            auto interval = options_.intervals_ms[i];
+            auto start = std::max(ts - ts % interval, slot.closed_until);
+            if (slot.bar && start >= slot.bar->end_ms()) close(slot, closed);
+            if (!slot.bar) {
+                slot.bar.emplace(Bar{e.asset, interval, start});
+                if (bars.quote.two_sided()) add_quote(*slot.bar, bars.quote.bid, bars.quote.ask);
+            }
+        }
+
+        if constexpr (std::is_same_v<T, TradeEvent>) {
+            for (auto& slot : bars.slots) add_trade(*slot.bar, e);
+        } else if constexpr (std::is_same_v<T, BookSnapshot> || std::is_same_v<T, BookDelta>) {
+            if constexpr (std::is_same_v<T, BookSnapshot>) {
+                bars.quote = {};
+                for (const auto& level : e.bids) bars.quote.bid = std::max(bars.quote.bid, level.price().micros());
+                for (const auto& level : e.asks) {
+                    auto price = level.price().micros();
+                    if (bars.quote.ask == 0 || price < bars.quote.ask) bars.quote.ask = price;
+                }
+            } else {
+                if (e.changes.empty()) return;
+                bars.quote = {e.changes.back().best_bid.micros(), e.changes.back().best_ask.micros()};
+            }
+            for (auto& slot : bars.slots) {
+                ++slot.bar->quote_updates;
+                if (bars.quote.two_sided()) add_quote(*slot.bar, bars.quote.bid, bars.quote.ask);
+            }
+        }
+    }, event);
+}
+
+void BarBuilder::close_until(int64_t now_ms, std::vector<Bar>& closed) {
+    for (auto& [asset, bars] : assets_) {
+        for (auto& slot : bars.slots) {
+            if (slot.bar && slot.bar->end_ms() + options_.grace_ms <= now_ms) close(slot, closed);
+        }
+    }
+}
+
+void BarBuilder::close_all(std::vector<Bar>& closed) {
+    for (auto& [asset, bars] : assets_) {
+        for (auto& slot : bars.slots) {
+            if (slot.bar) close(slot, closed);
+        }
+    }
+}
+
+size_t BarBuilder::open_bars() const noexcept {
+    size_t open = 0;
+    for (const auto& [asset, bars] : assets_) {
+        for (const auto& slot : bars.slots) open += slot.bar.has_value();
+    }
+    return open;
+}
+
+} // namespace mde::services::analytics
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+#include "domain/value_objects/Bar.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mde::services::analytics {
+
+struct BarOptions {
+    // Every asset gets a bar of each interval, aligned to the epoch
+    std::vector<int64_t> intervals_ms{1000, 60000};
+    // A quiet asset's bar is closed this long after its end, so events
+    // that arrive a little late still land in it
+    int64_t grace_ms = 2000;
+};
+
+// Throws std::invalid_argument for no intervals, a non-positive or
+// repeated one, or a negative grace
+void validate(const BarOptions& options);
+
+// Intervals as written in settings: "1s,1m", "500ms", "5m,1h". Nullopt for
+// an empty list, a unit other than ms/s/m/h or a count that is not positive.
+std::optional<std::vector<int64_t>> parse_bar_intervals(std::string_view text);
+
+// Incremental OHLCV and top-of-book bars per asset, built from the event
+// stream in event-time buckets. A bar closes when its asset's next event
+// falls in a later bucket, or through close_until() once its end is
+// grace_ms behind the wall clock; bars without events are not emitted.
+// An event older than its asset's open bar (or than the last one closed)
+// counts toward the earliest bar still open rather than reopening one.
+//
+// The quote comes from snapshots (best of each side) and deltas (the
+// exchange's best_bid/best_ask on the change). Not thread-safe.
+class BarBuilder {
+public:
+    explicit BarBuilder(BarOptions options = {});
+
+    // Closed bars are appended to `closed`
+    void apply(const mde::domain::OrderBookEventVariant& event, std::vector<mde::domain::Bar>& closed);
+    void close_until(int64_t now_ms, std::vector<mde::domain::Bar>& closed);
+    void close_all(std::vector<mde::domain::Bar>& closed);
+
+    const BarOptions& options() const noexcept { return options_; }
+    size_t open_bars() const noexcept;
+
+private:
+    struct Quote {
+        int64_t bid{0};
+        int64_t ask{0};
+        bool two_sided() const noexcept { return bid > 0 && ask > 0; }
+    };
+
+    // Per interval, in options order
+    struct Slot {
+        std::optional<mde::domain::Bar> bar;
+        int64_t closed_until{0};  // end of the last bar closed
+    };
+
+    struct AssetBars {
+        Quote quote;
+        std::vector<Slot> slots;
+    };
+
+    AssetBars& bars_for(const mde::domain::MarketAsset& asset);
+    static void close(Slot& slot, std::vector<mde::domain::Bar>& closed);
+
+    BarOptions options_;
+    std::unordered_map<mde::domain::MarketAsset, AssetBars> assets_;
+};
+
+} // namespace mde::services::analytics
@@ -0,0 +1,89 @@
+#include "services/analytics/BarService.hpp"
+
+#include "services/SpscQueue.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace mde::services::analytics {
+
+using namespace mde::domain;
+
+namespace {
+
+int64_t wall_clock_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+BarService::BarService(EventStream& events, Sink sink, BarOptions options, std::chrono::milliseconds flush_interval)
+    : sink_(std::move(sink))
+    , flush_interval_(flush_interval)
+    , subscription_(events.subscribe())
+    , builder_(std::move(options)) {
+    if (!sink_) throw std::invalid_argument("Bars need a sink");
+    if (flush_interval_.count() <= 0) throw std::invalid_argument("Bar flush interval must be positive");
+}
+
+BarService::~BarService() {
+    stop();
+}
+
+void BarService::start() {
+    if (running_.exchange(true)) return;
+    worker_ = std::thread([this] { run(); });
+}
+
+void BarService::stop() {
+    if (running_.exchange(false)) {
+        if (worker_.joinable()) worker_.join();
+    }
+    if (drained_) return;
+    drained_ = true;
+    poll();
+    builder_.close_all(closed_);
+    hand_over();
+}
+
+void BarService::run() {
+    Backoff backoff;
+    auto next_flush = std::chrono::steady_clock::now() + flush_interval_;
+    while (running_.load(std::memory_order_acquire)) {
+        if (poll() > 0) {
+            backoff.reset();
+        } else {
+            backoff.pause();
+        }
+        if (std::chrono::steady_clock::now() >= next_flush) {
+            flush(wall_clock_ms());
+            next_flush = std::chrono::steady_clock::now() + flush_interval_;
+        }
+    }
+}
+
+size_t BarService::poll() {
+    size_t applied = subscription_.poll([this](const OrderBookEventVariant& event) { builder_.apply(event, closed_); });
+    if (applied > 0) {
+        processed_.fetch_add(applied, std::memory_order_relaxed);
+        dropped_.store(subscription_.dropped(), std::memory_order_relaxed);
+    }
+    return applied;
+}
+
+size_t BarService::flush(int64_t now_ms) {
+    builder_.close_until(now_ms, closed_);
+    return hand_over();
+}
+
+size_t BarService::hand_over() {
+    auto count = closed_.size();
+    if (count == 0) return 0;
+    sink_(closed_);
+    closed_.clear();
+    written_.fetch_add(count, std::memory_order_relaxed);
+    return count;
+}
+
+} // namespace mde::services::analytics
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+#include "domain/value_objects/Bar.hpp"
+#include "services/EventBus.hpp"
+#include "services/analytics/BarBuilder.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace mde::services::analytics {
+
+// Time bars over the service's event stream (OrderBookService::events()),
+// built on a thread of its own like AnalyticsService and handed to a sink
+// in batches: every flush_interval, closed bars plus those whose end is
+// grace_ms behind the wall clock. stop() closes and hands over the rest.
+// Events lost to a full ring (events_dropped()) are missing from the bars.
+//
+// Either start() the worker, or call poll() and flush() from one thread;
+// not both. The sink runs on that thread. The counters may be read from
+// any thread.
+class BarService {
+public:
+    using EventStream = EventBus<mde::domain::OrderBookEventVariant>;
+    using Sink = std::function<void(const std::vector<mde::domain::Bar>&)>;
+
+    // Subscribes at once: events published from here on are counted
+    BarService(EventStream& events, Sink sink, BarOptions options = {},
+               std::chrono::milliseconds flush_interval = std::chrono::seconds(60));
+    ~BarService();
+
+    BarService(const BarService&) = delete;
+    BarService& operator=(const BarService&) = delete;
+
+    void start();
+    // Joins the worker after it has applied what was already published,
+    // then hands every open bar to the sink
+    void stop();
+
+    // Apply every event published so far; returns how many were applied
+    size_t poll();
+    // Close the bars finished by `now_ms` and hand every closed bar to the
+    // sink; returns how many
+    size_t flush(int64_t now_ms);
+
+    uint64_t events_processed() const noexcept { return processed_.load(std::memory_order_relaxed); }
+    uint64_t events_dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t bars_written() const noexcept { return written_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    size_t hand_over();
+
+    Sink sink_;
+    std::chrono::milliseconds flush_interval_;
+    EventStream::Subscription subscription_;
+    BarBuilder builder_;
+    std::vector<mde::domain::Bar> closed_;  // waiting for the next flush
+
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<bool> running_{false};
+    bool drained_{false};  // stop() already handed over the open bars
+    std::thread worker_;
+};
+
+} // namespace mde::services::analytics
@@ -0,0 +1,128 @@
+#include "services/analytics/MarketMetrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+namespace mde::services::analytics {
+
+using namespace mde::domain;
+
+namespace {
+
+// (a - b) / (a + b), empty when both are zero
+std::optional<double> imbalance_of(int64_t a, int64_t b) {
+    if (a + b == 0) return std::nullopt;
+    return static_cast<double>(a - b) / static_cast<double>(a + b);
+}
+
+} // anonymous namespace
+
+void validate(const AnalyticsOptions& options) {
+    if (options.vwap_trades == 0 || options.volatility_returns == 0) {
+        throw std::invalid_argument("Analytics windows must hold at least one value");
+    }
+    if (!(options.ewma_lambda > 0.0 && options.ewma_lambda < 1.0)) {
+        throw std::invalid_argument("EWMA lambda must be in (0, 1)");
+    }
+    if (options.depth_ticks < 0) {
+        throw std::invalid_argument("Depth ticks must be non-negative");
+    }
+    if (!(options.sweep_size >= 0.0)) {
+        throw std::invalid_argument("Sweep size must be non-negative");
+    }
+}
+
+MarketMetrics::MarketMetrics(MarketAsset asset, const AnalyticsOptions& options)
+    : book_(OrderBook::empty(std::move(asset)))
+    , depth_ticks_(options.depth_ticks)
+    , sweep_size_(options.sweep_size)
+    , ewma_lambda_(options.ewma_lambda)
+    , trades_(options.vwap_trades)
+    , squared_returns_(options.volatility_returns) {}
+
+void MarketMetrics::apply(const OrderBookEventVariant& event) {
+    book_.apply_in_place(event);
+    if (const auto* trade = std::get_if<TradeEvent>(&event)) {
+        on_trade(*trade);
+    } else {
+        on_book_changed();
+    }
+}
+
+void MarketMetrics::on_trade(const TradeEvent& trade) {
+    TradeSample sample{trade.price.micros() * trade.size.units() / kFixedPointScale, trade.size.units()};
+    if (auto evicted = trades_.push(sample)) {
+        notional_sum_ -= evicted->notional;
+        units_sum_ -= evicted->units;
+    }
+    notional_sum_ += sample.notional;
+    units_sum_ += sample.units;
+    ++trade_count_;
+}
+
+void MarketMetrics::on_book_changed() {
+    auto mid = book_.midpoint();
+    if (!mid || mid->micros() <= 0 || mid == last_midpoint_) return;
+    if (!last_midpoint_) {
+        last_midpoint_ = mid;
+        return;
+    }
+
+    double r = std::log(static_cast<double>(mid->micros()) / static_cast<double>(last_midpoint_->micros()));
+    double r2 = r * r;
+    last_midpoint_ = mid;
+    ++return_count_;
+
+    ewma_variance_ = ewma_variance_ ? ewma_lambda_ * *ewma_variance_ + (1.0 - ewma_lambda_) * r2 : r2;
+
+    if (auto evicted = squared_returns_.push(r2)) squared_sum_ -= *evicted;
+    squared_sum_ += r2;
+    if (++pushes_since_resum_ == squared_returns_.capacity()) {
+        squared_sum_ = 0.0;
+        for (size_t i = 0; i < squared_returns_.size(); ++i) squared_sum_ += squared_returns_[i];
+        pushes_since_resum_ = 0;
+    }
+}
+
+MetricsSnapshot MarketMetrics::snapshot() const {
+    MetricsSnapshot s{book_.get_asset()};
+    s.last_sequence_number = book_.get_last_sequence_number();
+    s.timestamp = book_.get_timestamp();
+
+    s.trades = trade_count_;
+    if (units_sum_ > 0) {
+        s.vwap = Price::from_micros(std::llround(
+            static_cast<double>(notional_sum_) * kFixedPointScale / static_cast<double>(units_sum_)));
+    }
+
+    const auto& top = book_.top();
+    s.midpoint = book_.midpoint();
+    s.microprice = book_.weighted_midpoint();
+    if (top.bid && top.ask) {
+        s.imbalance = imbalance_of(top.bid->size().units(), top.ask->size().units());
+        s.depth_imbalance = imbalance_of(book_.get_depth_within(Side::BUY, depth_ticks_).units(),
+                                         book_.get_depth_within(Side::SELL, depth_ticks_).units());
+    }
+
+    if (!sweep_size_.is_zero()) {
+        auto fill_price = [&](Side side) -> std::optional<Price> {
+            auto sweep = book_.get_sweep(side, sweep_size_);
+            if (sweep.filled != sweep_size_) return std::nullopt;
+            return sweep.average_price;
+        };
+        s.buy_sweep_price = fill_price(Side::SELL);
+        s.sell_sweep_price = fill_price(Side::BUY);
+    }
+
+    s.returns = return_count_;
+    if (!squared_returns_.empty()) {
+        s.realized_volatility = std::sqrt(std::max(squared_sum_, 0.0) / static_cast<double>(squared_returns_.size()));
+    }
+    if (ewma_variance_) s.ewma_volatility = std::sqrt(*ewma_variance_);
+    return s;
+}
+
+} // namespace mde::services::analytics
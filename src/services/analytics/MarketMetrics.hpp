@@ -0,0 +1,102 @@
+#pragma once
+
+#include "domain/aggregates/OrderBook.hpp"
+#include "services/analytics/RingBuffer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace mde::services::analytics {
+
+struct AnalyticsOptions {
+    // Trades in the rolling VWAP window
+    size_t vwap_trades = 100;
+    // Midpoint log returns in the realized volatility window
+    size_t volatility_returns = 100;
+    // Decay of the EWMA variance, per return (RiskMetrics uses 0.94)
+    double ewma_lambda = 0.94;
+    // Levels within this many ticks of the best count toward depth imbalance
+    int depth_ticks = 5;
+    // Shares of the market order the sweep prices fill (0 = none)
+    double sweep_size = 100.0;
+};
+
+// Throws std::invalid_argument for empty windows, a lambda outside (0, 1),
+// negative depth_ticks or a negative sweep_size
+void validate(const AnalyticsOptions& options);
+
+// One asset's metrics as of its last applied event. Volatilities are per
+// midpoint change (not annualized): root mean square of the windowed log
+// returns, and the square root of their exponentially weighted variance.
+struct MetricsSnapshot {
+    mde::domain::MarketAsset asset;
+    uint64_t last_sequence_number{0};
+    mde::domain::Timestamp timestamp{0};
+
+    uint64_t trades{0};
+    std::optional<mde::domain::Price> vwap{};
+    std::optional<mde::domain::Price> midpoint{};
+    std::optional<mde::domain::Price> microprice{};
+    // (bid - ask) / (bid + ask) of the best levels' sizes, in [-1, 1]
+    std::optional<double> imbalance{};
+    // The same over the levels within depth_ticks of each best price
+    std::optional<double> depth_imbalance{};
+    // Average price a market order of sweep_size shares would pay buying
+    // (taking the asks) and selling (taking the bids); empty when that side
+    // cannot fill it
+    std::optional<mde::domain::Price> buy_sweep_price{};
+    std::optional<mde::domain::Price> sell_sweep_price{};
+
+    uint64_t returns{0};
+    std::optional<double> realized_volatility{};
+    std::optional<double> ewma_volatility{};
+};
+
+// Streaming metrics for one asset, fed the asset's events in sequence
+// order. Keeps its own copy of the book and updates every statistic in
+// constant time per event: the VWAP and volatility windows are ring
+// buffers with running sums, and the top-of-book signals read the book's
+// cached best levels. Nothing is allocated per event once the book's
+// levels have grown to size.
+class MarketMetrics {
+public:
+    // `options` must pass validate()
+    MarketMetrics(mde::domain::MarketAsset asset, const AnalyticsOptions& options);
+
+    void apply(const mde::domain::OrderBookEventVariant& event);
+
+    MetricsSnapshot snapshot() const;
+    const mde::domain::OrderBook& book() const noexcept { return book_; }
+
+private:
+    struct TradeSample {
+        int64_t notional;  // micro-dollars
+        int64_t units;
+    };
+
+    void on_trade(const mde::domain::TradeEvent& trade);
+    void on_book_changed();
+
+    mde::domain::OrderBook book_;
+    int depth_ticks_;
+    mde::domain::Quantity sweep_size_;
+    double ewma_lambda_;
+
+    // Exact integer sums over the VWAP window
+    RingBuffer<TradeSample> trades_;
+    int64_t notional_sum_{0};
+    int64_t units_sum_{0};
+    uint64_t trade_count_{0};
+
+    // Squared log returns of the midpoint. The running sum is rebuilt from
+    // the window once per lap so floating-point drift can't accumulate.
+    RingBuffer<double> squared_returns_;
+    double squared_sum_{0.0};
+    size_t pushes_since_resum_{0};
+    std::optional<double> ewma_variance_;
+    uint64_t return_count_{0};
+    std::optional<mde::domain::Price> last_midpoint_;
+};
+
+} // namespace mde::services::analytics
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace mde::services::analytics {
+
+// Fixed-capacity FIFO window. Storage is allocated once, up front; pushing
+// onto a full buffer overwrites the oldest value and hands it back, so
+// rolling sums can subtract what leaves the window.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity) : items_(capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("RingBuffer capacity must be positive");
+        }
+    }
+
+    // Append, returning the value evicted to make room, if any
+    std::optional<T> push(T value) {
+        if (size_ < items_.size()) {
+            items_[(head_ + size_) % items_.size()] = std::move(value);
+            ++size_;
+            return std::nullopt;
+        }
+        T evicted = std::exchange(items_[head_], std::move(value));
+        head_ = (head_ + 1) % items_.size();
+        return evicted;
+    }
+
+    void clear() noexcept {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return items_.size(); }
+    bool empty() const noexcept { return size_ == 0; }
+    bool full() const noexcept { return size_ == items_.size(); }
+
+    // i-th oldest value held; i < size()
+    const T& operator[](size_t i) const { return items_[(head_ + i) % items_.size()]; }
+
+private:
+    std::vector<T> items_;
+    size_t head_{0};  // index of the oldest value
+    size_t size_{0};
+};
+
+} // namespace mde::services::analytics
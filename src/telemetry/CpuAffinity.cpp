@@ -0,0 +1,80 @@
+#include "telemetry/CpuAffinity.hpp"
+
+#include <charconv>
+#include <iostream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace mde::telemetry {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+std::optional<int> parse_cpu(std::string_view text) {
+    text = trim(text);
+    int cpu = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), cpu);
+    if (text.empty() || error != std::errc{} || end != text.data() + text.size() || cpu < 0) return std::nullopt;
+    return cpu;
+}
+
+void report(std::string_view role, std::string_view cpu_list, const char* problem) {
+    std::cerr << "[affinity] Not pinning " << role << " to \"" << cpu_list << "\": " << problem << std::endl;
+}
+
+} // namespace
+
+std::optional<std::vector<int>> parse_cpu_list(std::string_view text) {
+    std::vector<int> cpus;
+    if (trim(text).empty()) return cpus;
+    while (true) {
+        auto comma = text.find(',');
+        auto item = text.substr(0, comma);
+        auto dash = item.find('-');
+        auto first = parse_cpu(item.substr(0, dash));
+        auto last = dash == std::string_view::npos ? first : parse_cpu(item.substr(dash + 1));
+        if (!first || !last || *last < *first) return std::nullopt;
+        for (int cpu = *first; cpu <= *last; ++cpu) cpus.push_back(cpu);
+        if (comma == std::string_view::npos) return cpus;
+        text.remove_prefix(comma + 1);
+    }
+}
+
+bool pin_current_thread(std::span<const int> cpus) {
+    if (cpus.empty()) return true;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= CPU_SETSIZE) return false;
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+void pin_current_thread(std::string_view cpu_list, std::string_view role) {
+    auto cpus = parse_cpu_list(cpu_list);
+    if (!cpus) return report(role, cpu_list, "not a cpulist");
+    if (!pin_current_thread(*cpus)) report(role, cpu_list, "refused");
+}
+
+void pin_current_thread(std::string_view cpu_list, std::string_view role, size_t index) {
+    auto cpus = parse_cpu_list(cpu_list);
+    if (!cpus) return report(role, cpu_list, "not a cpulist");
+    if (cpus->empty()) return;
+    int cpu = (*cpus)[index % cpus->size()];
+    if (!pin_current_thread(std::span(&cpu, 1))) report(role, cpu_list, "refused");
+}
+
+} // namespace mde::telemetry
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace mde::telemetry {
+
+// The CPUs of a kernel-style cpulist ("2", "4-7", "0,2,8-11"), in the order
+// written; nullopt if it is malformed. Blank is the empty list.
+std::optional<std::vector<int>> parse_cpu_list(std::string_view text);
+
+// Restricts the calling thread to `cpus`; an empty list leaves it alone.
+// False where the platform has no affinity control or the kernel refuses,
+// e.g. for a CPU outside the process's cpuset.
+bool pin_current_thread(std::span<const int> cpus);
+
+// Pins the calling thread to the CPUs of a cpulist setting, or to the
+// index-th of them (wrapping) when one thread of several is asked for. A
+// malformed list or a refused pin is reported on stderr under `role`, and
+// the thread keeps running wherever the scheduler puts it.
+void pin_current_thread(std::string_view cpu_list, std::string_view role);
+void pin_current_thread(std::string_view cpu_list, std::string_view role, size_t index);
+
+} // namespace mde::telemetry
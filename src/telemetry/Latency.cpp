@@ -0,0 +1,80 @@
+#include "telemetry/Latency.hpp"
+
+#include <algorithm>
+
+namespace mde::telemetry {
+
+namespace {
+
+std::atomic<uint64_t> next_registry_id{1};
+
+struct CachedLookup {
+    uint64_t registry{0};
+    void* histograms{nullptr};
+};
+
+thread_local CachedLookup cached;
+
+} // anonymous namespace
+
+std::string_view stage_name(Stage stage) {
+    switch (stage) {
+        case Stage::parse: return "parse";
+        case Stage::end_to_end: return "end_to_end";
+        case Stage::apply: return "apply";
+        case Stage::append: return "append";
+        case Stage::flush: return "flush";
+    }
+    return "unknown";
+}
+
+LatencySummary LatencySummary::of(const HistogramSnapshot& ticks) {
+    LatencySummary s;
+    s.count = ticks.count();
+    if (s.count == 0) return s;
+    s.p50_ns = ticks_to_ns(ticks.value_at(0.50));
+    s.p99_ns = ticks_to_ns(ticks.value_at(0.99));
+    s.p999_ns = ticks_to_ns(ticks.value_at(0.999));
+    s.max_ns = ticks_to_ns(ticks.max());
+    return s;
+}
+
+LatencyRegistry::LatencyRegistry() : id_(next_registry_id.fetch_add(1)) {}
+
+LatencyRegistry::~LatencyRegistry() = default;
+
+LatencyRegistry& LatencyRegistry::global() {
+    static LatencyRegistry registry;
+    return registry;
+}
+
+LatencyRegistry::ThreadHistograms& LatencyRegistry::local() {
+    if (cached.registry != id_) {
+        cached.histograms = &register_thread();
+        cached.registry = id_;
+    }
+    return *static_cast<ThreadHistograms*>(cached.histograms);
+}
+
+LatencyRegistry::ThreadHistograms& LatencyRegistry::register_thread() {
+    auto self = std::this_thread::get_id();
+    std::lock_guard lock(mutex_);
+    // A thread alternating between registries finds its earlier set again
+    auto it = std::find_if(threads_.begin(), threads_.end(),
+                           [&](const auto& t) { return t->owner == self; });
+    if (it != threads_.end()) return **it;
+    threads_.push_back(std::make_unique<ThreadHistograms>());
+    threads_.back()->owner = self;
+    return *threads_.back();
+}
+
+HistogramSnapshot LatencyRegistry::snapshot(Stage stage) const {
+    HistogramSnapshot merged;
+    std::lock_guard lock(mutex_);
+    for (const auto& thread : threads_) {
+        thread->histograms[static_cast<size_t>(stage)].snapshot(merged);
+    }
+    return merged;
+}
+
+} // namespace mde::telemetry
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "telemetry/LatencyHistogram.hpp"
+#include "telemetry/Tsc.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace mde::telemetry {
+
+// Hot-path stages, each timed where it runs:
+//   parse:      websocket receive -> message parsed (with a parse queue,
+//               includes the wait in it)
+//   end_to_end: websocket receive -> the service has taken every event of
+//               the message (inline: applied and appended; with shards:
+//               queued to them)
+//   apply:      book lock + applying an event or a run of them
+//   append:     one repository append (its lock, buffering, the log write)
+//   flush:      writing one Parquet file (local disk or S3)
+enum class Stage : uint8_t { parse, end_to_end, apply, append, flush };
+
+inline constexpr std::array<Stage, 5> kStages = {
+    Stage::parse, Stage::end_to_end, Stage::apply, Stage::append, Stage::flush,
+};
+
+std::string_view stage_name(Stage stage);
+
+// Percentiles of a histogram, in nanoseconds
+struct LatencySummary {
+    uint64_t count{0};
+    double p50_ns{0};
+    double p99_ns{0};
+    double p999_ns{0};
+    double max_ns{0};
+
+    static LatencySummary of(const HistogramSnapshot& ticks);
+};
+
+// Per-thread, per-stage TSC-tick histograms. A thread's first record()
+// registers its histograms under a mutex; from then on recording is a
+// thread-local lookup and one relaxed counter update, and no two threads
+// ever write the same histogram. Readers merge every thread's histograms.
+// Histograms of exited threads are kept, so nothing recorded is lost.
+class LatencyRegistry {
+public:
+    LatencyRegistry();
+    ~LatencyRegistry();
+
+    LatencyRegistry(const LatencyRegistry&) = delete;
+    LatencyRegistry& operator=(const LatencyRegistry&) = delete;
+
+    // The one the engine's components record into
+    static LatencyRegistry& global();
+
+    void record(Stage stage, uint64_t ticks) {
+        local().histograms[static_cast<size_t>(stage)].record(ticks);
+    }
+    // For durations already measured with another clock
+    void record(Stage stage, std::chrono::nanoseconds duration) {
+        record(stage, ns_to_ticks(duration));
+    }
+
+    // Ticks recorded for `stage`, merged across threads
+    HistogramSnapshot snapshot(Stage stage) const;
+
+private:
+    struct ThreadHistograms {
+        std::thread::id owner;
+        std::array<LatencyHistogram, kStages.size()> histograms;
+    };
+
+    ThreadHistograms& local();
+    ThreadHistograms& register_thread();
+
+    const uint64_t id_;  // tells a thread's cached lookup which registry it is for
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadHistograms>> threads_;
+};
+
+// Shorthands for LatencyRegistry::global()
+inline void record_latency(Stage stage, uint64_t ticks) {
+    LatencyRegistry::global().record(stage, ticks);
+}
+
+// Records the ticks elapsed since `start` and returns the current tick, so
+// consecutive stages can chain: t = record_since(Stage::apply, t);
+inline uint64_t record_since(Stage stage, uint64_t start) {
+    auto now = tsc_now();
+    record_latency(stage, now - start);
+    return now;
+}
+
+} // namespace mde::telemetry
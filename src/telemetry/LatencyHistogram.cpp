@@ -0,0 +1,41 @@
+#include "telemetry/LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mde::telemetry {
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    for (size_t i = 0; i < counts_.size(); ++i) counts_[i] += other.counts_[i];
+    total_ += other.total_;
+}
+
+HistogramSnapshot HistogramSnapshot::since(const HistogramSnapshot& earlier) const {
+    HistogramSnapshot delta;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        // Counts only grow; guard anyway against a snapshot of other histograms
+        if (counts_[i] > earlier.counts_[i]) delta.add(i, counts_[i] - earlier.counts_[i]);
+    }
+    return delta;
+}
+
+uint64_t HistogramSnapshot::value_at(double quantile) const {
+    if (total_ == 0) return 0;
+    quantile = std::clamp(quantile, 0.0, 1.0);
+    auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(total_))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) return HistogramLayout::upper_bound(i);
+    }
+    return HistogramLayout::upper_bound(counts_.size() - 1);
+}
+
+void LatencyHistogram::snapshot(HistogramSnapshot& into) const {
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        auto count = counts_[i].load(std::memory_order_relaxed);
+        if (count > 0) into.add(i, count);
+    }
+}
+
+} // namespace mde::telemetry
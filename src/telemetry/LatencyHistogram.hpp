@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mde::telemetry {
+
+// Bucket layout shared by the histogram and its snapshots, HDR-style:
+// values below 2^kSubBucketBits get a bucket each; above that each power of
+// two is split into 2^kSubBucketBits linear sub-buckets, so a bucket is
+// never wider than 1/64 of its values (about 1.6%). Values of 2^kMaxBits
+// and above share the last bucket.
+struct HistogramLayout {
+    static constexpr int kSubBucketBits = 6;
+    static constexpr int kMaxBits = 42;
+    static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+    static constexpr size_t kBucketCount = (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+    static constexpr size_t index_of(uint64_t value) noexcept {
+        if (value < kSubBuckets) return static_cast<size_t>(value);
+        int msb = std::bit_width(value) - 1;
+        if (msb >= kMaxBits) return kBucketCount - 1;
+        int shift = msb - kSubBucketBits;
+        return static_cast<size_t>(shift + 1) * kSubBuckets + ((value >> shift) - kSubBuckets);
+    }
+
+    // Largest value that lands in bucket i
+    static constexpr uint64_t upper_bound(size_t i) noexcept {
+        if (i < kSubBuckets) return i;
+        auto shift = static_cast<int>(i / kSubBuckets) - 1;
+        auto sub = kSubBuckets + i % kSubBuckets;
+        return ((sub + 1) << shift) - 1;
+    }
+};
+
+// Counts copied out of one or more histograms
+class HistogramSnapshot {
+public:
+    HistogramSnapshot() : counts_(HistogramLayout::kBucketCount, 0) {}
+
+    void add(size_t bucket, uint64_t count) {
+        counts_[bucket] += count;
+        total_ += count;
+    }
+    void merge(const HistogramSnapshot& other);
+    // What was recorded after `earlier`, an older snapshot of the same histograms
+    HistogramSnapshot since(const HistogramSnapshot& earlier) const;
+
+    uint64_t count() const noexcept { return total_; }
+    // Smallest bucket bound that at least `quantile` (0..1) of the values
+    // are at or below; 0 when empty
+    uint64_t value_at(double quantile) const;
+    uint64_t max() const { return value_at(1.0); }
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t total_{0};
+};
+
+// Fixed-size log-linear histogram with a single writer. record() is a
+// relaxed load and store of one counter (no read-modify-write, no lock);
+// snapshot() may run on any thread and sees a slightly stale but never torn
+// count per bucket.
+class LatencyHistogram {
+public:
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t value) noexcept {
+        auto& bucket = counts_[HistogramLayout::index_of(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Adds this histogram's counts to `into`
+    void snapshot(HistogramSnapshot& into) const;
+
+private:
+    std::array<std::atomic<uint64_t>, HistogramLayout::kBucketCount> counts_{};
+};
+
+} // namespace mde::telemetry
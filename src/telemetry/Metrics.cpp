@@ -0,0 +1,218 @@
+#include "telemetry/Metrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace mde::telemetry {
+
+struct MetricsRegistry::Series {
+    Labels labels;
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<Gauge> gauge;
+    std::function<double()> read;
+    uint64_t sample_id{0};
+};
+
+struct MetricsRegistry::Family {
+    std::string name;
+    std::string help;
+    MetricType type;
+    std::vector<std::unique_ptr<Series>> series;
+
+    Series* find(const Labels& labels) {
+        for (auto& s : series) {
+            if (!s->read && s->labels == labels) return s.get();
+        }
+        return nullptr;
+    }
+};
+
+namespace {
+
+void append_escaped(std::string& out, const std::string& value, bool label) {
+    for (char c : value) {
+        if (c == '\\') {
+            out += "\\\\";
+        } else if (c == '\n') {
+            out += "\\n";
+        } else if (label && c == '"') {
+            out += "\\\"";
+        } else {
+            out += c;
+        }
+    }
+}
+
+void append_series_name(std::string& out, const std::string& name, const Labels& labels,
+                        const std::pair<std::string, std::string>* extra = nullptr) {
+    out += name;
+    if (labels.empty() && !extra) return;
+    out += '{';
+    bool first = true;
+    auto append_label = [&](const std::pair<std::string, std::string>& label) {
+        if (!first) out += ',';
+        first = false;
+        out += label.first;
+        out += "=\"";
+        append_escaped(out, label.second, true);
+        out += '"';
+    };
+    for (const auto& label : labels) append_label(label);
+    if (extra) append_label(*extra);
+    out += '}';
+}
+
+void append_value(std::string& out, double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.12g", value);
+    out += buffer;
+}
+
+void append_header(std::string& out, const std::string& name, const std::string& help, const char* type) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    append_escaped(out, help, false);
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+} // anonymous namespace
+
+MetricsRegistry::SampleHandle& MetricsRegistry::SampleHandle::operator=(SampleHandle&& other) noexcept {
+    if (this != &other) {
+        if (registry_) registry_->remove_sample(id_);
+        registry_ = std::exchange(other.registry_, nullptr);
+        id_ = other.id_;
+    }
+    return *this;
+}
+
+MetricsRegistry::SampleHandle::~SampleHandle() {
+    if (registry_) registry_->remove_sample(id_);
+}
+
+MetricsRegistry::MetricsRegistry() = default;
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help,
+                                                 MetricType type) {
+    for (auto& f : families_) {
+        if (f->name != name) continue;
+        if (f->type != type) {
+            throw std::invalid_argument("Metric " + name + " is already registered with another type");
+        }
+        return *f;
+    }
+    families_.push_back(std::make_unique<Family>(Family{name, help, type, {}}));
+    return *families_.back();
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard lock(mutex_);
+    auto& f = family(name, help, MetricType::counter);
+    if (auto* existing = f.find(labels)) return *existing->counter;
+    f.series.push_back(std::make_unique<Series>());
+    f.series.back()->labels = labels;
+    f.series.back()->counter = std::make_unique<Counter>();
+    return *f.series.back()->counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard lock(mutex_);
+    auto& f = family(name, help, MetricType::gauge);
+    if (auto* existing = f.find(labels)) return *existing->gauge;
+    f.series.push_back(std::make_unique<Series>());
+    f.series.back()->labels = labels;
+    f.series.back()->gauge = std::make_unique<Gauge>();
+    return *f.series.back()->gauge;
+}
+
+MetricsRegistry::SampleHandle MetricsRegistry::sample(MetricType type, const std::string& name,
+                                                      const std::string& help, const Labels& labels,
+                                                      std::function<double()> read) {
+    std::lock_guard lock(mutex_);
+    auto& f = family(name, help, type);
+    auto series = std::make_unique<Series>();
+    series->labels = labels;
+    series->read = std::move(read);
+    series->sample_id = next_sample_id_++;
+    auto id = series->sample_id;
+    f.series.push_back(std::move(series));
+    return SampleHandle(this, id);
+}
+
+void MetricsRegistry::remove_sample(uint64_t id) {
+    std::lock_guard lock(mutex_);
+    for (auto& f : families_) {
+        auto it = std::find_if(f->series.begin(), f->series.end(),
+                               [&](const auto& s) { return s->sample_id == id; });
+        if (it != f->series.end()) {
+            f->series.erase(it);
+            return;
+        }
+    }
+}
+
+std::string MetricsRegistry::render() const {
+    std::string out;
+    // Samples are read under the lock, so a handle being destroyed waits
+    // for the render rather than racing the object it reads
+    std::lock_guard lock(mutex_);
+    for (const auto& f : families_) {
+        if (f->series.empty()) continue;
+        append_header(out, f->name, f->help, f->type == MetricType::counter ? "counter" : "gauge");
+        for (const auto& s : f->series) {
+            append_series_name(out, f->name, s->labels);
+            out += ' ';
+            if (s->read) {
+                append_value(out, s->read());
+            } else if (s->counter) {
+                out += std::to_string(s->counter->value());
+            } else {
+                out += std::to_string(s->gauge->value());
+            }
+            out += '\n';
+        }
+    }
+    return out;
+}
+
+void render_latencies(const LatencyRegistry& latencies, std::string& out) {
+    static const std::string kName = "mde_stage_latency_seconds";
+    bool header = false;
+    for (auto stage : kStages) {
+        auto summary = LatencySummary::of(latencies.snapshot(stage));
+        if (summary.count == 0) continue;
+        if (!header) {
+            append_header(out, kName, "Hot-path stage latency since start", "summary");
+            header = true;
+        }
+        Labels labels{{"stage", std::string(stage_name(stage))}};
+        std::pair<const char*, double> quantiles[] = {
+            {"0.5", summary.p50_ns}, {"0.99", summary.p99_ns}, {"0.999", summary.p999_ns}};
+        for (const auto& [quantile, ns] : quantiles) {
+            std::pair<std::string, std::string> q{"quantile", quantile};
+            append_series_name(out, kName, labels, &q);
+            out += ' ';
+            append_value(out, ns / 1e9);
+            out += '\n';
+        }
+        append_series_name(out, kName + "_count", labels);
+        out += ' ';
+        out += std::to_string(summary.count);
+        out += '\n';
+    }
+}
+
+} // namespace mde::telemetry
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "telemetry/Latency.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mde::telemetry {
+
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+// Monotonic count; increments are one relaxed atomic add
+class Counter {
+public:
+    void inc(uint64_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+// Value that goes up and down
+class Gauge {
+public:
+    void set(int64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+    void add(int64_t n) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+enum class MetricType : uint8_t { counter, gauge };
+
+// Named metrics rendered in the Prometheus text format. Registration takes
+// a lock and is meant for startup; the returned Counter and Gauge live as
+// long as the registry and are updated without it. Asking again for the
+// same name and labels returns the same metric.
+//
+// Values a component already tracks (book counts, flush stats) are better
+// registered as samples: read only when the registry is rendered. A sample
+// stays registered until its handle is destroyed, so it can't outlive the
+// object it reads.
+class MetricsRegistry {
+public:
+    class SampleHandle {
+    public:
+        SampleHandle() = default;
+        SampleHandle(SampleHandle&& other) noexcept
+            : registry_(std::exchange(other.registry_, nullptr)), id_(other.id_) {}
+        SampleHandle& operator=(SampleHandle&& other) noexcept;
+        ~SampleHandle();
+
+    private:
+        friend class MetricsRegistry;
+        SampleHandle(MetricsRegistry* registry, uint64_t id) : registry_(registry), id_(id) {}
+
+        MetricsRegistry* registry_{nullptr};
+        uint64_t id_{0};
+    };
+
+    MetricsRegistry();
+    ~MetricsRegistry();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // The one the engine's components register with
+    static MetricsRegistry& global();
+
+    // Throw std::invalid_argument when the name is already registered with
+    // another type
+    Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+    [[nodiscard]] SampleHandle sample(MetricType type, const std::string& name, const std::string& help,
+                                      const Labels& labels, std::function<double()> read);
+
+    // Text exposition format 0.0.4, families in registration order
+    std::string render() const;
+
+private:
+    struct Series;
+    struct Family;
+
+    Family& family(const std::string& name, const std::string& help, MetricType type);
+    void remove_sample(uint64_t id);
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Family>> families_;
+    uint64_t next_sample_id_{1};
+};
+
+// Appends each stage's latency histogram as a Prometheus summary
+// (mde_stage_latency_seconds, p50/p99/p999 since start); stages with no
+// samples are skipped
+void render_latencies(const LatencyRegistry& latencies, std::string& out);
+
+} // namespace mde::telemetry
@@ -0,0 +1,40 @@
+#include "telemetry/Tsc.hpp"
+
+#include <thread>
+
+namespace mde::telemetry {
+
+namespace {
+
+struct Anchor {
+    uint64_t ticks;
+    std::chrono::steady_clock::time_point time;
+};
+
+// Taken during static initialization, so calibration usually has seconds
+// of baseline by the time anything reports
+const Anchor kAnchor{tsc_now(), std::chrono::steady_clock::now()};
+
+constexpr auto kMinBaseline = std::chrono::milliseconds(10);
+
+double calibrate() {
+#ifdef MDE_HAS_RDTSC
+    auto elapsed = std::chrono::steady_clock::now() - kAnchor.time;
+    if (elapsed < kMinBaseline) std::this_thread::sleep_for(kMinBaseline - elapsed);
+    auto ticks = tsc_now();
+    auto now = std::chrono::steady_clock::now();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - kAnchor.time).count();
+    return static_cast<double>(ticks - kAnchor.ticks) / static_cast<double>(ns);
+#else
+    return 1.0;
+#endif
+}
+
+} // anonymous namespace
+
+double tsc_ticks_per_ns() {
+    static const double rate = calibrate();
+    return rate;
+}
+
+} // namespace mde::telemetry
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <x86intrin.h>
+#define MDE_HAS_RDTSC 1
+#endif
+
+namespace mde::telemetry {
+
+// Cheap timestamps for hot-path latency: the CPU's time-stamp counter where
+// there is one (invariant on every x86-64 we deploy to, so ticks are
+// comparable across cores), steady_clock nanoseconds elsewhere. Only
+// differences are meaningful; convert them with ticks_to_ns().
+inline uint64_t tsc_now() noexcept {
+#ifdef MDE_HAS_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Ticks per nanosecond, measured against steady_clock the first time it is
+// needed. The measurement spans the time since process start, so it only
+// waits (up to 10 ms) when called right after startup.
+double tsc_ticks_per_ns();
+
+inline double ticks_to_ns(uint64_t ticks) {
+    return static_cast<double>(ticks) / tsc_ticks_per_ns();
+}
+
+inline uint64_t ns_to_ticks(std::chrono::nanoseconds ns) {
+    auto count = ns.count() > 0 ? static_cast<double>(ns.count()) : 0.0;
+    return static_cast<uint64_t>(count * tsc_ticks_per_ns());
+}
+
+} // namespace mde::telemetry
@@ -10,15 +10,45 @@ TEST(Settings, DefaultsAreReasonable) {
     Settings s;
     EXPECT_EQ(s.websocket.url, "wss://ws-subscriptions-clob.polymarket.com/ws/market");
     EXPECT_EQ(s.websocket.ping_interval_seconds, 30);
+    EXPECT_EQ(s.websocket.parser_backend, "nlohmann");
+    EXPECT_EQ(s.websocket.parse_queue_capacity, 0);
+    EXPECT_EQ(s.websocket.connections, 1);
+    EXPECT_EQ(s.websocket.reconnect_min_wait_ms, 500);
+    EXPECT_EQ(s.websocket.reconnect_max_wait_ms, 30000);
     EXPECT_EQ(s.api.gamma_api_base_url, "https://gamma-api.polymarket.com");
     EXPECT_EQ(s.service.snapshot_interval_seconds, 10);
+    EXPECT_EQ(s.service.snapshot_every_events, 1000);
+    EXPECT_EQ(s.service.ingest_shards, 0);
+    EXPECT_EQ(s.service.ingest_queue_capacity, 65536);
+    EXPECT_EQ(s.service.recovery_threads, 8);
     EXPECT_EQ(s.storage.backend, "memory");
     EXPECT_EQ(s.storage.data_directory, "data");
     EXPECT_EQ(s.storage.write_buffer_size, 1024);
+    EXPECT_EQ(s.storage.flush_threads, 0);
+    EXPECT_EQ(s.storage.max_pending_flushes, 16);
+    EXPECT_EQ(s.storage.buffer_age_seconds, 30);
+    EXPECT_TRUE(s.storage.wal_directory.empty());
+    EXPECT_EQ(s.storage.wal_sync_interval_ms, 10);
+    EXPECT_EQ(s.storage.compaction_interval_seconds, 0);
+    EXPECT_EQ(s.storage.snapshot_diffs_per_base, 8);
+    EXPECT_EQ(s.storage.parquet.profile, "default");
+    EXPECT_EQ(s.storage.parquet.codec, "uncompressed");
+    EXPECT_EQ(s.storage.parquet.numeric_encoding, "dictionary");
+    EXPECT_EQ(s.storage.parquet.row_group_rows, 256);
+    EXPECT_FALSE(s.storage.mmap_reads);
+    EXPECT_FALSE(s.storage.pre_buffer_reads);
+    EXPECT_EQ(s.storage.memory_pool, "default");
     EXPECT_FALSE(s.discovery.enabled);
     EXPECT_EQ(s.discovery.max_tracked_markets, 500);
     EXPECT_EQ(s.discovery.discovery_interval_seconds, 1800);
     EXPECT_EQ(s.discovery.markets_per_poll, 50);
+    EXPECT_FALSE(s.analytics.enabled);
+    EXPECT_EQ(s.analytics.vwap_trades, 100);
+    EXPECT_EQ(s.analytics.volatility_returns, 100);
+    EXPECT_DOUBLE_EQ(s.analytics.ewma_lambda, 0.94);
+    EXPECT_EQ(s.analytics.depth_ticks, 5);
+    EXPECT_EQ(s.metrics.port, 0);
+    EXPECT_EQ(s.metrics.host, "0.0.0.0");
 }
 
 TEST(Settings, FromEnvironmentDefaultsToDevelopment) {
@@ -64,6 +94,10 @@ TEST(Settings, FromEnvironmentReadsEnvVars) {
     unsetenv("MDE_ENV");
     setenv("MDE_WEBSOCKET_URL", "ws://localhost:8080", 1);
     setenv("MDE_PING_INTERVAL", "10", 1);
+    setenv("MDE_PARSER_BACKEND", "simdjson", 1);
+    setenv("MDE_WS_CONNECTIONS", "3", 1);
+    setenv("MDE_WS_RECONNECT_MIN_MS", "250", 1);
+    setenv("MDE_WS_RECONNECT_MAX_MS", "5000", 1);
     setenv("MDE_GAMMA_API_URL", "http://localhost:3000", 1);
     setenv("MDE_SNAPSHOT_INTERVAL", "3", 1);
     setenv("MDE_STORAGE_BACKEND", "parquet", 1);
@@ -73,6 +107,10 @@ TEST(Settings, FromEnvironmentReadsEnvVars) {
     auto s = Settings::from_environment();
     EXPECT_EQ(s.websocket.url, "ws://localhost:8080");
     EXPECT_EQ(s.websocket.ping_interval_seconds, 10);
+    EXPECT_EQ(s.websocket.parser_backend, "simdjson");
+    EXPECT_EQ(s.websocket.connections, 3);
+    EXPECT_EQ(s.websocket.reconnect_min_wait_ms, 250);
+    EXPECT_EQ(s.websocket.reconnect_max_wait_ms, 5000);
     EXPECT_EQ(s.api.gamma_api_base_url, "http://localhost:3000");
     EXPECT_EQ(s.service.snapshot_interval_seconds, 3);
     EXPECT_EQ(s.storage.backend, "parquet");
@@ -82,6 +120,10 @@ TEST(Settings, FromEnvironmentReadsEnvVars) {
     // Clean up
     unsetenv("MDE_WEBSOCKET_URL");
     unsetenv("MDE_PING_INTERVAL");
+    unsetenv("MDE_PARSER_BACKEND");
+    unsetenv("MDE_WS_CONNECTIONS");
+    unsetenv("MDE_WS_RECONNECT_MIN_MS");
+    unsetenv("MDE_WS_RECONNECT_MAX_MS");
     unsetenv("MDE_GAMMA_API_URL");
     unsetenv("MDE_SNAPSHOT_INTERVAL");
     unsetenv("MDE_STORAGE_BACKEND");
@@ -108,11 +150,153 @@ TEST(Settings, DevelopmentPreset) {
 TEST(Settings, ProductionPreset) {
     auto s = Settings::production();
     EXPECT_EQ(s.websocket.ping_interval_seconds, 15);
+    EXPECT_EQ(s.websocket.parser_backend, "simdjson");
+    EXPECT_EQ(s.websocket.parse_queue_capacity, 4096);
+    EXPECT_EQ(s.websocket.connections, 4);
+    EXPECT_EQ(s.websocket.reconnect_max_wait_ms, 10000);
     EXPECT_EQ(s.service.snapshot_interval_seconds, 5);
+    EXPECT_EQ(s.service.ingest_shards, 4);
+    EXPECT_EQ(s.service.snapshot_mode, "checkpoint");
     EXPECT_EQ(s.storage.backend, "parquet");
     EXPECT_EQ(s.storage.data_directory, "data/prod");
     EXPECT_EQ(s.storage.write_buffer_size, 4096);
+    EXPECT_EQ(s.storage.flush_threads, 4);
+    EXPECT_EQ(s.storage.read_concurrency, 8);
+    EXPECT_EQ(s.storage.buffer_age_seconds, 300);
+    EXPECT_EQ(s.storage.wal_directory, "data/prod/wal");
+    EXPECT_EQ(s.storage.compaction_interval_seconds, 900);
+    EXPECT_EQ(s.storage.parquet.profile, "compact");
     EXPECT_TRUE(s.discovery.enabled);
+    EXPECT_EQ(s.metrics.port, 9464);
+}
+
+TEST(Settings, IngestPipelineSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    setenv("MDE_PARSE_QUEUE_CAPACITY", "1024", 1);
+    setenv("MDE_INGEST_SHARDS", "8", 1);
+    setenv("MDE_INGEST_QUEUE_CAPACITY", "4096", 1);
+    setenv("MDE_RECOVERY_THREADS", "16", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.websocket.parse_queue_capacity, 1024);
+    EXPECT_EQ(s.service.ingest_shards, 8);
+    EXPECT_EQ(s.service.ingest_queue_capacity, 4096);
+    EXPECT_EQ(s.service.recovery_threads, 16);
+
+    unsetenv("MDE_PARSE_QUEUE_CAPACITY");
+    unsetenv("MDE_INGEST_SHARDS");
+    unsetenv("MDE_INGEST_QUEUE_CAPACITY");
+    unsetenv("MDE_RECOVERY_THREADS");
+}
+
+TEST(Settings, SnapshotModeFromEnvVars) {
+    unsetenv("MDE_ENV");
+    setenv("MDE_SNAPSHOT_MODE", "checkpoint", 1);
+    setenv("MDE_CHECKPOINT_INTERVAL", "30", 1);
+    setenv("MDE_SNAPSHOT_EVERY_EVENTS", "500", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.service.snapshot_mode, "checkpoint");
+    EXPECT_EQ(s.service.checkpoint_interval_seconds, 30);
+    EXPECT_EQ(s.service.snapshot_every_events, 500);
+
+    unsetenv("MDE_SNAPSHOT_MODE");
+    unsetenv("MDE_CHECKPOINT_INTERVAL");
+    unsetenv("MDE_SNAPSHOT_EVERY_EVENTS");
+}
+
+TEST(Settings, FlushSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    setenv("MDE_FLUSH_THREADS", "2", 1);
+    setenv("MDE_MAX_PENDING_FLUSHES", "8", 1);
+    setenv("MDE_COMPACTION_INTERVAL", "600", 1);
+    setenv("MDE_SNAPSHOT_DIFFS_PER_BASE", "0", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.storage.flush_threads, 2);
+    EXPECT_EQ(s.storage.max_pending_flushes, 8);
+    EXPECT_EQ(s.storage.compaction_interval_seconds, 600);
+    EXPECT_EQ(s.storage.snapshot_diffs_per_base, 0);
+
+    unsetenv("MDE_FLUSH_THREADS");
+    unsetenv("MDE_MAX_PENDING_FLUSHES");
+    unsetenv("MDE_COMPACTION_INTERVAL");
+    unsetenv("MDE_SNAPSHOT_DIFFS_PER_BASE");
+}
+
+TEST(Settings, WriteAheadLogSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    setenv("MDE_WAL_DIRECTORY", "/var/lib/mde/wal", 1);
+    setenv("MDE_WAL_SYNC_INTERVAL_MS", "-1", 1);
+    setenv("MDE_BUFFER_AGE", "120", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.storage.wal_directory, "/var/lib/mde/wal");
+    EXPECT_EQ(s.storage.wal_sync_interval_ms, -1);
+    EXPECT_EQ(s.storage.buffer_age_seconds, 120);
+
+    unsetenv("MDE_WAL_DIRECTORY");
+    unsetenv("MDE_WAL_SYNC_INTERVAL_MS");
+    unsetenv("MDE_BUFFER_AGE");
+}
+
+TEST(Settings, ParquetWriterProfiles) {
+    auto fast = ParquetWriterSettings::named("fast");
+    ASSERT_TRUE(fast.has_value());
+    EXPECT_EQ(fast->codec, "snappy");
+    EXPECT_EQ(fast->numeric_encoding, "plain");
+
+    auto compact = ParquetWriterSettings::named("compact");
+    ASSERT_TRUE(compact.has_value());
+    EXPECT_EQ(compact->codec, "zstd");
+    EXPECT_EQ(compact->numeric_encoding, "delta");
+    EXPECT_TRUE(compact->dictionary);
+
+    EXPECT_EQ(ParquetWriterSettings::named("default")->codec, ParquetWriterSettings{}.codec);
+    EXPECT_FALSE(ParquetWriterSettings::named("tiny").has_value());
+}
+
+TEST(Settings, ParquetWriterSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    setenv("MDE_PARQUET_PROFILE", "compact", 1);
+    setenv("MDE_PARQUET_CODEC_LEVEL", "19", 1);
+    setenv("MDE_PARQUET_DICTIONARY", "false", 1);
+    setenv("MDE_PARQUET_ROW_GROUP_ROWS", "65536", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.storage.parquet.profile, "compact");
+    EXPECT_EQ(s.storage.parquet.codec, "zstd");  // from the profile
+    EXPECT_EQ(s.storage.parquet.codec_level, 19);
+    EXPECT_FALSE(s.storage.parquet.dictionary);
+    EXPECT_EQ(s.storage.parquet.row_group_rows, 65536);
+
+    // An unknown profile is kept for main to reject
+    setenv("MDE_PARQUET_PROFILE", "tiny", 1);
+    EXPECT_EQ(Settings::from_environment().storage.parquet.profile, "tiny");
+
+    unsetenv("MDE_PARQUET_PROFILE");
+    unsetenv("MDE_PARQUET_CODEC_LEVEL");
+    unsetenv("MDE_PARQUET_DICTIONARY");
+    unsetenv("MDE_PARQUET_ROW_GROUP_ROWS");
+}
+
+TEST(Settings, ReadSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    setenv("MDE_MMAP_READS", "true", 1);
+    setenv("MDE_PRE_BUFFER_READS", "1", 1);
+    setenv("MDE_MEMORY_POOL", "jemalloc", 1);
+    setenv("MDE_READ_CONCURRENCY", "16", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_TRUE(s.storage.mmap_reads);
+    EXPECT_TRUE(s.storage.pre_buffer_reads);
+    EXPECT_EQ(s.storage.memory_pool, "jemalloc");
+    EXPECT_EQ(s.storage.read_concurrency, 16);
+
+    unsetenv("MDE_MMAP_READS");
+    unsetenv("MDE_PRE_BUFFER_READS");
+    unsetenv("MDE_MEMORY_POOL");
+    unsetenv("MDE_READ_CONCURRENCY");
 }
 
 TEST(Settings, DiscoverySettingsFromEnvVars) {
@@ -121,17 +305,23 @@ TEST(Settings, DiscoverySettingsFromEnvVars) {
     setenv("MDE_MAX_TRACKED_MARKETS", "100", 1);
     setenv("MDE_DISCOVERY_INTERVAL", "600", 1);
     setenv("MDE_MARKETS_PER_POLL", "25", 1);
+    setenv("MDE_DISCOVERY_PAGE_SIZE", "10", 1);
+    setenv("MDE_DISCOVERY_CONCURRENCY", "3", 1);
 
     auto s = Settings::from_environment();
     EXPECT_TRUE(s.discovery.enabled);
     EXPECT_EQ(s.discovery.max_tracked_markets, 100);
     EXPECT_EQ(s.discovery.discovery_interval_seconds, 600);
     EXPECT_EQ(s.discovery.markets_per_poll, 25);
+    EXPECT_EQ(s.discovery.page_size, 10);
+    EXPECT_EQ(s.discovery.fetch_concurrency, 3);
 
     unsetenv("MDE_DISCOVERY_ENABLED");
     unsetenv("MDE_MAX_TRACKED_MARKETS");
     unsetenv("MDE_DISCOVERY_INTERVAL");
     unsetenv("MDE_MARKETS_PER_POLL");
+    unsetenv("MDE_DISCOVERY_PAGE_SIZE");
+    unsetenv("MDE_DISCOVERY_CONCURRENCY");
 }
 
 TEST(Settings, DiscoveryDisabledByDefault) {
@@ -141,3 +331,207 @@ TEST(Settings, DiscoveryDisabledByDefault) {
     auto s = Settings::from_environment();
     EXPECT_FALSE(s.discovery.enabled);
 }
+
+TEST(Settings, AnalyticsSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    setenv("MDE_ANALYTICS_ENABLED", "true", 1);
+    setenv("MDE_ANALYTICS_VWAP_TRADES", "50", 1);
+    setenv("MDE_ANALYTICS_VOLATILITY_RETURNS", "200", 1);
+    setenv("MDE_ANALYTICS_EWMA_LAMBDA", "0.97", 1);
+    setenv("MDE_ANALYTICS_DEPTH_TICKS", "10", 1);
+    setenv("MDE_ANALYTICS_SWEEP_SIZE", "2500", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_TRUE(s.analytics.enabled);
+    EXPECT_EQ(s.analytics.vwap_trades, 50);
+    EXPECT_EQ(s.analytics.volatility_returns, 200);
+    EXPECT_DOUBLE_EQ(s.analytics.ewma_lambda, 0.97);
+    EXPECT_EQ(s.analytics.depth_ticks, 10);
+    EXPECT_DOUBLE_EQ(s.analytics.sweep_size, 2500.0);
+
+    unsetenv("MDE_ANALYTICS_ENABLED");
+    unsetenv("MDE_ANALYTICS_VWAP_TRADES");
+    unsetenv("MDE_ANALYTICS_VOLATILITY_RETURNS");
+    unsetenv("MDE_ANALYTICS_EWMA_LAMBDA");
+    unsetenv("MDE_ANALYTICS_DEPTH_TICKS");
+    unsetenv("MDE_ANALYTICS_SWEEP_SIZE");
+}
+
+TEST(Settings, BarSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    auto defaults = Settings::from_environment();
+    EXPECT_FALSE(defaults.bars.enabled);
+    EXPECT_EQ(defaults.bars.intervals, "1s,1m");
+
+    setenv("MDE_BARS_ENABLED", "true", 1);
+    setenv("MDE_BAR_INTERVALS", "5s,1h", 1);
+    setenv("MDE_BAR_FLUSH_INTERVAL", "30", 1);
+    setenv("MDE_BAR_GRACE_MS", "500", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_TRUE(s.bars.enabled);
+    EXPECT_EQ(s.bars.intervals, "5s,1h");
+    EXPECT_EQ(s.bars.flush_interval_seconds, 30);
+    EXPECT_EQ(s.bars.grace_ms, 500);
+
+    unsetenv("MDE_BARS_ENABLED");
+    unsetenv("MDE_BAR_INTERVALS");
+    unsetenv("MDE_BAR_FLUSH_INTERVAL");
+    unsetenv("MDE_BAR_GRACE_MS");
+}
+
+TEST(Settings, MetricsSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    setenv("MDE_METRICS_PORT", "9100", 1);
+    setenv("MDE_METRICS_HOST", "127.0.0.1", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.metrics.port, 9100);
+    EXPECT_EQ(s.metrics.host, "127.0.0.1");
+
+    unsetenv("MDE_METRICS_PORT");
+    unsetenv("MDE_METRICS_HOST");
+}
+
+TEST(Settings, SharedMemorySettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    EXPECT_TRUE(Settings::from_environment().shared_memory.name.empty());
+
+    setenv("MDE_SHM_NAME", "/mde_books", 1);
+    setenv("MDE_SHM_SLOTS", "4096", 1);
+    setenv("MDE_SHM_DEPTH", "5", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.shared_memory.name, "/mde_books");
+    EXPECT_EQ(s.shared_memory.slots, 4096);
+    EXPECT_EQ(s.shared_memory.depth, 5);
+
+    unsetenv("MDE_SHM_NAME");
+    unsetenv("MDE_SHM_SLOTS");
+    unsetenv("MDE_SHM_DEPTH");
+}
+
+TEST(Settings, BinaryFeedSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    EXPECT_TRUE(Settings::from_environment().binary_feed.group.empty());
+
+    setenv("MDE_BINARY_FEED_GROUP", "239.1.2.3", 1);
+    setenv("MDE_BINARY_FEED_PORT", "30000", 1);
+    setenv("MDE_BINARY_FEED_INTERFACE", "10.0.0.5", 1);
+    setenv("MDE_BINARY_FEED_TTL", "4", 1);
+    setenv("MDE_BINARY_FEED_RECOVERY_PORT", "30001", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.binary_feed.group, "239.1.2.3");
+    EXPECT_EQ(s.binary_feed.port, 30000);
+    EXPECT_EQ(s.binary_feed.interface_address, "10.0.0.5");
+    EXPECT_EQ(s.binary_feed.ttl, 4);
+    EXPECT_EQ(s.binary_feed.recovery_port, 30001);
+
+    unsetenv("MDE_BINARY_FEED_GROUP");
+    unsetenv("MDE_BINARY_FEED_PORT");
+    unsetenv("MDE_BINARY_FEED_INTERFACE");
+    unsetenv("MDE_BINARY_FEED_TTL");
+    unsetenv("MDE_BINARY_FEED_RECOVERY_PORT");
+}
+
+TEST(Settings, QuerySettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    EXPECT_EQ(Settings::from_environment().query.port, 0);
+
+    setenv("MDE_QUERY_PORT", "9300", 1);
+    setenv("MDE_QUERY_HOST", "127.0.0.1", 1);
+    setenv("MDE_QUERY_THREADS", "4", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.query.port, 9300);
+    EXPECT_EQ(s.query.host, "127.0.0.1");
+    EXPECT_EQ(s.query.threads, 4);
+
+    unsetenv("MDE_QUERY_PORT");
+    unsetenv("MDE_QUERY_HOST");
+    unsetenv("MDE_QUERY_THREADS");
+}
+
+TEST(Settings, MemoryRetentionFromEnvVars) {
+    unsetenv("MDE_ENV");
+    auto defaults = Settings::from_environment();
+    EXPECT_EQ(defaults.storage.memory_max_events, 0);
+    EXPECT_EQ(defaults.storage.memory_max_age_seconds, 0);
+
+    setenv("MDE_MEMORY_MAX_EVENTS", "50000", 1);
+    setenv("MDE_MEMORY_MAX_AGE", "3600", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.storage.memory_max_events, 50000);
+    EXPECT_EQ(s.storage.memory_max_age_seconds, 3600);
+
+    unsetenv("MDE_MEMORY_MAX_EVENTS");
+    unsetenv("MDE_MEMORY_MAX_AGE");
+}
+
+TEST(Settings, HotTailSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    auto defaults = Settings::from_environment();
+    EXPECT_EQ(defaults.storage.hot_tail_events, 0);
+    EXPECT_TRUE(defaults.storage.cache_directory.empty());
+
+    setenv("MDE_HOT_TAIL_EVENTS", "10000", 1);
+    setenv("MDE_HOT_TAIL_AGE", "600", 1);
+    setenv("MDE_CACHE_DIRECTORY", "/var/cache/mde", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.storage.hot_tail_events, 10000);
+    EXPECT_EQ(s.storage.hot_tail_age_seconds, 600);
+    EXPECT_EQ(s.storage.cache_directory, "/var/cache/mde");
+
+    unsetenv("MDE_HOT_TAIL_EVENTS");
+    unsetenv("MDE_HOT_TAIL_AGE");
+    unsetenv("MDE_CACHE_DIRECTORY");
+}
+
+TEST(Settings, S3CacheSettingsFromEnvVars) {
+    unsetenv("MDE_ENV");
+    auto defaults = Settings::from_environment();
+    EXPECT_TRUE(defaults.storage.s3_cache_directory.empty());
+    EXPECT_EQ(defaults.storage.s3_cache_max_mb, 1024);
+
+    setenv("MDE_S3_CACHE_DIRECTORY", "/var/cache/mde-s3", 1);
+    setenv("MDE_S3_CACHE_MAX_MB", "20480", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.storage.s3_cache_directory, "/var/cache/mde-s3");
+    EXPECT_EQ(s.storage.s3_cache_max_mb, 20480);
+
+    unsetenv("MDE_S3_CACHE_DIRECTORY");
+    unsetenv("MDE_S3_CACHE_MAX_MB");
+}
+
+TEST(Settings, ThreadPlacementFromEnvVars) {
+    unsetenv("MDE_ENV");
+    auto defaults = Settings::from_environment();
+    EXPECT_TRUE(defaults.service.shard_cpus.empty());
+    EXPECT_FALSE(defaults.service.busy_poll);
+
+    setenv("MDE_WS_CPUS", "2", 1);
+    setenv("MDE_INGEST_SHARD_CPUS", "4-7", 1);
+    setenv("MDE_INGEST_WRITER_CPUS", "8", 1);
+    setenv("MDE_INGEST_BUSY_POLL", "true", 1);
+    setenv("MDE_BACKGROUND_CPUS", "0,1", 1);
+    setenv("MDE_FLUSH_CPUS", "9-10", 1);
+
+    auto s = Settings::from_environment();
+    EXPECT_EQ(s.websocket.cpus, "2");
+    EXPECT_EQ(s.service.shard_cpus, "4-7");
+    EXPECT_EQ(s.service.writer_cpus, "8");
+    EXPECT_TRUE(s.service.busy_poll);
+    EXPECT_EQ(s.service.background_cpus, "0,1");
+    EXPECT_EQ(s.storage.flush_cpus, "9-10");
+
+    unsetenv("MDE_WS_CPUS");
+    unsetenv("MDE_INGEST_SHARD_CPUS");
+    unsetenv("MDE_INGEST_WRITER_CPUS");
+    unsetenv("MDE_INGEST_BUSY_POLL");
+    unsetenv("MDE_BACKGROUND_CPUS");
+    unsetenv("MDE_FLUSH_CPUS");
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace mde::domain;
 
 // --- Factory ---
@@ -295,6 +297,72 @@ TEST(OrderBook, GetMidpoint) {
     EXPECT_DOUBLE_EQ(updated.get_midpoint().value(), 0.50);
 }
 
+TEST(OrderBook, OptionalQueriesAreEmptyForMissingSides) {
+    auto asset = MarketAsset("0xbd31dc", "6581861");
+    auto book = OrderBook::empty(asset);
+    EXPECT_FALSE(book.best_bid().has_value());
+    EXPECT_FALSE(book.spread().has_value());
+    EXPECT_FALSE(book.midpoint().has_value());
+
+    book.apply_in_place(BookSnapshot{{asset, Timestamp(0), 1},
+                                     {PriceLevel(Price(0.48), Quantity(30.0))}, {}, ""});
+    EXPECT_EQ(book.best_bid(), Price(0.48));
+    EXPECT_FALSE(book.best_ask().has_value());
+    EXPECT_FALSE(book.weighted_midpoint().has_value());
+    EXPECT_THROW(book.get_midpoint(), std::runtime_error);
+}
+
+TEST(OrderBook, TopOfBookFollowsDeltas) {
+    auto asset = MarketAsset("0xbd31dc", "6581861");
+    auto book = OrderBook::empty(asset);
+    book.apply_in_place(BookSnapshot{
+        {asset, Timestamp(0), 1},
+        {PriceLevel(Price(0.48), Quantity(30.0)), PriceLevel(Price(0.47), Quantity(20.0))},
+        {PriceLevel(Price(0.52), Quantity(10.0))},
+        ""});
+    EXPECT_EQ(book.top().bid, PriceLevel(Price(0.48), Quantity(30.0)));
+
+    book.apply_in_place(BookDelta{{asset, Timestamp(100), 2},
+                                  {PriceLevelDelta{"6581861", Price(0.48), Quantity::zero(), Side::BUY,
+                                                   Price(0.47), Price(0.52)}}});
+    EXPECT_EQ(book.top().bid, PriceLevel(Price(0.47), Quantity(20.0)));
+    EXPECT_EQ(book.spread()->best_ask, Price(0.52));
+    EXPECT_EQ(book.midpoint(), Price(0.495));
+    // 0.47 x 20 against 0.52 x 10: the mid leans toward the thinner ask
+    EXPECT_EQ(book.weighted_midpoint(), Price::from_micros(503'333));
+}
+
+TEST(OrderBook, DepthAggregates) {
+    auto asset = MarketAsset("0xbd31dc", "6581861");
+    auto book = OrderBook::empty(asset).apply(BookSnapshot{
+        {asset, Timestamp(0), 1},
+        {PriceLevel(Price(0.48), Quantity(30.0)), PriceLevel(Price(0.46), Quantity(20.0)),
+         PriceLevel(Price(0.40), Quantity(5.0))},
+        {PriceLevel(Price(0.52), Quantity(25.0)), PriceLevel(Price(0.53), Quantity(1.5))},
+        ""});
+
+    EXPECT_EQ(book.get_total_size(Side::BUY), Quantity(55.0));
+    EXPECT_EQ(book.get_total_size(Side::SELL), Quantity(26.5));
+    EXPECT_EQ(book.get_depth_within(Side::BUY, 0), Quantity(30.0));
+    EXPECT_EQ(book.get_depth_within(Side::BUY, 2), Quantity(50.0));
+    EXPECT_EQ(book.get_depth_within(Side::BUY, 100), Quantity(55.0));
+    EXPECT_EQ(book.get_depth_within(Side::SELL, 1), Quantity(26.5));
+
+    std::vector<Quantity> curve(4, Quantity::zero());
+    book.get_depth_curve(Side::BUY, curve);
+    EXPECT_EQ(curve, (std::vector<Quantity>{Quantity(30.0), Quantity(30.0), Quantity(50.0), Quantity(50.0)}));
+    auto sweep = book.get_sweep(Side::SELL, Quantity(26.0));
+    EXPECT_EQ(sweep.filled, Quantity(26.0));
+    EXPECT_EQ(sweep.worst_price, Price(0.53));
+    EXPECT_EQ(sweep.notional, 13'530'000);  // 25 * 0.52 + 1 * 0.53
+
+    book = book.apply(BookDelta{{asset, Timestamp(100), 2},
+                                {PriceLevelDelta{"6581861", Price(0.46), Quantity(2.0), Side::BUY,
+                                                 Price(0.48), Price(0.52)}}});
+    EXPECT_EQ(book.get_total_size(Side::BUY), Quantity(37.0));
+    EXPECT_EQ(book.get_depth_within(Side::BUY, 2), Quantity(32.0));
+}
+
 // --- Variant dispatch ---
 
 TEST(OrderBook, ApplyVariantDispatchesCorrectly) {
@@ -312,3 +380,158 @@ TEST(OrderBook, ApplyVariantDispatchesCorrectly) {
     EXPECT_EQ(updated.get_depth(), 1);
     EXPECT_DOUBLE_EQ(updated.get_best_bid().value(), 0.48);
 }
+
+// --- Apply in place ---
+
+TEST(OrderBook, ApplyInPlaceMutatesBook) {
+    auto book = OrderBook::empty(MarketAsset("0xbd31dc", "6581861"));
+
+    BookSnapshot snap{
+        {MarketAsset("0xbd31dc", "6581861"), Timestamp(1000), 1},
+        {PriceLevel(Price(0.48), Quantity(30.0))},
+        {PriceLevel(Price(0.52), Quantity(25.0))},
+        "0xabc"
+    };
+
+    book.apply_in_place(snap);
+
+    EXPECT_EQ(book.get_depth(), 1);
+    EXPECT_DOUBLE_EQ(book.get_best_bid().value(), 0.48);
+    EXPECT_EQ(book.get_book_hash(), "0xabc");
+    EXPECT_EQ(book.get_last_sequence_number(), 1);
+}
+
+TEST(OrderBook, ApplyInPlaceMatchesImmutableApply) {
+    auto asset = MarketAsset("0xbd31dc", "6581861");
+    std::vector<OrderBookEventVariant> events = {
+        BookSnapshot{
+            {asset, Timestamp(0), 1},
+            {PriceLevel(Price(0.48), Quantity(30.0)), PriceLevel(Price(0.47), Quantity(20.0))},
+            {PriceLevel(Price(0.52), Quantity(25.0))},
+            "0xabc"
+        },
+        BookDelta{
+            {asset, Timestamp(100), 2},
+            {PriceLevelDelta{"6581861", Price(0.50), Quantity(100.0), Side::BUY,
+                             Price(0.50), Price(0.52)},
+             PriceLevelDelta{"6581861", Price(0.48), Quantity(0.0), Side::BUY,
+                             Price(0.50), Price(0.52)},
+             PriceLevelDelta{"6581861", Price(0.51), Quantity(5.0), Side::SELL,
+                             Price(0.50), Price(0.51)}}
+        },
+        TradeEvent{{asset, Timestamp(200), 3}, Price(0.51), Quantity(5.0), Side::BUY, "0"},
+        TickSizeChange{{asset, Timestamp(300), 4}, Price(0.01), Price(0.001)},
+    };
+
+    auto immutable = OrderBook::empty(asset);
+    auto in_place = OrderBook::empty(asset);
+    for (const auto& event : events) {
+        immutable = immutable.apply(event);
+        in_place.apply_in_place(event);
+    }
+
+    EXPECT_EQ(in_place.get_bids(), immutable.get_bids());
+    EXPECT_EQ(in_place.get_asks(), immutable.get_asks());
+    EXPECT_EQ(in_place.get_tick_size(), immutable.get_tick_size());
+    EXPECT_EQ(in_place.get_timestamp(), immutable.get_timestamp());
+    EXPECT_EQ(in_place.get_last_sequence_number(), immutable.get_last_sequence_number());
+    EXPECT_EQ(in_place.get_book_hash(), immutable.get_book_hash());
+    ASSERT_TRUE(in_place.get_latest_trade().has_value());
+    EXPECT_EQ(in_place.get_latest_trade()->sequence_number, 3);
+}
+
+TEST(OrderBook, ApplyRunMatchesOneByOne) {
+    auto asset = MarketAsset("0xbd31dc", "6581861");
+    auto delta = [&](uint64_t seq, double price, double size, Side side) {
+        return BookDelta{{asset, Timestamp(seq * 100), seq},
+                         {PriceLevelDelta{"6581861", Price(price), Quantity(size), side,
+                                          Price(0.0), Price(0.0)}}};
+    };
+    std::vector<OrderBookEventVariant> events = {
+        BookSnapshot{{asset, Timestamp(0), 1},
+                     {PriceLevel(Price(0.48), Quantity(30.0)), PriceLevel(Price(0.47), Quantity(20.0))},
+                     {PriceLevel(Price(0.52), Quantity(25.0)), PriceLevel(Price(0.55), Quantity(5.0))},
+                     "0xabc"},
+        delta(2, 0.48, 0.0, Side::BUY),
+        delta(3, 0.47, 0.0, Side::BUY),
+        delta(4, 0.46, 8.0, Side::BUY),
+        delta(5, 0.55, 0.0, Side::SELL),
+        TickSizeChange{{asset, Timestamp(600), 6}, Price(0.01), Price(0.001)},
+        delta(7, 0.465, 2.0, Side::BUY),
+        TradeEvent{{asset, Timestamp(800), 8}, Price(0.52), Quantity(5.0), Side::BUY, "0"},
+        delta(9, 0.52, 0.0, Side::SELL),
+        delta(10, 0.53, 4.0, Side::SELL),
+    };
+
+    auto one_by_one = OrderBook::empty(asset);
+    for (const auto& event : events) one_by_one.apply_in_place(event);
+    auto batched = OrderBook::empty(asset);
+    batched.apply_in_place(std::span<const OrderBookEventVariant>(events));
+
+    EXPECT_EQ(batched.get_bids(), one_by_one.get_bids());
+    EXPECT_EQ(batched.get_asks(), one_by_one.get_asks());
+    EXPECT_EQ(batched.get_best_bid(), Price(0.465));
+    EXPECT_EQ(batched.get_best_ask(), Price(0.53));
+    EXPECT_EQ(batched.get_tick_size(), Price(0.001));
+    EXPECT_EQ(batched.get_last_sequence_number(), 10);
+    ASSERT_TRUE(batched.get_latest_trade().has_value());
+    EXPECT_EQ(batched.get_latest_trade()->sequence_number, 8);
+}
+
+TEST(OrderBook, ApplyDoesNotMutateSourceAfterInPlaceUpdates) {
+    auto asset = MarketAsset("0xbd31dc", "6581861");
+    auto book = OrderBook::empty(asset);
+    book.apply_in_place(BookSnapshot{
+        {asset, Timestamp(0), 1},
+        {PriceLevel(Price(0.48), Quantity(30.0))},
+        {PriceLevel(Price(0.52), Quantity(25.0))},
+        ""
+    });
+
+    BookDelta delta{
+        {asset, Timestamp(100), 2},
+        {PriceLevelDelta{"6581861", Price(0.48), Quantity(0.0), Side::BUY,
+                         Price(0.0), Price(0.52)}}
+    };
+    auto updated = book.apply(delta);
+
+    EXPECT_EQ(book.get_bids().size(), 1);
+    EXPECT_TRUE(updated.get_bids().empty());
+}
+
+// --- Exchange-reported top of book ---
+
+TEST(OrderBook, AgreesWithDeltaWhenTopMatchesReport) {
+    MarketAsset asset("0xbd31dc", "6581861");
+    auto book = OrderBook::empty(asset).apply(BookSnapshot{
+        {asset, Timestamp(1000), 1},
+        {PriceLevel(Price(0.48), Quantity(30.0))},
+        {PriceLevel(Price(0.52), Quantity(25.0))},
+        "0xabc"});
+
+    BookDelta improves{{asset, Timestamp(1001), 2},
+                       {PriceLevelDelta{"6581861", Price(0.49), Quantity(5.0), Side::BUY,
+                                        Price(0.49), Price(0.52)}}};
+    EXPECT_TRUE(book.apply(improves).agrees_with(improves));
+
+    // The exchange saw a best bid this book never got
+    BookDelta elsewhere{{asset, Timestamp(1002), 3},
+                        {PriceLevelDelta{"6581861", Price(0.40), Quantity(5.0), Side::BUY,
+                                         Price(0.50), Price(0.52)}}};
+    EXPECT_FALSE(book.apply(elsewhere).agrees_with(elsewhere));
+}
+
+TEST(OrderBook, AgreesWithZeroReportForEmptySide) {
+    MarketAsset asset("0xbd31dc", "6581861");
+    BookDelta first_bid{{asset, Timestamp(1000), 1},
+                        {PriceLevelDelta{"6581861", Price(0.48), Quantity(5.0), Side::BUY,
+                                         Price(0.48), Price::zero()}}};
+    auto book = OrderBook::empty(asset).apply(first_bid);
+    EXPECT_TRUE(book.agrees_with(first_bid));
+
+    // Changes for another token carry that token's top, and are not checked
+    BookDelta other{{asset, Timestamp(1001), 2},
+                    {PriceLevelDelta{"4821793", Price(0.30), Quantity(5.0), Side::BUY,
+                                     Price(0.30), Price(0.70)}}};
+    EXPECT_TRUE(book.agrees_with(other));
+}
@@ -0,0 +1,341 @@
+#include "domain/aggregates/PriceLadder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+using namespace mde::domain;
+
+// --- Construction ---
+
+TEST(PriceLadder, NewLadderIsEmpty) {
+    PriceLadder ladder(Side::BUY, Price(0.01));
+
+    EXPECT_TRUE(ladder.empty());
+    EXPECT_EQ(ladder.size(), 0u);
+    EXPECT_EQ(ladder.begin(), ladder.end());
+    EXPECT_EQ(ladder.ticks_per_unit(), 100);
+}
+
+TEST(PriceLadder, ThrowsOnTickSizeThatDoesNotDivideOne) {
+    EXPECT_THROW(PriceLadder(Side::BUY, Price(0.03)), std::invalid_argument);
+    EXPECT_THROW(PriceLadder(Side::BUY, Price(0.0)), std::invalid_argument);
+}
+
+// --- Level updates ---
+
+TEST(PriceLadder, BidBestIsHighestPrice) {
+    PriceLadder bids(Side::BUY, Price(0.01));
+    bids.set(Price(0.48), Quantity(30.0));
+    bids.set(Price(0.49), Quantity(20.0));
+    bids.set(Price(0.30), Quantity(10.0));
+
+    EXPECT_EQ(bids.size(), 3u);
+    EXPECT_DOUBLE_EQ(bids.best_price().value(), 0.49);
+    EXPECT_DOUBLE_EQ(bids.best_size().size(), 20.0);
+}
+
+TEST(PriceLadder, AskBestIsLowestPrice) {
+    PriceLadder asks(Side::SELL, Price(0.01));
+    asks.set(Price(0.60), Quantity(10.0));
+    asks.set(Price(0.52), Quantity(25.0));
+    asks.set(Price(0.55), Quantity(5.0));
+
+    EXPECT_DOUBLE_EQ(asks.best_price().value(), 0.52);
+}
+
+TEST(PriceLadder, SetExistingLevelReplacesSize) {
+    PriceLadder bids(Side::BUY, Price(0.01));
+    bids.set(Price(0.48), Quantity(30.0));
+    bids.set(Price(0.48), Quantity(50.0));
+
+    EXPECT_EQ(bids.size(), 1u);
+    EXPECT_DOUBLE_EQ(bids.size_at(Price(0.48)).size(), 50.0);
+}
+
+TEST(PriceLadder, ZeroSizeRemovesBestAndAdvancesCursor) {
+    PriceLadder bids(Side::BUY, Price(0.01));
+    bids.set(Price(0.48), Quantity(30.0));
+    bids.set(Price(0.40), Quantity(20.0));
+
+    bids.set(Price(0.48), Quantity(0.0));
+
+    EXPECT_EQ(bids.size(), 1u);
+    EXPECT_DOUBLE_EQ(bids.best_price().value(), 0.40);
+}
+
+TEST(PriceLadder, RemovingWorstKeepsIterationBounded) {
+    PriceLadder asks(Side::SELL, Price(0.01));
+    asks.set(Price(0.52), Quantity(25.0));
+    asks.set(Price(0.60), Quantity(10.0));
+    asks.set(Price(0.55), Quantity(5.0));
+
+    asks.set(Price(0.60), Quantity(0.0));
+
+    std::vector<PriceLevel> levels(asks.begin(), asks.end());
+    ASSERT_EQ(levels.size(), 2u);
+    EXPECT_DOUBLE_EQ(levels[1].price().value(), 0.55);
+}
+
+TEST(PriceLadder, DeferredUpdatesSettleToTheSameLadder) {
+    PriceLadder one_by_one(Side::BUY, Price(0.01));
+    PriceLadder batched(Side::BUY, Price(0.01));
+    for (auto* ladder : {&one_by_one, &batched}) {
+        for (double price : {0.40, 0.45, 0.48, 0.49}) ladder->set(Price(price), Quantity(10.0));
+    }
+
+    // Remove both ends, then land a new best below the old one
+    const std::vector<std::pair<double, double>> updates = {
+        {0.49, 0.0}, {0.40, 0.0}, {0.48, 0.0}, {0.46, 7.0}, {0.41, 3.0}};
+    for (auto [price, size] : updates) {
+        one_by_one.set(Price(price), Quantity(size));
+        batched.set_deferred(Price(price), Quantity(size));
+    }
+    batched.settle();
+
+    EXPECT_EQ(batched, one_by_one);
+    EXPECT_DOUBLE_EQ(batched.best_price().value(), 0.46);
+    EXPECT_EQ(std::vector<PriceLevel>(batched.begin(), batched.end()).back(),
+              PriceLevel(Price(0.41), Quantity(3.0)));
+}
+
+TEST(PriceLadder, DeferredRemovalOfEveryLevelLeavesItEmpty) {
+    PriceLadder asks(Side::SELL, Price(0.01));
+    asks.set(Price(0.52), Quantity(1.0));
+    asks.set(Price(0.55), Quantity(1.0));
+
+    asks.set_deferred(Price(0.52), Quantity::zero());
+    asks.set_deferred(Price(0.55), Quantity::zero());
+    asks.settle();
+
+    EXPECT_TRUE(asks.empty());
+    EXPECT_EQ(asks.begin(), asks.end());
+}
+
+TEST(PriceLadder, TracksTotalSizeAndSizeNearTheBest) {
+    PriceLadder asks(Side::SELL, Price(0.01));
+    EXPECT_EQ(asks.size_within(Price(1.0)), Quantity::zero());
+
+    asks.set(Price(0.52), Quantity(25.0));
+    asks.set(Price(0.54), Quantity(10.0));
+    asks.set(Price(0.60), Quantity(1.0));
+    asks.set(Price(0.54), Quantity(4.0));
+    EXPECT_EQ(asks.total_size(), Quantity(30.0));
+    EXPECT_EQ(asks.size_within(Price(0.02)), Quantity(29.0));
+    EXPECT_EQ(asks.size_within(Price(1.0)), Quantity(30.0));
+
+    asks.rebucket(Price(0.001));
+    EXPECT_EQ(asks.total_size(), Quantity(30.0));
+    asks.clear();
+    EXPECT_EQ(asks.total_size(), Quantity::zero());
+}
+
+TEST(PriceLadder, SideTypedLaddersMatchTheRuntimeSide) {
+    BidLadder bids(Price(0.01));
+    AskLadder asks(Price(0.01));
+    PriceLadder runtime_bids(Side::BUY, Price(0.01));
+    PriceLadder runtime_asks(Side::SELL, Price(0.01));
+
+    // Adds, resizes, removals of the best and worst, and an off-grid price
+    const std::vector<std::pair<double, double>> updates{
+        {0.40, 10.0}, {0.45, 5.0}, {0.30, 2.0}, {0.45, 0.0}, {0.405, 1.0},
+        {0.30, 0.0}, {0.50, 7.0}, {0.40, 3.0}, {0.50, 0.0},
+    };
+    for (const auto& [price, size] : updates) {
+        bids.set_deferred(Price(price), Quantity(size));
+        asks.set_deferred(Price(price), Quantity(size));
+        runtime_bids.set_deferred(Price(price), Quantity(size));
+        runtime_asks.set_deferred(Price(price), Quantity(size));
+    }
+    bids.settle();
+    asks.settle();
+    runtime_bids.settle();
+    runtime_asks.settle();
+
+    const PriceLadder& bid_view = bids;
+    EXPECT_EQ(bid_view, runtime_bids);
+    EXPECT_EQ(static_cast<const PriceLadder&>(asks), runtime_asks);
+    EXPECT_EQ(bids.best_price(), Price(0.405));
+    EXPECT_EQ(asks.best_price(), Price(0.40));
+    EXPECT_EQ(bids.ticks_per_unit(), 1000);
+}
+
+TEST(PriceLadder, CumulativeDepthMatchesSizeWithin) {
+    for (auto side : {Side::BUY, Side::SELL}) {
+        PriceLadder ladder(side, Price(0.01));
+        std::vector<Quantity> curve(60, Quantity::zero());
+        ladder.cumulative_depth(Price(0.01), curve);
+        EXPECT_EQ(curve.back(), Quantity::zero());
+
+        for (int tick = 20; tick <= 60; tick += 3) {
+            ladder.set(Price::from_micros(tick * 10'000), Quantity(static_cast<double>(tick)));
+        }
+        ladder.cumulative_depth(Price(0.01), curve);
+        for (size_t k = 0; k < curve.size(); ++k) {
+            EXPECT_EQ(curve[k], ladder.size_within(Price::from_micros(static_cast<int64_t>(k) * 10'000))) << k;
+        }
+        // Steps of two ticks
+        ladder.cumulative_depth(Price(0.02), curve);
+        EXPECT_EQ(curve[5], ladder.size_within(Price(0.10)));
+    }
+}
+
+TEST(PriceLadder, SweepTakesLevelsFromTheBestOutward) {
+    PriceLadder asks(Side::SELL, Price(0.01));
+    EXPECT_EQ(asks.sweep(Quantity(10.0)).filled, Quantity::zero());
+
+    // Levels spread over more than one block of slots
+    asks.set(Price(0.20), Quantity(10.0));
+    asks.set(Price(0.30), Quantity(10.0));
+    asks.set(Price(0.70), Quantity(10.0));
+
+    auto partial = asks.sweep(Quantity(15.0));
+    EXPECT_EQ(partial.filled, Quantity(15.0));
+    EXPECT_EQ(partial.notional, 3'500'000);  // 10 * 0.20 + 5 * 0.30
+    EXPECT_EQ(partial.average_price, Price::from_micros(233'333));
+    EXPECT_EQ(partial.worst_price, Price(0.30));
+
+    auto exact = asks.sweep(Quantity(20.0));
+    EXPECT_EQ(exact.worst_price, Price(0.30));
+    EXPECT_EQ(exact.average_price, Price(0.25));
+
+    // More than the side holds
+    auto all = asks.sweep(Quantity(100.0));
+    EXPECT_EQ(all.filled, Quantity(30.0));
+    EXPECT_EQ(all.notional, 12'000'000);
+    EXPECT_EQ(all.worst_price, Price(0.70));
+
+    PriceLadder bids(Side::BUY, Price(0.001));
+    bids.set(Price(0.455), Quantity(4.0));
+    bids.set(Price(0.300), Quantity(8.0));
+    bids.set(Price(0.010), Quantity(1.0));
+    auto sell = bids.sweep(Quantity(6.0));
+    EXPECT_EQ(sell.notional, 2'420'000);  // 4 * 0.455 + 2 * 0.30
+    EXPECT_EQ(sell.worst_price, Price(0.30));
+    EXPECT_EQ(bids.sweep(Quantity(13.0)).worst_price, Price(0.01));
+}
+
+TEST(PriceLadder, SweepOfManyMillionSharesDoesNotOverflow) {
+    // Units times micro-dollars is past int64 from about 9.2M shares
+    PriceLadder asks(Side::SELL, Price(0.01));
+    asks.set(Price(0.98), Quantity(30'000'000.0));
+    asks.set(Price(0.99), Quantity(30'000'000.0));
+
+    auto partial = asks.sweep(Quantity(40'000'000.0));
+    EXPECT_EQ(partial.filled, Quantity(40'000'000.0));
+    EXPECT_EQ(partial.notional, 39'300'000'000'000);  // 30M * 0.98 + 10M * 0.99
+    EXPECT_EQ(partial.average_price, Price(0.9825));
+
+    auto all = asks.sweep(Quantity(100'000'000.0));
+    EXPECT_EQ(all.notional, 59'100'000'000'000);
+    EXPECT_EQ(all.average_price, Price(0.985));
+    EXPECT_EQ(all.worst_price, Price(0.99));
+}
+
+TEST(PriceLadder, SweepOfBillionsOfSharesOnTheFinestGridDoesNotOverflow) {
+    // A block the fill passes whole: 9800 ticks times 1e15 units is past int64
+    PriceLadder asks(Side::SELL, Price(0.0001));
+    asks.set(Price(0.98), Quantity(1'000'000'000.0));
+    asks.set(Price(0.99), Quantity(1'000'000'000.0));
+
+    auto partial = asks.sweep(Quantity(1'500'000'000.0));
+    EXPECT_EQ(partial.notional, 1'475'000'000'000'000);  // 1e9 * 0.98 + 5e8 * 0.99
+    EXPECT_EQ(partial.average_price, Price::from_micros(983'333));
+    EXPECT_EQ(partial.worst_price, Price(0.99));
+}
+
+TEST(PriceLadder, RemovingUnknownLevelIsNoOp) {
+    PriceLadder bids(Side::BUY, Price(0.01));
+    bids.set(Price(0.48), Quantity(30.0));
+
+    bids.set(Price(0.47), Quantity(0.0));
+
+    EXPECT_EQ(bids.size(), 1u);
+}
+
+TEST(PriceLadder, IteratesFromBestToWorst) {
+    PriceLadder bids(Side::BUY, Price(0.01));
+    bids.set(Price(0.30), Quantity(10.0));
+    bids.set(Price(0.49), Quantity(20.0));
+    bids.set(Price(0.40), Quantity(15.0));
+
+    EXPECT_DOUBLE_EQ(bids[0].price().value(), 0.49);
+    EXPECT_DOUBLE_EQ(bids[1].price().value(), 0.40);
+    EXPECT_DOUBLE_EQ(bids[2].price().value(), 0.30);
+    EXPECT_THROW(bids[3], std::out_of_range);
+}
+
+TEST(PriceLadder, ClearRemovesAllLevels) {
+    PriceLadder asks(Side::SELL, Price(0.01));
+    asks.set(Price(0.52), Quantity(25.0));
+    asks.set(Price(0.60), Quantity(10.0));
+
+    asks.clear();
+
+    EXPECT_TRUE(asks.empty());
+    EXPECT_DOUBLE_EQ(asks.size_at(Price(0.52)).size(), 0.0);
+}
+
+// --- Tick grid ---
+
+TEST(PriceLadder, RebucketToFinerTickKeepsLevels) {
+    PriceLadder bids(Side::BUY, Price(0.01));
+    bids.set(Price(0.97), Quantity(30.0));
+
+    bids.rebucket(Price(0.001));
+    bids.set(Price(0.975), Quantity(5.0));
+
+    EXPECT_EQ(bids.ticks_per_unit(), 1000);
+    EXPECT_EQ(bids.size(), 2u);
+    EXPECT_DOUBLE_EQ(bids.best_price().value(), 0.975);
+    EXPECT_DOUBLE_EQ(bids.size_at(Price(0.97)).size(), 30.0);
+}
+
+TEST(PriceLadder, OffGridPriceRefinesGrid) {
+    PriceLadder asks(Side::SELL, Price(0.01));
+    asks.set(Price(0.52), Quantity(25.0));
+
+    asks.set(Price(0.515), Quantity(10.0));
+
+    EXPECT_EQ(asks.ticks_per_unit(), 1000);
+    EXPECT_DOUBLE_EQ(asks.best_price().value(), 0.515);
+    EXPECT_EQ(asks.size(), 2u);
+}
+
+TEST(PriceLadder, PriceFinerThanTheFinestGridIsSetAndRemovedAtTheSameSlot) {
+    PriceLadder asks(Side::SELL, Price(0.01));
+    asks.set(Price(0.52), Quantity(25.0));
+
+    asks.set(Price::from_micros(515'030), Quantity(10.0));
+    EXPECT_EQ(asks.ticks_per_unit(), 10000);
+    EXPECT_EQ(asks.best_price(), Price(0.515));
+    EXPECT_DOUBLE_EQ(asks.size_at(Price::from_micros(515'030)).size(), 10.0);
+
+    asks.set(Price::from_micros(515'030), Quantity(0.0));
+    EXPECT_EQ(asks.size(), 1u);
+    EXPECT_EQ(asks.best_price(), Price(0.52));
+}
+
+TEST(PriceLadder, RebucketToCoarserTickKeepsOffGridLevels) {
+    PriceLadder bids(Side::BUY, Price(0.001));
+    bids.set(Price(0.975), Quantity(5.0));
+    bids.set(Price(0.97), Quantity(30.0));
+
+    bids.rebucket(Price(0.01));
+
+    EXPECT_EQ(bids.size(), 2u);
+    EXPECT_DOUBLE_EQ(bids.best_price().value(), 0.975);
+}
+
+TEST(PriceLadder, EqualityComparesLevelsNotGrid) {
+    PriceLadder a(Side::BUY, Price(0.01));
+    PriceLadder b(Side::BUY, Price(0.001));
+    a.set(Price(0.48), Quantity(30.0));
+    b.set(Price(0.48), Quantity(30.0));
+
+    EXPECT_EQ(a, b);
+
+    b.set(Price(0.47), Quantity(1.0));
+    EXPECT_NE(a, b);
+}
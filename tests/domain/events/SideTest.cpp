@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 using mde::domain::Side;
+using mde::domain::parse_side;
 using mde::domain::side_from_string;
 
 TEST(Side, BuyAndSellAreDifferent) {
@@ -22,3 +23,16 @@ TEST(Side, FromStringThrowsOnInvalid) {
     EXPECT_THROW(side_from_string(""), std::invalid_argument);
     EXPECT_THROW(side_from_string("HOLD"), std::invalid_argument);
 }
+
+TEST(Side, ParseReportsErrorsWithoutThrowing) {
+    Side side = Side::SELL;
+    EXPECT_EQ(parse_side("BUY", side), std::errc{});
+    EXPECT_EQ(side, Side::BUY);
+    EXPECT_EQ(parse_side("SELL", side), std::errc{});
+    EXPECT_EQ(side, Side::SELL);
+
+    EXPECT_EQ(parse_side("BUYS", side), std::errc::invalid_argument);
+    EXPECT_EQ(parse_side("sell", side), std::errc::invalid_argument);
+    EXPECT_EQ(parse_side("", side), std::errc::invalid_argument);
+    EXPECT_EQ(side, Side::SELL);  // untouched on error
+}
@@ -0,0 +1,56 @@
+#include "domain/value_objects/AssetId.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_set>
+
+using mde::domain::AssetId;
+
+TEST(AssetId, InterningSameStringYieldsSameHandle) {
+    std::string token = "21742633143463906290569050155826241533067272736897614950488156847949938836455";
+    AssetId a(token);
+    AssetId b(std::string_view(token).substr(0));
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.index(), b.index());
+    EXPECT_EQ(&a.str(), &b.str());
+}
+
+TEST(AssetId, DistinctStringsGetDistinctIndices) {
+    AssetId a("asset-id-test-a");
+    AssetId b("asset-id-test-b");
+
+    EXPECT_NE(a, b);
+    EXPECT_NE(a.index(), b.index());
+}
+
+TEST(AssetId, ComparesAgainstStrings) {
+    AssetId id("6581861");
+
+    EXPECT_EQ(id, "6581861");
+    EXPECT_EQ(id, std::string("6581861"));
+    EXPECT_FALSE(id == "6581862");
+    EXPECT_EQ(id.str(), "6581861");
+}
+
+TEST(AssetId, OrdersLexicographically) {
+    // Interned in reverse order so index order disagrees with string order
+    AssetId z("asset-id-order-z");
+    AssetId a("asset-id-order-a");
+
+    EXPECT_LT(a, z);
+}
+
+TEST(AssetId, HashesByHandle) {
+    std::unordered_set<AssetId> set;
+    set.insert(AssetId("asset-id-hash"));
+    set.insert(AssetId(std::string("asset-id-hash")));
+
+    EXPECT_EQ(set.size(), 1u);
+}
+
+TEST(AssetId, EmptyStringIsInternable) {
+    AssetId empty("");
+    EXPECT_TRUE(empty.empty());
+}
@@ -81,3 +81,46 @@ TEST(Price, CopySemantics) {
     EXPECT_EQ(original, copy);
     EXPECT_DOUBLE_EQ(copy.value(), 0.75);
 }
+
+TEST(Price, StoresExactMicroUnits) {
+    EXPECT_EQ(Price(0.456).micros(), 456000);
+    EXPECT_EQ(Price::from_string("0.456").micros(), 456000);
+    EXPECT_EQ(Price::from_micros(456000), Price(0.456));
+}
+
+TEST(Price, FromStringIsExactWhereDoublesAreNot) {
+    // 0.1 + 0.2 != 0.3 in binary floating point; decimal parsing is exact
+    EXPECT_EQ(Price::from_string("0.3").micros(),
+              Price::from_string("0.1").micros() + Price::from_string("0.2").micros());
+}
+
+TEST(Price, FromStringParsesEdgeForms) {
+    EXPECT_EQ(Price::from_string("1").micros(), 1000000);
+    EXPECT_EQ(Price::from_string(".5").micros(), 500000);
+    EXPECT_EQ(Price::from_string("0.50").micros(), 500000);
+    EXPECT_EQ(Price::from_string("0.0000005").micros(), 1);  // rounds half up
+}
+
+TEST(Price, FromStringRejectsMalformedInput) {
+    EXPECT_THROW(Price::from_string(""), std::invalid_argument);
+    EXPECT_THROW(Price::from_string("."), std::invalid_argument);
+    EXPECT_THROW(Price::from_string("0.5x"), std::invalid_argument);
+    EXPECT_THROW(Price::from_string("5e-1"), std::invalid_argument);
+}
+
+TEST(Price, FromMicrosThrowsOutOfRange) {
+    EXPECT_THROW(Price::from_micros(-1), std::out_of_range);
+    EXPECT_THROW(Price::from_micros(1000001), std::out_of_range);
+}
+
+TEST(Price, ParseReportsErrorsWithoutThrowing) {
+    auto price = Price::zero();
+    EXPECT_EQ(Price::parse("0.456", price), std::errc{});
+    EXPECT_EQ(price.micros(), 456000);
+
+    EXPECT_EQ(Price::parse("abc", price), std::errc::invalid_argument);
+    EXPECT_EQ(Price::parse("", price), std::errc::invalid_argument);
+    EXPECT_EQ(Price::parse("1.5", price), std::errc::result_out_of_range);
+    EXPECT_EQ(Price::parse("-0.1", price), std::errc::result_out_of_range);
+    EXPECT_EQ(price.micros(), 456000);  // untouched on error
+}
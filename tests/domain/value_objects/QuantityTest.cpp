@@ -82,3 +82,30 @@ TEST(Quantity, CopySemantics) {
     EXPECT_EQ(original, copy);
     EXPECT_DOUBLE_EQ(copy.size(), 75.5);
 }
+
+TEST(Quantity, StoresExactMicroUnits) {
+    EXPECT_EQ(Quantity::from_string("219.217767").units(), 219217767);
+    EXPECT_EQ(Quantity(219.217767).units(), 219217767);
+    EXPECT_EQ(Quantity::from_units(30000000), Quantity(30.0));
+}
+
+TEST(Quantity, IsZero) {
+    EXPECT_TRUE(Quantity::zero().is_zero());
+    EXPECT_TRUE(Quantity::from_string("0.000").is_zero());
+    EXPECT_FALSE(Quantity::from_string("0.000001").is_zero());
+}
+
+TEST(Quantity, FromStringThrowsOnOverflow) {
+    EXPECT_THROW(Quantity::from_string("99999999999999999999"), std::out_of_range);
+}
+
+TEST(Quantity, ParseReportsErrorsWithoutThrowing) {
+    auto quantity = Quantity::zero();
+    EXPECT_EQ(Quantity::parse("219.217767", quantity), std::errc{});
+    EXPECT_EQ(quantity.units(), 219217767);
+
+    EXPECT_EQ(Quantity::parse("1,5", quantity), std::errc::invalid_argument);
+    EXPECT_EQ(Quantity::parse("-10", quantity), std::errc::result_out_of_range);
+    EXPECT_EQ(Quantity::parse("99999999999999999999", quantity), std::errc::result_out_of_range);
+    EXPECT_EQ(quantity.units(), 219217767);  // untouched on error
+}
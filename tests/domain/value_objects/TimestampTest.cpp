@@ -67,3 +67,16 @@ TEST(Timestamp, CopySemantics) {
     EXPECT_EQ(original, copy);
     EXPECT_EQ(copy.milliseconds(), 123456789000);
 }
+
+TEST(Timestamp, ParseReportsErrorsWithoutThrowing) {
+    Timestamp ts(7);
+    EXPECT_EQ(Timestamp::parse("1750428146322", ts), std::errc{});
+    EXPECT_EQ(ts.milliseconds(), 1750428146322);
+
+    EXPECT_EQ(Timestamp::parse("", ts), std::errc::invalid_argument);
+    EXPECT_EQ(Timestamp::parse("12a", ts), std::errc::invalid_argument);
+    EXPECT_EQ(Timestamp::parse(" 12", ts), std::errc::invalid_argument);
+    EXPECT_EQ(Timestamp::parse("-100", ts), std::errc::result_out_of_range);
+    EXPECT_EQ(Timestamp::parse("99999999999999999999", ts), std::errc::result_out_of_range);
+    EXPECT_EQ(ts.milliseconds(), 1750428146322);  // untouched on error
+}
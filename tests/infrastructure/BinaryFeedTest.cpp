@@ -0,0 +1,255 @@
+#include "infrastructure/BinaryFeed.hpp"
+#include "repositories/InMemoryOrderBookRepository.hpp"
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::infrastructure;
+using namespace mde::services;
+using mde::repositories::InMemoryOrderBookRepository;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+const MarketAsset kNo("0xbd31dc", "4815162");
+
+class SilentFeed : public IMarketDataFeed {
+public:
+    void set_on_event(EventCallback) override {}
+    void subscribe(const std::string&) override {}
+    void start() override {}
+    void stop() override {}
+};
+
+// A UDP socket on an ephemeral loopback port, standing in for subscribers
+class Capture {
+public:
+    Capture() : fd_(::socket(AF_INET, SOCK_DGRAM, 0)) {
+        sockaddr_in local{};
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(fd_, reinterpret_cast<const sockaddr*>(&local), sizeof(local));
+        socklen_t length = sizeof(local);
+        ::getsockname(fd_, reinterpret_cast<sockaddr*>(&local), &length);
+        port_ = ntohs(local.sin_port);
+        timeval timeout{2, 0};
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+    ~Capture() { ::close(fd_); }
+
+    uint16_t port() const { return port_; }
+
+    std::string next() {
+        std::string packet(binary::kMaxPacketBytes, '\0');
+        auto received = ::recv(fd_, packet.data(), packet.size(), 0);
+        packet.resize(received > 0 ? static_cast<size_t>(received) : 0);
+        return packet;
+    }
+
+private:
+    int fd_;
+    uint16_t port_{0};
+};
+
+// A loopback port free a moment ago, for a subscriber to bind
+uint16_t free_port() {
+    Capture probe;
+    return probe.port();
+}
+
+template <typename Predicate>
+bool eventually(Predicate predicate) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+BookSnapshot make_snapshot(const MarketAsset& asset) {
+    return BookSnapshot{{asset, Timestamp(1000), 0},
+                        {PriceLevel(Price(0.47), Quantity(10.0)), PriceLevel(Price(0.48), Quantity(30.0))},
+                        {PriceLevel(Price(0.52), Quantity(25.0)), PriceLevel(Price(0.53), Quantity(60.0))},
+                        "0xabc"};
+}
+
+BookDelta make_delta(const MarketAsset& asset, int64_t ts, Price price) {
+    return BookDelta{{asset, Timestamp(ts), 0},
+                     {PriceLevelDelta{asset.token(), price, Quantity(5.0), Side::BUY, price, Price(0.52)}}};
+}
+
+BinaryPublisherOptions loopback(uint16_t port, size_t retransmit_packets = 8192) {
+    BinaryPublisherOptions options;
+    options.group = "127.0.0.1";
+    options.port = port;
+    options.retransmit_packets = retransmit_packets;
+    options.recovery_host = "127.0.0.1";
+    options.recovery_port = 0;
+    return options;
+}
+
+BinarySubscriberOptions listening(uint16_t port, const BinaryPublisher& publisher) {
+    BinarySubscriberOptions options;
+    options.group = "127.0.0.1";
+    options.port = port;
+    options.recovery_port = publisher.recovery_port();
+    return options;
+}
+
+uint64_t sequence_of(const OrderBookEventVariant& event) {
+    return std::visit([](const auto& e) { return e.sequence_number; }, event);
+}
+
+class BinaryFeedTest : public ::testing::Test {
+protected:
+    InMemoryOrderBookRepository repo;
+    SilentFeed feed;
+    OrderBookService service{repo, feed, 0};
+
+    // Fed by the subscriber, to compare against `service`
+    InMemoryOrderBookRepository mirror_repo;
+    SilentFeed mirror_feed;
+    OrderBookService mirror{mirror_repo, mirror_feed, 0};
+
+    bool mirrored(const MarketAsset& asset) {
+        auto expected = service.get_top_levels(asset, 100);
+        auto actual = mirror.get_top_levels(asset, 100);
+        return expected && actual && actual->timestamp == expected->timestamp && actual->bids == expected->bids &&
+               actual->asks == expected->asks;
+    }
+};
+
+} // namespace
+
+TEST_F(BinaryFeedTest, SubscriberRebuildsThePublishersBooks) {
+    auto port = free_port();
+    BinaryPublisher publisher(service, loopback(port));
+    BinarySubscriber subscriber(listening(port, publisher));
+    subscriber.set_on_events([this](std::span<OrderBookEventVariant> events) { mirror.on_events(events); });
+    subscriber.start();
+    publisher.start();
+
+    service.on_event(make_snapshot(kYes));
+    service.on_event(make_snapshot(kNo));
+    for (int64_t ts = 2000; ts < 2050; ++ts) {
+        service.on_event(make_delta(kYes, ts, Price::from_micros(480000 + (ts % 10) * 1000)));
+    }
+    service.on_event(TradeEvent{{kNo, Timestamp(3000), 0}, Price(0.52), Quantity(1.0), Side::BUY, ""});
+
+    EXPECT_TRUE(eventually([&] { return mirrored(kYes) && mirrored(kNo); }));
+    publisher.stop();
+    subscriber.stop();
+    EXPECT_EQ(publisher.events_sent(), 53u);
+    EXPECT_EQ(subscriber.packets_lost(), 0u);
+    EXPECT_EQ(subscriber.malformed(), 0u);
+}
+
+TEST_F(BinaryFeedTest, LateSubscriberStartsFromASnapshot) {
+    auto port = free_port();
+    BinaryPublisher publisher(service, loopback(port));
+    publisher.start();
+    service.on_event(make_snapshot(kYes));
+    service.on_event(make_snapshot(kNo));
+    ASSERT_TRUE(eventually([&] { return publisher.last_sequence() > 0; }));
+
+    BinarySubscriber subscriber(listening(port, publisher));
+    subscriber.set_on_events([this](std::span<OrderBookEventVariant> events) { mirror.on_events(events); });
+    subscriber.start();
+    // kNo only ever reached the wire before the subscriber joined
+    service.on_event(make_delta(kYes, 2000, Price(0.49)));
+
+    EXPECT_TRUE(eventually([&] { return mirrored(kYes) && mirrored(kNo); }));
+    subscriber.stop();
+    EXPECT_EQ(subscriber.snapshots(), 1u);
+    EXPECT_EQ(publisher.snapshots_served(), 1u);
+}
+
+TEST_F(BinaryFeedTest, GapsAreFilledByRetransmit) {
+    Capture wire;
+    BinaryPublisher publisher(service, loopback(wire.port()));
+    publisher.start();
+    BinarySubscriber subscriber(listening(wire.port(), publisher));
+    std::vector<uint64_t> delivered;
+    subscriber.set_on_event([&](OrderBookEventVariant&& event) { delivered.push_back(sequence_of(event)); });
+
+    // One event per packet
+    auto emit = [&](OrderBookEventVariant event) {
+        auto before = publisher.last_sequence();
+        service.on_event(std::move(event));
+        EXPECT_TRUE(eventually([&] { return publisher.last_sequence() == before + 1; }));
+        return wire.next();
+    };
+
+    subscriber.handle_packet(emit(make_snapshot(kYes)));  // syncs from a snapshot
+    auto second = emit(make_delta(kYes, 2000, Price(0.49)));
+    emit(make_delta(kYes, 2001, Price(0.50)));            // lost
+    auto fourth = emit(make_delta(kYes, 2002, Price(0.51)));
+
+    subscriber.handle_packet(second);
+    subscriber.handle_packet(fourth);
+    subscriber.handle_packet(second);  // and a duplicate
+
+    EXPECT_EQ(delivered, (std::vector<uint64_t>{1, 2, 3, 4}));
+    EXPECT_EQ(subscriber.gaps(), 1u);
+    EXPECT_EQ(subscriber.packets_recovered(), 1u);
+    EXPECT_EQ(subscriber.packets_lost(), 0u);
+    EXPECT_EQ(subscriber.duplicates(), 2u);  // the first packet, covered by the snapshot, and the repeat
+    EXPECT_EQ(publisher.retransmits_served(), 1u);
+}
+
+TEST_F(BinaryFeedTest, FallsBackToASnapshotWhenTheGapIsNoLongerHeld) {
+    Capture wire;
+    BinaryPublisher publisher(service, loopback(wire.port(), 2));
+    publisher.start();
+    BinarySubscriber subscriber(listening(wire.port(), publisher));
+    subscriber.set_on_events([this](std::span<OrderBookEventVariant> events) { mirror.on_events(events); });
+
+    auto emit = [&](OrderBookEventVariant event) {
+        auto before = publisher.last_sequence();
+        service.on_event(std::move(event));
+        EXPECT_TRUE(eventually([&] { return publisher.last_sequence() == before + 1; }));
+        return wire.next();
+    };
+
+    subscriber.handle_packet(emit(make_snapshot(kYes)));
+    for (int64_t ts = 2000; ts < 2003; ++ts) emit(make_delta(kYes, ts, Price::from_micros(490000 + ts)));
+    subscriber.handle_packet(emit(make_delta(kYes, 2003, Price(0.51))));
+
+    EXPECT_TRUE(mirrored(kYes));
+    EXPECT_EQ(subscriber.gaps(), 1u);
+    EXPECT_EQ(subscriber.snapshots(), 2u);
+    EXPECT_EQ(subscriber.packets_lost(), 0u);
+}
+
+TEST(BinaryFeed, RejectsBadOptions) {
+    InMemoryOrderBookRepository repo;
+    SilentFeed feed;
+    OrderBookService service{repo, feed, 0};
+
+    auto options = loopback(20000);
+    options.group = "not-an-address";
+    EXPECT_THROW(BinaryPublisher(service, options), std::invalid_argument);
+    options = loopback(20000);
+    options.max_packet_bytes = 10;
+    EXPECT_THROW(BinaryPublisher(service, options), std::invalid_argument);
+    options = loopback(20000, 0);
+    EXPECT_THROW(BinaryPublisher(service, options), std::invalid_argument);
+
+    BinarySubscriberOptions subscriber;
+    subscriber.recovery_host = "localhost:1";
+    EXPECT_THROW(BinarySubscriber{subscriber}, std::invalid_argument);
+}
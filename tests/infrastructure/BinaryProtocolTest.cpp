@@ -0,0 +1,181 @@
+#include "infrastructure/BinaryProtocol.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::infrastructure::binary;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+const MarketAsset kNo("0xbd31dc", "4815162");
+
+std::vector<std::pair<uint32_t, OrderBookEventVariant>> decode(std::string_view packet, AssetDictionary& assets,
+                                                               DecodeResult* result = nullptr) {
+    std::vector<std::pair<uint32_t, OrderBookEventVariant>> events;
+    auto decoded = decode_packet(packet, assets, [&](uint32_t asset, OrderBookEventVariant&& event) {
+        events.emplace_back(asset, std::move(event));
+    });
+    if (result) *result = decoded;
+    return events;
+}
+
+} // namespace
+
+TEST(BinaryProtocol, EventsRoundTrip) {
+    PacketWriter writer;
+    writer.begin(77, 5);
+    ASSERT_TRUE(writer.add_definition(3, kYes));
+    ASSERT_TRUE(writer.add_event(3, BookSnapshot{{kYes, Timestamp(1000), 11},
+                                                 {PriceLevel(Price(0.48), Quantity(30.0))},
+                                                 {PriceLevel(Price(0.52), Quantity(25.5)),
+                                                  PriceLevel(Price(0.53), Quantity(60.0))},
+                                                 "0xabc"}));
+    ASSERT_TRUE(writer.add_event(3, BookDelta{{kYes, Timestamp(1001), 12},
+                                              {PriceLevelDelta{kYes.token(), Price(0.49), Quantity(5.0), Side::BUY,
+                                                               Price(0.49), Price(0.52)},
+                                               PriceLevelDelta{kYes.token(), Price(0.53), Quantity(0.0), Side::SELL,
+                                                               Price(0.49), Price(0.52)}}}));
+    ASSERT_TRUE(writer.add_event(3, TradeEvent{{kYes, Timestamp(1002), 13}, Price(0.52), Quantity(2.5), Side::SELL, "0"}));
+    ASSERT_TRUE(writer.add_event(3, TickSizeChange{{kYes, Timestamp(1003), 14}, Price(0.01), Price(0.001)}));
+    EXPECT_EQ(writer.message_count(), 5u);
+    auto packet = std::string(writer.finish());
+
+    auto header = read_header(packet);
+    ASSERT_TRUE(header);
+    EXPECT_EQ(header->session, 77u);
+    EXPECT_EQ(header->sequence, 5u);
+    EXPECT_EQ(header->message_count, 5u);
+    EXPECT_EQ(header->length, packet.size());
+
+    AssetDictionary assets;
+    DecodeResult result;
+    auto events = decode(packet, assets, &result);
+    EXPECT_TRUE(result.ok);
+    EXPECT_EQ(result.events, 4u);
+    EXPECT_EQ(result.skipped, 0u);
+    ASSERT_EQ(events.size(), 4u);
+    ASSERT_TRUE(assets.find(3));
+    EXPECT_EQ(*assets.find(3), kYes);
+
+    const auto& snapshot = std::get<BookSnapshot>(events[0].second);
+    EXPECT_EQ(events[0].first, 3u);
+    EXPECT_EQ(snapshot.asset, kYes);
+    EXPECT_EQ(snapshot.timestamp, Timestamp(1000));
+    EXPECT_EQ(snapshot.sequence_number, 11u);
+    ASSERT_EQ(snapshot.bids.size(), 1u);
+    EXPECT_EQ(snapshot.bids[0].price(), Price(0.48));
+    ASSERT_EQ(snapshot.asks.size(), 2u);
+    EXPECT_EQ(snapshot.asks[0].size(), Quantity(25.5));
+    EXPECT_EQ(snapshot.hash, "0xabc");
+
+    const auto& delta = std::get<BookDelta>(events[1].second);
+    ASSERT_EQ(delta.changes.size(), 2u);
+    EXPECT_EQ(delta.changes[0].asset_id, kYes.token());
+    EXPECT_EQ(delta.changes[0].price, Price(0.49));
+    EXPECT_EQ(delta.changes[0].side, Side::BUY);
+    EXPECT_EQ(delta.changes[1].new_size, Quantity(0.0));
+    EXPECT_EQ(delta.changes[1].side, Side::SELL);
+    EXPECT_EQ(delta.changes[1].best_ask, Price(0.52));
+
+    const auto& trade = std::get<TradeEvent>(events[2].second);
+    EXPECT_EQ(trade.price, Price(0.52));
+    EXPECT_EQ(trade.size, Quantity(2.5));
+    EXPECT_EQ(trade.side, Side::SELL);
+    EXPECT_EQ(trade.fee_rate_bps, "0");
+
+    const auto& tick = std::get<TickSizeChange>(events[3].second);
+    EXPECT_EQ(tick.sequence_number, 14u);
+    EXPECT_EQ(tick.new_tick_size, Price(0.001));
+}
+
+TEST(BinaryProtocol, FullPacketsRefuseMoreMessages) {
+    PacketWriter writer(200);
+    writer.begin(1, 1);
+    TradeEvent trade{{kYes, Timestamp(1000), 1}, Price(0.5), Quantity(1.0), Side::BUY, ""};
+    size_t added = 0;
+    while (writer.add_event(1, trade)) ++added;
+    EXPECT_EQ(added, (200 - kPacketHeaderBytes) / (kMessageHeaderBytes + 40));
+    EXPECT_LE(writer.finish().size(), 200u);
+
+    // The first message of a packet may go past the limit, up to a datagram
+    std::vector<PriceLevel> bids;
+    for (int i = 1; i <= 50; ++i) bids.emplace_back(Price::from_micros(i * 10000), Quantity(1.0));
+    writer.begin(1, 2);
+    EXPECT_TRUE(writer.add_event(1, BookSnapshot{{kYes, Timestamp(1000), 2}, bids, {}, ""}));
+    EXPECT_GT(writer.finish().size(), 200u);
+
+    std::vector<PriceLevel> huge(4100, PriceLevel(Price(0.5), Quantity(1.0)));
+    writer.begin(1, 3);
+    EXPECT_THROW(writer.add_event(1, BookSnapshot{{kYes, Timestamp(1000), 3}, huge, {}, ""}), std::length_error);
+    EXPECT_TRUE(writer.empty());
+}
+
+TEST(BinaryProtocol, SkipsEventsItCannotDecode) {
+    PacketWriter writer;
+    writer.begin(1, 1);
+    writer.add_definition(0, kNo);
+    writer.add_event(9, TradeEvent{{kYes, Timestamp(1000), 1}, Price(0.5), Quantity(1.0), Side::BUY, ""});
+    writer.add_event(0, TradeEvent{{kNo, Timestamp(1000), 2}, Price(0.5), Quantity(1.0), Side::BUY, ""});
+    auto packet = std::string(writer.finish());
+
+    // An out-of-range price in the last trade, after its message and event
+    // headers
+    auto last = packet.size() - (kMessageHeaderBytes + 40);
+    auto price_at = last + kMessageHeaderBytes + 16;
+    for (size_t i = 0; i < 8; ++i) packet[price_at + i] = static_cast<char>(0x7F);
+
+    AssetDictionary assets;
+    DecodeResult result;
+    auto events = decode(packet, assets, &result);
+    EXPECT_TRUE(result.ok);
+    EXPECT_EQ(result.events, 0u);
+    EXPECT_EQ(result.skipped, 2u);  // unknown id 9, and the bad price
+    EXPECT_EQ(assets.size(), 1u);
+}
+
+TEST(BinaryProtocol, RejectsMalformedPackets) {
+    PacketWriter writer;
+    writer.begin(1, 1);
+    writer.add_definition(0, kYes);
+    writer.add_event(0, TickSizeChange{{kYes, Timestamp(1000), 1}, Price(0.01), Price(0.001)});
+    auto packet = std::string(writer.finish());
+
+    AssetDictionary assets;
+    DecodeResult result;
+    decode(packet.substr(0, packet.size() - 1), assets, &result);
+    EXPECT_FALSE(result.ok);
+
+    auto bad_magic = packet;
+    bad_magic[0] = 'X';
+    EXPECT_FALSE(read_header(bad_magic));
+
+    // A message length that runs past the packet is caught before anything
+    // is delivered, definitions included
+    auto bad_length = packet;
+    bad_length[kPacketHeaderBytes + 1] = static_cast<char>(0x7F);
+    EXPECT_TRUE(decode(bad_length, assets, &result).empty());
+    EXPECT_FALSE(result.ok);
+    EXPECT_EQ(assets.size(), 0u);
+}
+
+TEST(BinaryProtocol, RecoveryRequestsRoundTrip) {
+    auto bytes = encode_request({RecoveryKind::retransmit, 42, 100, 120});
+    ASSERT_EQ(bytes.size(), kRecoveryRequestBytes);
+    auto request = read_request(bytes);
+    ASSERT_TRUE(request);
+    EXPECT_EQ(request->kind, RecoveryKind::retransmit);
+    EXPECT_EQ(request->session, 42u);
+    EXPECT_EQ(request->from, 100u);
+    EXPECT_EQ(request->to, 120u);
+
+    bytes[3] = 9;
+    EXPECT_FALSE(read_request(bytes));
+    EXPECT_FALSE(read_request("short"));
+}
@@ -0,0 +1,135 @@
+#include "infrastructure/FrameCapture.hpp"
+#include "infrastructure/PolymarketMessageParser.hpp"
+#include "infrastructure/ReplayFeed.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::infrastructure;
+using namespace std::chrono_literals;
+
+namespace {
+
+const char* const kTrade =
+    R"([{"event_type":"last_trade_price","market":"0xbd31dc","asset_id":"6581861",)"
+    R"("price":"0.50","size":"10","side":"BUY","timestamp":"1000"}])";
+
+class FrameCaptureTest : public ::testing::Test {
+protected:
+    std::filesystem::path path;
+
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+               ("mde_capture_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+};
+
+} // namespace
+
+TEST_F(FrameCaptureTest, RoundTripsFramesAndTimes) {
+    {
+        FrameWriter writer(path.string());
+        writer.write(1000ns, "first");
+        writer.write(2500ns, "");
+        writer.write(4000ns, kTrade);
+        EXPECT_EQ(writer.frames_written(), 3u);
+    }
+
+    FrameReader reader(path.string());
+    CapturedFrame frame;
+    ASSERT_TRUE(reader.next(frame));
+    EXPECT_EQ(frame.received, 1000ns);
+    EXPECT_EQ(frame.text, "first");
+    ASSERT_TRUE(reader.next(frame));
+    EXPECT_EQ(frame.received, 2500ns);
+    EXPECT_EQ(frame.text, "");
+    ASSERT_TRUE(reader.next(frame));
+    EXPECT_EQ(frame.text, kTrade);
+    EXPECT_FALSE(reader.next(frame));
+
+    reader.rewind();
+    ASSERT_TRUE(reader.next(frame));
+    EXPECT_EQ(frame.text, "first");
+}
+
+TEST_F(FrameCaptureTest, TruncatedLastRecordEndsTheCapture) {
+    {
+        FrameWriter writer(path.string());
+        writer.write(1ns, "kept");
+        writer.write(2ns, "cut short");
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+
+    FrameReader reader(path.string());
+    CapturedFrame frame;
+    ASSERT_TRUE(reader.next(frame));
+    EXPECT_EQ(frame.text, "kept");
+    EXPECT_FALSE(reader.next(frame));
+}
+
+TEST_F(FrameCaptureTest, RejectsFilesThatAreNotCaptures) {
+    EXPECT_THROW(FrameReader("/nonexistent/capture.bin"), std::runtime_error);
+    std::ofstream(path) << "[{\"event_type\":\"book\"}]\n";
+    EXPECT_THROW(FrameReader(path.string()), std::runtime_error);
+}
+
+TEST_F(FrameCaptureTest, ReplayFeedDeliversEveryFrameInOrder) {
+    {
+        FrameWriter writer(path.string());
+        writer.write(0ns, kTrade);
+        writer.write(1ms, "not json");
+        writer.write(2ms, kTrade);
+    }
+
+    ReplayFeed feed(path.string(), std::make_unique<PolymarketMessageParser>(), {0.0, 2});
+    std::vector<size_t> batches;
+    feed.set_on_events([&](std::span<OrderBookEventVariant> events) {
+        batches.push_back(events.size());
+        EXPECT_TRUE(std::holds_alternative<TradeEvent>(events[0]));
+    });
+    feed.start();
+    feed.wait();
+
+    EXPECT_TRUE(feed.finished());
+    EXPECT_EQ(batches, (std::vector<size_t>{1, 1, 1, 1}));
+    EXPECT_EQ(feed.frames_replayed(), 6u);
+    EXPECT_EQ(feed.events_replayed(), 4u);
+    EXPECT_EQ(feed.parse_failures(), 2u);
+}
+
+TEST_F(FrameCaptureTest, ReplayFeedKeepsTheRecordedPace) {
+    {
+        FrameWriter writer(path.string());
+        writer.write(0ns, kTrade);
+        writer.write(100ms, kTrade);
+    }
+
+    // At 4x the 100 ms gap takes 25 ms
+    ReplayFeed feed(path.string(), std::make_unique<PolymarketMessageParser>(), {4.0, 1});
+    feed.set_on_event([](OrderBookEventVariant&&) {});
+    auto started = std::chrono::steady_clock::now();
+    feed.run();
+    EXPECT_GE(std::chrono::steady_clock::now() - started, 25ms);
+    EXPECT_EQ(feed.events_replayed(), 2u);
+}
+
+TEST_F(FrameCaptureTest, ReplayFeedRejectsBadOptions) {
+    { FrameWriter writer(path.string()); }
+    EXPECT_THROW(ReplayFeed(path.string(), std::make_unique<PolymarketMessageParser>(), {-1.0, 1}),
+                 std::invalid_argument);
+    EXPECT_THROW(ReplayFeed(path.string(), std::make_unique<PolymarketMessageParser>(), {1.0, 0}),
+                 std::invalid_argument);
+}
@@ -5,7 +5,13 @@
 #include <arrow/io/api.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 using namespace mde::infrastructure;
@@ -21,6 +27,9 @@ public:
     void set_fake_ids(std::vector<std::string> ids) {
         fake_ids_ = std::move(ids);
     }
+    void set_fake_closed(std::vector<std::string> ids) {
+        fake_closed_ = std::move(ids);
+    }
 
 protected:
     std::vector<std::string> fetch_top_token_ids(int limit) const override {
@@ -28,8 +37,65 @@ protected:
         return {fake_ids_.begin(), fake_ids_.begin() + limit};
     }
 
+    std::vector<std::string> fetch_retired_token_ids(const std::vector<std::string>& token_ids) const override {
+        std::vector<std::string> closed;
+        for (const auto& id : token_ids) {
+            if (std::find(fake_closed_.begin(), fake_closed_.end(), id) != fake_closed_.end()) closed.push_back(id);
+        }
+        return closed;
+    }
+
 private:
     std::vector<std::string> fake_ids_;
+    std::vector<std::string> fake_closed_;
+};
+
+// Serves a listing of `markets` markets ranked by id, through the real
+// paging in fetch_top_token_ids
+class PagedDiscovery : public MarketDiscovery {
+public:
+    PagedDiscovery(const ApiSettings& api, const DiscoverySettings& discovery, int markets)
+        : MarketDiscovery(nullptr, api, discovery), markets_(markets) {}
+
+    std::vector<std::pair<int, int>> requests() const {
+        std::lock_guard lock(mutex_);
+        auto sorted = requests_;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted;
+    }
+    int most_in_flight() const {
+        std::lock_guard lock(mutex_);
+        return most_in_flight_;
+    }
+
+protected:
+    std::optional<std::string> fetch_page(int offset, int limit) const override {
+        {
+            std::lock_guard lock(mutex_);
+            most_in_flight_ = std::max(most_in_flight_, ++in_flight_);
+        }
+        // Long enough for the other workers to start theirs
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        {
+            std::lock_guard lock(mutex_);
+            requests_.emplace_back(offset, limit);
+            --in_flight_;
+        }
+        std::string body = "[";
+        for (int i = offset; i < std::min(offset + limit, markets_); ++i) {
+            if (i > offset) body += ",";
+            body += R"({"question":"q)" + std::to_string(i) + R"(","clobTokenIds":"[\"yes_)" + std::to_string(i) +
+                    R"(\", \"no_)" + std::to_string(i) + R"(\"]"})";
+        }
+        return body + "]";
+    }
+
+private:
+    int markets_;
+    mutable std::mutex mutex_;
+    mutable std::vector<std::pair<int, int>> requests_;
+    mutable int in_flight_{0};
+    mutable int most_in_flight_{0};
 };
 
 std::shared_ptr<arrow::fs::FileSystem> make_mock_fs() {
@@ -38,6 +104,22 @@ std::shared_ptr<arrow::fs::FileSystem> make_mock_fs() {
     return std::make_shared<arrow::fs::SubTreeFileSystem>("/", mock);
 }
 
+// Fails every write of a path starting with `prefix` while `fail` is set
+class FailingFileSystem : public arrow::fs::SubTreeFileSystem {
+public:
+    using SubTreeFileSystem::SubTreeFileSystem;
+    using SubTreeFileSystem::OpenOutputStream;
+
+    arrow::Result<std::shared_ptr<arrow::io::OutputStream>> OpenOutputStream(
+        const std::string& path, const std::shared_ptr<const arrow::KeyValueMetadata>& metadata) override {
+        if (fail && path.rfind(prefix, 0) == 0) return arrow::Status::IOError("disk full");
+        return SubTreeFileSystem::OpenOutputStream(path, metadata);
+    }
+
+    bool fail{true};
+    std::string prefix;
+};
+
 } // namespace
 
 TEST(MarketDiscovery, LoadFromEmptyFilesystem) {
@@ -184,3 +266,129 @@ TEST(MarketDiscovery, WorksWithNullFilesystem) {
     EXPECT_EQ(added, 2u);
     EXPECT_EQ(discovery.tracked_count(), 2u);
 }
+
+TEST(MarketDiscovery, ParsesTheYesTokenOfEachMarket) {
+    auto ids = MarketDiscovery::parse_token_ids(
+        R"([{"id":"1","clobTokenIds":"[\"111\", \"222\"]","outcomes":"[\"Yes\", \"No\"]"},)"
+        R"({"id":"2","events":[{"clobTokenIds":"[\"nested\"]"}]},)"
+        R"({"id":"3","clobTokenIds":["333","444"]},)"
+        R"({"id":"4","clobTokenIds":"[]"}])");
+    EXPECT_EQ(ids, (std::vector<std::string>{"111", "333"}));
+
+    EXPECT_TRUE(MarketDiscovery::parse_token_ids(R"({"clobTokenIds":"[\"1\"]"})").empty());
+    EXPECT_TRUE(MarketDiscovery::parse_token_ids(R"([{"clobTokenIds":"[\"1\"]"},)").empty());
+}
+
+TEST(MarketDiscovery, FetchesPagesConcurrentlyInRankOrder) {
+    ApiSettings api;
+    DiscoverySettings disc;
+    disc.markets_per_poll = 25;
+    disc.page_size = 10;
+    disc.fetch_concurrency = 3;
+
+    PagedDiscovery discovery(api, disc, 100);
+    std::vector<std::string> added;
+    discovery.poll([&](const std::vector<std::string>& new_ids) { added = new_ids; });
+
+    ASSERT_EQ(added.size(), 25u);
+    for (int i = 0; i < 25; ++i) EXPECT_EQ(added[static_cast<size_t>(i)], "yes_" + std::to_string(i));
+    EXPECT_EQ(discovery.requests(), (std::vector<std::pair<int, int>>{{0, 10}, {10, 10}, {20, 5}}));
+    EXPECT_GT(discovery.most_in_flight(), 1);
+}
+
+TEST(MarketDiscovery, PersistsPollsAsDeltasAndCompactsThem) {
+    auto fs = make_mock_fs();
+    ApiSettings api;
+    DiscoverySettings disc;
+    disc.max_tracked_markets = 1000;
+
+    FakeDiscovery d1(fs, api, disc);
+    for (int i = 0; i < 100; ++i) {
+        d1.set_fake_ids({"id_" + std::to_string(i)});
+        ASSERT_EQ(d1.poll(nullptr), 1u);
+    }
+
+    arrow::fs::FileSelector deltas;
+    deltas.base_dir = "tracked_markets.d";
+    deltas.allow_not_found = true;
+    auto files = fs->GetFileInfo(deltas).ValueOrDie();
+    EXPECT_LT(files.size(), 100u);  // folded into tracked_markets.json
+
+    FakeDiscovery d2(fs, api, disc);
+    d2.load();
+    EXPECT_EQ(d2.tracked_count(), 100u);
+
+    // Numbering carries on after a restart, so nothing is overwritten
+    d2.set_fake_ids({"id_100"});
+    d2.poll(nullptr);
+    FakeDiscovery d3(fs, api, disc);
+    d3.load();
+    EXPECT_EQ(d3.tracked_count(), 101u);
+}
+
+TEST(MarketDiscovery, CompactionThatFailsToWriteKeepsTheDeltas) {
+    auto mock = std::make_shared<arrow::fs::internal::MockFileSystem>(
+        arrow::fs::TimePoint(std::chrono::seconds(0)));
+    auto fs = std::make_shared<FailingFileSystem>("/", mock);
+    fs->prefix = "tracked_markets.json";
+    ApiSettings api;
+    DiscoverySettings disc;
+    disc.max_tracked_markets = 1000;
+
+    FakeDiscovery d1(fs, api, disc);
+    for (int i = 0; i < 100; ++i) {
+        d1.set_fake_ids({"id_" + std::to_string(i)});
+        ASSERT_EQ(d1.poll(nullptr), 1u);
+    }
+    EXPECT_FALSE(fs->GetFileInfo("tracked_markets.json").ValueOrDie().IsFile());
+
+    FakeDiscovery d2(fs, api, disc);
+    d2.load();
+    EXPECT_EQ(d2.tracked_count(), 100u);
+
+    // The next persist compacts once the base can be written
+    fs->fail = false;
+    d2.set_fake_ids({"id_100"});
+    d2.poll(nullptr);
+    arrow::fs::FileSelector deltas;
+    deltas.base_dir = "tracked_markets.d";
+    deltas.allow_not_found = true;
+    EXPECT_LT(fs->GetFileInfo(deltas).ValueOrDie().size(), 100u);
+    FakeDiscovery d3(fs, api, disc);
+    d3.load();
+    EXPECT_EQ(d3.tracked_count(), 101u);
+}
+
+TEST(MarketDiscovery, ParsesClosedMarkets) {
+    auto ids = MarketDiscovery::parse_retired_token_ids(
+        R"([{"clobTokenIds":"[\"1\"]","active":true,"closed":false},)"
+        R"({"clobTokenIds":"[\"2\"]","active":true,"closed":true},)"
+        R"({"clobTokenIds":"[\"3\"]","active":false,"closed":false},)"
+        R"({"clobTokenIds":"[\"4\"]","archived":true}])");
+    EXPECT_EQ(ids, (std::vector<std::string>{"2", "3", "4"}));
+}
+
+TEST(MarketDiscovery, RetiresClosedMarketsToFreeCapacity) {
+    auto fs = make_mock_fs();
+    ApiSettings api;
+    DiscoverySettings disc;
+    disc.max_tracked_markets = 2;
+
+    FakeDiscovery discovery(fs, api, disc);
+    discovery.set_fake_ids({"a", "b"});
+    discovery.poll(nullptr);
+    ASSERT_TRUE(discovery.at_capacity());
+
+    discovery.set_fake_closed({"a"});
+    discovery.set_fake_ids({"a", "c"});
+    std::vector<std::string> retired, added;
+    discovery.poll([&](const std::vector<std::string>& ids) { added = ids; },
+                   [&](const std::vector<std::string>& ids) { retired = ids; });
+    EXPECT_EQ(retired, std::vector<std::string>{"a"});
+    EXPECT_EQ(added, std::vector<std::string>{"c"});
+    EXPECT_EQ(discovery.tracked_token_ids(), (std::vector<std::string>{"b", "c"}));
+
+    FakeDiscovery restarted(fs, api, disc);
+    restarted.load();
+    EXPECT_EQ(restarted.tracked_token_ids(), (std::vector<std::string>{"b", "c"}));
+}
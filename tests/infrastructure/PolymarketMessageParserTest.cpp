@@ -65,6 +65,24 @@ TEST_F(ParserTest, ParsesBookSnapshotWithEmptyBook) {
     EXPECT_TRUE(snap.asks.empty());
 }
 
+TEST_F(ParserTest, ParsesBookSnapshotWithFieldsInAnyOrder) {
+    auto events = parser.parse(R"([{
+        "bids": [{"size": "30", "price": "0.48"}],
+        "asks": [],
+        "timestamp": "1000",
+        "asset_id": "6581861",
+        "market": "0xbd31dc",
+        "event_type": "book"
+    }])");
+
+    ASSERT_EQ(events.size(), 1);
+    auto& snap = std::get<BookSnapshot>(events[0]);
+    EXPECT_EQ(snap.asset.token_id(), "6581861");
+    EXPECT_TRUE(snap.hash.empty());
+    ASSERT_EQ(snap.bids.size(), 1);
+    EXPECT_EQ(snap.bids[0], PriceLevel(Price(0.48), Quantity(30.0)));
+}
+
 // --- BookDelta (price_change) ---
 
 TEST_F(ParserTest, ParsesPriceChange) {
@@ -206,7 +224,62 @@ TEST_F(ParserTest, HandlesNonArrayMessage) {
     EXPECT_TRUE(std::holds_alternative<TradeEvent>(events[0]));
 }
 
+TEST_F(ParserTest, SkipsUnknownNestedFields) {
+    auto events = parser.parse(R"([{
+        "event_type": "last_trade_price",
+        "extra": {"price": "0.99", "list": [{"size": "1"}, "x", 3]},
+        "asset_id": "6581861",
+        "market": "0xbd31dc",
+        "price": "0.50",
+        "side": "BUY",
+        "size": "100",
+        "timestamp": "1000",
+        "flags": [true, null, 1.5]
+    }])");
+
+    ASSERT_EQ(events.size(), 1);
+    auto& trade = std::get<TradeEvent>(events[0]);
+    EXPECT_EQ(trade.price, Price(0.50));
+    EXPECT_EQ(trade.size, Quantity(100.0));
+}
+
+TEST_F(ParserTest, DropsAMessageWithAMissingFieldAndKeepsNoEvents) {
+    mde::infrastructure::EventBatch batch;
+    const char* message = R"([
+        {"event_type": "tick_size_change", "asset_id": "1", "market": "0x", "old_tick_size": "0.01", "new_tick_size": "0.001", "timestamp": "1"},
+        {"event_type": "last_trade_price", "asset_id": "1", "market": "0x", "side": "BUY", "size": "1", "timestamp": "2"}
+    ])";
+    EXPECT_FALSE(parser.parse(message, batch));
+    EXPECT_TRUE(batch.empty());
+
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "book", "asset_id": "1", "market": "0x", "asks": [], "timestamp": "1"}])", batch));
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "price_change", "market": "0x", "timestamp": "2"}])", batch));
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST_F(ParserTest, DropsAMessageWithAMalformedFieldWithoutThrowing) {
+    mde::infrastructure::EventBatch batch;
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "last_trade_price", "asset_id": "1", "market": "0x", "price": "0.5", "side": "HOLD", "size": "1", "timestamp": "2"}])", batch));
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "tick_size_change", "asset_id": "1", "market": "0x", "old_tick_size": "0.01", "new_tick_size": "0.001", "timestamp": "yesterday"}])", batch));
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "book", "asset_id": "1", "market": "0x", "bids": [{"price": "1.5", "size": "1"}], "asks": [], "timestamp": "1"}])", batch));
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "price_change", "market": "0x", "timestamp": "2", "price_changes": [{"asset_id": "", "price": "0.5", "size": "10", "side": "BUY", "best_bid": "0.5", "best_ask": "0.52"}]}])", batch));
+    EXPECT_TRUE(batch.empty());
+}
+
 TEST_F(ParserTest, ReturnsEmptyOnMalformedJson) {
     auto events = parser.parse("not json");
     EXPECT_TRUE(events.empty());
+
+    // Events before the error are dropped too
+    EXPECT_TRUE(parser.parse(R"([{"event_type": "tick_size_change", "asset_id": "1", "market": "0x", "old_tick_size": "0.01", "new_tick_size": "0.001", "timestamp": "1"}, {)").empty());
+}
+
+TEST_F(ParserTest, ReportsWhetherTheMessageWasWellFormed) {
+    mde::infrastructure::EventBatch batch;
+    EXPECT_FALSE(parser.parse("not json", batch));
+    // Well-formed but of no interest: nothing to count as dropped
+    EXPECT_TRUE(parser.parse(R"([{"event_type": "unknown_type"}])", batch));
+    EXPECT_TRUE(batch.empty());
+    EXPECT_TRUE(parser.parse(R"([{"event_type": "tick_size_change", "asset_id": "1", "market": "0x", "old_tick_size": "0.01", "new_tick_size": "0.001", "timestamp": "1"}])", batch));
+    EXPECT_EQ(batch.size(), 1u);
 }
@@ -0,0 +1,215 @@
+#include "infrastructure/QueryServer.hpp"
+#include "infrastructure/LittleEndian.hpp"
+#include "repositories/InMemoryOrderBookRepository.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::infrastructure;
+using namespace mde::infrastructure::query;
+using namespace mde::services;
+using mde::repositories::InMemoryOrderBookRepository;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+const MarketAsset kNo("0xbd31dc", "4815162");
+
+class SilentFeed : public IMarketDataFeed {
+public:
+    void set_on_event(EventCallback) override {}
+    void subscribe(const std::string&) override {}
+    void start() override {}
+    void stop() override {}
+};
+
+template <typename Predicate>
+bool eventually(Predicate predicate) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+BookSnapshot make_snapshot(const MarketAsset& asset) {
+    return BookSnapshot{{asset, Timestamp(1000), 0},
+                        {PriceLevel(Price(0.47), Quantity(10.0)), PriceLevel(Price(0.48), Quantity(30.0))},
+                        {PriceLevel(Price(0.52), Quantity(25.0)), PriceLevel(Price(0.53), Quantity(60.0))},
+                        "0xabc"};
+}
+
+class QueryServerTest : public ::testing::Test {
+protected:
+    InMemoryOrderBookRepository repo;
+    SilentFeed feed;
+    OrderBookService service{repo, feed, 0};
+    QueryServer server{service, local()};
+
+    void SetUp() override {
+        service.on_event(make_snapshot(kYes));
+        server.start();
+    }
+
+    QueryClient client() { return QueryClient("127.0.0.1", server.port()); }
+
+    static QueryServerOptions local() {
+        QueryServerOptions options;
+        options.host = "127.0.0.1";
+        options.port = 0;
+        return options;
+    }
+};
+
+} // namespace
+
+TEST_F(QueryServerTest, AnswersBookSpreadAndMidpointInOneRequest) {
+    std::vector<Query> queries{{QueryKind::book, kYes.token_id(), 0},
+                               {QueryKind::spread, kYes.token_id(), 0},
+                               {QueryKind::midpoint, kYes.token_id(), 0}};
+    auto response = client().query(queries);
+
+    ASSERT_EQ(response.results.size(), 3u);
+    const auto& book = response.results[0];
+    EXPECT_EQ(book.status, Status::ok);
+    EXPECT_EQ(book.timestamp, Timestamp(1000));
+    EXPECT_EQ(book.bids, (std::vector<PriceLevel>{PriceLevel(Price(0.48), Quantity(30.0)),
+                                                  PriceLevel(Price(0.47), Quantity(10.0))}));
+    EXPECT_EQ(book.asks, (std::vector<PriceLevel>{PriceLevel(Price(0.52), Quantity(25.0)),
+                                                  PriceLevel(Price(0.53), Quantity(60.0))}));
+
+    ASSERT_EQ(response.results[1].status, Status::ok);
+    EXPECT_EQ(response.results[1].spread->best_bid, Price(0.48));
+    EXPECT_EQ(response.results[1].spread->best_ask, Price(0.52));
+    ASSERT_EQ(response.results[2].status, Status::ok);
+    EXPECT_EQ(*response.results[2].midpoint, Price(0.50));
+    EXPECT_EQ(server.queries_served(), 3u);
+}
+
+TEST_F(QueryServerTest, DepthLimitsTheLevelsPerSide) {
+    std::vector<Query> queries{{QueryKind::book, kYes.token_id(), 1}};
+    auto response = client().query(queries);
+
+    ASSERT_EQ(response.results[0].status, Status::ok);
+    EXPECT_EQ(response.results[0].bids, (std::vector<PriceLevel>{PriceLevel(Price(0.48), Quantity(30.0))}));
+    EXPECT_EQ(response.results[0].asks, (std::vector<PriceLevel>{PriceLevel(Price(0.52), Quantity(25.0))}));
+}
+
+TEST_F(QueryServerTest, ReportsUnknownAssetsAndOneSidedBooks) {
+    service.on_event(BookSnapshot{{kNo, Timestamp(1000), 0}, {PriceLevel(Price(0.40), Quantity(5.0))}, {}, ""});
+    std::vector<Query> queries{{QueryKind::book, "999", 0},
+                               {QueryKind::spread, kNo.token_id(), 0},
+                               {QueryKind::midpoint, kNo.token_id(), 0},
+                               {QueryKind::book, kNo.token_id(), 0}};
+    auto response = client().query(queries);
+
+    EXPECT_EQ(response.results[0].status, Status::unknown_asset);
+    EXPECT_EQ(response.results[1].status, Status::one_sided);
+    EXPECT_EQ(response.results[2].status, Status::one_sided);
+    ASSERT_EQ(response.results[3].status, Status::ok);
+    EXPECT_EQ(response.results[3].bids.size(), 1u);
+    EXPECT_TRUE(response.results[3].asks.empty());
+}
+
+TEST_F(QueryServerTest, ServesLargeBatchesAndSeesNewEvents) {
+    auto connection = client();
+    std::vector<Query> queries(5000, Query{QueryKind::book, kYes.token_id(), 0});
+    auto response = connection.query(queries);
+    ASSERT_EQ(response.results.size(), 5000u);
+    EXPECT_EQ(response.results.back().bids.size(), 2u);
+
+    service.on_event(BookDelta{{kYes, Timestamp(2000), 0},
+                               {PriceLevelDelta{kYes.token(), Price(0.49), Quantity(5.0), Side::BUY, Price(0.49),
+                                                Price(0.52)}}});
+    std::vector<Query> midpoint{{QueryKind::midpoint, kYes.token_id(), 0}};
+    EXPECT_EQ(*connection.query(midpoint).results[0].midpoint, Price(0.505));
+}
+
+TEST_F(QueryServerTest, ServesConcurrentClients) {
+    std::vector<std::thread> clients;
+    std::atomic<int> correct{0};
+    for (int i = 0; i < 8; ++i) {
+        clients.emplace_back([&] {
+            auto connection = client();
+            std::vector<Query> queries{{QueryKind::spread, kYes.token_id(), 0}};
+            for (int request = 0; request < 100; ++request) {
+                if (connection.query(queries).results[0].spread->best_bid == Price(0.48)) ++correct;
+            }
+        });
+    }
+    for (auto& thread : clients) thread.join();
+    EXPECT_EQ(correct.load(), 800);
+    EXPECT_EQ(server.requests_served(), 800u);
+    EXPECT_EQ(server.connections_accepted(), 8u);
+}
+
+TEST_F(QueryServerTest, AnswersPipelinedRequestsInOrder) {
+    auto socket = net::open_socket(SOCK_STREAM, "test client");
+    auto address = net::endpoint(net::parse_address("127.0.0.1", "test"), server.port());
+    ASSERT_EQ(::connect(socket.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    net::set_timeouts(socket.get(), std::chrono::seconds(2));
+
+    std::vector<Query> queries{{QueryKind::midpoint, kYes.token_id(), 0}};
+    std::string requests;
+    for (uint32_t id = 1; id <= 3; ++id) requests += encode_request(id, queries);
+    ASSERT_TRUE(net::send_all(socket.get(), requests.data(), requests.size()));
+
+    for (uint32_t id = 1; id <= 3; ++id) {
+        char prefix[kFrameHeaderBytes];
+        ASSERT_TRUE(net::receive_all(socket.get(), prefix, sizeof(prefix)));
+        std::string body(little_endian::load<uint32_t>(prefix), '\0');
+        ASSERT_TRUE(net::receive_all(socket.get(), body.data(), body.size()));
+        auto response = read_response(body);
+        ASSERT_TRUE(response);
+        EXPECT_EQ(response->request_id, id);
+    }
+}
+
+TEST_F(QueryServerTest, MalformedRequestClosesTheConnection) {
+    auto socket = net::open_socket(SOCK_STREAM, "test client");
+    auto address = net::endpoint(net::parse_address("127.0.0.1", "test"), server.port());
+    ASSERT_EQ(::connect(socket.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    net::set_timeouts(socket.get(), std::chrono::seconds(2));
+
+    std::vector<Query> queries{{QueryKind::spread, kYes.token_id(), 0}};
+    auto request = encode_request(1, queries);
+    request[kFrameHeaderBytes] = 'X';  // bad magic
+    ASSERT_TRUE(net::send_all(socket.get(), request.data(), request.size()));
+
+    char byte;
+    EXPECT_FALSE(net::receive_all(socket.get(), &byte, 1));
+    EXPECT_TRUE(eventually([&] { return server.bad_requests() == 1 && server.connections_open() == 0; }));
+    // Other clients are unaffected
+    EXPECT_EQ(client().query(queries).results[0].status, Status::ok);
+}
+
+TEST(QueryProtocolTest, RejectsTruncatedAndTrailingBodies) {
+    std::vector<Query> queries{{QueryKind::book, "6581861", 5}};
+    auto frame = encode_request(7, queries);
+    std::string_view body = std::string_view(frame).substr(kFrameHeaderBytes);
+    std::vector<QueryView> parsed;
+
+    ASSERT_EQ(read_request(body, parsed), 7u);
+    ASSERT_EQ(parsed.size(), 1u);
+    EXPECT_EQ(parsed[0].token_id, "6581861");
+    EXPECT_EQ(parsed[0].depth, 5u);
+    EXPECT_FALSE(read_request(body.substr(0, body.size() - 1), parsed));
+    EXPECT_FALSE(read_request(std::string(body) + "x", parsed));
+}
+
+TEST(QueryServerOptionsTest, RejectsBadOptions) {
+    QueryServerOptions options;
+    options.host = "not-an-address";
+    EXPECT_THROW(validate(options), std::invalid_argument);
+    options.host = "127.0.0.1";
+    options.threads = 0;
+    EXPECT_THROW(validate(options), std::invalid_argument);
+}
@@ -0,0 +1,115 @@
+#include "infrastructure/SharedBookRegion.hpp"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+using namespace mde::domain;
+using namespace mde::infrastructure;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+const MarketAsset kNo("0xbd31dc", "4815162");
+
+std::string region_name() {
+    return "/mde_test_books_" + std::to_string(::getpid());
+}
+
+OrderBook make_book(const MarketAsset& asset, uint64_t seq, Price best_bid) {
+    return OrderBook::empty(asset).apply(BookSnapshot{
+        {asset, Timestamp(1000), seq},
+        {PriceLevel(Price(0.40), Quantity(5.0)), PriceLevel(Price(0.45), Quantity(30.0)),
+         PriceLevel(best_bid, Quantity(20.0))},
+        {PriceLevel(Price(0.52), Quantity(25.0)), PriceLevel(Price(0.53), Quantity(60.0))},
+        "0xabc"});
+}
+
+} // namespace
+
+TEST(SharedBookRegion, ReaderSeesTheTopLevelsOfEachPublishedBook) {
+    SharedBookPublisher publisher({region_name(), 8, 2});
+    SharedBookReader reader(region_name());
+    EXPECT_EQ(reader.slot_count(), 8u);
+    EXPECT_EQ(reader.depth(), 2u);
+    EXPECT_FALSE(reader.find("6581861"));
+
+    EXPECT_TRUE(publisher.publish(make_book(kYes, 7, Price(0.48))));
+    EXPECT_TRUE(publisher.publish(make_book(kNo, 8, Price(0.46)), /*stale=*/true));
+    EXPECT_EQ(publisher.slots_used(), 2u);
+
+    auto yes = reader.read("6581861");
+    ASSERT_TRUE(yes);
+    EXPECT_EQ(yes->token, "6581861");
+    EXPECT_EQ(yes->last_sequence_number, 7u);
+    EXPECT_EQ(yes->timestamp_ms, 1000);
+    EXPECT_FALSE(yes->stale);
+    ASSERT_EQ(yes->bids.size(), 2u);  // depth-limited, best first
+    EXPECT_EQ(yes->bids[0].price, Price(0.48).micros());
+    EXPECT_EQ(yes->bids[0].size, Quantity(20.0).units());
+    EXPECT_EQ(yes->bids[1].price, Price(0.45).micros());
+    ASSERT_EQ(yes->asks.size(), 2u);
+    EXPECT_EQ(yes->asks[0].price, Price(0.52).micros());
+
+    auto no = reader.read("4815162");
+    ASSERT_TRUE(no);
+    EXPECT_TRUE(no->stale);
+    EXPECT_EQ(no->bids[0].price, Price(0.46).micros());
+
+    // Updates land in the same slot under a newer version
+    auto slot = reader.find("6581861");
+    ASSERT_TRUE(slot);
+    publisher.publish(make_book(kYes, 9, Price(0.49)));
+    SharedBook book;
+    ASSERT_TRUE(reader.read(*slot, book));
+    EXPECT_GT(book.version, yes->version);
+    EXPECT_EQ(book.last_sequence_number, 9u);
+    EXPECT_EQ(book.bids[0].price, Price(0.49).micros());
+}
+
+TEST(SharedBookRegion, RejectsAssetsOnceFull) {
+    SharedBookPublisher publisher({region_name(), 1, 1});
+    EXPECT_TRUE(publisher.publish(make_book(kYes, 1, Price(0.48))));
+    EXPECT_FALSE(publisher.publish(make_book(kNo, 2, Price(0.30))));
+    EXPECT_TRUE(publisher.publish(make_book(kYes, 3, Price(0.48))));
+    EXPECT_EQ(publisher.rejected(), 1u);
+    EXPECT_EQ(publisher.slots_used(), 1u);
+}
+
+TEST(SharedBookRegion, ReadsAreNeverTorn) {
+    SharedBookPublisher publisher({region_name(), 4, 3});
+    publisher.publish(make_book(kYes, 0, Price(0.46)));
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (uint64_t seq = 1; seq <= 20000; ++seq) {
+            // The sequence number and the best bid always move together
+            publisher.publish(make_book(kYes, seq, seq % 2 ? Price(0.47) : Price(0.46)));
+        }
+        done.store(true);
+    });
+
+    SharedBookReader reader(region_name());
+    auto slot = reader.find("6581861");
+    ASSERT_TRUE(slot);
+    SharedBook book;
+    while (!done.load()) {
+        ASSERT_TRUE(reader.read(*slot, book));
+        EXPECT_EQ(book.bids[0].price, (book.last_sequence_number % 2 ? Price(0.47) : Price(0.46)).micros());
+        EXPECT_EQ(book.bids.size(), 3u);
+    }
+    writer.join();
+}
+
+TEST(SharedBookRegion, RejectsBadOptionsAndMissingRegions) {
+    EXPECT_THROW(SharedBookPublisher({"", 8, 2}), std::invalid_argument);
+    EXPECT_THROW(SharedBookPublisher({region_name(), 0, 2}), std::invalid_argument);
+    EXPECT_THROW(SharedBookPublisher({region_name(), 8, 0}), std::invalid_argument);
+    EXPECT_THROW(SharedBookReader(region_name() + "_missing"), std::system_error);
+}
@@ -0,0 +1,221 @@
+#include "infrastructure/MessageParserFactory.hpp"
+#include "infrastructure/PolymarketMessageParser.hpp"
+#include "infrastructure/SimdjsonMessageParser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace mde::domain;
+using mde::infrastructure::PolymarketMessageParser;
+using mde::infrastructure::SimdjsonMessageParser;
+
+namespace {
+
+void expect_same_header(const OrderBookEvent& a, const OrderBookEvent& b) {
+    EXPECT_EQ(a.asset, b.asset);
+    EXPECT_EQ(a.timestamp.milliseconds(), b.timestamp.milliseconds());
+    EXPECT_EQ(a.sequence_number, b.sequence_number);
+}
+
+void expect_same_event(const OrderBookEventVariant& a, const OrderBookEventVariant& b) {
+    ASSERT_EQ(a.index(), b.index());
+    if (auto* snap = std::get_if<BookSnapshot>(&a)) {
+        const auto& other = std::get<BookSnapshot>(b);
+        expect_same_header(*snap, other);
+        EXPECT_EQ(snap->bids, other.bids);
+        EXPECT_EQ(snap->asks, other.asks);
+        EXPECT_EQ(snap->hash, other.hash);
+    } else if (auto* delta = std::get_if<BookDelta>(&a)) {
+        const auto& other = std::get<BookDelta>(b);
+        expect_same_header(*delta, other);
+        ASSERT_EQ(delta->changes.size(), other.changes.size());
+        for (size_t i = 0; i < delta->changes.size(); ++i) {
+            EXPECT_EQ(delta->changes[i].asset_id, other.changes[i].asset_id);
+            EXPECT_EQ(delta->changes[i].price, other.changes[i].price);
+            EXPECT_EQ(delta->changes[i].new_size, other.changes[i].new_size);
+            EXPECT_EQ(delta->changes[i].side, other.changes[i].side);
+            EXPECT_EQ(delta->changes[i].best_bid, other.changes[i].best_bid);
+            EXPECT_EQ(delta->changes[i].best_ask, other.changes[i].best_ask);
+        }
+    } else if (auto* trade = std::get_if<TradeEvent>(&a)) {
+        const auto& other = std::get<TradeEvent>(b);
+        expect_same_header(*trade, other);
+        EXPECT_EQ(trade->price, other.price);
+        EXPECT_EQ(trade->size, other.size);
+        EXPECT_EQ(trade->side, other.side);
+        EXPECT_EQ(trade->fee_rate_bps, other.fee_rate_bps);
+    } else if (auto* tick = std::get_if<TickSizeChange>(&a)) {
+        const auto& other = std::get<TickSizeChange>(b);
+        expect_same_header(*tick, other);
+        EXPECT_EQ(tick->old_tick_size, other.old_tick_size);
+        EXPECT_EQ(tick->new_tick_size, other.new_tick_size);
+    }
+}
+
+} // namespace
+
+class SimdjsonParserTest : public ::testing::Test {
+protected:
+    SimdjsonMessageParser parser;
+    PolymarketMessageParser reference;
+
+    void expect_matches_reference(const std::string& message) {
+        auto expected = reference.parse(message);
+        auto actual = parser.parse(message);
+        ASSERT_EQ(actual.size(), expected.size()) << message;
+        for (size_t i = 0; i < actual.size(); ++i) {
+            expect_same_event(actual[i], expected[i]);
+        }
+    }
+};
+
+TEST_F(SimdjsonParserTest, MatchesReferenceForEveryEventType) {
+    expect_matches_reference(R"([{
+        "event_type": "book", "asset_id": "6581861", "market": "0xbd31dc",
+        "bids": [{"price": "0.48", "size": "30"}, {"price": "0.49", "size": "20"}],
+        "asks": [{"price": "0.52", "size": "25"}, {"price": "0.53", "size": "60.5"}],
+        "timestamp": "1750428146322", "hash": "0xabc123"
+    }])");
+    expect_matches_reference(R"({
+        "event_type": "price_change", "market": "0xbd31dc", "timestamp": "1000",
+        "price_changes": [
+            {"asset_id": "222", "price": "0.4", "size": "50", "side": "SELL", "hash": "", "best_bid": "0.3", "best_ask": "0.4"},
+            {"asset_id": "111", "price": "0.5", "size": "100", "side": "BUY", "hash": "", "best_bid": "0.5", "best_ask": "0.6"},
+            {"asset_id": "111", "price": "0.49", "size": "0", "side": "BUY", "hash": "", "best_bid": "0.5", "best_ask": "0.6"}
+        ]
+    })");
+    expect_matches_reference(R"([{
+        "event_type": "last_trade_price", "asset_id": "6581861", "market": "0xbd31dc",
+        "price": "0.456", "side": "BUY", "size": "219.217767", "fee_rate_bps": "200",
+        "timestamp": "1750428146322"
+    }])");
+    expect_matches_reference(R"([{
+        "event_type": "tick_size_change", "asset_id": "6581861", "market": "0xbd31dc",
+        "old_tick_size": "0.01", "new_tick_size": "0.001", "timestamp": "100000000"
+    }])");
+}
+
+TEST_F(SimdjsonParserTest, HandlesFieldsInAnyOrder) {
+    auto events = parser.parse(R"([{
+        "timestamp": "5000", "size": "100", "side": "SELL", "price": "0.50",
+        "market": "0xbd31dc", "asset_id": "6581861", "event_type": "last_trade_price"
+    }])");
+
+    ASSERT_EQ(events.size(), 1);
+    auto& trade = std::get<TradeEvent>(events[0]);
+    EXPECT_EQ(trade.price.micros(), 500'000);
+    EXPECT_EQ(trade.side, Side::SELL);
+    EXPECT_EQ(trade.fee_rate_bps, "0");
+}
+
+TEST_F(SimdjsonParserTest, ParsesMultipleObjectsInOneMessage) {
+    expect_matches_reference(R"([
+        {"event_type": "book", "asset_id": "111", "market": "0xm", "bids": [], "asks": [], "timestamp": "1"},
+        {"event_type": "unknown"},
+        {"foo": "bar"},
+        42,
+        {"event_type": "book", "asset_id": "222", "market": "0xm", "bids": [{"price": "0.1", "size": "7"}], "asks": [], "timestamp": "2"}
+    ])");
+}
+
+TEST_F(SimdjsonParserTest, ReusesBufferAcrossMessagesOfDifferentLengths) {
+    std::string long_msg = R"([{"event_type": "last_trade_price", "asset_id": "6581861", "market": "0xbd31dc", "price": "0.50", "side": "BUY", "size": "100", "fee_rate_bps": "0", "timestamp": "1000"}])";
+    std::string short_msg = R"([{"event_type": "book", "asset_id": "1", "market": "0x", "bids": [], "asks": [], "timestamp": "1"}])";
+
+    EXPECT_EQ(parser.parse(long_msg).size(), 1);
+    auto events = parser.parse(short_msg);
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_TRUE(std::holds_alternative<BookSnapshot>(events[0]));
+}
+
+TEST_F(SimdjsonParserTest, ReturnsEmptyOnMalformedJson) {
+    EXPECT_TRUE(parser.parse("not json").empty());
+    EXPECT_TRUE(parser.parse(R"([{"event_type": "book", "asset_id": )").empty());
+    EXPECT_TRUE(parser.parse("").empty());
+
+    mde::infrastructure::EventBatch batch;
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "book", "asset_id": )", batch));
+    EXPECT_TRUE(parser.parse(R"([{"event_type": "unknown_type"}])", batch));
+}
+
+TEST_F(SimdjsonParserTest, DropsAMessageWithAMissingOrMalformedFieldWithoutThrowing) {
+    mde::infrastructure::EventBatch batch;
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "tick_size_change", "asset_id": "1", "market": "0x", "old_tick_size": "0.01", "new_tick_size": "0.001", "timestamp": "1"}, {"event_type": "last_trade_price", "asset_id": "1", "market": "0x", "side": "BUY", "size": "1", "timestamp": "2"}])", batch));
+    EXPECT_TRUE(batch.empty());
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "last_trade_price", "asset_id": "1", "market": "0x", "price": "0.5", "side": "HOLD", "size": "1", "timestamp": "2"}])", batch));
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "tick_size_change", "asset_id": "1", "market": "0x", "old_tick_size": "0.01", "new_tick_size": "0.001", "timestamp": "yesterday"}])", batch));
+    EXPECT_FALSE(parser.parse(R"([{"event_type": "book", "asset_id": "1", "market": "0x", "bids": [{"price": "1.5", "size": "1"}], "asks": [], "timestamp": "1"}])", batch));
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST_F(SimdjsonParserTest, BothBackendsDropEventsMissingTheirLevels) {
+    const std::string messages[] = {
+        R"([{"event_type": "book", "asset_id": "1", "market": "0x", "asks": [], "timestamp": "1"}])",
+        R"([{"event_type": "book", "asset_id": "1", "market": "0x", "bids": [], "timestamp": "1"}])",
+        R"([{"event_type": "book", "asset_id": "1", "market": "0x", "bids": null, "asks": [], "timestamp": "1"}])",
+        R"([{"event_type": "price_change", "market": "0x", "timestamp": "2"}])",
+    };
+    for (mde::infrastructure::IMessageParser* backend :
+         {static_cast<mde::infrastructure::IMessageParser*>(&parser),
+          static_cast<mde::infrastructure::IMessageParser*>(&reference)}) {
+        for (const auto& message : messages) {
+            mde::infrastructure::EventBatch batch;
+            EXPECT_FALSE(backend->parse(message, batch)) << message;
+            EXPECT_TRUE(batch.empty()) << message;
+        }
+    }
+}
+
+TEST_F(SimdjsonParserTest, ReusedBatchHoldsOnlyTheLatestMessage) {
+    std::string deep = R"([{"event_type": "book", "asset_id": "1", "market": "0x", "bids": [{"price": "0.48", "size": "30"}, {"price": "0.49", "size": "20"}], "asks": [], "timestamp": "1", "hash": "0xa"}, {"event_type": "price_change", "market": "0x", "timestamp": "2", "price_changes": [{"asset_id": "1", "price": "0.5", "size": "10", "side": "BUY", "best_bid": "0.5", "best_ask": "0.52"}, {"asset_id": "2", "price": "0.5", "size": "10", "side": "SELL", "best_bid": "0.48", "best_ask": "0.5"}]}])";
+    std::string shallow = R"([{"event_type": "book", "asset_id": "1", "market": "0x", "bids": [{"price": "0.47", "size": "5"}], "asks": [], "timestamp": "3"}])";
+
+    for (mde::infrastructure::IMessageParser* backend :
+         {static_cast<mde::infrastructure::IMessageParser*>(&parser),
+          static_cast<mde::infrastructure::IMessageParser*>(&reference)}) {
+        mde::infrastructure::EventBatch batch;
+        backend->parse(deep, batch);
+        ASSERT_EQ(batch.size(), 3);
+        EXPECT_EQ(std::get<BookDelta>(batch[1]).changes.size(), 1);
+
+        // Recycled slots must not keep levels, hashes or later events
+        backend->parse(shallow, batch);
+        ASSERT_EQ(batch.size(), 1);
+        const auto& snapshot = std::get<BookSnapshot>(batch[0]);
+        ASSERT_EQ(snapshot.bids.size(), 1);
+        EXPECT_EQ(snapshot.bids[0].price(), Price(0.47));
+        EXPECT_TRUE(snapshot.hash.empty());
+        EXPECT_EQ(snapshot.timestamp.milliseconds(), 3);
+
+        backend->parse("not json", batch);
+        EXPECT_TRUE(batch.empty());
+    }
+}
+
+TEST_F(SimdjsonParserTest, ReusedBatchKeepsDeltaStorageAcrossEventTypes) {
+    std::string delta = R"([{"event_type": "price_change", "market": "0x", "timestamp": "1", "price_changes": [{"asset_id": "1", "price": "0.5", "size": "10", "side": "BUY", "best_bid": "0.5", "best_ask": "0.52"}, {"asset_id": "1", "price": "0.49", "size": "5", "side": "BUY", "best_bid": "0.5", "best_ask": "0.52"}]}])";
+    std::string trade = R"([{"event_type": "last_trade_price", "asset_id": "1", "market": "0x", "price": "0.50", "side": "BUY", "size": "100", "timestamp": "2"}])";
+
+    for (mde::infrastructure::IMessageParser* backend :
+         {static_cast<mde::infrastructure::IMessageParser*>(&parser),
+          static_cast<mde::infrastructure::IMessageParser*>(&reference)}) {
+        mde::infrastructure::EventBatch batch;
+        backend->parse(delta, batch);
+        const auto* storage = std::get<BookDelta>(batch[0]).changes.data();
+
+        // The trade takes the delta's slot; the next delta gets its vector back
+        backend->parse(trade, batch);
+        ASSERT_TRUE(std::holds_alternative<TradeEvent>(batch[0]));
+        backend->parse(delta, batch);
+        ASSERT_EQ(batch.size(), 1);
+        EXPECT_EQ(std::get<BookDelta>(batch[0]).changes.data(), storage);
+        EXPECT_EQ(std::get<BookDelta>(batch[0]).changes.size(), 2);
+    }
+}
+
+TEST(MessageParserFactory, BuildsKnownBackends) {
+    EXPECT_NE(mde::infrastructure::make_message_parser("nlohmann"), nullptr);
+    EXPECT_NE(mde::infrastructure::make_message_parser("simdjson"), nullptr);
+    EXPECT_THROW(mde::infrastructure::make_message_parser("rapidjson"), std::invalid_argument);
+}
@@ -0,0 +1,123 @@
+#include "repositories/parquet/CachingFileSystem.hpp"
+
+#include <arrow/buffer.h>
+#include <arrow/filesystem/api.h>
+#include <arrow/filesystem/mockfs.h>
+#include <arrow/io/interfaces.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using mde::repositories::pq::CachingFileSystem;
+using mde::repositories::pq::DiskCacheOptions;
+
+namespace {
+
+void write(arrow::fs::FileSystem& fs, const std::string& path, const std::string& contents) {
+    auto out = fs.OpenOutputStream(path).ValueOrDie();
+    ASSERT_TRUE(out->Write(contents.data(), static_cast<int64_t>(contents.size())).ok());
+    ASSERT_TRUE(out->Close().ok());
+}
+
+std::string read(arrow::fs::FileSystem& fs, const std::string& path) {
+    auto file = fs.OpenInputFile(path).ValueOrDie();
+    auto size = file->GetSize().ValueOrDie();
+    return file->ReadAt(0, size).ValueOrDie()->ToString();
+}
+
+class CachingFileSystemTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir;
+    // Every file it writes was last modified long ago, so all are cacheable
+    std::shared_ptr<arrow::fs::FileSystem> remote =
+        std::make_shared<arrow::fs::internal::MockFileSystem>(arrow::fs::TimePoint(std::chrono::seconds(0)));
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              ("mde_cache_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(dir);
+    }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    DiskCacheOptions options(uint64_t max_bytes = 1 << 20) {
+        DiskCacheOptions o;
+        o.directory = dir.string();
+        o.max_bytes = max_bytes;
+        return o;
+    }
+};
+
+} // namespace
+
+TEST_F(CachingFileSystemTest, DownloadsOnceAndServesRepeatsFromDisk) {
+    write(*remote, "a.parquet", "first file");
+    CachingFileSystem cache(remote, options());
+
+    EXPECT_EQ(read(cache, "a.parquet"), "first file");
+    EXPECT_EQ(read(cache, "a.parquet"), "first file");
+    EXPECT_EQ(cache.misses(), 1u);
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.entries(), 1u);
+    EXPECT_EQ(cache.bytes_cached(), 10u);
+}
+
+TEST_F(CachingFileSystemTest, ARewrittenFileIsFetchedAgain) {
+    write(*remote, "snapshot.parquet", "v1");
+    CachingFileSystem cache(remote, options());
+    EXPECT_EQ(read(cache, "snapshot.parquet"), "v1");
+
+    write(cache, "snapshot.parquet", "version 2");
+    EXPECT_EQ(read(cache, "snapshot.parquet"), "version 2");
+    EXPECT_EQ(cache.misses(), 2u);
+}
+
+TEST_F(CachingFileSystemTest, EvictsLeastRecentlyUsedPastTheBudget) {
+    write(*remote, "a.parquet", std::string(40, 'a'));
+    write(*remote, "b.parquet", std::string(40, 'b'));
+    write(*remote, "c.parquet", std::string(40, 'c'));
+    CachingFileSystem cache(remote, options(100));
+
+    read(cache, "a.parquet");
+    read(cache, "b.parquet");
+    read(cache, "a.parquet");  // b is now the oldest
+    read(cache, "c.parquet");
+    EXPECT_EQ(cache.evictions(), 1u);
+    EXPECT_EQ(cache.bytes_cached(), 80u);
+
+    read(cache, "a.parquet");
+    EXPECT_EQ(cache.hits(), 2u);
+    read(cache, "b.parquet");
+    EXPECT_EQ(cache.misses(), 4u);
+}
+
+TEST_F(CachingFileSystemTest, ARestartKeepsWhatWasCached) {
+    write(*remote, "a.parquet", "kept across runs");
+    {
+        CachingFileSystem cache(remote, options());
+        read(cache, "a.parquet");
+    }
+    CachingFileSystem cache(remote, options());
+    EXPECT_EQ(cache.entries(), 1u);
+    EXPECT_EQ(read(cache, "a.parquet"), "kept across runs");
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), 0u);
+}
+
+TEST_F(CachingFileSystemTest, RecentlyModifiedFilesAreNotCached) {
+    auto fresh = std::make_shared<arrow::fs::internal::MockFileSystem>(std::chrono::system_clock::now());
+    write(*fresh, "a.parquet", "still changing");
+    CachingFileSystem cache(fresh, options());
+
+    EXPECT_EQ(read(cache, "a.parquet"), "still changing");
+    EXPECT_EQ(cache.entries(), 0u);
+    EXPECT_EQ(cache.misses(), 0u);
+}
+
+TEST_F(CachingFileSystemTest, RejectsBadOptions) {
+    EXPECT_THROW({ CachingFileSystem cache(remote, DiskCacheOptions{}); }, std::invalid_argument);
+    EXPECT_THROW({ CachingFileSystem cache(remote, options(0)); }, std::invalid_argument);
+}
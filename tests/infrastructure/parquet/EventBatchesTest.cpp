@@ -0,0 +1,94 @@
+#include "repositories/parquet/EventBatches.hpp"
+#include "repositories/parquet/ParquetSchemas.hpp"
+
+#include <arrow/api.h>
+
+#include <gtest/gtest.h>
+
+#include <variant>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::repositories::pq;
+
+namespace {
+
+const MarketAsset kAsset("0xbd31dc", "6581861");
+
+template <typename T>
+std::shared_ptr<T> column(const arrow::RecordBatch& batch, const char* name) {
+    return std::static_pointer_cast<T>(batch.GetColumnByName(name));
+}
+
+} // namespace
+
+TEST(EventBatches, BookSnapshotsUseTheSnapshotSchema) {
+    std::vector<OrderBookEventVariant> events{
+        BookSnapshot{{kAsset, Timestamp(1000), 1},
+                     {PriceLevel(Price(0.48), Quantity(30.0)), PriceLevel(Price(0.47), Quantity(5.0))},
+                     {PriceLevel(Price(0.52), Quantity(25.0))},
+                     "0xhash"}};
+    auto batch = book_snapshot_batch(events);
+
+    ASSERT_TRUE(batch->schema()->Equals(*ParquetSchemas::book_snapshot_schema()));
+    ASSERT_EQ(batch->num_rows(), 1);
+    EXPECT_EQ(column<arrow::StringArray>(*batch, "token_id")->GetString(0), "6581861");
+    EXPECT_EQ(column<arrow::UInt64Array>(*batch, "sequence_number")->Value(0), 1u);
+    auto bids = column<arrow::ListArray>(*batch, "bid_prices");
+    EXPECT_EQ(bids->value_length(0), 2);
+    EXPECT_EQ(std::static_pointer_cast<arrow::Int64Array>(bids->values())->Value(0), 480'000);
+    EXPECT_TRUE(batch->ValidateFull().ok());
+}
+
+TEST(EventBatches, DeltasAreOneRowEachNestedOrOneRowPerChangeFlat) {
+    std::vector<OrderBookEventVariant> events{
+        BookDelta{{kAsset, Timestamp(2000), 2},
+                  {PriceLevelDelta{kAsset.token(), Price(0.49), Quantity(10.0), Side::BUY, Price(0.49), Price(0.52)},
+                   PriceLevelDelta{kAsset.token(), Price(0.52), Quantity(0.0), Side::SELL, Price(0.49), Price(0.53)}}},
+        BookDelta{{kAsset, Timestamp(3000), 3},
+                  {PriceLevelDelta{kAsset.token(), Price(0.50), Quantity(4.0), Side::BUY, Price(0.50), Price(0.53)}}}};
+
+    auto nested = book_delta_batch(events);
+    ASSERT_TRUE(nested->schema()->Equals(*ParquetSchemas::book_delta_schema()));
+    EXPECT_EQ(nested->num_rows(), 2);
+    EXPECT_EQ(column<arrow::ListArray>(*nested, "change_prices")->value_length(0), 2);
+
+    auto flat = flat_book_delta_batch(events);
+    ASSERT_TRUE(flat->schema()->Equals(*ParquetSchemas::flat_book_delta_schema()));
+    ASSERT_EQ(flat->num_rows(), 3);
+    auto seqs = column<arrow::UInt64Array>(*flat, "sequence_number");
+    EXPECT_EQ(seqs->Value(0), 2u);
+    EXPECT_EQ(seqs->Value(1), 2u);
+    EXPECT_EQ(seqs->Value(2), 3u);
+    EXPECT_EQ(column<arrow::Int64Array>(*flat, "best_ask")->Value(1), 530'000);
+    EXPECT_EQ(ParquetSchemas::schema_version(*flat->schema()), 2);
+}
+
+TEST(EventBatches, TradesAndTickSizeChangesKeepEveryField) {
+    std::vector<OrderBookEventVariant> trades{
+        TradeEvent{{kAsset, Timestamp(4000), 4}, Price(0.51), Quantity(12.5), Side::SELL, "10"}};
+    auto trade = trade_event_batch(trades);
+    ASSERT_TRUE(trade->schema()->Equals(*ParquetSchemas::trade_event_schema()));
+    EXPECT_EQ(column<arrow::Int64Array>(*trade, "price")->Value(0), 510'000);
+    EXPECT_EQ(column<arrow::Int64Array>(*trade, "size")->Value(0), 12'500'000);
+    EXPECT_EQ(column<arrow::UInt8Array>(*trade, "side")->Value(0), static_cast<uint8_t>(Side::SELL));
+
+    std::vector<OrderBookEventVariant> ticks{
+        TickSizeChange{{kAsset, Timestamp(5000), 5}, Price(0.01), Price(0.001)}};
+    auto tick = tick_size_change_batch(ticks);
+    ASSERT_TRUE(tick->schema()->Equals(*ParquetSchemas::tick_size_change_schema()));
+    EXPECT_EQ(column<arrow::Int64Array>(*tick, "new_tick_size")->Value(0), 1'000);
+}
+
+TEST(EventBatches, NoEventsIsAnEmptyBatchAndTablesShareTheColumns) {
+    auto empty = trade_event_batch({});
+    EXPECT_EQ(empty->num_rows(), 0);
+    EXPECT_TRUE(empty->schema()->Equals(*ParquetSchemas::trade_event_schema()));
+
+    std::vector<OrderBookEventVariant> trades{
+        TradeEvent{{kAsset, Timestamp(4000), 4}, Price(0.51), Quantity(1.0), Side::BUY, "0"}};
+    auto batch = trade_event_batch(trades);
+    auto table = as_table(batch);
+    EXPECT_EQ(table->num_rows(), 1);
+    EXPECT_EQ(table->column(0)->chunk(0)->data()->buffers[1], batch->column(0)->data()->buffers[1]);
+}
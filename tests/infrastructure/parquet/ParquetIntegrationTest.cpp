@@ -10,11 +10,37 @@
 #include <arrow/filesystem/mockfs.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <variant>
+#include <vector>
 
 using namespace mde::domain;
 using namespace mde::repositories::pq;
 
+namespace {
+
+// Refuses to open event files for writing while `fail` is set
+class FailingFileSystem : public arrow::fs::SubTreeFileSystem {
+public:
+    using SubTreeFileSystem::SubTreeFileSystem;
+    using SubTreeFileSystem::OpenOutputStream;
+
+    arrow::Result<std::shared_ptr<arrow::io::OutputStream>> OpenOutputStream(
+        const std::string& path, const std::shared_ptr<const arrow::KeyValueMetadata>& metadata) override {
+        if (fail && path.rfind(prefix, 0) == 0) return arrow::Status::IOError("disk full");
+        return SubTreeFileSystem::OpenOutputStream(path, metadata);
+    }
+
+    std::atomic<bool> fail{true};
+    std::string prefix{"events/"};  // of the paths that fail
+};
+
+} // namespace
+
 class ParquetIntegrationTest : public ::testing::Test {
 protected:
     std::shared_ptr<arrow::fs::FileSystem> fs_;
@@ -59,8 +85,8 @@ protected:
 };
 
 TEST_F(ParquetIntegrationTest, AppendAndReadEventsRoundtrip) {
-    // Use small buffer to force immediate flush
-    auto settings = make_settings(3);
+    // Each event type is its own partition; size 1 flushes every append
+    auto settings = make_settings(1);
     ParquetOrderBookRepository repo(fs_, settings);
 
     auto snap = make_snapshot(1);
@@ -71,7 +97,7 @@ TEST_F(ParquetIntegrationTest, AppendAndReadEventsRoundtrip) {
     repo.append_event(trade);
     repo.append_event(delta);
 
-    // Buffer should have flushed (3 events >= buffer_size of 3)
+    // Every partition should have flushed
     auto events = repo.get_events_since(asset, 0);
     ASSERT_EQ(events.size(), 3);
 
@@ -112,6 +138,470 @@ TEST_F(ParquetIntegrationTest, FlushOnDestructor) {
     EXPECT_EQ(events.size(), 2);
 }
 
+// --- Partitioning ---
+
+TEST_F(ParquetIntegrationTest, InterleavedAssetsFlushToTheirOwnDirectories) {
+    auto settings = make_settings(2);
+    ParquetOrderBookRepository repo(fs_, settings);
+
+    MarketAsset other("0xother", "99999999");
+    for (uint64_t seq = 1; seq <= 4; ++seq) {
+        const auto& a = (seq % 2) ? asset : other;
+        repo.append_event(TradeEvent{{a, Timestamp(2000), seq},
+                                     Price(0.50), Quantity(10.0), Side::BUY, "100"});
+    }
+
+    // Each asset filled its own partition, so each got its own file
+    auto list = [&](const std::string& dir) {
+        arrow::fs::FileSelector selector;
+        selector.base_dir = dir;
+        selector.recursive = true;
+        selector.allow_not_found = true;
+        size_t files = 0;
+        for (const auto& info : fs_->GetFileInfo(selector).ValueOrDie()) {
+            if (info.type() == arrow::fs::FileType::File) ++files;
+        }
+        return files;
+    };
+    EXPECT_EQ(list("events/trade_event/6581861"), 1);
+    EXPECT_EQ(list("events/trade_event/99999999"), 1);
+
+    EXPECT_EQ(repo.get_events_since(asset, 0).size(), 2);
+    EXPECT_EQ(repo.get_events_since(other, 0).size(), 2);
+}
+
+TEST_F(ParquetIntegrationTest, EventsInDifferentHoursFlushSeparately) {
+    {
+        ParquetOrderBookRepository repo(fs_, make_settings(1000));
+        repo.append_event(TradeEvent{{asset, Timestamp(1000), 1},
+                                     Price(0.50), Quantity(10.0), Side::BUY, "100"});
+        repo.append_event(TradeEvent{{asset, Timestamp(3'600'000 + 1000), 2},
+                                     Price(0.51), Quantity(10.0), Side::BUY, "100"});
+    }
+
+    EXPECT_TRUE(fs_->GetFileInfo("events/trade_event/6581861/1970-01-01/trade_event_00_1_1.parquet")
+                    .ValueOrDie().IsFile());
+    EXPECT_TRUE(fs_->GetFileInfo("events/trade_event/6581861/1970-01-01/trade_event_01_2_2.parquet")
+                    .ValueOrDie().IsFile());
+}
+
+TEST_F(ParquetIntegrationTest, ReadsFilesSpanningSeveralRowGroups) {
+    {
+        ParquetOrderBookRepository repo(fs_, make_settings(600));
+        for (uint64_t seq = 1; seq <= 600; ++seq) {
+            repo.append_event(make_trade(seq));
+        }
+    }
+
+    ParquetOrderBookRepository repo(fs_, make_settings());
+    EXPECT_EQ(repo.get_events_since(asset, 0).size(), 600);
+
+    // Only the tail of the file is past seq 550
+    auto tail = repo.get_events_since(asset, 550);
+    ASSERT_EQ(tail.size(), 50);
+    EXPECT_EQ(std::visit([](const auto& e) { return e.sequence_number; }, tail.front()), 551);
+    EXPECT_TRUE(repo.get_events_since(asset, 600).empty());
+}
+
+TEST_F(ParquetIntegrationTest, ConcurrentReadsMatchSequentialReads) {
+    {
+        // Many small files across event types and hours
+        ParquetOrderBookRepository repo(fs_, make_settings(3));
+        for (uint64_t seq = 1; seq <= 60; ++seq) {
+            auto hour = static_cast<int64_t>(seq / 20) * 3'600'000;
+            if (seq % 2) {
+                repo.append_event(TradeEvent{{asset, Timestamp(hour + 1000), seq},
+                                             Price(0.50), Quantity(10.0), Side::BUY, "100"});
+            } else {
+                auto delta = make_delta(seq);
+                delta.timestamp = Timestamp(hour + 1000);
+                repo.append_event(delta);
+            }
+        }
+    }
+
+    auto sequential_settings = make_settings();
+    auto concurrent_settings = make_settings();
+    concurrent_settings.read_concurrency = 4;
+    ParquetOrderBookRepository sequential(fs_, sequential_settings);
+    ParquetOrderBookRepository concurrent(fs_, concurrent_settings);
+
+    for (uint64_t since : {0u, 25u, 59u}) {
+        auto expected = sequential.get_events_since(asset, since);
+        auto events = concurrent.get_events_since(asset, since);
+        ASSERT_EQ(events.size(), 60 - since);
+        for (size_t i = 0; i < events.size(); ++i) {
+            EXPECT_EQ(std::visit([](const auto& e) { return e.sequence_number; }, events[i]), since + i + 1);
+            EXPECT_EQ(events[i].index(), expected[i].index());
+        }
+    }
+}
+
+TEST_F(ParquetIntegrationTest, ReadsOneAssetOutOfASharedFile) {
+    // Same token prefix, so both assets' events land in the same files
+    MarketAsset first{"0xaa", "658186100"};
+    MarketAsset second{"0xbb", "658186101"};
+    auto settings = make_settings(12);
+    settings.parquet.row_group_rows = 4;
+    {
+        ParquetOrderBookRepository repo(fs_, settings);
+        for (uint64_t seq = 1; seq <= 12; ++seq) {
+            const auto& a = (seq / 3) % 2 ? second : first;  // runs of three
+            PriceLevelDelta change{a.token(), Price(0.50), Quantity(static_cast<double>(seq)), Side::BUY,
+                                   Price(0.50), Price(0.52)};
+            repo.append_event(BookDelta{{a, Timestamp(3000), seq}, {change, change}});
+        }
+    }
+
+    ParquetOrderBookRepository repo(fs_, settings);
+    auto events = repo.get_events_since(second, 0);
+    std::vector<uint64_t> seqs;
+    for (const auto& event : events) {
+        const auto& delta = std::get<BookDelta>(event);
+        EXPECT_EQ(delta.asset, second);
+        ASSERT_EQ(delta.changes.size(), 2);
+        EXPECT_EQ(delta.changes[1].new_size, Quantity(static_cast<double>(delta.sequence_number)));
+        seqs.push_back(delta.sequence_number);
+    }
+    EXPECT_EQ(seqs, (std::vector<uint64_t>{3, 4, 5, 9, 10, 11}));
+    EXPECT_EQ(repo.get_events_since(first, 4).size(), 4);
+}
+
+// --- Writer profiles ---
+
+TEST_F(ParquetIntegrationTest, EveryWriterProfileRoundtripsEveryEventType) {
+    for (const char* name : {"default", "fast", "compact"}) {
+        SetUp();  // fresh filesystem per profile
+        auto settings = make_settings(1);
+        settings.parquet = *mde::config::ParquetWriterSettings::named(name);
+        {
+            ParquetOrderBookRepository repo(fs_, settings);
+            repo.append_event(make_snapshot(1));
+            repo.append_event(make_trade(2));
+            repo.append_event(make_delta(3));
+            repo.append_event(TickSizeChange{{asset, Timestamp(4000), 4}, Price(0.01), Price(0.001)});
+            repo.store_snapshot(OrderBook::empty(asset).apply(make_snapshot(1)));
+        }
+
+        ParquetOrderBookRepository repo(fs_, settings);
+        auto events = repo.get_events_since(asset, 0);
+        ASSERT_EQ(events.size(), 4) << name;
+        EXPECT_EQ(std::get<BookSnapshot>(events[0]).bids, make_snapshot(1).bids) << name;
+        EXPECT_EQ(std::get<TradeEvent>(events[1]).fee_rate_bps, "100") << name;
+        EXPECT_EQ(std::get<BookDelta>(events[2]).changes[0].best_ask, Price(0.52)) << name;
+        EXPECT_EQ(std::get<TickSizeChange>(events[3]).new_tick_size, Price(0.001)) << name;
+        EXPECT_TRUE(repo.get_latest_snapshot(asset).has_value()) << name;
+    }
+}
+
+TEST_F(ParquetIntegrationTest, FilesFromDifferentWriterSettingsReadTogether) {
+    auto settings = make_settings(5);
+    settings.parquet.codec = "zstd";
+    settings.parquet.dictionary = false;
+    settings.parquet.numeric_encoding = "delta";
+    settings.parquet.row_group_rows = 2;
+    {
+        ParquetOrderBookRepository repo(fs_, make_settings(5));
+        for (uint64_t seq = 1; seq <= 5; ++seq) repo.append_event(make_trade(seq));
+    }
+    {
+        ParquetOrderBookRepository repo(fs_, settings);
+        for (uint64_t seq = 6; seq <= 10; ++seq) repo.append_event(make_trade(seq));
+    }
+
+    ParquetOrderBookRepository repo(fs_, make_settings());
+    auto events = repo.get_events_since(asset, 3);
+    ASSERT_EQ(events.size(), 7);
+    EXPECT_EQ(std::get<TradeEvent>(events.back()).sequence_number, 10);
+}
+
+TEST_F(ParquetIntegrationTest, UnknownWriterSettingsAreRejected) {
+    auto settings = make_settings();
+    settings.parquet.codec = "zip";
+    EXPECT_THROW(ParquetOrderBookRepository(fs_, settings), std::invalid_argument);
+
+    settings = make_settings();
+    settings.parquet.numeric_encoding = "varint";
+    EXPECT_THROW(ParquetOrderBookRepository(fs_, settings), std::invalid_argument);
+}
+
+// --- Read modes ---
+
+TEST_F(ParquetIntegrationTest, MappedPreBufferedReadsMatch) {
+    auto root = std::filesystem::temp_directory_path() / "mde_parquet_mmap";
+    std::filesystem::remove_all(root);
+    auto settings = make_settings(2);
+    settings.mmap_reads = true;
+    settings.pre_buffer_reads = true;
+    settings.memory_pool = "system";
+    {
+        auto fs = ParquetOrderBookRepository::make_local_fs(root.string(), settings.mmap_reads);
+        {
+            ParquetOrderBookRepository repo(fs, settings);
+            for (uint64_t seq = 1; seq <= 6; ++seq) repo.append_event(make_delta(seq));
+            repo.store_snapshot(OrderBook::empty(asset).apply(make_snapshot(6)));
+        }
+
+        ParquetOrderBookRepository repo(fs, settings);
+        auto events = repo.get_events_since(asset, 2);
+        ASSERT_EQ(events.size(), 4);
+        EXPECT_EQ(std::get<BookDelta>(events.front()).changes, make_delta(3).changes);
+        auto snapshot = repo.get_latest_snapshot(asset);
+        ASSERT_TRUE(snapshot.has_value());
+        EXPECT_EQ(snapshot->get_last_sequence_number(), 6);
+    }
+    std::filesystem::remove_all(root);
+}
+
+TEST_F(ParquetIntegrationTest, UnknownMemoryPoolIsRejected) {
+    auto settings = make_settings();
+    settings.memory_pool = "tcmalloc";
+    EXPECT_THROW(ParquetOrderBookRepository(fs_, settings), std::invalid_argument);
+}
+
+// --- Replay ---
+
+TEST_F(ParquetIntegrationTest, ReplayMergesFilesAndBuffersInSequenceOrder) {
+    MarketAsset other{"0xbd31dc", "4815162"};
+    auto settings = make_settings(3);
+    settings.parquet.row_group_rows = 2;
+    auto wide_delta = [](const MarketAsset& a, uint64_t seq) {
+        PriceLevelDelta change{a.token(), Price(0.50), Quantity(1.0), Side::BUY, Price(0.50), Price(0.52)};
+        return BookDelta{{a, Timestamp(3000), seq}, {change, change, change}};
+    };
+
+    ParquetOrderBookRepository repo(fs_, settings);
+    // Deltas and trades of both assets, split over files, row groups and
+    // the unflushed buffers
+    for (uint64_t seq = 1; seq <= 20; ++seq) {
+        const auto& a = seq % 2 ? asset : other;
+        if (seq % 3 == 0) {
+            repo.append_event(TradeEvent{{a, Timestamp(2000), seq}, Price(0.5), Quantity(1.0), Side::SELL, "0"});
+        } else {
+            repo.append_event(wide_delta(a, seq));
+        }
+    }
+
+    std::vector<uint64_t> seqs;
+    auto visited = repo.replay_events({asset, other}, 4, [&](OrderBookEventVariant&& event) {
+        if (auto* delta = std::get_if<BookDelta>(&event)) EXPECT_EQ(delta->changes.size(), 3);
+        seqs.push_back(std::visit([](const auto& e) { return e.sequence_number; }, event));
+        return true;
+    });
+    EXPECT_EQ(visited, 16);
+    std::vector<uint64_t> expected;
+    for (uint64_t seq = 5; seq <= 20; ++seq) expected.push_back(seq);
+    EXPECT_EQ(seqs, expected);
+
+    // One asset, stopping early
+    seqs.clear();
+    repo.replay_events({other}, 0, [&](OrderBookEventVariant&& event) {
+        seqs.push_back(std::visit([](const auto& e) { return e.sequence_number; }, event));
+        return seqs.size() < 3;
+    });
+    EXPECT_EQ(seqs, (std::vector<uint64_t>{2, 4, 6}));
+}
+
+// --- Manifest ---
+
+TEST_F(ParquetIntegrationTest, FlushWritesManifestThatReadsUse) {
+    {
+        ParquetOrderBookRepository repo(fs_, make_settings(1));
+        repo.append_event(make_trade(1));
+        repo.append_event(make_trade(2));
+    }
+    EXPECT_TRUE(fs_->GetFileInfo("manifests/events/trade_event/6581861.parquet")
+                    .ValueOrDie().IsFile());
+
+    // A file the manifest does not know about is not picked up by reads...
+    const std::string dir = "events/trade_event/6581861/1970-01-01/";
+    ASSERT_TRUE(fs_->CopyFile(dir + "trade_event_00_2_2.parquet",
+                              dir + "trade_event_00_9_9.parquet").ok());
+    {
+        ParquetOrderBookRepository repo(fs_, make_settings());
+        EXPECT_EQ(repo.get_events_since(asset, 0).size(), 2);
+    }
+
+    // ...until the manifest is lost and the directory is listed again
+    ASSERT_TRUE(fs_->DeleteFile("manifests/events/trade_event/6581861.parquet").ok());
+    {
+        ParquetOrderBookRepository repo(fs_, make_settings());
+        EXPECT_EQ(repo.get_events_since(asset, 0).size(), 3);
+    }
+    // The listing was persisted as the new manifest
+    EXPECT_TRUE(fs_->GetFileInfo("manifests/events/trade_event/6581861.parquet")
+                    .ValueOrDie().IsFile());
+}
+
+TEST_F(ParquetIntegrationTest, ReadOnlyRepositoryNeverWritesAManifest) {
+    {
+        ParquetOrderBookRepository repo(fs_, make_settings(1));
+        repo.append_event(make_trade(1));
+        repo.append_event(make_trade(2));
+    }
+    ASSERT_TRUE(fs_->DeleteFile("manifests/events/trade_event/6581861.parquet").ok());
+
+    {
+        ParquetOrderBookRepository reader(fs_, make_settings(), Access::read_only);
+        EXPECT_EQ(reader.get_events_since(asset, 0).size(), 2);
+        EXPECT_THROW(reader.append_event(make_trade(3)), std::logic_error);
+        EXPECT_THROW(reader.store_snapshot(OrderBook::empty(asset).apply(make_snapshot(3))), std::logic_error);
+    }
+    // The listing was used but not persisted
+    EXPECT_EQ(fs_->GetFileInfo("manifests/events/trade_event/6581861.parquet").ValueOrDie().type(),
+              arrow::fs::FileType::NotFound);
+}
+
+TEST_F(ParquetIntegrationTest, ManifestSkipsFilesOfOtherTokensInPrefix) {
+    // Both tokens share the 8-character directory prefix
+    MarketAsset first("0xaaa", "1234567801");
+    MarketAsset second("0xbbb", "1234567802");
+    {
+        ParquetOrderBookRepository repo(fs_, make_settings(1));
+        repo.append_event(TradeEvent{{first, Timestamp(1000), 1},
+                                     Price(0.50), Quantity(10.0), Side::BUY, "0"});
+        repo.append_event(TradeEvent{{second, Timestamp(1000), 2},
+                                     Price(0.50), Quantity(10.0), Side::BUY, "0"});
+    }
+
+    ParquetOrderBookRepository repo(fs_, make_settings());
+    auto events = repo.get_events_since(second, 0);
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(std::visit([](const auto& e) { return e.sequence_number; }, events[0]), 2);
+}
+
+// --- Background flushing ---
+
+TEST_F(ParquetIntegrationTest, AsyncFlushEventsVisibleWhileInFlight) {
+    auto settings = make_settings(1);
+    settings.flush_threads = 2;
+    ParquetOrderBookRepository repo(fs_, settings);
+
+    for (uint64_t seq = 1; seq <= 20; ++seq) {
+        repo.append_event(make_trade(seq));
+    }
+
+    // Whether or not the writers have finished, every event is read exactly once
+    auto events = repo.get_events_since(asset, 0);
+    ASSERT_EQ(events.size(), 20);
+    for (size_t i = 0; i < events.size(); ++i) {
+        auto seq = std::visit([](const auto& e) { return e.sequence_number; }, events[i]);
+        EXPECT_EQ(seq, i + 1);
+    }
+}
+
+TEST_F(ParquetIntegrationTest, AsyncFlushSyncWritesEverything) {
+    auto settings = make_settings(2);
+    settings.flush_threads = 2;
+    settings.max_pending_flushes = 1;  // Force backpressure
+    ParquetOrderBookRepository repo(fs_, settings);
+
+    for (uint64_t seq = 1; seq <= 9; ++seq) {
+        repo.append_event(make_delta(seq));
+    }
+    repo.sync();
+
+    auto stats = repo.flush_stats();
+    EXPECT_EQ(stats.files_written, 5);  // 4 full buffers + the remainder
+    EXPECT_EQ(stats.failed_writes, 0);
+    EXPECT_EQ(stats.queue_depth, 0);
+    EXPECT_LE(stats.max_queue_depth, 1);
+
+    ParquetOrderBookRepository reader(fs_, make_settings());
+    EXPECT_EQ(reader.get_events_since(asset, 0).size(), 9);
+}
+
+TEST_F(ParquetIntegrationTest, AsyncFlushOnDestructor) {
+    auto settings = make_settings(1000);
+    settings.flush_threads = 1;
+
+    {
+        ParquetOrderBookRepository repo(fs_, settings);
+        repo.append_event(make_snapshot(1));
+        repo.append_event(make_trade(2));
+    }
+
+    ParquetOrderBookRepository repo2(fs_, make_settings());
+    EXPECT_EQ(repo2.get_events_since(asset, 0).size(), 2);
+}
+
+TEST_F(ParquetIntegrationTest, ConcurrentAppendsAndReadsMissNoEvent) {
+    for (int flush_threads : {0, 2}) {
+        auto settings = make_settings(7);
+        settings.flush_threads = flush_threads;
+        settings.max_pending_flushes = 2;
+        auto mock_fs = std::make_shared<arrow::fs::internal::MockFileSystem>(
+            arrow::fs::TimePoint(std::chrono::seconds(0)));
+        ParquetOrderBookRepository repo(std::make_shared<arrow::fs::SubTreeFileSystem>("/", mock_fs), settings);
+
+        // One writer per market, in its own partition shard or not
+        constexpr uint64_t kEvents = 200;
+        std::vector<MarketAsset> markets;
+        for (int i = 0; i < 4; ++i) markets.emplace_back("0xbd31dc", std::to_string(10000000 + i * 1111111));
+        std::vector<std::thread> writers;
+        for (size_t m = 0; m < markets.size(); ++m) {
+            writers.emplace_back([&, m] {
+                for (uint64_t seq = 1; seq <= kEvents; ++seq) {
+                    repo.append_event(TradeEvent{{markets[m], Timestamp(2000), m * 1000 + seq},
+                                                 Price(0.50), Quantity(1.0), Side::BUY, "0"});
+                }
+            });
+        }
+
+        // Whether an event is buffered, being written or in a file, a read
+        // sees every event appended before it
+        size_t seen = 0;
+        bool gapless = true;
+        while (seen < kEvents && gapless) {
+            auto events = repo.get_events_since(markets[0], 0);
+            gapless = events.size() >= seen;
+            for (size_t i = 0; i < events.size(); ++i) {
+                gapless = gapless && std::get<TradeEvent>(events[i]).sequence_number == i + 1;
+            }
+            seen = events.size();
+        }
+        for (auto& writer : writers) writer.join();
+        EXPECT_TRUE(gapless) << flush_threads << " flush threads";
+        repo.sync();
+
+        for (size_t m = 0; m < markets.size(); ++m) {
+            EXPECT_EQ(repo.get_events_since(markets[m], 0).size(), kEvents);
+        }
+        auto stats = repo.flush_stats();
+        EXPECT_EQ(stats.failed_writes, 0);
+        EXPECT_EQ(stats.buffered_events[2], 0);
+    }
+}
+
+TEST_F(ParquetIntegrationTest, SynchronousFlushRecordsStats) {
+    ParquetOrderBookRepository repo(fs_, make_settings(1));
+    repo.append_event(make_trade(1));
+
+    auto stats = repo.flush_stats();
+    EXPECT_EQ(stats.files_written, 1);
+    EXPECT_EQ(stats.queue_depth, 0);
+    EXPECT_EQ(stats.total_latency, stats.last_latency);
+}
+
+TEST_F(ParquetIntegrationTest, FlushStatsCountBytesAndBufferedEvents) {
+    ParquetOrderBookRepository repo(fs_, make_settings(3));
+    repo.append_event(make_delta(1));
+    repo.append_event(make_delta(2));
+    repo.append_event(make_trade(3));
+
+    auto stats = repo.flush_stats();
+    EXPECT_EQ(stats.bytes_written, 0);
+    EXPECT_EQ(stats.buffered_events[1], 2);  // book_delta
+    EXPECT_EQ(stats.buffered_events[2], 1);  // trade_event
+
+    repo.append_event(make_delta(4));
+    stats = repo.flush_stats();
+    EXPECT_EQ(stats.files_written, 1);
+    EXPECT_GT(stats.bytes_written, 0);
+    EXPECT_EQ(stats.buffered_events[1], 0);
+    EXPECT_EQ(stats.buffered_events[2], 1);
+}
+
 TEST_F(ParquetIntegrationTest, SequenceFilteringWorks) {
     auto settings = make_settings(1);
     ParquetOrderBookRepository repo(fs_, settings);
@@ -179,6 +669,363 @@ TEST_F(ParquetIntegrationTest, SnapshotReturnsNulloptForUnknownAsset) {
     EXPECT_FALSE(loaded.has_value());
 }
 
+namespace {
+
+std::vector<PriceLevel> levels_of(const auto& ladder) {
+    return {ladder.begin(), ladder.end()};
+}
+
+} // namespace
+
+TEST_F(ParquetIntegrationTest, SnapshotsAfterTheBaseStoreOnlyChangedLevels) {
+    auto settings = make_settings(1000);
+    settings.snapshot_diffs_per_base = 2;
+    ParquetOrderBookRepository repo(fs_, settings);
+
+    std::vector<PriceLevel> bids, asks;
+    for (int i = 0; i < 20; ++i) {
+        bids.emplace_back(Price(0.30 + i * 0.01), Quantity(10.0 + i));
+        asks.emplace_back(Price(0.51 + i * 0.01), Quantity(10.0 + i));
+    }
+    auto base = OrderBook::empty(asset).apply(BookSnapshot{{asset, Timestamp(1000), 1}, bids, asks, "0xbase"});
+    repo.store_snapshot(base);
+    EXPECT_EQ(fs_->GetFileInfo("snapshots/6581861.diff.parquet").ValueOrDie().type(),
+              arrow::fs::FileType::NotFound);
+
+    // A changed, a new and a removed bid, and a trade
+    auto changed = base.apply(BookDelta{{asset, Timestamp(2000), 2},
+                                        {PriceLevelDelta{"6581861", Price(0.40), Quantity(99.0), Side::BUY,
+                                                         Price(0.49), Price(0.51)},
+                                         PriceLevelDelta{"6581861", Price(0.50), Quantity(5.0), Side::BUY,
+                                                         Price(0.50), Price(0.51)},
+                                         PriceLevelDelta{"6581861", Price(0.30), Quantity(0.0), Side::BUY,
+                                                         Price(0.50), Price(0.51)}}})
+                       .apply(make_trade(3));
+    repo.store_snapshot(changed);
+    ASSERT_EQ(fs_->GetFileInfo("snapshots/6581861.diff.parquet").ValueOrDie().type(),
+              arrow::fs::FileType::File);
+
+    // Rebuilt from base and diff, also by a repository that did not write them
+    ParquetOrderBookRepository reader(fs_, settings);
+    for (const auto* source : {&repo, &reader}) {
+        auto loaded = source->get_latest_snapshot(asset);
+        ASSERT_TRUE(loaded.has_value());
+        EXPECT_EQ(levels_of(loaded->get_bids()), levels_of(changed.get_bids()));
+        EXPECT_EQ(levels_of(loaded->get_asks()), levels_of(changed.get_asks()));
+        EXPECT_EQ(loaded->get_last_sequence_number(), 3u);
+        ASSERT_TRUE(loaded->get_latest_trade().has_value());
+    }
+
+    // Past snapshot_diffs_per_base the next snapshot is a new base
+    repo.store_snapshot(changed);
+    repo.store_snapshot(changed);
+    EXPECT_EQ(fs_->GetFileInfo("snapshots/6581861.diff.parquet").ValueOrDie().type(),
+              arrow::fs::FileType::NotFound);
+    auto loaded = repo.get_latest_snapshot(asset);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(levels_of(loaded->get_bids()), levels_of(changed.get_bids()));
+}
+
+TEST_F(ParquetIntegrationTest, SnapshotChangingHalfTheBookIsStoredInFull) {
+    ParquetOrderBookRepository repo(fs_, make_settings(1000));
+
+    repo.store_snapshot(OrderBook::empty(asset).apply(make_snapshot(1)));
+    // Every level moves
+    repo.store_snapshot(OrderBook::empty(asset).apply(
+        BookSnapshot{{asset, Timestamp(2000), 2},
+                     {PriceLevel(Price(0.40), Quantity(30.0)), PriceLevel(Price(0.41), Quantity(20.0))},
+                     {PriceLevel(Price(0.60), Quantity(25.0)), PriceLevel(Price(0.61), Quantity(60.0))},
+                     "0xmoved"}));
+
+    EXPECT_EQ(fs_->GetFileInfo("snapshots/6581861.diff.parquet").ValueOrDie().type(),
+              arrow::fs::FileType::NotFound);
+    EXPECT_EQ(repo.get_latest_snapshot(asset)->get_last_sequence_number(), 2u);
+}
+
+TEST_F(ParquetIntegrationTest, SnapshotThatFailsToWriteKeepsThePreviousOne) {
+    auto mock_fs = std::make_shared<arrow::fs::internal::MockFileSystem>(
+        arrow::fs::TimePoint(std::chrono::seconds(0)));
+    auto failing = std::make_shared<FailingFileSystem>("/", mock_fs);
+    failing->prefix = "snapshots/";
+    failing->fail = false;
+    auto settings = make_settings(1000);
+    settings.snapshot_diffs_per_base = 1;
+    ParquetOrderBookRepository repo(failing, settings);
+
+    auto base = OrderBook::empty(asset).apply(make_snapshot(1));
+    repo.store_snapshot(base);
+
+    // Neither a diff (no level changed) nor a new base (every level moved)
+    // replaces it
+    failing->fail = true;
+    auto traded = base.apply(make_trade(2));
+    repo.store_snapshot(traded);
+    repo.store_snapshot(OrderBook::empty(asset).apply(
+        BookSnapshot{{asset, Timestamp(3000), 3},
+                     {PriceLevel(Price(0.40), Quantity(30.0)), PriceLevel(Price(0.41), Quantity(20.0))},
+                     {PriceLevel(Price(0.60), Quantity(25.0)), PriceLevel(Price(0.61), Quantity(60.0))},
+                     "0xmoved"}));
+    EXPECT_EQ(repo.get_latest_snapshot(asset)->get_last_sequence_number(), 1u);
+
+    // The failed diff did not use up the base's one diff
+    failing->fail = false;
+    repo.store_snapshot(traded);
+    EXPECT_EQ(failing->GetFileInfo("snapshots/6581861.diff.parquet").ValueOrDie().type(),
+              arrow::fs::FileType::File);
+    EXPECT_EQ(repo.get_latest_snapshot(asset)->get_last_sequence_number(), 2u);
+}
+
+TEST_F(ParquetIntegrationTest, CheckpointStoresAllBooksInOneFile) {
+    ParquetOrderBookRepository repo(fs_, make_settings(1000));
+
+    // Enough books for several row groups
+    std::vector<OrderBook> books;
+    for (int i = 0; i < 150; ++i) {
+        MarketAsset market("0xc" + std::to_string(i), "token" + std::to_string(1000 + i));
+        BookSnapshot snap{{market, Timestamp(1000), static_cast<uint64_t>(i + 1)},
+                          {PriceLevel(Price(0.48), Quantity(30.0))},
+                          {PriceLevel(Price(0.52), Quantity(25.0))}, "0xhash"};
+        books.push_back(OrderBook::empty(market).apply(snap));
+    }
+    books.push_back(OrderBook::empty(asset).apply(make_snapshot(200)).apply(make_trade(201)));
+    repo.store_checkpoint(books);
+
+    arrow::fs::FileSelector selector;
+    selector.base_dir = "checkpoints";
+    auto files = fs_->GetFileInfo(selector).ValueOrDie();
+    EXPECT_EQ(files.size(), 2);  // one data file plus the LATEST pointer
+    EXPECT_TRUE(fs_->GetFileInfo("snapshots").ValueOrDie().type() ==
+                arrow::fs::FileType::NotFound);
+
+    auto loaded = repo.load_checkpoint();
+    ASSERT_EQ(loaded.size(), books.size());
+
+    // Point lookups find the asset's row through the row-group statistics
+    auto book = repo.get_latest_snapshot(asset);
+    ASSERT_TRUE(book.has_value());
+    EXPECT_EQ(book->get_last_sequence_number(), 201);
+    EXPECT_DOUBLE_EQ(book->get_best_bid().value(), 0.49);
+    ASSERT_TRUE(book->get_latest_trade().has_value());
+    EXPECT_TRUE(repo.get_latest_snapshot_by_token("token1100").has_value());
+    EXPECT_FALSE(repo.get_latest_snapshot_by_token("token9999").has_value());
+}
+
+TEST_F(ParquetIntegrationTest, NewCheckpointReplacesPrevious) {
+    ParquetOrderBookRepository repo(fs_, make_settings(1000));
+
+    repo.store_checkpoint({OrderBook::empty(asset).apply(make_snapshot(1))});
+    repo.store_checkpoint({OrderBook::empty(asset).apply(make_snapshot(1)).apply(make_trade(2))});
+
+    arrow::fs::FileSelector selector;
+    selector.base_dir = "checkpoints";
+    EXPECT_EQ(fs_->GetFileInfo(selector).ValueOrDie().size(), 2);
+
+    auto loaded = repo.load_checkpoint();
+    ASSERT_EQ(loaded.size(), 1);
+    EXPECT_EQ(loaded[0].get_last_sequence_number(), 2);
+
+    // Survives a restart
+    ParquetOrderBookRepository reopened(fs_, make_settings(1000));
+    EXPECT_EQ(reopened.load_checkpoint().size(), 1);
+}
+
+TEST_F(ParquetIntegrationTest, LoadCheckpointEmptyWhenNoneStored) {
+    ParquetOrderBookRepository repo(fs_, make_settings(1000));
+    EXPECT_TRUE(repo.load_checkpoint().empty());
+}
+
+TEST_F(ParquetIntegrationTest, WriteAheadLogReplaysBufferedEventsAfterCrash) {
+    auto wal_dir = std::filesystem::temp_directory_path() / "mde_parquet_wal_replay";
+    std::filesystem::remove_all(wal_dir);
+    auto settings = make_settings(1000);
+    settings.wal_directory = wal_dir.string();
+
+    {
+        // Buffered only: nothing is in a file when the "crash" happens
+        ParquetOrderBookRepository crashed(fs_, settings);
+        crashed.append_event(make_snapshot(1));
+        crashed.append_event(make_delta(2));
+        crashed.append_event(make_trade(3));
+
+        // The next process sees an event store without them and the same log
+        auto mock_fs = std::make_shared<arrow::fs::internal::MockFileSystem>(
+            arrow::fs::TimePoint(std::chrono::seconds(0)));
+        auto fresh_fs = std::make_shared<arrow::fs::SubTreeFileSystem>("/", mock_fs);
+        ParquetOrderBookRepository restarted(fresh_fs, settings);
+
+        auto events = restarted.get_events_since(asset, 0);
+        ASSERT_EQ(events.size(), 3);
+        EXPECT_EQ(std::get<BookSnapshot>(events[0]).bids.size(), 2);
+        EXPECT_EQ(std::get<TradeEvent>(events[2]).sequence_number, 3);
+    }
+    std::filesystem::remove_all(wal_dir);
+}
+
+TEST_F(ParquetIntegrationTest, WriteAheadLogSkipsEventsAlreadyWritten) {
+    auto wal_dir = std::filesystem::temp_directory_path() / "mde_parquet_wal_skip";
+    std::filesystem::remove_all(wal_dir);
+    auto settings = make_settings(1);
+    settings.wal_directory = wal_dir.string();
+    {
+        // Every append is written at once; the current segment still holds them
+        ParquetOrderBookRepository repo(fs_, settings);
+        repo.append_event(make_snapshot(1));
+        repo.append_event(make_delta(2));
+    }
+
+    {
+        ParquetOrderBookRepository reopened(fs_, settings);
+        EXPECT_EQ(reopened.get_events_since(asset, 0).size(), 2);
+        EXPECT_EQ(reopened.flush_stats().files_written, 0);
+    }
+    std::filesystem::remove_all(wal_dir);
+}
+
+TEST_F(ParquetIntegrationTest, FailedFlushKeepsItsEventsInTheLog) {
+    auto wal_dir = std::filesystem::temp_directory_path() / "mde_parquet_wal_failed_flush";
+    // The event file itself, or the manifest that would list it
+    for (std::string failing_prefix : {"events/", "manifests/"}) {
+        for (int flush_threads : {0, 1}) {
+            SCOPED_TRACE(failing_prefix + " flush_threads=" + std::to_string(flush_threads));
+            std::filesystem::remove_all(wal_dir);
+            auto settings = make_settings(2);
+            settings.wal_directory = wal_dir.string();
+            settings.flush_threads = flush_threads;
+            auto mock_fs = std::make_shared<arrow::fs::internal::MockFileSystem>(
+                arrow::fs::TimePoint(std::chrono::seconds(0)));
+            auto failing = std::make_shared<FailingFileSystem>("/", mock_fs);
+            failing->prefix = failing_prefix;
+            {
+                ParquetOrderBookRepository repo(failing, settings);
+                repo.append_event(make_delta(1));
+                if (flush_threads == 0) {
+                    EXPECT_THROW(repo.append_event(make_delta(2)), std::runtime_error);
+                } else {
+                    repo.append_event(make_delta(2));
+                    repo.sync();
+                }
+                auto stats = repo.flush_stats();
+                EXPECT_EQ(stats.failed_writes, 1);
+                EXPECT_EQ(stats.files_written, 0);
+            }
+
+            // Nothing was recorded as written, so the next start replays both
+            failing->fail = false;
+            ParquetOrderBookRepository restarted(failing, settings);
+            EXPECT_EQ(restarted.get_events_since(asset, 0).size(), 2);
+            EXPECT_TRUE(failing->GetFileInfo("manifests/events/book_delta/6581861.parquet").ValueOrDie().IsFile());
+        }
+    }
+    std::filesystem::remove_all(wal_dir);
+}
+
+TEST_F(ParquetIntegrationTest, CompactionMergesAnEndedHoursFiles) {
+    // Size 1: every append is its own file
+    ParquetOrderBookRepository repo(fs_, make_settings(1));
+    for (uint64_t seq = 1; seq <= 5; ++seq) {
+        repo.append_event(make_delta(seq));
+    }
+
+    auto stats = repo.compact();
+    EXPECT_EQ(stats.files_written, 1);
+    EXPECT_EQ(stats.files_merged, 5);
+    EXPECT_EQ(stats.events_rewritten, 5);
+
+    auto events = repo.get_events_since(asset, 2);
+    ASSERT_EQ(events.size(), 3);
+    EXPECT_EQ(std::get<BookDelta>(events[0]).sequence_number, 3);
+    EXPECT_EQ(std::get<BookDelta>(events[2]).sequence_number, 5);
+
+    // The inputs outlive the pass that replaced them, then go
+    arrow::fs::FileSelector selector;
+    selector.base_dir = "events";
+    selector.recursive = true;
+    auto count_files = [&] {
+        size_t files = 0;
+        for (const auto& info : fs_->GetFileInfo(selector).ValueOrDie()) {
+            if (info.type() == arrow::fs::FileType::File) ++files;
+        }
+        return files;
+    };
+    EXPECT_EQ(count_files(), 6);
+    EXPECT_EQ(repo.compact().files_deleted, 5);
+    EXPECT_EQ(count_files(), 1);
+
+    // A restart reads the merged file through the manifest
+    ParquetOrderBookRepository reopened(fs_, make_settings(1));
+    EXPECT_EQ(reopened.get_events_since(asset, 0).size(), 5);
+}
+
+TEST_F(ParquetIntegrationTest, CompactionThatFailsToWriteKeepsItsInputs) {
+    auto mock_fs = std::make_shared<arrow::fs::internal::MockFileSystem>(
+        arrow::fs::TimePoint(std::chrono::seconds(0)));
+    auto failing = std::make_shared<FailingFileSystem>("/", mock_fs);
+    failing->fail = false;
+    ParquetOrderBookRepository repo(failing, make_settings(1));
+    for (uint64_t seq = 1; seq <= 3; ++seq) {
+        repo.append_event(make_delta(seq));
+    }
+
+    failing->fail = true;
+    EXPECT_EQ(repo.compact().files_written, 0);
+    EXPECT_EQ(repo.compact().files_deleted, 0);
+    failing->fail = false;
+
+    ParquetOrderBookRepository reopened(failing, make_settings(1));
+    EXPECT_EQ(reopened.get_events_since(asset, 0).size(), 3);
+    auto stats = reopened.compact();
+    EXPECT_EQ(stats.files_written, 1);
+    EXPECT_EQ(stats.files_merged, 3);
+}
+
+TEST_F(ParquetIntegrationTest, CompactionLeavesTheCurrentHourAlone) {
+    ParquetOrderBookRepository repo(fs_, make_settings(1));
+    repo.append_event(make_delta(1));
+    repo.append_event(make_delta(2));
+
+    // The deltas are stamped 3000 ms, inside the UTC hour starting at 0
+    auto stats = repo.compact(std::chrono::system_clock::time_point(std::chrono::minutes(30)));
+    EXPECT_EQ(stats.files_written, 0);
+    EXPECT_EQ(repo.get_events_since(asset, 0).size(), 2);
+}
+
+TEST_F(ParquetIntegrationTest, CompactionDatesListedFilesByTheirPath) {
+    {
+        ParquetOrderBookRepository repo(fs_, make_settings(1));
+        repo.append_event(make_delta(1));
+        repo.append_event(make_delta(2));
+    }
+    // Rebuilt by listing, with no time range
+    ASSERT_TRUE(fs_->DeleteDirContents("manifests").ok());
+
+    ParquetOrderBookRepository repo(fs_, make_settings(1));
+    EXPECT_EQ(repo.compact(std::chrono::system_clock::time_point(std::chrono::minutes(30))).files_written, 0);
+    auto stats = repo.compact();
+    EXPECT_EQ(stats.files_written, 1);
+    EXPECT_EQ(stats.files_merged, 2);
+    EXPECT_EQ(repo.get_events_since(asset, 0).size(), 2);
+}
+
+TEST_F(ParquetIntegrationTest, WriteAheadLogSkipsEventsInListedFiles) {
+    auto wal_dir = std::filesystem::temp_directory_path() / "mde_parquet_wal_listed";
+    std::filesystem::remove_all(wal_dir);
+    auto settings = make_settings(1);
+    settings.wal_directory = wal_dir.string();
+    {
+        ParquetOrderBookRepository repo(fs_, settings);
+        repo.append_event(make_delta(1));
+        repo.append_event(make_delta(2));
+    }
+    ASSERT_TRUE(fs_->DeleteDirContents("manifests").ok());
+
+    {
+        ParquetOrderBookRepository reopened(fs_, settings);
+        EXPECT_EQ(reopened.get_events_since(asset, 0).size(), 2);
+        EXPECT_EQ(reopened.flush_stats().files_written, 0);
+    }
+    std::filesystem::remove_all(wal_dir);
+}
+
 TEST_F(ParquetIntegrationTest, BookSnapshotEventDataPreserved) {
     auto settings = make_settings(1);
     ParquetOrderBookRepository repo(fs_, settings);
@@ -197,6 +1044,52 @@ TEST_F(ParquetIntegrationTest, BookSnapshotEventDataPreserved) {
     EXPECT_EQ(read_snap.hash, "0xhash");
 }
 
+TEST_F(ParquetIntegrationTest, MultiLevelDeltasReassembleAcrossRowGroups) {
+    auto settings = make_settings(3);
+    settings.parquet.row_group_rows = 2;  // every delta's rows straddle a group boundary
+    auto delta = [&](uint64_t seq) {
+        return BookDelta{{asset, Timestamp(3000), seq},
+                         {PriceLevelDelta{"6581861", Price(0.50), Quantity(100.0), Side::BUY,
+                                          Price(0.50), Price(0.52)},
+                          PriceLevelDelta{"6581861", Price(0.53), Quantity(0.0), Side::SELL,
+                                          Price(0.50), Price(0.52)},
+                          PriceLevelDelta{"6581861", Price(0.52), Quantity(7.5), Side::SELL,
+                                          Price(0.50), Price(0.52)}}};
+    };
+    {
+        ParquetOrderBookRepository repo(fs_, settings);
+        for (uint64_t seq = 1; seq <= 3; ++seq) repo.append_event(delta(seq));
+    }
+
+    ParquetOrderBookRepository repo(fs_, settings);
+    auto events = repo.get_events_since(asset, 1);
+    ASSERT_EQ(events.size(), 2);
+    for (uint64_t i = 0; i < 2; ++i) {
+        const auto& read = std::get<BookDelta>(events[i]);
+        EXPECT_EQ(read.sequence_number, i + 2);
+        EXPECT_EQ(read.asset, asset);
+        EXPECT_EQ(read.changes, delta(i + 2).changes);
+    }
+}
+
+TEST_F(ParquetIntegrationTest, NestedDeltaFilesStillRead) {
+    {
+        // A delta without changes has no flat rows, so its file uses the nested schema
+        ParquetOrderBookRepository repo(fs_, make_settings(2));
+        repo.append_event(BookDelta{{asset, Timestamp(3000), 1}, {}});
+        repo.append_event(make_delta(2));
+        repo.append_event(make_delta(3));
+        repo.append_event(make_delta(4));
+    }
+
+    ParquetOrderBookRepository repo(fs_, make_settings());
+    auto events = repo.get_events_since(asset, 0);
+    ASSERT_EQ(events.size(), 4);
+    EXPECT_TRUE(std::get<BookDelta>(events[0]).changes.empty());
+    EXPECT_EQ(std::get<BookDelta>(events[1]).changes, make_delta(2).changes);
+    EXPECT_EQ(std::get<BookDelta>(events[3]).changes, make_delta(4).changes);
+}
+
 TEST_F(ParquetIntegrationTest, TradeEventDataPreserved) {
     auto settings = make_settings(1);
     ParquetOrderBookRepository repo(fs_, settings);
@@ -231,3 +1124,47 @@ TEST_F(ParquetIntegrationTest, BookDeltaEventDataPreserved) {
     EXPECT_DOUBLE_EQ(read_delta.changes[0].new_size.size(), 100.0);
     EXPECT_EQ(read_delta.changes[0].side, Side::BUY);
 }
+
+TEST_F(ParquetIntegrationTest, BarsRoundTripPerInterval) {
+    ParquetOrderBookRepository repo(fs_, make_settings());
+    MarketAsset other{"0xbd31dc", "4815162"};
+
+    Bar second{asset, 1000, 3'600'000};
+    second.open = 500'000;
+    second.high = 550'000;
+    second.low = 450'000;
+    second.close = 480'000;
+    second.volume = 20'000'000;
+    second.buy_volume = 11'000'000;
+    second.trade_count = 4;
+    second.mid_open = second.mid_high = second.mid_low = second.mid_close = 500'000;
+    second.spread_close = second.spread_max = 40'000;
+    second.quote_updates = 3;
+    Bar later = second;
+    later.start_ms = 3'601'000;
+    Bar other_second{other, 1000, 3'600'000};
+    Bar minute{asset, 60'000, 3'600'000};
+    minute.trade_count = 9;
+
+    repo.store_bars({later, minute, second});
+    repo.store_bars({other_second});
+
+    auto seconds = repo.read_bars(1000, 0, 7'200'000);
+    ASSERT_EQ(seconds.size(), 3u);
+    EXPECT_EQ(seconds[0], other_second);  // token 4815162 sorts first
+    EXPECT_EQ(seconds[1], second);
+    EXPECT_EQ(seconds[2], later);
+
+    auto minutes = repo.read_bars(60'000, 0, 7'200'000);
+    ASSERT_EQ(minutes.size(), 1u);
+    EXPECT_EQ(minutes[0], minute);
+
+    EXPECT_EQ(repo.read_bars(1000, 3'601'000, 3'602'000).size(), 1u);
+    EXPECT_TRUE(repo.read_bars(5000, 0, 7'200'000).empty());
+
+    arrow::fs::FileSelector selector;
+    selector.base_dir = "bars/1s";
+    selector.recursive = true;
+    auto files = fs_->GetFileInfo(selector).ValueOrDie();
+    EXPECT_EQ(files.size(), 3u);  // the date directory and a file per call
+}
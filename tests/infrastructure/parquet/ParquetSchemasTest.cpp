@@ -21,7 +21,7 @@ TEST(ParquetSchemas, BookSnapshotSchemaHasCorrectFields) {
     EXPECT_TRUE(schema->field(0)->type()->Equals(arrow::utf8()));
     EXPECT_TRUE(schema->field(2)->type()->Equals(arrow::int64()));
     EXPECT_TRUE(schema->field(3)->type()->Equals(arrow::uint64()));
-    EXPECT_TRUE(schema->field(5)->type()->Equals(arrow::list(arrow::float64())));
+    EXPECT_TRUE(schema->field(5)->type()->Equals(arrow::list(arrow::int64())));
 }
 
 TEST(ParquetSchemas, BookDeltaSchemaHasCorrectFields) {
@@ -39,6 +39,26 @@ TEST(ParquetSchemas, BookDeltaSchemaHasCorrectFields) {
     EXPECT_TRUE(schema->field(7)->type()->Equals(arrow::list(arrow::uint8())));
 }
 
+TEST(ParquetSchemas, FlatBookDeltaSchemaHasOneRowPerChange) {
+    auto schema = ParquetSchemas::flat_book_delta_schema();
+    ASSERT_EQ(schema->num_fields(), 9);
+
+    EXPECT_EQ(schema->field(4)->name(), "side");
+    EXPECT_EQ(schema->field(5)->name(), "price");
+    EXPECT_EQ(schema->field(6)->name(), "new_size");
+    EXPECT_EQ(schema->field(7)->name(), "best_bid");
+    EXPECT_EQ(schema->field(8)->name(), "best_ask");
+
+    EXPECT_TRUE(schema->field(4)->type()->Equals(arrow::uint8()));
+    EXPECT_TRUE(schema->field(5)->type()->Equals(arrow::int64()));
+}
+
+TEST(ParquetSchemas, SchemaVersionDefaultsToOne) {
+    EXPECT_EQ(ParquetSchemas::schema_version(*ParquetSchemas::flat_book_delta_schema()), 2);
+    EXPECT_EQ(ParquetSchemas::schema_version(*ParquetSchemas::book_delta_schema()), 1);
+    EXPECT_EQ(ParquetSchemas::schema_version(*ParquetSchemas::trade_event_schema()), 1);
+}
+
 TEST(ParquetSchemas, TradeEventSchemaHasCorrectFields) {
     auto schema = ParquetSchemas::trade_event_schema();
     ASSERT_EQ(schema->num_fields(), 8);
@@ -48,10 +68,27 @@ TEST(ParquetSchemas, TradeEventSchemaHasCorrectFields) {
     EXPECT_EQ(schema->field(6)->name(), "side");
     EXPECT_EQ(schema->field(7)->name(), "fee_rate_bps");
 
-    EXPECT_TRUE(schema->field(4)->type()->Equals(arrow::float64()));
+    EXPECT_TRUE(schema->field(4)->type()->Equals(arrow::int64()));
     EXPECT_TRUE(schema->field(6)->type()->Equals(arrow::uint8()));
 }
 
+TEST(ParquetSchemas, BarSchemaHasCorrectFields) {
+    auto schema = ParquetSchemas::bar_schema();
+    ASSERT_EQ(schema->num_fields(), 18);
+
+    EXPECT_EQ(schema->field(0)->name(), "condition_id");
+    EXPECT_EQ(schema->field(1)->name(), "token_id");
+    EXPECT_EQ(schema->field(2)->name(), "interval_ms");
+    EXPECT_EQ(schema->field(3)->name(), "start_ms");
+    EXPECT_EQ(schema->field(4)->name(), "open");
+    EXPECT_EQ(schema->field(10)->name(), "trade_count");
+    EXPECT_EQ(schema->field(11)->name(), "mid_open");
+    EXPECT_EQ(schema->field(17)->name(), "quote_updates");
+
+    EXPECT_TRUE(schema->field(4)->type()->Equals(arrow::int64()));
+    EXPECT_TRUE(schema->field(10)->type()->Equals(arrow::uint32()));
+}
+
 TEST(ParquetSchemas, TickSizeChangeSchemaHasCorrectFields) {
     auto schema = ParquetSchemas::tick_size_change_schema();
     ASSERT_EQ(schema->num_fields(), 6);
@@ -59,7 +96,32 @@ TEST(ParquetSchemas, TickSizeChangeSchemaHasCorrectFields) {
     EXPECT_EQ(schema->field(4)->name(), "old_tick_size");
     EXPECT_EQ(schema->field(5)->name(), "new_tick_size");
 
-    EXPECT_TRUE(schema->field(4)->type()->Equals(arrow::float64()));
+    EXPECT_TRUE(schema->field(4)->type()->Equals(arrow::int64()));
+}
+
+TEST(ParquetSchemas, OrderBookDiffSchemaExtendsTheSnapshotSchema) {
+    auto snapshot = ParquetSchemas::order_book_snapshot_schema();
+    auto diff = ParquetSchemas::order_book_diff_schema();
+    ASSERT_EQ(diff->num_fields(), snapshot->num_fields() + 1);
+
+    for (int i = 0; i < snapshot->num_fields(); ++i) {
+        EXPECT_TRUE(diff->field(i)->Equals(*snapshot->field(i))) << i;
+    }
+    EXPECT_EQ(diff->field(16)->name(), "base_sequence_number");
+    EXPECT_TRUE(diff->field(16)->type()->Equals(arrow::uint64()));
+}
+
+TEST(ParquetSchemas, BookLevelsSchemaHasCorrectFields) {
+    auto schema = ParquetSchemas::book_levels_schema();
+    ASSERT_EQ(schema->num_fields(), 8);
+
+    EXPECT_EQ(schema->field(0)->name(), "token_id");
+    EXPECT_EQ(schema->field(3)->name(), "stale");
+    EXPECT_EQ(schema->field(4)->name(), "bid_prices");
+    EXPECT_EQ(schema->field(7)->name(), "ask_sizes");
+
+    EXPECT_TRUE(schema->field(3)->type()->Equals(arrow::boolean()));
+    EXPECT_TRUE(schema->field(4)->type()->Equals(arrow::list(arrow::int64())));
 }
 
 TEST(ParquetSchemas, OrderBookSnapshotSchemaHasCorrectFields) {
@@ -74,10 +136,26 @@ TEST(ParquetSchemas, OrderBookSnapshotSchemaHasCorrectFields) {
     EXPECT_TRUE(schema->field(15)->type()->Equals(arrow::boolean()));
 }
 
+TEST(ParquetSchemas, EventManifestSchemaHasCorrectFields) {
+    auto schema = ParquetSchemas::event_manifest_schema();
+    ASSERT_EQ(schema->num_fields(), 6);
+
+    EXPECT_EQ(schema->field(0)->name(), "path");
+    EXPECT_EQ(schema->field(1)->name(), "token_ids");
+    EXPECT_EQ(schema->field(2)->name(), "seq_start");
+    EXPECT_EQ(schema->field(3)->name(), "seq_end");
+    EXPECT_EQ(schema->field(4)->name(), "ts_start_ms");
+    EXPECT_EQ(schema->field(5)->name(), "ts_end_ms");
+
+    EXPECT_TRUE(schema->field(1)->type()->Equals(arrow::list(arrow::utf8())));
+    EXPECT_TRUE(schema->field(3)->type()->Equals(arrow::uint64()));
+}
+
 TEST(ParquetSchemas, AllSchemasShareBaseColumns) {
     auto schemas = {
         ParquetSchemas::book_snapshot_schema(),
         ParquetSchemas::book_delta_schema(),
+        ParquetSchemas::flat_book_delta_schema(),
         ParquetSchemas::trade_event_schema(),
         ParquetSchemas::tick_size_change_schema(),
     };
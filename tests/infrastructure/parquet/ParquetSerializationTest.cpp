@@ -41,10 +41,10 @@ TEST(ParquetSerialization, BookSnapshotRoundtrip) {
     arrow::Int64Builder ts_b;
     arrow::UInt64Builder seq_b;
 
-    auto bp_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto bs_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto ap_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto as_inner = std::make_shared<arrow::DoubleBuilder>();
+    auto bp_inner = std::make_shared<arrow::Int64Builder>();
+    auto bs_inner = std::make_shared<arrow::Int64Builder>();
+    auto ap_inner = std::make_shared<arrow::Int64Builder>();
+    auto as_inner = std::make_shared<arrow::Int64Builder>();
     arrow::ListBuilder bp_list(arrow::default_memory_pool(), bp_inner);
     arrow::ListBuilder bs_list(arrow::default_memory_pool(), bs_inner);
     arrow::ListBuilder ap_list(arrow::default_memory_pool(), ap_inner);
@@ -57,16 +57,16 @@ TEST(ParquetSerialization, BookSnapshotRoundtrip) {
     (void)hash_b.Append("0xhash");
 
     (void)bp_list.Append();
-    (void)bp_inner->Append(0.48);
-    (void)bp_inner->Append(0.49);
+    (void)bp_inner->Append(480'000);
+    (void)bp_inner->Append(490'000);
     (void)bs_list.Append();
-    (void)bs_inner->Append(30.0);
-    (void)bs_inner->Append(20.0);
+    (void)bs_inner->Append(30'000'000);
+    (void)bs_inner->Append(20'000'000);
 
     (void)ap_list.Append();
-    (void)ap_inner->Append(0.52);
+    (void)ap_inner->Append(520'000);
     (void)as_list.Append();
-    (void)as_inner->Append(25.0);
+    (void)as_inner->Append(25'000'000);
 
     std::shared_ptr<arrow::Array> a1, a2, a3, a4, a5, a6, a7, a8, a9;
     (void)cid_b.Finish(&a1);
@@ -91,10 +91,10 @@ TEST(ParquetSerialization, BookSnapshotRoundtrip) {
         result->column(2)->chunk(0))->Value(0), 1000);
 
     auto bp = std::static_pointer_cast<arrow::ListArray>(result->column(5)->chunk(0));
-    auto bp_vals = std::static_pointer_cast<arrow::DoubleArray>(bp->values());
+    auto bp_vals = std::static_pointer_cast<arrow::Int64Array>(bp->values());
     EXPECT_EQ(bp->value_offset(1) - bp->value_offset(0), 2);
-    EXPECT_DOUBLE_EQ(bp_vals->Value(0), 0.48);
-    EXPECT_DOUBLE_EQ(bp_vals->Value(1), 0.49);
+    EXPECT_EQ(bp_vals->Value(0), 480'000);
+    EXPECT_EQ(bp_vals->Value(1), 490'000);
 }
 
 TEST(ParquetSerialization, TradeEventRoundtrip) {
@@ -103,15 +103,15 @@ TEST(ParquetSerialization, TradeEventRoundtrip) {
     arrow::StringBuilder cid_b, tid_b, fee_b;
     arrow::Int64Builder ts_b;
     arrow::UInt64Builder seq_b;
-    arrow::DoubleBuilder price_b, size_b;
+    arrow::Int64Builder price_b, size_b;
     arrow::UInt8Builder side_b;
 
     (void)cid_b.Append("0xabc");
     (void)tid_b.Append("12345");
     (void)ts_b.Append(2000);
     (void)seq_b.Append(5);
-    (void)price_b.Append(0.456);
-    (void)size_b.Append(219.22);
+    (void)price_b.Append(456'000);
+    (void)size_b.Append(219'220'000);
     (void)side_b.Append(static_cast<uint8_t>(Side::BUY));
     (void)fee_b.Append("100");
 
@@ -129,10 +129,10 @@ TEST(ParquetSerialization, TradeEventRoundtrip) {
     auto result = roundtrip(table);
 
     ASSERT_EQ(result->num_rows(), 1);
-    EXPECT_DOUBLE_EQ(std::static_pointer_cast<arrow::DoubleArray>(
-        result->column(4)->chunk(0))->Value(0), 0.456);
-    EXPECT_DOUBLE_EQ(std::static_pointer_cast<arrow::DoubleArray>(
-        result->column(5)->chunk(0))->Value(0), 219.22);
+    EXPECT_EQ(std::static_pointer_cast<arrow::Int64Array>(
+        result->column(4)->chunk(0))->Value(0), 456'000);
+    EXPECT_EQ(std::static_pointer_cast<arrow::Int64Array>(
+        result->column(5)->chunk(0))->Value(0), 219'220'000);
     EXPECT_EQ(std::static_pointer_cast<arrow::UInt8Array>(
         result->column(6)->chunk(0))->Value(0), static_cast<uint8_t>(Side::BUY));
     EXPECT_EQ(std::static_pointer_cast<arrow::StringArray>(
@@ -147,11 +147,11 @@ TEST(ParquetSerialization, BookDeltaRoundtrip) {
     arrow::UInt64Builder seq_b;
 
     auto aids_inner = std::make_shared<arrow::StringBuilder>();
-    auto prices_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto sizes_inner = std::make_shared<arrow::DoubleBuilder>();
+    auto prices_inner = std::make_shared<arrow::Int64Builder>();
+    auto sizes_inner = std::make_shared<arrow::Int64Builder>();
     auto sides_inner = std::make_shared<arrow::UInt8Builder>();
-    auto bbids_inner = std::make_shared<arrow::DoubleBuilder>();
-    auto basks_inner = std::make_shared<arrow::DoubleBuilder>();
+    auto bbids_inner = std::make_shared<arrow::Int64Builder>();
+    auto basks_inner = std::make_shared<arrow::Int64Builder>();
 
     arrow::ListBuilder aids_list(arrow::default_memory_pool(), aids_inner);
     arrow::ListBuilder prices_list(arrow::default_memory_pool(), prices_inner);
@@ -173,11 +173,11 @@ TEST(ParquetSerialization, BookDeltaRoundtrip) {
     (void)basks_list.Append();
 
     (void)aids_inner->Append("12345");
-    (void)prices_inner->Append(0.50);
-    (void)sizes_inner->Append(100.0);
+    (void)prices_inner->Append(500'000);
+    (void)sizes_inner->Append(100'000'000);
     (void)sides_inner->Append(static_cast<uint8_t>(Side::BUY));
-    (void)bbids_inner->Append(0.50);
-    (void)basks_inner->Append(0.52);
+    (void)bbids_inner->Append(500'000);
+    (void)basks_inner->Append(520'000);
 
     std::shared_ptr<arrow::Array> a1, a2, a3, a4, a5, a6, a7, a8, a9, a10;
     (void)cid_b.Finish(&a1);
@@ -206,14 +206,14 @@ TEST(ParquetSerialization, TickSizeChangeRoundtrip) {
     arrow::StringBuilder cid_b, tid_b;
     arrow::Int64Builder ts_b;
     arrow::UInt64Builder seq_b;
-    arrow::DoubleBuilder old_b, new_b;
+    arrow::Int64Builder old_b, new_b;
 
     (void)cid_b.Append("0xabc");
     (void)tid_b.Append("12345");
     (void)ts_b.Append(4000);
     (void)seq_b.Append(20);
-    (void)old_b.Append(0.01);
-    (void)new_b.Append(0.001);
+    (void)old_b.Append(10'000);
+    (void)new_b.Append(1'000);
 
     std::shared_ptr<arrow::Array> a1, a2, a3, a4, a5, a6;
     (void)cid_b.Finish(&a1);
@@ -227,8 +227,8 @@ TEST(ParquetSerialization, TickSizeChangeRoundtrip) {
     auto result = roundtrip(table);
 
     ASSERT_EQ(result->num_rows(), 1);
-    EXPECT_DOUBLE_EQ(std::static_pointer_cast<arrow::DoubleArray>(
-        result->column(4)->chunk(0))->Value(0), 0.01);
-    EXPECT_DOUBLE_EQ(std::static_pointer_cast<arrow::DoubleArray>(
-        result->column(5)->chunk(0))->Value(0), 0.001);
+    EXPECT_EQ(std::static_pointer_cast<arrow::Int64Array>(
+        result->column(4)->chunk(0))->Value(0), 10'000);
+    EXPECT_EQ(std::static_pointer_cast<arrow::Int64Array>(
+        result->column(5)->chunk(0))->Value(0), 1'000);
 }
@@ -0,0 +1,79 @@
+#include "repositories/InMemoryOrderBookRepository.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace mde::domain;
+using mde::repositories::InMemoryOrderBookRepository;
+using mde::repositories::InMemoryRetention;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+const MarketAsset kNo("0xbd31dc", "4815162");
+
+TradeEvent make_trade(const MarketAsset& asset, uint64_t seq, int64_t ts = 1000) {
+    return TradeEvent{{asset, Timestamp(ts), seq}, Price(0.50), Quantity(1.0), Side::BUY, ""};
+}
+
+std::vector<uint64_t> sequences(const std::vector<OrderBookEventVariant>& events) {
+    std::vector<uint64_t> out;
+    for (const auto& event : events) out.push_back(std::visit([](const auto& e) { return e.sequence_number; }, event));
+    return out;
+}
+
+} // namespace
+
+TEST(InMemoryOrderBookRepository, ReturnsOnlyTheAssetsEventsAfterTheSequence) {
+    InMemoryOrderBookRepository repo;
+    for (uint64_t seq = 1; seq <= 40; ++seq) repo.append_event(make_trade(seq % 2 ? kYes : kNo, seq));
+
+    EXPECT_EQ(sequences(repo.get_events_since(kYes, 30)), (std::vector<uint64_t>{31, 33, 35, 37, 39}));
+    EXPECT_EQ(sequences(repo.get_events_since(kNo, 36)), (std::vector<uint64_t>{38, 40}));
+    EXPECT_EQ(repo.get_events_since(kYes, 0).size(), 20u);
+    EXPECT_TRUE(repo.get_events_since(kYes, 40).empty());
+    EXPECT_TRUE(repo.get_events_since(MarketAsset("0xother", "1"), 0).empty());
+    EXPECT_EQ(repo.event_count(), 40u);
+    EXPECT_EQ(sequences(repo.events()).front(), 1u);
+    EXPECT_EQ(sequences(repo.events()).back(), 40u);
+}
+
+TEST(InMemoryOrderBookRepository, KeepsTheNewestEventsPerAsset) {
+    InMemoryRetention retention;
+    retention.max_events_per_asset = 5;
+    InMemoryOrderBookRepository repo(retention);
+    for (uint64_t seq = 1; seq <= 100; ++seq) repo.append_event(make_trade(kYes, seq));
+    repo.append_event(make_trade(kNo, 101));
+
+    EXPECT_EQ(sequences(repo.get_events_since(kYes, 0)), (std::vector<uint64_t>{96, 97, 98, 99, 100}));
+    EXPECT_EQ(sequences(repo.get_events_since(kYes, 97)), (std::vector<uint64_t>{98, 99, 100}));
+    EXPECT_EQ(repo.get_events_since(kNo, 0).size(), 1u);
+    EXPECT_EQ(repo.event_count(), 6u);
+}
+
+TEST(InMemoryOrderBookRepository, MaxSequenceOutlivesRetention) {
+    InMemoryRetention retention;
+    retention.max_events_per_asset = 1;
+    InMemoryOrderBookRepository repo(retention);
+    EXPECT_EQ(repo.max_sequence_number(), 0u);
+
+    repo.append_event(make_trade(kYes, 7));
+    repo.append_event(make_trade(kYes, 3));  // drops 7
+    EXPECT_EQ(repo.max_sequence_number(), 7u);
+}
+
+TEST(InMemoryOrderBookRepository, DropsEventsOutsideTheTimeWindow) {
+    InMemoryRetention retention;
+    retention.max_age = std::chrono::seconds(10);
+    InMemoryOrderBookRepository repo(retention);
+    for (uint64_t seq = 1; seq <= 30; ++seq) repo.append_event(make_trade(kYes, seq, static_cast<int64_t>(seq) * 1000));
+    // kNo's clock is its own
+    repo.append_event(make_trade(kNo, 31, 1000));
+
+    EXPECT_EQ(sequences(repo.get_events_since(kYes, 0)).front(), 20u);
+    EXPECT_EQ(repo.get_events_since(kYes, 0).size(), 11u);
+    EXPECT_EQ(repo.get_events_since(kNo, 0).size(), 1u);
+    EXPECT_EQ(repo.event_count(), 12u);
+}
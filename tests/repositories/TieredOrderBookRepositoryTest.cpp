@@ -0,0 +1,115 @@
+#include "repositories/TieredOrderBookRepository.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::repositories;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+const MarketAsset kNo("0xbd31dc", "4815162");
+
+TradeEvent make_trade(const MarketAsset& asset, uint64_t seq) {
+    return TradeEvent{{asset, Timestamp(static_cast<int64_t>(seq) * 1000), seq}, Price(0.50), Quantity(1.0),
+                      Side::BUY, ""};
+}
+
+std::vector<uint64_t> sequences(const std::vector<OrderBookEventVariant>& events) {
+    std::vector<uint64_t> out;
+    for (const auto& event : events) out.push_back(std::visit([](const auto& e) { return e.sequence_number; }, event));
+    return out;
+}
+
+class TieredOrderBookRepositoryTest : public ::testing::Test {
+protected:
+    InMemoryOrderBookRepository* cold = nullptr;
+    InMemoryOrderBookRepository* warm = nullptr;
+
+    // kYes events 1..10 from an earlier run are only in the cold store
+    std::unique_ptr<TieredOrderBookRepository> make(bool with_warm) {
+        auto cold_store = std::make_unique<InMemoryOrderBookRepository>();
+        cold = cold_store.get();
+        for (uint64_t seq = 1; seq <= 10; ++seq) cold->append_event(make_trade(kYes, seq));
+        std::unique_ptr<InMemoryOrderBookRepository> warm_store;
+        if (with_warm) {
+            warm_store = std::make_unique<InMemoryOrderBookRepository>();
+            warm = warm_store.get();
+        }
+        InMemoryRetention hot;
+        hot.max_events_per_asset = 5;
+        auto repo = std::make_unique<TieredOrderBookRepository>(std::move(cold_store), hot, std::move(warm_store));
+        // 11..30, alternating assets: the hot tail keeps kYes 21..29
+        for (uint64_t seq = 11; seq <= 30; ++seq) repo->append_event(make_trade(seq % 2 ? kYes : kNo, seq));
+        return repo;
+    }
+};
+
+} // namespace
+
+TEST_F(TieredOrderBookRepositoryTest, ServesRecentRangesFromTheHotTail) {
+    auto repo = make(false);
+
+    EXPECT_EQ(sequences(repo->get_events_since(kYes, 24)), (std::vector<uint64_t>{25, 27, 29}));
+    EXPECT_EQ(sequences(repo->get_events_since(kNo, 30)), std::vector<uint64_t>{});
+    EXPECT_EQ(repo->hot_reads(), 2u);
+    EXPECT_EQ(repo->cold_reads(), 0u);
+    EXPECT_EQ(repo->hot_events(), 10u);
+}
+
+TEST_F(TieredOrderBookRepositoryTest, FallsThroughForOlderRanges) {
+    auto repo = make(false);
+
+    // Evicted from the hot tail
+    EXPECT_EQ(sequences(repo->get_events_since(kYes, 14)), (std::vector<uint64_t>{15, 17, 19, 21, 23, 25, 27, 29}));
+    // Before this run
+    EXPECT_EQ(repo->get_events_since(kYes, 5).size(), 15u);
+    EXPECT_EQ(repo->cold_reads(), 2u);
+    EXPECT_EQ(repo->hot_reads(), 0u);
+}
+
+TEST_F(TieredOrderBookRepositoryTest, WarmTierServesWhatTheHotTailDropped) {
+    auto repo = make(true);
+
+    EXPECT_EQ(sequences(repo->get_events_since(kYes, 14)), (std::vector<uint64_t>{15, 17, 19, 21, 23, 25, 27, 29}));
+    EXPECT_EQ(repo->warm_reads(), 1u);
+    // The warm tier only holds this run
+    EXPECT_EQ(repo->get_events_since(kYes, 5).size(), 15u);
+    EXPECT_EQ(repo->cold_reads(), 1u);
+    EXPECT_EQ(warm->event_count(), 20u);
+    EXPECT_EQ(cold->event_count(), 30u);
+}
+
+TEST_F(TieredOrderBookRepositoryTest, ReplayReadsTheTierEveryAssetIsIn) {
+    auto repo = make(false);
+    std::vector<uint64_t> visited;
+    auto collect = [&](OrderBookEventVariant&& event) {
+        visited.push_back(std::visit([](const auto& e) { return e.sequence_number; }, event));
+        return true;
+    };
+
+    EXPECT_EQ(repo->replay_events({kYes, kNo}, 26, collect), 4u);
+    EXPECT_EQ(visited, (std::vector<uint64_t>{27, 28, 29, 30}));
+    EXPECT_EQ(repo->hot_reads(), 1u);
+
+    visited.clear();
+    EXPECT_EQ(repo->replay_events({kYes, kNo}, 16, collect), 14u);
+    EXPECT_EQ(repo->cold_reads(), 1u);
+}
+
+TEST_F(TieredOrderBookRepositoryTest, BatchesReachEveryTierAndSnapshotsTheColdStore) {
+    auto repo = make(true);
+    std::vector<OrderBookEventVariant> batch{make_trade(kYes, 31), make_trade(kNo, 32)};
+    repo->append_events(batch);
+    repo->store_snapshot(OrderBook::empty(kYes));
+
+    EXPECT_EQ(sequences(repo->get_events_since(kNo, 30)), (std::vector<uint64_t>{32}));
+    EXPECT_EQ(warm->event_count(), 22u);
+    EXPECT_EQ(cold->event_count(), 32u);
+    EXPECT_TRUE(cold->has_snapshot(kYes));
+    EXPECT_FALSE(warm->has_snapshot(kYes));
+    EXPECT_TRUE(repo->get_latest_snapshot(kYes));
+}
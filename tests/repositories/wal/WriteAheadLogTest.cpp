@@ -0,0 +1,187 @@
+#include "repositories/wal/WriteAheadLog.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::repositories::wal;
+
+namespace {
+
+const MarketAsset kAsset("0xbd31dc", "6581861");
+
+BookSnapshot make_snapshot(uint64_t seq) {
+    return BookSnapshot{{kAsset, Timestamp(1000), seq},
+                        {PriceLevel(Price(0.48), Quantity(30.0)), PriceLevel(Price(0.47), Quantity(5.5))},
+                        {PriceLevel(Price(0.52), Quantity(25.0))},
+                        "0xabc"};
+}
+
+BookDelta make_delta(uint64_t seq) {
+    return BookDelta{{kAsset, Timestamp(1001), seq},
+                     {PriceLevelDelta{"6581861", Price(0.49), Quantity(12.0), Side::BUY,
+                                      Price(0.49), Price(0.52)}}};
+}
+
+class WriteAheadLogTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              ("mde_wal_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(dir);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    WalOptions options() const {
+        WalOptions opts;
+        opts.directory = dir.string();
+        return opts;
+    }
+
+    std::vector<OrderBookEventVariant> replay_all() const {
+        std::vector<OrderBookEventVariant> events;
+        WriteAheadLog log(options());
+        log.replay([&](uint64_t, OrderBookEventVariant&& event) { events.push_back(std::move(event)); });
+        return events;
+    }
+
+    std::vector<std::filesystem::path> segment_files() const {
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            if (std::filesystem::file_size(entry.path()) > 0) files.push_back(entry.path());
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+};
+
+} // namespace
+
+TEST_F(WriteAheadLogTest, ReplaysEveryEventTypeAfterReopening) {
+    {
+        WriteAheadLog log(options());
+        log.append(make_snapshot(1));
+        log.append(make_delta(2));
+        log.append(TradeEvent{{kAsset, Timestamp(1002), 3}, Price(0.50), Quantity(7.0), Side::SELL, "20"});
+        log.append(TickSizeChange{{kAsset, Timestamp(1003), 4}, Price(0.01), Price(0.001)});
+    }
+
+    auto events = replay_all();
+    ASSERT_EQ(events.size(), 4u);
+
+    const auto& snap = std::get<BookSnapshot>(events[0]);
+    EXPECT_EQ(snap.asset, kAsset);
+    EXPECT_EQ(snap.timestamp.milliseconds(), 1000);
+    EXPECT_EQ(snap.sequence_number, 1u);
+    EXPECT_EQ(snap.bids, make_snapshot(1).bids);
+    EXPECT_EQ(snap.asks, make_snapshot(1).asks);
+    EXPECT_EQ(snap.hash, "0xabc");
+
+    const auto& delta = std::get<BookDelta>(events[1]);
+    ASSERT_EQ(delta.changes.size(), 1u);
+    EXPECT_EQ(delta.changes[0].asset_id, "6581861");
+    EXPECT_EQ(delta.changes[0].price, Price(0.49));
+    EXPECT_EQ(delta.changes[0].new_size, Quantity(12.0));
+    EXPECT_EQ(delta.changes[0].side, Side::BUY);
+    EXPECT_EQ(delta.changes[0].best_ask, Price(0.52));
+
+    const auto& trade = std::get<TradeEvent>(events[2]);
+    EXPECT_EQ(trade.price, Price(0.50));
+    EXPECT_EQ(trade.side, Side::SELL);
+    EXPECT_EQ(trade.fee_rate_bps, "20");
+
+    const auto& tick = std::get<TickSizeChange>(events[3]);
+    EXPECT_EQ(tick.old_tick_size, Price(0.01));
+    EXPECT_EQ(tick.new_tick_size, Price(0.001));
+}
+
+TEST_F(WriteAheadLogTest, ReopeningStartsANewSegment) {
+    uint64_t first = 0;
+    {
+        WriteAheadLog log(options());
+        first = log.append(make_delta(1));
+    }
+    WriteAheadLog log(options());
+    EXPECT_EQ(log.append(make_delta(2)), first + 1);
+}
+
+TEST_F(WriteAheadLogTest, TornTailIsIgnored) {
+    {
+        WriteAheadLog log(options());
+        log.append(make_delta(1));
+        log.append(make_delta(2));
+    }
+    auto segment = segment_files().front();
+    std::filesystem::resize_file(segment, std::filesystem::file_size(segment) - 3);
+
+    auto events = replay_all();
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(std::get<BookDelta>(events[0]).sequence_number, 1u);
+}
+
+TEST_F(WriteAheadLogTest, CorruptRecordEndsItsSegment) {
+    size_t first_record = 0;
+    {
+        WriteAheadLog log(options());
+        log.append(make_delta(1));
+        first_record = log.stats().bytes_appended;
+        log.append(make_delta(2));
+        log.append(make_delta(3));
+    }
+    auto segment = segment_files().front();
+    {
+        std::fstream file(segment, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(first_record + 12));
+        file.put('\x7f');
+    }
+
+    EXPECT_EQ(replay_all().size(), 1u);
+}
+
+TEST_F(WriteAheadLogTest, RotatesSegmentsAndReleasesOldOnes) {
+    auto opts = options();
+    opts.segment_bytes = 1;  // every record after the first in a segment rotates
+    WriteAheadLog log(opts);
+    auto first = log.append(make_delta(1));
+    log.append(make_delta(2));
+    auto last = log.append(make_delta(3));
+    EXPECT_EQ(last, first + 2);
+    EXPECT_EQ(segment_files().size(), 3u);
+
+    log.release_before(last);
+    EXPECT_EQ(segment_files().size(), 1u);
+    EXPECT_EQ(log.stats().segments_released, 2u);
+
+    std::vector<uint64_t> seqs;
+    log.replay([&](uint64_t segment, OrderBookEventVariant&& event) {
+        EXPECT_EQ(segment, last);
+        seqs.push_back(std::get<BookDelta>(event).sequence_number);
+    });
+    EXPECT_EQ(seqs, std::vector<uint64_t>{3});
+}
+
+TEST_F(WriteAheadLogTest, GroupCommitSyncsAtMostOncePerInterval) {
+    auto opts = options();
+    opts.sync_interval = std::chrono::hours(1);
+    WriteAheadLog log(opts);
+    for (uint64_t seq = 1; seq <= 100; ++seq) log.append(make_delta(seq));
+    EXPECT_EQ(log.stats().syncs, 0u);
+    EXPECT_EQ(log.stats().records_appended, 100u);
+
+    log.sync();
+    EXPECT_EQ(log.stats().syncs, 1u);
+
+    opts.sync_interval = std::chrono::milliseconds(0);
+    WriteAheadLog every_append(opts);
+    every_append.append(make_delta(101));
+    every_append.append(make_delta(102));
+    EXPECT_EQ(every_append.stats().syncs, 2u);
+}
@@ -0,0 +1,136 @@
+#include "repositories/InMemoryOrderBookRepository.hpp"
+#include "services/BacktestRunner.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::services;
+using mde::repositories::InMemoryOrderBookRepository;
+
+namespace {
+
+BookSnapshot make_snapshot(const MarketAsset& asset, uint64_t seq, int64_t ts) {
+    return BookSnapshot{{asset, Timestamp(ts), seq},
+                        {PriceLevel(Price(0.40), Quantity(30.0))},
+                        {PriceLevel(Price(0.60), Quantity(25.0))},
+                        "0xabc"};
+}
+
+BookDelta make_delta(const MarketAsset& asset, uint64_t seq, int64_t ts, Price price) {
+    return BookDelta{{asset, Timestamp(ts), seq},
+                     {PriceLevelDelta{asset.token(), price, Quantity(10.0), Side::BUY,
+                                      price, Price(0.60)}}};
+}
+
+BacktestOptions on_threads(size_t threads) {
+    BacktestOptions options;
+    options.threads = threads;
+    return options;
+}
+
+// Interleaved history of eight assets; asset i gets 2 + i deltas
+class BacktestRunnerTest : public ::testing::Test {
+protected:
+    InMemoryOrderBookRepository repo;
+    std::vector<MarketAsset> assets;
+
+    void SetUp() override {
+        for (int i = 0; i < 8; ++i) {
+            assets.emplace_back("0xbd31dc", std::to_string(1000 + i));
+        }
+        uint64_t seq = 0;
+        for (const auto& asset : assets) repo.append_event(make_snapshot(asset, ++seq, 1000));
+        for (int step = 0; step < 10; ++step) {
+            for (size_t i = 0; i < assets.size(); ++i) {
+                if (step >= static_cast<int>(i) + 2) continue;
+                repo.append_event(make_delta(assets[i], ++seq, 2000 + step * 1000, Price(0.41 + step * 0.01)));
+            }
+        }
+    }
+
+    // Sequence numbers each asset's strategy saw, one list per asset
+    std::vector<std::vector<uint64_t>> run_collecting(BacktestRunner& runner, size_t threads,
+                                                      BacktestResult* out = nullptr) {
+        std::vector<std::vector<uint64_t>> seen(assets.size());
+        auto result = runner.run(assets, [&](const MarketAsset& asset) -> BacktestRunner::Strategy {
+            auto* log = &seen[std::stoi(asset.token_id()) - 1000];
+            return [log](const OrderBook& book, const OrderBookEventVariant& event) {
+                auto seq = std::visit([](const auto& e) { return e.sequence_number; }, event);
+                EXPECT_EQ(book.get_last_sequence_number(), seq);
+                log->push_back(seq);
+            };
+        }, on_threads(threads));
+        if (out) *out = std::move(result);
+        return seen;
+    }
+};
+
+} // namespace
+
+TEST_F(BacktestRunnerTest, ReplaysEveryAssetOnItsOwnBook) {
+    BacktestRunner runner(repo);
+    BacktestResult result;
+    run_collecting(runner, 4, &result);
+
+    ASSERT_EQ(result.assets.size(), assets.size());
+    EXPECT_EQ(result.events, repo.event_count());
+    for (size_t i = 0; i < assets.size(); ++i) {
+        const auto& market = result.assets[i];
+        EXPECT_EQ(market.asset, assets[i]);
+        EXPECT_TRUE(market.error.empty());
+        EXPECT_EQ(market.stats.events, 3 + i);
+        EXPECT_EQ(market.book.get_asset(), assets[i]);
+        EXPECT_EQ(market.book.get_best_bid(), Price(0.41 + (i + 1) * 0.01));
+    }
+}
+
+TEST_F(BacktestRunnerTest, StrategiesSeeTheSameEventsWhateverTheThreadCount) {
+    BacktestRunner runner(repo);
+    auto serial = run_collecting(runner, 1);
+    for (size_t i = 0; i < serial.size(); ++i) {
+        EXPECT_TRUE(std::is_sorted(serial[i].begin(), serial[i].end()));
+        EXPECT_EQ(serial[i].size(), 3 + i);
+    }
+    for (size_t threads : {2u, 3u, 8u, 16u}) {
+        EXPECT_EQ(run_collecting(runner, threads), serial) << threads << " threads";
+    }
+}
+
+TEST_F(BacktestRunnerTest, StopsEachAssetAtUntil) {
+    BacktestRunner runner(repo);
+    BacktestOptions options;
+    options.threads = 3;
+    options.until = Timestamp(3000);
+    auto result = runner.run(assets, {}, options);
+
+    for (const auto& market : result.assets) {
+        EXPECT_EQ(market.stats.events, 3u);  // snapshot and the deltas at 2000 and 3000
+        EXPECT_EQ(market.book.get_best_bid(), Price(0.42));
+    }
+}
+
+TEST_F(BacktestRunnerTest, RecordsAStrategyThatThrowsAndRunsTheRest) {
+    BacktestRunner runner(repo);
+    auto result = runner.run(assets, [&](const MarketAsset& asset) -> BacktestRunner::Strategy {
+        if (asset == assets[2]) throw std::runtime_error("bad market");
+        return {};
+    }, on_threads(2));
+
+    EXPECT_EQ(result.assets[2].error, "bad market");
+    EXPECT_EQ(result.assets[2].stats.events, 0u);
+    EXPECT_TRUE(result.assets[3].error.empty());
+    EXPECT_EQ(result.assets[3].stats.events, 6u);
+}
+
+TEST_F(BacktestRunnerTest, NoAssetsIsAnEmptyRun) {
+    BacktestRunner runner(repo);
+    auto result = runner.run({}, {}, on_threads(4));
+    EXPECT_TRUE(result.assets.empty());
+    EXPECT_EQ(result.events, 0u);
+}
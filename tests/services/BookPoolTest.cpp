@@ -0,0 +1,88 @@
+#include "services/BookPool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using mde::domain::MarketAsset;
+using mde::services::BookPool;
+
+namespace {
+
+MarketAsset asset(int n) {
+    return MarketAsset("0xpool", "pool-token-" + std::to_string(n));
+}
+
+} // namespace
+
+TEST(BookPool, FindsWhatWasEmplaced) {
+    BookPool<std::string> pool;
+    EXPECT_TRUE(pool.empty());
+    EXPECT_EQ(pool.find(asset(1)), pool.end());
+
+    auto [it, inserted] = pool.emplace(asset(1), "one");
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first, asset(1));
+    pool.emplace(asset(2), "two");
+
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_EQ(pool.find(asset(1))->second, "one");
+    EXPECT_EQ(pool.find(asset(2))->second, "two");
+    EXPECT_EQ(pool.find(asset(3)), pool.end());
+}
+
+TEST(BookPool, EmplaceKeepsAnExistingEntry) {
+    BookPool<std::string> pool;
+    pool.emplace(asset(1), "first");
+    auto [it, inserted] = pool.emplace(asset(1), "second");
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(it->second, "first");
+
+    pool.insert_or_assign(asset(1), "replaced");
+    EXPECT_EQ(pool.find(asset(1))->second, "replaced");
+    EXPECT_EQ(pool.size(), 1u);
+}
+
+TEST(BookPool, EntriesStayPutAndCacheLineAlignedAsThePoolGrows) {
+    BookPool<int> pool;
+    auto* first = &pool.emplace(asset(0), 0).first->second;
+    for (int n = 1; n < 1000; ++n) pool.emplace(asset(n), n);
+
+    EXPECT_EQ(&pool.find(asset(0))->second, first);
+    for (const auto& [key, value] : pool) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&key) % 64, 0u);
+    }
+}
+
+TEST(BookPool, IteratesInInsertionOrder) {
+    BookPool<int> pool;
+    for (int n : {5, 3, 9}) pool.emplace(asset(n), n);
+
+    std::vector<int> seen;
+    for (const auto& [key, value] : pool) seen.push_back(value);
+    EXPECT_EQ(seen, (std::vector<int>{5, 3, 9}));
+}
+
+TEST(BookPool, ErasedSlotsAreSkippedAndReused) {
+    BookPool<int> pool;
+    for (int n = 0; n < 3; ++n) pool.emplace(asset(n), n);
+    auto* last = &pool.find(asset(2))->second;
+
+    EXPECT_TRUE(pool.erase(asset(1)));
+    EXPECT_FALSE(pool.erase(asset(1)));
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_EQ(pool.find(asset(1)), pool.end());
+    EXPECT_EQ(&pool.find(asset(2))->second, last);
+
+    std::vector<int> seen;
+    for (const auto& [key, value] : pool) seen.push_back(value);
+    EXPECT_EQ(seen, (std::vector<int>{0, 2}));
+
+    EXPECT_TRUE(pool.erase(asset(0)));
+    pool.emplace(asset(3), 3);
+    seen.clear();
+    for (const auto& [key, value] : pool) seen.push_back(value);
+    EXPECT_EQ(seen, (std::vector<int>{3, 2}));  // in the slot asset 0 left
+}
@@ -0,0 +1,136 @@
+#include "repositories/InMemoryOrderBookRepository.hpp"
+#include "services/ConflatedPublisher.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::services;
+using mde::repositories::InMemoryOrderBookRepository;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+const MarketAsset kNo("0xbd31dc", "4815162");
+
+class SilentFeed : public IMarketDataFeed {
+public:
+    void set_on_event(EventCallback) override {}
+    void subscribe(const std::string&) override {}
+    void start() override {}
+    void stop() override {}
+};
+
+BookSnapshot make_snapshot(const MarketAsset& asset) {
+    return BookSnapshot{{asset, Timestamp(1000), 0},
+                        {PriceLevel(Price(0.47), Quantity(10.0)), PriceLevel(Price(0.48), Quantity(30.0)),
+                         PriceLevel(Price(0.49), Quantity(20.0))},
+                        {PriceLevel(Price(0.52), Quantity(25.0)), PriceLevel(Price(0.53), Quantity(60.0))},
+                        "0xabc"};
+}
+
+BookDelta make_delta(const MarketAsset& asset, int64_t ts, Price price) {
+    return BookDelta{{asset, Timestamp(ts), 0},
+                     {PriceLevelDelta{asset.token(), price, Quantity(5.0), Side::BUY, price, Price(0.52)}}};
+}
+
+class ConflatedPublisherTest : public ::testing::Test {
+protected:
+    InMemoryOrderBookRepository repo;
+    SilentFeed feed;
+    OrderBookService service{repo, feed, 0};
+    std::vector<std::vector<BookLevels>> batches;
+
+    ConflatedPublisher::Sink sink() {
+        return [this](std::span<const BookLevels> books) { batches.emplace_back(books.begin(), books.end()); };
+    }
+};
+
+} // namespace
+
+TEST_F(ConflatedPublisherTest, PublishesEachChangedAssetOncePerFlush) {
+    ConflatedPublisher publisher(service, sink(), {std::chrono::milliseconds(50), 2});
+
+    service.on_event(make_snapshot(kYes));
+    service.on_event(make_snapshot(kNo));
+    for (int64_t ts = 2000; ts < 2100; ++ts) {
+        service.on_event(make_delta(kYes, ts, Price(0.50)));
+    }
+    EXPECT_EQ(publisher.poll(), 102u);
+    EXPECT_EQ(publisher.flush(), 2u);
+
+    ASSERT_EQ(batches.size(), 1u);
+    const auto& yes = batches[0][0];
+    EXPECT_EQ(yes.asset, kYes);
+    EXPECT_EQ(yes.timestamp, Timestamp(2099));
+    EXPECT_EQ(yes.last_sequence_number, 102u);
+    ASSERT_EQ(yes.bids.size(), 2u);  // depth-limited, best first
+    EXPECT_EQ(yes.bids[0].price(), Price(0.50));
+    EXPECT_EQ(yes.bids[1].price(), Price(0.49));
+    ASSERT_EQ(yes.asks.size(), 2u);
+    EXPECT_EQ(yes.asks[0].price(), Price(0.52));
+    EXPECT_EQ(batches[0][1].asset, kNo);
+
+    // Nothing changed since
+    EXPECT_EQ(publisher.flush(), 0u);
+    service.on_event(make_delta(kNo, 3000, Price(0.50)));
+    publisher.poll();
+    EXPECT_EQ(publisher.flush(), 1u);
+    ASSERT_EQ(batches.size(), 2u);
+    EXPECT_EQ(batches[1][0].asset, kNo);
+    EXPECT_EQ(publisher.books_published(), 3u);
+    EXPECT_EQ(publisher.events_seen(), 103u);
+}
+
+TEST_F(ConflatedPublisherTest, CarriesTheStaleFlag) {
+    ConflatedPublisher publisher(service, sink());
+    service.on_event(make_snapshot(kYes));
+    const std::vector<std::string> dropped = {"6581861"};
+    service.mark_stale(dropped);
+
+    publisher.poll();
+    publisher.flush();
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_TRUE(batches[0][0].stale);
+}
+
+TEST_F(ConflatedPublisherTest, RepublishesEveryKnownAssetAfterFallingBehind) {
+    ConflatedPublisher publisher(service, sink());
+    service.on_event(make_snapshot(kYes));
+    service.on_event(make_snapshot(kNo));
+    publisher.poll();
+    publisher.flush();
+
+    // Lap the ring with kYes alone; kNo's change is among what was lost
+    service.on_event(make_delta(kNo, 2000, Price(0.50)));
+    for (size_t i = 0; i < service.events().capacity() + 1; ++i) {
+        service.on_event(make_delta(kYes, 3000, Price(0.50)));
+    }
+    publisher.poll();
+    EXPECT_GT(publisher.events_dropped(), 0u);
+    EXPECT_EQ(publisher.flush(), 2u);
+}
+
+TEST_F(ConflatedPublisherTest, WorkerFlushesOnItsInterval) {
+    ConflatedPublisher publisher(service, sink(), {std::chrono::milliseconds(5), 10});
+    publisher.start();
+    service.on_event(make_snapshot(kYes));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (publisher.books_published() < 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    publisher.stop();
+
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_EQ(batches[0][0].asset, kYes);
+}
+
+TEST_F(ConflatedPublisherTest, RejectsBadOptions) {
+    EXPECT_THROW(ConflatedPublisher(service, sink(), {std::chrono::milliseconds(0), 10}), std::invalid_argument);
+    EXPECT_THROW(ConflatedPublisher(service, sink(), {std::chrono::milliseconds(10), 0}), std::invalid_argument);
+}
@@ -0,0 +1,89 @@
+#include "services/EventBus.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using mde::services::EventBus;
+
+TEST(EventBus, EverySubscriberSeesEveryValue) {
+    EventBus<std::string> bus(8);
+    auto first = bus.subscribe();
+    auto second = bus.subscribe();
+
+    bus.publish("a");
+    bus.publish("b");
+
+    std::vector<std::string> seen;
+    EXPECT_EQ(first.poll([&](const std::string& v) { seen.push_back(v); }), 2);
+    EXPECT_EQ(seen, (std::vector<std::string>{"a", "b"}));
+
+    // Both read the same stored entry
+    auto entry = second.next();
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->value, "a");
+    EXPECT_EQ(entry->sequence, 0);
+    EXPECT_EQ(second.next()->value, "b");
+    EXPECT_EQ(second.next(), nullptr);
+}
+
+TEST(EventBus, SubscriptionStartsAtHead) {
+    EventBus<int> bus(8);
+    bus.publish(1);
+    auto late = bus.subscribe();
+    bus.publish(2);
+
+    ASSERT_NE(late.next(), nullptr);
+    EXPECT_EQ(late.cursor(), 2);
+    EXPECT_EQ(late.next(), nullptr);
+}
+
+TEST(EventBus, SlowSubscriberDropsOldestInsteadOfBlocking) {
+    EventBus<int> bus(4);
+    auto slow = bus.subscribe();
+    for (int i = 0; i < 10; ++i) {
+        bus.publish(i);
+    }
+
+    std::vector<int> seen;
+    slow.poll([&](int v) { seen.push_back(v); });
+    EXPECT_EQ(seen, (std::vector<int>{6, 7, 8, 9}));
+    EXPECT_EQ(slow.dropped(), 6);
+}
+
+TEST(EventBus, TracksSubscribers) {
+    EventBus<int> bus(4);
+    EXPECT_FALSE(bus.has_subscribers());
+    {
+        auto subscription = bus.subscribe();
+        EXPECT_TRUE(bus.has_subscribers());
+    }
+    EXPECT_FALSE(bus.has_subscribers());
+}
+
+TEST(EventBus, ConsumerThreadsReadInOrder) {
+    constexpr int kCount = 20000;
+    EventBus<int> bus(kCount);  // Large enough that nothing is dropped
+
+    auto consume = [&bus](EventBus<int>::Subscription subscription) {
+        int expected = 0;
+        while (expected < kCount) {
+            auto entry = subscription.next();
+            if (!entry) {
+                std::this_thread::yield();
+                continue;
+            }
+            ASSERT_EQ(entry->value, expected);
+            ++expected;
+        }
+    };
+    std::thread a(consume, bus.subscribe());
+    std::thread b(consume, bus.subscribe());
+    for (int i = 0; i < kCount; ++i) {
+        bus.publish(i);
+    }
+    a.join();
+    b.join();
+}
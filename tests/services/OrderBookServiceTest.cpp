@@ -4,6 +4,14 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <span>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
 using namespace mde::domain;
 using namespace mde::services;
 using mde::repositories::InMemoryOrderBookRepository;
@@ -14,13 +22,19 @@ class FakeMarketDataFeed : public IMarketDataFeed {
     EventCallback on_event_;
 
 public:
+    std::vector<std::string> subscribed;
     void set_on_event(EventCallback cb) override { on_event_ = std::move(cb); }
-    void subscribe(const std::string&) override {}
+    std::vector<std::string> unsubscribed;
+
+    void subscribe(const std::string& token_id) override { subscribed.push_back(token_id); }
+    void unsubscribe_all(std::span<const std::string> token_ids) override {
+        unsubscribed.insert(unsubscribed.end(), token_ids.begin(), token_ids.end());
+    }
     void start() override {}
     void stop() override {}
 
     void emit(const OrderBookEventVariant& event) {
-        if (on_event_) on_event_(event);
+        if (on_event_) on_event_(OrderBookEventVariant(event));
     }
 };
 
@@ -58,6 +72,14 @@ TEST_F(OrderBookServiceTest, PersistsEventAndUpdatesProjection) {
     EXPECT_DOUBLE_EQ(book.get_best_ask().value(), 0.52);
 }
 
+TEST_F(OrderBookServiceTest, SubscribesABatchThroughTheFeed) {
+    OrderBookService service(repo, feed);
+    std::vector<std::string> tokens{"1", "2", "3"};
+
+    service.subscribe_all(tokens);
+    EXPECT_EQ(feed.subscribed, tokens);
+}
+
 TEST_F(OrderBookServiceTest, AssignsSequenceNumbers) {
     OrderBookService service(repo, feed);
 
@@ -69,7 +91,7 @@ TEST_F(OrderBookServiceTest, AssignsSequenceNumbers) {
     };
     feed.emit(trade);
 
-    auto& events = repo.events();
+    auto events = repo.events();
     auto seq1 = std::visit([](const auto& e) { return e.sequence_number; }, events[0]);
     auto seq2 = std::visit([](const auto& e) { return e.sequence_number; }, events[1]);
 
@@ -160,6 +182,167 @@ TEST_F(OrderBookServiceTest, SnapshotsAtConfiguredInterval) {
     EXPECT_TRUE(repo.has_snapshot(asset));
 }
 
+TEST_F(OrderBookServiceTest, EventThresholdCountsEachBookSeparately) {
+    MarketAsset other{"0xbd31dc", "4821793"};
+    OrderBookService service(repo, feed, /*snapshot_every_events=*/2);
+
+    // Global sequence numbers 1..3; each book has seen fewer than two events
+    // until the last one
+    feed.emit(make_snapshot());
+    feed.emit(TradeEvent{{other, Timestamp(2000), 0}, Price(0.50), Quantity(10.0), Side::BUY, "0"});
+    EXPECT_FALSE(repo.has_snapshot(asset));
+    EXPECT_FALSE(repo.has_snapshot(other));
+
+    feed.emit(make_snapshot());
+    EXPECT_TRUE(repo.has_snapshot(asset));
+    EXPECT_FALSE(repo.has_snapshot(other));
+}
+
+TEST_F(OrderBookServiceTest, ShardedModeSnapshotsQuietBooksByAge) {
+    OrderBookService service(repo, feed, /*snapshot_every_events=*/0, /*shard_count=*/1,
+                             /*queue_capacity=*/1024, std::chrono::milliseconds(20));
+
+    feed.emit(make_snapshot());
+
+    // No further events: the idle worker's sweep stores the dirty book
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    service.stop();
+    EXPECT_TRUE(repo.has_snapshot(asset));
+}
+
+// --- Published snapshots ---
+
+TEST_F(OrderBookServiceTest, BookSnapshotIsImmutableAndTracksLaterEvents) {
+    OrderBookService service(repo, feed);
+    feed.emit(make_snapshot());
+
+    auto first = service.get_book_snapshot(asset);
+    feed.emit(TradeEvent{{asset, Timestamp(2000), 0}, Price(0.50), Quantity(10.0), Side::BUY, "0"});
+    auto second = service.get_book_snapshot(asset);
+
+    EXPECT_EQ(first->get_last_sequence_number(), 1);   // held versions never change
+    EXPECT_EQ(second->get_last_sequence_number(), 2);
+    EXPECT_THROW(service.get_book_snapshot(MarketAsset("0x000", "999")), std::runtime_error);
+}
+
+TEST_F(OrderBookServiceTest, TopLevelsCopyOnlyTheBestLevels) {
+    for (size_t shards : {size_t{0}, size_t{2}}) {
+        InMemoryOrderBookRepository repository;
+        FakeMarketDataFeed source;
+        OrderBookService service(repository, source, 0, shards);
+        source.emit(make_snapshot());
+        service.drain();
+
+        auto levels = service.get_top_levels(asset, 1);
+        ASSERT_TRUE(levels);
+        EXPECT_EQ(levels->last_sequence_number, 1u);
+        ASSERT_EQ(levels->bids.size(), 1u);
+        EXPECT_EQ(levels->bids[0].price(), Price(0.49));
+        ASSERT_EQ(levels->asks.size(), 1u);
+        EXPECT_EQ(levels->asks[0].price(), Price(0.52));
+        EXPECT_EQ(service.get_top_levels(asset, 10)->bids.size(), 2u);
+        EXPECT_FALSE(service.get_top_levels(MarketAsset("0x000", "999"), 1));
+    }
+}
+
+TEST_F(OrderBookServiceTest, ShardedReadersSeeConsistentBooksWhileIngesting) {
+    OrderBookService service(repo, feed, /*snapshot_every_events=*/0, /*shard_count=*/2);
+    feed.emit(make_snapshot());
+    service.drain();
+
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        uint64_t last_seen = 0;
+        while (!done.load()) {
+            auto book = service.get_book_snapshot(asset);
+            // Every version is a whole book, and versions only move forward
+            EXPECT_EQ(book->get_depth(), 2);
+            EXPECT_GE(book->get_last_sequence_number(), last_seen);
+            last_seen = book->get_last_sequence_number();
+            std::this_thread::yield();
+        }
+    });
+    for (int i = 0; i < 2000; ++i) {
+        feed.emit(make_snapshot());
+    }
+    service.drain();
+    done.store(true);
+    reader.join();
+
+    EXPECT_EQ(service.get_book_snapshot(asset)->get_last_sequence_number(), 2001);
+}
+
+TEST_F(OrderBookServiceTest, OnEventsAppliesRunsAndStoresEveryEvent) {
+    OrderBookService service(repo, feed, /*snapshot_every_events=*/3);
+    MarketAsset other{"0xbd31dc", "4815162"};
+    auto delta = [](const MarketAsset& a, double price, double size) {
+        return BookDelta{{a, Timestamp(2000), 0},
+                         {PriceLevelDelta{a.token(), Price(price), Quantity(size), Side::BUY,
+                                          Price(price), Price(0.52)}}};
+    };
+
+    std::vector<OrderBookEventVariant> events = {
+        make_snapshot(), delta(asset, 0.49, 0.0), delta(asset, 0.50, 5.0),
+        delta(other, 0.30, 1.0), delta(asset, 0.51, 2.0)};
+    service.on_events(events);
+
+    ASSERT_EQ(repo.event_count(), 5);
+    for (size_t i = 0; i < repo.events().size(); ++i) {
+        EXPECT_EQ(std::visit([](const auto& e) { return e.sequence_number; }, repo.events()[i]), i + 1);
+    }
+
+    const auto& book = service.get_current_book(asset);
+    EXPECT_EQ(book.get_best_bid(), Price(0.51));
+    EXPECT_EQ(book.get_bids().size(), 3);
+    EXPECT_EQ(book.get_last_sequence_number(), 5);
+    EXPECT_EQ(service.get_current_book(other).get_best_bid(), Price(0.30));
+
+    // The first run of three reached the threshold; the book is stored as of its end
+    auto snapshot = repo.get_latest_snapshot(asset);
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(snapshot->get_last_sequence_number(), 3);
+}
+
+TEST_F(OrderBookServiceTest, OnEventsAppliesTheRunsAfterOneThatThrows) {
+    OrderBookService service(repo, feed);
+    MarketAsset other{"0xbd31dc", "4815162"};
+    auto subscriber = service.events().subscribe();
+
+    std::vector<OrderBookEventVariant> events = {
+        make_snapshot(),
+        TickSizeChange{{other, Timestamp(2000), 0}, Price(0.01), Price(0.0003)},  // off the grid
+        TradeEvent{{asset, Timestamp(3000), 0}, Price(0.50), Quantity(10.0), Side::BUY, "0"}};
+    EXPECT_THROW(service.on_events(events), std::invalid_argument);
+
+    EXPECT_EQ(repo.event_count(), 3);
+    EXPECT_EQ(service.get_current_book(asset).get_last_sequence_number(), 3);
+
+    std::vector<uint64_t> published;
+    subscriber.poll([&](const OrderBookEventVariant& event) {
+        published.push_back(std::visit([](const auto& e) { return e.sequence_number; }, event));
+    });
+    EXPECT_EQ(published, (std::vector<uint64_t>{1, 3}));
+}
+
+// --- Event bus ---
+
+TEST_F(OrderBookServiceTest, PublishesAppliedEventsToSubscribers) {
+    OrderBookService service(repo, feed);
+    feed.emit(make_snapshot());  // before anyone subscribed
+
+    auto recorder = service.events().subscribe();
+    auto analytics = service.events().subscribe();
+    feed.emit(make_snapshot());
+    feed.emit(TradeEvent{{asset, Timestamp(2000), 0}, Price(0.50), Quantity(10.0), Side::BUY, "0"});
+
+    std::vector<uint64_t> sequences;
+    recorder.poll([&](const OrderBookEventVariant& event) {
+        sequences.push_back(std::visit([](const auto& e) { return e.sequence_number; }, event));
+    });
+    EXPECT_EQ(sequences, (std::vector<uint64_t>{2, 3}));
+    EXPECT_EQ(analytics.poll([](const OrderBookEventVariant&) {}), 2);
+}
+
 // --- resolve_asset and event_count ---
 
 TEST_F(OrderBookServiceTest, ResolveAssetFindsKnownToken) {
@@ -180,6 +363,19 @@ TEST_F(OrderBookServiceTest, ResolveAssetReturnsNulloptForUnknown) {
     EXPECT_FALSE(resolved.has_value());
 }
 
+TEST_F(OrderBookServiceTest, ResolveAssetsResolvesBatchInOrder) {
+    OrderBookService service(repo, feed);
+    MarketAsset other("0xbd31dc", "7777777");
+    feed.emit(make_snapshot());
+    feed.emit(TradeEvent{{other, Timestamp(2000), 0}, Price(0.50), Quantity(10.0), Side::BUY, "0"});
+
+    auto resolved = service.resolve_assets({"7777777", "unknown_token", "6581861"});
+    ASSERT_EQ(resolved.size(), 3u);
+    EXPECT_EQ(resolved[0], other);
+    EXPECT_FALSE(resolved[1].has_value());
+    EXPECT_EQ(resolved[2], asset);
+}
+
 TEST_F(OrderBookServiceTest, EventCountStartsAtZero) {
     OrderBookService service(repo, feed);
     EXPECT_EQ(service.event_count(), 0);
@@ -207,3 +403,305 @@ TEST_F(OrderBookServiceTest, NoSnapshotWhenIntervalZero) {
 
     EXPECT_FALSE(repo.has_snapshot(asset));
 }
+
+// --- Sharded pipeline ---
+
+TEST_F(OrderBookServiceTest, ShardedModeAppliesAndPersistsEvents) {
+    OrderBookService service(repo, feed, /*snapshot_interval=*/1000, /*shard_count=*/2);
+
+    feed.emit(make_snapshot());
+    TradeEvent trade{
+        {asset, Timestamp(2000), 0},
+        Price(0.50), Quantity(10.0), Side::BUY, "0"
+    };
+    feed.emit(trade);
+    service.drain();
+
+    EXPECT_EQ(repo.event_count(), 2);
+    auto& book = service.get_current_book(asset);
+    EXPECT_EQ(book.get_depth(), 2);
+    EXPECT_EQ(book.get_last_sequence_number(), 2);
+    EXPECT_DOUBLE_EQ(service.get_midpoint(asset).value(), 0.505);
+}
+
+TEST_F(OrderBookServiceTest, ShardedModeRunsPinnedAndBusyPolling) {
+    // A CPU the kernel refuses only costs a warning
+    PipelineThreads threads{"0", "0", /*busy_poll=*/true};
+    OrderBookService service(repo, feed, /*snapshot_interval=*/1000, /*shard_count=*/2, 65536,
+                             std::chrono::milliseconds(0), threads);
+
+    feed.emit(make_snapshot());
+    service.drain();
+    EXPECT_EQ(repo.event_count(), 1);
+    EXPECT_EQ(service.get_current_book(asset).get_depth(), 2);
+}
+
+TEST_F(OrderBookServiceTest, ShardedModePersistsEventsInSequenceOrder) {
+    // Tiny queues so the dispatcher has to wait on full workers
+    OrderBookService service(repo, feed, /*snapshot_interval=*/0, /*shard_count=*/3,
+                             /*queue_capacity=*/4);
+
+    std::vector<MarketAsset> assets;
+    for (int i = 0; i < 8; ++i) {
+        assets.emplace_back("0xcond" + std::to_string(i), "token" + std::to_string(i));
+    }
+    for (int round = 0; round < 50; ++round) {
+        for (const auto& a : assets) {
+            feed.emit(BookSnapshot{{a, Timestamp(1000 + round), 0},
+                                   {PriceLevel(Price(0.48), Quantity(30.0))},
+                                   {PriceLevel(Price(0.52), Quantity(25.0))},
+                                   "0x"});
+        }
+    }
+    service.drain();
+
+    EXPECT_EQ(service.book_count(), assets.size());
+    auto events = repo.get_events_since(assets[0], 0);
+    ASSERT_EQ(events.size(), 50);
+    uint64_t previous = 0;
+    for (const auto& event : events) {
+        auto seq = std::visit([](const auto& e) { return e.sequence_number; }, event);
+        EXPECT_GT(seq, previous);
+        previous = seq;
+    }
+    EXPECT_EQ(service.get_current_book(assets[7]).get_last_sequence_number(), 400);
+}
+
+TEST_F(OrderBookServiceTest, ShardedModeStoresSnapshots) {
+    OrderBookService service(repo, feed, /*snapshot_interval=*/2, /*shard_count=*/2);
+
+    feed.emit(make_snapshot());
+    feed.emit(make_snapshot());
+    service.drain();
+
+    EXPECT_TRUE(repo.has_snapshot(asset));
+}
+
+TEST_F(OrderBookServiceTest, ShardedModeStopFlushesPendingEvents) {
+    OrderBookService service(repo, feed, /*snapshot_interval=*/1000, /*shard_count=*/2);
+
+    for (int i = 0; i < 100; ++i) {
+        feed.emit(make_snapshot());
+    }
+    service.stop();
+
+    EXPECT_EQ(repo.event_count(), 100);
+    EXPECT_EQ(service.get_current_book(asset).get_last_sequence_number(), 100);
+}
+
+// --- Warm start ---
+
+TEST_F(OrderBookServiceTest, RecoverLoadsSnapshotAndReplaysTail) {
+    {
+        OrderBookService previous(repo, feed, /*snapshot_interval=*/1);
+        feed.emit(make_snapshot());  // seq 1, snapshotted
+    }
+    // Stored after the snapshot, as if the process died before the next one
+    repo.append_event(TradeEvent{{asset, Timestamp(2000), 2},
+                                 Price(0.50), Quantity(10.0), Side::BUY, "0"});
+
+    OrderBookService service(repo, feed);
+    auto stats = service.recover({"6581861", "unknown-token"}, /*threads=*/2);
+
+    ASSERT_EQ(stats.markets.size(), 2);
+    EXPECT_TRUE(stats.markets[0].recovered);
+    EXPECT_EQ(stats.markets[0].events_replayed, 1);
+    EXPECT_FALSE(stats.markets[1].recovered);
+    EXPECT_EQ(stats.recovered, 1);
+
+    auto& book = service.get_current_book(asset);
+    EXPECT_EQ(book.get_last_sequence_number(), 2);
+    EXPECT_DOUBLE_EQ(book.get_best_bid().value(), 0.49);
+    EXPECT_TRUE(service.resolve_asset("6581861").has_value());
+}
+
+TEST_F(OrderBookServiceTest, RecoverResumesSequenceNumbering) {
+    {
+        OrderBookService previous(repo, feed, /*snapshot_interval=*/1);
+        feed.emit(make_snapshot());
+        feed.emit(make_snapshot());  // seq 2
+    }
+
+    OrderBookService service(repo, feed, /*snapshot_interval=*/1000, /*shard_count=*/2);
+    service.recover({"6581861"}, /*threads=*/4);
+
+    feed.emit(make_snapshot());
+    service.drain();
+    EXPECT_EQ(service.get_current_book(asset).get_last_sequence_number(), 3);
+}
+
+TEST_F(OrderBookServiceTest, RecoverResumesAfterMarketsItDidNotRecover) {
+    MarketAsset other{"0xbd31dc", "4821793"};
+    {
+        OrderBookService previous(repo, feed, /*snapshot_interval=*/1);
+        feed.emit(make_snapshot());  // seq 1
+        feed.emit(TradeEvent{{other, Timestamp(2000), 0}, Price(0.50), Quantity(10.0), Side::BUY, "0"});
+        feed.emit(TradeEvent{{other, Timestamp(3000), 0}, Price(0.50), Quantity(10.0), Side::BUY, "0"});
+    }
+
+    // Only the first market is subscribed again; the other stored seq 3
+    OrderBookService service(repo, feed);
+    service.recover({"6581861"}, /*threads=*/1);
+
+    feed.emit(make_snapshot());
+    EXPECT_EQ(service.get_current_book(asset).get_last_sequence_number(), 4);
+}
+
+TEST_F(OrderBookServiceTest, CheckpointStoresEveryBook) {
+    MarketAsset other{"0xbd31dc", "4821793"};
+    OrderBookService service(repo, feed, /*snapshot_interval=*/0, /*shard_count=*/2);
+
+    feed.emit(make_snapshot());
+    feed.emit(TradeEvent{{other, Timestamp(2000), 0}, Price(0.50), Quantity(10.0), Side::BUY, "0"});
+    service.drain();
+
+    EXPECT_EQ(service.checkpoint(), 2);
+    EXPECT_EQ(repo.checkpoint_count(), 1);
+    EXPECT_EQ(repo.load_checkpoint().size(), 2);
+    EXPECT_EQ(repo.snapshot_count(), 0);
+}
+
+TEST_F(OrderBookServiceTest, CheckpointsRunAlongsideTheWriter) {
+    OrderBookService service(repo, feed, /*snapshot_interval=*/10, /*shard_count=*/2);
+    std::atomic<bool> done{false};
+    size_t checkpoints = 0;
+    std::thread checkpointer([&] {
+        while (!done.load()) {
+            service.checkpoint();
+            ++checkpoints;
+        }
+    });
+
+    for (int i = 0; i < 2000; ++i) {
+        feed.emit(make_snapshot());
+    }
+    service.drain();
+    done.store(true);
+    checkpointer.join();
+
+    EXPECT_EQ(repo.event_count(), 2000);
+    EXPECT_EQ(repo.checkpoint_count(), checkpoints);
+}
+
+TEST_F(OrderBookServiceTest, RecoverPrefersCheckpointAndReplaysTail) {
+    {
+        OrderBookService previous(repo, feed, /*snapshot_interval=*/0);
+        feed.emit(make_snapshot());  // seq 1
+        previous.checkpoint();
+    }
+    repo.append_event(TradeEvent{{asset, Timestamp(2000), 2},
+                                 Price(0.50), Quantity(10.0), Side::BUY, "0"});
+
+    OrderBookService service(repo, feed);
+    auto stats = service.recover({"6581861", "unknown-token"}, /*threads=*/2);
+
+    EXPECT_EQ(stats.recovered, 1);
+    EXPECT_EQ(stats.from_checkpoint, 1);
+    EXPECT_EQ(stats.markets[0].events_replayed, 1);
+    EXPECT_EQ(service.get_current_book(asset).get_last_sequence_number(), 2);
+}
+
+// --- Gap detection ---
+
+TEST_F(OrderBookServiceTest, FlagsBookWhoseTopDisagreesUntilNextSnapshot) {
+    for (size_t shards : {size_t{0}, size_t{2}}) {
+        InMemoryOrderBookRepository repository;
+        FakeMarketDataFeed source;
+        OrderBookService service(repository, source, 0, shards);
+        std::vector<MarketAsset> notified;
+        service.set_on_divergence([&](const MarketAsset& diverged) { notified.push_back(diverged); });
+
+        source.emit(make_snapshot());
+        // Agrees: bid 0.49 resized, top unchanged
+        source.emit(BookDelta{{asset, Timestamp(2000), 0},
+                              {PriceLevelDelta{"6581861", Price(0.49), Quantity(10.0), Side::BUY,
+                                               Price(0.49), Price(0.52)}}});
+        service.drain();
+        EXPECT_TRUE(service.diverged_assets().empty());
+
+        // The exchange reports a 0.51 ask this book never saw, twice
+        for (int i = 0; i < 2; ++i) {
+            source.emit(BookDelta{{asset, Timestamp(3000), 0},
+                                  {PriceLevelDelta{"6581861", Price(0.48), Quantity(40.0), Side::BUY,
+                                                   Price(0.49), Price(0.51)}}});
+        }
+        service.drain();
+        EXPECT_EQ(service.diverged_assets(), std::vector<MarketAsset>{asset});
+        EXPECT_EQ(notified, std::vector<MarketAsset>{asset});  // once per divergence
+        EXPECT_EQ(service.divergence_count(), 1u);
+
+        source.emit(make_snapshot());
+        service.drain();
+        EXPECT_TRUE(service.diverged_assets().empty());
+    }
+}
+
+// --- Feed outages ---
+
+TEST_F(OrderBookServiceTest, MarksBooksStaleUntilNextSnapshot) {
+    for (size_t shards : {size_t{0}, size_t{2}}) {
+        InMemoryOrderBookRepository repository;
+        FakeMarketDataFeed source;
+        OrderBookService service(repository, source, 0, shards);
+
+        source.emit(make_snapshot());
+        service.drain();
+
+        const std::vector<std::string> dropped = {"6581861", "unknown-token"};
+        EXPECT_EQ(service.mark_stale(dropped), 1u);
+        EXPECT_EQ(service.mark_stale(dropped), 0u);  // already stale
+        EXPECT_TRUE(service.is_stale(asset));
+        EXPECT_EQ(service.stale_assets(), std::vector<MarketAsset>{asset});
+
+        // Deltas keep applying, but don't make the book trustworthy again
+        source.emit(BookDelta{{asset, Timestamp(2000), 0},
+                              {PriceLevelDelta{"6581861", Price(0.49), Quantity(10.0), Side::BUY,
+                                               Price(0.49), Price(0.52)}}});
+        service.drain();
+        EXPECT_TRUE(service.is_stale(asset));
+
+        source.emit(make_snapshot());
+        service.drain();
+        EXPECT_FALSE(service.is_stale(asset));
+        EXPECT_TRUE(service.stale_assets().empty());
+    }
+}
+
+// --- Market lifecycle ---
+
+TEST_F(OrderBookServiceTest, RetireStoresAFinalSnapshotAndDropsTheBook) {
+    for (size_t shards : {size_t{0}, size_t{2}}) {
+        InMemoryOrderBookRepository repository;
+        FakeMarketDataFeed source;
+        OrderBookService service(repository, source, /*snapshot_every_events=*/1000, shards);
+        auto delta = BookDelta{{asset, Timestamp(2000), 0},
+                               {PriceLevelDelta{"6581861", Price(0.49), Quantity(10.0), Side::BUY,
+                                                Price(0.49), Price(0.52)}}};
+
+        source.emit(make_snapshot());
+        source.emit(delta);
+        service.drain();
+        ASSERT_FALSE(repository.has_snapshot(asset));
+
+        const std::vector<std::string> closed = {"6581861", "unknown-token"};
+        EXPECT_EQ(service.retire(closed), 1u);
+        EXPECT_EQ(source.unsubscribed, closed);
+        EXPECT_EQ(service.book_count(), 0u);
+        auto last = repository.get_latest_snapshot(asset);
+        ASSERT_TRUE(last.has_value());
+        EXPECT_EQ(last->get_last_sequence_number(), 2u);
+
+        // A late event is stored but brings no book back, and the token
+        // leaves the index
+        source.emit(delta);
+        service.drain();
+        EXPECT_EQ(repository.event_count(), 3);
+        EXPECT_EQ(service.book_count(), 0u);
+        EXPECT_FALSE(service.resolve_asset("6581861").has_value());
+
+        service.subscribe("6581861");
+        source.emit(make_snapshot());
+        service.drain();
+        EXPECT_EQ(service.book_count(), 1u);
+    }
+}
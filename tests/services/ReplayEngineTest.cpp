@@ -0,0 +1,74 @@
+#include "repositories/InMemoryOrderBookRepository.hpp"
+#include "services/ReplayEngine.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <variant>
+#include <vector>
+
+using namespace mde::domain;
+using namespace mde::services;
+using mde::repositories::InMemoryOrderBookRepository;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+const MarketAsset kNo("0xbd31dc", "4815162");
+
+BookSnapshot make_snapshot(const MarketAsset& asset, uint64_t seq, int64_t ts) {
+    return BookSnapshot{{asset, Timestamp(ts), seq},
+                        {PriceLevel(Price(0.48), Quantity(30.0))},
+                        {PriceLevel(Price(0.52), Quantity(25.0))},
+                        "0xabc"};
+}
+
+BookDelta make_delta(const MarketAsset& asset, uint64_t seq, int64_t ts, Price price) {
+    return BookDelta{{asset, Timestamp(ts), seq},
+                     {PriceLevelDelta{asset.token(), price, Quantity(10.0), Side::BUY,
+                                      price, Price(0.52)}}};
+}
+
+class ReplayEngineTest : public ::testing::Test {
+protected:
+    InMemoryOrderBookRepository repo;
+    ReplayEngine engine{repo};
+
+    void SetUp() override {
+        repo.append_event(make_snapshot(kYes, 1, 1000));
+        repo.append_event(make_snapshot(kNo, 2, 1000));
+        repo.append_event(make_delta(kYes, 3, 2000, Price(0.49)));
+        repo.append_event(make_delta(kNo, 4, 3000, Price(0.50)));
+        repo.append_event(make_delta(kYes, 5, 4000, Price(0.51)));
+    }
+};
+
+} // namespace
+
+TEST_F(ReplayEngineTest, AppliesEveryAssetsEventsInSequenceOrder) {
+    std::vector<uint64_t> seqs;
+    auto stats = engine.replay({kYes, kNo}, [&](const OrderBook& book, const OrderBookEventVariant& event) {
+        auto seq = std::visit([](const auto& e) { return e.sequence_number; }, event);
+        EXPECT_EQ(book.get_last_sequence_number(), seq);
+        seqs.push_back(seq);
+    });
+
+    EXPECT_EQ(seqs, (std::vector<uint64_t>{1, 2, 3, 4, 5}));
+    EXPECT_EQ(stats.events, 5u);
+    EXPECT_EQ(stats.last_sequence_number, 5u);
+    EXPECT_EQ(engine.book(kYes).get_best_bid(), Price(0.51));
+    EXPECT_EQ(engine.book(kNo).get_best_bid(), Price(0.50));
+}
+
+TEST_F(ReplayEngineTest, StopsAtTheFirstEventAfterUntil) {
+    auto stats = engine.replay({kYes, kNo}, {}, 0, Timestamp(3000));
+    EXPECT_EQ(stats.events, 4u);
+    EXPECT_EQ(engine.book(kYes).get_best_bid(), Price(0.49));
+}
+
+TEST_F(ReplayEngineTest, ReplaysOnlyTheRequestedAssetsAfterASequenceNumber) {
+    auto stats = engine.replay({kYes}, {}, 1);
+    EXPECT_EQ(stats.events, 2u);
+    EXPECT_EQ(engine.book(kYes).get_last_sequence_number(), 5u);
+    EXPECT_THROW(engine.book(kNo), std::runtime_error);
+}
@@ -0,0 +1,60 @@
+#include "services/SpscQueue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+using mde::services::SpscQueue;
+
+TEST(SpscQueue, RoundsCapacityUpToPowerOfTwo) {
+    SpscQueue<int> queue(5);
+    EXPECT_EQ(queue.capacity(), 8);
+}
+
+TEST(SpscQueue, PopsInFifoOrder) {
+    SpscQueue<std::string> queue(4);
+    EXPECT_TRUE(queue.try_push("a"));
+    EXPECT_TRUE(queue.try_push("b"));
+
+    EXPECT_EQ(queue.try_pop(), "a");
+    EXPECT_EQ(queue.try_pop(), "b");
+    EXPECT_EQ(queue.try_pop(), std::nullopt);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueue, RejectsPushWhenFull) {
+    SpscQueue<std::string> queue(2);
+    EXPECT_TRUE(queue.try_push("a"));
+    EXPECT_TRUE(queue.try_push("b"));
+
+    std::string overflow = "c";
+    EXPECT_FALSE(queue.try_push(std::move(overflow)));
+    EXPECT_EQ(overflow, "c");  // Not consumed on failure
+
+    EXPECT_EQ(queue.try_pop(), "a");
+    EXPECT_TRUE(queue.try_push(std::move(overflow)));
+}
+
+TEST(SpscQueue, TransfersAcrossThreadsInOrder) {
+    constexpr int kCount = 100000;
+    SpscQueue<int> queue(64);
+
+    std::thread producer([&] {
+        for (int i = 0; i < kCount; ++i) {
+            while (!queue.try_push(int(i))) std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    while (expected < kCount) {
+        if (auto value = queue.try_pop()) {
+            ASSERT_EQ(*value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(queue.empty());
+}
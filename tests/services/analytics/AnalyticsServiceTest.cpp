@@ -0,0 +1,89 @@
+#include "services/analytics/AnalyticsService.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace mde::domain;
+using namespace mde::services::analytics;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+const MarketAsset kNo("0xbd31dc", "4815162");
+
+BookSnapshot make_snapshot(const MarketAsset& asset, uint64_t seq) {
+    return BookSnapshot{{asset, Timestamp(1000), seq},
+                        {PriceLevel(Price(0.48), Quantity(30.0))},
+                        {PriceLevel(Price(0.52), Quantity(10.0))},
+                        "0xabc"};
+}
+
+TradeEvent make_trade(const MarketAsset& asset, uint64_t seq, double price) {
+    return TradeEvent{{asset, Timestamp(2000), seq}, Price(price), Quantity(5.0), Side::SELL, "0"};
+}
+
+} // namespace
+
+TEST(AnalyticsService, KeepsMetricsPerAsset) {
+    AnalyticsService::EventStream bus(64);
+    AnalyticsService analytics(bus);
+    EXPECT_FALSE(analytics.metrics(kYes));
+
+    bus.publish(make_snapshot(kYes, 1));
+    bus.publish(make_snapshot(kNo, 2));
+    bus.publish(make_trade(kYes, 3, 0.50));
+    bus.publish(make_trade(kNo, 4, 0.45));
+    EXPECT_EQ(analytics.poll(), 4u);
+    EXPECT_EQ(analytics.events_processed(), 4u);
+
+    auto yes = analytics.metrics(kYes);
+    ASSERT_TRUE(yes);
+    EXPECT_EQ(yes->vwap, Price(0.50));
+    EXPECT_EQ(yes->midpoint, Price(0.50));
+    EXPECT_EQ(yes->last_sequence_number, 3u);
+
+    auto no = analytics.metrics(kNo);
+    ASSERT_TRUE(no);
+    EXPECT_EQ(no->vwap, Price(0.45));
+    EXPECT_EQ(analytics.all_metrics().size(), 2u);
+}
+
+TEST(AnalyticsService, WorkerAppliesPublishedEvents) {
+    AnalyticsService::EventStream bus(64);
+    AnalyticsService analytics(bus);
+    analytics.start();
+
+    bus.publish(make_snapshot(kYes, 1));
+    bus.publish(make_trade(kYes, 2, 0.51));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (analytics.events_processed() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    analytics.stop();
+
+    auto yes = analytics.metrics(kYes);
+    ASSERT_TRUE(yes);
+    EXPECT_EQ(yes->trades, 1u);
+}
+
+TEST(AnalyticsService, CountsEventsItFellTooFarBehindFor) {
+    AnalyticsService::EventStream bus(4);
+    AnalyticsService analytics(bus);
+    for (uint64_t seq = 1; seq <= 6; ++seq) {
+        bus.publish(make_trade(kYes, seq, 0.50));
+    }
+
+    EXPECT_EQ(analytics.poll(), 4u);
+    EXPECT_EQ(analytics.events_dropped(), 2u);
+    EXPECT_EQ(analytics.metrics(kYes)->trades, 4u);
+}
+
+TEST(AnalyticsService, RejectsBadOptions) {
+    AnalyticsService::EventStream bus(4);
+    AnalyticsOptions options;
+    options.volatility_returns = 0;
+    EXPECT_THROW(AnalyticsService(bus, options), std::invalid_argument);
+}
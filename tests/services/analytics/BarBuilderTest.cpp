@@ -0,0 +1,189 @@
+#include "services/analytics/BarBuilder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace mde::domain;
+using namespace mde::services::analytics;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+const MarketAsset kNo("0xbd31dc", "4815162");
+
+BookSnapshot make_snapshot(const MarketAsset& asset, int64_t ms, double bid, double ask) {
+    return BookSnapshot{{asset, Timestamp(ms), 1},
+                        {PriceLevel(Price(bid - 0.01), Quantity(50.0)), PriceLevel(Price(bid), Quantity(30.0))},
+                        {PriceLevel(Price(ask), Quantity(10.0)), PriceLevel(Price(ask + 0.01), Quantity(20.0))},
+                        "0xabc"};
+}
+
+BookDelta make_delta(const MarketAsset& asset, int64_t ms, double bid, double ask) {
+    BookDelta delta{{asset, Timestamp(ms), 2}, {}};
+    delta.changes.push_back({asset.token(), Price(bid), Quantity(5.0), Side::BUY, Price(bid), Price(ask)});
+    return delta;
+}
+
+TradeEvent make_trade(const MarketAsset& asset, int64_t ms, double price, double size, Side side) {
+    return TradeEvent{{asset, Timestamp(ms), 3}, Price(price), Quantity(size), side, "0"};
+}
+
+BarOptions one_second() {
+    BarOptions options;
+    options.intervals_ms = {1000};
+    options.grace_ms = 500;
+    return options;
+}
+
+} // namespace
+
+TEST(BarBuilder, AggregatesTradesIntoOhlcv) {
+    BarBuilder builder(one_second());
+    std::vector<Bar> closed;
+    builder.apply(make_trade(kYes, 10'100, 0.50, 10.0, Side::BUY), closed);
+    builder.apply(make_trade(kYes, 10'200, 0.55, 4.0, Side::SELL), closed);
+    builder.apply(make_trade(kYes, 10'300, 0.45, 1.0, Side::BUY), closed);
+    builder.apply(make_trade(kYes, 10'900, 0.48, 5.0, Side::SELL), closed);
+    EXPECT_TRUE(closed.empty());
+
+    builder.apply(make_trade(kYes, 11'050, 0.49, 1.0, Side::BUY), closed);
+    ASSERT_EQ(closed.size(), 1u);
+    const auto& bar = closed[0];
+    EXPECT_EQ(bar.asset, kYes);
+    EXPECT_EQ(bar.interval_ms, 1000);
+    EXPECT_EQ(bar.start_ms, 10'000);
+    EXPECT_EQ(bar.end_ms(), 11'000);
+    EXPECT_EQ(bar.open, Price(0.50).micros());
+    EXPECT_EQ(bar.high, Price(0.55).micros());
+    EXPECT_EQ(bar.low, Price(0.45).micros());
+    EXPECT_EQ(bar.close, Price(0.48).micros());
+    EXPECT_EQ(bar.volume, Quantity(20.0).units());
+    EXPECT_EQ(bar.buy_volume, Quantity(11.0).units());
+    EXPECT_EQ(bar.trade_count, 4u);
+    EXPECT_EQ(bar.quote_updates, 0u);
+    EXPECT_EQ(bar.mid_open, 0);
+    EXPECT_EQ(builder.open_bars(), 1u);
+}
+
+TEST(BarBuilder, TracksMidAndSpreadFromSnapshotsAndDeltas) {
+    BarBuilder builder(one_second());
+    std::vector<Bar> closed;
+    builder.apply(make_snapshot(kYes, 10'100, 0.48, 0.52), closed);
+    builder.apply(make_delta(kYes, 10'200, 0.50, 0.52), closed);
+    builder.apply(make_delta(kYes, 10'300, 0.40, 0.60), closed);
+    builder.apply(make_delta(kYes, 10'400, 0.49, 0.51), closed);
+    builder.close_all(closed);
+
+    ASSERT_EQ(closed.size(), 1u);
+    const auto& bar = closed[0];
+    EXPECT_EQ(bar.mid_open, Price(0.50).micros());
+    EXPECT_EQ(bar.mid_high, Price(0.51).micros());
+    EXPECT_EQ(bar.mid_low, Price(0.50).micros());
+    EXPECT_EQ(bar.mid_close, Price(0.50).micros());
+    EXPECT_EQ(bar.spread_close, Price(0.02).micros());
+    EXPECT_EQ(bar.spread_max, Price(0.20).micros());
+    EXPECT_EQ(bar.quote_updates, 4u);
+    EXPECT_EQ(bar.trade_count, 0u);
+    EXPECT_EQ(builder.open_bars(), 0u);
+}
+
+TEST(BarBuilder, ANewBarOpensWithTheQuoteInForce) {
+    BarBuilder builder(one_second());
+    std::vector<Bar> closed;
+    builder.apply(make_snapshot(kYes, 10'100, 0.48, 0.52), closed);
+    builder.apply(make_trade(kYes, 12'500, 0.51, 1.0, Side::BUY), closed);
+    builder.close_all(closed);
+
+    ASSERT_EQ(closed.size(), 2u);
+    EXPECT_EQ(closed[1].start_ms, 12'000);
+    EXPECT_EQ(closed[1].mid_open, Price(0.50).micros());
+    EXPECT_EQ(closed[1].mid_close, Price(0.50).micros());
+    EXPECT_EQ(closed[1].spread_close, Price(0.04).micros());
+    EXPECT_EQ(closed[1].quote_updates, 0u);
+}
+
+TEST(BarBuilder, KeepsABarPerIntervalAndAsset) {
+    BarOptions options;
+    options.intervals_ms = {1000, 60'000};
+    BarBuilder builder(options);
+    std::vector<Bar> closed;
+    builder.apply(make_trade(kYes, 60'100, 0.50, 1.0, Side::BUY), closed);
+    builder.apply(make_trade(kNo, 60'200, 0.50, 2.0, Side::BUY), closed);
+    builder.apply(make_trade(kYes, 61'100, 0.60, 1.0, Side::BUY), closed);
+    EXPECT_EQ(builder.open_bars(), 4u);
+
+    ASSERT_EQ(closed.size(), 1u);
+    EXPECT_EQ(closed[0].asset, kYes);
+    EXPECT_EQ(closed[0].interval_ms, 1000);
+
+    closed.clear();
+    builder.close_all(closed);
+    ASSERT_EQ(closed.size(), 4u);
+    for (const auto& bar : closed) {
+        if (bar.asset == kYes && bar.interval_ms == 60'000) {
+            EXPECT_EQ(bar.start_ms, 60'000);
+            EXPECT_EQ(bar.trade_count, 2u);
+            EXPECT_EQ(bar.high, Price(0.60).micros());
+        }
+    }
+}
+
+TEST(BarBuilder, LateEventsFoldIntoTheOpenBar) {
+    BarBuilder builder(one_second());
+    std::vector<Bar> closed;
+    builder.apply(make_trade(kYes, 10'100, 0.50, 1.0, Side::BUY), closed);
+    builder.apply(make_trade(kYes, 11'100, 0.52, 1.0, Side::BUY), closed);
+    ASSERT_EQ(closed.size(), 1u);
+
+    // Belongs to the bar already closed, so it goes in the next one
+    builder.apply(make_trade(kYes, 10'900, 0.40, 1.0, Side::BUY), closed);
+    builder.close_all(closed);
+    ASSERT_EQ(closed.size(), 2u);
+    EXPECT_EQ(closed[1].start_ms, 11'000);
+    EXPECT_EQ(closed[1].trade_count, 2u);
+    EXPECT_EQ(closed[1].low, Price(0.40).micros());
+
+    // And after everything closed, a bar opens where the last one ended
+    builder.apply(make_trade(kYes, 10'950, 0.45, 1.0, Side::BUY), closed);
+    builder.close_all(closed);
+    ASSERT_EQ(closed.size(), 3u);
+    EXPECT_EQ(closed[2].start_ms, 12'000);
+}
+
+TEST(BarBuilder, ClosesQuietBarsAfterTheGrace) {
+    BarBuilder builder(one_second());
+    std::vector<Bar> closed;
+    builder.apply(make_trade(kYes, 10'100, 0.50, 1.0, Side::BUY), closed);
+
+    builder.close_until(11'499, closed);
+    EXPECT_TRUE(closed.empty());
+    builder.close_until(11'500, closed);
+    ASSERT_EQ(closed.size(), 1u);
+    EXPECT_EQ(builder.open_bars(), 0u);
+}
+
+TEST(BarBuilder, RejectsBadOptions) {
+    BarOptions none;
+    none.intervals_ms.clear();
+    EXPECT_THROW(BarBuilder{none}, std::invalid_argument);
+    BarOptions zero;
+    zero.intervals_ms = {0};
+    EXPECT_THROW(BarBuilder{zero}, std::invalid_argument);
+    BarOptions repeated;
+    repeated.intervals_ms = {1000, 1000};
+    EXPECT_THROW(BarBuilder{repeated}, std::invalid_argument);
+    BarOptions negative;
+    negative.grace_ms = -1;
+    EXPECT_THROW(BarBuilder{negative}, std::invalid_argument);
+}
+
+TEST(BarBuilder, ParsesIntervalLists) {
+    EXPECT_EQ(parse_bar_intervals("1s,1m"), (std::vector<int64_t>{1000, 60'000}));
+    EXPECT_EQ(parse_bar_intervals("500ms, 5m ,1h"), (std::vector<int64_t>{500, 300'000, 3'600'000}));
+    EXPECT_FALSE(parse_bar_intervals(""));
+    EXPECT_FALSE(parse_bar_intervals("1s,"));
+    EXPECT_FALSE(parse_bar_intervals("10"));
+    EXPECT_FALSE(parse_bar_intervals("0s"));
+    EXPECT_FALSE(parse_bar_intervals("1d"));
+}
@@ -0,0 +1,104 @@
+#include "services/analytics/BarService.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+using namespace mde::domain;
+using namespace mde::services::analytics;
+
+namespace {
+
+const MarketAsset kYes("0xbd31dc", "6581861");
+
+TradeEvent make_trade(int64_t ms, double price) {
+    return TradeEvent{{kYes, Timestamp(ms), 1}, Price(price), Quantity(5.0), Side::BUY, "0"};
+}
+
+BarOptions one_second() {
+    BarOptions options;
+    options.intervals_ms = {1000};
+    options.grace_ms = 0;
+    return options;
+}
+
+struct Collected {
+    std::mutex mutex;
+    std::vector<Bar> bars;
+    size_t batches{0};
+
+    BarService::Sink sink() {
+        return [this](const std::vector<Bar>& batch) {
+            std::lock_guard lock(mutex);
+            bars.insert(bars.end(), batch.begin(), batch.end());
+            ++batches;
+        };
+    }
+};
+
+} // namespace
+
+TEST(BarService, HandsClosedBarsToTheSinkOnFlush) {
+    BarService::EventStream bus(64);
+    Collected out;
+    BarService bars(bus, out.sink(), one_second());
+
+    bus.publish(make_trade(10'100, 0.50));
+    bus.publish(make_trade(11'100, 0.51));
+    bus.publish(make_trade(12'100, 0.52));
+    EXPECT_EQ(bars.poll(), 3u);
+    EXPECT_EQ(bars.events_processed(), 3u);
+    EXPECT_TRUE(out.bars.empty());
+
+    // Two closed by later events, one by the clock
+    EXPECT_EQ(bars.flush(13'000), 3u);
+    EXPECT_EQ(out.batches, 1u);
+    ASSERT_EQ(out.bars.size(), 3u);
+    EXPECT_EQ(out.bars[2].start_ms, 12'000);
+    EXPECT_EQ(bars.bars_written(), 3u);
+    EXPECT_EQ(bars.flush(14'000), 0u);
+    EXPECT_EQ(out.batches, 1u);
+}
+
+TEST(BarService, StopHandsOverOpenBars) {
+    BarService::EventStream bus(64);
+    Collected out;
+    BarService bars(bus, out.sink(), one_second(), std::chrono::hours(1));
+    bars.start();
+
+    bus.publish(make_trade(10'100, 0.50));
+    bus.publish(make_trade(10'200, 0.55));
+    bars.stop();
+    ASSERT_EQ(out.bars.size(), 1u);
+    EXPECT_EQ(out.bars[0].trade_count, 2u);
+    EXPECT_EQ(out.bars[0].high, Price(0.55).micros());
+
+    bars.stop();
+    EXPECT_EQ(out.batches, 1u);
+}
+
+TEST(BarService, WorkerFlushesOnItsInterval) {
+    BarService::EventStream bus(64);
+    Collected out;
+    BarService bars(bus, out.sink(), one_second(), std::chrono::milliseconds(5));
+    bars.start();
+
+    // Long past, so the wall clock closes it at the next flush
+    bus.publish(make_trade(10'100, 0.50));
+    for (int i = 0; i < 400 && bars.bars_written() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(bars.bars_written(), 1u);
+    bars.stop();
+    EXPECT_EQ(out.batches, 1u);
+}
+
+TEST(BarService, RejectsBadArguments) {
+    BarService::EventStream bus(64);
+    Collected out;
+    EXPECT_THROW(BarService(bus, nullptr), std::invalid_argument);
+    EXPECT_THROW(BarService(bus, out.sink(), one_second(), std::chrono::milliseconds(0)), std::invalid_argument);
+}
@@ -0,0 +1,143 @@
+#include "services/analytics/MarketMetrics.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace mde::domain;
+using namespace mde::services::analytics;
+
+namespace {
+
+const MarketAsset kAsset("0xbd31dc", "6581861");
+
+BookSnapshot make_snapshot(uint64_t seq, Price bid, Quantity bid_size, Price ask, Quantity ask_size) {
+    return BookSnapshot{{kAsset, Timestamp(1000), seq},
+                        {PriceLevel(bid, bid_size), PriceLevel(Price(bid.value() - 0.01), Quantity(50.0))},
+                        {PriceLevel(ask, ask_size)},
+                        "0xabc"};
+}
+
+TradeEvent make_trade(uint64_t seq, double price, double size) {
+    return TradeEvent{{kAsset, Timestamp(2000), seq}, Price(price), Quantity(size), Side::BUY, "0"};
+}
+
+AnalyticsOptions small_windows() {
+    AnalyticsOptions options;
+    options.vwap_trades = 2;
+    options.volatility_returns = 2;
+    options.ewma_lambda = 0.5;
+    options.depth_ticks = 1;
+    return options;
+}
+
+} // namespace
+
+TEST(MarketMetrics, EmptyUntilThereIsData) {
+    MarketMetrics metrics(kAsset, {});
+    auto s = metrics.snapshot();
+    EXPECT_EQ(s.asset, kAsset);
+    EXPECT_EQ(s.trades, 0u);
+    EXPECT_FALSE(s.vwap);
+    EXPECT_FALSE(s.midpoint);
+    EXPECT_FALSE(s.microprice);
+    EXPECT_FALSE(s.imbalance);
+    EXPECT_FALSE(s.realized_volatility);
+    EXPECT_FALSE(s.ewma_volatility);
+}
+
+TEST(MarketMetrics, VwapCoversTheLastTrades) {
+    MarketMetrics metrics(kAsset, small_windows());
+    metrics.apply(make_trade(1, 0.40, 100.0));
+    EXPECT_EQ(metrics.snapshot().vwap, Price(0.40));
+
+    metrics.apply(make_trade(2, 0.50, 300.0));
+    EXPECT_EQ(metrics.snapshot().vwap, Price(0.475));
+
+    // The first trade leaves the window
+    metrics.apply(make_trade(3, 0.60, 100.0));
+    auto s = metrics.snapshot();
+    EXPECT_EQ(s.vwap, Price(0.525));
+    EXPECT_EQ(s.trades, 3u);
+    EXPECT_EQ(s.last_sequence_number, 3u);
+}
+
+TEST(MarketMetrics, TopOfBookSignals) {
+    MarketMetrics metrics(kAsset, small_windows());
+    metrics.apply(make_snapshot(1, Price(0.50), Quantity(300.0), Price(0.52), Quantity(100.0)));
+
+    auto s = metrics.snapshot();
+    EXPECT_EQ(s.midpoint, Price(0.51));
+    // Leans toward the ask: more size rests on the bid
+    EXPECT_EQ(s.microprice, Price(0.515));
+    ASSERT_TRUE(s.imbalance);
+    EXPECT_DOUBLE_EQ(*s.imbalance, 0.5);
+    // Within one tick: 300 + 50 bid against 100 ask
+    ASSERT_TRUE(s.depth_imbalance);
+    EXPECT_DOUBLE_EQ(*s.depth_imbalance, 250.0 / 450.0);
+}
+
+TEST(MarketMetrics, SweepPricesFillTheOrderSizeAcrossLevels) {
+    auto options = small_windows();
+    options.sweep_size = 320.0;
+    MarketMetrics metrics(kAsset, options);
+    metrics.apply(make_snapshot(1, Price(0.50), Quantity(300.0), Price(0.52), Quantity(100.0)));
+
+    auto s = metrics.snapshot();
+    // 300 at 0.50 and 20 of the 50 at 0.49
+    EXPECT_EQ(s.sell_sweep_price, Price::from_micros((300 * 500000 + 20 * 490000) / 320));
+    // The asks hold only 100
+    EXPECT_FALSE(s.buy_sweep_price);
+
+    options.sweep_size = 0.0;
+    MarketMetrics off(kAsset, options);
+    off.apply(make_snapshot(1, Price(0.50), Quantity(300.0), Price(0.52), Quantity(100.0)));
+    EXPECT_FALSE(off.snapshot().sell_sweep_price);
+}
+
+TEST(MarketMetrics, VolatilityOfMidpointReturns) {
+    MarketMetrics metrics(kAsset, small_windows());
+    metrics.apply(make_snapshot(1, Price(0.49), Quantity(10.0), Price(0.51), Quantity(10.0)));  // mid 0.50
+    metrics.apply(make_snapshot(2, Price(0.49), Quantity(20.0), Price(0.51), Quantity(10.0)));  // unchanged
+    EXPECT_EQ(metrics.snapshot().returns, 0u);
+
+    metrics.apply(make_snapshot(3, Price(0.54), Quantity(10.0), Price(0.56), Quantity(10.0)));  // mid 0.55
+    metrics.apply(make_snapshot(4, Price(0.49), Quantity(10.0), Price(0.51), Quantity(10.0)));  // mid 0.50
+    metrics.apply(make_snapshot(5, Price(0.44), Quantity(10.0), Price(0.46), Quantity(10.0)));  // mid 0.45
+
+    double r1 = std::log(0.55 / 0.50);
+    double r2 = std::log(0.50 / 0.55);
+    double r3 = std::log(0.45 / 0.50);
+
+    auto s = metrics.snapshot();
+    EXPECT_EQ(s.returns, 3u);
+    ASSERT_TRUE(s.realized_volatility);
+    EXPECT_NEAR(*s.realized_volatility, std::sqrt((r2 * r2 + r3 * r3) / 2), 1e-12);
+
+    double ewma = r1 * r1;
+    ewma = 0.5 * ewma + 0.5 * r2 * r2;
+    ewma = 0.5 * ewma + 0.5 * r3 * r3;
+    ASSERT_TRUE(s.ewma_volatility);
+    EXPECT_NEAR(*s.ewma_volatility, std::sqrt(ewma), 1e-12);
+}
+
+TEST(MarketMetrics, ValidateRejectsBadOptions) {
+    AnalyticsOptions options;
+    EXPECT_NO_THROW(validate(options));
+
+    options.vwap_trades = 0;
+    EXPECT_THROW(validate(options), std::invalid_argument);
+
+    options = {};
+    options.ewma_lambda = 1.0;
+    EXPECT_THROW(validate(options), std::invalid_argument);
+
+    options = {};
+    options.depth_ticks = -1;
+    EXPECT_THROW(validate(options), std::invalid_argument);
+
+    options = {};
+    options.sweep_size = -1.0;
+    EXPECT_THROW(validate(options), std::invalid_argument);
+}
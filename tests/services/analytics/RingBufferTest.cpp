@@ -0,0 +1,39 @@
+#include "services/analytics/RingBuffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using mde::services::analytics::RingBuffer;
+
+TEST(RingBuffer, EvictsOldestOnceFull) {
+    RingBuffer<int> ring(3);
+    EXPECT_FALSE(ring.push(1));
+    EXPECT_FALSE(ring.push(2));
+    EXPECT_FALSE(ring.push(3));
+    EXPECT_TRUE(ring.full());
+
+    EXPECT_EQ(ring.push(4), 1);
+    EXPECT_EQ(ring.push(5), 2);
+    EXPECT_EQ(ring.size(), 3u);
+    EXPECT_EQ(ring[0], 3);
+    EXPECT_EQ(ring[1], 4);
+    EXPECT_EQ(ring[2], 5);
+}
+
+TEST(RingBuffer, ClearKeepsCapacity) {
+    RingBuffer<int> ring(2);
+    ring.push(1);
+    ring.push(2);
+    ring.push(3);
+    ring.clear();
+
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.capacity(), 2u);
+    EXPECT_FALSE(ring.push(7));
+    EXPECT_EQ(ring[0], 7);
+}
+
+TEST(RingBuffer, ZeroCapacityThrows) {
+    EXPECT_THROW(RingBuffer<int>(0), std::invalid_argument);
+}
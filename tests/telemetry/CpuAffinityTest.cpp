@@ -0,0 +1,51 @@
+#include "telemetry/CpuAffinity.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace mde::telemetry;
+
+TEST(CpuAffinity, ParsesCpuLists) {
+    EXPECT_EQ(parse_cpu_list("3"), (std::vector<int>{3}));
+    EXPECT_EQ(parse_cpu_list("4-7"), (std::vector<int>{4, 5, 6, 7}));
+    EXPECT_EQ(parse_cpu_list("0, 2,8-9"), (std::vector<int>{0, 2, 8, 9}));
+    EXPECT_EQ(parse_cpu_list(""), std::vector<int>{});
+}
+
+TEST(CpuAffinity, RejectsMalformedLists) {
+    EXPECT_FALSE(parse_cpu_list("a"));
+    EXPECT_FALSE(parse_cpu_list("1,"));
+    EXPECT_FALSE(parse_cpu_list("5-2"));
+    EXPECT_FALSE(parse_cpu_list("-1"));
+    EXPECT_FALSE(parse_cpu_list("1-2-3"));
+}
+
+#ifdef __linux__
+TEST(CpuAffinity, PinsTheCallingThreadOnly) {
+    cpu_set_t before;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+
+    int cpu = -1, pinned_to = -1;
+    std::thread([&] {
+        cpu = sched_getcpu();
+        ASSERT_TRUE(pin_current_thread(std::vector<int>{cpu}));
+        pinned_to = sched_getcpu();
+    }).join();
+    EXPECT_EQ(pinned_to, cpu);
+
+    cpu_set_t after;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+    EXPECT_TRUE(CPU_EQUAL(&before, &after));
+
+    std::thread([] {
+        EXPECT_FALSE(pin_current_thread(std::vector<int>{CPU_SETSIZE}));
+        EXPECT_TRUE(pin_current_thread(std::vector<int>{}));
+    }).join();
+}
+#endif
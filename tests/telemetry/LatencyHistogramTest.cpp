@@ -0,0 +1,61 @@
+#include "telemetry/LatencyHistogram.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+using namespace mde::telemetry;
+
+TEST(HistogramLayout, BucketsAreContiguousAndNarrow) {
+    for (uint64_t v = 0; v < 100'000; ++v) {
+        auto i = HistogramLayout::index_of(v);
+        ASSERT_LE(v, HistogramLayout::upper_bound(i));
+        if (i > 0) {
+            ASSERT_GT(v, HistogramLayout::upper_bound(i - 1));
+        }
+    }
+    // Within 1/64 of the value
+    uint64_t big = 123'456'789;
+    auto bound = HistogramLayout::upper_bound(HistogramLayout::index_of(big));
+    EXPECT_LE(bound - big, big / 64);
+}
+
+TEST(HistogramLayout, HugeValuesShareTheLastBucket) {
+    EXPECT_EQ(HistogramLayout::index_of(UINT64_MAX), HistogramLayout::kBucketCount - 1);
+    EXPECT_EQ(HistogramLayout::index_of(uint64_t{1} << HistogramLayout::kMaxBits),
+              HistogramLayout::kBucketCount - 1);
+}
+
+TEST(LatencyHistogram, Percentiles) {
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 1000; ++v) histogram.record(v);
+    HistogramSnapshot snapshot;
+    histogram.snapshot(snapshot);
+
+    EXPECT_EQ(snapshot.count(), 1000u);
+    EXPECT_NEAR(static_cast<double>(snapshot.value_at(0.5)), 500, 500 / 64.0);
+    EXPECT_NEAR(static_cast<double>(snapshot.value_at(0.99)), 990, 990 / 64.0);
+    EXPECT_NEAR(static_cast<double>(snapshot.max()), 1000, 1000 / 64.0);
+    EXPECT_EQ(snapshot.value_at(0.0), 1u);
+}
+
+TEST(LatencyHistogram, EmptySnapshotIsZero) {
+    HistogramSnapshot snapshot;
+    EXPECT_EQ(snapshot.count(), 0u);
+    EXPECT_EQ(snapshot.value_at(0.99), 0u);
+}
+
+TEST(LatencyHistogram, SinceKeepsOnlyNewerValues) {
+    LatencyHistogram histogram;
+    histogram.record(10);
+    HistogramSnapshot earlier;
+    histogram.snapshot(earlier);
+
+    histogram.record(5000);
+    HistogramSnapshot later;
+    histogram.snapshot(later);
+
+    auto window = later.since(earlier);
+    EXPECT_EQ(window.count(), 1u);
+    EXPECT_GE(window.value_at(0.0), 5000u);
+}
@@ -0,0 +1,61 @@
+#include "telemetry/Latency.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace mde::telemetry;
+
+TEST(LatencyRegistry, MergesEveryThreadsHistograms) {
+    LatencyRegistry registry;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&registry] {
+            for (int i = 0; i < 1000; ++i) registry.record(Stage::apply, uint64_t{100});
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    registry.record(Stage::append, uint64_t{7});
+
+    EXPECT_EQ(registry.snapshot(Stage::apply).count(), 4000u);
+    EXPECT_EQ(registry.snapshot(Stage::append).count(), 1u);
+    EXPECT_EQ(registry.snapshot(Stage::flush).count(), 0u);
+}
+
+TEST(LatencyRegistry, RegistriesAreIndependent) {
+    LatencyRegistry first;
+    LatencyRegistry second;
+    first.record(Stage::parse, uint64_t{1});
+    second.record(Stage::parse, uint64_t{1});
+    first.record(Stage::parse, uint64_t{1});
+
+    EXPECT_EQ(first.snapshot(Stage::parse).count(), 2u);
+    EXPECT_EQ(second.snapshot(Stage::parse).count(), 1u);
+}
+
+TEST(LatencyRegistry, SummaryIsInNanoseconds) {
+    LatencyRegistry registry;
+    registry.record(Stage::flush, std::chrono::milliseconds(2));
+
+    auto summary = LatencySummary::of(registry.snapshot(Stage::flush));
+    EXPECT_EQ(summary.count, 1u);
+    // One bucket's width of error plus the calibration's
+    EXPECT_NEAR(summary.p50_ns, 2e6, 2e6 * 0.05);
+    EXPECT_DOUBLE_EQ(summary.max_ns, summary.p999_ns);
+}
+
+TEST(Tsc, TicksAdvanceWithTime) {
+    auto start = tsc_now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    auto elapsed_ns = ticks_to_ns(tsc_now() - start);
+    EXPECT_GT(elapsed_ns, 4e6);
+    EXPECT_LT(elapsed_ns, 1e9);
+}
+
+TEST(Stage, Names) {
+    EXPECT_EQ(stage_name(Stage::parse), "parse");
+    EXPECT_EQ(stage_name(Stage::end_to_end), "end_to_end");
+    EXPECT_EQ(stage_name(Stage::flush), "flush");
+}
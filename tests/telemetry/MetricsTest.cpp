@@ -0,0 +1,99 @@
+#include "telemetry/Metrics.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+using namespace mde::telemetry;
+
+TEST(MetricsRegistry, RendersCountersAndGauges) {
+    MetricsRegistry registry;
+    registry.counter("mde_messages_total", "Messages received").inc(3);
+    registry.gauge("mde_connected", "1 while connected").set(1);
+
+    EXPECT_EQ(registry.render(),
+              "# HELP mde_messages_total Messages received\n"
+              "# TYPE mde_messages_total counter\n"
+              "mde_messages_total 3\n"
+              "# HELP mde_connected 1 while connected\n"
+              "# TYPE mde_connected gauge\n"
+              "mde_connected 1\n");
+}
+
+TEST(MetricsRegistry, SameNameAndLabelsIsTheSameMetric) {
+    MetricsRegistry registry;
+    auto& books = registry.counter("mde_events_total", "Events", {{"type", "book"}});
+    auto& trades = registry.counter("mde_events_total", "Events", {{"type", "trade"}});
+    EXPECT_EQ(&registry.counter("mde_events_total", "Events", {{"type", "book"}}), &books);
+    EXPECT_NE(&books, &trades);
+
+    books.inc();
+    trades.inc(2);
+    auto text = registry.render();
+    EXPECT_NE(text.find("mde_events_total{type=\"book\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("mde_events_total{type=\"trade\"} 2\n"), std::string::npos);
+    // One header for the family
+    EXPECT_EQ(text.find("# TYPE mde_events_total"), text.rfind("# TYPE mde_events_total"));
+}
+
+TEST(MetricsRegistry, ThrowsOnTypeMismatch) {
+    MetricsRegistry registry;
+    registry.counter("mde_thing", "A thing");
+    EXPECT_THROW(registry.gauge("mde_thing", "A thing"), std::invalid_argument);
+}
+
+TEST(MetricsRegistry, EscapesLabelValuesAndHelp) {
+    MetricsRegistry registry;
+    registry.gauge("mde_escaped", "Back\\slash\nnewline", {{"path", "a\"b\\c\nd"}}).set(-2);
+
+    auto text = registry.render();
+    EXPECT_NE(text.find("# HELP mde_escaped Back\\\\slash\\nnewline\n"), std::string::npos);
+    EXPECT_NE(text.find("mde_escaped{path=\"a\\\"b\\\\c\\nd\"} -2\n"), std::string::npos);
+}
+
+TEST(MetricsRegistry, SamplesAreReadAtRenderUntilTheHandleGoes) {
+    MetricsRegistry registry;
+    double books = 4;
+    {
+        auto handle = registry.sample(MetricType::gauge, "mde_books", "Books", {}, [&] { return books; });
+        EXPECT_NE(registry.render().find("mde_books 4\n"), std::string::npos);
+        books = 5.5;
+        EXPECT_NE(registry.render().find("mde_books 5.5\n"), std::string::npos);
+    }
+    // A family with no series left is not rendered
+    EXPECT_EQ(registry.render(), "");
+}
+
+TEST(MetricsRegistry, MovedSampleHandleKeepsTheSample) {
+    MetricsRegistry registry;
+    MetricsRegistry::SampleHandle kept;
+    {
+        auto handle = registry.sample(MetricType::counter, "mde_files_total", "Files", {}, [] { return 7.0; });
+        kept = std::move(handle);
+    }
+    EXPECT_NE(registry.render().find("mde_files_total 7\n"), std::string::npos);
+    kept = MetricsRegistry::SampleHandle();
+    EXPECT_EQ(registry.render(), "");
+}
+
+TEST(RenderLatencies, EmitsASummaryPerRecordedStage) {
+    LatencyRegistry latencies;
+    latencies.record(Stage::flush, std::chrono::milliseconds(2));
+
+    std::string text;
+    render_latencies(latencies, text);
+    EXPECT_NE(text.find("# TYPE mde_stage_latency_seconds summary\n"), std::string::npos);
+    EXPECT_NE(text.find("mde_stage_latency_seconds{stage=\"flush\",quantile=\"0.5\"} 0.002"),
+              std::string::npos);
+    EXPECT_NE(text.find("mde_stage_latency_seconds_count{stage=\"flush\"} 1\n"), std::string::npos);
+    EXPECT_EQ(text.find("stage=\"parse\""), std::string::npos);
+}
+
+TEST(RenderLatencies, NothingRecordedRendersNothing) {
+    LatencyRegistry latencies;
+    std::string text;
+    render_latencies(latencies, text);
+    EXPECT_EQ(text, "");
+}
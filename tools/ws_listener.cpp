@@ -1,3 +1,5 @@
+#include "infrastructure/FrameCapture.hpp"
+
 #include <ixwebsocket/IXNetSystem.h>
 #include <ixwebsocket/IXWebSocket.h>
 
@@ -5,8 +7,11 @@
 #include <chrono>
 #include <csignal>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
 
 static std::atomic<bool> running{true};
 
@@ -15,8 +20,24 @@ void signal_handler(int) {
 }
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Usage: ws_listener <token_id> [token_id2 ...]" << std::endl;
+    // --record <file> writes frames to a capture for ws_replay instead of stdout
+    std::unique_ptr<mde::infrastructure::FrameWriter> recorder;
+    std::vector<std::string> token_ids;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            try {
+                recorder = std::make_unique<mde::infrastructure::FrameWriter>(argv[++i]);
+            } catch (const std::runtime_error& e) {
+                std::cerr << e.what() << std::endl;
+                return 1;
+            }
+        } else {
+            token_ids.push_back(std::move(arg));
+        }
+    }
+    if (token_ids.empty()) {
+        std::cerr << "Usage: ws_listener [--record <file>] <token_id> [token_id2 ...]" << std::endl;
         return 1;
     }
 
@@ -24,9 +45,9 @@ int main(int argc, char* argv[]) {
 
     // Build assets array from CLI args
     std::string assets = "[";
-    for (int i = 1; i < argc; ++i) {
-        if (i > 1) assets += ",";
-        assets += "\"" + std::string(argv[i]) + "\"";
+    for (size_t i = 0; i < token_ids.size(); ++i) {
+        if (i > 0) assets += ",";
+        assets += "\"" + token_ids[i] + "\"";
     }
     assets += "]";
 
@@ -37,13 +58,18 @@ int main(int argc, char* argv[]) {
     ws.setOnMessageCallback([&](const ix::WebSocketMessagePtr& msg) {
         switch (msg->type) {
             case ix::WebSocketMessageType::Open:
-                std::cout << "[connected] Subscribing to " << argc - 1
+                std::cout << "[connected] Subscribing to " << token_ids.size()
                           << " asset(s)..." << std::endl;
                 ws.send(R"({"assets_ids": )" + assets + R"(, "type": "market"})");
                 break;
 
             case ix::WebSocketMessageType::Message:
-                std::cout << msg->str << "\n" << std::endl;
+                if (recorder) {
+                    // Stamped on arrival, before anything else touches the frame
+                    recorder->write(std::chrono::system_clock::now().time_since_epoch(), msg->str);
+                } else {
+                    std::cout << msg->str << "\n" << std::endl;
+                }
                 break;
 
             case ix::WebSocketMessageType::Error:
@@ -70,6 +96,10 @@ int main(int argc, char* argv[]) {
 
     ws.stop();
     ix::uninitNetSystem();
+    if (recorder) {
+        recorder->flush();
+        std::cout << "\n[recorded] " << recorder->frames_written() << " frames" << std::endl;
+    }
     std::cout << "\nDone." << std::endl;
     return 0;
 }
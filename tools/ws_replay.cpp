@@ -0,0 +1,126 @@
+#include "config/Settings.hpp"
+#include "infrastructure/MessageParserFactory.hpp"
+#include "infrastructure/ReplayFeed.hpp"
+#include "repositories/InMemoryOrderBookRepository.hpp"
+#include "services/OrderBookService.hpp"
+#include "telemetry/Latency.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace mde::domain;
+
+namespace {
+
+// Drops what it is given, so a run measures the engine rather than memory growth
+class DiscardingRepository : public mde::repositories::IOrderBookRepository {
+public:
+    void append_event(const OrderBookEventVariant&) override {}
+    void append_event(OrderBookEventVariant&&) override {}
+    std::vector<OrderBookEventVariant> get_events_since(const MarketAsset&, uint64_t) const override {
+        return {};
+    }
+    uint64_t max_sequence_number() const override { return 0; }
+    void store_snapshot(const OrderBook&) override {}
+    std::optional<OrderBook> get_latest_snapshot(const MarketAsset&) const override { return std::nullopt; }
+    std::optional<OrderBook> get_latest_snapshot_by_token(const std::string&) const override {
+        return std::nullopt;
+    }
+    void store_checkpoint(const std::vector<OrderBook>&) override {}
+    std::vector<OrderBook> load_checkpoint() const override { return {}; }
+};
+
+int usage() {
+    std::cerr << "Usage: ws_replay <capture> [--speed <x>|max] [--passes <n>] [--shards <n>]\n"
+              << "                 [--parser nlohmann|simdjson] [--store]\n"
+              << "  --speed   multiple of the recorded pace (default 1; max: back to back)\n"
+              << "  --store   keep events in an in-memory repository instead of dropping them"
+              << std::endl;
+    return 1;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) return usage();
+
+    std::string path = argv[1];
+    mde::infrastructure::ReplayOptions options;
+    size_t shards = 0;
+    std::string parser_name = "nlohmann";
+    bool store = false;
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--speed" && has_value) {
+                std::string value = argv[++i];
+                options.speed = value == "max" ? 0.0 : std::stod(value);
+            } else if (arg == "--passes" && has_value) {
+                options.passes = std::stoul(argv[++i]);
+            } else if (arg == "--shards" && has_value) {
+                shards = std::stoul(argv[++i]);
+            } else if (arg == "--parser" && has_value) {
+                parser_name = argv[++i];
+            } else if (arg == "--store") {
+                store = true;
+            } else {
+                return usage();
+            }
+        }
+    } catch (const std::logic_error&) {
+        return usage();
+    }
+
+    std::unique_ptr<mde::repositories::IOrderBookRepository> repo;
+    if (store) {
+        repo = std::make_unique<mde::repositories::InMemoryOrderBookRepository>();
+    } else {
+        repo = std::make_unique<DiscardingRepository>();
+    }
+
+    std::unique_ptr<mde::infrastructure::ReplayFeed> feed;
+    try {
+        feed = std::make_unique<mde::infrastructure::ReplayFeed>(
+            path, mde::infrastructure::make_message_parser(parser_name), options);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // Snapshot policy and queue sizes as the engine runs by default
+    const mde::config::ServiceSettings defaults;
+    mde::services::OrderBookService service(
+        *repo, *feed, static_cast<uint64_t>(defaults.snapshot_every_events), shards,
+        static_cast<size_t>(defaults.ingest_queue_capacity));
+    auto started = std::chrono::steady_clock::now();
+    service.start();
+    feed->wait();
+    service.stop();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    auto events = feed->events_replayed();
+    std::cout << "[replay] frames=" << feed->frames_replayed() << " events=" << events
+              << " parse_failures=" << feed->parse_failures() << " markets=" << service.book_count()
+              << std::fixed << std::setprecision(3) << " seconds=" << elapsed
+              << std::setprecision(0) << " events/sec=" << (elapsed > 0 ? events / elapsed : 0)
+              << std::defaultfloat << std::endl;
+
+    for (auto stage : mde::telemetry::kStages) {
+        auto summary = mde::telemetry::LatencySummary::of(mde::telemetry::LatencyRegistry::global().snapshot(stage));
+        if (summary.count == 0) continue;
+        std::cout << "[latency] " << mde::telemetry::stage_name(stage) << std::fixed << std::setprecision(1)
+                  << " p50_us=" << summary.p50_ns / 1000.0
+                  << " p99_us=" << summary.p99_ns / 1000.0
+                  << " p999_us=" << summary.p999_ns / 1000.0
+                  << " max_us=" << summary.max_ns / 1000.0
+                  << " n=" << summary.count << std::defaultfloat << std::endl;
+    }
+    return 0;
+}